@@ -294,6 +294,8 @@ extern te_errno ta_unix_conf_aggr_init(void);
 #ifdef ENABLE_PCI_SUPPORT
 extern te_errno ta_unix_conf_pci_init(void);
 extern te_errno ta_unix_conf_pci_cleanup(void);
+extern te_errno ta_unix_conf_devlink_init(void);
+extern te_errno ta_unix_conf_devlink_cleanup(void);
 #endif
 
 extern te_errno ta_unix_conf_memory_init(void);
@@ -328,6 +330,9 @@ extern te_errno ta_unix_conf_nginx_init(void);
 
 extern te_errno ta_unix_conf_loadavg_init(void);
 
+extern te_errno ta_unix_conf_sampler_init(void);
+extern te_errno ta_unix_conf_sampler_cleanup(void);
+
 #ifdef WITH_UPNP_CP
 # include "conf_upnp_cp.h"
 #endif /* WITH_UPNP_CP */
@@ -1337,6 +1342,8 @@ rcf_ch_conf_init(void)
 #ifdef ENABLE_PCI_SUPPORT
         if (ta_unix_conf_pci_init() != 0)
             goto fail;
+        if (ta_unix_conf_devlink_init() != 0)
+            goto fail;
 #endif
 
         if (ta_unix_conf_cpu_init() != 0)
@@ -1403,7 +1410,11 @@ rcf_ch_conf_init(void)
         if (ta_unix_conf_loadavg_init() != 0)
             goto fail;
 
+        if (ta_unix_conf_sampler_init() != 0)
+            goto fail;
+
         rcf_pch_rsrc_init();
+        rcf_pch_perf_init();
 
 #ifdef WITH_AGGREGATION
         if (ta_unix_conf_aggr_init() != 0)
@@ -1572,6 +1583,8 @@ rcf_ch_conf_agent(void)
 void
 rcf_ch_conf_fini(void)
 {
+    ta_unix_conf_sampler_cleanup();
+
 #ifdef WITH_SERIALPARSE
     ta_unix_serial_parser_cleanup();
 #endif
@@ -1596,6 +1609,7 @@ rcf_ch_conf_fini(void)
 #endif
 
 #ifdef ENABLE_PCI_SUPPORT
+    ta_unix_conf_devlink_cleanup();
     ta_unix_conf_pci_cleanup();
 #endif
 
@@ -3376,121 +3390,144 @@ typedef enum {
     IF_PROP_KIND,       /**< Interface kind (vlan, macvlan, ipvlan, etc). */
 } if_property;
 
+/** Key of the interfaces dump in the configuration snapshot */
+#define IFACE_LINK_DUMP_KEY "unix/netconf_link_dump"
+
+/* Release the interfaces dump stored in the configuration snapshot */
+static void
+iface_link_dump_free(void *data)
+{
+    netconf_list_free(data);
+}
+
 /**
- * Get a propery of the interface (using libnetconf).
+ * Find an interface in the dump of interfaces. The dump is taken once
+ * per configuration request and shared by all handlers of interface
+ * properties, so synchronization of the whole tree does not dump
+ * interfaces for every property of every interface.
  *
  * @param ifname        Name of the interface (like "eth0").
- * @param value         Where to save an answer.
- * @param prop          Which property to get.
+ * @param link          Where to save pointer to the interface (valid
+ *                      till the end of the configuration request).
  *
  * @return              Status code.
  */
 static te_errno
-iface_get_property_netconf(const char *ifname,
-                           char *value,
-                           if_property prop)
+iface_link_find(const char *ifname, const netconf_link **link)
 {
-    netconf_list    *list = NULL;
-    netconf_node    *node = NULL;
-    unsigned int     ifindex = 0;
-    te_errno         rc = 0;
+    netconf_list    *list;
+    netconf_node    *node;
 
-    if ((ifindex = if_nametoindex(ifname)) == 0)
+    list = rcf_pch_snapshot_get(IFACE_LINK_DUMP_KEY);
+    if (list == NULL)
     {
-        rc = te_rc_os2te(errno);
-        ERROR("%s(): cannot obtain interface index for '%s'",
-              __FUNCTION__, ifname);
-        return TE_RC(TE_TA_UNIX, rc);
-    }
+        if ((list = netconf_link_dump(nh)) == NULL)
+        {
+            ERROR("%s(): Cannot get list of interfaces",
+                  __FUNCTION__);
+            return TE_RC(TE_TA_UNIX, TE_ENOENT);
+        }
 
-    if ((list = netconf_link_dump(nh)) == NULL)
-    {
-        ERROR("%s(): Cannot get list of interfaces",
-              __FUNCTION__);
-        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+        rcf_pch_snapshot_put(IFACE_LINK_DUMP_KEY, list,
+                             iface_link_dump_free);
     }
 
     for (node = list->head; node != NULL; node = node->next)
     {
-        const netconf_link *link = &(node->data.link);
-
-        if (ifindex == (unsigned int)(link->ifindex))
+        if (node->data.link.ifname != NULL &&
+            strcmp(node->data.link.ifname, ifname) == 0)
         {
-            rc = 0;
+            *link = &node->data.link;
+            return 0;
+        }
+    }
 
-            switch (prop)
-            {
-                case IF_PROP_PARENT:
+    ERROR("%s(): cannot find interface '%s'", __FUNCTION__, ifname);
 
-                    if (link->link != (int)ifindex &&
-                        link->link != 0)
-                    {
-                        if (if_indextoname(link->link, value) == NULL)
-                        {
-                            /* No such device in the current namespace -
-                             * return empty string but don't fail. */
-                            if (errno == ENXIO)
-                            {
-                                *value = '\0';
-                            }
-                            else
-                            {
-                                rc = te_rc_os2te(errno);
-                                ERROR("%s(): cannot obtain interface "
-                                      "name for index %d",
-                                      __FUNCTION__, link->link);
-                            }
-                        }
-                    }
+    return TE_RC(TE_TA_UNIX, TE_ENOENT);
+}
 
-                    break;
+/**
+ * Get a propery of the interface (using libnetconf).
+ *
+ * @param ifname        Name of the interface (like "eth0").
+ * @param value         Where to save an answer.
+ * @param prop          Which property to get.
+ *
+ * @return              Status code.
+ */
+static te_errno
+iface_get_property_netconf(const char *ifname,
+                           char *value,
+                           if_property prop)
+{
+    const netconf_link  *link = NULL;
+    te_errno             rc = 0;
 
-                case IF_PROP_KIND:
+    rc = iface_link_find(ifname, &link);
+    if (rc != 0)
+        return rc;
+
+    switch (prop)
+    {
+        case IF_PROP_PARENT:
 
-                    if (link->info_kind != NULL)
+            if (link->link != link->ifindex &&
+                link->link != 0)
+            {
+                if (if_indextoname(link->link, value) == NULL)
+                {
+                    /* No such device in the current namespace -
+                     * return empty string but don't fail. */
+                    if (errno == ENXIO)
                     {
-                        size_t length;
-
-                        /* 1 is for terminating '\0'. */
-                        length = strlen(link->info_kind) + 1;
-                        if (length <= RCF_MAX_VAL)
-                        {
-                            memcpy(value, link->info_kind, length);
-                        }
-                        else
-                        {
-                            ERROR("%s(): too long interface type",
-                                  __FUNCTION__);
-                            rc = TE_ESMALLBUF;
-                        }
+                        *value = '\0';
                     }
+                    else
+                    {
+                        rc = te_rc_os2te(errno);
+                        ERROR("%s(): cannot obtain interface "
+                              "name for index %d",
+                              __FUNCTION__, link->link);
+                    }
+                }
+            }
 
-                    break;
+            break;
 
-                case IF_PROP_BCAST_ADDR:
+        case IF_PROP_KIND:
 
-                    link_addr_n2a(link->broadcast, link->addrlen,
-                                  value, RCF_MAX_VAL);
-                    break;
-
-                default:
+            if (link->info_kind != NULL)
+            {
+                size_t length;
 
-                    ERROR("%s(): unknown interface property requested",
+                /* 1 is for terminating '\0'. */
+                length = strlen(link->info_kind) + 1;
+                if (length <= RCF_MAX_VAL)
+                {
+                    memcpy(value, link->info_kind, length);
+                }
+                else
+                {
+                    ERROR("%s(): too long interface type",
                           __FUNCTION__);
-                    rc = TE_EINVAL;
+                    rc = TE_ESMALLBUF;
+                }
             }
 
             break;
-        }
-    }
 
-    netconf_list_free(list);
+        case IF_PROP_BCAST_ADDR:
 
-    if (node == NULL)
-    {
-        ERROR("%s(): cannot find interface '%s'",
-              __FUNCTION__, ifname);
-        rc = TE_ENOENT;
+            link_addr_n2a(link->broadcast, link->addrlen,
+                          value, RCF_MAX_VAL);
+            break;
+
+        default:
+
+            ERROR("%s(): unknown interface property requested",
+                  __FUNCTION__);
+            rc = TE_EINVAL;
     }
 
     if (rc != 0)
@@ -5559,6 +5596,20 @@ mtu_get(unsigned int gid, const char *oid, char *value,
     if ((rc = CHECK_INTERFACE(ifname)) != 0)
         return TE_RC(TE_TA_UNIX, rc);
 
+#ifdef USE_LIBNETCONF
+    /* A single ioctl() is cheaper than a dump unless it is shared */
+    if (rcf_pch_snapshot_active())
+    {
+        const netconf_link *link;
+
+        rc = iface_link_find(ifname, &link);
+        if (rc != 0)
+            return rc;
+
+        sprintf(value, "%u", link->mtu);
+        return 0;
+    }
+#endif
 #if defined(SIOCGIFMTU)  && defined(HAVE_STRUCT_IFREQ_IFR_MTU)   || \
     defined(SIOCGLIFMTU) && defined(HAVE_STRUCT_LIFREQ_LIFR_MTU)
     {
@@ -5878,6 +5929,23 @@ status_get(unsigned int gid, const char *oid, char *value,
     UNUSED(gid);
     UNUSED(oid);
 
+#ifdef USE_LIBNETCONF
+    /* A single ioctl() is cheaper than a dump unless it is shared */
+    if (rcf_pch_snapshot_active())
+    {
+        const netconf_link *link;
+
+        if ((rc = CHECK_INTERFACE(ifname)) != 0)
+            return TE_RC(TE_TA_UNIX, rc);
+
+        rc = iface_link_find(ifname, &link);
+        if (rc != 0)
+            return rc;
+
+        sprintf(value, "%d", !!(link->flags & IFF_UP));
+        return 0;
+    }
+#endif
     rc = ta_interface_status_get(ifname, &status);
     if (rc != 0)
         return rc;
@@ -0,0 +1,897 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Devlink support
+ *
+ * Configuration tree support for devlink ports, health reporters,
+ * resources and packet traps of PCI devices. Devlink notifications
+ * may be logged by a dedicated thread.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Conf Devlink"
+
+#include "te_config.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "te_stdint.h"
+#include "te_errno.h"
+#include "te_defs.h"
+#include "te_string.h"
+#include "te_str.h"
+#include "logger_api.h"
+#include "rcf_pch.h"
+#include "unix_internal.h"
+
+#ifdef USE_LIBNETCONF
+#include "netconf.h"
+
+/** Bus name of PCI devices in devlink */
+#define DEVLINK_PCI_BUS "pci"
+
+/** Types of cached devlink objects */
+typedef enum devlink_obj {
+    DEVLINK_OBJ_PORT,
+    DEVLINK_OBJ_HEALTH,
+    DEVLINK_OBJ_RESOURCE,
+    DEVLINK_OBJ_TRAP,
+    DEVLINK_OBJ_NUM,
+} devlink_obj;
+
+/** Cache of devlink objects of one type */
+typedef struct devlink_cache {
+    netconf_list *list;     /**< Dumped objects */
+    unsigned int gid;       /**< Group ID for which the cache was
+                                 obtained */
+    char *addr;             /**< PCI address for which the cache was
+                                 obtained (resources are dumped
+                                 per device) */
+} devlink_cache;
+
+/** Netconf session used to get and set devlink objects */
+static netconf_handle nh_devlink = NULL;
+
+/** Caches of devlink objects */
+static devlink_cache caches[DEVLINK_OBJ_NUM];
+
+/** Whether the thread logging devlink notifications is running */
+static te_bool events_enabled = FALSE;
+/** Thread logging devlink notifications */
+static pthread_t events_thread;
+/** Netconf session subscribed to devlink notifications */
+static netconf_handle nh_events = NULL;
+
+/* Drop cached objects of a given type */
+static void
+cache_invalidate(devlink_obj obj)
+{
+    netconf_list_free(caches[obj].list);
+    caches[obj].list = NULL;
+    free(caches[obj].addr);
+    caches[obj].addr = NULL;
+}
+
+/* Get devlink objects of a given type, dump them if necessary */
+static te_errno
+cache_get(unsigned int gid, devlink_obj obj, const char *addr_str,
+          netconf_list **list)
+{
+    devlink_cache *cache = &caches[obj];
+    te_errno rc = 0;
+
+    if (cache->list != NULL &&
+        (cache->gid != gid ||
+         (obj == DEVLINK_OBJ_RESOURCE &&
+          strcmp(cache->addr, addr_str) != 0)))
+        cache_invalidate(obj);
+
+    if (cache->list == NULL)
+    {
+        switch (obj)
+        {
+            case DEVLINK_OBJ_PORT:
+                rc = netconf_devlink_port_dump(nh_devlink, &cache->list);
+                break;
+
+            case DEVLINK_OBJ_HEALTH:
+                rc = netconf_devlink_health_dump(nh_devlink, &cache->list);
+                break;
+
+            case DEVLINK_OBJ_RESOURCE:
+                rc = netconf_devlink_resource_dump(nh_devlink,
+                                                   DEVLINK_PCI_BUS,
+                                                   addr_str,
+                                                   &cache->list);
+                if (rc == 0)
+                    cache->addr = strdup(addr_str);
+                break;
+
+            case DEVLINK_OBJ_TRAP:
+                rc = netconf_devlink_trap_dump(nh_devlink, &cache->list);
+                break;
+
+            default:
+                return TE_EINVAL;
+        }
+
+        /*
+         * Devices without devlink instance and kernels without
+         * support of the objects are reported in the same way.
+         */
+        if (rc == TE_ENODEV || rc == TE_EOPNOTSUPP || rc == TE_EINVAL)
+            rc = TE_ENOENT;
+        if (rc != 0)
+            return rc;
+
+        cache->gid = gid;
+    }
+
+    *list = cache->list;
+    return 0;
+}
+
+/* Check that devlink object belongs to a given PCI device */
+static te_bool
+obj_of_device(const char *bus_name, const char *dev_name,
+              const char *addr_str)
+{
+    return bus_name != NULL && dev_name != NULL &&
+           strcmp(bus_name, DEVLINK_PCI_BUS) == 0 &&
+           strcmp(dev_name, addr_str) == 0;
+}
+
+/* Find devlink port of PCI device by index */
+static te_errno
+find_port(unsigned int gid, const char *addr_str, const char *index_str,
+          netconf_devlink_port **port_out)
+{
+    netconf_list *list;
+    netconf_node *node;
+    netconf_devlink_port *port;
+    unsigned int index;
+    te_errno rc;
+
+    rc = te_strtoui(index_str, 10, &index);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    rc = cache_get(gid, DEVLINK_OBJ_PORT, addr_str, &list);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    for (node = list->head; node != NULL; node = node->next)
+    {
+        port = &node->data.devlink_port;
+        if (obj_of_device(port->bus_name, port->dev_name, addr_str) &&
+            port->index == index)
+        {
+            *port_out = port;
+            return 0;
+        }
+    }
+
+    return TE_RC(TE_TA_UNIX, TE_ENOENT);
+}
+
+/*
+ * Find health reporter of PCI device by name. Reporters of devlink
+ * ports are not considered.
+ */
+static te_errno
+find_health(unsigned int gid, const char *addr_str, const char *name,
+            netconf_devlink_health **health_out)
+{
+    netconf_list *list;
+    netconf_node *node;
+    netconf_devlink_health *health;
+    te_errno rc;
+
+    rc = cache_get(gid, DEVLINK_OBJ_HEALTH, addr_str, &list);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    for (node = list->head; node != NULL; node = node->next)
+    {
+        health = &node->data.devlink_health;
+        if (obj_of_device(health->bus_name, health->dev_name, addr_str) &&
+            !health->has_port && health->name != NULL &&
+            strcmp(health->name, name) == 0)
+        {
+            *health_out = health;
+            return 0;
+        }
+    }
+
+    return TE_RC(TE_TA_UNIX, TE_ENOENT);
+}
+
+/* Find resource of PCI device by ID */
+static te_errno
+find_resource(unsigned int gid, const char *addr_str, const char *id_str,
+              netconf_devlink_resource **res_out)
+{
+    netconf_list *list;
+    netconf_node *node;
+    uintmax_t id;
+    te_errno rc;
+
+    rc = te_strtoumax(id_str, 10, &id);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    rc = cache_get(gid, DEVLINK_OBJ_RESOURCE, addr_str, &list);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    for (node = list->head; node != NULL; node = node->next)
+    {
+        if (node->data.devlink_resource.id == id)
+        {
+            *res_out = &node->data.devlink_resource;
+            return 0;
+        }
+    }
+
+    return TE_RC(TE_TA_UNIX, TE_ENOENT);
+}
+
+/* Find packet trap of PCI device by name */
+static te_errno
+find_trap(unsigned int gid, const char *addr_str, const char *name,
+          netconf_devlink_trap **trap_out)
+{
+    netconf_list *list;
+    netconf_node *node;
+    netconf_devlink_trap *trap;
+    te_errno rc;
+
+    rc = cache_get(gid, DEVLINK_OBJ_TRAP, addr_str, &list);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    for (node = list->head; node != NULL; node = node->next)
+    {
+        trap = &node->data.devlink_trap;
+        if (obj_of_device(trap->bus_name, trap->dev_name, addr_str) &&
+            trap->name != NULL && strcmp(trap->name, name) == 0)
+        {
+            *trap_out = trap;
+            return 0;
+        }
+    }
+
+    return TE_RC(TE_TA_UNIX, TE_ENOENT);
+}
+
+/* List devlink objects of a given type of PCI device */
+static te_errno
+devlink_obj_list(unsigned int gid, devlink_obj obj, const char *addr_str,
+                 char **list)
+{
+    te_string str = TE_STRING_INIT;
+    netconf_list *objs;
+    netconf_node *node;
+    te_errno rc;
+
+    rc = cache_get(gid, obj, addr_str, &objs);
+    if (rc != 0)
+    {
+        if (rc == TE_ENOENT)
+        {
+            *list = NULL;
+            return 0;
+        }
+
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    for (node = objs->head; node != NULL; node = node->next)
+    {
+        switch (obj)
+        {
+            case DEVLINK_OBJ_PORT:
+            {
+                netconf_devlink_port *port = &node->data.devlink_port;
+
+                if (obj_of_device(port->bus_name, port->dev_name,
+                                  addr_str))
+                    te_string_append(&str, "%u ", port->index);
+                break;
+            }
+
+            case DEVLINK_OBJ_HEALTH:
+            {
+                netconf_devlink_health *health =
+                                    &node->data.devlink_health;
+
+                if (obj_of_device(health->bus_name, health->dev_name,
+                                  addr_str) &&
+                    !health->has_port && health->name != NULL)
+                    te_string_append(&str, "%s ", health->name);
+                break;
+            }
+
+            case DEVLINK_OBJ_RESOURCE:
+                te_string_append(&str, "%" PRIu64 " ",
+                                 node->data.devlink_resource.id);
+                break;
+
+            case DEVLINK_OBJ_TRAP:
+            {
+                netconf_devlink_trap *trap = &node->data.devlink_trap;
+
+                if (obj_of_device(trap->bus_name, trap->dev_name,
+                                  addr_str) &&
+                    trap->name != NULL)
+                    te_string_append(&str, "%s ", trap->name);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    *list = str.ptr;
+    return 0;
+}
+
+#define DEVLINK_OBJ_LIST(_name, _obj) \
+    static te_errno                                                     \
+    devlink_##_name##_list(unsigned int gid, const char *oid,           \
+                           const char *sub_id, char **list,             \
+                           const char *unused1, const char *unused2,    \
+                           const char *addr_str)                        \
+    {                                                                   \
+        UNUSED(oid);                                                    \
+        UNUSED(sub_id);                                                 \
+        UNUSED(unused1);                                                \
+        UNUSED(unused2);                                                \
+                                                                        \
+        return devlink_obj_list(gid, _obj, addr_str, list);             \
+    }
+
+DEVLINK_OBJ_LIST(port, DEVLINK_OBJ_PORT)
+DEVLINK_OBJ_LIST(health, DEVLINK_OBJ_HEALTH)
+DEVLINK_OBJ_LIST(resource, DEVLINK_OBJ_RESOURCE)
+DEVLINK_OBJ_LIST(trap, DEVLINK_OBJ_TRAP)
+
+#undef DEVLINK_OBJ_LIST
+
+/* Get split count of a port */
+static te_errno
+devlink_port_split_get(unsigned int gid, const char *oid, char *value,
+                       const char *unused1, const char *unused2,
+                       const char *addr_str, const char *index_str)
+{
+    netconf_devlink_port *port;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_port(gid, addr_str, index_str, &port);
+    if (rc != 0)
+        return rc;
+
+    rc = te_snprintf(value, RCF_MAX_VAL, "%u", port->split_count);
+    return TE_RC(TE_TA_UNIX, rc);
+}
+
+/* Split a port to a given number of subports or unsplit it if 0 */
+static te_errno
+devlink_port_split_set(unsigned int gid, const char *oid,
+                       const char *value, const char *unused1,
+                       const char *unused2, const char *addr_str,
+                       const char *index_str)
+{
+    netconf_devlink_port *port;
+    unsigned int count;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_port(gid, addr_str, index_str, &port);
+    if (rc != 0)
+        return rc;
+
+    rc = te_strtoui(value, 10, &count);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    rc = netconf_devlink_port_split(nh_devlink, DEVLINK_PCI_BUS, addr_str,
+                                    port->index, count);
+    /* Ports are renumbered after split */
+    cache_invalidate(DEVLINK_OBJ_PORT);
+    if (rc != 0)
+    {
+        ERROR("%s(): failed to %s port %s of %s: %r", __FUNCTION__,
+              count == 0 ? "unsplit" : "split", index_str, addr_str, rc);
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    return 0;
+}
+
+/* Get number of recoveries, triggering a recovery is write-only */
+static te_errno
+devlink_health_recover_get(unsigned int gid, const char *oid, char *value,
+                           const char *unused1, const char *unused2,
+                           const char *addr_str, const char *name)
+{
+    netconf_devlink_health *health;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_health(gid, addr_str, name, &health);
+    if (rc != 0)
+        return rc;
+
+    rc = te_snprintf(value, RCF_MAX_VAL, "0");
+    return TE_RC(TE_TA_UNIX, rc);
+}
+
+/* Trigger recovery of a health reporter */
+static te_errno
+devlink_health_recover_set(unsigned int gid, const char *oid,
+                           const char *value, const char *unused1,
+                           const char *unused2, const char *addr_str,
+                           const char *name)
+{
+    netconf_devlink_health *health;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_health(gid, addr_str, name, &health);
+    if (rc != 0)
+        return rc;
+
+    if (strcmp(value, "0") == 0)
+        return 0;
+    if (strcmp(value, "1") != 0)
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+
+    rc = netconf_devlink_health_recover(nh_devlink, DEVLINK_PCI_BUS,
+                                        addr_str, name);
+    cache_invalidate(DEVLINK_OBJ_HEALTH);
+    if (rc != 0)
+    {
+        ERROR("%s(): failed to recover '%s' of %s: %r", __FUNCTION__,
+              name, addr_str, rc);
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    return 0;
+}
+
+/* Get size of a resource */
+static te_errno
+devlink_resource_size_get(unsigned int gid, const char *oid, char *value,
+                          const char *unused1, const char *unused2,
+                          const char *addr_str, const char *id_str)
+{
+    netconf_devlink_resource *res;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_resource(gid, addr_str, id_str, &res);
+    if (rc != 0)
+        return rc;
+
+    rc = te_snprintf(value, RCF_MAX_VAL, "%" PRIu64, res->size);
+    return TE_RC(TE_TA_UNIX, rc);
+}
+
+/*
+ * Set size of a resource. The new size is applied by the driver
+ * after devlink reload, till then it is reported in "size_new".
+ */
+static te_errno
+devlink_resource_size_set(unsigned int gid, const char *oid,
+                          const char *value, const char *unused1,
+                          const char *unused2, const char *addr_str,
+                          const char *id_str)
+{
+    netconf_devlink_resource *res;
+    uintmax_t size;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_resource(gid, addr_str, id_str, &res);
+    if (rc != 0)
+        return rc;
+
+    rc = te_strtoumax(value, 10, &size);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    rc = netconf_devlink_resource_set(nh_devlink, DEVLINK_PCI_BUS,
+                                      addr_str, res->id, size);
+    cache_invalidate(DEVLINK_OBJ_RESOURCE);
+    if (rc != 0)
+    {
+        ERROR("%s(): failed to set size of resource %s of %s: %r",
+              __FUNCTION__, id_str, addr_str, rc);
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    return 0;
+}
+
+/* Get action of a packet trap */
+static te_errno
+devlink_trap_action_get(unsigned int gid, const char *oid, char *value,
+                        const char *unused1, const char *unused2,
+                        const char *addr_str, const char *name)
+{
+    netconf_devlink_trap *trap;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_trap(gid, addr_str, name, &trap);
+    if (rc != 0)
+        return rc;
+
+    rc = te_snprintf(value, RCF_MAX_VAL, "%s",
+                     devlink_trap_action_netconf2str(trap->action));
+    return TE_RC(TE_TA_UNIX, rc);
+}
+
+/* Set action of a packet trap */
+static te_errno
+devlink_trap_action_set(unsigned int gid, const char *oid,
+                        const char *value, const char *unused1,
+                        const char *unused2, const char *addr_str,
+                        const char *name)
+{
+    netconf_devlink_trap *trap;
+    netconf_devlink_trap_action action;
+    te_errno rc;
+
+    UNUSED(oid);
+    UNUSED(unused1);
+    UNUSED(unused2);
+
+    rc = find_trap(gid, addr_str, name, &trap);
+    if (rc != 0)
+        return rc;
+
+    action = devlink_trap_action_str2netconf(value);
+    if (action == NETCONF_DEVLINK_TRAP_ACTION_UNDEF)
+    {
+        ERROR("%s(): unknown trap action '%s'", __FUNCTION__, value);
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+    }
+
+    rc = netconf_devlink_trap_set(nh_devlink, DEVLINK_PCI_BUS, addr_str,
+                                  name, action);
+    cache_invalidate(DEVLINK_OBJ_TRAP);
+    if (rc != 0)
+    {
+        ERROR("%s(): failed to set action of trap '%s' of %s: %r",
+              __FUNCTION__, name, addr_str, rc);
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    return 0;
+}
+
+#define DEVLINK_NODE_RO(_obj, _attr, _fmt, _expr, _sibling)             \
+    static te_errno                                                     \
+    devlink_##_obj##_##_attr##_get(unsigned int gid, const char *oid,   \
+                                   char *value, const char *unused1,    \
+                                   const char *unused2,                 \
+                                   const char *addr_str,                \
+                                   const char *key)                     \
+    {                                                                   \
+        netconf_devlink_##_obj *_obj;                                   \
+        te_errno rc;                                                    \
+                                                                        \
+        UNUSED(oid);                                                    \
+        UNUSED(unused1);                                                \
+        UNUSED(unused2);                                                \
+                                                                        \
+        rc = find_##_obj(gid, addr_str, key, &_obj);                    \
+        if (rc != 0)                                                    \
+            return rc;                                                  \
+                                                                        \
+        rc = te_snprintf(value, RCF_MAX_VAL, _fmt, _expr);              \
+        return TE_RC(TE_TA_UNIX, rc);                                   \
+    }                                                                   \
+                                                                        \
+    RCF_PCH_CFG_NODE_RO(node_devlink_##_obj##_##_attr, #_attr, NULL,    \
+                        (_sibling),                                     \
+                        devlink_##_obj##_##_attr##_get)
+
+RCF_PCH_CFG_NODE_RW(node_devlink_port_split, "split", NULL, NULL,
+                    devlink_port_split_get, devlink_port_split_set);
+DEVLINK_NODE_RO(port, netdev, "%s", te_str_empty_if_null(port->netdev_name),
+                &node_devlink_port_split);
+DEVLINK_NODE_RO(port, flavour, "%u", port->flavour,
+                &node_devlink_port_netdev);
+DEVLINK_NODE_RO(port, type, "%u", port->type,
+                &node_devlink_port_flavour);
+
+RCF_PCH_CFG_NODE_RW(node_devlink_health_recover, "recover", NULL, NULL,
+                    devlink_health_recover_get, devlink_health_recover_set);
+DEVLINK_NODE_RO(health, recover_count, "%" PRIu64, health->recover_count,
+                &node_devlink_health_recover);
+DEVLINK_NODE_RO(health, error_count, "%" PRIu64, health->error_count,
+                &node_devlink_health_recover_count);
+DEVLINK_NODE_RO(health, state, "%s", health->error ? "error" : "healthy",
+                &node_devlink_health_error_count);
+
+DEVLINK_NODE_RO(resource, occ, "%" PRIu64, resource->occ, NULL);
+DEVLINK_NODE_RO(resource, size_new, "%" PRIu64, resource->size_new,
+                &node_devlink_resource_occ);
+RCF_PCH_CFG_NODE_RW(node_devlink_resource_size, "size",
+                    NULL, &node_devlink_resource_size_new,
+                    devlink_resource_size_get, devlink_resource_size_set);
+DEVLINK_NODE_RO(resource, path, "%s", resource->path,
+                &node_devlink_resource_size);
+
+DEVLINK_NODE_RO(trap, rx_bytes, "%" PRIu64, trap->rx_bytes, NULL);
+DEVLINK_NODE_RO(trap, rx_packets, "%" PRIu64, trap->rx_packets,
+                &node_devlink_trap_rx_bytes);
+RCF_PCH_CFG_NODE_RW(node_devlink_trap_action, "action",
+                    NULL, &node_devlink_trap_rx_packets,
+                    devlink_trap_action_get, devlink_trap_action_set);
+DEVLINK_NODE_RO(trap, group, "%s", te_str_empty_if_null(trap->group_name),
+                &node_devlink_trap_action);
+
+#undef DEVLINK_NODE_RO
+
+RCF_PCH_CFG_NODE_RO_COLLECTION(node_devlink_trap, "trap",
+                               &node_devlink_trap_group, NULL,
+                               NULL, devlink_trap_list);
+RCF_PCH_CFG_NODE_RO_COLLECTION(node_devlink_resource, "resource",
+                               &node_devlink_resource_path,
+                               &node_devlink_trap,
+                               NULL, devlink_resource_list);
+RCF_PCH_CFG_NODE_RO_COLLECTION(node_devlink_health, "health",
+                               &node_devlink_health_state,
+                               &node_devlink_resource,
+                               NULL, devlink_health_list);
+RCF_PCH_CFG_NODE_RO_COLLECTION(node_devlink_port, "port",
+                               &node_devlink_port_type,
+                               &node_devlink_health,
+                               NULL, devlink_port_list);
+
+/* Log devlink notification */
+static void
+log_event(const netconf_node *node)
+{
+    switch (node->type)
+    {
+        case NETCONF_NODE_DEVLINK_PORT:
+        {
+            const netconf_devlink_port *port = &node->data.devlink_port;
+
+            RING("Devlink port %s/%s/%u changed: type %u, flavour %u, "
+                 "netdev '%s', split count %u",
+                 port->bus_name, port->dev_name, port->index, port->type,
+                 port->flavour, te_str_empty_if_null(port->netdev_name),
+                 port->split_count);
+            break;
+        }
+
+        case NETCONF_NODE_DEVLINK_HEALTH:
+        {
+            const netconf_devlink_health *health =
+                                    &node->data.devlink_health;
+
+            WARN("Devlink health reporter '%s' of %s/%s: state %s, "
+                 "%" PRIu64 " errors, %" PRIu64 " recoveries",
+                 health->name, health->bus_name, health->dev_name,
+                 health->error ? "error" : "healthy",
+                 health->error_count, health->recover_count);
+            break;
+        }
+
+        case NETCONF_NODE_DEVLINK_TRAP:
+        {
+            const netconf_devlink_trap *trap = &node->data.devlink_trap;
+
+            RING("Devlink trap '%s' of %s/%s changed: group '%s', "
+                 "action %s", trap->name, trap->bus_name, trap->dev_name,
+                 te_str_empty_if_null(trap->group_name),
+                 devlink_trap_action_netconf2str(trap->action));
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/* Receive devlink notifications and log them */
+static void *
+events_thread_func(void *arg)
+{
+    netconf_list *list;
+    netconf_node *node;
+    te_errno rc;
+
+    UNUSED(arg);
+
+    while (TRUE)
+    {
+        /* The thread is cancelled only while it is waiting */
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        rc = netconf_devlink_event_recv(nh_events, &list);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+        if (rc != 0)
+        {
+            ERROR("Failed to receive devlink notifications: %r", rc);
+            break;
+        }
+
+        for (node = list->head; node != NULL; node = node->next)
+            log_event(node);
+
+        netconf_list_free(list);
+    }
+
+    return NULL;
+}
+
+/* Start logging of devlink notifications */
+static te_errno
+events_start(void)
+{
+    te_errno rc;
+
+    if (netconf_open(&nh_events, NETLINK_GENERIC) != 0)
+    {
+        rc = te_rc_os2te(errno);
+        ERROR("%s(): failed to open netconf session: %r",
+              __FUNCTION__, rc);
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    rc = netconf_devlink_event_subscribe(nh_events);
+    if (rc == 0)
+    {
+        rc = pthread_create(&events_thread, NULL, events_thread_func,
+                            NULL);
+        if (rc != 0)
+            rc = te_rc_os2te(rc);
+    }
+
+    if (rc != 0)
+    {
+        ERROR("%s(): failed to start logging of devlink "
+              "notifications: %r", __FUNCTION__, rc);
+        netconf_close(nh_events);
+        nh_events = NULL;
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    events_enabled = TRUE;
+    return 0;
+}
+
+/* Stop logging of devlink notifications */
+static void
+events_stop(void)
+{
+    pthread_cancel(events_thread);
+    pthread_join(events_thread, NULL);
+
+    netconf_close(nh_events);
+    nh_events = NULL;
+    events_enabled = FALSE;
+}
+
+/* Get whether devlink notifications are logged */
+static te_errno
+devlink_events_get(unsigned int gid, const char *oid, char *value)
+{
+    UNUSED(gid);
+    UNUSED(oid);
+
+    strcpy(value, events_enabled ? "1" : "0");
+    return 0;
+}
+
+/* Enable or disable logging of devlink notifications */
+static te_errno
+devlink_events_set(unsigned int gid, const char *oid, const char *value)
+{
+    te_bool enable;
+    te_errno rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    rc = te_strtol_bool(value, &enable);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    if (enable == events_enabled)
+        return 0;
+
+    if (enable)
+        return events_start();
+
+    events_stop();
+    return 0;
+}
+
+RCF_PCH_CFG_NODE_RW(node_devlink_events, "devlink_events", NULL, NULL,
+                    devlink_events_get, devlink_events_set);
+
+#endif /* USE_LIBNETCONF */
+
+/* Initialize devlink configuration nodes */
+te_errno
+ta_unix_conf_devlink_init(void)
+{
+#ifdef USE_LIBNETCONF
+    te_errno rc;
+
+    if (netconf_open(&nh_devlink, NETLINK_GENERIC) != 0)
+    {
+        rc = te_rc_os2te(errno);
+        ERROR("%s(): failed to open netconf session, errno=%r",
+              __FUNCTION__, rc);
+        return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    rc = rcf_pch_add_node("/agent/hardware/pci/device", &node_devlink_port);
+    if (rc != 0)
+        return rc;
+
+    return rcf_pch_add_node("/agent/hardware/pci", &node_devlink_events);
+#else
+    return 0;
+#endif
+}
+
+/* Release resources */
+te_errno
+ta_unix_conf_devlink_cleanup(void)
+{
+#ifdef USE_LIBNETCONF
+    devlink_obj obj;
+
+    if (events_enabled)
+        events_stop();
+
+    for (obj = 0; obj < DEVLINK_OBJ_NUM; obj++)
+        cache_invalidate(obj);
+
+    if (nh_devlink != NULL)
+    {
+        netconf_close(nh_devlink);
+        nh_devlink = NULL;
+    }
+#endif
+
+    return 0;
+}
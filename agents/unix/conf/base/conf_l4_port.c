@@ -24,7 +24,12 @@
 
 static int socket_family = 0;
 static int socket_type = 0;
+static int range_size = 1;
+/* Port to start search of the next port from, 0 to continue search */
+static int start_port = 0;
 static te_vec allocated_ports = TE_VEC_INIT(uint16_t);
+/* Ports allocated on get of the next port which are not added yet */
+static te_vec pending_ports = TE_VEC_INIT(uint16_t);
 static te_bool allocate_on_get = TRUE;
 static int32_t last_allocated_port = -1;
 static te_bool allocate_property_changed = FALSE;
@@ -47,6 +52,10 @@ l4_port_alloc_property_ptr_by_oid(const char *oid)
         result = &socket_family;
     else if (strcmp(prop_subid, "type") == 0)
         result = &socket_type;
+    else if (strcmp(prop_subid, "range") == 0)
+        result = &range_size;
+    else if (strcmp(prop_subid, "start") == 0)
+        result = &start_port;
 
 exit:
     cfg_free_oid(coid);
@@ -72,6 +81,13 @@ l4_port_alloc_property_set(unsigned int gid, const char *oid, const char *value)
     if (te_strtoi(value, 0, &property_value) != 0)
         return TE_RC(TE_TA_UNIX, TE_EINVAL);
 
+    if (property == &range_size && property_value <= 0)
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+
+    if (property == &start_port &&
+        (property_value < 0 || property_value > UINT16_MAX))
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+
     if (*property != property_value)
         allocate_property_changed = TRUE;
 
@@ -96,6 +112,33 @@ l4_port_alloc_property_get(unsigned int gid, const char *oid, char *value)
     return 0;
 }
 
+static int
+l4_port_vec_find(const te_vec *ports, uint16_t port)
+{
+    size_t i;
+
+    for (i = 0; i < te_vec_size(ports); i++)
+    {
+        if (TE_VEC_GET(uint16_t, ports, i) == port)
+            return i;
+    }
+
+    return -1;
+}
+
+/* Free ports allocated on get of the next port which are not added */
+static void
+l4_port_free_pending(void)
+{
+    uint16_t *p;
+
+    TE_VEC_FOREACH(&pending_ports, p)
+    {
+        agent_free_l4_port(*p);
+    }
+    te_vec_reset(&pending_ports);
+}
+
 static te_errno
 l4_port_alloc_next_get(unsigned int gid, const char *oid, char *value)
 {
@@ -107,18 +150,36 @@ l4_port_alloc_next_get(unsigned int gid, const char *oid, char *value)
     UNUSED(oid);
 
     realloc_last_port = !allocate_on_get && allocate_property_changed &&
-                        !agent_check_l4_port_is_free(socket_family, socket_type,
-                                                     last_allocated_port);
-
-    if (realloc_last_port)
-        agent_free_l4_port(last_allocated_port);
+                        (range_size != (int)te_vec_size(&pending_ports) ||
+                         last_allocated_port < start_port ||
+                         !agent_check_l4_port_is_free(socket_family,
+                                                      socket_type,
+                                                      last_allocated_port));
 
     if (allocate_on_get || realloc_last_port)
     {
-        rc = agent_alloc_l4_port(socket_family, socket_type, &port);
+        int i;
+
+        l4_port_free_pending();
+
+        rc = agent_alloc_l4_port_range_from(socket_family, socket_type,
+                                            range_size, start_port, &port);
         if (rc != 0)
             return rc;
 
+        for (i = 0; i < range_size; i++)
+        {
+            uint16_t range_port = port + i;
+
+            rc = TE_VEC_APPEND(&pending_ports, range_port);
+            if (rc != 0)
+            {
+                for (; i < range_size; i++)
+                    agent_free_l4_port(port + i);
+                return rc;
+            }
+        }
+
         last_allocated_port = port;
     }
 
@@ -132,15 +193,7 @@ l4_port_alloc_next_get(unsigned int gid, const char *oid, char *value)
 static int
 l4_port_allocated_find(uint16_t port)
 {
-    size_t i;
-
-    for (i = 0; i < te_vec_size(&allocated_ports); i++)
-    {
-        if (TE_VEC_GET(uint16_t, &allocated_ports, i) == port)
-            return i;
-    }
-
-    return -1;
+    return l4_port_vec_find(&allocated_ports, port);
 }
 
 static te_errno
@@ -150,6 +203,7 @@ l4_port_allocated_add(unsigned int gid, const char *oid, const char *value,
 {
     unsigned int port_val;
     uint16_t port;
+    int pending;
     te_errno rc;
 
     UNUSED(gid);
@@ -167,9 +221,13 @@ l4_port_allocated_add(unsigned int gid, const char *oid, const char *value,
 
     port = port_val;
 
-    if ((int32_t)port != last_allocated_port)
+    if (l4_port_allocated_find(port) >= 0)
+        return TE_RC(TE_TA_UNIX, TE_EEXIST);
+
+    pending = l4_port_vec_find(&pending_ports, port);
+    if (pending < 0)
     {
-        if (agent_alloc_l4_specified_port(socket_type, socket_family,
+        if (agent_alloc_l4_specified_port(socket_family, socket_type,
                                           port) != 0)
         {
             ERROR("Failed to add a new port");
@@ -177,12 +235,14 @@ l4_port_allocated_add(unsigned int gid, const char *oid, const char *value,
         }
     }
 
-    if (l4_port_allocated_find(port) >= 0)
-        return TE_RC(TE_TA_UNIX, TE_EEXIST);
-
     rc = TE_VEC_APPEND(&allocated_ports, port);
-    if (rc == 0)
-        allocate_on_get = TRUE;
+    if (rc != 0)
+        return rc;
+
+    if (pending >= 0)
+        te_vec_remove_index(&pending_ports, pending);
+
+    allocate_on_get = TRUE;
 
     return rc;
 }
@@ -245,9 +305,15 @@ RCF_PCH_CFG_NODE_COLLECTION(node_port_allocated, "allocated",
                     NULL, NULL,
                     l4_port_allocated_add, l4_port_allocated_del,
                     l4_port_allocated_list, NULL);
-RCF_PCH_CFG_NODE_RW(node_port_alloc_type, "type",
+RCF_PCH_CFG_NODE_RW(node_port_alloc_start, "start",
                     NULL, NULL,
                     l4_port_alloc_property_get, l4_port_alloc_property_set);
+RCF_PCH_CFG_NODE_RW(node_port_alloc_range, "range",
+                    NULL, &node_port_alloc_start,
+                    l4_port_alloc_property_get, l4_port_alloc_property_set);
+RCF_PCH_CFG_NODE_RW(node_port_alloc_type, "type",
+                    NULL, &node_port_alloc_range,
+                    l4_port_alloc_property_get, l4_port_alloc_property_set);
 RCF_PCH_CFG_NODE_RW(node_port_alloc_family, "family",
                     NULL, &node_port_alloc_type,
                     l4_port_alloc_property_get, l4_port_alloc_property_set);
@@ -45,6 +45,14 @@
 #include <sys/stat.h>
 #endif
 
+#if HAVE_NET_IF_H
+#include <net/if.h>
+#endif
+
+#if HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif
+
 #include "conf_netconf.h"
 #include "conf_common.h"
 #include "rcf_ch_api.h"
@@ -53,6 +61,7 @@
 #include "te_alloc.h"
 #include "agentlib.h"
 #include "unix_internal.h"
+#include "logfork.h"
 
 #include "netconf.h"
 
@@ -87,11 +96,25 @@ typedef struct netns_interface {
     char *name;
 } netns_interface;
 
+/* Sub-agent serving a network namespace. */
+typedef struct netns_subagent {
+    SLIST_ENTRY(netns_subagent)  ent_l;
+    char *name;
+} netns_subagent;
+
 /* Network namespace structure. */
 typedef struct netns_namespace {
     SLIST_ENTRY(netns_namespace)  ent_l;
     SLIST_HEAD(, netns_interface) ifs_h;
+    SLIST_HEAD(, netns_subagent)  subagents_h;
     char *name;
+    netconf_handle nh;  /* Netconf session in the namespace, opened on
+                           the first use */
+    ino_t nh_ino;       /* Inode of the namespace the session is
+                           bound to */
+    netconf_list *links;    /* Interfaces of the namespace dumped while
+                               processing the request @p links_gid */
+    unsigned int links_gid; /* Group identifier of the request */
 } netns_namespace;
 
 /* Head of the network namespaces list. */
@@ -185,6 +208,43 @@ netns_interface_release(netns_interface *netif)
     free(netif);
 }
 
+/**
+ * Stop a sub-agent and release memory allocated for
+ * a @b netns_subagent object.
+ */
+static void
+netns_subagent_release(netns_subagent *sub)
+{
+    (void)rcf_pch_subagent_stop(sub->name);
+    free(sub->name);
+    free(sub);
+}
+
+/**
+ * Drop the cached dump of interfaces of a namespace, it must be done
+ * when the interfaces are changed.
+ */
+static void
+netns_links_invalidate(netns_namespace *netns)
+{
+    netconf_list_free(netns->links);
+    netns->links = NULL;
+    netns->links_gid = (unsigned int)-1;
+}
+
+/**
+ * Close netconf session bound to a namespace.
+ */
+static void
+netns_netconf_close(netns_namespace *netns)
+{
+    netns_links_invalidate(netns);
+
+    if (netns->nh != NULL)
+        netconf_close(netns->nh);
+    netns->nh = NULL;
+}
+
 /**
  * Release memory allocated for a @b netns_namespace object.
  */
@@ -192,6 +252,14 @@ static void
 netns_namespace_release(netns_namespace *netns)
 {
     netns_interface *netif;
+    netns_subagent  *sub;
+
+    while (SLIST_EMPTY(&netns->subagents_h) == FALSE)
+    {
+        sub = SLIST_FIRST(&netns->subagents_h);
+        SLIST_REMOVE_HEAD(&netns->subagents_h, ent_l);
+        netns_subagent_release(sub);
+    }
 
     while (SLIST_EMPTY(&netns->ifs_h) == FALSE)
     {
@@ -200,6 +268,8 @@ netns_namespace_release(netns_namespace *netns)
         netns_interface_release(netif);
     }
 
+    netns_netconf_close(netns);
+
     free(netns->name);
     free(netns);
 }
@@ -225,6 +295,8 @@ netns_namespace_add(const char *ns_name)
         return TE_RC(TE_TA_UNIX, TE_ENOMEM);
     }
     SLIST_INIT(&netns->ifs_h);
+    SLIST_INIT(&netns->subagents_h);
+    netns->links_gid = (unsigned int)-1;
     SLIST_INSERT_HEAD(&netns_h, netns, ent_l);
 
     return 0;
@@ -297,6 +369,8 @@ netns_interface_add(unsigned int gid, const char *oid, const char *value,
     if (rc != 0)
         return rc;
 
+    netns_links_invalidate(netns);
+
     netif = TE_ALLOC(sizeof(*netif));
 
     netif->name = strdup(if_name);
@@ -337,41 +411,63 @@ netns_switch(const char *ns_name)
 }
 
 /**
- * Entry point to the process for moving an interface from a network
- * namespace to the parent process namespace.
+ * Get netconf session bound to network namespace @p ns_name. The session
+ * is opened on the first use and kept while the namespace file refers to
+ * the same namespace: if the namespace is deleted and created again with
+ * the same name, the session is reopened in the new namespace.
  *
  * @param ns_name   The namespace name.
- * @param if_name   The interface name.
+ * @param netns_out Where to save the namespace object (may be @c NULL).
+ * @param nh_ns     Where to save the session handle.
  *
- * @return Exit code.
+ * @return Status code.
  */
-int
-netns_unset_interface_process(const char *ns_name, const char *if_name)
+static te_errno
+netns_get_netconf(const char *ns_name, netns_namespace **netns_out,
+                  netconf_handle *nh_ns)
 {
-    te_errno        rc;
-    netconf_handle  nch;
+    netns_namespace *netns;
+    struct stat      st;
+    te_errno         rc;
+    int              fd;
+
+    rc = netns_namespace_find_by_name(ns_name, &netns);
+    if (rc != 0)
+        return rc;
 
-    rc = netns_switch(ns_name);
+    rc = netns_get_fd(ns_name, &fd);
     if (rc != 0)
+        return rc;
+
+    if (fstat(fd, &st) != 0)
     {
-        ERROR("Failed to move process to namespace %s: %r", ns_name, rc);
-        exit(EXIT_FAILURE);
+        rc = TE_OS_RC(TE_TA_UNIX, errno);
+        ERROR("Cannot get status of namespace %s file: %r", ns_name, rc);
     }
-
-    if (netconf_open(&nch, NETLINK_ROUTE) < 0)
+    else if (netns->nh == NULL || netns->nh_ino != st.st_ino)
     {
-        ERROR("Cannot open netconf session: %s", strerror(errno));
-        exit(EXIT_FAILURE);
+        netns_netconf_close(netns);
+
+        if (netconf_open_ns(&netns->nh, NETLINK_ROUTE, fd) != 0)
+        {
+            rc = TE_OS_RC(TE_TA_UNIX, errno);
+            ERROR("Cannot open netconf session in namespace %s: %r",
+                  ns_name, rc);
+            netns->nh = NULL;
+        }
+        else
+        {
+            netns->nh_ino = st.st_ino;
+        }
     }
 
-    rc = netconf_link_set_ns(nch, if_name, -1, getppid());
-    netconf_close(nch);
+    NETNS_CLOSE_FD(fd);
     if (rc != 0)
-    {
-        ERROR("Failed to move interface %s to the parent namespace %s: %r",
-              if_name, ns_name, rc);
-        exit(EXIT_FAILURE);
-    }
+        return rc;
+
+    if (netns_out != NULL)
+        *netns_out = netns;
+    *nh_ns = netns->nh;
 
     return 0;
 }
@@ -394,19 +490,13 @@ netns_interface_del(unsigned int gid, const char *oid, const char *ns,
 {
     netns_namespace *netns;
     netns_interface *netif;
+    netconf_handle   nh_ns;
     te_errno         rc;
-    pid_t            pid;
-    int              status;
-    int              argc = 2;
-    const char      *params[argc];
 
     UNUSED(gid);
     UNUSED(oid);
     UNUSED(ns);
 
-    params[0] = ns_name;
-    params[1] = if_name;
-
     rc = netns_namespace_find_by_name(ns_name, &netns);
     if (rc != 0)
         return rc;
@@ -415,25 +505,23 @@ netns_interface_del(unsigned int gid, const char *oid, const char *ns,
     if (rc != 0)
         return rc;
 
-    if ((rc = rcf_ch_start_process(&pid, -1,
-                                   "netns_unset_interface_process", FALSE,
-                                   argc, (void **)params)) != 0)
-    {
-        ERROR("Failed to start auxiliary process");
+    rc = netns_get_netconf(ns_name, NULL, &nh_ns);
+    if (rc != 0)
         return rc;
-    }
 
-    if (ta_waitpid(pid, &status, 0) <= 0)
-    {
-        ERROR("Failed to get status of the interface moving process");
-        return TE_OS_RC(TE_TA_UNIX, errno);
-    }
-    if (status != 0)
+    /*
+     * The request is processed in the namespace of the session,
+     * the PID selects the namespace of the agent process.
+     */
+    rc = netconf_link_set_ns(nh_ns, if_name, -1, getpid());
+    if (rc != 0)
     {
-        ERROR("Non-zero status of the interface moving process: %d", status);
-        return TE_RC(TE_TA_UNIX, TE_ESHCMD);
+        ERROR("Failed to move interface %s from the namespace %s: %r",
+              if_name, ns_name, rc);
+        return rc;
     }
 
+    netns_links_invalidate(netns);
     SLIST_REMOVE(&netns->ifs_h, netif, netns_interface, ent_l);
     netns_interface_release(netif);
 
@@ -486,6 +574,153 @@ netns_interface_list(unsigned int gid, const char *oid,
     return 0;
 }
 
+/**
+ * Prepare a sub-agent process: move it to the network namespace and
+ * make it serve configuration of its own Test Agent name.
+ *
+ * @param name      Sub-agent name.
+ * @param opaque    The namespace name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_subagent_enter(const char *name, void *opaque)
+{
+    const char *ns_name = opaque;
+
+    ta_name = name;
+    logfork_register_user(name);
+
+    return netns_switch(ns_name);
+}
+
+/**
+ * Start a sub-agent in a network namespace.
+ *
+ * @param gid       Group identifier (unused).
+ * @param oid       Full object instance identifier (unused).
+ * @param value     The object value (unused).
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param sub_name  The sub-agent name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_subagent_add(unsigned int gid, const char *oid, const char *value,
+                   const char *ns, const char *ns_name,
+                   const char *sub_name)
+{
+    netns_namespace *netns;
+    netns_subagent  *sub;
+    te_errno         rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(ns);
+    UNUSED(value);
+
+    rc = netns_namespace_find_by_name(ns_name, &netns);
+    if (rc != 0)
+        return rc;
+
+    rc = rcf_pch_subagent_start(sub_name, netns_subagent_enter,
+                                (void *)ns_name);
+    if (rc != 0)
+    {
+        ERROR("Failed to start sub-agent %s in the namespace %s: %r",
+              sub_name, ns_name, rc);
+        return rc;
+    }
+
+    sub = TE_ALLOC(sizeof(*sub));
+    sub->name = TE_STRDUP(sub_name);
+    SLIST_INSERT_HEAD(&netns->subagents_h, sub, ent_l);
+
+    return 0;
+}
+
+/**
+ * Stop a sub-agent of a network namespace.
+ *
+ * @param gid       Group identifier (unused).
+ * @param oid       Full object instance identifier (unused).
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param sub_name  The sub-agent name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_subagent_del(unsigned int gid, const char *oid, const char *ns,
+                   const char *ns_name, const char *sub_name)
+{
+    netns_namespace *netns;
+    netns_subagent  *sub;
+    te_errno         rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(ns);
+
+    rc = netns_namespace_find_by_name(ns_name, &netns);
+    if (rc != 0)
+        return rc;
+
+    SLIST_FOREACH(sub, &netns->subagents_h, ent_l)
+    {
+        if (strcmp(sub->name, sub_name) == 0)
+        {
+            SLIST_REMOVE(&netns->subagents_h, sub, netns_subagent, ent_l);
+            netns_subagent_release(sub);
+            return 0;
+        }
+    }
+
+    ERROR("Cannot find sub-agent %s in namespace %s", sub_name, ns_name);
+
+    return TE_RC(TE_TA_UNIX, TE_ENOENT);
+}
+
+/**
+ * Get list of sub-agents of a network namespace.
+ *
+ * @param gid       Group identifier (unused).
+ * @param oid       Full identifier of the father instance (unused).
+ * @param sub_id    ID of the object to be listed (unused).
+ * @param list      Where to save the list.
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_subagent_list(unsigned int gid, const char *oid,
+                    const char *sub_id, char **list,
+                    const char *ns, const char *ns_name)
+{
+    netns_namespace *netns;
+    netns_subagent  *sub;
+    te_string        te_str = TE_STRING_INIT;
+    te_errno         rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(sub_id);
+    UNUSED(ns);
+
+    rc = netns_namespace_find_by_name(ns_name, &netns);
+    if (rc != 0)
+        return rc;
+
+    SLIST_FOREACH(sub, &netns->subagents_h, ent_l)
+        te_string_append(&te_str, "%s ", sub->name);
+
+    *list = te_str.ptr;
+
+    return 0;
+}
+
 /**
  * Create new network namespace. Current process is naturally moved to the
  * namespace.
@@ -732,7 +967,584 @@ netns_list(unsigned int gid, const char *oid,
 }
 
 
-RCF_PCH_CFG_NODE_COLLECTION(node_interface, "interface", NULL, NULL,
+/**
+ * Get list of network interfaces in a namespace. The interfaces are
+ * dumped once while processing a request, the dump is reused for all
+ * instances accessed with the same group identifier.
+ *
+ * @param gid       Group identifier.
+ * @param ns_name   The namespace name.
+ * @param nh_ns     Where to save netconf session of the namespace.
+ * @param links     Where to save list of interfaces owned by the
+ *                  namespace object.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_links_get(unsigned int gid, const char *ns_name,
+                netconf_handle *nh_ns, netconf_list **links)
+{
+    netns_namespace *netns;
+    te_errno         rc;
+
+    rc = netns_get_netconf(ns_name, &netns, nh_ns);
+    if (rc != 0)
+        return rc;
+
+    if (netns->links == NULL || netns->links_gid != gid)
+    {
+        netns_links_invalidate(netns);
+
+        netns->links = netconf_link_dump(*nh_ns);
+        if (netns->links == NULL)
+        {
+            rc = TE_OS_RC(TE_TA_UNIX, errno);
+            ERROR("Failed to get interfaces of namespace %s: %r",
+                  ns_name, rc);
+            return rc;
+        }
+        netns->links_gid = gid;
+    }
+
+    *links = netns->links;
+
+    return 0;
+}
+
+/**
+ * Find a network interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ * @param nh_ns     Where to save netconf session of the namespace.
+ * @param link      Where to save the interface.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_link_find(unsigned int gid, const char *ns_name, const char *if_name,
+                netconf_handle *nh_ns, netconf_link **link)
+{
+    netconf_list *links;
+    netconf_node *node;
+    te_errno      rc;
+
+    rc = netns_links_get(gid, ns_name, nh_ns, &links);
+    if (rc != 0)
+        return rc;
+
+    for (node = links->head; node != NULL; node = node->next)
+    {
+        if (node->data.link.ifname != NULL &&
+            strcmp(node->data.link.ifname, if_name) == 0)
+        {
+            *link = &node->data.link;
+            return 0;
+        }
+    }
+
+    return TE_RC(TE_TA_UNIX, TE_ENOENT);
+}
+
+/**
+ * Get list of network interfaces in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param oid       Full identifier of the father instance (unused).
+ * @param sub_id    ID of the object to be listed (unused).
+ * @param list      Where to save the list.
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_link_list(unsigned int gid, const char *oid,
+                const char *sub_id, char **list,
+                const char *ns, const char *ns_name)
+{
+    netconf_handle  nh_ns;
+    netconf_list   *links;
+    netconf_node   *node;
+    te_string       te_str = TE_STRING_INIT;
+    te_errno        rc;
+
+    UNUSED(oid);
+    UNUSED(sub_id);
+    UNUSED(ns);
+
+    rc = netns_links_get(gid, ns_name, &nh_ns, &links);
+    if (rc != 0)
+        return rc;
+
+    for (node = links->head; node != NULL; node = node->next)
+    {
+        if (node->data.link.ifname != NULL)
+            te_string_append(&te_str, "%s ", node->data.link.ifname);
+    }
+
+    *list = te_str.ptr;
+
+    return 0;
+}
+
+/**
+ * Get administrative status of a network interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param oid       Full object instance identifier (unused).
+ * @param value     Where to save the status (@c 0 or @c 1).
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_link_status_get(unsigned int gid, const char *oid, char *value,
+                      const char *ns, const char *ns_name,
+                      const char *if_name)
+{
+    netconf_handle  nh_ns;
+    netconf_link   *link;
+    te_errno        rc;
+
+    UNUSED(oid);
+    UNUSED(ns);
+
+    rc = netns_link_find(gid, ns_name, if_name, &nh_ns, &link);
+    if (rc != 0)
+        return rc;
+
+    snprintf(value, RCF_MAX_VAL, "%d", (link->flags & IFF_UP) ? 1 : 0);
+
+    return 0;
+}
+
+/**
+ * Bring a network interface in a namespace up or down.
+ *
+ * @param gid       Group identifier (unused).
+ * @param oid       Full object instance identifier (unused).
+ * @param value     New status (@c 0 or @c 1).
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_link_status_set(unsigned int gid, const char *oid,
+                      const char *value, const char *ns,
+                      const char *ns_name, const char *if_name)
+{
+    netns_namespace *netns;
+    netconf_handle   nh_ns;
+    te_bool          up;
+    te_errno         rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(ns);
+
+    rc = te_strtol_bool(value, &up);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    rc = netns_get_netconf(ns_name, &netns, &nh_ns);
+    if (rc != 0)
+        return rc;
+
+    netns_links_invalidate(netns);
+
+    return netconf_link_set_up(nh_ns, if_name, up);
+}
+
+/**
+ * Get MTU of a network interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param oid       Full object instance identifier (unused).
+ * @param value     Where to save the MTU.
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_link_mtu_get(unsigned int gid, const char *oid, char *value,
+                   const char *ns, const char *ns_name,
+                   const char *if_name)
+{
+    netconf_handle  nh_ns;
+    netconf_link   *link;
+    te_errno        rc;
+
+    UNUSED(oid);
+    UNUSED(ns);
+
+    rc = netns_link_find(gid, ns_name, if_name, &nh_ns, &link);
+    if (rc != 0)
+        return rc;
+
+    snprintf(value, RCF_MAX_VAL, "%u", link->mtu);
+
+    return 0;
+}
+
+/**
+ * Set MTU of a network interface in a namespace.
+ *
+ * @param gid       Group identifier (unused).
+ * @param oid       Full object instance identifier (unused).
+ * @param value     New MTU.
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_link_mtu_set(unsigned int gid, const char *oid, const char *value,
+                   const char *ns, const char *ns_name,
+                   const char *if_name)
+{
+    netns_namespace *netns;
+    netconf_handle   nh_ns;
+    unsigned int     mtu;
+    te_errno         rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(ns);
+
+    rc = te_strtoui(value, 10, &mtu);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    rc = netns_get_netconf(ns_name, &netns, &nh_ns);
+    if (rc != 0)
+        return rc;
+
+    netns_links_invalidate(netns);
+
+    return netconf_link_set_mtu(nh_ns, if_name, mtu);
+}
+
+/**
+ * Parse network address and fill in address family and data in
+ * netconf structure.
+ *
+ * @param str       Address string.
+ * @param buf       Buffer for the address data.
+ * @param net_addr  Netconf structure.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_parse_net_addr(const char *str, struct in6_addr *buf,
+                     netconf_net_addr *net_addr)
+{
+    if (inet_pton(AF_INET, str, buf) == 1)
+        net_addr->family = AF_INET;
+    else if (inet_pton(AF_INET6, str, buf) == 1)
+        net_addr->family = AF_INET6;
+    else
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+
+    net_addr->address = (uint8_t *)buf;
+
+    return 0;
+}
+
+/**
+ * Find a network address of an interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ * @param addr      Address string or @c NULL to get all addresses.
+ * @param nh_ns     Where to save netconf session of the namespace.
+ * @param ifindex   Where to save index of the interface in the namespace.
+ * @param addrs     Where to save list of addresses which must be released
+ *                  with netconf_list_free().
+ * @param net_addr  Where to save the address (unused if @p addr is
+ *                  @c NULL).
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_net_addr_find(unsigned int gid, const char *ns_name,
+                    const char *if_name, const char *addr,
+                    netconf_handle *nh_ns, int *ifindex,
+                    netconf_list **addrs, netconf_net_addr **net_addr)
+{
+    netconf_link     *link;
+    netconf_node     *node;
+    netconf_net_addr  key;
+    struct in6_addr   buf;
+    te_errno          rc;
+
+    rc = netns_link_find(gid, ns_name, if_name, nh_ns, &link);
+    if (rc != 0)
+        return rc;
+
+    *ifindex = link->ifindex;
+
+    *addrs = netconf_net_addr_dump_iface(*nh_ns, AF_UNSPEC, *ifindex);
+    if (*addrs == NULL)
+        return TE_OS_RC(TE_TA_UNIX, errno);
+
+    if (addr == NULL)
+        return 0;
+
+    netconf_net_addr_init(&key);
+    rc = netns_parse_net_addr(addr, &buf, &key);
+    if (rc != 0)
+        goto fail;
+
+    for (node = (*addrs)->head; node != NULL; node = node->next)
+    {
+        if (node->data.net_addr.family == key.family &&
+            memcmp(node->data.net_addr.address, key.address,
+                   key.family == AF_INET ? sizeof(struct in_addr) :
+                                           sizeof(struct in6_addr)) == 0)
+        {
+            *net_addr = &node->data.net_addr;
+            return 0;
+        }
+    }
+
+    rc = TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+fail:
+    netconf_list_free(*addrs);
+    *addrs = NULL;
+
+    return rc;
+}
+
+/**
+ * Get prefix length of a network address of an interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param oid       Full object instance identifier (unused).
+ * @param value     Where to save the prefix length.
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ * @param addr      The address.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_net_addr_get(unsigned int gid, const char *oid, char *value,
+                   const char *ns, const char *ns_name,
+                   const char *if_name, const char *addr)
+{
+    netconf_handle    nh_ns;
+    netconf_list     *addrs;
+    netconf_net_addr *net_addr;
+    int               ifindex;
+    te_errno          rc;
+
+    UNUSED(oid);
+    UNUSED(ns);
+
+    rc = netns_net_addr_find(gid, ns_name, if_name, addr, &nh_ns,
+                             &ifindex, &addrs, &net_addr);
+    if (rc != 0)
+        return rc;
+
+    snprintf(value, RCF_MAX_VAL, "%u", net_addr->prefix);
+    netconf_list_free(addrs);
+
+    return 0;
+}
+
+/**
+ * Add or delete a network address of an interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param cmd       Netconf command.
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ * @param addr      The address.
+ * @param prefix    Prefix length string (unused for deletion).
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_net_addr_modify(unsigned int gid, netconf_cmd cmd,
+                      const char *ns_name, const char *if_name,
+                      const char *addr, const char *prefix)
+{
+    netconf_handle    nh_ns;
+    netconf_link     *link;
+    netconf_net_addr  net_addr;
+    struct in6_addr   buf;
+    unsigned int      prefix_len;
+    te_errno          rc;
+
+    rc = netns_link_find(gid, ns_name, if_name, &nh_ns, &link);
+    if (rc != 0)
+        return rc;
+
+    netconf_net_addr_init(&net_addr);
+    net_addr.ifindex = link->ifindex;
+
+    rc = netns_parse_net_addr(addr, &buf, &net_addr);
+    if (rc != 0)
+    {
+        ERROR("Invalid network address %s", addr);
+        return rc;
+    }
+
+    if (prefix != NULL)
+    {
+        rc = te_strtoui(prefix, 10, &prefix_len);
+        if (rc != 0 ||
+            prefix_len > (net_addr.family == AF_INET ? 32 : 128))
+        {
+            ERROR("Invalid prefix length %s", prefix);
+            return TE_RC(TE_TA_UNIX, TE_EINVAL);
+        }
+        net_addr.prefix = prefix_len;
+    }
+
+    if (netconf_net_addr_modify(nh_ns, cmd, &net_addr) != 0)
+    {
+        rc = TE_OS_RC(TE_TA_UNIX, errno);
+        ERROR("Failed to %s address %s on interface %s in namespace %s: %r",
+              cmd == NETCONF_CMD_DEL ? "delete" : "add", addr, if_name,
+              ns_name, rc);
+        return rc;
+    }
+
+    return 0;
+}
+
+/**
+ * Add a network address to an interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param oid       Full object instance identifier (unused).
+ * @param value     Prefix length.
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ * @param addr      The address.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_net_addr_add(unsigned int gid, const char *oid, const char *value,
+                   const char *ns, const char *ns_name,
+                   const char *if_name, const char *addr)
+{
+    UNUSED(oid);
+    UNUSED(ns);
+
+    return netns_net_addr_modify(gid, NETCONF_CMD_ADD, ns_name, if_name,
+                                 addr, value);
+}
+
+/**
+ * Delete a network address from an interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param oid       Full object instance identifier (unused).
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ * @param addr      The address.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_net_addr_del(unsigned int gid, const char *oid, const char *ns,
+                   const char *ns_name, const char *if_name,
+                   const char *addr)
+{
+    UNUSED(oid);
+    UNUSED(ns);
+
+    return netns_net_addr_modify(gid, NETCONF_CMD_DEL, ns_name, if_name,
+                                 addr, NULL);
+}
+
+/**
+ * Get list of network addresses of an interface in a namespace.
+ *
+ * @param gid       Group identifier.
+ * @param oid       Full identifier of the father instance (unused).
+ * @param sub_id    ID of the object to be listed (unused).
+ * @param list      Where to save the list.
+ * @param ns        Namespace configurator instance (unused).
+ * @param ns_name   The namespace name.
+ * @param if_name   The interface name.
+ *
+ * @return Status code.
+ */
+static te_errno
+netns_net_addr_list(unsigned int gid, const char *oid,
+                    const char *sub_id, char **list,
+                    const char *ns, const char *ns_name,
+                    const char *if_name)
+{
+    netconf_handle  nh_ns;
+    netconf_list   *addrs;
+    netconf_node   *node;
+    te_string       te_str = TE_STRING_INIT;
+    char            buf[INET6_ADDRSTRLEN];
+    int             ifindex;
+    te_errno        rc;
+
+    UNUSED(oid);
+    UNUSED(sub_id);
+    UNUSED(ns);
+
+    rc = netns_net_addr_find(gid, ns_name, if_name, NULL, &nh_ns,
+                             &ifindex, &addrs, NULL);
+    if (rc != 0)
+        return rc;
+
+    for (node = addrs->head; node != NULL; node = node->next)
+    {
+        if (inet_ntop(node->data.net_addr.family,
+                      node->data.net_addr.address,
+                      buf, sizeof(buf)) != NULL)
+            te_string_append(&te_str, "%s ", buf);
+    }
+
+    netconf_list_free(addrs);
+    *list = te_str.ptr;
+
+    return 0;
+}
+
+RCF_PCH_CFG_NODE_RW_COLLECTION(node_link_net_addr, "net_addr", NULL, NULL,
+                               netns_net_addr_get, NULL,
+                               netns_net_addr_add, netns_net_addr_del,
+                               netns_net_addr_list, NULL);
+
+RCF_PCH_CFG_NODE_RW(node_link_mtu, "mtu", NULL, &node_link_net_addr,
+                    netns_link_mtu_get, netns_link_mtu_set);
+
+RCF_PCH_CFG_NODE_RW(node_link_status, "status", NULL, &node_link_mtu,
+                    netns_link_status_get, netns_link_status_set);
+
+RCF_PCH_CFG_NODE_RO_COLLECTION(node_link, "link", &node_link_status, NULL,
+                               NULL, netns_link_list);
+
+RCF_PCH_CFG_NODE_COLLECTION(node_subagent, "subagent", NULL, &node_link,
+                            netns_subagent_add, netns_subagent_del,
+                            netns_subagent_list, NULL);
+
+RCF_PCH_CFG_NODE_COLLECTION(node_interface, "interface", NULL,
+                            &node_subagent,
                             netns_interface_add, netns_interface_del,
                             netns_interface_list, NULL);
 
@@ -0,0 +1,1635 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Periodic counter sampler
+ *
+ * Configuration tree support for Test Agent side sampling of
+ * interface, ethtool, qdisc, SNMP, socket, CPU and BPF counters.
+ *
+ * Each sampler has a dedicated thread which reads all its counters
+ * every @c interval milliseconds and stores them together with
+ * a CLOCK_MONOTONIC timestamp in a fixed size ring. The ring is
+ * dumped on request to a file in a compact binary format (see
+ * tapi_cfg_sampler.h), so a test gets the whole time series at once
+ * and timestamps are not affected by Configurator round trips.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Conf Sampler"
+
+#include "te_config.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+#include <linux/ethtool.h>
+
+#ifdef WITH_TC
+#include <net/if.h>
+#include <netlink/netlink.h>
+#include <netlink/route/tc.h>
+#include <netlink/route/qdisc.h>
+#include <linux/pkt_sched.h>
+#endif
+
+#ifdef WITH_BPF
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_alloc.h"
+#include "te_queue.h"
+#include "te_str.h"
+#include "te_string.h"
+#include "te_file.h"
+#include "logger_api.h"
+#include "rcf_ch_api.h"
+#include "rcf_pch.h"
+#include "unix_internal.h"
+#include "conf_common.h"
+#include "conf_ethtool.h"
+
+/** Magic number of the sampler dump ("TESM") */
+#define SAMPLER_DUMP_MAGIC      0x5445534d
+
+/** Version of the sampler dump format */
+#define SAMPLER_DUMP_VERSION    1
+
+/** Value stored for a counter which could not be read */
+#define SAMPLER_VALUE_NONE      UINT64_MAX
+
+/** Default sampling interval, milliseconds */
+#define SAMPLER_DEF_INTERVAL    1000
+
+/** Default number of samples kept in the ring */
+#define SAMPLER_DEF_DEPTH       1024
+
+/** Maximum number of samples kept in the ring */
+#define SAMPLER_MAX_DEPTH       (1024 * 1024)
+
+/** Initial size of the buffer used to read a file */
+#define SAMPLER_FILE_BUF_SIZE   4096
+
+/** Kind of a counter */
+typedef enum sampler_cnt_kind {
+    SAMPLER_CNT_VALUE,      /**< The only number in a file */
+    SAMPLER_CNT_TABLE,      /**< Column of a table in /proc/net/snmp
+                                 format: header line and value line */
+    SAMPLER_CNT_KEYVAL,     /**< Value after a key in a line of
+                                 /proc/net/sockstat format */
+    SAMPLER_CNT_COLUMN,     /**< Column of a line in /proc/stat format */
+    SAMPLER_CNT_ETHTOOL,    /**< Ethtool statistic */
+#ifdef WITH_TC
+    SAMPLER_CNT_QDISC,      /**< Root qdisc statistic */
+#endif
+#ifdef WITH_BPF
+    SAMPLER_CNT_BPF,        /**< Element of a pinned BPF map */
+#endif
+} sampler_cnt_kind;
+
+/** Kind of a counters source */
+typedef enum sampler_src_kind {
+    SAMPLER_SRC_FILE,       /**< Text file */
+    SAMPLER_SRC_ETHTOOL,    /**< Ethtool statistics of an interface */
+} sampler_src_kind;
+
+/**
+ * Source read once per sample and shared by all counters taken
+ * from it (e.g. /proc/net/snmp or ethtool statistics of
+ * an interface).
+ */
+typedef struct sampler_source {
+    SLIST_ENTRY(sampler_source) links;  /**< List links */
+
+    sampler_src_kind    kind;       /**< Source kind */
+    char               *id;         /**< File path or interface name */
+    unsigned int        refs;       /**< Number of counters using it */
+    te_bool             ok;         /**< Read successfully in the
+                                         current sample */
+
+    int                 fd;         /**< Opened file */
+    char               *buf;        /**< File content */
+    size_t              size;       /**< Size of the buffer */
+
+    struct ethtool_stats *stats;    /**< Ethtool statistics */
+} sampler_source;
+
+/** Counter of a sampler */
+typedef struct sampler_counter {
+    TAILQ_ENTRY(sampler_counter) links; /**< List links */
+
+    char               *name;       /**< Instance name */
+    char               *spec;       /**< Source specification */
+    sampler_cnt_kind    kind;       /**< Counter kind */
+    sampler_source     *src;        /**< Source or @c NULL */
+    char               *prefix;     /**< Prefix of the line to look for,
+                                         including the separator */
+    char               *key;        /**< Key for SAMPLER_CNT_KEYVAL */
+    unsigned int        idx;        /**< Column, ethtool statistic or
+                                         qdisc statistic index */
+    te_bool             failed;     /**< Reading failure is logged */
+#ifdef WITH_TC
+    int                 ifindex;    /**< Interface of the qdisc */
+#endif
+#ifdef WITH_BPF
+    int                 map_fd;     /**< Pinned BPF map */
+    uint32_t            map_key;    /**< Map element key */
+    unsigned int        n_values;   /**< Number of per-CPU values */
+    unsigned int        value_size; /**< Size of a value */
+    uint8_t            *map_value;  /**< Buffer for the element */
+#endif
+} sampler_counter;
+
+/** Sampler */
+typedef struct sampler {
+    TAILQ_ENTRY(sampler) links;     /**< List links */
+
+    char               *name;       /**< Instance name */
+    unsigned int        interval;   /**< Sampling interval, ms */
+    unsigned int        depth;      /**< Number of samples in the ring */
+    te_bool             enabled;    /**< Sampling thread is running */
+    char               *dump;       /**< Path of the last dump */
+
+    TAILQ_HEAD(, sampler_counter) counters; /**< Counters */
+    unsigned int        n_counters; /**< Number of counters */
+    SLIST_HEAD(, sampler_source) sources;   /**< Shared sources */
+
+#ifdef WITH_TC
+    struct nl_sock     *nl_sock;    /**< Netlink socket to get qdiscs */
+    struct nl_cache    *qdiscs;     /**< Qdisc cache */
+    unsigned int        n_qdisc;    /**< Number of qdisc counters */
+#endif
+
+    pthread_t           thread;     /**< Sampling thread */
+    pthread_mutex_t     lock;       /**< Lock protecting the ring and
+                                         @a stop */
+    pthread_cond_t      cond;       /**< Used to wake the thread up */
+    te_bool             stop;       /**< The thread should stop */
+
+    uint64_t           *ts;         /**< Ring of timestamps, ns */
+    uint64_t           *values;     /**< Ring of values, @a n_counters
+                                         per sample */
+    unsigned int        ring_counters; /**< Number of counters the ring
+                                            is allocated for */
+    unsigned int        head;       /**< Index of the next sample */
+    unsigned int        n_samples;  /**< Number of samples in the ring */
+    uint64_t            missed;     /**< Number of missed sampling
+                                         periods */
+} sampler;
+
+/** List of samplers */
+static TAILQ_HEAD(, sampler) samplers = TAILQ_HEAD_INITIALIZER(samplers);
+
+/** Columns of a CPU line in /proc/stat */
+static const char *sampler_cpu_fields[] = {
+    "user", "nice", "system", "idle", "iowait", "irq", "softirq",
+    "steal", "guest", "guest_nice",
+};
+
+/* Find a sampler by name */
+static sampler *
+sampler_find(const char *name)
+{
+    sampler *s;
+
+    TAILQ_FOREACH(s, &samplers, links)
+    {
+        if (strcmp(s->name, name) == 0)
+            return s;
+    }
+
+    return NULL;
+}
+
+/* Find a counter of a sampler by name */
+static sampler_counter *
+sampler_counter_find(sampler *s, const char *name)
+{
+    sampler_counter *cnt;
+
+    TAILQ_FOREACH(cnt, &s->counters, links)
+    {
+        if (strcmp(cnt->name, name) == 0)
+            return cnt;
+    }
+
+    return NULL;
+}
+
+/*
+ * Find a line starting with a given prefix. If @p after is not @c NULL,
+ * the search is started from the line following it.
+ */
+static const char *
+sampler_find_line(const char *buf, const char *prefix, const char *after)
+{
+    size_t      len = strlen(prefix);
+    const char *p = buf;
+
+    if (after != NULL)
+    {
+        p = strchr(after, '\n');
+        if (p == NULL)
+            return NULL;
+        p++;
+    }
+
+    while (*p != '\0')
+    {
+        if (strncmp(p, prefix, len) == 0)
+            return p;
+
+        p = strchr(p, '\n');
+        if (p == NULL)
+            break;
+        p++;
+    }
+
+    return NULL;
+}
+
+/* Skip @p n whitespace separated tokens of a line */
+static const char *
+sampler_skip_tokens(const char *p, unsigned int n)
+{
+    for (; n > 0; n--)
+    {
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '\0' || *p == '\n')
+            return NULL;
+        while (*p != ' ' && *p != '\t' && *p != '\0' && *p != '\n')
+            p++;
+    }
+
+    while (*p == ' ' || *p == '\t')
+        p++;
+
+    return (*p == '\0' || *p == '\n') ? NULL : p;
+}
+
+/* Parse an unsigned number at the beginning of a string */
+static te_bool
+sampler_parse_u64(const char *p, uint64_t *value)
+{
+    char *end;
+
+    if (p == NULL)
+        return FALSE;
+
+    *value = strtoull(p, &end, 10);
+
+    return end != p;
+}
+
+/*
+ * Get index of a token in a line. The first token (line prefix)
+ * has index 0.
+ */
+static te_bool
+sampler_token_idx(const char *line, const char *token, unsigned int *idx)
+{
+    size_t       len = strlen(token);
+    const char  *p;
+    unsigned int i;
+
+    for (i = 1; (p = sampler_skip_tokens(line, i)) != NULL; i++)
+    {
+        if (strncmp(p, token, len) == 0 &&
+            (p[len] == ' ' || p[len] == '\t' || p[len] == '\n' ||
+             p[len] == '\0'))
+        {
+            *idx = i;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* Read the whole content of a file source */
+static te_bool
+sampler_source_read_file(sampler_source *src)
+{
+    size_t  len = 0;
+    ssize_t rc;
+
+    while (TRUE)
+    {
+        if (len + 1 == src->size)
+        {
+            src->size *= 2;
+            TE_REALLOC(src->buf, src->size);
+        }
+
+        rc = pread(src->fd, src->buf + len, src->size - len - 1, len);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return FALSE;
+        }
+        if (rc == 0)
+            break;
+
+        len += rc;
+    }
+
+    src->buf[len] = '\0';
+    return TRUE;
+}
+
+/* Read a source, it is done once per sample */
+static void
+sampler_source_read(sampler_source *src)
+{
+    switch (src->kind)
+    {
+        case SAMPLER_SRC_FILE:
+            src->ok = sampler_source_read_file(src);
+            break;
+
+        case SAMPLER_SRC_ETHTOOL:
+            src->ok = call_ethtool_ioctl(src->id, ETHTOOL_GSTATS,
+                                         src->stats) == 0;
+            break;
+    }
+}
+
+/* Get a source shared by counters, create it if it does not exist */
+static te_errno
+sampler_source_get(sampler *s, unsigned int gid, sampler_src_kind kind,
+                   const char *id, sampler_source **result)
+{
+    const ta_ethtool_strings *sset;
+    sampler_source           *src;
+    te_errno                  rc;
+    int                       fd = -1;
+
+    SLIST_FOREACH(src, &s->sources, links)
+    {
+        if (src->kind == kind && strcmp(src->id, id) == 0)
+        {
+            src->refs++;
+            *result = src;
+            return 0;
+        }
+    }
+
+    src = TE_ALLOC(sizeof(*src));
+    src->kind = kind;
+    src->fd = -1;
+
+    switch (kind)
+    {
+        case SAMPLER_SRC_FILE:
+            fd = open(id, O_RDONLY);
+            if (fd < 0)
+            {
+                rc = TE_OS_RC(TE_TA_UNIX, errno);
+                ERROR("Failed to open '%s': %r", id, rc);
+                free(src);
+                return rc;
+            }
+            src->fd = fd;
+            src->size = SAMPLER_FILE_BUF_SIZE;
+            src->buf = TE_ALLOC(src->size);
+            break;
+
+        case SAMPLER_SRC_ETHTOOL:
+            rc = ta_ethtool_get_strings(gid, id, ETH_SS_STATS, &sset);
+            if (rc != 0)
+            {
+                free(src);
+                return rc;
+            }
+            src->stats = TE_ALLOC(sizeof(*src->stats) +
+                                  sset->num * sizeof(uint64_t));
+            src->stats->n_stats = sset->num;
+            break;
+    }
+
+    src->id = TE_STRDUP(id);
+    src->refs = 1;
+    SLIST_INSERT_HEAD(&s->sources, src, links);
+
+    *result = src;
+    return 0;
+}
+
+/* Release a source reference */
+static void
+sampler_source_put(sampler *s, sampler_source *src)
+{
+    if (src == NULL || --src->refs > 0)
+        return;
+
+    SLIST_REMOVE(&s->sources, src, sampler_source, links);
+    if (src->fd >= 0)
+        close(src->fd);
+    free(src->buf);
+    free(src->stats);
+    free(src->id);
+    free(src);
+}
+
+/* Get a counter value from the already read sources */
+static te_bool
+sampler_counter_read(sampler *s, sampler_counter *cnt, uint64_t *value)
+{
+    const char *line;
+
+    UNUSED(s);
+
+    if (cnt->src != NULL && !cnt->src->ok)
+        return FALSE;
+
+    switch (cnt->kind)
+    {
+        case SAMPLER_CNT_VALUE:
+            return sampler_parse_u64(cnt->src->buf, value);
+
+        case SAMPLER_CNT_TABLE:
+            /* The first line is a header, the next one contains values */
+            line = sampler_find_line(cnt->src->buf, cnt->prefix, NULL);
+            if (line != NULL)
+                line = sampler_find_line(cnt->src->buf, cnt->prefix, line);
+            if (line == NULL)
+                return FALSE;
+            return sampler_parse_u64(sampler_skip_tokens(line, cnt->idx),
+                                     value);
+
+        case SAMPLER_CNT_COLUMN:
+            line = sampler_find_line(cnt->src->buf, cnt->prefix, NULL);
+            if (line == NULL)
+                return FALSE;
+            return sampler_parse_u64(sampler_skip_tokens(line, cnt->idx),
+                                     value);
+
+        case SAMPLER_CNT_KEYVAL:
+        {
+            unsigned int idx;
+
+            line = sampler_find_line(cnt->src->buf, cnt->prefix, NULL);
+            if (line == NULL || !sampler_token_idx(line, cnt->key, &idx))
+                return FALSE;
+            return sampler_parse_u64(sampler_skip_tokens(line, idx + 1),
+                                     value);
+        }
+
+        case SAMPLER_CNT_ETHTOOL:
+            if (cnt->idx >= cnt->src->stats->n_stats)
+                return FALSE;
+            *value = cnt->src->stats->data[cnt->idx];
+            return TRUE;
+
+#ifdef WITH_TC
+        case SAMPLER_CNT_QDISC:
+        {
+            struct rtnl_qdisc *qdisc;
+
+            if (s->qdiscs == NULL)
+                return FALSE;
+
+            qdisc = rtnl_qdisc_get(s->qdiscs, cnt->ifindex, TC_H_ROOT);
+            if (qdisc == NULL)
+                return FALSE;
+            *value = rtnl_tc_get_stat(TC_CAST(qdisc), cnt->idx);
+            rtnl_qdisc_put(qdisc);
+            return TRUE;
+        }
+#endif
+
+#ifdef WITH_BPF
+        case SAMPLER_CNT_BPF:
+        {
+            unsigned int i;
+
+            if (bpf_map_lookup_elem(cnt->map_fd, &cnt->map_key,
+                                    cnt->map_value) != 0)
+                return FALSE;
+
+            /* Per-CPU values are summed up */
+            *value = 0;
+            for (i = 0; i < cnt->n_values; i++)
+            {
+                const uint8_t *v = cnt->map_value + i * cnt->value_size;
+
+                if (cnt->value_size == sizeof(uint32_t))
+                    *value += *(const uint32_t *)v;
+                else
+                    *value += *(const uint64_t *)v;
+            }
+            return TRUE;
+        }
+#endif
+    }
+
+    return FALSE;
+}
+
+/* Take a sample of all counters */
+static void
+sampler_take(sampler *s, uint64_t *ts, uint64_t *values)
+{
+    sampler_source  *src;
+    sampler_counter *cnt;
+    struct timespec  start;
+    struct timespec  end;
+    unsigned int     i = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    SLIST_FOREACH(src, &s->sources, links)
+        sampler_source_read(src);
+
+#ifdef WITH_TC
+    if (s->n_qdisc > 0 && nl_cache_refill(s->nl_sock, s->qdiscs) < 0)
+    {
+        nl_cache_free(s->qdiscs);
+        s->qdiscs = NULL;
+        rtnl_qdisc_alloc_cache(s->nl_sock, &s->qdiscs);
+    }
+#endif
+
+    TAILQ_FOREACH(cnt, &s->counters, links)
+    {
+        if (!sampler_counter_read(s, cnt, &values[i]))
+        {
+            values[i] = SAMPLER_VALUE_NONE;
+            if (!cnt->failed)
+            {
+                WARN("Sampler '%s' failed to read counter '%s' (%s)",
+                     s->name, cnt->name, cnt->spec);
+                cnt->failed = TRUE;
+            }
+        }
+        i++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /*
+     * Reading of all sources may take noticeable time, the middle
+     * of the reading interval is the best estimation of the moment
+     * all the values correspond to.
+     */
+    *ts = (TE_SEC2NS(start.tv_sec) + start.tv_nsec +
+           TE_SEC2NS(end.tv_sec) + end.tv_nsec) / 2;
+}
+
+/* Sampling thread */
+static void *
+sampler_thread(void *arg)
+{
+    sampler         *s = arg;
+    struct timespec  next;
+    struct timespec  now;
+    uint64_t         interval_ns = TE_MS2NS((uint64_t)s->interval);
+    uint64_t         next_ns;
+    uint64_t         now_ns;
+    uint64_t         ts;
+    uint64_t        *values;
+    unsigned int     n_counters = s->ring_counters;
+
+    values = TE_ALLOC(n_counters * sizeof(*values));
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    next_ns = TE_SEC2NS(now.tv_sec) + now.tv_nsec;
+
+    pthread_mutex_lock(&s->lock);
+    while (!s->stop)
+    {
+        pthread_mutex_unlock(&s->lock);
+
+        sampler_take(s, &ts, values);
+
+        pthread_mutex_lock(&s->lock);
+
+        s->ts[s->head] = ts;
+        memcpy(&s->values[(size_t)s->head * n_counters], values,
+               n_counters * sizeof(*values));
+        s->head = (s->head + 1) % s->depth;
+        if (s->n_samples < s->depth)
+            s->n_samples++;
+
+        /*
+         * Sampling moments are aligned to the interval from the start,
+         * so that timestamps do not drift. If the thread is late for
+         * one or more periods, they are skipped.
+         */
+        next_ns += interval_ns;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        now_ns = TE_SEC2NS(now.tv_sec) + now.tv_nsec;
+        if (now_ns >= next_ns)
+        {
+            uint64_t skip = (now_ns - next_ns) / interval_ns + 1;
+
+            s->missed += skip;
+            next_ns += skip * interval_ns;
+        }
+
+        next.tv_sec = next_ns / TE_SEC2NS(1);
+        next.tv_nsec = next_ns % TE_SEC2NS(1);
+        while (!s->stop &&
+               pthread_cond_timedwait(&s->cond, &s->lock, &next) == 0)
+            ;
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    free(values);
+
+    return NULL;
+}
+
+/* Release the ring of samples */
+static void
+sampler_ring_free(sampler *s)
+{
+    free(s->ts);
+    s->ts = NULL;
+    free(s->values);
+    s->values = NULL;
+    s->ring_counters = 0;
+    s->head = 0;
+    s->n_samples = 0;
+    s->missed = 0;
+}
+
+/* Start the sampling thread */
+static te_errno
+sampler_start(sampler *s)
+{
+    int rc;
+
+    if (s->n_counters == 0)
+    {
+        ERROR("Sampler '%s' has no counters", s->name);
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+    }
+
+    sampler_ring_free(s);
+    s->ring_counters = s->n_counters;
+    s->ts = TE_ALLOC(s->depth * sizeof(*s->ts));
+    s->values = TE_ALLOC((size_t)s->depth * s->n_counters *
+                         sizeof(*s->values));
+    s->stop = FALSE;
+
+    rc = pthread_create(&s->thread, NULL, sampler_thread, s);
+    if (rc != 0)
+    {
+        ERROR("Failed to start sampler '%s' thread: %s", s->name,
+              strerror(rc));
+        sampler_ring_free(s);
+        return TE_OS_RC(TE_TA_UNIX, rc);
+    }
+
+    s->enabled = TRUE;
+    return 0;
+}
+
+/* Stop the sampling thread keeping the collected samples */
+static void
+sampler_stop(sampler *s)
+{
+    if (!s->enabled)
+        return;
+
+    pthread_mutex_lock(&s->lock);
+    s->stop = TRUE;
+    pthread_cond_signal(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+
+    pthread_join(s->thread, NULL);
+    s->enabled = FALSE;
+}
+
+/* Append a 32-bit number in network byte order to a dump */
+static void
+sampler_dump_u32(te_string *dump, uint32_t value)
+{
+    value = htonl(value);
+    te_string_append_buf(dump, (const char *)&value, sizeof(value));
+}
+
+/* Append a 64-bit number in network byte order to a dump */
+static void
+sampler_dump_u64(te_string *dump, uint64_t value)
+{
+    sampler_dump_u32(dump, value >> 32);
+    sampler_dump_u32(dump, value & UINT32_MAX);
+}
+
+/* Dump the ring of samples to a file */
+static te_errno
+sampler_dump(sampler *s, const char *path)
+{
+    te_string        dump = TE_STRING_INIT;
+    sampler_counter *cnt;
+    struct timespec  mono;
+    struct timespec  real;
+    uint64_t        *ts = NULL;
+    uint64_t        *values = NULL;
+    unsigned int     n_counters;
+    unsigned int     n_samples;
+    unsigned int     first;
+    unsigned int     i;
+    unsigned int     j;
+    te_errno         rc;
+
+    /* Copy the ring to keep the sampling thread blocked for less time */
+    pthread_mutex_lock(&s->lock);
+    n_counters = s->ring_counters;
+    n_samples = s->n_samples;
+    if (n_samples > 0)
+    {
+        first = (s->head + s->depth - n_samples) % s->depth;
+        ts = TE_ALLOC(n_samples * sizeof(*ts));
+        values = TE_ALLOC((size_t)n_samples * n_counters *
+                          sizeof(*values));
+        for (i = 0; i < n_samples; i++)
+        {
+            unsigned int k = (first + i) % s->depth;
+
+            ts[i] = s->ts[k];
+            memcpy(&values[(size_t)i * n_counters],
+                   &s->values[(size_t)k * n_counters],
+                   n_counters * sizeof(*values));
+        }
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    /* Offset allowing to convert monotonic timestamps to real time */
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+    clock_gettime(CLOCK_REALTIME, &real);
+
+    sampler_dump_u32(&dump, SAMPLER_DUMP_MAGIC);
+    sampler_dump_u32(&dump, SAMPLER_DUMP_VERSION);
+    sampler_dump_u32(&dump, s->interval);
+    sampler_dump_u32(&dump, n_counters);
+    sampler_dump_u32(&dump, n_samples);
+    sampler_dump_u64(&dump, s->missed);
+    sampler_dump_u64(&dump,
+                     (TE_SEC2NS((uint64_t)real.tv_sec) + real.tv_nsec) -
+                     (TE_SEC2NS((uint64_t)mono.tv_sec) + mono.tv_nsec));
+
+    /* Ring is reset on counters change, so names are the same */
+    i = 0;
+    TAILQ_FOREACH(cnt, &s->counters, links)
+    {
+        if (i++ == n_counters)
+            break;
+        te_string_append_buf(&dump, cnt->name, strlen(cnt->name) + 1);
+    }
+
+    for (i = 0; i < n_samples; i++)
+    {
+        sampler_dump_u64(&dump, ts[i]);
+        for (j = 0; j < n_counters; j++)
+            sampler_dump_u64(&dump, values[(size_t)i * n_counters + j]);
+    }
+
+    free(ts);
+    free(values);
+
+    rc = te_file_write_string(&dump, 0, O_CREAT | O_TRUNC,
+                              S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH,
+                              "%s", path);
+    if (rc != 0)
+        ERROR("Failed to dump sampler '%s' to '%s': %r", s->name, path, rc);
+
+    te_string_free(&dump);
+    return rc;
+}
+
+/*
+ * Split a specification "<first>:<last>" at the last colon,
+ * the first part may contain colons (e.g. an interface alias).
+ */
+static te_errno
+sampler_spec_split(char *spec, char **first, char **last)
+{
+    char *colon = strrchr(spec, ':');
+
+    if (colon == NULL || colon == spec || colon[1] == '\0')
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+
+    *colon = '\0';
+    *first = spec;
+    *last = colon + 1;
+
+    return 0;
+}
+
+/* Configure a counter of /proc/net/snmp or /proc/net/netstat */
+static te_errno
+sampler_counter_snmp(sampler *s, unsigned int gid, sampler_counter *cnt,
+                     const char *group, const char *field)
+{
+    static const char *files[] = { "/proc/net/snmp", "/proc/net/netstat" };
+
+    te_string    content = TE_STRING_INIT;
+    const char  *line;
+    unsigned int i;
+    te_errno     rc;
+
+    cnt->kind = SAMPLER_CNT_TABLE;
+    cnt->prefix = te_string_fmt("%s:", group);
+
+    for (i = 0; i < TE_ARRAY_LEN(files); i++)
+    {
+        te_string_reset(&content);
+        if (te_file_read_string(&content, FALSE, 0, "%s", files[i]) != 0)
+            continue;
+
+        line = sampler_find_line(content.ptr, cnt->prefix, NULL);
+        if (line != NULL && sampler_token_idx(line, field, &cnt->idx))
+        {
+            te_string_free(&content);
+            return sampler_source_get(s, gid, SAMPLER_SRC_FILE, files[i],
+                                      &cnt->src);
+        }
+    }
+
+    te_string_free(&content);
+    rc = TE_RC(TE_TA_UNIX, TE_ENOENT);
+    ERROR("SNMP counter %s:%s is not found", group, field);
+    return rc;
+}
+
+/* Configure a root qdisc counter */
+static te_errno
+sampler_counter_qdisc(sampler *s, sampler_counter *cnt,
+                      const char *if_name, const char *stat)
+{
+#ifdef WITH_TC
+    static const struct {
+        const char        *name;
+        enum rtnl_tc_stat  id;
+    } stats[] = {
+        { "packets", RTNL_TC_PACKETS },
+        { "bytes", RTNL_TC_BYTES },
+        { "drops", RTNL_TC_DROPS },
+        { "overlimits", RTNL_TC_OVERLIMITS },
+        { "requeues", RTNL_TC_REQUEUES },
+        { "qlen", RTNL_TC_QLEN },
+        { "backlog", RTNL_TC_BACKLOG },
+    };
+    unsigned int i;
+    int          rc;
+
+    for (i = 0; i < TE_ARRAY_LEN(stats); i++)
+    {
+        if (strcmp(stats[i].name, stat) == 0)
+            break;
+    }
+    if (i == TE_ARRAY_LEN(stats))
+    {
+        ERROR("Unknown qdisc statistic '%s'", stat);
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+    }
+
+    cnt->ifindex = if_nametoindex(if_name);
+    if (cnt->ifindex == 0)
+    {
+        ERROR("Interface '%s' is not found", if_name);
+        return TE_RC(TE_TA_UNIX, TE_ENODEV);
+    }
+
+    if (s->nl_sock == NULL)
+    {
+        s->nl_sock = nl_socket_alloc();
+        if (s->nl_sock == NULL)
+            return TE_RC(TE_TA_UNIX, TE_ENOMEM);
+
+        rc = nl_connect(s->nl_sock, NETLINK_ROUTE);
+        if (rc == 0)
+            rc = rtnl_qdisc_alloc_cache(s->nl_sock, &s->qdiscs);
+        if (rc != 0)
+        {
+            ERROR("Failed to get qdiscs: %s", nl_geterror(rc));
+            nl_socket_free(s->nl_sock);
+            s->nl_sock = NULL;
+            return TE_RC(TE_TA_UNIX, TE_EFAIL);
+        }
+    }
+
+    cnt->kind = SAMPLER_CNT_QDISC;
+    cnt->idx = stats[i].id;
+    s->n_qdisc++;
+
+    return 0;
+#else
+    UNUSED(s);
+    UNUSED(cnt);
+    UNUSED(if_name);
+    UNUSED(stat);
+
+    ERROR("Qdisc counters are not supported");
+    return TE_RC(TE_TA_UNIX, TE_EOPNOTSUPP);
+#endif
+}
+
+/* Configure a counter of a pinned BPF map element */
+static te_errno
+sampler_counter_bpf(sampler_counter *cnt, const char *key,
+                    const char *path)
+{
+#ifdef WITH_BPF
+    struct bpf_map_info info;
+    uint32_t            info_len = sizeof(info);
+    te_errno            rc;
+
+    rc = te_strtoui(key, 0, &cnt->map_key);
+    if (rc != 0)
+        return rc;
+
+    cnt->map_fd = bpf_obj_get(path);
+    if (cnt->map_fd < 0)
+    {
+        rc = TE_OS_RC(TE_TA_UNIX, errno);
+        ERROR("Failed to get pinned BPF map '%s': %r", path, rc);
+        return rc;
+    }
+
+    memset(&info, 0, sizeof(info));
+    if (bpf_obj_get_info_by_fd(cnt->map_fd, &info, &info_len) != 0)
+    {
+        rc = TE_OS_RC(TE_TA_UNIX, errno);
+        ERROR("Failed to get BPF map '%s' info: %r", path, rc);
+        goto fail;
+    }
+
+    if (info.key_size != sizeof(uint32_t) ||
+        (info.value_size != sizeof(uint32_t) &&
+         info.value_size != sizeof(uint64_t)))
+    {
+        ERROR("BPF map '%s' should have 32-bit keys and 32-bit or "
+              "64-bit values", path);
+        rc = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        goto fail;
+    }
+
+    cnt->value_size = info.value_size;
+    cnt->n_values = 1;
+    if (info.type == BPF_MAP_TYPE_PERCPU_ARRAY ||
+        info.type == BPF_MAP_TYPE_PERCPU_HASH ||
+        info.type == BPF_MAP_TYPE_LRU_PERCPU_HASH)
+    {
+        int n_cpus = libbpf_num_possible_cpus();
+
+        if (n_cpus <= 0)
+        {
+            rc = TE_RC(TE_TA_UNIX, TE_EFAIL);
+            goto fail;
+        }
+        cnt->n_values = n_cpus;
+        /* Per-CPU values are rounded up to 8 bytes */
+        cnt->value_size = TE_ALIGN(info.value_size, 8);
+    }
+    cnt->map_value = TE_ALLOC(cnt->n_values * cnt->value_size);
+    cnt->kind = SAMPLER_CNT_BPF;
+
+    return 0;
+
+fail:
+    close(cnt->map_fd);
+    cnt->map_fd = -1;
+    return rc;
+#else
+    UNUSED(cnt);
+    UNUSED(key);
+    UNUSED(path);
+
+    ERROR("BPF counters are not supported");
+    return TE_RC(TE_TA_UNIX, TE_EOPNOTSUPP);
+#endif
+}
+
+/*
+ * Configure a counter according to its specification:
+ * - if:<interface>:<statistic> - /sys/class/net/<interface>/statistics;
+ * - ethtool:<interface>:<statistic> - ethtool -S;
+ * - qdisc:<interface>:<statistic> - root qdisc statistics;
+ * - snmp:<group>:<field> - /proc/net/snmp and /proc/net/netstat;
+ * - sockstat:<protocol>:<field> - /proc/net/sockstat(6);
+ * - cpu:[<cpu>:]<field> - /proc/stat in USER_HZ;
+ * - bpf:<key>:<pinned map path> - sum of per-CPU values of the element;
+ * - file:<path> - a file containing a number.
+ */
+static te_errno
+sampler_counter_setup(sampler *s, unsigned int gid, sampler_counter *cnt)
+{
+    char       *spec = TE_STRDUP(cnt->spec);
+    char       *kind;
+    char       *args;
+    char       *first;
+    char       *last;
+    char       *path = NULL;
+    unsigned int i;
+    te_errno    rc = 0;
+
+    kind = spec;
+    args = strchr(spec, ':');
+    if (args == NULL)
+    {
+        rc = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        goto out;
+    }
+    *args++ = '\0';
+
+    if (strcmp(kind, "file") == 0)
+    {
+        cnt->kind = SAMPLER_CNT_VALUE;
+        rc = sampler_source_get(s, gid, SAMPLER_SRC_FILE, args, &cnt->src);
+        goto out;
+    }
+    else if (strcmp(kind, "bpf") == 0)
+    {
+        last = strchr(args, ':');
+        if (last == NULL)
+        {
+            rc = TE_RC(TE_TA_UNIX, TE_EINVAL);
+            goto out;
+        }
+        *last++ = '\0';
+        rc = sampler_counter_bpf(cnt, args, last);
+        goto out;
+    }
+
+    rc = sampler_spec_split(args, &first, &last);
+    if (rc != 0 && strcmp(kind, "cpu") != 0)
+        goto out;
+
+    if (strcmp(kind, "if") == 0)
+    {
+        cnt->kind = SAMPLER_CNT_VALUE;
+        path = te_string_fmt("/sys/class/net/%s/statistics/%s",
+                             first, last);
+        rc = sampler_source_get(s, gid, SAMPLER_SRC_FILE, path, &cnt->src);
+    }
+    else if (strcmp(kind, "ethtool") == 0)
+    {
+        cnt->kind = SAMPLER_CNT_ETHTOOL;
+        rc = ta_ethtool_get_string_idx(gid, first, ETH_SS_STATS, last,
+                                       &cnt->idx);
+        if (rc == 0)
+        {
+            rc = sampler_source_get(s, gid, SAMPLER_SRC_ETHTOOL, first,
+                                    &cnt->src);
+        }
+    }
+    else if (strcmp(kind, "qdisc") == 0)
+    {
+        rc = sampler_counter_qdisc(s, cnt, first, last);
+    }
+    else if (strcmp(kind, "snmp") == 0)
+    {
+        rc = sampler_counter_snmp(s, gid, cnt, first, last);
+    }
+    else if (strcmp(kind, "sockstat") == 0)
+    {
+        size_t len = strlen(first);
+
+        cnt->kind = SAMPLER_CNT_KEYVAL;
+        cnt->prefix = te_string_fmt("%s:", first);
+        cnt->key = TE_STRDUP(last);
+        rc = sampler_source_get(s, gid, SAMPLER_SRC_FILE,
+                                first[len - 1] == '6' ?
+                                    "/proc/net/sockstat6" :
+                                    "/proc/net/sockstat",
+                                &cnt->src);
+    }
+    else if (strcmp(kind, "cpu") == 0)
+    {
+        if (rc == 0)
+        {
+            cnt->prefix = te_string_fmt("cpu%s ", first);
+        }
+        else
+        {
+            cnt->prefix = TE_STRDUP("cpu ");
+            last = args;
+        }
+
+        for (i = 0; i < TE_ARRAY_LEN(sampler_cpu_fields); i++)
+        {
+            if (strcmp(sampler_cpu_fields[i], last) == 0)
+                break;
+        }
+        if (i == TE_ARRAY_LEN(sampler_cpu_fields))
+        {
+            rc = TE_RC(TE_TA_UNIX, TE_EINVAL);
+            goto out;
+        }
+
+        cnt->kind = SAMPLER_CNT_COLUMN;
+        cnt->idx = i + 1;
+        rc = sampler_source_get(s, gid, SAMPLER_SRC_FILE, "/proc/stat",
+                                &cnt->src);
+    }
+    else
+    {
+        rc = TE_RC(TE_TA_UNIX, TE_EINVAL);
+    }
+
+out:
+    if (TE_RC_GET_ERROR(rc) == TE_EINVAL)
+        ERROR("Invalid sampler counter specification '%s'", cnt->spec);
+
+    free(path);
+    free(spec);
+    return rc;
+}
+
+/* Release a counter */
+static void
+sampler_counter_free(sampler *s, sampler_counter *cnt)
+{
+    sampler_source_put(s, cnt->src);
+#ifdef WITH_TC
+    if (cnt->kind == SAMPLER_CNT_QDISC && --s->n_qdisc == 0)
+    {
+        if (s->qdiscs != NULL)
+            nl_cache_free(s->qdiscs);
+        s->qdiscs = NULL;
+        nl_close(s->nl_sock);
+        nl_socket_free(s->nl_sock);
+        s->nl_sock = NULL;
+    }
+#endif
+#ifdef WITH_BPF
+    if (cnt->kind == SAMPLER_CNT_BPF)
+        close(cnt->map_fd);
+    free(cnt->map_value);
+#endif
+    free(cnt->prefix);
+    free(cnt->key);
+    free(cnt->spec);
+    free(cnt->name);
+    free(cnt);
+}
+
+/* Release a sampler */
+static void
+sampler_free(sampler *s)
+{
+    sampler_counter *cnt;
+
+    sampler_stop(s);
+
+    while ((cnt = TAILQ_FIRST(&s->counters)) != NULL)
+    {
+        TAILQ_REMOVE(&s->counters, cnt, links);
+        sampler_counter_free(s, cnt);
+    }
+
+    sampler_ring_free(s);
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->lock);
+    free(s->dump);
+    free(s->name);
+    free(s);
+}
+
+/* Find a sampler which is not enabled, so that it can be changed */
+static te_errno
+sampler_find_stopped(const char *name, sampler **result)
+{
+    sampler *s = sampler_find(name);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    if (s->enabled)
+    {
+        ERROR("Sampler '%s' cannot be changed while it is enabled", name);
+        return TE_RC(TE_TA_UNIX, TE_EBUSY);
+    }
+
+    *result = s;
+    return 0;
+}
+
+static te_errno
+sampler_add(unsigned int gid, const char *oid, const char *value,
+            const char *name)
+{
+    pthread_condattr_t  attr;
+    sampler            *s;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(value);
+
+    if (sampler_find(name) != NULL)
+        return TE_RC(TE_TA_UNIX, TE_EEXIST);
+
+    s = TE_ALLOC(sizeof(*s));
+    s->name = TE_STRDUP(name);
+    s->interval = SAMPLER_DEF_INTERVAL;
+    s->depth = SAMPLER_DEF_DEPTH;
+    TAILQ_INIT(&s->counters);
+    SLIST_INIT(&s->sources);
+
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    TAILQ_INSERT_TAIL(&samplers, s, links);
+
+    return 0;
+}
+
+static te_errno
+sampler_del(unsigned int gid, const char *oid, const char *name)
+{
+    sampler *s = sampler_find(name);
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    TAILQ_REMOVE(&samplers, s, links);
+    sampler_free(s);
+
+    return 0;
+}
+
+static te_errno
+sampler_list(unsigned int gid, const char *oid, const char *sub_id,
+             char **list)
+{
+    te_string  str = TE_STRING_INIT;
+    sampler   *s;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(sub_id);
+
+    TAILQ_FOREACH(s, &samplers, links)
+        te_string_append(&str, "%s ", s->name);
+
+    te_string_move(list, &str);
+    return 0;
+}
+
+static te_errno
+sampler_interval_get(unsigned int gid, const char *oid, char *value,
+                     const char *name)
+{
+    sampler *s = sampler_find(name);
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%u", s->interval);
+}
+
+static te_errno
+sampler_interval_set(unsigned int gid, const char *oid, const char *value,
+                     const char *name)
+{
+    sampler     *s;
+    unsigned int interval;
+    te_errno     rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    rc = sampler_find_stopped(name, &s);
+    if (rc != 0)
+        return rc;
+
+    rc = te_strtoui(value, 0, &interval);
+    if (rc != 0)
+        return rc;
+
+    if (interval == 0)
+    {
+        ERROR("Sampling interval should be at least 1 ms");
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+    }
+
+    s->interval = interval;
+    return 0;
+}
+
+static te_errno
+sampler_depth_get(unsigned int gid, const char *oid, char *value,
+                  const char *name)
+{
+    sampler *s = sampler_find(name);
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%u", s->depth);
+}
+
+static te_errno
+sampler_depth_set(unsigned int gid, const char *oid, const char *value,
+                  const char *name)
+{
+    sampler     *s;
+    unsigned int depth;
+    te_errno     rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    rc = sampler_find_stopped(name, &s);
+    if (rc != 0)
+        return rc;
+
+    rc = te_strtoui(value, 0, &depth);
+    if (rc != 0)
+        return rc;
+
+    if (depth == 0 || depth > SAMPLER_MAX_DEPTH)
+    {
+        ERROR("Sampler depth should be in [1, %u]", SAMPLER_MAX_DEPTH);
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+    }
+
+    s->depth = depth;
+    return 0;
+}
+
+static te_errno
+sampler_enable_get(unsigned int gid, const char *oid, char *value,
+                   const char *name)
+{
+    sampler *s = sampler_find(name);
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%d", s->enabled ? 1 : 0);
+}
+
+static te_errno
+sampler_enable_set(unsigned int gid, const char *oid, const char *value,
+                   const char *name)
+{
+    sampler *s = sampler_find(name);
+    te_bool  enable;
+    te_errno rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    rc = te_strtol_bool(value, &enable);
+    if (rc != 0)
+        return rc;
+
+    if (enable == s->enabled)
+        return 0;
+
+    if (!enable)
+    {
+        sampler_stop(s);
+        return 0;
+    }
+
+    return sampler_start(s);
+}
+
+static te_errno
+sampler_missed_get(unsigned int gid, const char *oid, char *value,
+                   const char *name)
+{
+    sampler *s = sampler_find(name);
+    uint64_t missed;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    pthread_mutex_lock(&s->lock);
+    missed = s->missed;
+    pthread_mutex_unlock(&s->lock);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%" PRIu64, missed);
+}
+
+static te_errno
+sampler_dump_get(unsigned int gid, const char *oid, char *value,
+                 const char *name)
+{
+    sampler *s = sampler_find(name);
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%s",
+                       te_str_empty_if_null(s->dump));
+}
+
+static te_errno
+sampler_dump_set(unsigned int gid, const char *oid, const char *value,
+                 const char *name)
+{
+    sampler *s = sampler_find(name);
+    te_errno rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    if (*value == '\0')
+    {
+        free(s->dump);
+        s->dump = NULL;
+        return 0;
+    }
+
+    rc = sampler_dump(s, value);
+    if (rc != 0)
+        return rc;
+
+    free(s->dump);
+    s->dump = TE_STRDUP(value);
+    return 0;
+}
+
+static te_errno
+sampler_counter_add(unsigned int gid, const char *oid, const char *value,
+                    const char *name, const char *cname)
+{
+    sampler         *s;
+    sampler_counter *cnt;
+    te_errno         rc;
+
+    UNUSED(oid);
+
+    rc = sampler_find_stopped(name, &s);
+    if (rc != 0)
+        return rc;
+
+    if (sampler_counter_find(s, cname) != NULL)
+        return TE_RC(TE_TA_UNIX, TE_EEXIST);
+
+    cnt = TE_ALLOC(sizeof(*cnt));
+    cnt->name = TE_STRDUP(cname);
+    cnt->spec = TE_STRDUP(value);
+#ifdef WITH_BPF
+    cnt->map_fd = -1;
+#endif
+
+    rc = sampler_counter_setup(s, gid, cnt);
+    if (rc != 0)
+    {
+        sampler_counter_free(s, cnt);
+        return rc;
+    }
+
+    TAILQ_INSERT_TAIL(&s->counters, cnt, links);
+    s->n_counters++;
+    sampler_ring_free(s);
+
+    return 0;
+}
+
+static te_errno
+sampler_counter_del(unsigned int gid, const char *oid, const char *name,
+                    const char *cname)
+{
+    sampler         *s;
+    sampler_counter *cnt;
+    te_errno         rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    rc = sampler_find_stopped(name, &s);
+    if (rc != 0)
+        return rc;
+
+    cnt = sampler_counter_find(s, cname);
+    if (cnt == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    TAILQ_REMOVE(&s->counters, cnt, links);
+    s->n_counters--;
+    sampler_counter_free(s, cnt);
+    sampler_ring_free(s);
+
+    return 0;
+}
+
+static te_errno
+sampler_counter_get(unsigned int gid, const char *oid, char *value,
+                    const char *name, const char *cname)
+{
+    sampler         *s = sampler_find(name);
+    sampler_counter *cnt;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    if (s == NULL || (cnt = sampler_counter_find(s, cname)) == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%s", cnt->spec);
+}
+
+static te_errno
+sampler_counter_list(unsigned int gid, const char *oid, const char *sub_id,
+                     char **list, const char *name)
+{
+    te_string        str = TE_STRING_INIT;
+    sampler         *s = sampler_find(name);
+    sampler_counter *cnt;
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(sub_id);
+
+    if (s == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    TAILQ_FOREACH(cnt, &s->counters, links)
+        te_string_append(&str, "%s ", cnt->name);
+
+    te_string_move(list, &str);
+    return 0;
+}
+
+RCF_PCH_CFG_NODE_RW_COLLECTION(node_sampler_counter, "counter", NULL, NULL,
+                               sampler_counter_get, NULL,
+                               sampler_counter_add, sampler_counter_del,
+                               sampler_counter_list, NULL);
+
+RCF_PCH_CFG_NODE_RO(node_sampler_missed, "missed", NULL,
+                    &node_sampler_counter, sampler_missed_get);
+
+RCF_PCH_CFG_NODE_RW(node_sampler_dump, "dump", NULL, &node_sampler_missed,
+                    sampler_dump_get, sampler_dump_set);
+
+RCF_PCH_CFG_NODE_RW(node_sampler_enable, "enable", NULL, &node_sampler_dump,
+                    sampler_enable_get, sampler_enable_set);
+
+RCF_PCH_CFG_NODE_RW(node_sampler_depth, "depth", NULL, &node_sampler_enable,
+                    sampler_depth_get, sampler_depth_set);
+
+RCF_PCH_CFG_NODE_RW(node_sampler_interval, "interval", NULL,
+                    &node_sampler_depth,
+                    sampler_interval_get, sampler_interval_set);
+
+RCF_PCH_CFG_NODE_COLLECTION(node_sampler, "sampler",
+                            &node_sampler_interval, NULL,
+                            sampler_add, sampler_del, sampler_list, NULL);
+
+te_errno
+ta_unix_conf_sampler_init(void)
+{
+    return rcf_pch_add_node("/agent", &node_sampler);
+}
+
+te_errno
+ta_unix_conf_sampler_cleanup(void)
+{
+    sampler *s;
+
+    while ((s = TAILQ_FIRST(&samplers)) != NULL)
+    {
+        TAILQ_REMOVE(&samplers, s, links);
+        sampler_free(s);
+    }
+
+    return 0;
+}
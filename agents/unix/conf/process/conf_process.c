@@ -18,6 +18,8 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <stddef.h>
+#include <inttypes.h>
 
 #include "ta_job.h"
 #include "logger_api.h"
@@ -95,6 +97,10 @@ struct ps_entry {
     struct ps_ta_job        ta_job;
 
     te_vec                  exec_params;
+    /* Whether the process runs in a dedicated cgroup */
+    te_bool                 cgroup;
+    /* Parent of the dedicated cgroup, NULL for the cgroup of the agent */
+    char                   *cgroup_parent;
 };
 
 static SLIST_HEAD(, ps_entry) processes = SLIST_HEAD_INITIALIZER(processes);
@@ -576,6 +582,18 @@ ps_ta_job_reconfigure(struct ps_entry *ps)
         return rc;
     }
 
+    if (ps->cgroup)
+    {
+        rc = ta_job_set_cgroup(manager, ta_job->id,
+                               te_str_empty_if_null(ps->cgroup_parent));
+        if (rc != 0)
+        {
+            ERROR("Failed to set cgroup of the process '%s', error: %r",
+                  ps->name, rc);
+            return rc;
+        }
+    }
+
     return ps_enable_stdout_and_stderr_logging(ps);
 }
 
@@ -820,6 +838,7 @@ ps_free(struct ps_entry *ps)
 
     ps_free_exec_params(&ps->exec_params);
 
+    free(ps->cgroup_parent);
     free(ps->name);
     free(ps->exe);
     free(ps);
@@ -1172,6 +1191,170 @@ ps_workdir_set(unsigned int gid, const char *oid, const char *value,
     return rc;
 }
 
+static te_errno
+ps_cgroup_get(unsigned int gid, const char *oid, char *value,
+              const char *ps_name)
+{
+    struct ps_entry *ps;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    ENTRY("%s", ps_name);
+
+    ps = ps_find(ps_name);
+    if (ps == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    snprintf(value, RCF_MAX_VAL, "%d", ps->cgroup ? 1 : 0);
+
+    return 0;
+}
+
+static te_errno
+ps_cgroup_set(unsigned int gid, const char *oid, const char *value,
+              const char *ps_name)
+{
+    struct ps_entry *ps;
+    te_bool enable;
+    te_errno rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    ENTRY("%s", ps_name);
+
+    ps = ps_find(ps_name);
+    if (ps == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    if (ps->enabled)
+        return TE_RC(TE_TA_UNIX, TE_EBUSY);
+
+    rc = te_strtol_bool(value, &enable);
+    if (rc != 0)
+        return TE_RC(TE_TA_UNIX, rc);
+
+    if (enable != ps->cgroup)
+    {
+        ps->cgroup = enable;
+        ps->ta_job.reconfigure_required = TRUE;
+    }
+
+    return 0;
+}
+
+static te_errno
+ps_cgroup_parent_get(unsigned int gid, const char *oid, char *value,
+                     const char *ps_name)
+{
+    struct ps_entry *ps;
+    te_errno rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    ENTRY("%s", ps_name);
+
+    ps = ps_find(ps_name);
+    if (ps == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    rc = te_snprintf(value, RCF_MAX_VAL, "%s",
+                     te_str_empty_if_null(ps->cgroup_parent));
+    return TE_RC_UPSTREAM(TE_TA_UNIX, rc);
+}
+
+static te_errno
+ps_cgroup_parent_set(unsigned int gid, const char *oid, const char *value,
+                     const char *ps_name)
+{
+    struct ps_entry *ps;
+    char *parent = NULL;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    ENTRY("%s", ps_name);
+
+    ps = ps_find(ps_name);
+    if (ps == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    if (ps->enabled)
+        return TE_RC(TE_TA_UNIX, TE_EBUSY);
+
+    if (!te_str_is_null_or_empty(value))
+    {
+        parent = strdup(value);
+        if (parent == NULL)
+            return TE_RC(TE_TA_UNIX, TE_ENOMEM);
+    }
+
+    free(ps->cgroup_parent);
+    ps->cgroup_parent = parent;
+    if (ps->cgroup)
+        ps->ta_job.reconfigure_required = TRUE;
+
+    return 0;
+}
+
+/*
+ * Get a resource usage counter of the process cgroup. Zero is reported
+ * if the process has no dedicated cgroup or has never been started.
+ */
+static te_errno
+ps_cgroup_stat_get(char *value, const char *ps_name, size_t offset)
+{
+    ta_job_cgroup_stats_t stats;
+    struct ps_entry *ps;
+    uint64_t counter = 0;
+    te_errno rc;
+
+    ENTRY("%s", ps_name);
+
+    ps = ps_find(ps_name);
+    if (ps == NULL)
+        return TE_RC(TE_TA_UNIX, TE_ENOENT);
+
+    if (ps->cgroup && ps->ta_job.created)
+    {
+        rc = ta_job_get_cgroup_stats(manager, ps->ta_job.id, &stats);
+        if (rc == 0)
+            counter = *(uint64_t *)((uint8_t *)&stats + offset);
+        else if (rc != TE_ENOENT)
+            return TE_RC(TE_TA_UNIX, rc);
+    }
+
+    snprintf(value, RCF_MAX_VAL, "%" PRIu64, counter);
+
+    return 0;
+}
+
+/** Define a getter of a cgroup resource usage counter */
+#define PS_CGROUP_STAT_GETTER(_field) \
+    static te_errno                                                     \
+    ps_cgroup_##_field##_get(unsigned int gid, const char *oid,         \
+                             char *value, const char *ps_name)          \
+    {                                                                   \
+        UNUSED(gid);                                                    \
+        UNUSED(oid);                                                    \
+                                                                        \
+        return ps_cgroup_stat_get(value, ps_name,                       \
+                                  offsetof(ta_job_cgroup_stats_t,       \
+                                           _field));                    \
+    }
+
+PS_CGROUP_STAT_GETTER(cpu_usage_us)
+PS_CGROUP_STAT_GETTER(cpu_user_us)
+PS_CGROUP_STAT_GETTER(cpu_system_us)
+PS_CGROUP_STAT_GETTER(memory_current)
+PS_CGROUP_STAT_GETTER(memory_peak)
+PS_CGROUP_STAT_GETTER(io_read_bytes)
+PS_CGROUP_STAT_GETTER(io_write_bytes)
+
+#undef PS_CGROUP_STAT_GETTER
+
 static struct ps_arg_entry *
 ps_arg_find(const struct ps_entry *ps, unsigned int order)
 {
@@ -1854,8 +2037,38 @@ RCF_PCH_CFG_NODE_RW(node_ps_long_opt_sep, "long_option_value_separator", NULL,
 RCF_PCH_CFG_NODE_RW(node_ps_workdir, "workdir", NULL, &node_ps_long_opt_sep,
                     ps_workdir_get, ps_workdir_set);
 
+RCF_PCH_CFG_NODE_RO(node_ps_cgroup_io_write, "io_write", NULL, NULL,
+                    ps_cgroup_io_write_bytes_get);
+
+RCF_PCH_CFG_NODE_RO(node_ps_cgroup_io_read, "io_read", NULL,
+                    &node_ps_cgroup_io_write, ps_cgroup_io_read_bytes_get);
+
+RCF_PCH_CFG_NODE_RO(node_ps_cgroup_memory_peak, "memory_peak", NULL,
+                    &node_ps_cgroup_io_read, ps_cgroup_memory_peak_get);
+
+RCF_PCH_CFG_NODE_RO(node_ps_cgroup_memory_current, "memory_current", NULL,
+                    &node_ps_cgroup_memory_peak,
+                    ps_cgroup_memory_current_get);
+
+RCF_PCH_CFG_NODE_RO(node_ps_cgroup_cpu_system, "cpu_system", NULL,
+                    &node_ps_cgroup_memory_current,
+                    ps_cgroup_cpu_system_us_get);
+
+RCF_PCH_CFG_NODE_RO(node_ps_cgroup_cpu_user, "cpu_user", NULL,
+                    &node_ps_cgroup_cpu_system, ps_cgroup_cpu_user_us_get);
+
+RCF_PCH_CFG_NODE_RO(node_ps_cgroup_cpu_usage, "cpu_usage", NULL,
+                    &node_ps_cgroup_cpu_user, ps_cgroup_cpu_usage_us_get);
+
+RCF_PCH_CFG_NODE_RW(node_ps_cgroup_parent, "parent", NULL,
+                    &node_ps_cgroup_cpu_usage, ps_cgroup_parent_get,
+                    ps_cgroup_parent_set);
+
+RCF_PCH_CFG_NODE_RW(node_ps_cgroup, "cgroup", &node_ps_cgroup_parent,
+                    &node_ps_workdir, ps_cgroup_get, ps_cgroup_set);
+
 RCF_PCH_CFG_NODE_RW(node_ps_autorestart, "autorestart", NULL,
-                    &node_ps_workdir, ps_autorestart_get,
+                    &node_ps_cgroup, ps_autorestart_get,
                     ps_autorestart_set);
 
 RCF_PCH_CFG_NODE_RW(node_ps_kill_self, "self", NULL, NULL,
@@ -1064,7 +1064,8 @@ bpf_get_map_params(unsigned int gid, const char *oid, char *value,
  *
  * @param gid           Group identifier (unused).
  * @param oid           Full object instance identifier.
- * @param[out] value    Obtained value.
+ * @param value_str     Buffer for the value (unused, the value
+ *                      is returned by reference).
  * @param bpf_id        BPF object id.
  * @param map_name      Map name.
  * @param view          View of the map (unused).
@@ -1079,12 +1080,13 @@ bpf_get_map_kv_pair(unsigned int gid, const char *oid, char *value_str,
 {
     struct bpf_map_entry *map;
     unsigned char *key, *value;
-    te_string value_buf = TE_STRING_EXT_BUF_INIT(value_str, RCF_MAX_VAL);
+    te_string value_buf = TE_STRING_INIT;
     te_errno rc = 0;
 
     UNUSED(gid);
     UNUSED(oid);
     UNUSED(view);
+    UNUSED(value_str);
 
     map = bpf_find_map(bpf_id, map_name);
     if (map == NULL)
@@ -1115,7 +1117,14 @@ bpf_get_map_kv_pair(unsigned int gid, const char *oid, char *value_str,
         goto fail_free_key_value;
     }
 
+    /*
+     * Values of per-CPU maps may be too long for the buffer,
+     * so return the value by reference.
+     */
     rc = te_str_hex_raw2str(value, map->value_size * map->n_values, &value_buf);
+    if (rc == 0)
+        rcf_pch_value_set_string(&value_buf);
+    te_string_free(&value_buf);
 
 fail_free_key_value:
     free(value);
@@ -45,6 +45,25 @@ SLIST_HEAD(, serial_parser_t) parsers_h;
     } \
 }
 
+/**
+ * Notify the Test Engine about the detected event without waiting
+ * for the event status to be polled.
+ *
+ * @param parser    The parser
+ * @param event     Detected event
+ */
+static void
+parser_event_post(const serial_parser_t *parser, const serial_event_t *event)
+{
+    te_errno rc;
+
+    rc = rcf_pch_event_post("serial_event %s %s %s", parser->name,
+                            event->name, event->t_name);
+    if (rc != 0)
+        ERROR("Failed to post event %s of the parser %s: %r",
+              event->name, parser->name, rc);
+}
+
 /**
  * Searching for the parser by name.
  *
@@ -202,6 +221,7 @@ parser_add(unsigned int gid, const char *oid, char *cname,
     parser = TE_ALLOC_UNINITIALIZED(sizeof(serial_parser_t));
     parser->enable      = FALSE;
     parser->rcf         = FALSE;
+    parser->event_cb    = parser_event_post;
     parser->port        = TE_SERIAL_PORT;
     parser->interval    = TE_SERIAL_INTERVAL;
     parser->logging     = TRUE;
@@ -1038,6 +1058,7 @@ parser_event_common_set(unsigned int gid, const char *oid, char *value,
 
     serial_parser_t     *parser;
     serial_event_t      *event;
+    te_bool              activated = FALSE;
 
     parser = parser_get_by_name(pname);
     event  = parser_get_event_by_name(parser, ename);
@@ -1046,7 +1067,10 @@ parser_event_common_set(unsigned int gid, const char *oid, char *value,
 
     TE_SERIAL_CHECK_LOCK(pthread_mutex_lock(&parser->mutex));
     if (strstr(oid, "/status:") != NULL)
+    {
+        activated = !event->status && atoi(value) != 0;
         event->status = atoi(value) == 0 ? FALSE : TRUE;
+    }
     else if (strstr(oid, "/counter:") != NULL)
         event->count = atoi(value);
     else
@@ -1056,6 +1080,10 @@ parser_event_common_set(unsigned int gid, const char *oid, char *value,
     }
     TE_SERIAL_CHECK_LOCK(pthread_mutex_unlock(&parser->mutex));
 
+    /* Event activated manually is handled as a detected one */
+    if (activated && parser->event_cb != NULL)
+        parser->event_cb(parser, event);
+
     return 0;
 }
 
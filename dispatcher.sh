@@ -310,6 +310,20 @@ Generic options:
 
   --tester-dial=<percentage>    Choose randomly a given percentage of all
                                 available test iterations.
+  --tester-dial-budget=<seconds>
+                                Choose test iterations which are expected to
+                                run within a given time, covering all pairs of
+                                argument values first and then preferring tests
+                                with unexpected results in previous runs.
+                                Cannot be used together with --tester-dial.
+  --tester-dial-history=<file>  Data about previous runs for
+                                --tester-dial-budget: lines with test path,
+                                average iteration duration in seconds and share
+                                of unexpected results (0-1).
+  --tester-dial-history-save=<file>
+                                Save data about tests run in the format of
+                                --tester-dial-history (data about tests which
+                                are not run is kept from --tester-dial-history).
 
   --test-sigusr2-stop           Stop all the testing when SIGUSR2 signal is received.
                                 The default behaviour is to print a verdict in the
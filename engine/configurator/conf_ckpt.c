@@ -0,0 +1,685 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Configurator
+ *
+ * Binary checkpoints of the configuration database.
+ *
+ * A checkpoint is a compact alternative to the XML backup file which
+ * is only used to check whether the database has returned to the state
+ * it had when the backup was created. Restoring a backup from the dynamic
+ * history replays only commands executed after the backup, and then
+ * the result is compared with the checkpoint in memory instead of
+ * dumping the whole database to XML and running diff(1) on it.
+ *
+ * The checkpoint is stored next to the backup and is bound to the backup
+ * file by its inode, size and modification time, so a checkpoint is never
+ * used after the backup file is rewritten.
+ *
+ * The set of subtrees the checkpoint is created for is stored in it.
+ * A checkpoint is only used to verify the same set of subtrees: if
+ * a narrower set were compared, the database could match the checkpoint
+ * while the XML backup verification fails on a subtree which is missing
+ * in the database.
+ *
+ * File layout (host byte order, the file never leaves the host):
+ * - header: magic, number of subtrees and entries, digest of the payload,
+ *   identification of the backup file;
+ * - subtrees, each one is a record header of kind 's' followed by
+ *   the subtree OID;
+ * - entries sorted by kind and OID, each one is a fixed-size record
+ *   header followed by OID and value strings without terminating zeroes.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include <sys/stat.h>
+
+#include "conf_defs.h"
+#include "conf_ckpt.h"
+#include "te_alloc.h"
+#include "te_dbuf.h"
+#include "te_file.h"
+#include "te_string.h"
+
+/** Checkpoint file magic, includes format version */
+#define CFG_CKPT_MAGIC "TECSCKP3"
+
+/** Maximum number of differences logged on verification failure */
+#define CFG_CKPT_MAX_LOGGED_DIFFS 8
+
+/** Identification of the backup file the checkpoint belongs to */
+typedef struct cfg_ckpt_backup_id {
+    uint64_t ino;        /**< Inode number */
+    uint64_t size;       /**< Size in bytes */
+    int64_t  mtime_sec;  /**< Modification time, seconds */
+    int64_t  mtime_nsec; /**< Modification time, nanoseconds */
+} cfg_ckpt_backup_id;
+
+/** Checkpoint file header */
+typedef struct cfg_ckpt_header {
+    char     magic[8];   /**< CFG_CKPT_MAGIC */
+    uint32_t n_entries;  /**< Number of entries */
+    uint32_t n_subtrees; /**< Number of subtrees */
+    uint64_t digest;     /**< FNV-1a digest of the payload */
+    cfg_ckpt_backup_id backup; /**< Backup file identification */
+} cfg_ckpt_header;
+
+/** Checkpoint entry header */
+typedef struct cfg_ckpt_rec {
+    uint8_t  kind;      /**< 'o' for objects, 'i' for instances,
+                             's' for subtrees */
+    uint8_t  reserved[3];
+    uint32_t oid_len;   /**< OID length */
+    uint32_t val_len;   /**< Value length */
+} cfg_ckpt_rec;
+
+/** In-memory checkpoint entry */
+typedef struct cfg_ckpt_entry {
+    uint8_t     kind;       /**< 'o' for objects, 'i' for instances */
+    const char *oid;        /**< OID */
+    size_t      oid_len;    /**< OID length */
+    const char *val;        /**< Value in string representation */
+    size_t      val_len;    /**< Value length */
+    char       *val_owned;  /**< Value to be freed, if any */
+} cfg_ckpt_entry;
+
+/** Update FNV-1a digest with a chunk of data */
+static uint64_t
+ckpt_digest_update(uint64_t digest, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    while (len-- > 0)
+    {
+        digest ^= *p++;
+        digest *= UINT64_C(0x100000001b3);
+    }
+
+    return digest;
+}
+
+/** Initial value of FNV-1a digest */
+#define CKPT_DIGEST_INIT UINT64_C(0xcbf29ce484222325)
+
+/**
+ * Get identification of the backup file.
+ *
+ * @param backup    name of the backup file
+ * @param id        location for the identification
+ *
+ * @return Status code
+ */
+static te_errno
+ckpt_backup_id_get(const char *backup, cfg_ckpt_backup_id *id)
+{
+    struct stat st;
+
+    if (stat(backup, &st) != 0)
+        return TE_OS_RC(TE_CS, errno);
+
+    memset(id, 0, sizeof(*id));
+    id->ino = st.st_ino;
+    id->size = st.st_size;
+    id->mtime_sec = st.st_mtim.tv_sec;
+    id->mtime_nsec = st.st_mtim.tv_nsec;
+
+    return 0;
+}
+
+/**
+ * Get name of the checkpoint file of the backup.
+ *
+ * @param backup    name of the backup file
+ *
+ * @return Checkpoint filename, should be freed by the caller.
+ */
+static char *
+ckpt_filename(const char *backup)
+{
+    return te_string_fmt("%s%s", backup, CFG_CKPT_SUFFIX);
+}
+
+/**
+ * Check whether an OID belongs to one of the subtrees.
+ *
+ * @param oid       OID
+ * @param oid_len   OID length
+ * @param subtrees  vector of subtrees, may be @c NULL
+ *
+ * @return @c TRUE if @p subtrees is empty or the OID is inside one of them
+ */
+static te_bool
+ckpt_oid_in_subtrees(const char *oid, size_t oid_len, const te_vec *subtrees)
+{
+    char * const *subtree;
+
+    if (subtrees == NULL || te_vec_size(subtrees) == 0)
+        return TRUE;
+
+    TE_VEC_FOREACH(subtrees, subtree)
+    {
+        size_t len = strlen(*subtree);
+
+        if (oid_len >= len && strncmp(oid, *subtree, len) == 0 &&
+            (oid_len == len || oid[len] == '/'))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/** Release entries collected by ckpt_collect_*() */
+static void
+ckpt_entries_free(te_vec *entries)
+{
+    cfg_ckpt_entry *entry;
+
+    TE_VEC_FOREACH(entries, entry)
+        free(entry->val_owned);
+
+    te_vec_free(entries);
+}
+
+/** Append an entry with an owned value */
+static void
+ckpt_entry_add(te_vec *entries, uint8_t kind, const char *oid, char *val)
+{
+    cfg_ckpt_entry entry = {
+        .kind = kind,
+        .oid = oid,
+        .oid_len = strlen(oid),
+        .val = te_str_empty_if_null(val),
+        .val_len = val == NULL ? 0 : strlen(val),
+        .val_owned = val,
+    };
+
+    TE_VEC_APPEND(entries, entry);
+}
+
+/**
+ * Collect objects the same way as put_object() in conf_backup.c does.
+ *
+ * @param obj       object to start from
+ * @param entries   vector of cfg_ckpt_entry to append entries to
+ */
+static void
+ckpt_collect_objects(cfg_object *obj, te_vec *entries)
+{
+    if (obj != &cfg_obj_root && !cfg_object_agent(obj))
+    {
+        te_string descr = TE_STRING_INIT;
+        cfg_dependency *dep;
+
+        te_string_append(&descr, "%s %s %s %s",
+                         te_enum_map_from_value(cfg_cva_mapping,
+                                                obj->access),
+                         te_enum_map_from_value(cfg_cvt_mapping, obj->type),
+                         obj->unit ? "unit" : "-",
+                         te_str_empty_if_null(obj->def_val));
+        for (dep = obj->depends_on; dep != NULL; dep = dep->next)
+        {
+            te_string_append(&descr, "\n%s %s", dep->depends->oid,
+                             dep->object_wide ? "object" : "instance");
+        }
+
+        ckpt_entry_add(entries, 'o', obj->oid, descr.ptr);
+    }
+
+    for (obj = obj->son; obj != NULL; obj = obj->brother)
+        ckpt_collect_objects(obj, entries);
+}
+
+/**
+ * Collect instances the same way as put_instance() in conf_backup.c does.
+ *
+ * @param inst      instance to start from
+ * @param subtrees  subtrees to collect, may be @c NULL
+ * @param entries   vector of cfg_ckpt_entry to append entries to
+ *
+ * @return Status code
+ */
+static te_errno
+ckpt_collect_instances(cfg_instance *inst, const te_vec *subtrees,
+                       te_vec *entries)
+{
+    te_errno rc;
+
+    if (inst != &cfg_inst_root && !cfg_inst_agent(inst) &&
+        !cfg_instance_volatile(inst) &&
+        ckpt_oid_in_subtrees(inst->oid, strlen(inst->oid), subtrees))
+    {
+        char *val_str = NULL;
+
+        if (inst->obj->type != CVT_NONE)
+        {
+            rc = cfg_types[inst->obj->type].val2str(inst->val, &val_str);
+            if (rc != 0)
+            {
+                ERROR("Conversion failed for instance %s type %d: %r",
+                      inst->oid, inst->obj->type, rc);
+                return rc;
+            }
+        }
+
+        ckpt_entry_add(entries, 'i', inst->oid, val_str);
+    }
+
+    for (inst = inst->son; inst != NULL; inst = inst->brother)
+    {
+        rc = ckpt_collect_instances(inst, subtrees, entries);
+        if (rc != 0)
+            return rc;
+    }
+
+    return 0;
+}
+
+/** Compare entries by kind and OID */
+static int
+ckpt_entry_cmp(const void *arg1, const void *arg2)
+{
+    const cfg_ckpt_entry *e1 = arg1;
+    const cfg_ckpt_entry *e2 = arg2;
+    size_t len = MIN(e1->oid_len, e2->oid_len);
+    int rc;
+
+    if (e1->kind != e2->kind)
+        return e1->kind < e2->kind ? -1 : 1;
+
+    rc = memcmp(e1->oid, e2->oid, len);
+    if (rc != 0)
+        return rc;
+
+    if (e1->oid_len == e2->oid_len)
+        return 0;
+
+    return e1->oid_len < e2->oid_len ? -1 : 1;
+}
+
+/**
+ * Collect the current state of the database as a sorted vector of entries.
+ *
+ * @param subtrees  subtrees to collect, may be @c NULL
+ * @param entries   vector of cfg_ckpt_entry to fill in
+ *
+ * @return Status code
+ */
+static te_errno
+ckpt_collect(const te_vec *subtrees, te_vec *entries)
+{
+    te_errno rc;
+
+    ckpt_collect_objects(&cfg_obj_root, entries);
+    rc = ckpt_collect_instances(&cfg_inst_root, subtrees, entries);
+    if (rc != 0)
+        return rc;
+
+    te_vec_sort(entries, ckpt_entry_cmp);
+    return 0;
+}
+
+/* See the description in conf_ckpt.h */
+te_errno
+cfg_ckpt_create(const char *backup, const te_vec *subtrees)
+{
+    te_vec entries = TE_VEC_INIT(cfg_ckpt_entry);
+    te_dbuf payload = TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+    cfg_ckpt_header hdr = { .magic = CFG_CKPT_MAGIC };
+    cfg_ckpt_entry *entry;
+    char *filename = ckpt_filename(backup);
+    FILE *f = NULL;
+    te_errno rc;
+
+    rc = ckpt_backup_id_get(backup, &hdr.backup);
+    if (rc != 0)
+    {
+        ERROR("Failed to get backup '%s' attributes: %r", backup, rc);
+        goto out;
+    }
+
+    rc = ckpt_collect(subtrees, &entries);
+    if (rc != 0)
+        goto out;
+
+    if (subtrees != NULL)
+    {
+        char * const *subtree;
+
+        TE_VEC_FOREACH(subtrees, subtree)
+        {
+            cfg_ckpt_rec rec = {
+                .kind = 's',
+                .oid_len = strlen(*subtree),
+            };
+
+            te_dbuf_append(&payload, &rec, sizeof(rec));
+            te_dbuf_append(&payload, *subtree, rec.oid_len);
+        }
+        hdr.n_subtrees = te_vec_size(subtrees);
+    }
+
+    TE_VEC_FOREACH(&entries, entry)
+    {
+        cfg_ckpt_rec rec = {
+            .kind = entry->kind,
+            .oid_len = entry->oid_len,
+            .val_len = entry->val_len,
+        };
+
+        te_dbuf_append(&payload, &rec, sizeof(rec));
+        te_dbuf_append(&payload, entry->oid, entry->oid_len);
+        te_dbuf_append(&payload, entry->val, entry->val_len);
+    }
+
+    hdr.n_entries = te_vec_size(&entries);
+    hdr.digest = ckpt_digest_update(CKPT_DIGEST_INIT, payload.ptr,
+                                    payload.len);
+
+    f = fopen(filename, "w");
+    if (f == NULL)
+    {
+        rc = TE_OS_RC(TE_CS, errno);
+        ERROR("Failed to create checkpoint '%s': %r", filename, rc);
+        goto out;
+    }
+
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+        (payload.len > 0 && fwrite(payload.ptr, payload.len, 1, f) != 1))
+    {
+        rc = TE_OS_RC(TE_CS, errno);
+        ERROR("Failed to write checkpoint '%s': %r", filename, rc);
+    }
+
+    if (fclose(f) != 0 && rc == 0)
+        rc = TE_OS_RC(TE_CS, errno);
+
+    if (rc != 0)
+        unlink(filename);
+
+out:
+    te_dbuf_free(&payload);
+    ckpt_entries_free(&entries);
+    free(filename);
+    return rc;
+}
+
+/* See the description in conf_ckpt.h */
+void
+cfg_ckpt_remove(const char *backup)
+{
+    char *filename = ckpt_filename(backup);
+
+    if (unlink(filename) != 0 && errno != ENOENT)
+        WARN("Failed to remove checkpoint '%s': %s", filename,
+             strerror(errno));
+
+    free(filename);
+}
+
+/**
+ * Parse the next entry of a checkpoint payload.
+ *
+ * @param[in,out] pos   current position, advanced past the entry
+ * @param end           end of the payload
+ * @param entry         where to store the entry
+ *
+ * @return Status code
+ */
+static te_errno
+ckpt_parse_entry(const char **pos, const char *end, cfg_ckpt_entry *entry)
+{
+    cfg_ckpt_rec rec;
+
+    if ((size_t)(end - *pos) < sizeof(rec))
+        return TE_EILSEQ;
+
+    memcpy(&rec, *pos, sizeof(rec));
+    *pos += sizeof(rec);
+
+    if ((size_t)(end - *pos) < (size_t)rec.oid_len + rec.val_len)
+        return TE_EILSEQ;
+
+    entry->kind = rec.kind;
+    entry->oid = *pos;
+    entry->oid_len = rec.oid_len;
+    entry->val = *pos + rec.oid_len;
+    entry->val_len = rec.val_len;
+    entry->val_owned = NULL;
+
+    *pos += rec.oid_len + rec.val_len;
+
+    return 0;
+}
+
+/**
+ * Check whether a subtree is listed in the vector of subtrees.
+ *
+ * @param oid       subtree OID
+ * @param oid_len   subtree OID length
+ * @param subtrees  vector of subtrees, may be @c NULL
+ *
+ * @return @c TRUE if the subtree is listed
+ */
+static te_bool
+ckpt_subtree_listed(const char *oid, size_t oid_len, const te_vec *subtrees)
+{
+    char * const *subtree;
+
+    if (subtrees == NULL)
+        return FALSE;
+
+    TE_VEC_FOREACH(subtrees, subtree)
+    {
+        if (strlen(*subtree) == oid_len &&
+            memcmp(*subtree, oid, oid_len) == 0)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * Check whether the checkpoint is created for the same set of subtrees.
+ *
+ * @param[in,out] pos   position of the first subtree, advanced past
+ *                      the last one
+ * @param end           end of the payload
+ * @param n_subtrees    number of subtrees in the checkpoint
+ * @param subtrees      subtrees to compare, may be @c NULL
+ *
+ * @return Status code
+ * @retval TE_EOPNOTSUPP the checkpoint is created for other subtrees
+ */
+static te_errno
+ckpt_check_subtrees(const char **pos, const char *end, uint32_t n_subtrees,
+                    const te_vec *subtrees)
+{
+    te_vec saved_subtrees = TE_VEC_INIT(char *);
+    char * const *subtree;
+    te_bool same = TRUE;
+    uint32_t i;
+    te_errno rc = 0;
+
+    for (i = 0; i < n_subtrees; i++)
+    {
+        cfg_ckpt_entry saved;
+        char *oid;
+
+        rc = ckpt_parse_entry(pos, end, &saved);
+        if (rc == 0 && (saved.kind != 's' || saved.val_len != 0))
+            rc = TE_EILSEQ;
+        if (rc != 0)
+            goto out;
+
+        if (!ckpt_subtree_listed(saved.oid, saved.oid_len, subtrees))
+            same = FALSE;
+
+        oid = TE_ALLOC(saved.oid_len + 1);
+        memcpy(oid, saved.oid, saved.oid_len);
+        TE_VEC_APPEND(&saved_subtrees, oid);
+    }
+
+    if (subtrees != NULL)
+    {
+        TE_VEC_FOREACH(subtrees, subtree)
+        {
+            if (!ckpt_subtree_listed(*subtree, strlen(*subtree),
+                                     &saved_subtrees))
+                same = FALSE;
+        }
+    }
+
+    if (!same)
+        rc = TE_EOPNOTSUPP;
+
+out:
+    te_vec_deep_free(&saved_subtrees);
+    return rc;
+}
+
+/** Log a single checkpoint difference */
+static void
+ckpt_log_diff(const char *what, const cfg_ckpt_entry *entry)
+{
+    INFO("Checkpoint mismatch: %s %s %.*s", what,
+         entry->kind == 'o' ? "object" : "instance",
+         (int)entry->oid_len, entry->oid);
+}
+
+/* See the description in conf_ckpt.h */
+te_errno
+cfg_ckpt_verify(const char *backup, const te_vec *subtrees)
+{
+    te_string content = TE_STRING_INIT;
+    te_vec entries = TE_VEC_INIT(cfg_ckpt_entry);
+    char *filename = ckpt_filename(backup);
+    cfg_ckpt_header hdr;
+    cfg_ckpt_backup_id backup_id;
+    const char *pos;
+    const char *end;
+    unsigned int n_diffs = 0;
+    size_t cur = 0;
+    uint32_t i;
+    te_errno rc;
+
+    if (access(filename, F_OK) != 0)
+    {
+        free(filename);
+        return TE_ENOENT;
+    }
+
+    rc = te_file_read_string(&content, TRUE, 0, "%s", filename);
+    if (rc != 0)
+    {
+        ERROR("Failed to read checkpoint '%s': %r", filename, rc);
+        goto out;
+    }
+
+    if (content.len < sizeof(hdr))
+    {
+        rc = TE_EILSEQ;
+        goto corrupted;
+    }
+
+    memcpy(&hdr, content.ptr, sizeof(hdr));
+    pos = content.ptr + sizeof(hdr);
+    end = content.ptr + content.len;
+
+    if (memcmp(hdr.magic, CFG_CKPT_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.digest != ckpt_digest_update(CKPT_DIGEST_INIT, pos, end - pos))
+    {
+        rc = TE_EILSEQ;
+        goto corrupted;
+    }
+
+    if (ckpt_backup_id_get(backup, &backup_id) != 0 ||
+        memcmp(&backup_id, &hdr.backup, sizeof(backup_id)) != 0)
+    {
+        INFO("Checkpoint '%s' does not match backup '%s', remove it",
+             filename, backup);
+        unlink(filename);
+        rc = TE_ESTALE;
+        goto out;
+    }
+
+    rc = ckpt_check_subtrees(&pos, end, hdr.n_subtrees, subtrees);
+    if (TE_RC_GET_ERROR(rc) == TE_EOPNOTSUPP)
+    {
+        INFO("Checkpoint '%s' is created for other subtrees", filename);
+        goto out;
+    }
+    if (rc != 0)
+        goto corrupted;
+
+    rc = ckpt_collect(subtrees, &entries);
+    if (rc != 0)
+        goto out;
+
+    for (i = 0; i < hdr.n_entries; i++)
+    {
+        cfg_ckpt_entry saved;
+        const cfg_ckpt_entry *current = NULL;
+        int cmp = -1;
+
+        rc = ckpt_parse_entry(&pos, end, &saved);
+        if (rc != 0)
+            goto corrupted;
+
+        /* Both sequences are sorted, so walk them as in merge */
+        while (cur < te_vec_size(&entries))
+        {
+            current = te_vec_get(&entries, cur);
+            cmp = ckpt_entry_cmp(current, &saved);
+            if (cmp >= 0)
+                break;
+
+            if (n_diffs++ < CFG_CKPT_MAX_LOGGED_DIFFS)
+                ckpt_log_diff("unexpected", current);
+            cur++;
+        }
+
+        if (cmp != 0)
+        {
+            if (n_diffs++ < CFG_CKPT_MAX_LOGGED_DIFFS)
+                ckpt_log_diff("missing", &saved);
+            continue;
+        }
+
+        if (current->val_len != saved.val_len ||
+            memcmp(current->val, saved.val, saved.val_len) != 0)
+        {
+            if (n_diffs++ < CFG_CKPT_MAX_LOGGED_DIFFS)
+                ckpt_log_diff("changed", &saved);
+        }
+        cur++;
+    }
+
+    if (pos != end)
+    {
+        rc = TE_EILSEQ;
+        goto corrupted;
+    }
+
+    for (; cur < te_vec_size(&entries); cur++)
+    {
+        if (n_diffs++ < CFG_CKPT_MAX_LOGGED_DIFFS)
+            ckpt_log_diff("unexpected", te_vec_get(&entries, cur));
+    }
+
+    if (n_diffs != 0)
+    {
+        INFO("Database differs from checkpoint '%s' in %u entries",
+             filename, n_diffs);
+        rc = TE_EBACKUP;
+    }
+    goto out;
+
+corrupted:
+    ERROR("Checkpoint '%s' is corrupted", filename);
+
+out:
+    ckpt_entries_free(&entries);
+    te_string_free(&content);
+    free(filename);
+    return rc;
+}
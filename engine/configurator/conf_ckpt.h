@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Configurator
+ *
+ * Binary checkpoints of the configuration database
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_CONF_CKPT_H__
+#define __TE_CONF_CKPT_H__
+
+#include "te_vector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Suffix appended to a backup filename to get its checkpoint filename */
+#define CFG_CKPT_SUFFIX ".ckpt"
+
+/**
+ * Create a binary checkpoint of the configuration database for a backup.
+ *
+ * The checkpoint contains the same objects and instances that
+ * cfg_backup_create_file() puts into an XML backup, but they are stored
+ * in a compact sorted form protected by a content digest, so that
+ * the database may later be compared against it without generating
+ * and diffing XML files. The checkpoint is stored in the file named
+ * after the backup with #CFG_CKPT_SUFFIX appended and is bound to
+ * the current inode, size and modification time of the backup file.
+ * The set of subtrees is stored in the checkpoint as well.
+ *
+ * @param backup     name of the backup file created from the same
+ *                   database state
+ * @param subtrees   vector of the subtrees to put into the checkpoint,
+ *                   @c NULL or empty to store the whole database
+ *
+ * @return Status code
+ */
+extern te_errno cfg_ckpt_create(const char *backup, const te_vec *subtrees);
+
+/**
+ * Check whether the current state of the configuration database
+ * matches the checkpoint of a backup.
+ *
+ * If the backup file has been changed or removed since the checkpoint
+ * was created, the checkpoint is removed.
+ *
+ * The checkpoint is only used if it is created for the same set of
+ * subtrees, otherwise the caller should verify the XML backup.
+ *
+ * @param backup     name of the backup file
+ * @param subtrees   vector of the subtrees to compare, @c NULL or empty
+ *                   to compare the whole database
+ *
+ * @return Status code
+ * @retval 0            the database matches the checkpoint
+ * @retval TE_EBACKUP   the database differs from the checkpoint
+ * @retval TE_ENOENT    there is no checkpoint for the backup
+ * @retval TE_ESTALE    the checkpoint does not match the backup file
+ * @retval TE_EOPNOTSUPP the checkpoint is created for other subtrees
+ * @retval TE_EILSEQ    the checkpoint file is corrupted
+ */
+extern te_errno cfg_ckpt_verify(const char *backup, const te_vec *subtrees);
+
+/**
+ * Remove the checkpoint of a backup if any. It should be called when
+ * the backup is released, so that the checkpoint cannot be matched
+ * against a different file created later with the same name.
+ *
+ * @param backup     name of the backup file
+ */
+extern void cfg_ckpt_remove(const char *backup);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __TE_CONF_CKPT_H__ */
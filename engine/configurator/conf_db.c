@@ -9,6 +9,7 @@
  */
 
 #include "conf_defs.h"
+#include "conf_sub.h"
 #include "te_alloc.h"
 #include "te_string.h"
 
@@ -1499,6 +1500,8 @@ cfg_add_with_obj_and_parent(cfg_instance *par_inst, cfg_object *obj,
     par_inst->son =  cfg_all_inst[i];
     *inst = cfg_all_inst[i];
 
+    cfg_sub_notify(CFG_CHANGE_ADD, oid_s);
+
     return 0;
 }
 
@@ -1784,6 +1787,7 @@ cfg_db_add(const char *oid_s, cfg_handle *handle,
         cfg_all_inst_max = i;
 
     cfg_free_oid(oid);
+    cfg_sub_notify(CFG_CHANGE_ADD, inst->oid);
     if (strcmp_start(CFG_TA_PREFIX, inst->oid) != 0)
     {
         return cfg_db_add_children(inst);
@@ -1871,6 +1875,8 @@ delete_son(cfg_instance *father, cfg_instance *son)
     /* Delete from the array of object instances */
     cfg_all_inst[CFG_INST_HANDLE_TO_INDEX(son->handle)] = NULL;
 
+    cfg_sub_notify(CFG_CHANGE_DEL, son->oid);
+
     /* Free memory allocated for the instance */
     if (son->obj->type != CVT_NONE)
         cfg_types[son->obj->type].free(son->val);
@@ -1890,6 +1896,29 @@ cfg_db_del(cfg_handle handle)
     delete_son(CFG_GET_INST(handle)->father, CFG_GET_INST(handle));
 }
 
+/* Check whether values are equal, pointer values may be NULL */
+static te_bool
+cfg_db_val_equal(cfg_val_type type, cfg_inst_val val1, cfg_inst_val val2)
+{
+    switch (type)
+    {
+        case CVT_STRING:
+            if (val1.val_str == NULL || val2.val_str == NULL)
+                return val1.val_str == val2.val_str;
+            break;
+
+        case CVT_ADDRESS:
+            if (val1.val_addr == NULL || val2.val_addr == NULL)
+                return val1.val_addr == val2.val_addr;
+            break;
+
+        default:
+            break;
+    }
+
+    return cfg_types[type].is_equal(val1, val2);
+}
+
 /**
  * Change instance value.
  *
@@ -1907,6 +1936,8 @@ cfg_db_set(cfg_handle handle, cfg_inst_val val)
     if (inst->obj->type != CVT_NONE)
     {
         cfg_inst_val val0;
+        te_bool changed = !cfg_db_val_equal(inst->obj->type, inst->val,
+                                            val);
         int err = cfg_types[inst->obj->type].copy(val, &val0);
 
         if (err)
@@ -1914,6 +1945,9 @@ cfg_db_set(cfg_handle handle, cfg_inst_val val)
 
         cfg_types[inst->obj->type].free(inst->val);
         inst->val = val0;
+
+        if (changed)
+            cfg_sub_notify(CFG_CHANGE_SET, inst->oid);
     }
 
     return 0;
@@ -9,6 +9,7 @@
 
 #include "te_alloc.h"
 #include "conf_defs.h"
+#include "conf_ckpt.h"
 #define TE_EXPAND_XML 1
 #include "te_expand.h"
 
@@ -49,6 +50,7 @@ free_entry_backup(cfg_dh_entry *entry)
     for (tmp = entry->backup; tmp != NULL; tmp = entry->backup)
     {
         entry->backup = entry->backup->next;
+        cfg_ckpt_remove(tmp->filename);
         free(tmp->filename);
         free(tmp);
     }
@@ -1808,6 +1810,7 @@ cfg_dh_release_backup(char *filename)
         else
             tmp->backup = cur->next;
 
+        cfg_ckpt_remove(cur->filename);
         free(cur->filename);
         free(cur);
 
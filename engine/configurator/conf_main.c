@@ -15,6 +15,8 @@
 #endif /* WITH_CONF_YAML */
 #include "conf_rcf.h"
 #include "conf_ipc.h"
+#include "conf_ckpt.h"
+#include "conf_sub.h"
 
 #include <libxml/xinclude.h>
 #include "te_kvpair.h"
@@ -22,6 +24,8 @@
 #include "te_str.h"
 #include "te_string.h"
 #include "te_vector.h"
+#include "te_perf.h"
+#include "te_trace.h"
 
 #if HAVE_SIGNAL_H
 #include <signal.h>
@@ -73,6 +77,15 @@ static unsigned int cs_flags = 0;
 
 static te_bool cs_inconsistency_state = FALSE;
 
+/** IPC client which sent the message being processed */
+static struct ipc_server_client *cs_msg_user = NULL;
+
+/**
+ * Histograms of messages processing duration (microseconds)
+ * by message type, created on the first message of a type.
+ */
+static te_perf_hist *cfg_msg_perf[CFG_SUB_WAIT + 1];
+
 static void process_backup(cfg_backup_msg *msg, te_bool release_dh);
 static te_errno create_backup(char **bkp_filename);
 static te_errno process_backup_op(const char *name, uint8_t op);
@@ -1913,6 +1926,21 @@ log_msg(cfg_msg *msg, te_bool before)
                     ((cfg_process_history_msg *)msg)->filename);
             break;
 
+        case CFG_SUBSCRIBE:
+            LOG_MSG(level, "Subscribe to %s%s",
+                    ((cfg_subscribe_msg *)msg)->pattern, addon);
+            break;
+
+        case CFG_UNSUBSCRIBE:
+            LOG_MSG(level, "Unsubscribe %u%s",
+                    ((cfg_unsubscribe_msg *)msg)->id, addon);
+            break;
+
+        case CFG_SUB_WAIT:
+            LOG_MSG(level, "Wait for changes of subscription %u%s",
+                    ((cfg_sub_wait_msg *)msg)->id, addon);
+            break;
+
         case CFG_CONF_DELAY:
             LOG_MSG(level, "Wait configuration changes");
             break;
@@ -1979,6 +2007,25 @@ verify_backup(const char *backup, te_bool log, const char *msg,
     return rc;
 }
 
+/**
+ * Check if the current DB matches the binary checkpoint created
+ * together with the backup. It is much cheaper than verify_backup(),
+ * but it is only able to confirm a match; the caller should fall back
+ * to verify_backup() to get the diff logged or if the checkpoint
+ * is created for other subtrees.
+ *
+ * @param backup        backup filename
+ * @param subtrees      subtrees to compare, @c NULL to compare
+ *                      the whole database
+ *
+ * @return @c TRUE if the checkpoint exists and DB matches it
+ */
+static te_bool
+verify_backup_checkpoint(const char *backup, const te_vec *subtrees)
+{
+    return cfg_ckpt_verify(backup, subtrees) == 0;
+}
+
 /**
  * Check the running agents
  *
@@ -2286,6 +2333,8 @@ process_backup(cfg_backup_msg *msg, te_bool release_dh)
     {
         case CFG_BACKUP_CREATE:
         {
+            te_errno rc;
+
             sprintf(backup_filename, CONF_BACKUP_NAME,
                     tmp_dir, getpid(), get_time_ms());
 
@@ -2296,7 +2345,16 @@ process_backup(cfg_backup_msg *msg, te_bool release_dh)
             }
 
             if ((msg->rc = cfg_dh_attach_backup(backup_filename)) != 0)
+            {
                 unlink(backup_filename);
+            }
+            else
+            {
+                /* Checkpoint only speeds up verification, it is optional */
+                rc = cfg_ckpt_create(backup_filename, &subtrees_vec);
+                if (rc != 0)
+                    WARN("Failed to create backup checkpoint: %r", rc);
+            }
 
             msg->len += strlen(backup_filename) + 1;
 
@@ -2328,9 +2386,16 @@ process_backup(cfg_backup_msg *msg, te_bool release_dh)
                     cfg_conf_delay_reset();
                     cfg_ta_sync("/:", TRUE);
 
-                    msg->rc = verify_backup(backup_filename, FALSE,
-                                            "Restoring backup from history "
-                                            "failed:", NULL);
+                    if (verify_backup_checkpoint(backup_filename, NULL))
+                    {
+                        msg->rc = 0;
+                    }
+                    else
+                    {
+                        msg->rc = verify_backup(backup_filename, FALSE,
+                                                "Restoring backup from "
+                                                "history failed:", NULL);
+                    }
                     if (msg->rc == 0)
                     {
                         rcf_log_cfg_changes(FALSE);
@@ -2373,6 +2438,22 @@ process_backup(cfg_backup_msg *msg, te_bool release_dh)
             te_errno rc;
             te_string backup = TE_STRING_INIT;
 
+            rc = check_agents();
+            if (rc != 0)
+            {
+                ERROR("Backup verification failed: %r", rc);
+                msg->rc = rc;
+                break;
+            }
+
+            if (verify_backup_checkpoint(backup_filename, &subtrees_vec))
+            {
+                msg->rc = 0;
+                if (release_dh)
+                    cfg_dh_release_after(backup_filename);
+                break;
+            }
+
             /*
              * If subtrees is NULL @p backup string will contain
              * filename specified by the user
@@ -2387,14 +2468,6 @@ process_backup(cfg_backup_msg *msg, te_bool release_dh)
                 break;
             }
 
-            rc = check_agents();
-            if (rc != 0){
-                ERROR("Backup verification failed: %r", rc);
-                msg->rc = rc;
-                te_string_free(&backup);
-                break;
-            }
-
             msg->rc = verify_backup(backup.ptr, TRUE, NULL, &subtrees_vec);
             if (msg->rc != 0)
             {
@@ -2620,6 +2693,22 @@ process_register(cfg_register_msg *msg, te_bool update_dh)
 void
 cfg_process_msg(cfg_msg **msg, te_bool update_dh)
 {
+    uint8_t       type = (*msg)->type;
+    uint64_t      start = te_perf_now_us();
+    te_trace_ctx  caller;
+    te_trace_span span;
+
+    /*
+     * Requests to RCF and nested messages processed on behalf of
+     * this message become children of its span.
+     */
+    te_trace_current(&caller);
+    te_trace_span_start(&span, &caller, "cs.%s",
+                        te_enum_map_from_any_value(cfg_ipc_msg_type_names,
+                                                   type, "unknown"));
+    if (te_trace_span_active(&span))
+        te_trace_set_current(&span.ctx);
+
     log_msg(*msg, TRUE);
 
     switch ((*msg)->type)
@@ -2703,9 +2792,16 @@ cfg_process_msg(cfg_msg **msg, te_bool update_dh)
         }
 
         case CFG_SYNC:
-            (*msg)->rc = cfg_ta_sync(((cfg_sync_msg *)(*msg))->oid,
-                                     ((cfg_sync_msg *)(*msg))->subtree);
+        {
+            cfg_sync_msg *sync_msg = (cfg_sync_msg *)(*msg);
+
+            if (sync_msg->subtree && sync_msg->depth != 0)
+                sync_msg->rc = cfg_ta_sync_depth(sync_msg->oid,
+                                                 sync_msg->depth);
+            else
+                sync_msg->rc = cfg_ta_sync(sync_msg->oid, sync_msg->subtree);
             break;
+        }
 
         case CFG_REBOOT:
             process_reboot((cfg_reboot_msg *)(*msg));
@@ -2728,6 +2824,8 @@ cfg_process_msg(cfg_msg **msg, te_bool update_dh)
             }
             else
             {
+                /* Checkpoint of the overwritten backup is not valid */
+                cfg_ckpt_remove(((cfg_config_msg *)(*msg))->filename);
                 (*msg)->rc = cfg_backup_create_file(
                                  ((cfg_config_msg *)(*msg))->filename, NULL);
             }
@@ -2778,6 +2876,15 @@ cfg_process_msg(cfg_msg **msg, te_bool update_dh)
             cfg_process_msg_tree_print((cfg_tree_print_msg *)*msg);
             break;
 
+        case CFG_SUBSCRIBE:
+            cfg_sub_process_msg_subscribe((cfg_subscribe_msg *)*msg,
+                                          cs_msg_user);
+            break;
+
+        case CFG_UNSUBSCRIBE:
+            cfg_sub_process_msg_unsubscribe((cfg_unsubscribe_msg *)*msg);
+            break;
+
         default: /* Should not occur */
             ERROR("Unknown message is received");
             break;
@@ -2785,6 +2892,22 @@ cfg_process_msg(cfg_msg **msg, te_bool update_dh)
 
     (*msg)->rc = TE_RC(TE_CS, (*msg)->rc);
 
+    if (type < TE_ARRAY_LEN(cfg_msg_perf))
+    {
+        /* The message may be re-allocated, so its type is saved above */
+        if (cfg_msg_perf[type] == NULL)
+        {
+            cfg_msg_perf[type] =
+                te_perf_hist_get("cs.msg.%s",
+                                 te_enum_map_from_any_value(
+                                     cfg_ipc_msg_type_names, type, "unknown"));
+        }
+        te_perf_hist_add(cfg_msg_perf[type], te_perf_now_us() - start);
+    }
+
+    te_trace_span_end(&span);
+    te_trace_set_current(&caller);
+
     log_msg(*msg, FALSE);
 }
 
@@ -2803,6 +2926,9 @@ free_resources(void)
     VERB("Free resources");
     free(cfg_get_buf);
 
+    VERB("Cancel subscriptions");
+    cfg_sub_shutdown();
+
     VERB("Closing server");
     ipc_close_server(server);
 
@@ -3020,6 +3146,9 @@ main(int argc, char **argv)
     (void)signal(SIGPIPE, cfg_sigpipe_handler);
 #endif
 
+    /* Failure to dump counters is not critical */
+    (void)te_perf_log_start();
+
     ipc_init();
     if (ipc_register_server(CONFIGURATOR_SERVER, CONFIGURATOR_IPC,
                             &server) != 0)
@@ -3090,13 +3219,34 @@ main(int argc, char **argv)
 
     INFO("Initialization is finished");
     cfg_conf_delay = 0;
+    cfg_sub_init(server);
 
     while (TRUE)
     {
         struct ipc_server_client *user = NULL;
 
-        cfg_msg *msg = (cfg_msg *)buf;
-        size_t   len = CFG_BUF_LEN;
+        cfg_msg        *msg = (cfg_msg *)buf;
+        size_t          len = CFG_BUF_LEN;
+        fd_set          set;
+        struct timeval  tv;
+        int             select_rc;
+
+        /*
+         * Wait for a request, but do not miss timeouts of subscribers
+         * waiting for configuration changes.
+         */
+        FD_ZERO(&set);
+        (void)ipc_get_server_fds(server, &set);
+        select_rc = select(FD_SETSIZE, &set, NULL, NULL,
+                           cfg_sub_timeout(&tv) ? &tv : NULL);
+        if (select_rc < 0 && errno != EINTR)
+            ERROR("Unexpected failure of select(): errno=%d", errno);
+
+        if (select_rc <= 0 || !ipc_is_server_ready(server, &set, FD_SETSIZE))
+        {
+            cfg_sub_dispatch();
+            continue;
+        }
 
         if ((rc = ipc_receive_message(server, buf, &len, &user)) != 0)
         {
@@ -3109,10 +3259,23 @@ main(int argc, char **argv)
             ERROR("Configurator is in inconsistent state");
             msg->rc = TE_RC(TE_CS, TE_EFAULT);
         }
+        else if (msg->type == CFG_SUB_WAIT)
+        {
+            /* The answer is sent when changes appear or on timeout */
+            log_msg(msg, TRUE);
+            cfg_sub_wait(user, (cfg_sub_wait_msg *)msg);
+            cfg_sub_dispatch();
+            continue;
+        }
         else
         {
             msg->rc = 0;
+            /* Link processing of the request to the trace of the caller */
+            te_trace_set_current(&msg->trace);
+            cs_msg_user = user;
             cfg_process_msg(&msg, TRUE);
+            cs_msg_user = NULL;
+            te_trace_set_current(NULL);
         }
 
         rc = ipc_send_answer(server, user, (char *)msg, msg->len);
@@ -3124,6 +3287,9 @@ main(int argc, char **argv)
         if ((char *)msg != buf)
             free(msg);
 
+        /* The request may change subscribed subtrees */
+        cfg_sub_dispatch();
+
         if (cs_flags & CS_SHUTDOWN)
         {
             result = EXIT_SUCCESS;
@@ -3132,6 +3298,7 @@ main(int argc, char **argv)
     }
 
 exit:
+    te_perf_log_stop();
 
     free(cfg_files);
 
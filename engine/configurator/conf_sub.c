@@ -0,0 +1,476 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Configurator
+ *
+ * Subscriptions to changes of the configuration database.
+ *
+ * A subscription is a pattern of instance OIDs (each sub-identifier
+ * and each instance name may be '*') with a bounded queue of changes
+ * of matching instances and their descendants. Changes are queued
+ * whenever the database is modified: by configuration requests,
+ * by synchronization with Test Agents and by backup restoration.
+ *
+ * A client waits for changes with CFG_SUB_WAIT request. Configurator
+ * is single-threaded, so the answer to the request is deferred until
+ * changes appear or the timeout expires, and other requests are
+ * processed in the meantime. While somebody waits, the subscribed
+ * subtree may be periodically synchronized with Test Agents, so that
+ * changes done by non-CS means are noticed without client-side polling.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "conf_defs.h"
+#include "conf_sub.h"
+#include "te_alloc.h"
+#include "te_queue.h"
+#include "te_string.h"
+
+/** Maximum number of queued changes of a subscription */
+#define CFG_SUB_QUEUE_MAX   1024
+
+/** Queued change */
+typedef struct cfg_sub_change {
+    TAILQ_ENTRY(cfg_sub_change) links;  /**< Queue links */
+    cfg_change_type             type;   /**< Change type */
+    char                       *oid;    /**< Instance OID */
+} cfg_sub_change;
+
+/** Subscription */
+typedef struct cfg_sub {
+    LIST_ENTRY(cfg_sub)     links;      /**< List links */
+    unsigned int            id;         /**< Subscription ID */
+    cfg_oid                *pattern;    /**< Parsed OID pattern */
+    char                   *sync_oid;   /**< Subtree to synchronize or
+                                             @c NULL */
+    uint64_t                sync_period; /**< Synchronization period,
+                                              microseconds */
+    uint64_t                next_sync;  /**< Time of the next
+                                             synchronization */
+    unsigned int            owner;      /**< ID of the IPC client which
+                                             subscribed */
+
+    TAILQ_HEAD(, cfg_sub_change) changes; /**< Queued changes */
+    unsigned int            n_changes;  /**< Number of queued changes */
+    te_bool                 lost;       /**< Some changes are lost */
+
+    unsigned int            waiter;     /**< ID of the IPC client waiting
+                                             for changes or @c 0 */
+    cfg_msg                 waiter_msg; /**< Header of the wait request */
+    uint64_t                deadline;   /**< Timeout of the waiter */
+} cfg_sub;
+
+/** IPC server to send deferred answers */
+static struct ipc_server *cfg_sub_server = NULL;
+
+/** List of subscriptions */
+static LIST_HEAD(, cfg_sub) cfg_subs = LIST_HEAD_INITIALIZER(cfg_subs);
+
+/** ID of the last subscription */
+static unsigned int cfg_sub_last_id = 0;
+
+/* Get the current time in microseconds */
+static uint64_t
+cfg_sub_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Find subscription by ID */
+static cfg_sub *
+cfg_sub_find(unsigned int id)
+{
+    cfg_sub *sub;
+
+    LIST_FOREACH(sub, &cfg_subs, links)
+    {
+        if (sub->id == id)
+            return sub;
+    }
+
+    return NULL;
+}
+
+/*
+ * Get the longest prefix of the pattern without wildcards which may be
+ * synchronized with Test Agents. An agent name wildcard is allowed since
+ * cfg_ta_sync() supports it.
+ */
+static char *
+cfg_sub_sync_oid(const cfg_oid *pattern)
+{
+    const cfg_inst_subid *ids = (const cfg_inst_subid *)pattern->ids;
+    te_string             oid = TE_STRING_INIT;
+    int                   i;
+
+    if (pattern->len < 2 || strcmp(ids[1].subid, "agent") != 0)
+        return NULL;
+
+    for (i = 1; i < pattern->len; i++)
+    {
+        if (strchr(ids[i].subid, '*') != NULL ||
+            (i > 1 && strchr(ids[i].name, '*') != NULL))
+            break;
+
+        te_string_append(&oid, "/%s:%s", ids[i].subid, ids[i].name);
+    }
+
+    return oid.ptr;
+}
+
+/* Check whether an instance OID or its ancestor matches the pattern */
+static te_bool
+cfg_sub_match(const cfg_oid *pattern, const cfg_oid *oid)
+{
+    const cfg_inst_subid *p = (const cfg_inst_subid *)pattern->ids;
+    const cfg_inst_subid *s = (const cfg_inst_subid *)oid->ids;
+    int                   i;
+
+    if (oid->len < pattern->len)
+        return FALSE;
+
+    /* The root is the first sub-identifier of both OIDs */
+    for (i = 1; i < pattern->len; i++)
+    {
+        if ((strcmp(p[i].subid, "*") != 0 &&
+             strcmp(p[i].subid, s[i].subid) != 0) ||
+            (strcmp(p[i].name, "*") != 0 &&
+             strcmp(p[i].name, s[i].name) != 0))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Free queued changes */
+static void
+cfg_sub_changes_free(cfg_sub *sub)
+{
+    cfg_sub_change *change;
+
+    while ((change = TAILQ_FIRST(&sub->changes)) != NULL)
+    {
+        TAILQ_REMOVE(&sub->changes, change, links);
+        free(change->oid);
+        free(change);
+    }
+    sub->n_changes = 0;
+}
+
+/*
+ * Send an answer to the waiter of the subscription. Queued changes
+ * which fit into the answer are removed from the queue.
+ */
+static void
+cfg_sub_answer(cfg_sub *sub, te_errno rc)
+{
+    struct ipc_server_client *waiter;
+    cfg_sub_wait_msg *answer;
+    cfg_sub_change   *change;
+    char             *p;
+    te_errno          ipc_rc;
+
+    waiter = ipc_server_client_by_id(cfg_sub_server, sub->waiter);
+    sub->waiter = 0;
+    if (waiter == NULL)
+    {
+        /* The client has gone, nobody needs the answer */
+        return;
+    }
+
+    answer = TE_ALLOC(CFG_SUB_WAIT_MAX_LEN);
+    *(cfg_msg *)answer = sub->waiter_msg;
+    answer->id = sub->id;
+    p = answer->changes;
+
+    if (rc == 0)
+    {
+        while ((change = TAILQ_FIRST(&sub->changes)) != NULL)
+        {
+            size_t oid_len = strlen(change->oid) + 1;
+
+            /* A single change always fits since OID length is limited */
+            if (p + 1 + oid_len > (char *)answer + CFG_SUB_WAIT_MAX_LEN)
+                break;
+
+            *p++ = change->type;
+            memcpy(p, change->oid, oid_len);
+            p += oid_len;
+            answer->n_changes++;
+
+            TAILQ_REMOVE(&sub->changes, change, links);
+            sub->n_changes--;
+            free(change->oid);
+            free(change);
+        }
+
+        answer->lost = sub->lost;
+        sub->lost = FALSE;
+    }
+
+    answer->rc = TE_RC(TE_CS, rc);
+    answer->len = p - (char *)answer;
+
+    VERB("Subscription %u: answer %r with %u changes%s", sub->id, rc,
+         answer->n_changes, answer->lost ? " (some are lost)" : "");
+
+    ipc_rc = ipc_send_answer(cfg_sub_server, waiter, answer, answer->len);
+    if (ipc_rc != 0)
+        ERROR("Cannot send an answer to subscriber: errno=%r", ipc_rc);
+
+    free(answer);
+}
+
+/* Remove subscription and free its resources */
+static void
+cfg_sub_free(cfg_sub *sub, te_errno waiter_rc)
+{
+    if (sub->waiter != 0)
+        cfg_sub_answer(sub, waiter_rc);
+
+    LIST_REMOVE(sub, links);
+    cfg_sub_changes_free(sub);
+    cfg_free_oid(sub->pattern);
+    free(sub->sync_oid);
+    free(sub);
+}
+
+/* See description in conf_sub.h */
+void
+cfg_sub_init(struct ipc_server *ipcs)
+{
+    cfg_sub_server = ipcs;
+}
+
+/* See description in conf_sub.h */
+void
+cfg_sub_process_msg_subscribe(cfg_subscribe_msg *msg,
+                              const struct ipc_server_client *user)
+{
+    cfg_sub *sub;
+    cfg_oid *pattern;
+
+    if (msg->len <= sizeof(*msg) ||
+        ((char *)msg)[msg->len - 1] != '\0')
+    {
+        msg->rc = TE_EINVAL;
+        return;
+    }
+
+    pattern = cfg_convert_oid_str(msg->pattern);
+    if (pattern == NULL || !pattern->inst)
+    {
+        ERROR("Bad subscription pattern '%s'", msg->pattern);
+        cfg_free_oid(pattern);
+        msg->rc = TE_EINVAL;
+        return;
+    }
+
+    sub = TE_ALLOC(sizeof(*sub));
+    sub->id = ++cfg_sub_last_id;
+    sub->pattern = pattern;
+    sub->owner = ipc_server_client_id(user);
+    TAILQ_INIT(&sub->changes);
+
+    if (msg->sync_period != 0)
+    {
+        sub->sync_oid = cfg_sub_sync_oid(pattern);
+        if (sub->sync_oid == NULL)
+        {
+            WARN("Subscription to '%s' is not synchronized: "
+                 "it is not a Test Agent subtree", msg->pattern);
+        }
+        sub->sync_period = (uint64_t)msg->sync_period * 1000;
+    }
+
+    LIST_INSERT_HEAD(&cfg_subs, sub, links);
+
+    INFO("Subscription %u to '%s' is created", sub->id, msg->pattern);
+
+    msg->id = sub->id;
+    msg->len = sizeof(*msg);
+}
+
+/* See description in conf_sub.h */
+void
+cfg_sub_process_msg_unsubscribe(cfg_unsubscribe_msg *msg)
+{
+    cfg_sub *sub = cfg_sub_find(msg->id);
+
+    if (sub == NULL)
+    {
+        msg->rc = TE_ENOENT;
+        return;
+    }
+
+    cfg_sub_free(sub, TE_ECANCELED);
+    INFO("Subscription %u is removed", msg->id);
+}
+
+/* See description in conf_sub.h */
+void
+cfg_sub_wait(struct ipc_server_client *user, const cfg_sub_wait_msg *msg)
+{
+    cfg_sub *sub = cfg_sub_find(msg->id);
+    te_errno rc = 0;
+
+    if (sub == NULL)
+    {
+        rc = TE_ENOENT;
+    }
+    else if (ipc_server_client_by_id(cfg_sub_server, sub->waiter) != NULL)
+    {
+        ERROR("Subscription %u already has a waiter", sub->id);
+        rc = TE_EBUSY;
+    }
+
+    if (rc != 0)
+    {
+        cfg_sub_wait_msg answer;
+
+        memset(&answer, 0, sizeof(answer));
+        answer.type = msg->type;
+        answer.id = msg->id;
+        answer.rc = TE_RC(TE_CS, rc);
+        answer.len = sizeof(answer);
+        rc = ipc_send_answer(cfg_sub_server, user, &answer, answer.len);
+        if (rc != 0)
+            ERROR("Cannot send an answer to subscriber: errno=%r", rc);
+        return;
+    }
+
+    sub->waiter = ipc_server_client_id(user);
+    sub->waiter_msg = *(const cfg_msg *)msg;
+    sub->deadline = cfg_sub_now() + (uint64_t)msg->timeout * 1000;
+
+    if (sub->sync_oid != NULL && sub->next_sync == 0)
+        sub->next_sync = cfg_sub_now();
+
+    /* Changes queued before are delivered by cfg_sub_dispatch() */
+}
+
+/* See description in conf_sub.h */
+void
+cfg_sub_notify(cfg_change_type type, const char *oid)
+{
+    cfg_oid *parsed;
+    cfg_sub *sub;
+
+    if (LIST_EMPTY(&cfg_subs))
+        return;
+
+    parsed = cfg_convert_oid_str(oid);
+    if (parsed == NULL)
+        return;
+
+    LIST_FOREACH(sub, &cfg_subs, links)
+    {
+        cfg_sub_change *change;
+
+        if (!cfg_sub_match(sub->pattern, parsed))
+            continue;
+
+        if (sub->n_changes >= CFG_SUB_QUEUE_MAX)
+        {
+            sub->lost = TRUE;
+            continue;
+        }
+
+        change = TE_ALLOC(sizeof(*change));
+        change->type = type;
+        change->oid = TE_STRDUP(oid);
+        TAILQ_INSERT_TAIL(&sub->changes, change, links);
+        sub->n_changes++;
+    }
+
+    cfg_free_oid(parsed);
+}
+
+/* See description in conf_sub.h */
+void
+cfg_sub_dispatch(void)
+{
+    cfg_sub *sub;
+    cfg_sub *next;
+    uint64_t now = cfg_sub_now();
+
+    LIST_FOREACH_SAFE(sub, &cfg_subs, links, next)
+    {
+        if (ipc_server_client_by_id(cfg_sub_server, sub->owner) == NULL)
+        {
+            INFO("Subscription %u is removed since its owner has gone",
+                 sub->id);
+            cfg_sub_free(sub, TE_ECANCELED);
+            continue;
+        }
+
+        if (sub->waiter != 0 && sub->sync_oid != NULL &&
+            TAILQ_EMPTY(&sub->changes) && now >= sub->next_sync)
+        {
+            te_errno rc = cfg_ta_sync(sub->sync_oid, TRUE);
+
+            if (rc != 0)
+            {
+                WARN("Subscription %u: failed to synchronize '%s': %r",
+                     sub->id, sub->sync_oid, rc);
+            }
+
+            now = cfg_sub_now();
+            sub->next_sync = now + sub->sync_period;
+        }
+    }
+
+    /* Synchronization may add changes to any subscription */
+    LIST_FOREACH(sub, &cfg_subs, links)
+    {
+        if (sub->waiter == 0)
+            continue;
+
+        if (!TAILQ_EMPTY(&sub->changes) || sub->lost)
+            cfg_sub_answer(sub, 0);
+        else if (now >= sub->deadline)
+            cfg_sub_answer(sub, TE_ETIMEDOUT);
+    }
+}
+
+/* See description in conf_sub.h */
+te_bool
+cfg_sub_timeout(struct timeval *tv)
+{
+    cfg_sub *sub;
+    uint64_t now = cfg_sub_now();
+    uint64_t next = UINT64_MAX;
+
+    LIST_FOREACH(sub, &cfg_subs, links)
+    {
+        if (sub->waiter == 0)
+            continue;
+
+        next = MIN(next, sub->deadline);
+        if (sub->sync_oid != NULL)
+            next = MIN(next, sub->next_sync);
+    }
+
+    if (next == UINT64_MAX)
+        return FALSE;
+
+    next = next > now ? next - now : 0;
+    tv->tv_sec = next / 1000000;
+    tv->tv_usec = next % 1000000;
+
+    return TRUE;
+}
+
+/* See description in conf_sub.h */
+void
+cfg_sub_shutdown(void)
+{
+    cfg_sub *sub;
+
+    while ((sub = LIST_FIRST(&cfg_subs)) != NULL)
+        cfg_sub_free(sub, TE_ECANCELED);
+}
@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Configurator
+ *
+ * Subscriptions to changes of the configuration database
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_CONF_SUB_H__
+#define __TE_CONF_SUB_H__
+
+#include "conf_api.h"
+#include "conf_messages.h"
+#include "ipc_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize subscriptions support.
+ *
+ * @param ipcs      IPC server used to answer deferred wait requests
+ */
+extern void cfg_sub_init(struct ipc_server *ipcs);
+
+/**
+ * Process CFG_SUBSCRIBE message. The subscription is removed when
+ * the client which created it disconnects.
+ *
+ * @param msg       Message (ID of the new subscription is returned in it)
+ * @param user      Client which sent the message
+ */
+extern void cfg_sub_process_msg_subscribe(
+                cfg_subscribe_msg *msg,
+                const struct ipc_server_client *user);
+
+/**
+ * Process CFG_UNSUBSCRIBE message. The pending waiter of
+ * the subscription, if any, gets @c TE_ECANCELED.
+ *
+ * @param msg       Message
+ */
+extern void cfg_sub_process_msg_unsubscribe(cfg_unsubscribe_msg *msg);
+
+/**
+ * Process CFG_SUB_WAIT message. If there are queued changes,
+ * the answer is sent immediately, otherwise it is deferred until
+ * changes appear or the timeout expires.
+ *
+ * @param user      Client which sent the message
+ * @param msg       Message
+ */
+extern void cfg_sub_wait(struct ipc_server_client *user,
+                         const cfg_sub_wait_msg *msg);
+
+/**
+ * Notify subscribers about a change in the configuration database.
+ *
+ * @param type      Change type
+ * @param oid       Instance OID
+ */
+extern void cfg_sub_notify(cfg_change_type type, const char *oid);
+
+/**
+ * Synchronize subscribed subtrees which are due and answer waiters
+ * which have changes or whose timeout has expired.
+ */
+extern void cfg_sub_dispatch(void);
+
+/**
+ * Get time until the next event handled by cfg_sub_dispatch().
+ *
+ * @param[out] tv   Location for the time
+ *
+ * @return @c FALSE if there are no events to wait for.
+ */
+extern te_bool cfg_sub_timeout(struct timeval *tv);
+
+/**
+ * Cancel all waiters and free all subscriptions.
+ */
+extern void cfg_sub_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __TE_CONF_SUB_H__ */
@@ -6,12 +6,15 @@
  * TA interaction auxiliary routines
  */
 
+#include <limits.h>
 #include <search.h>
 #include "te_str.h"
 #include "conf_defs.h"
 #include "rcf_api.h"
 #include "te_queue.h"
 #include "te_alloc.h"
+#include "te_string.h"
+#include "te_vector.h"
 
 #define TA_LIST_SIZE    64
 
@@ -182,11 +185,13 @@ cfg_ta_log_syncing(te_bool flag)
  *
  * @param ta      Test Agent name
  * @param oid     object instance identifier
+ * @param value   instance value already obtained from the TA or @c NULL
+ *                to request it
  *
  * @return status code (see te_errno.h)
  */
 static int
-sync_ta_instance(const char *ta, const char *oid)
+sync_ta_instance(const char *ta, const char *oid, char *value)
 {
     cfg_object   *obj = cfg_get_object(oid);
     cfg_handle    handle = CFG_HANDLE_INVALID;
@@ -221,7 +226,7 @@ sync_ta_instance(const char *ta, const char *oid)
         return rc;
     }
 
-    while (TRUE)
+    while (value == NULL)
     {
         rc = rcf_ta_cfg_get(ta, 0, oid, cfg_get_buf, cfg_get_buf_len);
         if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
@@ -235,10 +240,15 @@ sync_ta_instance(const char *ta, const char *oid)
                 return TE_ENOMEM;
             }
         }
-        else if (TE_RC_GET_ERROR(rc) == TE_ENOENT || rc == 0 ||
-                 (TE_RC_GET_ERROR(rc) == TE_ENOENT && obj->vol))
+        else if (rc == 0)
         {
-            break;
+            value = cfg_get_buf;
+        }
+        else if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+        {
+            if (handle != CFG_HANDLE_INVALID)
+                cfg_db_del(handle);
+            return 0;
         }
         else
         {
@@ -247,22 +257,15 @@ sync_ta_instance(const char *ta, const char *oid)
         }
     }
 
-    if (rc != 0)
-    {
-        if (handle != CFG_HANDLE_INVALID)
-            cfg_db_del(handle);
-        return 0;
-    }
-
     if (do_log_syncing)
     {
-        RING("Syncing %s on %s -> %s", ta, oid, cfg_get_buf);
+        RING("Syncing %s on %s -> %s", ta, oid, value);
     }
 
-    if ((rc = cfg_types[obj->type].str2val(cfg_get_buf, &val)) != 0)
+    if ((rc = cfg_types[obj->type].str2val(value, &val)) != 0)
     {
         ERROR("Conversion of '%s' to value type %s(%d) for OID '%s' "
-                "failed", cfg_get_buf,
+                "failed", value,
                 te_enum_map_from_any_value(cfg_cvt_mapping, obj->type,
                                            "unknown type"),
                 obj->type, oid);
@@ -292,19 +295,23 @@ sync_ta_instance(const char *ta, const char *oid)
     return rc;
 }
 
-/* Remove entries, which do not mention in the list, from database */
+/*
+ * Remove entries, which do not mention in the list, from database.
+ * Descendants are checked up to @p levels levels below @p inst,
+ * deeper ones are not reported by the TA and are kept.
+ */
 static void
-remove_excessive(cfg_instance *inst, char *list)
+remove_excessive(cfg_instance *inst, char *list, unsigned int levels)
 {
     cfg_instance *tmp;
     cfg_instance *next;
     int len = strlen(inst->oid);
     char *s;
 
-    for (tmp = inst->son; tmp != NULL; tmp = next)
+    for (tmp = inst->son; tmp != NULL && levels > 0; tmp = next)
     {
         next = tmp->brother;
-        remove_excessive(tmp, list);
+        remove_excessive(tmp, list, levels - 1);
     }
 
     if (cfg_inst_agent(inst))
@@ -400,16 +407,165 @@ oid_tree_free(void *unused)
     UNUSED(unused);
 }
 
+/** Object instance reported by the TA in reply to getall request */
+typedef struct getall_entry {
+    const char *oid;    /**< Object instance identifier */
+    char       *value;  /**< Instance value or @c NULL if unknown */
+} getall_entry;
+
+/* Comparison function for sorting getall entries by OID */
+static int
+getall_entry_compare(const void *pa, const void *pb)
+{
+    const getall_entry *a = pa;
+    const getall_entry *b = pb;
+
+    return strcmp(a->oid, b->oid);
+}
+
+/**
+ * Parse the reply to getall request (see rcf_ta_cfg_getall()) in place.
+ *
+ * @param answer    reply from the TA (modified)
+ * @param entries   vector of getall_entry to fill in
+ * @param list      space-separated list of instances to append to
+ *
+ * @return status code (see te_errno.h)
+ */
+static te_errno
+parse_getall_answer(te_string *answer, te_vec *entries, te_string *list)
+{
+    char *cur = answer->ptr;
+    char *limit = answer->ptr + answer->len;
+
+    while (cur < limit)
+    {
+        getall_entry entry;
+        char *sep;
+        char *end;
+        unsigned long len;
+
+        sep = memchr(cur, ' ', limit - cur);
+        if (sep == NULL || sep + 1 >= limit)
+            return TE_EPROTO;
+        *sep++ = '\0';
+
+        entry.oid = cur;
+        if (*sep == '-')
+        {
+            entry.value = NULL;
+            end = sep + 1;
+        }
+        else
+        {
+            len = strtoul(sep, &end, 10);
+            if (end == sep || *end != ':' || len > (size_t)(limit - end - 1))
+                return TE_EPROTO;
+            entry.value = end + 1;
+            end += 1 + len;
+        }
+
+        if (end >= limit || *end != '\n')
+            return TE_EPROTO;
+        *end = '\0';
+        cur = end + 1;
+
+        TE_VEC_APPEND(entries, entry);
+        te_string_append(list, "%s ", entry.oid);
+    }
+
+    return 0;
+}
+
+/**
+ * Synchronize tree of object instances on the TA using a single getall
+ * request returning instances together with their values.
+ *
+ * @param ta      Test Agent name
+ * @param oid     root object instance identifier
+ * @param depth   maximum number of levels below the root to synchronize,
+ *                @c 0 for no limit
+ *
+ * @return status code (see te_errno.h)
+ * @retval TE_EOPNOTSUPP    the TA does not support getall request,
+ *                          nothing is changed
+ */
+static te_errno
+sync_ta_subtree_getall(const char *ta, const char *oid, unsigned int depth)
+{
+    te_string wildcard_oid = TE_STRING_INIT;
+    te_string answer = TE_STRING_INIT;
+    te_string list = TE_STRING_INIT;
+    te_vec entries = TE_VEC_INIT(getall_entry);
+    const getall_entry *entry;
+    const getall_entry *prev = NULL;
+    cfg_handle *handles = NULL;
+    unsigned int h_num;
+    unsigned int i;
+    te_errno rc;
+
+    te_string_append(&wildcard_oid, "%s/...", oid);
+    rc = rcf_ta_cfg_getall(ta, 0, wildcard_oid.ptr, depth, &answer);
+    te_string_free(&wildcard_oid);
+    if (rc != 0)
+    {
+        if (TE_RC_GET_ERROR(rc) != TE_EOPNOTSUPP)
+            ERROR("rcf_ta_cfg_getall() failed: TA=%s, error=%r", ta, rc);
+        goto out;
+    }
+
+    VERB("%s instances with values:\n%s", ta, answer.ptr);
+
+    rc = parse_getall_answer(&answer, &entries, &list);
+    if (rc != 0)
+    {
+        ERROR("Malformed getall reply from TA '%s'", ta);
+        goto out;
+    }
+    te_string_append(&list, "%s", oid);
+
+    rc = cfg_db_find_pattern(oid, &h_num, &handles);
+    if (rc != 0)
+        goto out;
+
+    for (i = 0; i < h_num; i++)
+        remove_excessive(CFG_GET_INST(handles[i]), list.ptr,
+                         depth == 0 ? UINT_MAX : depth);
+
+    /* Parents must be synchronized before their children */
+    te_vec_sort(&entries, getall_entry_compare);
+    TE_VEC_FOREACH(&entries, entry)
+    {
+        if (prev != NULL && strcmp(prev->oid, entry->oid) == 0)
+            continue;
+        prev = entry;
+
+        if ((rc = sync_ta_instance(ta, entry->oid, entry->value)) != 0)
+            break;
+    }
+
+out:
+    free(handles);
+    te_vec_free(&entries);
+    te_string_free(&list);
+    te_string_free(&answer);
+
+    return rc;
+}
+
 /**
  * Synchronize tree of object instances on the TA.
  *
  * @param ta      Test Agent name
  * @param oid     root object instance identifier
+ * @param depth   maximum number of levels below the root to synchronize,
+ *                @c 0 for no limit; the whole subtree is synchronized
+ *                if the TA does not support getall request
  *
  * @return status code (see te_errno.h)
  */
 static int
-sync_ta_subtree(const char *ta, const char *oid)
+sync_ta_subtree(const char *ta, const char *oid, unsigned int depth)
 {
     char  *tmp;
     char  *next;
@@ -443,6 +599,14 @@ sync_ta_subtree(const char *ta, const char *oid)
         return TE_ENOMEM;
     }
 
+    rc = sync_ta_subtree_getall(ta, oid, depth);
+    if (TE_RC_GET_ERROR(rc) != TE_EOPNOTSUPP)
+    {
+        rcf_ta_cfg_group(ta, 0, FALSE);
+        free(wildcard_oid);
+        return rc;
+    }
+
     cfg_get_buf[0] = 0;
     while (TRUE)
     {
@@ -500,7 +664,7 @@ sync_ta_subtree(const char *ta, const char *oid)
     sprintf(limit, " %s", oid);
 
     for (i = 0; i < h_num; i++)
-        remove_excessive(CFG_GET_INST(handles[i]), cfg_get_buf);
+        remove_excessive(CFG_GET_INST(handles[i]), cfg_get_buf, UINT_MAX);
 
     /* Calculate number of OIDs to be synchronized */
     for (tmp = cfg_get_buf; tmp < limit; tmp = next)
@@ -528,7 +692,7 @@ sync_ta_subtree(const char *ta, const char *oid)
     twalk(oid_tree_root, oid_tree_action);
     TAILQ_FOREACH(entry, &oid_queue, links)
     {
-        if ((rc = sync_ta_instance(ta, entry->oid)) != 0)
+        if ((rc = sync_ta_instance(ta, entry->oid, NULL)) != 0)
             break;
     }
 
@@ -547,11 +711,13 @@ sync_ta_subtree(const char *ta, const char *oid)
  * @param oid           identifier of the object instance or subtree
  * @param subtree       1 if the subtree of the specified node should
  *                      be synchronized
+ * @param depth         maximum number of levels of the subtree to
+ *                      synchronize, @c 0 for no limit
  *
  * @return status code (see te_errno.h)
  */
-int
-cfg_ta_sync(char *oid, te_bool subtree)
+static int
+ta_sync(char *oid, te_bool subtree, unsigned int depth)
 {
     cfg_oid  *tmp_oid;
     char     *ta;
@@ -581,7 +747,7 @@ cfg_ta_sync(char *oid, te_bool subtree)
             TE_SPRINTF(agent_oid, CFG_TA_PREFIX"%s%s", ta,
                        tmp_oid->len == 1 ? "" :
                        oid + strlen(CFG_TA_PREFIX"*"));
-            if ((rc = sync_ta_subtree(ta, agent_oid)) != 0)
+            if ((rc = sync_ta_subtree(ta, agent_oid, depth)) != 0)
                 break;
         }
     }
@@ -603,8 +769,8 @@ cfg_ta_sync(char *oid, te_bool subtree)
 
         if (found) /** This is the normal case */
         {
-            rc = subtree ? sync_ta_subtree(ta, oid) :
-                           sync_ta_instance(ta, oid);
+            rc = subtree ? sync_ta_subtree(ta, oid, depth) :
+                           sync_ta_instance(ta, oid, NULL);
         }
         else /** The specified agent is deleted by RCF */
         {
@@ -646,6 +812,20 @@ cfg_ta_sync(char *oid, te_bool subtree)
     return rc;
 }
 
+/* see description in conf_ta.h */
+int
+cfg_ta_sync(char *oid, te_bool subtree)
+{
+    return ta_sync(oid, subtree, 0);
+}
+
+/* see description in conf_ta.h */
+int
+cfg_ta_sync_depth(char *oid, unsigned int depth)
+{
+    return ta_sync(oid, TRUE, depth);
+}
+
 /* see description in conf_ta.h */
 void
 cfg_ta_sync_obj(cfg_object *obj, te_bool subtree)
@@ -910,7 +1090,7 @@ cfg_ta_commit(const char *ta, cfg_instance *inst)
 
     if (ret == 0 && need_sync)
     {
-        if ((rc = sync_ta_subtree(ta, inst->oid)) != 0)
+        if ((rc = sync_ta_subtree(ta, inst->oid, 0)) != 0)
         {
             ERROR("Failed(%r) to synchronize %s instance", rc, inst->oid);
             if (ret == 0)
@@ -68,6 +68,19 @@ extern void cfg_ta_reboot_all(void);
  */
 extern int cfg_ta_sync(char *oid, te_bool subtree);
 
+/**
+ * Synchronize object instances subtree with Test Agents up to
+ * the specified depth. Instances below the depth are neither added
+ * nor removed.
+ *
+ * @param oid           identifier of the subtree root
+ * @param depth         maximum number of levels below the root
+ *                      to synchronize, @c 0 for no limit
+ *
+ * @return status code (see te_errno.h)
+ */
+extern int cfg_ta_sync_depth(char *oid, unsigned int depth);
+
 /**
  * Synchronize all instances with given object with Test Agents
  *
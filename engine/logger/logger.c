@@ -28,6 +28,7 @@
 #endif
 
 #include "te_str.h"
+#include "te_perf.h"
 #include "te_raw_log.h"
 #include "te_log_fmt.h"
 #include "logger_int.h"
@@ -107,6 +108,15 @@ static unsigned int         lgr_flags = 0;
 static char *cfg_file = NULL;
 static struct ipc_server   *logger_ten_srv = NULL;
 
+/** @name Logger performance counters */
+static te_perf_counter *perf_messages = NULL;   /**< Registered messages */
+static te_perf_counter *perf_bytes = NULL;      /**< Registered bytes */
+static te_perf_counter *perf_lost = NULL;       /**< Lost TA messages */
+static te_perf_hist    *perf_write = NULL;      /**< Duration of writing
+                                                     to the raw log,
+                                                     microseconds */
+/*@}*/
+
 /* Path to the metadata file for live results */
 extern char *metafile_path;
 
@@ -207,10 +217,14 @@ lgr_register_message(const void *buf, size_t len)
 {
     struct stat            raw_file_stat;
     te_errno               rc;
+    uint64_t               start;
 
     if (((lgr_flags & LOGGER_CHECK) && !lgr_message_valid(buf, len)))
         return;
 
+    te_perf_counter_add(perf_messages, 1);
+    te_perf_counter_add(perf_bytes, len);
+
     if (listeners_enabled)
     {
         rc = msg_queue_post(&listener_queue, buf, len);
@@ -246,12 +260,14 @@ lgr_register_message(const void *buf, size_t len)
         }
     }
 
+    start = te_perf_now_us();
     pthread_mutex_lock(&raw_file_mutex);
     if (fwrite(buf, len, 1, raw_file) != 1)
         perror("fwrite() failure");
     if (fflush(raw_file) != 0)
         perror("fflush(raw_file) failed");
     pthread_mutex_unlock(&raw_file_mutex);
+    te_perf_hist_add(perf_write, te_perf_now_us() - start);
 }
 
 static pthread_mutex_t add_remove_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -763,7 +779,10 @@ ta_handler(void *ta)
             sequence = ntohl(sequence);
             lost = sequence - inst->sequence - 1;
             if (lost > 0)
+            {
                 WARN("TA %s: Lost %d messages", inst->agent, lost);
+                te_perf_counter_add(perf_lost, lost);
+            }
             inst->sequence = sequence;
 
             /* Read control fields value */
@@ -1160,6 +1179,12 @@ main(int argc, const char *argv[])
     ta_inst    *ta_el;
 
     te_log_init("Logger", lgr_log_message);
+
+    perf_messages = te_perf_counter_get("logger.messages");
+    perf_bytes = te_perf_counter_get("logger.bytes");
+    perf_lost = te_perf_counter_get("logger.lost");
+    perf_write = te_perf_hist_get("logger.write");
+
     rc = msg_queue_init(&listener_queue);
     if (rc != 0)
     {
@@ -1199,6 +1224,9 @@ main(int argc, const char *argv[])
     }
     /* Further we must goto 'exit' in the case of failure */
 
+    /* Failure to dump counters is not critical */
+    (void)te_perf_log_start();
+
     /* Initialize IPC before any servers creation */
     if (ipc_init() != 0)
     {
@@ -1457,6 +1485,7 @@ exit:
         result = EXIT_FAILURE;
     }
 
+    te_perf_log_stop();
     RING("Shutdown is completed");
 
     if (fflush(raw_file) != 0)
@@ -209,6 +209,9 @@ resolve_ta_methods(ta *agent, char *libname)
     char                      name[RCF_MAX_NAME];
     void                     *handle;
 
+    if (rcf_subagent_resolve_methods(agent, libname))
+        return 0;
+
     TE_SPRINTF(name, "lib%s.so", libname);
     if ((handle = dlopen(name, RTLD_LAZY)) == NULL)
     {
@@ -875,6 +878,8 @@ rcf_answer_user_request(usrreq *req)
     }
     if (!(req->message->flags & INTERMEDIATE_ANSWER))
     {
+        te_perf_counter_add(req->queued, -1);
+        te_trace_span_end(&req->span);
         free(req->message);
         if (req->prev != NULL)
             (req->prev)->next = req->next;
@@ -970,6 +975,18 @@ rcf_set_ta_dead(ta *agent)
                   agent->name, rc);
         agent->flags |= TA_DEAD;
         agent->conn_locked = FALSE;
+
+        if (!rcf_ta_is_subagent(agent))
+        {
+            ta *sub;
+
+            /* Sub-agents are served via the connection of the TA */
+            for (sub = agents; sub != NULL; sub = sub->next)
+            {
+                if (rcf_ta_is_subagent_of(sub, agent))
+                    rcf_set_ta_dead(sub);
+            }
+        }
     }
 }
 
@@ -1056,6 +1073,16 @@ rcf_init_agent(ta *agent)
     agent->flags &= ~(TA_DEAD | TA_REBOOTING);
     INFO("Connected with TA '%s'", agent->name);
 
+    if (rcf_ta_is_subagent(agent))
+    {
+        /*
+         * Sub-agent is a fork of its parent, so it is consistent and
+         * uses the same clock. Exchanges with it are not synchronous.
+         */
+        agent->conn_locked = FALSE;
+        return 0;
+    }
+
     if ((rc = rcf_consistency_check(agent)) != 0)
     {
         rcf_set_ta_unrecoverable(agent);
@@ -1288,10 +1315,10 @@ read_str(char **ptr, char *s)
 static void
 process_reply(ta *agent)
 {
-    int     rc;
-    int     sid;
-    int     error;
-    size_t  len = sizeof(cmd);
+    te_errno rc;
+    int      sid;
+    int      error;
+    size_t   len = sizeof(cmd);
 
     rcf_msg *msg;
     usrreq  *req = NULL;
@@ -1332,6 +1359,13 @@ process_reply(ta *agent)
         return;
     }
 
+    if (cmd[0] == TE_PROTO_SUBAGENT)
+    {
+        agent = rcf_subagent_demux(agent, cmd, sizeof(cmd), &len, &ba, &rc);
+        if (agent == NULL)
+            return;
+    }
+
     VERB("Answer \"%s\" is received from TA '%s'", cmd, agent->name);
 
     if (strncmp(ptr, "SID ", strlen("SID ")) != 0)
@@ -1354,6 +1388,13 @@ process_reply(ta *agent)
         goto push;
     }
 
+    if (req->sent_us != 0)
+    {
+        te_perf_hist_add(agent->perf_latency,
+                         te_perf_now_us() - req->sent_us);
+        req->sent_us = 0;
+    }
+
     msg = req->message;
     msg->flags = 0;
     msg->data_len = 0;
@@ -1361,7 +1402,10 @@ process_reply(ta *agent)
     if ((msg->opcode == RCFOP_TRRECV_STOP ||
          msg->opcode == RCFOP_TRRECV_GET ||
          msg->opcode == RCFOP_TRRECV_WAIT ||
-         msg->opcode == RCFOP_TRSEND_RECV) &&
+         msg->opcode == RCFOP_TRSEND_RECV ||
+         /* Chunks of getall answer have no status code */
+         (msg->opcode == RCFOP_CONFGET &&
+          strcmp_start("attach ", ptr) == 0)) &&
          ba != NULL)
     {
         /* Set intermediate flag to keep request in the queue */
@@ -1375,6 +1419,8 @@ process_reply(ta *agent)
         msg->file[0] = '\0';
         save_attachment(agent, msg, len, ba);
         rcf_answer_user_request(req);
+        /* The next attachment must not overwrite the file */
+        msg->file[0] = '\0';
         return;
     }
 
@@ -1438,6 +1484,7 @@ process_reply(ta *agent)
 
             case RCFOP_VREAD:
             case RCFOP_CSAP_PARAM:
+            case RCFOP_EVENT_WAIT:
                 read_str(&ptr, msg->value);
                 break;
 
@@ -1736,6 +1783,7 @@ transmit_cmd(ta *agent, usrreq *req)
 
     VERB("The command is transmitted to %s", agent->name);
     req->sent = time(NULL);
+    req->sent_us = te_perf_now_us();
     agent->conn_locked = TRUE;
     agent->lock_sid = req->message->sid;
 
@@ -1895,6 +1943,11 @@ rcf_send_cmd(ta *agent, usrreq *req)
     } while (0)
 
     PUT("SID %d ", msg->sid);
+    if (te_trace_span_active(&req->span))
+    {
+        PUT(TE_PROTO_TRACE " " TE_TRACE_CTX_FMT " ",
+            TE_TRACE_CTX_ARGS(&req->span.ctx));
+    }
     switch (msg->opcode)
     {
         case RCFOP_REBOOT:
@@ -1906,6 +1959,9 @@ rcf_send_cmd(ta *agent, usrreq *req)
 
         case RCFOP_CONFGET:
             PUT(TE_PROTO_CONFGET " %s", msg->id);
+            /* Options of getall request */
+            if (msg->value[0] != '\0')
+                write_str(msg->value, RCF_MAX_VAL);
             req->timeout = RCF_CMD_TIMEOUT;
             break;
 
@@ -2061,6 +2117,11 @@ rcf_send_cmd(ta *agent, usrreq *req)
             req->timeout = RCF_CMD_TIMEOUT;
             break;
 
+        case RCFOP_EVENT_WAIT:
+            PUT(TE_PROTO_EVENT_WAIT " %u", msg->timeout);
+            req->timeout = TE_MS2SEC(msg->timeout) + RCF_CMD_TIMEOUT;
+            break;
+
         case RCFOP_EXECUTE:
             PUT(TE_PROTO_EXECUTE " ");
             switch (msg->intparm)
@@ -2606,6 +2667,24 @@ process_user_request(usrreq *req)
                     break; /** Leave 'do/while' block */
                 }
 
+                {
+                    ta *sub;
+
+                    for (sub = agents; sub != NULL; sub = sub->next)
+                    {
+                        if (rcf_ta_is_subagent_of(sub, *a))
+                            break;
+                    }
+
+                    if (sub != NULL)
+                    {
+                        ERROR("TA '%s' cannot be removed since it has "
+                              "sub-agent '%s'", msg->ta, sub->name);
+                        msg->error = TE_RC(TE_RCF, TE_EBUSY);
+                        break; /** Leave 'do/while' block */
+                    }
+                }
+
                 /* Shutdown TA */
                 RING("Shutting down '%s' TA", (*a)->name);
 
@@ -2615,7 +2694,15 @@ process_user_request(usrreq *req)
                     ta *agt = *a;
                     ta *next = agt->next; /**< Save 'next' item */
 
-                    if (!(agt->flags & TA_DEAD)) /** If TA is NOT DEAD */
+                    if (rcf_ta_is_subagent(agt))
+                    {
+                        /* Sub-agent is stopped by its parent TA */
+                        rcf_answer_all_requests(&(agt->sent), TE_EIO);
+                        rcf_answer_all_requests(&(agt->pending), TE_EIO);
+                        rcf_answer_all_requests(&(agt->waiting), TE_EIO);
+                        agt->flags |= TA_DOWN;
+                    }
+                    else if (!(agt->flags & TA_DEAD)) /** If TA is NOT DEAD */
                     {
                         TE_SPRINTF(cmd, "SID %d %s",
                                    ++agt->sid, TE_PROTO_SHUTDOWN);
@@ -2765,6 +2852,13 @@ process_user_request(usrreq *req)
             return;
 
         case RCFOP_REBOOT:
+            if (rcf_ta_is_subagent(agent))
+            {
+                ERROR("Sub-agent '%s' cannot be rebooted", agent->name);
+                msg->error = TE_RC(TE_RCF, TE_EOPNOTSUPP);
+                rcf_answer_user_request(req);
+                return;
+            }
             process_reboot_request(agent, req);
             /*
              * If the reboot request does not pass the primitive checks
@@ -2781,6 +2875,18 @@ process_user_request(usrreq *req)
     }
 
     /* Usual commands */
+    if (agent->perf_queued == NULL)
+    {
+        agent->perf_queued = te_perf_counter_get("rcf.%s.queued",
+                                                 agent->name);
+        agent->perf_latency = te_perf_hist_get("rcf.%s.latency",
+                                               agent->name);
+    }
+    req->queued = agent->perf_queued;
+    te_perf_counter_add(req->queued, 1);
+    te_trace_span_start(&req->span, &msg->trace, "rcf.%s",
+                        rcf_op_to_string(msg->opcode));
+
     if (shutdown_num > 0 ||
         agent->reboot_timestamp > 0 ||
         (agent->flags & TA_CHECKING) ||
@@ -2818,11 +2924,20 @@ rcf_shutdown(void)
         if (agent->flags & TA_DEAD)
             continue;
 
-        TE_SPRINTF(cmd, "SID %d %s", ++agent->sid, TE_PROTO_SHUTDOWN);
-        (agent->m.transmit)(agent->handle, cmd, strlen(cmd) + 1);
         rcf_answer_all_requests(&(agent->sent), TE_EIO);
         rcf_answer_all_requests(&(agent->pending), TE_EIO);
         rcf_answer_all_requests(&(agent->waiting), TE_EIO);
+
+        if (rcf_ta_is_subagent(agent))
+        {
+            /* Sub-agents are stopped by their parents */
+            agent->flags |= TA_DOWN;
+            shutdown_num--;
+            continue;
+        }
+
+        TE_SPRINTF(cmd, "SID %d %s", ++agent->sid, TE_PROTO_SHUTDOWN);
+        (agent->m.transmit)(agent->handle, cmd, strlen(cmd) + 1);
     }
 
     while (shutdown_num > 0 && time(NULL) - t < RCF_SHUTDOWN_TIMEOUT)
@@ -2982,6 +3097,9 @@ main(int argc, const char *argv[])
     /* Ignore SIGPIPE, by default SIGPIPE kills the process */
     signal(SIGPIPE, SIG_IGN);
 
+    /* Failure to dump counters is not critical */
+    (void)te_perf_log_start();
+
     ipc_init();
     if (ipc_register_server(RCF_SERVER, RCF_IPC, &server) != 0)
         goto exit;
@@ -3186,6 +3304,7 @@ main(int argc, const char *argv[])
 
 exit:
     rcf_shutdown();
+    te_perf_log_stop();
 
     if (req != NULL && req->message->opcode == RCFOP_SHUTDOWN)
         rcf_answer_user_request(req);
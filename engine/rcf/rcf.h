@@ -24,6 +24,8 @@
 #include "rcf_methods.h"
 #include "rcf_api.h"
 #include "rcf_internal.h"
+#include "te_perf.h"
+#include "te_trace.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -92,6 +94,13 @@ struct usrreq {
     struct ipc_server_client *user;
     uint32_t                  timeout;  /**< Timeout in seconds */
     time_t                    sent;
+    uint64_t                  sent_us;  /**< Time of sending to the TA,
+                                             microseconds */
+    te_perf_counter          *queued;   /**< Counter of queued requests
+                                             this request is accounted in
+                                             or @c NULL */
+    te_trace_span             span;     /**< Trace span of the request
+                                             processing */
     userreq_callback          cb;
 };
 
@@ -242,6 +251,12 @@ struct ta {
     struct rcf_talib_methods m; /**< TA-specific Methods */
 
     ta_reboot_context reboot_ctx; /**< Reboot context */
+
+    te_perf_counter    *perf_queued;        /**< Number of user requests
+                                                 queued for the TA */
+    te_perf_hist       *perf_latency;       /**< Latency of commands
+                                                 processing by the TA,
+                                                 microseconds */
 };
 
 /**
@@ -378,6 +393,57 @@ extern void rcf_ta_reboot_init_ctx(ta *agent);
  */
 extern void rcf_ta_reboot_get_next_reboot_type(ta *agent);
 
+/** Name of the RCF library to be specified for sub-agents */
+#define RCF_SUBAGENT_LIB    "rcfsub"
+
+/**
+ * Use built-in sub-agent methods for the TA if @p libname
+ * is @c RCF_SUBAGENT_LIB.
+ *
+ * @param agent     Test Agent structure
+ * @param libname   Name of the RCF library of the TA
+ *
+ * @return @c TRUE if the methods are resolved.
+ */
+extern te_bool rcf_subagent_resolve_methods(ta *agent, const char *libname);
+
+/**
+ * Check whether the TA is a sub-agent served via the connection
+ * of another (parent) TA.
+ *
+ * @param agent Test Agent structure
+ *
+ * @return @c TRUE if the TA is a sub-agent.
+ */
+extern te_bool rcf_ta_is_subagent(const ta *agent);
+
+/**
+ * Check whether the TA is a sub-agent of the specified parent.
+ *
+ * @param agent     Test Agent structure
+ * @param parent    Parent Test Agent structure
+ *
+ * @return @c TRUE if @p agent is a sub-agent of @p parent.
+ */
+extern te_bool rcf_ta_is_subagent_of(const ta *agent, const ta *parent);
+
+/**
+ * Dispatch an answer received from the parent TA connection to
+ * the sub-agent it is sent by. The sub-agent prefix is removed
+ * from the answer.
+ *
+ * @param parent        Parent Test Agent structure
+ * @param buf           Buffer with the answer
+ * @param bufsize       Size of the buffer
+ * @param len           Length of the answer (IN/OUT)
+ * @param ba            Location of the attachment pointer (IN/OUT)
+ * @param rc            Status of the receive (IN/OUT)
+ *
+ * @return Sub-agent or @c NULL if the answer is dropped.
+ */
+extern ta *rcf_subagent_demux(ta *parent, char *buf, size_t bufsize,
+                              size_t *len, char **ba, te_errno *rc);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
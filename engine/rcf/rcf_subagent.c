@@ -0,0 +1,317 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF sub-agents support
+ *
+ * Sub-agent is a process forked by a Test Agent (for example, to serve
+ * a network namespace) which is controlled via the connection of
+ * the parent Test Agent. Commands to the sub-agent and answers from it
+ * are prefixed with @c TE_PROTO_SUBAGENT followed by the sub-agent name.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+#include "te_config.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rcf.h"
+#include "te_alloc.h"
+#include "te_str.h"
+#include "te_proto.h"
+
+#include "logger_api.h"
+#include "logger_ten.h"
+
+/** Sub-agent handle */
+typedef struct rcf_subagent {
+    ta     *parent;         /**< Parent Test Agent */
+    char   *tag;            /**< Prefix of commands and answers */
+    size_t  tag_len;        /**< Length of the prefix */
+    size_t  attach_left;    /**< Number of bytes of the attachment
+                                 which are still to be transmitted */
+} rcf_subagent;
+
+static te_errno
+rcfsub_start(const char *ta_name, const char *ta_type,
+             const rcf_talib_param *param, const te_kvpair_h *conf,
+             rcf_talib_handle *handle, unsigned int *flags)
+{
+    const char   *parent_name;
+    ta           *parent;
+    rcf_subagent *sub;
+
+    UNUSED(ta_type);
+    UNUSED(param);
+    UNUSED(flags);
+
+    parent_name = te_kvpairs_get(conf, "parent");
+    if (parent_name == NULL)
+    {
+        ERROR("Parent of the sub-agent '%s' is not specified", ta_name);
+        return TE_RC(TE_RCF, TE_EINVAL);
+    }
+
+    parent = rcf_find_ta_by_name((char *)parent_name);
+    if (parent == NULL || rcf_ta_is_subagent(parent))
+    {
+        ERROR("Invalid parent '%s' of the sub-agent '%s'",
+              parent_name, ta_name);
+        return TE_RC(TE_RCF, TE_EINVAL);
+    }
+
+    if (parent->flags & TA_DEAD)
+    {
+        ERROR("Parent '%s' of the sub-agent '%s' is dead",
+              parent_name, ta_name);
+        return TE_RC(TE_RCF, TE_ETADEAD);
+    }
+
+    sub = TE_ALLOC(sizeof(*sub));
+    sub->parent = parent;
+    sub->tag = te_string_fmt("%c%s ", TE_PROTO_SUBAGENT, ta_name);
+    sub->tag_len = strlen(sub->tag);
+
+    *handle = sub;
+
+    return 0;
+}
+
+static te_errno
+rcfsub_close(rcf_talib_handle handle, fd_set *select_set)
+{
+    UNUSED(handle);
+    UNUSED(select_set);
+
+    return 0;
+}
+
+static te_errno
+rcfsub_finish(rcf_talib_handle handle, const char *parms)
+{
+    rcf_subagent *sub = handle;
+
+    UNUSED(parms);
+
+    if (sub != NULL)
+    {
+        free(sub->tag);
+        free(sub);
+    }
+
+    return 0;
+}
+
+static te_errno
+rcfsub_connect(rcf_talib_handle handle, fd_set *select_set,
+               struct timeval *select_tm)
+{
+    UNUSED(handle);
+    UNUSED(select_set);
+    UNUSED(select_tm);
+
+    return 0;
+}
+
+/**
+ * Get length of the attachment announced in the command. As for
+ * any Test Agent, it is announced by "attach <number>" at the end of
+ * the command, so arguments of the command containing the same words
+ * are not taken into account.
+ *
+ * @param data      Command
+ * @param len       Length of the command including the trailing @c NUL
+ *
+ * @return Length of the attachment or @c 0.
+ */
+static size_t
+rcfsub_attach_len(const char *data, size_t len)
+{
+    static const char attach[] = "attach";
+
+    const char *p;
+    const char *number;
+
+    if (len == 0 || data[len - 1] != '\0')
+        return 0;
+
+    p = data + strlen(data);
+    while (p > data && isspace(p[-1]))
+        p--;
+    while (p > data && isdigit(p[-1]))
+        p--;
+    number = p;
+    if (!isdigit(*number) || p == data || !isspace(p[-1]))
+        return 0;
+
+    while (p > data && isspace(p[-1]))
+        p--;
+    if ((size_t)(p - data) < strlen(attach))
+        return 0;
+    p -= strlen(attach);
+    if (strncmp(p, attach, strlen(attach)) != 0 ||
+        (p > data && !isspace(p[-1])))
+        return 0;
+
+    return strtoul(number, NULL, 10);
+}
+
+static te_errno
+rcfsub_transmit(rcf_talib_handle handle, const void *data, size_t len)
+{
+    rcf_subagent *sub = handle;
+    ta           *parent = sub->parent;
+    te_errno      rc;
+
+    if (sub->attach_left > 0)
+    {
+        sub->attach_left -= MIN(len, sub->attach_left);
+        return (parent->m.transmit)(parent->handle, data, len);
+    }
+
+    rc = (parent->m.transmit)(parent->handle, sub->tag, sub->tag_len);
+    if (rc == 0)
+        rc = (parent->m.transmit)(parent->handle, data, len);
+    if (rc == 0)
+        sub->attach_left = rcfsub_attach_len(data, len);
+
+    return rc;
+}
+
+static te_bool
+rcfsub_is_ready(rcf_talib_handle handle)
+{
+    UNUSED(handle);
+
+    /* Answers are received from the parent connection */
+    return FALSE;
+}
+
+static te_errno
+rcfsub_receive(rcf_talib_handle handle, char *buf, size_t *len,
+               char **pba)
+{
+    rcf_subagent *sub = handle;
+
+    return (sub->parent->m.receive)(sub->parent->handle, buf, len, pba);
+}
+
+/** Methods of sub-agents */
+static const struct rcf_talib_methods rcf_subagent_methods = {
+    .start = rcfsub_start,
+    .close = rcfsub_close,
+    .finish = rcfsub_finish,
+    .connect = rcfsub_connect,
+    .transmit = rcfsub_transmit,
+    .is_ready = rcfsub_is_ready,
+    .receive = rcfsub_receive,
+};
+
+/* See description in rcf.h */
+te_bool
+rcf_subagent_resolve_methods(ta *agent, const char *libname)
+{
+    if (strcmp(libname, RCF_SUBAGENT_LIB) != 0)
+        return FALSE;
+
+    memcpy(&agent->m, &rcf_subagent_methods, sizeof(agent->m));
+
+    return TRUE;
+}
+
+/* See description in rcf.h */
+te_bool
+rcf_ta_is_subagent(const ta *agent)
+{
+    return agent->m.start == rcfsub_start;
+}
+
+/* See description in rcf.h */
+te_bool
+rcf_ta_is_subagent_of(const ta *agent, const ta *parent)
+{
+    const char *parent_name;
+
+    if (!rcf_ta_is_subagent(agent))
+        return FALSE;
+
+    parent_name = te_kvpairs_get(&agent->conf, "parent");
+
+    return parent_name != NULL && strcmp(parent_name, parent->name) == 0;
+}
+
+/**
+ * Read and drop the rest of an answer.
+ *
+ * @param parent    Test Agent which connection is used
+ * @param buf       Buffer
+ * @param bufsize   Size of the buffer
+ * @param rc        Status of the previous receive
+ */
+static void
+rcfsub_drop_answer(ta *parent, char *buf, size_t bufsize, te_errno rc)
+{
+    while (TE_RC_GET_ERROR(rc) == TE_EPENDING)
+    {
+        size_t len = bufsize;
+
+        rc = (parent->m.receive)(parent->handle, buf, &len, NULL);
+    }
+}
+
+/* See description in rcf.h */
+ta *
+rcf_subagent_demux(ta *parent, char *buf, size_t bufsize,
+                   size_t *len, char **ba, te_errno *rc)
+{
+    char          name[RCF_MAX_NAME];
+    const char   *end;
+    ta           *agent;
+    size_t        tag_len;
+    size_t        rest;
+
+    end = strchr(buf, ' ');
+    if (end == NULL || (size_t)(end - buf) > sizeof(name))
+    {
+        ERROR("Malformed answer from a sub-agent of TA '%s'",
+              parent->name);
+        rcfsub_drop_answer(parent, buf, bufsize, *rc);
+        return NULL;
+    }
+
+    tag_len = end - buf + 1;
+    memcpy(name, buf + 1, tag_len - 2);
+    name[tag_len - 2] = '\0';
+
+    agent = rcf_find_ta_by_name(name);
+    if (agent == NULL || !rcf_ta_is_subagent_of(agent, parent) ||
+        (agent->flags & TA_DEAD))
+    {
+        WARN("Drop answer from unknown or dead sub-agent '%s' of TA '%s'",
+             name, parent->name);
+        rcfsub_drop_answer(parent, buf, bufsize, *rc);
+        return NULL;
+    }
+
+    memmove(buf, buf + tag_len, MIN(*len, bufsize) - tag_len);
+    *len -= tag_len;
+    if (*ba != NULL)
+        *ba -= tag_len;
+
+    if (TE_RC_GET_ERROR(*rc) == TE_EPENDING)
+    {
+        /* Fill in the space freed by the prefix */
+        rest = tag_len;
+        *rc = (parent->m.receive)(parent->handle, buf + bufsize - tag_len,
+                                  &rest, NULL);
+        if (*rc != 0 && TE_RC_GET_ERROR(*rc) != TE_EPENDING)
+        {
+            ERROR("Receiving answer from TA '%s' failed error=%r",
+                  parent->name, *rc);
+            rcf_set_ta_dead(parent);
+            return NULL;
+        }
+    }
+
+    return agent;
+}
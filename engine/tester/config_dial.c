@@ -13,6 +13,9 @@
 #include "config.h"
 #endif
 
+#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
 #include <search.h>
 
 #include "te_alloc.h"
@@ -24,6 +27,7 @@
 #include "tester_conf.h"
 #include "tester_run.h"
 #include "test_path.h"
+#include "dial_history.h"
 
 /** Chosen iterations in a given scenario act */
 typedef struct act_chosen {
@@ -1148,11 +1152,622 @@ choose_iters(dial_node *root, uint64_t select_num)
     return 0;
 }
 
-/* See description in tester_run.h */
-te_errno
-scenario_apply_dial(testing_scenario *scenario,
-                    const struct tester_cfgs *cfgs,
-                    double dial)
+/* Default duration of an iteration of a test without history, seconds */
+#define DIAL_DEF_DURATION 10.0
+/* Minimum duration of an iteration taken into account, seconds */
+#define DIAL_MIN_DURATION 0.001
+/*
+ * How many times an iteration of a test which always gives unexpected
+ * results is more valuable than an iteration of a test which always
+ * gives expected ones.
+ */
+#define DIAL_UNEXP_FACTOR 10.0
+
+/** Argument of a test script considered for coverage */
+typedef struct dial_cov_arg {
+    /** Name of the list the argument belongs to or @c NULL */
+    const char *list;
+    /**
+     * Index of the previous argument from the same list or
+     * @c -1 (the value index is taken from that argument then).
+     */
+    int list_arg;
+    /** Number of the argument values */
+    unsigned int n_values;
+    /** Offset of coverage items of single values of the argument */
+    unsigned int item_off;
+} dial_cov_arg;
+
+/**
+ * Coverage of argument values of a test script. The script itself,
+ * single values and pairs of values of different arguments are
+ * coverage items.
+ */
+typedef struct dial_cov {
+    /** Script run item */
+    const run_item *ri;
+    /** Arguments */
+    dial_cov_arg *args;
+    /** Number of arguments */
+    unsigned int n_args;
+    /**
+     * Offsets of coverage items of value pairs, element
+     * [i * n_args + j] for i < j corresponds to arguments i and j.
+     * It is @c UINT_MAX for arguments from the same list: their values
+     * are not combined.
+     */
+    unsigned int *pair_off;
+    /** Number of coverage items */
+    unsigned int n_items;
+    /** Number of covered items */
+    unsigned int n_covered;
+    /** Covered items */
+    uint8_t *covered;
+    /** Number of chosen iterations */
+    unsigned int n_chosen;
+    /** Value of the first chosen iteration */
+    double value;
+    /** Expected duration of an iteration, in seconds */
+    double duration;
+} dial_cov;
+
+/** Iteration which can be chosen when selecting within a budget */
+typedef struct dial_cand {
+    /** Scenario act */
+    act_chosen *act;
+    /** Iteration */
+    unsigned int iter;
+    /** Index of the iteration in the script run item */
+    unsigned int i_iter;
+    /** Coverage of the script */
+    dial_cov *cov;
+    /** Upper bound of the gain per second of choosing the iteration */
+    double key;
+} dial_cand;
+
+/** Context of selection within a budget */
+typedef struct dial_budget_ctx {
+    /** Data about previous runs of tests (may be @c NULL) */
+    const dial_history *history;
+    /** Duration of a test without history */
+    double def_duration;
+    /** Tree of dial_cov structures */
+    void *covs;
+    /** Array of the same dial_cov structures */
+    dial_cov **cov_list;
+    /** Number of dial_cov structures */
+    size_t n_covs;
+    /** Maximum number of arguments of a script */
+    unsigned int max_args;
+
+    /** Candidate iterations */
+    dial_cand *cands;
+    /** Number of candidate iterations */
+    size_t n_cands;
+    /** Number of elements allocated for candidates */
+    size_t max_cands;
+    /** Heap of candidates ordered by key (maximum at the top) */
+    dial_cand **heap;
+    /** Number of candidates in the heap */
+    size_t heap_len;
+
+    /** Remaining budget, in seconds */
+    double budget;
+    /** Number of chosen iterations */
+    uint64_t n_chosen;
+} dial_budget_ctx;
+
+/* Compare two dial_cov structures by run items */
+static int
+compare_dial_cov(const void *a, const void *b)
+{
+    const run_item *ri_a = ((dial_cov *)a)->ri;
+    const run_item *ri_b = ((dial_cov *)b)->ri;
+
+    if (ri_a == ri_b)
+        return 0;
+
+    return ri_a < ri_b ? -1 : 1;
+}
+
+/* Release memory allocated for dial_cov structure */
+static void
+free_dial_cov(void *arg)
+{
+    dial_cov *cov = arg;
+
+    free(cov->args);
+    free(cov->pair_off);
+    free(cov->covered);
+    free(cov);
+}
+
+/* Callback to fill arguments of dial_cov structure */
+static te_errno
+dial_cov_arg_cb(const test_var_arg *va, void *opaque)
+{
+    dial_cov *cov = opaque;
+    dial_cov_arg *arg;
+    const test_var_arg_list *list;
+    unsigned int i;
+
+    TE_REALLOC(cov->args, (cov->n_args + 1) * sizeof(*cov->args));
+    arg = &cov->args[cov->n_args];
+
+    arg->list = va->list;
+    arg->list_arg = -1;
+    if (va->list != NULL)
+    {
+        for (i = 0; i < cov->n_args; i++)
+        {
+            if (cov->args[i].list != NULL &&
+                strcmp(cov->args[i].list, va->list) == 0)
+            {
+                arg->list_arg = i;
+                break;
+            }
+        }
+
+        SLIST_FOREACH(list, &cov->ri->lists, links)
+        {
+            if (strcmp(list->name, va->list) == 0)
+                break;
+        }
+        assert(list != NULL);
+        arg->n_values = list->len;
+    }
+    else
+    {
+        arg->n_values = test_var_arg_values(va)->num;
+    }
+
+    cov->n_args++;
+
+    return 0;
+}
+
+/*
+ * Get indexes of argument values of a given iteration of a script
+ * the same way as it is done when the iteration is run.
+ */
+static void
+dial_cov_iter_values(const dial_cov *cov, unsigned int i_iter,
+                     unsigned int *values)
+{
+    unsigned int n_iters = cov->ri->n_iters;
+    unsigned int i;
+
+    for (i = 0; i < cov->n_args; i++)
+    {
+        if (cov->args[i].list_arg >= 0)
+        {
+            values[i] = values[cov->args[i].list_arg];
+            continue;
+        }
+
+        assert(cov->args[i].n_values != 0);
+        assert(n_iters % cov->args[i].n_values == 0);
+        n_iters /= cov->args[i].n_values;
+
+        values[i] = i_iter / n_iters;
+        i_iter %= n_iters;
+    }
+}
+
+/*
+ * Process coverage items of a given iteration: count the uncovered
+ * ones and optionally mark them as covered.
+ */
+static unsigned int
+dial_cov_iter_items(dial_cov *cov, unsigned int i_iter,
+                    unsigned int *values, te_bool mark)
+{
+    unsigned int n_new = 0;
+    unsigned int item;
+    unsigned int i;
+    unsigned int j;
+
+    /* The first item is the script itself */
+    if (!cov->covered[0])
+    {
+        n_new++;
+        if (mark)
+            cov->covered[0] = 1;
+    }
+
+    dial_cov_iter_values(cov, i_iter, values);
+
+    for (i = 0; i < cov->n_args; i++)
+    {
+        for (j = i; j < cov->n_args; j++)
+        {
+            if (i == j)
+            {
+                item = cov->args[i].item_off + values[i];
+            }
+            else if (cov->pair_off[i * cov->n_args + j] == UINT_MAX)
+            {
+                continue;
+            }
+            else
+            {
+                item = cov->pair_off[i * cov->n_args + j] +
+                       values[i] * cov->args[j].n_values + values[j];
+            }
+
+            assert(item < cov->n_items);
+            if (!cov->covered[item])
+            {
+                n_new++;
+                if (mark)
+                    cov->covered[item] = 1;
+            }
+        }
+    }
+
+    if (mark)
+        cov->n_covered += n_new;
+
+    return n_new;
+}
+
+/* Get (create if necessary) coverage data for a script */
+static dial_cov *
+dial_cov_get(dial_budget_ctx *ctx, const dial_node *script, double coef)
+{
+    dial_cov key;
+    dial_cov *cov;
+    const dial_history_entry *hist = NULL;
+    void *result;
+    unsigned int i;
+    unsigned int j;
+    te_errno rc;
+
+    key.ri = script->ri;
+    result = tfind(&key, &ctx->covs, compare_dial_cov);
+    if (result != NULL)
+        return *(dial_cov **)result;
+
+    cov = TE_ALLOC(sizeof(*cov));
+    cov->ri = script->ri;
+
+    rc = test_run_item_enum_args(cov->ri, dial_cov_arg_cb, TRUE, cov);
+    if (rc != 0 && TE_RC_GET_ERROR(rc) != TE_ENOENT)
+    {
+        WARN("Failed to get arguments of '%s', their values coverage "
+             "is not considered: %r", run_item_name(cov->ri), rc);
+        cov->n_args = 0;
+    }
+
+    cov->n_items = 1;
+    for (i = 0; i < cov->n_args; i++)
+    {
+        cov->args[i].item_off = cov->n_items;
+        cov->n_items += cov->args[i].n_values;
+    }
+    if (cov->n_args > 1)
+    {
+        cov->pair_off = TE_ALLOC(cov->n_args * cov->n_args *
+                                 sizeof(*cov->pair_off));
+        for (i = 0; i < cov->n_args; i++)
+        {
+            for (j = i + 1; j < cov->n_args; j++)
+            {
+                if (cov->args[i].list != NULL &&
+                    cov->args[j].list != NULL &&
+                    strcmp(cov->args[i].list, cov->args[j].list) == 0)
+                {
+                    cov->pair_off[i * cov->n_args + j] = UINT_MAX;
+                    continue;
+                }
+
+                cov->pair_off[i * cov->n_args + j] = cov->n_items;
+                cov->n_items += cov->args[i].n_values *
+                                cov->args[j].n_values;
+            }
+        }
+    }
+    cov->covered = TE_ALLOC(cov->n_items);
+
+    if (cov->n_args > ctx->max_args)
+        ctx->max_args = cov->n_args;
+
+    if (script->path != NULL && ctx->history != NULL)
+    {
+        hist = dial_history_find(ctx->history, script->path);
+        if (hist != NULL && !hist->known)
+            hist = NULL;
+    }
+
+    /*
+     * Tests which were not run before are considered as always
+     * giving unexpected results: there is nothing known about them.
+     */
+    cov->duration = (hist != NULL) ? hist->duration : ctx->def_duration;
+    if (cov->duration < DIAL_MIN_DURATION)
+        cov->duration = DIAL_MIN_DURATION;
+    cov->value = coef * (1 + DIAL_UNEXP_FACTOR *
+                             (hist != NULL ? hist->unexp_rate : 1));
+
+    result = tsearch(cov, &ctx->covs, compare_dial_cov);
+    if (result == NULL)
+        TE_FATAL_ERROR("Failed to add coverage data to the tree");
+
+    TE_REALLOC(ctx->cov_list, (ctx->n_covs + 1) * sizeof(*ctx->cov_list));
+    ctx->cov_list[ctx->n_covs++] = cov;
+
+    return cov;
+}
+
+/*
+ * Collect iterations from the selection tree leafs (added from
+ * the original scenario) as candidates for choosing.
+ */
+static void
+dial_budget_collect(dial_budget_ctx *ctx, dial_node *node,
+                    const dial_node *script, double coef)
+{
+    dial_node *child;
+
+    if (node->ri != NULL)
+    {
+        if (node->ri->dial_coef > 0)
+            coef *= node->ri->dial_coef;
+        if (node->ri->type == RUN_ITEM_SCRIPT)
+            script = node;
+    }
+
+    if (node->act_ptr != NULL)
+    {
+        dial_cov *cov;
+        unsigned int i;
+
+        assert(script != NULL);
+        cov = dial_cov_get(ctx, script, coef);
+
+        for (i = node->first; i <= node->last; i++)
+        {
+            dial_cand *cand;
+
+            assert(ctx->n_cands < ctx->max_cands);
+            cand = &ctx->cands[ctx->n_cands++];
+            cand->act = node->act_ptr;
+            cand->iter = i;
+            cand->i_iter = i - script->first;
+            cand->cov = cov;
+            cand->key = 0;
+
+            if (i == UINT_MAX)
+                break;
+        }
+        return;
+    }
+
+    TAILQ_FOREACH(child, &node->children, links)
+    {
+        dial_budget_collect(ctx, child, script, coef);
+    }
+}
+
+/* Restore heap order moving an element down */
+static void
+dial_heap_down(dial_budget_ctx *ctx, size_t i)
+{
+    dial_cand **heap = ctx->heap;
+
+    while (TRUE)
+    {
+        size_t max = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        dial_cand *tmp;
+
+        if (left < ctx->heap_len && heap[left]->key > heap[max]->key)
+            max = left;
+        if (right < ctx->heap_len && heap[right]->key > heap[max]->key)
+            max = right;
+        if (max == i)
+            break;
+
+        tmp = heap[i];
+        heap[i] = heap[max];
+        heap[max] = tmp;
+        i = max;
+    }
+}
+
+/* Remove the top element from the heap */
+static void
+dial_heap_pop(dial_budget_ctx *ctx)
+{
+    ctx->heap[0] = ctx->heap[--ctx->heap_len];
+    dial_heap_down(ctx, 0);
+}
+
+/*
+ * Compute gain per second of choosing a candidate. When @p coverage
+ * is @c TRUE, the gain is the number of newly covered items,
+ * otherwise it is the value of the iteration which decreases with
+ * every iteration chosen from the same script.
+ */
+static double
+dial_cand_gain(dial_cand *cand, te_bool coverage, unsigned int *values)
+{
+    dial_cov *cov = cand->cov;
+
+    if (coverage)
+    {
+        return dial_cov_iter_items(cov, cand->i_iter, values, FALSE) /
+               cov->duration;
+    }
+
+    return cov->value / (cov->n_chosen + 1) / cov->duration;
+}
+
+/*
+ * Greedily choose candidates with the best gain per second until
+ * the budget is spent or there is no gain anymore. Gains may only
+ * decrease when other candidates are chosen, so they are recomputed
+ * lazily: a candidate is chosen if its recomputed gain is still not
+ * less than the keys of all other candidates.
+ */
+static void
+dial_budget_choose(dial_budget_ctx *ctx, te_bool coverage)
+{
+    unsigned int *values;
+    size_t i;
+
+    values = TE_ALLOC((ctx->max_args + 1) * sizeof(*values));
+
+    ctx->heap_len = 0;
+    for (i = 0; i < ctx->n_cands; i++)
+    {
+        dial_cand *cand = &ctx->cands[i];
+
+        if (cand->act->chosen[cand->iter - cand->act->first])
+            continue;
+
+        cand->key = dial_cand_gain(cand, coverage, values);
+        if (cand->key > 0)
+            ctx->heap[ctx->heap_len++] = cand;
+    }
+    for (i = ctx->heap_len / 2; i > 0; i--)
+        dial_heap_down(ctx, i - 1);
+
+    while (ctx->heap_len > 0)
+    {
+        dial_cand *cand = ctx->heap[0];
+        double gain;
+        double next_key = 0;
+
+        if (cand->cov->duration > ctx->budget)
+        {
+            dial_heap_pop(ctx);
+            continue;
+        }
+
+        gain = dial_cand_gain(cand, coverage, values);
+        if (gain <= 0)
+        {
+            dial_heap_pop(ctx);
+            continue;
+        }
+
+        if (ctx->heap_len > 1)
+            next_key = ctx->heap[1]->key;
+        if (ctx->heap_len > 2 && ctx->heap[2]->key > next_key)
+            next_key = ctx->heap[2]->key;
+
+        if (gain < next_key)
+        {
+            cand->key = gain;
+            dial_heap_down(ctx, 0);
+            continue;
+        }
+
+        cand->act->chosen[cand->iter - cand->act->first] = 1;
+        dial_cov_iter_items(cand->cov, cand->i_iter, values, TRUE);
+        cand->cov->n_chosen++;
+        ctx->budget -= cand->cov->duration;
+        ctx->n_chosen++;
+        dial_heap_pop(ctx);
+    }
+
+    free(values);
+}
+
+/* Log how argument values are covered by chosen iterations */
+static void
+dial_budget_log_coverage(const dial_budget_ctx *ctx)
+{
+    uint64_t n_items = 0;
+    uint64_t n_covered = 0;
+    size_t i;
+
+    for (i = 0; i < ctx->n_covs; i++)
+    {
+        const dial_cov *cov = ctx->cov_list[i];
+
+        if (cov->n_covered < cov->n_items)
+        {
+            INFO("Only %u of %u coverage items are covered by chosen "
+                 "iterations of '%s'", cov->n_covered,
+                 cov->n_items, run_item_name(cov->ri));
+        }
+
+        n_items += cov->n_items;
+        n_covered += cov->n_covered;
+    }
+
+    if (n_covered < n_items)
+    {
+        WARN("The budget is not enough to cover all tests, argument "
+             "values and their pairs: %" PRIu64 " of %" PRIu64 " "
+             "are covered",
+             n_covered, n_items);
+    }
+}
+
+/*
+ * Choose iterations from the selection tree to fit into the budget.
+ * At first iterations are chosen to cover all the values of arguments
+ * of every test and all the pairs of values of different arguments,
+ * preferring faster iterations covering more pairs. Then the remaining
+ * budget is filled with iterations having the best value per second,
+ * with value of a test decreasing with every its iteration chosen.
+ */
+static te_errno
+choose_iters_budget(dial_node *root, const dial_history *history,
+                    double budget, uint64_t total_iters)
+{
+    dial_budget_ctx ctx;
+    void *path_tree = NULL;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.history = history;
+    ctx.def_duration = (history != NULL) ?
+                       dial_history_avg_duration(history, DIAL_DEF_DURATION) :
+                       DIAL_DEF_DURATION;
+    ctx.budget = budget;
+
+    /* Fill test paths of script nodes */
+    count_path_iters(root, NULL, &path_tree);
+    tdestroy(path_tree, free_path_iters);
+
+    ctx.max_cands = total_iters;
+    ctx.cands = TE_ALLOC(ctx.max_cands * sizeof(*ctx.cands));
+    dial_budget_collect(&ctx, root, NULL, 1);
+    if (ctx.n_cands == 0)
+        goto cleanup;
+
+    ctx.heap = TE_ALLOC(ctx.n_cands * sizeof(*ctx.heap));
+
+    dial_budget_choose(&ctx, TRUE);
+    dial_budget_log_coverage(&ctx);
+    dial_budget_choose(&ctx, FALSE);
+
+    RING("%" PRIu64 " of %" PRIu64 " iterations are chosen, their "
+         "expected duration is %.0f seconds of %.0f seconds budget",
+         ctx.n_chosen, total_iters, budget - ctx.budget, budget);
+
+cleanup:
+    free(ctx.heap);
+    free(ctx.cands);
+    free(ctx.cov_list);
+    tdestroy(ctx.covs, free_dial_cov);
+    return 0;
+}
+
+/*
+ * Replace a given testing scenario with a new one containing
+ * iterations chosen either randomly (if @p dial is not negative)
+ * or to fit into a given time budget.
+ */
+static te_errno
+scenario_apply_selection(testing_scenario *scenario,
+                         const struct tester_cfgs *cfgs,
+                         double dial, double budget,
+                         const dial_history *history)
 {
     dial_node *root = NULL;
     acts_chosen iters;
@@ -1188,19 +1803,26 @@ scenario_apply_dial(testing_scenario *scenario,
     if (total_iters == 0)
         goto cleanup;
 
-    /*
-     * After final tree is constructed, set initial selection weights
-     * for its nodes.
-     */
-    set_init_weights(root);
+    if (dial >= 0)
+    {
+        /*
+         * After final tree is constructed, set initial selection
+         * weights for its nodes.
+         */
+        set_init_weights(root);
 
-    /*
-     * Compute exact number of iterations we should choose.
-     * Choose this number of iterations randomly from the
-     * selection tree.
-     */
-    select_num = total_iters * dial / 100.0;
-    rc = choose_iters(root, select_num);
+        /*
+         * Compute exact number of iterations we should choose.
+         * Choose this number of iterations randomly from the
+         * selection tree.
+         */
+        select_num = total_iters * dial / 100.0;
+        rc = choose_iters(root, select_num);
+    }
+    else
+    {
+        rc = choose_iters_budget(root, history, budget, total_iters);
+    }
     if (rc != 0)
         goto cleanup;
 
@@ -1224,3 +1846,22 @@ cleanup:
     acts_chosen_free(&iters);
     return rc;
 }
+
+/* See description in tester_run.h */
+te_errno
+scenario_apply_dial(testing_scenario *scenario,
+                    const struct tester_cfgs *cfgs,
+                    double dial)
+{
+    return scenario_apply_selection(scenario, cfgs, dial, -1, NULL);
+}
+
+/* See description in tester_run.h */
+te_errno
+scenario_apply_dial_budget(testing_scenario *scenario,
+                           const struct tester_cfgs *cfgs,
+                           double budget,
+                           const dial_history *history)
+{
+    return scenario_apply_selection(scenario, cfgs, -1, budget, history);
+}
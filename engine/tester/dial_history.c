@@ -0,0 +1,246 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2024 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Tester Subsystem
+ *
+ * Data about previous runs of tests used by --dial-budget.
+ */
+
+#define TE_LGR_USER "Dial History"
+
+#include "te_config.h"
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <search.h>
+
+#include "te_alloc.h"
+#include "te_str.h"
+#include "logger_api.h"
+#include "dial_history.h"
+
+/* Compare two dial_history_entry structures by test paths */
+static int
+compare_entry(const void *a, const void *b)
+{
+    return strcmp(((const dial_history_entry *)a)->path,
+                  ((const dial_history_entry *)b)->path);
+}
+
+/* Compare two pointers to dial_history_entry structures by test paths */
+static int
+compare_entry_ptr(const void *a, const void *b)
+{
+    return compare_entry(*(const dial_history_entry * const *)a,
+                         *(const dial_history_entry * const *)b);
+}
+
+/* Release memory allocated for dial_history_entry structure */
+static void
+free_entry(void *arg)
+{
+    dial_history_entry *entry = arg;
+
+    free(entry->path);
+    free(entry);
+}
+
+/* Find an entry for a test path, add a new one if there is no such entry */
+static dial_history_entry *
+get_entry(dial_history *hist, const char *path)
+{
+    dial_history_entry key = { .path = (char *)path };
+    dial_history_entry *entry;
+    void *result;
+
+    result = tfind(&key, &hist->tree, compare_entry);
+    if (result != NULL)
+        return *(dial_history_entry **)result;
+
+    entry = TE_ALLOC(sizeof(*entry));
+    entry->path = TE_STRDUP(path);
+
+    result = tsearch(entry, &hist->tree, compare_entry);
+    if (result == NULL)
+        TE_FATAL_ERROR("Failed to add new path to the tree");
+
+    TE_VEC_APPEND(&hist->entries, entry);
+    return entry;
+}
+
+/* See description in dial_history.h */
+te_errno
+dial_history_load(dial_history *hist, const char *filename)
+{
+    FILE *f;
+    char *line = NULL;
+    size_t line_size = 0;
+    unsigned int line_num = 0;
+    te_errno rc = 0;
+
+    f = fopen(filename, "r");
+    if (f == NULL)
+    {
+        rc = TE_OS_RC(TE_TESTER, errno);
+        ERROR("Failed to open dial history file '%s': %r", filename, rc);
+        return rc;
+    }
+
+    while (getline(&line, &line_size, f) >= 0)
+    {
+        char *saveptr = NULL;
+        char *path;
+        char *duration_str;
+        char *unexp_rate_str;
+        double duration;
+        double unexp_rate;
+        dial_history_entry *entry;
+
+        line_num++;
+
+        path = strtok_r(line, " \t\r\n", &saveptr);
+        if (path == NULL || *path == '#')
+            continue;
+
+        duration_str = strtok_r(NULL, " \t\r\n", &saveptr);
+        unexp_rate_str = strtok_r(NULL, " \t\r\n", &saveptr);
+
+        if (duration_str == NULL || unexp_rate_str == NULL ||
+            te_strtod(duration_str, &duration) != 0 ||
+            te_strtod(unexp_rate_str, &unexp_rate) != 0 ||
+            duration < 0 || unexp_rate < 0 || unexp_rate > 1)
+        {
+            ERROR("%s:%u: invalid dial history line", filename, line_num);
+            rc = TE_RC(TE_TESTER, TE_EINVAL);
+            break;
+        }
+
+        entry = get_entry(hist, path);
+        if (entry->known)
+        {
+            WARN("%s:%u: the test '%s' is mentioned more than once, "
+                 "the last data is used", filename, line_num, path);
+        }
+
+        entry->duration = duration;
+        entry->unexp_rate = unexp_rate;
+        entry->known = TRUE;
+    }
+
+    free(line);
+    fclose(f);
+
+    return rc;
+}
+
+/* See description in dial_history.h */
+const dial_history_entry *
+dial_history_find(const dial_history *hist, const char *path)
+{
+    dial_history_entry key = { .path = (char *)path };
+    void *result;
+
+    result = tfind(&key, &hist->tree, compare_entry);
+    if (result == NULL)
+        return NULL;
+
+    return *(dial_history_entry **)result;
+}
+
+/* See description in dial_history.h */
+double
+dial_history_avg_duration(const dial_history *hist, double def_duration)
+{
+    dial_history_entry * const *entry;
+    double total = 0;
+    unsigned int n_known = 0;
+
+    TE_VEC_FOREACH(&hist->entries, entry)
+    {
+        if ((*entry)->known)
+        {
+            total += (*entry)->duration;
+            n_known++;
+        }
+    }
+
+    return n_known > 0 ? total / n_known : def_duration;
+}
+
+/* See description in dial_history.h */
+void
+dial_history_add_iter(dial_history *hist, const char *path,
+                      double duration, te_bool unexpected)
+{
+    dial_history_entry *entry = get_entry(hist, path);
+
+    entry->n_iters++;
+    entry->total_duration += duration;
+    if (unexpected)
+        entry->n_unexp++;
+}
+
+/* See description in dial_history.h */
+te_errno
+dial_history_save(const dial_history *hist, const char *filename)
+{
+    te_vec sorted = TE_VEC_INIT(dial_history_entry *);
+    dial_history_entry * const *entry;
+    FILE *f;
+    te_errno rc = 0;
+
+    TE_VEC_FOREACH(&hist->entries, entry)
+        TE_VEC_APPEND(&sorted, *entry);
+    te_vec_sort(&sorted, compare_entry_ptr);
+
+    f = fopen(filename, "w");
+    if (f == NULL)
+    {
+        rc = TE_OS_RC(TE_TESTER, errno);
+        ERROR("Failed to open dial history file '%s' for writing: %r",
+              filename, rc);
+        te_vec_free(&sorted);
+        return rc;
+    }
+
+    fprintf(f, "# <test path> <average iteration duration in seconds> "
+            "<share of unexpected results>\n");
+    TE_VEC_FOREACH(&sorted, entry)
+    {
+        const dial_history_entry *e = *entry;
+
+        if (e->n_iters > 0)
+        {
+            fprintf(f, "%s %.3f %.3f\n", e->path,
+                    e->total_duration / e->n_iters,
+                    (double)e->n_unexp / e->n_iters);
+        }
+        else if (e->known)
+        {
+            fprintf(f, "%s %.3f %.3f\n", e->path, e->duration,
+                    e->unexp_rate);
+        }
+    }
+
+    if (fclose(f) != 0)
+    {
+        rc = TE_OS_RC(TE_TESTER, errno);
+        ERROR("Failed to write dial history file '%s': %r", filename, rc);
+    }
+
+    te_vec_free(&sorted);
+    return rc;
+}
+
+/* See description in dial_history.h */
+void
+dial_history_free(dial_history *hist)
+{
+    tdestroy(hist->tree, free_entry);
+    hist->tree = NULL;
+    te_vec_free(&hist->entries);
+}
@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2024 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Tester Subsystem
+ *
+ * Data about previous runs of tests used by --dial-budget.
+ */
+
+#ifndef __TE_TESTER_DIAL_HISTORY_H__
+#define __TE_TESTER_DIAL_HISTORY_H__
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_vector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Data about runs of a test */
+typedef struct dial_history_entry {
+    /** Test path (names of nested run items joined with '/') */
+    char *path;
+    /** Average duration of an iteration in previous runs, in seconds */
+    double duration;
+    /** Share of iterations with unexpected results in previous runs */
+    double unexp_rate;
+    /** Whether data about previous runs is known */
+    te_bool known;
+
+    /** Number of iterations run by this Tester */
+    unsigned int n_iters;
+    /** Total duration of iterations run by this Tester, in seconds */
+    double total_duration;
+    /** Number of iterations with unexpected results run by this Tester */
+    unsigned int n_unexp;
+} dial_history_entry;
+
+/**
+ * Data about runs of tests. Tests are identified by test paths rather
+ * than by iteration hashes: the data should remain usable after
+ * arguments of a test are changed, and per-test aggregates are
+ * compact and stable enough to predict a test from few runs.
+ */
+typedef struct dial_history {
+    /** Tree of dial_history_entry structures searched by test path */
+    void *tree;
+    /** Pointers to the same entries in order of addition */
+    te_vec entries;
+} dial_history;
+
+/** Initializer of dial_history structure */
+#define DIAL_HISTORY_INIT \
+    { .tree = NULL, .entries = TE_VEC_INIT(dial_history_entry *) }
+
+/**
+ * Load data about previous runs from a file. Every line of the file
+ * has format "<test path> <average iteration duration in seconds>
+ * <share of unexpected results>", empty lines and lines starting
+ * with '#' are ignored. If a test is mentioned more than once, the
+ * last line is used.
+ *
+ * @param hist          Where to add loaded data
+ * @param filename      File name
+ *
+ * @return Status code.
+ */
+extern te_errno dial_history_load(dial_history *hist,
+                                  const char *filename);
+
+/**
+ * Find data about a test.
+ *
+ * @param hist      Data about runs of tests
+ * @param path      Test path
+ *
+ * @return Found entry or @c NULL.
+ */
+extern const dial_history_entry *dial_history_find(const dial_history *hist,
+                                                   const char *path);
+
+/**
+ * Get average of iteration durations of all tests with data about
+ * previous runs.
+ *
+ * @param hist          Data about runs of tests
+ * @param def_duration  What to return if no data is known
+ *
+ * @return Average duration in seconds.
+ */
+extern double dial_history_avg_duration(const dial_history *hist,
+                                        double def_duration);
+
+/**
+ * Account an iteration of a test run by this Tester.
+ *
+ * @param hist          Data about runs of tests
+ * @param path          Test path
+ * @param duration      Duration of the iteration, in seconds
+ * @param unexpected    Whether the result of the iteration is unexpected
+ */
+extern void dial_history_add_iter(dial_history *hist, const char *path,
+                                  double duration, te_bool unexpected);
+
+/**
+ * Save data about runs of tests to a file in format accepted by
+ * dial_history_load(). Tests run by this Tester are saved with data
+ * of the current run, other tests are saved with previously loaded
+ * data.
+ *
+ * @param hist          Data about runs of tests
+ * @param filename      File name
+ *
+ * @return Status code.
+ */
+extern te_errno dial_history_save(const dial_history *hist,
+                                  const char *filename);
+
+/**
+ * Release memory allocated for data about runs of tests.
+ *
+ * @param hist      Data about runs of tests
+ */
+extern void dial_history_free(dial_history *hist);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_TESTER_DIAL_HISTORY_H__ */
@@ -39,6 +39,9 @@
 #include <jansson.h>
 
 #include "te_alloc.h"
+#include "te_str.h"
+#include "te_string.h"
+#include "te_time.h"
 #include "conf_api.h"
 #include "log_bufs.h"
 #include "te_trc.h"
@@ -165,6 +168,13 @@ typedef struct tester_ctx {
 #endif
 } tester_ctx;
 
+/** Hash of test iteration arguments cached at plan time */
+typedef struct run_iter_hash {
+    unsigned int    cfg_id;     /**< Configuration ID of the iteration */
+    const run_item *ri;         /**< Run item of the iteration */
+    char           *hash;       /**< Hash of the iteration arguments */
+} run_iter_hash;
+
 /**
  * Opaque data for all configuration traverse callbacks.
  */
@@ -202,6 +212,22 @@ typedef struct tester_run_data {
                                                  nesting level */
     int                         plan_id;    /**< ID of the next run item in
                                                  the plan */
+    te_vec                      iter_hashes; /**< Hashes of test iteration
+                                                  arguments (run_iter_hash)
+                                                  computed at plan time,
+                                                  sorted by configuration
+                                                  ID */
+    te_string                   test_path;  /**< Names of the current
+                                                 nested run items joined
+                                                 with '/' */
+    te_vec                      test_path_lens; /**< Lengths of
+                                                     @p test_path before
+                                                     names of nested run
+                                                     items were added */
+    double                      script_duration; /**< Duration of the last
+                                                      run test script in
+                                                      seconds or negative
+                                                      value */
 
 #if WITH_TRC
     const te_trc_db            *trc_db;     /**< TRC database handle */
@@ -1336,6 +1362,38 @@ test_params_to_json(const unsigned int n_args, const test_iter_arg *args)
     return result;
 }
 
+/**
+ * Normalize parameter value appending it to the string.
+ * Leading and trailing spaces are removed, other sequences of
+ * space characters are replaced with a single space.
+ *
+ * @param dst     String to append normalized value to
+ * @param param   Parameter value to normalize
+ */
+static void
+test_params_normalise_append(te_string *dst, const char *param)
+{
+    const char *p;
+    const char *word;
+    te_bool     first = TRUE;
+
+    for (p = param; *p != '\0'; )
+    {
+        while (isspace(*p))
+            p++;
+        if (*p == '\0')
+            break;
+
+        for (word = p; *p != '\0' && !isspace(*p); p++)
+            ;
+
+        if (!first)
+            te_string_append_buf(dst, " ", 1);
+        te_string_append_buf(dst, word, p - word);
+        first = FALSE;
+    }
+}
+
 /**
  * Normalize parameter value. Remove trailing spaces and newlines.
  *
@@ -1346,42 +1404,26 @@ test_params_to_json(const unsigned int n_args, const test_iter_arg *args)
 char *
 test_params_normalise(const char *param)
 {
-    const char *p;
-    char *q;
-    char *str = NULL;
-    te_bool skip_spaces = TRUE;
+    te_string str = TE_STRING_INIT;
 
     if (param == NULL)
         return NULL;
 
-    str = (char *)calloc(1, strlen(param) + 1);
-    if (str == NULL)
-        return NULL;
-
-    for (p = param, q = str; *p != '\0'; p++)
-    {
-        if (isspace(*p))
-        {
-            if (!skip_spaces)
-            {
-                *q++ = ' ';
-                skip_spaces = TRUE;
-            }
-        }
-        else
-        {
-            *q++ = *p;
-            skip_spaces = FALSE;
-        }
-    }
+    /* Make sure that the buffer is allocated even for empty values */
+    te_string_append(&str, "");
+    test_params_normalise_append(&str, param);
 
-    /* remove trailing space at the end, if any */
-    if ((q > str) && (skip_spaces))
-        q--;
+    return str.ptr;
+}
 
-    *q = '\0';
+/** Compare pointers to test arguments by argument names */
+static int
+test_iter_arg_ptr_cmp(const void *a, const void *b)
+{
+    const test_iter_arg *arg_a = *(const test_iter_arg * const *)a;
+    const test_iter_arg *arg_b = *(const test_iter_arg * const *)b;
 
-    return str;
+    return strcmp(arg_a->name, arg_b->name);
 }
 
 /**
@@ -1395,114 +1437,181 @@ test_params_normalise(const char *param)
 char *
 test_params_hash(test_iter_arg *args, unsigned int n_args)
 {
-    EVP_MD_CTX *md5;
-    unsigned int md5_len;
+    /*
+     * Digest lookup and context allocation are not cheap, so they are
+     * done once. Tester walks the configuration in a single thread.
+     */
+    static const EVP_MD *md5_type = NULL;
+    static EVP_MD_CTX   *md5 = NULL;
+    /* Buffer reused for normalized name-value pairs */
+    static te_string     pair = TE_STRING_INIT;
 
-    unsigned int  i;
-    unsigned int  j;
-    unsigned int  k;
-    unsigned char digest[EVP_MAX_MD_SIZE];
-    char *hash_str = calloc(1, sizeof(digest) * 2 + 1);
-    int  *sorted = calloc(n_args, sizeof(int));
-    char  buf[8192] = {0, };
-    int   len = 0;
+    static const char hex[] = "0123456789abcdef";
 
-    if (sorted == NULL)
-    {
-        free(hash_str);
-        return NULL;
-    }
-    for (k = 0; k < n_args; k++)
-        sorted[k] = k;
+    unsigned int          md5_len;
+    unsigned int          i;
+    unsigned char         digest[EVP_MAX_MD_SIZE];
+    char                 *hash_str;
+    const test_iter_arg **sorted;
 
-    /* Sort arguments first */
-    if (n_args > 0)
+    if (md5 == NULL)
     {
-        for (i = 0; i < n_args - 1; i++)
+        md5_type = EVP_get_digestbyname("md5");
+        md5 = EVP_MD_CTX_new();
+        if (md5_type == NULL || md5 == NULL)
         {
-            for (j = i + 1; j < n_args; j++)
-            {
-                if (strcmp(args[sorted[i]].name, args[sorted[j]].name) > 0)
-                {
-                    k = sorted[i];
-                    sorted[i] = sorted[j];
-                    sorted[j] = k;
-                }
-            }
+            ERROR("%s(): failed to initialize MD5 context", __FUNCTION__);
+            EVP_MD_CTX_free(md5);
+            md5 = NULL;
+            return NULL;
         }
     }
 
-    md5 = EVP_MD_CTX_new();
-    EVP_DigestInit_ex(md5, EVP_get_digestbyname("md5"), NULL);
+    /* Sort arguments first */
+    sorted = TE_ALLOC((n_args + 1) * sizeof(*sorted));
+    for (i = 0; i < n_args; i++)
+        sorted[i] = &args[i];
+    qsort(sorted, n_args, sizeof(*sorted), test_iter_arg_ptr_cmp);
+
+    EVP_DigestInit_ex(md5, md5_type, NULL);
 
     for (i = 0; i < n_args; i++)
     {
-        const char *name = args[sorted[i]].name;
-        char *value = test_params_normalise(args[sorted[i]].value);
-
-        if (value == NULL)
+        if (sorted[i]->value == NULL)
         {
             free(sorted);
-            free(hash_str);
-            EVP_MD_CTX_free(md5);
             return NULL;
         }
 
-        VERB("%s %s", name, value);
-        len += snprintf(buf + len, sizeof(buf) - len,
-                        "%s%s %s", (i != 0) ? " " : "", name, value);
-        /*
-         * In case buffer size is too short to dump the whole string
-         * snprintf dumps only a part of string (that fits into the buffer)
-         * and returns the number of bytes it would have been written
-         * if buffer was bigger in size.
-         * We may easily have buffer overflow here, so we should catch
-         * such a condition and set current buffer length to total buffer
-         * length value in order to have '0' length for the next
-         * snprintf() call.
-         * In any case this buffer is filled in for debugging purposes,
-         * so there is no much need to care about it.
-         */
-        if (len >= (int)sizeof(buf))
-            len = sizeof(buf);
-
-        if (i != 0)
-            EVP_DigestUpdate(md5, " ", 1);
-
-        EVP_DigestUpdate(md5, name, strlen(name));
-        EVP_DigestUpdate(md5, " ", 1);
-        EVP_DigestUpdate(md5, value, strlen(value));
+        te_string_reset(&pair);
+        te_string_append(&pair, "%s%s ", (i != 0) ? " " : "",
+                         sorted[i]->name);
+        test_params_normalise_append(&pair, sorted[i]->value);
 
-        free(value);
+        VERB("%s", pair.ptr);
+        EVP_DigestUpdate(md5, pair.ptr, pair.len);
     }
+    free(sorted);
 
     EVP_DigestFinal_ex(md5, digest, &md5_len);
-    EVP_MD_CTX_free(md5);
 
+    hash_str = TE_ALLOC(md5_len * 2 + 1);
     for (i = 0; i < md5_len; i++)
     {
-        sprintf(hash_str + strlen(hash_str), "%02hhx", digest[i]);
+        hash_str[2 * i] = hex[digest[i] >> 4];
+        hash_str[2 * i + 1] = hex[digest[i] & 0xf];
     }
 
-    free(sorted);
-
     VERB("\nHash: %s\n", hash_str);
-    VERB("%s->%s", buf, hash_str);
 
     return hash_str;
 }
 
+/** Compare configuration ID with cached iteration hash */
+static int
+run_iter_hash_cmp(const void *key, const void *elt)
+{
+    unsigned int         cfg_id = *(const unsigned int *)key;
+    const run_iter_hash *iter_hash = elt;
+
+    if (cfg_id == iter_hash->cfg_id)
+        return 0;
+
+    return cfg_id < iter_hash->cfg_id ? -1 : 1;
+}
+
+/**
+ * Get hash of the current test iteration arguments.
+ *
+ * Configuration walks done at plan time (preparatory walk and
+ * execution plan assembling) visit iterations in order of
+ * configuration IDs, so their hashes are cached in a sorted vector
+ * and are not recalculated when the testing scenario is executed.
+ * Argument values of an iteration depend on the configuration only,
+ * so the cache is valid for the whole Tester run.
+ *
+ * @param gctx          Tester run data
+ * @param ri            Run item
+ * @param cfg_id_off    Configuration ID of the iteration
+ * @param ctx           Tester context with the iteration arguments
+ *
+ * @return Allocated string or @c NULL.
+ */
+static char *
+run_iter_hash_get(tester_run_data *gctx, const run_item *ri,
+                  unsigned int cfg_id_off, const tester_ctx *ctx)
+{
+    const run_iter_hash *found;
+    const run_iter_hash *last = NULL;
+    run_iter_hash        entry;
+    unsigned int         min;
+    unsigned int         max;
+    char                *hash;
+
+    if (te_vec_search(&gctx->iter_hashes, &cfg_id_off, run_iter_hash_cmp,
+                      &min, &max))
+    {
+        /* Prologues share configuration IDs with the first test */
+        for (; min <= max; min++)
+        {
+            found = te_vec_get(&gctx->iter_hashes, min);
+            if (found->ri == ri)
+                return TE_STRDUP(found->hash);
+        }
+    }
+
+    hash = test_params_hash(ctx->args, ri->n_args);
+    if (hash == NULL)
+        return NULL;
+
+    if (te_vec_size(&gctx->iter_hashes) > 0)
+    {
+        last = te_vec_get(&gctx->iter_hashes,
+                          te_vec_size(&gctx->iter_hashes) - 1);
+    }
+
+    /* Keep the cache sorted, iterations walked back are not cached */
+    if ((gctx->flags & (TESTER_PRERUN | TESTER_ASSEMBLE_PLAN)) &&
+        (last == NULL || last->cfg_id <= cfg_id_off))
+    {
+        entry.cfg_id = cfg_id_off;
+        entry.ri = ri;
+        entry.hash = hash;
+        TE_VEC_APPEND(&gctx->iter_hashes, entry);
+        return TE_STRDUP(hash);
+    }
+
+    return hash;
+}
+
+/**
+ * Release hashes of test iteration arguments cached at plan time.
+ *
+ * @param gctx          Tester run data
+ */
+static void
+run_iter_hashes_free(tester_run_data *gctx)
+{
+    run_iter_hash *iter_hash;
+
+    TE_VEC_FOREACH(&gctx->iter_hashes, iter_hash)
+        free(iter_hash->hash);
+
+    te_vec_free(&gctx->iter_hashes);
+}
+
 /**
  * Log test (script, package, session) start.
  *
  * @param ctx           Tester context
  * @param ri            Run item
  * @param tin           Test identification number
+ * @param hash          Hash of the test iteration arguments or @c NULL
  */
 static void
 log_test_start(unsigned int flags,
                const tester_ctx *ctx, const run_item *ri,
-               unsigned int tin)
+               unsigned int tin, const char *hash)
 {
     test_id                 parent = ctx->group_result.id;
     test_id                 test = ctx->current_result.id;
@@ -1514,7 +1623,6 @@ log_test_start(unsigned int flags,
     json_t                 *tmp;
 
     te_string   params_str  = TE_STRING_INIT;
-    char       *hash_str    = NULL;
 
 #define SET_JSON_STRING(_target, _string) \
     do {                                                                 \
@@ -1607,18 +1715,9 @@ log_test_start(unsigned int flags,
                 SET_NEW_JSON(result, "tin", tmp);
             }
 
-            hash_str = test_params_hash(ctx->args, ri->n_args);
-            if (hash_str != NULL)
+            if (hash != NULL)
             {
-                tmp = json_string(hash_str);
-                free(hash_str);
-                if (tmp == NULL)
-                {
-                    ERROR("%s: json_string failed for hash_str",
-                          __FUNCTION__);
-                    json_decref(result);
-                    return;
-                }
+                SET_JSON_STRING(tmp, hash);
                 SET_NEW_JSON(result, "hash", tmp);
             }
 
@@ -2477,6 +2576,8 @@ run_script(run_item *ri, test_script *script,
     tester_cfg_walk_ctl     ctl;
     tester_flags            def_flags = (gctx->flags & TESTER_FAKE) ?
                                             TESTER_FAKE : 0;
+    struct timeval          script_start;
+    struct timeval          script_end;
 
     assert(gctx != NULL);
     ctx = SLIST_FIRST(&gctx->ctxs);
@@ -2500,6 +2601,7 @@ run_script(run_item *ri, test_script *script,
 
     assert(ri != NULL);
     assert(ri->n_args == ctx->n_args);
+    te_gettimeofday(&script_start, NULL);
     if (run_test_script(script, ri->name, ctx->current_result.id,
                         ctx->n_args, ctx->args,
                         gctx->act == NULL ? def_flags : /* FIXME */
@@ -2508,6 +2610,9 @@ run_script(run_item *ri, test_script *script,
     {
         ctx->current_result.status = TESTER_TEST_ERROR;
     }
+    te_gettimeofday(&script_end, NULL);
+    te_timersub(&script_end, &script_start, &script_end);
+    gctx->script_duration = script_end.tv_sec + script_end.tv_usec / 1e6;
 
     switch (ctx->current_result.status)
     {
@@ -2778,6 +2883,43 @@ run_this_item(const unsigned int cfg_id_off, const unsigned int act_id,
         return TESTING_STOP;
 }
 
+/**
+ * Add name of a run item to the path of the current test.
+ *
+ * @param gctx          Tester run data
+ * @param ri            Run item which is started
+ */
+static void
+run_test_path_push(tester_run_data *gctx, const run_item *ri)
+{
+    const char *name = run_item_name(ri);
+
+    TE_VEC_APPEND(&gctx->test_path_lens, gctx->test_path.len);
+    if (te_str_is_null_or_empty(name))
+        return;
+
+    if (gctx->test_path.len > 0)
+        te_string_append(&gctx->test_path, "/");
+    te_string_append(&gctx->test_path, "%s", name);
+}
+
+/**
+ * Remove name of the last started run item from the path of
+ * the current test.
+ *
+ * @param gctx          Tester run data
+ */
+static void
+run_test_path_pop(tester_run_data *gctx)
+{
+    size_t n = te_vec_size(&gctx->test_path_lens);
+
+    assert(n > 0);
+    te_string_cut(&gctx->test_path, gctx->test_path.len -
+                  *(size_t *)te_vec_get(&gctx->test_path_lens, n - 1));
+    te_vec_remove_index(&gctx->test_path_lens, n - 1);
+}
+
 static tester_cfg_walk_ctl
 run_item_start(run_item *ri, unsigned int cfg_id_off, unsigned int flags,
                void *opaque)
@@ -2790,6 +2932,8 @@ run_item_start(run_item *ri, unsigned int cfg_id_off, unsigned int flags,
     assert(ctx != NULL);
     LOG_WALK_ENTRY(cfg_id_off, gctx);
 
+    run_test_path_push(gctx, ri);
+
 #if WITH_TRC
     ctx->do_trc_walker = FALSE;
 #endif
@@ -2893,6 +3037,8 @@ run_item_end(run_item *ri, unsigned int cfg_id_off, unsigned int flags,
     free(ctx->args);
     ctx->args = NULL;
 
+    run_test_path_pop(gctx);
+
     if (run_release_cfg_backup(ctx) != 0)
     {
         EXIT("FAULT");
@@ -3851,7 +3997,7 @@ run_repeat_start(run_item *ri, unsigned int cfg_id_off, unsigned int flags,
     if (ri->type == RUN_ITEM_SCRIPT && gctx->act != NULL &&
         gctx->act->hash != NULL && ~ctx->flags & TESTER_INLOGUE)
     {
-        hash_str = test_params_hash(ctx->args, ri->n_args);
+        hash_str = run_iter_hash_get(gctx, ri, cfg_id_off, ctx);
 
         if (hash_str == NULL || strcmp(hash_str, gctx->act->hash) != 0)
         {
@@ -3911,6 +4057,10 @@ run_repeat_start(run_item *ri, unsigned int cfg_id_off, unsigned int flags,
         }
         if (required)
         {
+            /* Precompute the hash to be logged when the test is run */
+            if (ri->type == RUN_ITEM_SCRIPT)
+                free(run_iter_hash_get(gctx, ri, cfg_id_off, ctx));
+
             EXIT("CONT");
             return TESTER_CFG_WALK_CONT;
         }
@@ -3997,7 +4147,10 @@ run_repeat_start(run_item *ri, unsigned int cfg_id_off, unsigned int flags,
     /* Test is considered here as run, if such event is logged */
     tester_term_out_start(ctx->flags, ri->type, run_item_name(ri), tin,
                           ctx->group_result.id, ctx->current_result.id);
-    log_test_start(flags, ctx, ri, tin);
+    hash_str = (ri->type == RUN_ITEM_SCRIPT) ?
+                   run_iter_hash_get(gctx, ri, cfg_id_off, ctx) : NULL;
+    log_test_start(flags, ctx, ri, tin, hash_str);
+    free(hash_str);
 
     tester_test_result_add(&gctx->results, &ctx->current_result);
 
@@ -4277,6 +4430,23 @@ run_repeat_end(run_item *ri, unsigned int cfg_id_off, unsigned int flags,
 
         tin = (ctx->flags & TESTER_INLOGUE || ri->type != RUN_ITEM_SCRIPT) ?
                   TE_TIN_INVALID : cfg_id_off;
+
+        if (tester_global_context.dial_history_save != NULL &&
+            tin != TE_TIN_INVALID && gctx->script_duration >= 0 &&
+            ctx->current_result.status != TESTER_TEST_FAKED)
+        {
+            dial_history_add_iter(&tester_global_context.dial_stats,
+                                  gctx->test_path.ptr,
+                                  gctx->script_duration,
+#if WITH_TRC
+                                  ctx->current_result.exp_status ==
+                                      TRC_VERDICT_UNEXPECTED
+#else
+                                  FALSE
+#endif
+                                  );
+        }
+        gctx->script_duration = -1;
         log_test_result(ctx->group_result.id, &ctx->current_result, ri->plan_id);
 
         tester_term_out_done(ctx->flags, ri->type, run_item_name(ri), tin,
@@ -4568,6 +4738,10 @@ tester_run(testing_scenario   *scenario,
 
     memset(&data, 0, sizeof(data));
     data.flags = flags;
+    data.iter_hashes = TE_VEC_INIT(run_iter_hash);
+    data.test_path = (te_string)TE_STRING_INIT;
+    data.test_path_lens = TE_VEC_INIT(size_t);
+    data.script_duration = -1;
     if (all_faked == TRUE)
         data.flags |= TESTER_FAKE;
 
@@ -4720,6 +4894,9 @@ tester_run(testing_scenario   *scenario,
 
     tester_run_destroy_ctx(&data);
     scenario_free(&data.fixed_scen);
+    run_iter_hashes_free(&data);
+    te_string_free(&data.test_path);
+    te_vec_free(&data.test_path_lens);
 #if WITH_TRC
     tq_strings_free(&data.trc_tags, free);
 #endif
@@ -100,6 +100,10 @@ tester_global_init(tester_global *global)
     TAILQ_INIT(&global->cmd_monitors);
 
     global->dial = -1.0;
+    global->dial_budget = -1.0;
+    global->dial_history = NULL;
+    global->dial_history_save = NULL;
+    global->dial_stats = (dial_history)DIAL_HISTORY_INIT;
 
     return 0;
 }
@@ -119,6 +123,9 @@ tester_global_free(tester_global *global)
     test_paths_free(&global->paths);
     logic_expr_free(global->targets);
     free(global->verdict);
+    free(global->dial_history);
+    free(global->dial_history_save);
+    dial_history_free(&global->dial_stats);
 #if WITH_TRC
     trc_db_close(global->trc_db);
     tq_strings_free(&global->trc_tags, free);
@@ -193,6 +200,9 @@ process_cmd_line_opts(tester_global *global, int argc, char **argv)
         TESTER_OPT_VERB_SKIP,
 
         TESTER_OPT_DIAL,
+        TESTER_OPT_DIAL_BUDGET,
+        TESTER_OPT_DIAL_HISTORY,
+        TESTER_OPT_DIAL_HISTORY_SAVE,
 
         /*
          * Values from here to TESTER_OPT_FAKE must correspond
@@ -302,6 +312,23 @@ process_cmd_line_opts(tester_global *global, int argc, char **argv)
         { "dial", '\0', POPT_ARG_DOUBLE, &global->dial, TESTER_OPT_DIAL,
           "Choose randomly a given percentage of test iterations to run.",
           "<double in range 0-100>" },
+        { "dial-budget", '\0', POPT_ARG_DOUBLE, &global->dial_budget,
+          TESTER_OPT_DIAL_BUDGET,
+          "Choose test iterations covering pairs of argument values "
+          "which are expected to run within a given time.",
+          "<seconds>" },
+        { "dial-history", '\0', POPT_ARG_STRING, NULL,
+          TESTER_OPT_DIAL_HISTORY,
+        TESTER_OPT_DIAL_HISTORY_SAVE,
+          "File with average iteration durations and shares of "
+          "unexpected results of tests for --dial-budget.",
+          "<filename>" },
+        { "dial-history-save", '\0', POPT_ARG_STRING, NULL,
+          TESTER_OPT_DIAL_HISTORY_SAVE,
+          "Save average iteration durations and shares of unexpected "
+          "results of tests to a file accepted by --dial-history "
+          "(tests which are not run keep data from --dial-history).",
+          "<filename>" },
 
         { "fake", '\0', POPT_ARG_STRING, NULL, TESTER_OPT_FAKE,
           "Don't run any test scripts, just emulate test scenario.",
@@ -576,6 +603,27 @@ process_cmd_line_opts(tester_global *global, int argc, char **argv)
 
                 break;
 
+            case TESTER_OPT_DIAL_BUDGET:
+                if (global->dial_budget <= 0)
+                {
+                    ERROR("Incorrect --dial-budget value %f, must be "
+                          "positive", global->dial_budget);
+                    poptFreeContext(optCon);
+                    return TE_EINVAL;
+                }
+
+                break;
+
+            case TESTER_OPT_DIAL_HISTORY:
+                free(global->dial_history);
+                global->dial_history = strdup(poptGetOptArg(optCon));
+                break;
+
+            case TESTER_OPT_DIAL_HISTORY_SAVE:
+                free(global->dial_history_save);
+                global->dial_history_save = strdup(poptGetOptArg(optCon));
+                break;
+
             case TESTER_OPT_RUN:
             case TESTER_OPT_RUN_FORCE:
             case TESTER_OPT_RUN_FROM:
@@ -825,6 +873,13 @@ process_cmd_line_opts(tester_global *global, int argc, char **argv)
         return TE_EINVAL;
     }
 
+    if (global->dial >= 0 && global->dial_budget > 0)
+    {
+        ERROR("--dial and --dial-budget cannot be used together");
+        poptFreeContext(optCon);
+        return TE_EINVAL;
+    }
+
     if (no_reqs)
     {
         logic_expr_free(global->targets);
@@ -1166,6 +1221,26 @@ main(int argc, char *argv[])
             goto exit;
     }
 
+    if (tester_global_context.dial_history != NULL &&
+        (tester_global_context.dial_budget > 0 ||
+         tester_global_context.dial_history_save != NULL))
+    {
+        rc = dial_history_load(&tester_global_context.dial_stats,
+                               tester_global_context.dial_history);
+        if (rc != 0)
+            goto exit;
+    }
+
+    if (tester_global_context.dial_budget > 0)
+    {
+        rc = scenario_apply_dial_budget(&tester_global_context.scenario,
+                                        &tester_global_context.cfgs,
+                                        tester_global_context.dial_budget,
+                                        &tester_global_context.dial_stats);
+        if (rc != 0)
+            goto exit;
+    }
+
     /*
      * Execute testing scenario.
      */
@@ -1187,6 +1262,12 @@ main(int argc, char *argv[])
                         tester_global_context.flags,
                         tester_global_context.verdict);
         stop_cmd_monitors(&tester_global_context.cmd_monitors);
+        /* Failure to save the data should not fail the testing */
+        if (tester_global_context.dial_history_save != NULL)
+        {
+            (void)dial_history_save(&tester_global_context.dial_stats,
+                                    tester_global_context.dial_history_save);
+        }
         if (rc != 0)
         {
 #if 1
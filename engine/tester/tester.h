@@ -21,6 +21,7 @@
 #include "type_lib.h"
 #include "tester_flags.h"
 #include "tester_cmd_monitor.h"
+#include "dial_history.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,6 +44,21 @@ typedef struct tester_global {
 
     /** Percentage of all test iterations to choose randomly */
     double dial;
+    /**
+     * Time budget in seconds to choose test iterations for
+     * or negative value
+     */
+    double dial_budget;
+    /** File with data about previous runs used with dial budget */
+    char *dial_history;
+    /** File to save data about runs of tests to or @c NULL */
+    char *dial_history_save;
+    /**
+     * Data about previous runs of tests loaded from @p dial_history
+     * and about tests run by this Tester if @p dial_history_save
+     * is set
+     */
+    dial_history dial_stats;
 
     cmd_monitor_descrs  cmd_monitors;   /**< Command monitors specifier via
                                              command line */
@@ -285,6 +285,7 @@ extern const char * scenario_to_str(const testing_scenario *scenario);
 /* Forwards */
 struct tester_cfgs;
 struct test_paths;
+struct dial_history;
 
 /**
  * Replace a given testing scenario with a new one containing randomly
@@ -301,6 +302,30 @@ extern te_errno scenario_apply_dial(testing_scenario *scenario,
                                     const struct tester_cfgs *cfgs,
                                     double dial);
 
+/**
+ * Replace a given testing scenario with a new one containing test
+ * iterations from the given scenario which are expected to fit into
+ * a given time budget.
+ *
+ * At first iterations are chosen to cover every value of every test
+ * argument and every pair of values of different arguments of a test.
+ * Then the remaining budget is filled with iterations of the most
+ * valuable tests, a test is more valuable if its results were
+ * unexpected more often in previous runs, and every next iteration
+ * of the same test is less valuable.
+ *
+ * @param scenario  Scenario to replace.
+ * @param cfgs      Configurations.
+ * @param budget    Time budget in seconds.
+ * @param history   Data about previous runs of tests or @c NULL.
+ *
+ * @return Status code.
+ */
+extern te_errno scenario_apply_dial_budget(testing_scenario *scenario,
+                                           const struct tester_cfgs *cfgs,
+                                           double budget,
+                                           const struct dial_history *history);
+
 /**
  * Run test configurations.
  *
@@ -18,11 +18,15 @@
 
 #include "logger_api.h"
 #include "te_errno.h"
+#include "te_alloc.h"
+#include "te_str.h"
 #include "conf_api.h"
+#include "rcf_api.h"
 #include "te_queue.h"
 #include "te_sigmap.h"
 
 #include <pthread.h>
+#include <time.h>
 
 /* Configurator subtrees */
 #define SERIAL_FMT_LOC      "/local:/tester:"
@@ -31,8 +35,13 @@
 /* Default handlers location */
 #define TESTER_SERIAL_LOC   "handlers"
 
-/* Default period to poll of events status */
+/* Default period to poll of events status, in milliseconds */
 #define TESTER_SERIAL_PERIOD    100
+/*
+ * Timeout of a single wait for events pushed by a Test Agent,
+ * in milliseconds
+ */
+#define TESTER_SERIAL_EVENT_WAIT_TIMEOUT    1000
 /* Max path length to external handler */
 #define TESTER_SERIAL_MAX_PATH  256
 
@@ -94,6 +103,42 @@ typedef struct tester_serial_handler_t {
 SLIST_HEAD(serial_hand_h_t, tester_serial_handler_t);
 typedef struct serial_hand_h_t serial_hand_h_t;
 
+/** Event pushed by a Test Agent */
+typedef struct tester_serial_event_t {
+    char       *data;       /**< Event description (split in place) */
+    const char *ta;         /**< Test Agent name */
+    const char *parser;     /**< Parser name */
+    const char *event;      /**< Parser event name */
+    const char *t_name;     /**< Tester event name or @c NULL */
+
+    TAILQ_ENTRY(tester_serial_event_t) links; /**< Queue links */
+} tester_serial_event_t;
+
+/** Test Agent which may push events */
+typedef struct tester_serial_agent_t {
+    char        name[RCF_MAX_NAME]; /**< Test Agent name */
+    int         sid;                /**< RCF session used to wait */
+    pthread_t   thread;             /**< Thread waiting for events */
+    te_bool     started;            /**< The thread is started */
+    te_bool     push;               /**< Events are pushed, otherwise
+                                         they should be polled */
+
+    SLIST_ENTRY(tester_serial_agent_t) links; /**< List links */
+} tester_serial_agent_t;
+
+/* Type of the tester_serial_agent_t list head */
+typedef SLIST_HEAD(, tester_serial_agent_t) tester_serial_agents_t;
+
+/* Lock protecting the pushed events queue and Test Agents state */
+static pthread_mutex_t events_lock = PTHREAD_MUTEX_INITIALIZER;
+/* Signalled when an event is pushed */
+static pthread_cond_t events_cond = PTHREAD_COND_INITIALIZER;
+/* New events are pushed since the queue was processed */
+static te_bool events_pushed = FALSE;
+/* Queue of the pushed events */
+static TAILQ_HEAD(, tester_serial_event_t) events =
+    TAILQ_HEAD_INITIALIZER(events);
+
 /** Counter to avoid infinite loops in configurator waiting */
 static int serial_wait_local_counter = 0;
 
@@ -454,14 +499,48 @@ tester_handle_serial_event(const char *event_name)
 }
 
 /**
- * Entry point to the Tester thread to handle events of the serial consoles
+ * Handle an active event and reset its status.
+ *
+ * @param status_handle Handle of the event status instance
+ * @param event_name    Name of the Tester event
+ *
+ * @return Status code
+ * @retval TE_EFAIL     The event could not be delivered to the test,
+ *                      its status is not reset
  */
-static int
-tester_serial_thread(void)
+static te_errno
+tester_serial_event_process(cfg_handle status_handle, const char *event_name)
+{
+    te_errno rc;
+
+    rc = tester_handle_serial_event(event_name);
+    if (rc == TE_EFAIL)
+        return rc;
+    if (rc != 0)
+    {
+        ERROR("Couldn't handle the event %s", event_name);
+        return rc;
+    }
+
+    SERIAL_WAIT_LOCAL_SEQ(cfg_set_instance(status_handle, CVT_INT32, FALSE));
+    if (rc != 0)
+        ERROR("Couldn't change event %s status", event_name);
+
+    return rc;
+}
+
+/**
+ * Poll status of the events of the Test Agent(s) and handle active ones.
+ *
+ * @param ta            Test Agent name or @c "*" for all Test Agents
+ *
+ * @return Status code
+ */
+static te_errno
+tester_serial_poll(const char *ta)
 {
     cfg_val_type    type;
     te_errno        rc;
-    int             period;
     unsigned        n_handles;
     cfg_handle     *handles         = NULL;
     cfg_handle      status_handle;
@@ -470,6 +549,324 @@ tester_serial_thread(void)
     int             i;
     int32_t         status;
 
+    SERIAL_WAIT_LOCAL_SEQ(cfg_find_pattern_fmt(&n_handles, &handles,
+        "/agent:%s/parser:*/event:*", ta));
+    if (rc != 0)
+        return rc;
+
+    for (i = 0; (unsigned)i < n_handles; i++)
+    {
+        SERIAL_WAIT_LOCAL_SEQ(cfg_get_oid_str(handles[i], &ag_event));
+        if (rc != 0 || ag_event == NULL)
+        {
+            ERROR("Couldn't get event oid");
+            continue;
+        }
+
+        SERIAL_WAIT_LOCAL_SEQ(cfg_find_fmt(&status_handle, "%s/status:",
+                                           ag_event));
+        if (rc != 0)
+        {
+            ERROR("Couldn't get event status handle of %s", ag_event);
+            free(ag_event);
+            continue;
+        }
+        free(ag_event);
+
+        type = CVT_INT32;
+        SERIAL_WAIT_LOCAL_SEQ(cfg_get_instance(status_handle,
+                                               &type, &status));
+        if (rc != 0)
+        {
+            ERROR("Couldn't get event status %s", te_rc_mod2str(rc));
+            continue;
+        }
+
+        if (status != 0)
+        {
+            event_name = NULL;
+            type = CVT_STRING;
+            SERIAL_WAIT_LOCAL_SEQ(cfg_get_instance(handles[i], &type,
+                                                   &event_name));
+            if (rc != 0 || event_name == NULL)
+            {
+                ERROR("Couldn't get the event name");
+                continue;
+            }
+
+            tester_serial_event_process(status_handle, event_name);
+            free(event_name);
+        }
+    }
+
+    free(handles);
+
+    return 0;
+}
+
+/**
+ * Handle an event pushed by a Test Agent.
+ *
+ * The event may already be handled by polling (e.g. the initial poll
+ * of all Test Agents) or due to a previous push of the same event, so
+ * it is handled only if its status is still active.
+ *
+ * @param event         The event
+ *
+ * @return Status code
+ * @retval TE_EFAIL     The event should be handled later
+ */
+static te_errno
+tester_serial_pushed_event_process(const tester_serial_event_t *event)
+{
+    cfg_handle      status_handle;
+    cfg_val_type    type = CVT_INT32;
+    int32_t         status;
+    te_errno        rc;
+
+    SERIAL_WAIT_LOCAL_SEQ(cfg_find_fmt(&status_handle,
+                                       "/agent:%s/parser:%s/event:%s/status:",
+                                       event->ta, event->parser,
+                                       event->event));
+    if (rc != 0)
+    {
+        ERROR("Couldn't get status handle of event %s of the parser %s "
+              "on %s: %r", event->event, event->parser, event->ta, rc);
+        return rc;
+    }
+
+    SERIAL_WAIT_LOCAL_SEQ(cfg_get_instance(status_handle, &type, &status));
+    if (rc != 0)
+    {
+        ERROR("Couldn't get status of event %s of the parser %s on %s: %r",
+              event->event, event->parser, event->ta, rc);
+        return rc;
+    }
+    if (status == 0)
+    {
+        VERB("Event %s of the parser %s on %s is already handled",
+             event->event, event->parser, event->ta);
+        return 0;
+    }
+
+    return tester_serial_event_process(status_handle, event->t_name);
+}
+
+/**
+ * Entry point to the thread waiting for events pushed by a Test Agent.
+ *
+ * @param arg           The Test Agent
+ */
+static void *
+tester_serial_agent_thread(void *arg)
+{
+    tester_serial_agent_t  *agent = arg;
+    tester_serial_event_t  *event;
+    char                    buf[RCF_MAX_VAL];
+    char                   *saveptr;
+    char                   *kind;
+    te_errno                rc;
+
+    while (stop_thread == FALSE)
+    {
+        rc = rcf_ta_event_wait(agent->name, agent->sid,
+                               TESTER_SERIAL_EVENT_WAIT_TIMEOUT,
+                               buf, sizeof(buf));
+        if (TE_RC_GET_ERROR(rc) == TE_ETIMEDOUT)
+            continue;
+        if (rc != 0)
+        {
+            if (TE_RC_GET_ERROR(rc) == TE_EOPNOTSUPP ||
+                TE_RC_GET_ERROR(rc) == TE_EFMT)
+            {
+                INFO("Test Agent %s does not push events, they are polled",
+                     agent->name);
+            }
+            else
+            {
+                WARN("Failed to wait for events of the Test Agent %s, "
+                     "they are polled: %r", agent->name, rc);
+            }
+            break;
+        }
+
+        event = TE_ALLOC(sizeof(*event));
+        event->data = TE_STRDUP(buf);
+        kind = strtok_r(event->data, " ", &saveptr);
+        event->parser = strtok_r(NULL, " ", &saveptr);
+        event->event = strtok_r(NULL, " ", &saveptr);
+        event->t_name = strtok_r(NULL, "", &saveptr);
+        if (kind == NULL || strcmp(kind, "serial_event") != 0 ||
+            event->event == NULL)
+        {
+            /* Not a serial console event */
+            free(event->data);
+            free(event);
+            continue;
+        }
+        event->ta = agent->name;
+
+        pthread_mutex_lock(&events_lock);
+        TAILQ_INSERT_TAIL(&events, event, links);
+        events_pushed = TRUE;
+        pthread_cond_signal(&events_cond);
+        pthread_mutex_unlock(&events_lock);
+    }
+
+    pthread_mutex_lock(&events_lock);
+    agent->push = FALSE;
+    pthread_mutex_unlock(&events_lock);
+
+    return NULL;
+}
+
+/**
+ * Find a Test Agent in the list.
+ *
+ * @param agents        List of Test Agents
+ * @param name          Test Agent name
+ *
+ * @return The Test Agent or @c NULL if it is not found
+ */
+static tester_serial_agent_t *
+tester_serial_agent_find(const tester_serial_agents_t *agents,
+                         const char *name)
+{
+    tester_serial_agent_t *agent;
+
+    SLIST_FOREACH(agent, agents, links)
+    {
+        if (strcmp(agent->name, name) == 0)
+            return agent;
+    }
+
+    return NULL;
+}
+
+/**
+ * Start waiting for events pushed by a Test Agent and add it to the list.
+ *
+ * @param agents        List of Test Agents
+ * @param name          Test Agent name
+ */
+static void
+tester_serial_agent_start(tester_serial_agents_t *agents, const char *name)
+{
+    tester_serial_agent_t  *agent;
+    te_errno                rc;
+
+    agent = TE_ALLOC(sizeof(*agent));
+    te_strlcpy(agent->name, name, sizeof(agent->name));
+
+    /* Dedicated session to avoid blocking of other requests */
+    rc = rcf_ta_create_session(agent->name, &agent->sid);
+    if (rc == 0)
+    {
+        agent->push = TRUE;
+        rc = pthread_create(&agent->thread, NULL,
+                            tester_serial_agent_thread, agent);
+        if (rc != 0)
+        {
+            agent->push = FALSE;
+            rc = TE_OS_RC(TE_TESTER, rc);
+        }
+        else
+        {
+            agent->started = TRUE;
+        }
+    }
+    if (rc != 0)
+    {
+        WARN("Failed to wait for events of the Test Agent %s, "
+             "they are polled: %r", agent->name, rc);
+    }
+
+    SLIST_INSERT_HEAD(agents, agent, links);
+}
+
+/**
+ * Start waiting for events pushed by Test Agents which are not in
+ * the list yet. Test Agents may be started after the Tester, so
+ * the list is updated periodically.
+ *
+ * @param agents        List of Test Agents to update
+ *
+ * @return Status code
+ */
+static te_errno
+tester_serial_agents_update(tester_serial_agents_t *agents)
+{
+    char        buf[RCF_MAX_VAL];
+    size_t      len = sizeof(buf);
+    const char *name;
+    te_errno    rc;
+
+    rc = rcf_get_ta_list(buf, &len);
+    if (rc != 0)
+        return rc;
+
+    for (name = buf; name < buf + len; name += strlen(name) + 1)
+    {
+        if (*name != '\0' && tester_serial_agent_find(agents, name) == NULL)
+        {
+            /*
+             * Events activated before waiting is started are only
+             * polled, a pushed event is not handled twice since its
+             * status is checked before handling.
+             */
+            rc = tester_serial_poll(name);
+            if (rc != 0)
+                return rc;
+
+            tester_serial_agent_start(agents, name);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Stop waiting for events pushed by Test Agents and release
+ * the list of Test Agents.
+ *
+ * @param agents        List of Test Agents
+ */
+static void
+tester_serial_agents_stop(tester_serial_agents_t *agents)
+{
+    tester_serial_agent_t *agent;
+    tester_serial_event_t *event;
+
+    while ((agent = SLIST_FIRST(agents)) != NULL)
+    {
+        SLIST_REMOVE_HEAD(agents, links);
+        if (agent->started)
+            pthread_join(agent->thread, NULL);
+        free(agent);
+    }
+
+    while ((event = TAILQ_FIRST(&events)) != NULL)
+    {
+        TAILQ_REMOVE(&events, event, links);
+        free(event->data);
+        free(event);
+    }
+}
+
+/**
+ * Entry point to the Tester thread to handle events of the serial consoles
+ */
+static int
+tester_serial_thread(void)
+{
+    te_errno                rc;
+    int                     period;
+    tester_serial_agents_t  agents;
+    tester_serial_agent_t  *agent;
+    tester_serial_event_t  *event;
+    struct timespec         deadline;
+    te_bool                 warned = FALSE;
+
     SERIAL_WAIT_LOCAL_SEQ(cfg_get_instance_int_fmt(&period,
                                                    "/local:/tester:/period:"));
     if (rc != 0)
@@ -479,94 +876,79 @@ tester_serial_thread(void)
     }
     if (period <= 0)
         period = TESTER_SERIAL_PERIOD;
-    period *= 1000;
+
+    SLIST_INIT(&agents);
 
     while (stop_thread == FALSE)
     {
-        SERIAL_WAIT_LOCAL_SEQ(cfg_find_pattern_fmt(&n_handles, &handles,
-            "/agent:*/parser:*/event:*"));
-
+        rc = tester_serial_agents_update(&agents);
         if (rc != 0)
-            return rc;
-        for (i = 0; (unsigned)i < n_handles; i++)
         {
-            SERIAL_WAIT_LOCAL_SEQ(cfg_get_oid_str(handles[i], &ag_event));
-            if (rc != 0 || ag_event == NULL)
+            if (!warned)
             {
-                ERROR("Couldn't get event oid");
-                continue;
+                WARN("Failed to update list of Test Agents, events of all "
+                     "Test Agents are polled: %r", rc);
+                warned = TRUE;
             }
-
-            SERIAL_WAIT_LOCAL_SEQ(cfg_find_fmt(&status_handle, "%s/status:",
-                                               ag_event));
+            /* Test Agents are unknown, poll all of them */
+            rc = tester_serial_poll("*");
             if (rc != 0)
-            {
-                ERROR("Couldn't get event status handle of %s", ag_event);
-                free(ag_event);
-                continue;
-            }
-            free(ag_event);
+                break;
+        }
 
-            type = CVT_INT32;
-            SERIAL_WAIT_LOCAL_SEQ(cfg_get_instance(status_handle,
-                                                   &type, &status));
-            if (rc != 0)
-            {
-                ERROR("Couldn't get event status %s", te_rc_mod2str(rc));
-                continue;
-            }
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += TE_MS2SEC(period);
+        deadline.tv_nsec += TE_MS2NS(period % 1000);
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
 
-            if (status != 0)
-            {
-                event_name = NULL;
-                type = CVT_STRING;
-                SERIAL_WAIT_LOCAL_SEQ(cfg_get_instance(handles[i], &type,
-                                                       &event_name));
-                if (rc != 0 || event_name == NULL)
-                {
-                    ERROR("Couldn't get the event name");
-                    continue;
-                }
+        pthread_mutex_lock(&events_lock);
+        if (!events_pushed)
+            pthread_cond_timedwait(&events_cond, &events_lock, &deadline);
+        events_pushed = FALSE;
 
-                rc = tester_handle_serial_event(event_name);
-                if (rc != 0 && rc != TE_EFAIL)
-                {
-                    ERROR("Couldn't handle the event %s", event_name);
-                    free(event_name);
-                    continue;
-                }
-                else if (rc == TE_EFAIL)
-                {
-                    free(event_name);
-                    continue;
-                }
+        while ((event = TAILQ_FIRST(&events)) != NULL)
+        {
+            pthread_mutex_unlock(&events_lock);
+            rc = tester_serial_pushed_event_process(event);
+            pthread_mutex_lock(&events_lock);
 
-                type = CVT_INT32;
-                SERIAL_WAIT_LOCAL_SEQ(cfg_set_instance(status_handle, type,
-                                                       FALSE));
-                if (rc != 0)
-                {
-                    ERROR("Couldn't change event %s status", event_name);
-                    free(event_name);
-                    continue;
-                }
+            /* Retry later if the event is not delivered to the test */
+            if (rc == TE_EFAIL)
+                break;
 
-                free(event_name);
-            }
+            TAILQ_REMOVE(&events, event, links);
+            free(event->data);
+            free(event);
         }
+        pthread_mutex_unlock(&events_lock);
 
-        if (handles != NULL)
+        rc = 0;
+        SLIST_FOREACH(agent, &agents, links)
         {
-            free(handles);
-            handles = NULL;
-        }
+            te_bool push;
+
+            pthread_mutex_lock(&events_lock);
+            push = agent->push;
+            pthread_mutex_unlock(&events_lock);
 
-        if (stop_thread != FALSE)
+            if (!push)
+            {
+                rc = tester_serial_poll(agent->name);
+                if (rc != 0)
+                    break;
+            }
+        }
+        if (rc != 0)
             break;
-        usleep(period);
     }
 
-    return 0;
+    tester_serial_agents_stop(&agents);
+
+    return rc;
 }
 
 /* See description in the tester_seria_thread.h */
@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Tester Engine dial history test
+ *
+ * Load data about previous runs of tests from stdin, account
+ * iterations passed in command line as triples
+ * "<test path> <duration> <0|1 (unexpected)>", save the data and
+ * print it to stdout.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "logger_api.h"
+#include "logger_file.h"
+#include "te_str.h"
+#include "dial_history.h"
+
+#define DIAL_HISTORY_BUF_SIZE   4096
+
+/**
+ * Copy contents of one stream to another.
+ *
+ * @param from      Source stream
+ * @param to        Destination stream
+ *
+ * @return 0 on success, -1 on failure
+ */
+static int
+copy_stream(FILE *from, FILE *to)
+{
+    char   buf[DIAL_HISTORY_BUF_SIZE];
+    size_t len;
+
+    while ((len = fread(buf, 1, sizeof(buf), from)) > 0)
+    {
+        if (fwrite(buf, 1, len, to) != len)
+            return -1;
+    }
+
+    return ferror(from) ? -1 : 0;
+}
+
+/**
+ * Main test body.
+ *
+ * @return 0, if success, -1 if not
+ */
+int
+main(int argc, char *argv[])
+{
+    char          in_name[] = "/tmp/dial_history_in_XXXXXX";
+    char          out_name[] = "/tmp/dial_history_out_XXXXXX";
+    dial_history  hist = DIAL_HISTORY_INIT;
+    FILE         *f = NULL;
+    int           fd;
+    int           i;
+    int           result = -1;
+
+    te_log_init("dial_history_test", te_log_message_file);
+
+    if ((argc - 1) % 3 != 0)
+    {
+        ERROR("Iterations must be specified as triples "
+              "<test path> <duration> <unexpected>");
+        return -1;
+    }
+
+    fd = mkstemp(in_name);
+    if (fd < 0 || (f = fdopen(fd, "w")) == NULL ||
+        copy_stream(stdin, f) != 0 || fclose(f) != 0)
+    {
+        ERROR("Failed to store input history in a file");
+        unlink(in_name);
+        return -1;
+    }
+    f = NULL;
+
+    fd = mkstemp(out_name);
+    if (fd < 0)
+    {
+        ERROR("Failed to create output history file");
+        goto cleanup;
+    }
+    close(fd);
+
+    if (dial_history_load(&hist, in_name) != 0)
+    {
+        ERROR("Failed to load history");
+        goto cleanup;
+    }
+
+    for (i = 1; i < argc; i += 3)
+    {
+        double   duration;
+        te_bool  unexpected;
+
+        if (te_strtod(argv[i + 1], &duration) != 0 ||
+            te_strtol_bool(argv[i + 2], &unexpected) != 0)
+        {
+            ERROR("Invalid iteration '%s %s %s'",
+                  argv[i], argv[i + 1], argv[i + 2]);
+            goto cleanup;
+        }
+
+        dial_history_add_iter(&hist, argv[i], duration, unexpected);
+    }
+
+    if (dial_history_save(&hist, out_name) != 0)
+    {
+        ERROR("Failed to save history");
+        goto cleanup;
+    }
+
+    f = fopen(out_name, "r");
+    if (f == NULL || copy_stream(f, stdout) != 0)
+    {
+        ERROR("Failed to print saved history");
+        goto cleanup;
+    }
+
+    result = 0;
+
+cleanup:
+    if (f != NULL)
+        fclose(f);
+    dial_history_free(&hist);
+    unlink(in_name);
+    unlink(out_name);
+
+    return result;
+}
@@ -11,12 +11,17 @@
 #ifndef __TE_COMM_AGENT_H__
 #define __TE_COMM_AGENT_H__
 
+#include <sys/uio.h>
+
 #include "te_errno.h"
 
 /** This structure is used to store some context for each connection. */
 struct rcf_comm_connection;
 typedef struct rcf_comm_connection rcf_comm_connection;
 
+/** Maximum number of buffers passed to rcf_comm_agent_reply_v() */
+#define RCF_COMM_AGENT_IOV_MAX  8
+
 /**
  * Create a listener for accepting connection from RCF in TA.
  *
@@ -48,6 +53,21 @@ extern te_errno rcf_comm_agent_create_listener(int port, int *listener);
 extern int rcf_comm_agent_init(const char *config_str,
                                rcf_comm_connection **p_rcc);
 
+/**
+ * Create a connection handle for an already connected stream socket.
+ * It is used to serve Test Protocol over a connection which is not
+ * established with the Test Engine directly (e.g. between a Test Agent
+ * and its sub-agent).
+ *
+ * @param socket        Connected socket (it is closed by
+ *                      rcf_comm_agent_close())
+ * @param p_rcc         Location for the connection handle
+ *
+ * @return Status code.
+ */
+extern te_errno rcf_comm_agent_attach(int socket,
+                                      rcf_comm_connection **p_rcc);
+
 
 
 /**
@@ -108,6 +128,24 @@ extern int rcf_comm_agent_wait(rcf_comm_connection *rcc,
 extern int rcf_comm_agent_reply(rcf_comm_connection *rcc,
                                 const void *p_buffer, size_t length);
 
+/**
+ * Send reply gathered from several buffers to the Test Engine side of
+ * Network Communication library. The data are written directly from
+ * the buffers, so it is possible to send a big attachment without
+ * copying it after the answer header.
+ *
+ * @param rcc           Handler received from rcf_comm_agent_init.
+ * @param iov           Buffers with reply.
+ * @param iovcnt        Number of buffers (not more than
+ *                      @c RCF_COMM_AGENT_IOV_MAX).
+ *
+ * @return Status code.
+ * @retval 0            Success.
+ * @retval other value  errno.
+ */
+extern int rcf_comm_agent_reply_v(rcf_comm_connection *rcc,
+                                  const struct iovec *iov, int iovcnt);
+
 /**
  * Close connection.
  *
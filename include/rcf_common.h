@@ -27,6 +27,19 @@
 
 #define RCF_MAX_PARAMS      10  /**< Maximum number of routine parameters */
 
+/**
+ * Option of configure get request with a wildcard object instance
+ * identifier: report values of all matching instances together with
+ * their identifiers in a single answer.
+ */
+#define RCF_CONFGET_ALL     "getall"
+
+/**
+ * Option of configure getall request limiting the number of levels
+ * below the last sub-identifier without wildcards: @c "depth=<n>".
+ */
+#define RCF_CONFGET_DEPTH   "depth"
+
 /**
  * Parameter and variable types.
  *
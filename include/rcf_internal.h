@@ -18,6 +18,7 @@
 
 #include "te_stdint.h"
 #include "te_errno.h"
+#include "te_trace.h"
 
 
 #ifdef __cplusplus
@@ -97,6 +98,7 @@ typedef enum {
     RCFOP_TADEAD,           /**< Inform RCF that TA is dead */
     RCFOP_GET_SNIFFERS,     /**< Obtain the list of sniffers */
     RCFOP_GET_SNIF_DUMP,    /**< Pull out capture logs of the sniffer */
+    RCFOP_EVENT_WAIT,       /**< Wait for an event on the Test Agent */
 } rcf_op_t;
 
 
@@ -113,7 +115,7 @@ typedef struct rcf_msg {
                                       or process priority*/
     uint32_t timeout;            /**< Timeout value (RCFOP_TRSEND_RECV,
                                       RCFOP_TRRECV_START, RCFOP_TRPOLL,
-                                      RCFOP_RPC) */
+                                      RCFOP_RPC, RCFOP_EVENT_WAIT) */
     int      intparm;            /**< Integer parameter:
                                        variable type;
                                        routine arguments passing mode;
@@ -126,6 +128,7 @@ typedef struct rcf_msg {
                                        poll request ID (RCFOP_TRPOLL,
                                        RCFOP_TRPOLL_CANCEL) */
     size_t   data_len;          /**< Length of additional data */
+    te_trace_ctx trace;         /**< Trace context of the request */
     char     id[RCF_MAX_ID];    /**< TA type;
                                      variable name;
                                      routine name;
@@ -218,6 +221,7 @@ rcf_op_to_string(rcf_op_t op)
         case RCFOP_KILL:            return "kill";
         case RCFOP_GET_SNIFFERS:    return "get sniffers";
         case RCFOP_GET_SNIF_DUMP:   return "get snif dump";
+        case RCFOP_EVENT_WAIT:      return "event wait";
         default:                    return "(unknown)";
     }
 }
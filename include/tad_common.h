@@ -50,6 +50,20 @@
 #define CSAP_PARAM_LAST_PACKET_TIME     "last_pkt_time"
 #define CSAP_PARAM_NO_MATCH_PKTS        "no_match_pkts"
 
+/**
+ * Statistics of the receive operation reported as
+ * @c "matched=N:unmatched=N:bytes=N:match_ns=N:media_drops=N:
+ * queued=N:queue_max=N:queue_drops=N".
+ */
+#define CSAP_PARAM_RECV_STATS           "recv_stats"
+
+/**
+ * Statistics of the last replay of a capture file by Ethernet-PCAP CSAP
+ * reported as @c "pkts=N:bytes=N:loops=N:requested_ns=N:duration_ns=N:
+ * max_lag_ns=N".
+ */
+#define CSAP_PARAM_REPLAY_STATS         "replay_stats"
+
 /**
  * Type for CSAP handle, should have semantic unsigned integer,
  * because TAD Users Guide specify CSAP ID as positive integer, and
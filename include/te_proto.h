@@ -50,6 +50,17 @@
 #define TE_PROTO_GET_SNIFFERS   "get_sniffers"
 #define TE_PROTO_GET_SNIF_DUMP  "get_snif_dump"
 
+#define TE_PROTO_EVENT_WAIT     "event_wait"
+
+/** Optional prefix of a command with the trace context (see te_trace.h) */
+#define TE_PROTO_TRACE          "TRACE"
+
+/**
+ * First symbol of commands and answers passed via the connection of
+ * a Test Agent to its sub-agent: "@<sub-agent name> SID ..."
+ */
+#define TE_PROTO_SUBAGENT       '@'
+
 #ifdef RCF_NEED_TYPES
 /**
  * Types recoding table.
@@ -327,16 +327,64 @@ extern te_bool agent_check_l4_port_is_free(int socket_family, int socket_type,
 extern te_errno agent_alloc_l4_port(int socket_family, int socket_type,
                                     uint16_t *port);
 
+/**
+ * Allocate a range of consecutive TCP/UDP ports for the TA.
+ * Ports used by sockets in the system are skipped without trying
+ * to bind them (the set of such ports is obtained via sock_diag
+ * netlink and refreshed periodically).
+ *
+ * @param socket_family     Socket family to use, @c AF_INET
+ *                          for IPv4, @c AF_INET6 for IPv6 or @c 0 for IPv6
+ *                          with fallback to IPv4 if IPv6 is not supported.
+ * @param socket_type       Socket type to use, @c SOCK_STREAM, @c SOCK_DGRAM,
+ *                          or @c 0 to check both.
+ * @param n_ports           Number of ports in the range
+ * @param[out] port         The first port of the range in host endian
+ *
+ * @return                  Status code
+ */
+extern te_errno agent_alloc_l4_port_range(int socket_family,
+                                          int socket_type,
+                                          unsigned int n_ports,
+                                          uint16_t *port);
+
+/**
+ * Allocate a range of consecutive TCP/UDP ports for the TA starting
+ * the search from the given port. It allows the Test Engine to keep
+ * ports unique among test agents while the search is done on the TA.
+ *
+ * @param socket_family     Socket family to use, @c AF_INET
+ *                          for IPv4, @c AF_INET6 for IPv6 or @c 0 for IPv6
+ *                          with fallback to IPv4 if IPv6 is not supported.
+ * @param socket_type       Socket type to use, @c SOCK_STREAM, @c SOCK_DGRAM,
+ *                          or @c 0 to check both.
+ * @param n_ports           Number of ports in the range
+ * @param start             Port to start the search from in host endian;
+ *                          if it is out of ports managed by the allocator,
+ *                          the search continues after the previous one
+ *                          as agent_alloc_l4_port_range() does
+ * @param[out] port         The first port of the range in host endian
+ *
+ * @return                  Status code
+ */
+extern te_errno agent_alloc_l4_port_range_from(int socket_family,
+                                               int socket_type,
+                                               unsigned int n_ports,
+                                               uint16_t start,
+                                               uint16_t *port);
+
 /**
  * Free a TCP/UDP port for the TA.
- * The API is used to free the ports allocated by agent_alloc_l4_port().
+ * The API is used to free the ports allocated by agent_alloc_l4_port(),
+ * agent_alloc_l4_port_range() or agent_alloc_l4_specified_port().
  *
  * @param port              Port number in host endian
  */
 extern void agent_free_l4_port(uint16_t port);
 
 /**
- * Allocate the specified TCP/UDP port for TA.
+ * Allocate the specified TCP/UDP port for TA. The port is rejected if
+ * it is allocated before or used by a socket in the system.
  *
  * @param socket_family     Socket family to use, @c AF_INET
  *                          for IPv4, @c AF_INET6 for IPv6 or @c 0 for IPv6
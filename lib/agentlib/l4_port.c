@@ -37,6 +37,13 @@
 #if HAVE_PTHREAD_H
 #include <pthread.h>
 #endif
+#if HAVE_LINUX_SOCK_DIAG_H && HAVE_LINUX_INET_DIAG_H
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#define WITH_SOCK_DIAG 1
+#endif
+#include <time.h>
 
 /**
  * The minimum available port number
@@ -58,15 +65,208 @@
 /* Number of buckets */
 #define BUCKETS_COUNT (AVAILABLE_PORT_COUNT / PORTS_PER_BUCKET_COUNT)
 
+/** Interval of refreshing the set of ports used in the system, ms */
+#define BUSY_PORTS_REFRESH_MS 1000
+
 /* Used to initialize state only once for the TA */
 static te_bool initialization_needed = TRUE;
-/* Number of allocated ports for the TA */
-static unsigned int allocated_ports = 0;
+/* Bitmap of ports allocated by the TA, indexed from MIN_AVAILABLE_PORT */
+static uint8_t allocated_ports[(AVAILABLE_PORT_COUNT + 7) / 8];
+/*
+ * Bitmap of ports used by sockets in the system at the moment of
+ * the last refresh, indexed from MIN_AVAILABLE_PORT
+ */
+static uint8_t busy_ports[(AVAILABLE_PORT_COUNT + 7) / 8];
+/* Time of the last refresh of busy ports, ms */
+static uint64_t busy_ports_refreshed = 0;
 /* Current offset of the next port to allocate for the TA */
 static uint16_t port_offset;
 /* Mutex used to make port allocation thread-safe for the TA */
 static pthread_mutex_t alloc_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/* Check whether the port is in the range managed by the allocator */
+static inline te_bool
+l4_port_in_range(unsigned int port)
+{
+    return port >= MIN_AVAILABLE_PORT && port <= MAX_AVAILABLE_PORT;
+}
+
+/* Check whether a bit corresponding to the port is set */
+static inline te_bool
+l4_port_bit_get(const uint8_t *bitmap, unsigned int port)
+{
+    unsigned int offset = port - MIN_AVAILABLE_PORT;
+
+    return (bitmap[offset / 8] & (1 << (offset % 8))) != 0;
+}
+
+/* Set or clear a bit corresponding to the port */
+static inline void
+l4_port_bit_set(uint8_t *bitmap, unsigned int port, te_bool value)
+{
+    unsigned int offset = port - MIN_AVAILABLE_PORT;
+
+    if (value)
+        bitmap[offset / 8] |= 1 << (offset % 8);
+    else
+        bitmap[offset / 8] &= ~(1 << (offset % 8));
+}
+
+/* Check whether the port may be tried for allocation */
+static inline te_bool
+l4_port_is_candidate(unsigned int port)
+{
+    return !l4_port_bit_get(allocated_ports, port) &&
+           !l4_port_bit_get(busy_ports, port);
+}
+
+#if WITH_SOCK_DIAG
+/**
+ * Mark ports of sockets of a given family and protocol as busy
+ * using sock_diag netlink socket dump.
+ *
+ * @param family        Address family
+ * @param protocol      Transport protocol
+ *
+ * @return Status code.
+ */
+static te_errno
+l4_port_dump_busy(int family, int protocol)
+{
+    struct {
+        struct nlmsghdr         nlh;
+        struct inet_diag_req_v2 req;
+    } request;
+    struct sockaddr_nl addr;
+    char               buf[8192];
+    te_bool            done = FALSE;
+    te_errno           rc = 0;
+    int                fd;
+
+    fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (fd < 0)
+        return TE_OS_RC(TE_TA_UNIX, errno);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+
+    memset(&request, 0, sizeof(request));
+    request.nlh.nlmsg_len = sizeof(request);
+    request.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    request.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.req.sdiag_family = family;
+    request.req.sdiag_protocol = protocol;
+    request.req.idiag_states = ~0U;
+
+    if (sendto(fd, &request, sizeof(request), 0, SA(&addr),
+               sizeof(addr)) < 0)
+    {
+        rc = TE_OS_RC(TE_TA_UNIX, errno);
+        close(fd);
+        return rc;
+    }
+
+    while (!done)
+    {
+        struct nlmsghdr *h;
+        int              len;
+
+        len = recv(fd, buf, sizeof(buf), 0);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            rc = TE_OS_RC(TE_TA_UNIX, errno);
+            break;
+        }
+
+        for (h = (struct nlmsghdr *)buf; NLMSG_OK(h, len);
+             h = NLMSG_NEXT(h, len))
+        {
+            const struct inet_diag_msg *msg;
+            unsigned int                port;
+
+            if (h->nlmsg_type == NLMSG_DONE)
+            {
+                done = TRUE;
+                break;
+            }
+
+            if (h->nlmsg_type == NLMSG_ERROR)
+            {
+                const struct nlmsgerr *err = NLMSG_DATA(h);
+
+                rc = TE_OS_RC(TE_TA_UNIX, -err->error);
+                done = TRUE;
+                break;
+            }
+
+            msg = NLMSG_DATA(h);
+            port = ntohs(msg->id.idiag_sport);
+            if (l4_port_in_range(port))
+                l4_port_bit_set(busy_ports, port, TRUE);
+        }
+    }
+
+    close(fd);
+
+    return rc;
+}
+#endif
+
+/* Get monotonic time in milliseconds */
+static uint64_t
+l4_port_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Refresh the set of ports used by sockets in the system if it is
+ * outdated. The set is only a hint which allows to skip most of busy
+ * ports without trying to bind them; candidates are checked with
+ * agent_check_l4_port_is_free() anyway.
+ */
+static void
+l4_port_refresh_busy(void)
+{
+    uint64_t now = l4_port_now_ms();
+
+    if (busy_ports_refreshed != 0 &&
+        now - busy_ports_refreshed < BUSY_PORTS_REFRESH_MS)
+        return;
+
+    memset(busy_ports, 0, sizeof(busy_ports));
+    busy_ports_refreshed = now;
+
+#if WITH_SOCK_DIAG
+    {
+        static const int families[] = { AF_INET, AF_INET6 };
+        static const int protocols[] = { IPPROTO_TCP, IPPROTO_UDP };
+        unsigned int     i;
+        unsigned int     j;
+
+        for (i = 0; i < TE_ARRAY_LEN(families); i++)
+        {
+            for (j = 0; j < TE_ARRAY_LEN(protocols); j++)
+            {
+                /* Failure is not fatal: e.g. UDP diag may be missing */
+                te_errno rc = l4_port_dump_busy(families[i], protocols[j]);
+
+                if (rc != 0)
+                    VERB("Failed to dump sockets of family %d protocol %d: "
+                         "%r", families[i], protocols[j], rc);
+            }
+        }
+    }
+#endif
+}
+
 static te_errno
 agent_port_alloc_init(void)
 {
@@ -89,13 +289,82 @@ agent_port_alloc_init(void)
     return 0;
 }
 
-te_errno
-agent_alloc_l4_port(int socket_family, int socket_type, uint16_t *port)
+/**
+ * Allocate a range of consecutive ports. It is called with the allocator
+ * lock held.
+ *
+ * @param socket_family     Socket family to use
+ * @param socket_type       Socket type to use
+ * @param n_ports           Number of ports in the range
+ * @param offset            Offset of the first candidate port, updated
+ *                          to the offset following the last tried port
+ * @param[out] port         The first port of the range in host endian
+ *
+ * @return Status code.
+ */
+static te_errno
+l4_port_alloc_range(int socket_family, int socket_type,
+                    unsigned int n_ports, uint16_t *offset, uint16_t *port)
 {
     unsigned int n_ports_tried = 0;
-    uint16_t result;
+    unsigned int n_found = 0;
+    unsigned int first = 0;
+    unsigned int i;
+
+    l4_port_refresh_busy();
+
+    while (n_found < n_ports)
+    {
+        unsigned int candidate;
+
+        if (n_ports_tried++ > AVAILABLE_PORT_COUNT + n_ports)
+        {
+            ERROR("Failed to allocate %u port(s) from all available",
+                  n_ports);
+            return TE_ENOBUFS;
+        }
+
+        candidate = MIN_AVAILABLE_PORT + *offset;
+        *offset = (*offset + 1) % AVAILABLE_PORT_COUNT;
+
+        /* Range cannot wrap around the end of available ports */
+        if (candidate == MIN_AVAILABLE_PORT)
+            n_found = 0;
+
+        if (!l4_port_is_candidate(candidate) ||
+            !agent_check_l4_port_is_free(socket_family, socket_type,
+                                         candidate))
+        {
+            /* Do not try the port again until the next refresh */
+            l4_port_bit_set(busy_ports, candidate, TRUE);
+            n_found = 0;
+            continue;
+        }
+
+        if (n_found++ == 0)
+            first = candidate;
+    }
+
+    for (i = 0; i < n_ports; i++)
+        l4_port_bit_set(allocated_ports, first + i, TRUE);
+
+    *port = first;
+
+    return 0;
+}
+
+/* See description in agentlib.h */
+te_errno
+agent_alloc_l4_port_range_from(int socket_family, int socket_type,
+                               unsigned int n_ports, uint16_t start,
+                               uint16_t *port)
+{
+    uint16_t offset;
     te_errno rc;
 
+    if (n_ports == 0 || n_ports > AVAILABLE_PORT_COUNT)
+        return TE_RC(TE_TA_UNIX, TE_EINVAL);
+
     pthread_mutex_lock(&alloc_lock);
 
     if (initialization_needed)
@@ -108,37 +377,50 @@ agent_alloc_l4_port(int socket_family, int socket_type, uint16_t *port)
         }
     }
 
-    do {
-        if (n_ports_tried++ > AVAILABLE_PORT_COUNT)
-        {
-            ERROR("Failed to allocate port from all available");
-            pthread_mutex_unlock(&alloc_lock);
-            return TE_ENOBUFS;
-        }
+    if (l4_port_in_range(start))
+    {
+        offset = start - MIN_AVAILABLE_PORT;
+        rc = l4_port_alloc_range(socket_family, socket_type, n_ports,
+                                 &offset, port);
+    }
+    else
+    {
+        rc = l4_port_alloc_range(socket_family, socket_type, n_ports,
+                                 &port_offset, port);
+    }
 
-        result = MIN_AVAILABLE_PORT + port_offset;
-        port_offset = (port_offset + 1) % AVAILABLE_PORT_COUNT;
-    } while (!agent_check_l4_port_is_free(socket_family, socket_type, result));
+    pthread_mutex_unlock(&alloc_lock);
 
-    allocated_ports++;
-    *port = result;
+    return rc;
+}
 
-    pthread_mutex_unlock(&alloc_lock);
+/* See description in agentlib.h */
+te_errno
+agent_alloc_l4_port_range(int socket_family, int socket_type,
+                          unsigned int n_ports, uint16_t *port)
+{
+    return agent_alloc_l4_port_range_from(socket_family, socket_type,
+                                          n_ports, 0, port);
+}
 
-    return 0;
+te_errno
+agent_alloc_l4_port(int socket_family, int socket_type, uint16_t *port)
+{
+    return agent_alloc_l4_port_range(socket_family, socket_type, 1, port);
 }
 
 void
 agent_free_l4_port(uint16_t port)
 {
-    UNUSED(port);
+    if (!l4_port_in_range(port))
+        return;
 
     pthread_mutex_lock(&alloc_lock);
 
-    if (allocated_ports > 0)
-        allocated_ports--;
+    if (l4_port_bit_get(allocated_ports, port))
+        l4_port_bit_set(allocated_ports, port, FALSE);
     else
-        ERROR("Failed to free a port, number of frees is greater than allocs");
+        ERROR("Failed to free port %u which is not allocated", port);
 
     pthread_mutex_unlock(&alloc_lock);
 }
@@ -247,23 +529,26 @@ te_errno
 agent_alloc_l4_specified_port(int socket_family, int socket_type,
                               uint16_t port)
 {
-    pthread_mutex_lock(&alloc_lock);
-
-    if (port > MAX_AVAILABLE_PORT && port < MIN_AVAILABLE_PORT)
+    if (!l4_port_in_range(port))
     {
-        ERROR("Invalid port number");
-        pthread_mutex_unlock(&alloc_lock);
-        return TE_EINVAL;
+        /* Ports out of the range are not tracked by the allocator */
+        return agent_check_l4_port_is_free(socket_family, socket_type,
+                                           port) ? 0 : TE_EBUSY;
     }
 
-    if (!agent_check_l4_port_is_free(socket_family, socket_type, port))
+    pthread_mutex_lock(&alloc_lock);
+
+    l4_port_refresh_busy();
+
+    if (!l4_port_is_candidate(port) ||
+        !agent_check_l4_port_is_free(socket_family, socket_type, port))
     {
-        ERROR("The port %s is busy");
+        ERROR("The port %u is busy", port);
         pthread_mutex_unlock(&alloc_lock);
         return TE_EBUSY;
     }
 
-    allocated_ports++;
+    l4_port_bit_set(allocated_ports, port, TRUE);
 
     pthread_mutex_unlock(&alloc_lock);
 
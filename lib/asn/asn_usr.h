@@ -574,6 +574,49 @@ extern asn_value *asn_retrieve_descendant(asn_value *value,
                                           te_errno *status,
                                           const char *labels_fmt, ...);
 
+/**
+ * Compiled labels of subvalue, see asn_path_compile().
+ */
+typedef struct asn_path asn_path;
+
+/**
+ * Compile textual labels of subvalue of values of specified type.
+ * Labels are resolved into child indexes as far as it is possible
+ * using type only; the rest (e.g. labels inside `CHOICE` values
+ * omitted in labels) is resolved when the path is applied to a value.
+ *
+ * Compiled paths are cached per type and are never freed, so it is
+ * cheap to compile the same labels again. Labels passed to
+ * asn_find_descendant(), asn_retrieve_descendant(),
+ * asn_read_value_field() and asn_write_value_field() are compiled
+ * implicitly with indexes of `SEQUENCE_OF` and `SET_OF` values
+ * replaced with `*`, so one compiled path is cached for all indexes.
+ *
+ * @param type          ASN.1 type of root values
+ * @param labels        Labels of subvalue
+ * @param path          Location for compiled path (OUT)
+ *
+ * @return Status code.
+ * @retval TE_ENOSPC    Too many paths are compiled
+ */
+extern te_errno asn_path_compile(const asn_type *type, const char *labels,
+                                 const asn_path **path);
+
+/**
+ * Find descendant value in ASN.1 value tree by compiled labels.
+ * It is the same as asn_find_descendant(), but labels are not
+ * parsed on each call.
+ *
+ * @param value         Root of ASN.1 value tree
+ * @param path          Compiled labels
+ * @param status        Location of status of operation,
+ *                      always changed unless @c NULL (OUT)
+ *
+ * @return pointer to found subvalue.
+ */
+extern asn_value *asn_path_find(const asn_value *value,
+                                const asn_path *path, te_errno *status);
+
 
 
 /**
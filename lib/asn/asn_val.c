@@ -15,6 +15,8 @@
 #include <ctype.h>
 
 #include <stdarg.h>
+#include <limits.h>
+#include <pthread.h>
 
 #include "te_defs.h"
 #include "te_errno.h"
@@ -71,6 +73,10 @@ asn_strdup(const char* src)
     }
 }
 
+static asn_value *asn_find_descendant_labels(const asn_value *value,
+                                             const char *labels,
+                                             te_errno *status);
+
 /**
  * Wrapper over asn_impl_find_subvalue, for find in writable container
  * and get writable subvalue. All parameters are same.
@@ -96,15 +102,12 @@ asn_impl_fall_down_to_tree_writable(asn_value *container,
                                     const char *field_labels,
                                     asn_value **found_value)
 {
-    te_errno rc;
-    char *rest_labels = asn_strdup(field_labels);
-    const asn_value *f_val;
-
-    rc = asn_impl_fall_down_to_tree_nc (container, rest_labels, &f_val);
-    free (rest_labels);
+    te_errno   rc = 0;
+    asn_value *f_val;
 
-    /* Initial container was*/
-    *found_value = (asn_value *)f_val;
+    f_val = asn_find_descendant_labels(container, field_labels, &rc);
+    if (rc == 0)
+        *found_value = f_val;
 
     return rc;
 }
@@ -867,47 +870,331 @@ asn_impl_find_subtype(const asn_type *type, const char *label,
 
 
 
-#define RETURN_NULL_WITH_ERROR(_error) \
-    do {                                \
-        if (status != NULL)             \
-            *status = (_error);         \
-        return NULL;                    \
-    } while(0)
+/** Number of hash buckets in the cache of compiled paths */
+#define ASN_PATH_CACHE_BUCKETS 256
+/** Maximum number of compiled paths in the cache */
+#define ASN_PATH_CACHE_MAX 4096
+/** Maximum number of indexes in labels compiled implicitly */
+#define ASN_PATH_MAX_INDEXES 16
+/** Maximum length of labels compiled implicitly */
+#define ASN_PATH_MAX_LABELS 200
+/** Compiled path has no labels resolved dynamically */
+#define ASN_PATH_NO_REST UINT_MAX
 
+/** Step of compiled path */
+typedef struct asn_path_step {
+    const asn_type *type;       /**< Type of the container */
+    int             index;      /**< Index of the child in the container */
+    te_bool         any_index;  /**< Index is taken from labels the path
+                                     is applied for, see
+                                     asn_path_template() */
+    unsigned int    label_no;   /**< Number of the child label in labels */
+} asn_path_step;
 
-/* see description in asn_usr.h */
-asn_value *
-asn_find_descendant(const asn_value *value, te_errno *status,
-                    const char *labels_fmt, ...)
+/** Compiled labels of subvalue */
+struct asn_path {
+    struct asn_path *next;      /**< Next path in the hash bucket */
+    const asn_type  *type;      /**< Type of root values */
+    char            *labels;    /**< Labels the path is compiled from */
+    unsigned int     rest_no;   /**< Number of the first label which is
+                                     resolved only when the path is
+                                     applied to a value or
+                                     @c ASN_PATH_NO_REST */
+    unsigned int     n_steps;   /**< Number of compiled steps */
+    asn_path_step    steps[];   /**< Compiled steps */
+};
+
+/**
+ * Cache of compiled paths. Paths are never removed from the cache,
+ * so lookup does not require locking; the lock protects insertion only.
+ * Indexes of SEQUENCE_OF and SET_OF values are not a part of cached
+ * labels, so the number of cached paths is limited by the number of
+ * distinct labels used in the code.
+ */
+static asn_path *asn_path_cache[ASN_PATH_CACHE_BUCKETS];
+/** Number of paths in the cache */
+static unsigned int asn_path_cache_size = 0;
+/** Lock protecting insertion into the cache */
+static pthread_mutex_t asn_path_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Get hash bucket of compiled path */
+static unsigned int
+asn_path_hash(const asn_type *type, const char *labels)
 {
-    va_list     list;
-    te_errno    rc = 0;
-    char        labels_buf[200];
-    const char *rest_labels = labels_buf;
-    asn_value  *tmp_value = (asn_value *)value;
-    int         subval_index;
+    uint32_t hash = 2166136261U ^ (uint32_t)((uintptr_t)type >> 4);
 
-    va_start(list, labels_fmt);
-    if (labels_fmt != NULL && labels_fmt[0] != 0)
+    for (; *labels != '\0'; labels++)
     {
-        if (vsnprintf(labels_buf, sizeof(labels_buf), labels_fmt, list) >=
-            (int)sizeof(labels_buf))
-            rc = TE_E2BIG;
+        hash ^= (unsigned char)*labels;
+        hash *= 16777619U;
     }
-    else
-        labels_buf[0] = '\0';
-    va_end(list);
-    if (rc != 0)
-        RETURN_NULL_WITH_ERROR(rc);
 
-    if (status != NULL)
-        *status = 0;
+    return hash % ASN_PATH_CACHE_BUCKETS;
+}
+
+/* Look up compiled path in the hash bucket */
+static const asn_path *
+asn_path_bucket_find(const asn_path *path, const asn_type *type,
+                     const char *labels)
+{
+    for (; path != NULL; path = __atomic_load_n(&path->next,
+                                                __ATOMIC_ACQUIRE))
+    {
+        if (path->type == type && strcmp(path->labels, labels) == 0)
+            return path;
+    }
 
-    if (!value)
-        RETURN_NULL_WITH_ERROR(TE_EWRONGPTR);
+    return NULL;
+}
 
-    if (*labels_buf == '\0')
-        return (asn_value *)value;
+/* Check whether the label is a placeholder of any index */
+static inline te_bool
+asn_path_label_any_index(const char *label)
+{
+    return label[0] == '*' && (label[1] == '\0' || label[1] == '.');
+}
+
+/* Get label by its number in labels */
+static const char *
+asn_path_label_by_no(const char *labels, unsigned int label_no)
+{
+    for (; label_no > 0; label_no--)
+        labels = strchr(labels, '.') + 1;
+
+    return labels;
+}
+
+/**
+ * Make labels template to be compiled: all numeric labels (indexes of
+ * SEQUENCE_OF and SET_OF values) are replaced with '*' and stored
+ * separately, so the same compiled path is used for all indexes.
+ *
+ * @param labels        Labels of subvalue.
+ * @param tmpl          Buffer for the template.
+ * @param tmpl_size     Size of the buffer.
+ * @param indexes       Array for indexes (OUT).
+ * @param n_indexes     Number of indexes (OUT).
+ *
+ * @return @c TRUE if the template is made, @c FALSE if labels should not
+ *         be compiled (too long, too many indexes or '*' in labels).
+ */
+static te_bool
+asn_path_template(const char *labels, char *tmpl, size_t tmpl_size,
+                  int *indexes, unsigned int *n_indexes)
+{
+    const char *label = labels;
+    size_t      len = 0;
+
+    *n_indexes = 0;
+
+    while (TRUE)
+    {
+        const char *end = strchr(label, '.');
+        size_t      label_len;
+        char       *num_end;
+        long        num;
+
+        if (end == NULL)
+            end = label + strlen(label);
+        label_len = end - label;
+
+        if (asn_path_label_any_index(label))
+            return FALSE;
+
+        num = strtol(label, &num_end, 10);
+        if (label_len > 0 && num_end == end)
+        {
+            if (*n_indexes == ASN_PATH_MAX_INDEXES)
+                return FALSE;
+
+            indexes[(*n_indexes)++] = num;
+            label = "*";
+            label_len = 1;
+        }
+
+        /* Place for the label, separator or terminating zero */
+        if (len + label_len + 1 > tmpl_size)
+            return FALSE;
+
+        memcpy(tmpl + len, label, label_len);
+        len += label_len;
+
+        if (*end == '\0')
+            break;
+
+        tmpl[len++] = '.';
+        label = end + 1;
+    }
+
+    tmpl[len] = '\0';
+
+    return TRUE;
+}
+
+/**
+ * Compile labels of subvalue of values of specified type.
+ *
+ * @param type          ASN.1 type of root values.
+ * @param labels        Labels of subvalue.
+ *
+ * @return compiled path or NULL if memory allocation failed.
+ */
+static asn_path *
+asn_path_new(const asn_type *type, const char *labels)
+{
+    asn_path     *path;
+    unsigned int  n_max = 1;
+    unsigned int  label_no = 0;
+    const char   *rest;
+    const char   *p;
+
+    for (p = labels; *p != '\0'; p++)
+    {
+        if (*p == '.')
+            n_max++;
+    }
+
+    path = calloc(1, sizeof(*path) + n_max * sizeof(path->steps[0]));
+    if (path == NULL)
+        return NULL;
+
+    path->type = type;
+    path->labels = asn_strdup(labels);
+    if (path->labels == NULL)
+    {
+        free(path);
+        return NULL;
+    }
+
+    /*
+     * Resolve labels while the type of the child is known. Labels which
+     * are not resolved by type (e.g. omitted CHOICE labels) are resolved
+     * in the same way as asn_find_descendant() does it.
+     */
+    rest = path->labels;
+    while (rest != NULL && *rest != '\0' && type != NULL &&
+           path->n_steps < n_max)
+    {
+        asn_path_step *step = &path->steps[path->n_steps];
+        const char    *next = NULL;
+        int            index = -1;
+
+        if ((type->syntax == SEQUENCE_OF || type->syntax == SET_OF) &&
+            asn_path_label_any_index(rest))
+        {
+            step->any_index = TRUE;
+            index = 0;
+            next = rest[1] == '.' ? rest + 2 : NULL;
+        }
+        else if (asn_child_named_index(type, rest, &index, &next) != 0)
+        {
+            break;
+        }
+
+        if (type->syntax & ASN_SYN_NAMED)
+        {
+            if (index < 0 || (unsigned int)index >= type->len)
+                break;
+        }
+
+        step->type = type;
+        step->index = index;
+        step->label_no = label_no++;
+        path->n_steps++;
+
+        if (type->syntax & ASN_SYN_NAMED)
+            type = type->sp.named_entries[index].type;
+        else
+            type = type->sp.subtype;
+
+        rest = next;
+    }
+
+    path->rest_no = (rest == NULL || *rest == '\0') ? ASN_PATH_NO_REST :
+                                                      label_no;
+
+    return path;
+}
+
+/* See description in asn_usr.h */
+te_errno
+asn_path_compile(const asn_type *type, const char *labels,
+                 const asn_path **path)
+{
+    unsigned int    bucket;
+    const asn_path *found;
+    asn_path       *new_path;
+
+    if (type == NULL || labels == NULL || path == NULL)
+        return TE_EWRONGPTR;
+
+    bucket = asn_path_hash(type, labels);
+    found = asn_path_bucket_find(__atomic_load_n(&asn_path_cache[bucket],
+                                                 __ATOMIC_ACQUIRE),
+                                 type, labels);
+    if (found != NULL)
+    {
+        *path = found;
+        return 0;
+    }
+
+    /* Do not contend for the lock when nothing may be added anyway */
+    if (__atomic_load_n(&asn_path_cache_size,
+                        __ATOMIC_RELAXED) >= ASN_PATH_CACHE_MAX)
+        return TE_ENOSPC;
+
+    pthread_mutex_lock(&asn_path_cache_lock);
+
+    /* The path may be added while the lock is being taken */
+    found = asn_path_bucket_find(asn_path_cache[bucket], type, labels);
+    if (found != NULL)
+    {
+        pthread_mutex_unlock(&asn_path_cache_lock);
+        *path = found;
+        return 0;
+    }
+
+    if (asn_path_cache_size >= ASN_PATH_CACHE_MAX)
+    {
+        pthread_mutex_unlock(&asn_path_cache_lock);
+        return TE_ENOSPC;
+    }
+
+    new_path = asn_path_new(type, labels);
+    if (new_path == NULL)
+    {
+        pthread_mutex_unlock(&asn_path_cache_lock);
+        return TE_ENOMEM;
+    }
+
+    new_path->next = asn_path_cache[bucket];
+    __atomic_store_n(&asn_path_cache[bucket], new_path, __ATOMIC_RELEASE);
+    __atomic_store_n(&asn_path_cache_size, asn_path_cache_size + 1,
+                     __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&asn_path_cache_lock);
+
+    *path = new_path;
+    return 0;
+}
+
+/**
+ * Find descendant value by labels without compiling them.
+ *
+ * @param value         Root of ASN.1 value tree.
+ * @param labels        Labels of subvalue.
+ * @param status        Location for status code (OUT).
+ *
+ * @return pointer to found subvalue or NULL.
+ */
+static asn_value *
+asn_find_descendant_dynamic(const asn_value *value, const char *labels,
+                            te_errno *status)
+{
+    te_errno    rc = 0;
+    const char *rest_labels = labels;
+    asn_value  *tmp_value = (asn_value *)value;
+    int         subval_index;
 
     while (rest_labels != NULL && (*rest_labels != '\0'))
     {
@@ -920,7 +1207,8 @@ asn_find_descendant(const asn_value *value, te_errno *status,
             {
                 if (rest_labels[0] == '#' && rest_labels[1] == '\001')
                     rc = 0;
-                else if ((rc = asn_get_choice_value(tmp_value, &tmp_value,
+                else if ((rc = asn_get_choice_value(tmp_value,
+                                                    &tmp_value,
                                                     NULL, NULL)) == 0)
                     continue;
             }
@@ -933,109 +1221,362 @@ asn_find_descendant(const asn_value *value, te_errno *status,
             break;
     }
 
-    if (rc != 0 && status != NULL)
-        *status = rc;
+    *status = rc;
 
     return (rc == 0) ? tmp_value : NULL;
 }
 
+/**
+ * Find descendant value by compiled labels.
+ *
+ * @param value         Root of ASN.1 value tree.
+ * @param path          Compiled labels.
+ * @param labels        Labels the path is applied for, the same as
+ *                      labels of the path with the exception of indexes.
+ * @param indexes       Indexes replaced with '*' in labels of the path.
+ * @param n_indexes     Number of indexes.
+ * @param status        Location for status code (OUT).
+ *
+ * @return pointer to found subvalue or NULL.
+ */
+static asn_value *
+asn_path_walk(const asn_value *value, const asn_path *path,
+              const char *labels, const int *indexes,
+              unsigned int n_indexes, te_errno *status)
+{
+    asn_value    *tmp_value = (asn_value *)value;
+    unsigned int  rest_no = path->rest_no;
+    unsigned int  next_index = 0;
+    unsigned int  i;
+    te_errno      rc;
+
+    for (i = 0; i < path->n_steps; i++)
+    {
+        const asn_path_step *step = &path->steps[i];
+        int                  index = step->index;
+
+        /* The value may have other type than specified in ASN.1 type */
+        if (tmp_value->asn_type != step->type)
+        {
+            rest_no = step->label_no;
+            break;
+        }
+
+        if (step->any_index)
+        {
+            if (next_index == n_indexes)
+            {
+                *status = TE_EASNWRONGLABEL;
+                return NULL;
+            }
+            index = indexes[next_index++];
+        }
+
+        rc = asn_get_child_by_index(tmp_value, &tmp_value, index);
+        if (rc != 0)
+        {
+            *status = rc;
+            return NULL;
+        }
+    }
 
+    if (rest_no != ASN_PATH_NO_REST)
+    {
+        return asn_find_descendant_dynamic(tmp_value,
+                                           asn_path_label_by_no(labels,
+                                                                rest_no),
+                                           status);
+    }
 
+    *status = 0;
+    return tmp_value;
+}
+
+/**
+ * Find descendant value in ASN.1 value tree by labels, compiled
+ * labels are used if possible.
+ *
+ * @param value         Root of ASN.1 value tree.
+ * @param labels        Labels of subvalue.
+ * @param status        Location for status code (OUT).
+ *
+ * @return pointer to found subvalue or NULL.
+ */
+static asn_value *
+asn_find_descendant_labels(const asn_value *value, const char *labels,
+                           te_errno *status)
+{
+    const asn_path *path;
+    char            tmpl[ASN_PATH_MAX_LABELS];
+    int             indexes[ASN_PATH_MAX_INDEXES];
+    unsigned int    n_indexes;
+
+    if (value == NULL)
+    {
+        *status = TE_EWRONGPTR;
+        return NULL;
+    }
+
+    if (labels == NULL || *labels == '\0')
+    {
+        *status = 0;
+        return (asn_value *)value;
+    }
+
+    if (asn_path_template(labels, tmpl, sizeof(tmpl), indexes,
+                          &n_indexes) &&
+        asn_path_compile(value->asn_type, tmpl, &path) == 0)
+    {
+        return asn_path_walk(value, path, labels, indexes, n_indexes,
+                             status);
+    }
+
+    return asn_find_descendant_dynamic(value, labels, status);
+}
+
+/* See description in asn_usr.h */
 asn_value *
-asn_retrieve_descendant(asn_value *value, te_errno *status,
-                        const char *labels_fmt, ...)
+asn_path_find(const asn_value *value, const asn_path *path,
+              te_errno *status)
+{
+    te_errno   rc;
+    asn_value *found = NULL;
+
+    if (value == NULL || path == NULL)
+        rc = TE_EWRONGPTR;
+    else if (value->asn_type != path->type)
+        rc = TE_EASNWRONGTYPE;
+    else
+        found = asn_path_walk(value, path, path->labels, NULL, 0, &rc);
+
+    if (status != NULL)
+        *status = rc;
+
+    return (rc == 0) ? found : NULL;
+}
+
+#define RETURN_NULL_WITH_ERROR(_error) \
+    do {                                \
+        if (status != NULL)             \
+            *status = (_error);         \
+        return NULL;                    \
+    } while(0)
+
+
+/**
+ * Format labels of descendant value.
+ *
+ * @param buf           Buffer for labels.
+ * @param size          Size of the buffer.
+ * @param labels_fmt    Format string for labels.
+ * @param list          Arguments of the format string.
+ * @param labels        Location for pointer to labels (OUT).
+ *
+ * @return zero on success, otherwise error code.
+ */
+static te_errno
+asn_format_labels(char *buf, size_t size, const char *labels_fmt,
+                  va_list list, const char **labels)
+{
+    if (labels_fmt == NULL || labels_fmt[0] == '\0')
+    {
+        *labels = "";
+        return 0;
+    }
+
+    /* Most of labels are constant strings, do not format them */
+    if (strchr(labels_fmt, '%') == NULL)
+    {
+        *labels = labels_fmt;
+        return 0;
+    }
+
+    if (vsnprintf(buf, size, labels_fmt, list) >= (int)size)
+        return TE_E2BIG;
+
+    *labels = buf;
+    return 0;
+}
+
+/* see description in asn_usr.h */
+asn_value *
+asn_find_descendant(const asn_value *value, te_errno *status,
+                    const char *labels_fmt, ...)
 {
     va_list     list;
-    te_errno    rc = 0;
-    asn_value  *tmp_value;
+    te_errno    rc;
     char        labels_buf[200];
-    const char *rest_labels;
-    int         subval_index;
+    const char *labels;
+    asn_value  *found;
 
     va_start(list, labels_fmt);
-    if (labels_fmt != NULL && labels_fmt[0] != '\0')
-    {
-        if (vsnprintf(labels_buf, sizeof(labels_buf), labels_fmt, list) >=
-            (int)sizeof(labels_buf))
-            rc = TE_E2BIG;
-    }
-    else
-        labels_buf[0] = '\0';
+    rc = asn_format_labels(labels_buf, sizeof(labels_buf), labels_fmt,
+                           list, &labels);
     va_end(list);
-
     if (rc != 0)
         RETURN_NULL_WITH_ERROR(rc);
 
+    found = asn_find_descendant_labels(value, labels, &rc);
+    if (status != NULL)
+        *status = rc;
+
+    return found;
+}
+
+/**
+ * Get child of ASN.1 value by index, create it if it is absent.
+ *
+ * @param container     ASN.1 value which child is interested.
+ * @param index         Index of child.
+ * @param child         Location for the child (OUT).
+ *
+ * @return zero on success, otherwise error code.
+ */
+static te_errno
+asn_retrieve_child(asn_value *container, int index, asn_value **child)
+{
+    const asn_type *new_type;
+    asn_value      *new_value;
+    te_errno        rc;
+
+    rc = asn_get_child_by_index(container, child, index);
+    if (rc != TE_EASNINCOMPLVAL)
+        return rc;
+
+    switch (container->syntax)
+    {
+        case SEQUENCE:
+        case SET:
+        case CHOICE:
+            new_type = container->asn_type->sp.named_entries[index].type;
+            break;
+
+        case SEQUENCE_OF:
+        case SET_OF:
+            new_type = container->asn_type->sp.subtype;
+            break;
+
+        default:
+            return TE_EASNGENERAL;
+    }
+
+    new_value = asn_init_value(new_type);
+    rc = asn_put_child_by_index(container, new_value, index);
+    *child = new_value;
+
+    return rc;
+}
+
+/**
+ * Find descendant value in ASN.1 value tree by labels and create it
+ * if it is absent.
+ *
+ * @param value         Root of ASN.1 value tree.
+ * @param labels        Labels of subvalue.
+ * @param status        Location for status code (OUT).
+ *
+ * @return pointer to found subvalue or NULL.
+ */
+static asn_value *
+asn_retrieve_descendant_labels(asn_value *value, const char *labels,
+                               te_errno *status)
+{
+    te_errno        rc = 0;
+    asn_value      *tmp_value;
+    const char     *rest_labels = labels;
+    const asn_path *path;
+    int             subval_index;
+    char            tmpl[ASN_PATH_MAX_LABELS];
+    int             indexes[ASN_PATH_MAX_INDEXES];
+    unsigned int    n_indexes;
+
     if (value == NULL)
-        RETURN_NULL_WITH_ERROR(TE_EWRONGPTR);
+    {
+        *status = TE_EWRONGPTR;
+        return NULL;
+    }
 
     tmp_value = value;
     asn_clean_count(tmp_value);
 
-    if (status != NULL)
+    if (labels == NULL || *labels == '\0')
+    {
         *status = 0;
+        return tmp_value;
+    }
 
-    if (*labels_buf == '\0')
-        goto end;
-
-    rest_labels = labels_buf;
-    while ((rest_labels != NULL) && (*rest_labels != '\0') && (rc == 0))
+    if (asn_path_template(labels, tmpl, sizeof(tmpl), indexes,
+                          &n_indexes) &&
+        asn_path_compile(value->asn_type, tmpl, &path) == 0)
     {
-        asn_value *new_value;
-        rc = asn_child_named_index(tmp_value->asn_type, rest_labels,
-                                   &subval_index, &rest_labels);
-        if (rc != 0)
-        {
-            break;
-        }
+        unsigned int rest_no = path->rest_no;
+        unsigned int next_index = 0;
+        unsigned int i;
 
-        rc = asn_get_child_by_index(tmp_value, &new_value, subval_index);
-        if (rc == TE_EASNOTHERCHOICE)
-            break;
-        else if (rc == TE_EASNINCOMPLVAL)
+        for (i = 0; i < path->n_steps; i++)
         {
-            const asn_type *new_type;
+            const asn_path_step *step = &path->steps[i];
+            int                  index = step->index;
 
-            rc = 0;
-            switch (tmp_value->syntax)
+            if (tmp_value->asn_type != step->type)
             {
-                case SEQUENCE:
-                case SET:
-                case CHOICE:
-                    {
-                    const asn_named_entry_t *ne =
-                            (tmp_value->asn_type->sp.named_entries) +
-                            subval_index;
-                    new_type = ne->type;
-                    }
-                    break;
+                rest_no = step->label_no;
+                break;
+            }
 
-                case SEQUENCE_OF:
-                case SET_OF:
-                    new_type = tmp_value->asn_type->sp.subtype;
-                    break;
+            /* Templates made from labels have an index for each '*' */
+            if (step->any_index)
+                index = indexes[next_index++];
 
-                default:
-                    rc = TE_EASNGENERAL;
-                    break;
-            }
+            rc = asn_retrieve_child(tmp_value, index, &tmp_value);
             if (rc != 0)
                 break;
-
-            new_value = asn_init_value(new_type);
-            rc = asn_put_child_by_index(tmp_value, new_value, subval_index);
         }
-        tmp_value = new_value;
+
+        rest_labels = (rest_no == ASN_PATH_NO_REST) ? NULL :
+                      asn_path_label_by_no(labels, rest_no);
     }
 
-    if (rc != 0 && status != NULL)
-        *status = rc;
+    while (rc == 0 && (rest_labels != NULL) && (*rest_labels != '\0'))
+    {
+        rc = asn_child_named_index(tmp_value->asn_type, rest_labels,
+                                   &subval_index, &rest_labels);
+        if (rc != 0)
+            break;
+
+        rc = asn_retrieve_child(tmp_value, subval_index, &tmp_value);
+    }
 
-end:
+    *status = rc;
 
     return (rc == 0) ? tmp_value : NULL;
 }
 
+/* see description in asn_usr.h */
+asn_value *
+asn_retrieve_descendant(asn_value *value, te_errno *status,
+                        const char *labels_fmt, ...)
+{
+    va_list     list;
+    te_errno    rc;
+    char        labels_buf[200];
+    const char *labels;
+    asn_value  *found;
+
+    va_start(list, labels_fmt);
+    rc = asn_format_labels(labels_buf, sizeof(labels_buf), labels_fmt,
+                           list, &labels);
+    va_end(list);
+    if (rc != 0)
+        RETURN_NULL_WITH_ERROR(rc);
+
+    found = asn_retrieve_descendant_labels(value, labels, &rc);
+    if (status != NULL)
+        *status = rc;
+
+    return found;
+}
+
 #undef RETURN_NULL_WITH_ERROR
 
 
@@ -1307,7 +1848,7 @@ asn_get_descendent(const asn_value *container,
     if (!container || !found_value)
         return TE_EWRONGPTR;
 
-    *found_value = asn_find_descendant(container, &rc, labels);
+    *found_value = asn_find_descendant_labels(container, labels, &rc);
 
 #else
     const char *rest_labels = labels;
@@ -1714,8 +2255,9 @@ asn_write_value_field(asn_value *container, const void *data, size_t d_len,
 {
 #if AVOID_STRSEP
     te_errno   rc;
-    asn_value *subvalue = asn_retrieve_descendant(container, &rc,
-                                                  field_labels);
+    asn_value *subvalue;
+
+    subvalue = asn_retrieve_descendant_labels(container, field_labels, &rc);
     if (subvalue == NULL)
         return rc;
 
@@ -1983,13 +2525,14 @@ te_errno
 asn_read_value_field(const asn_value *container, void *data, size_t *d_len,
                      const char *field_labels)
 {
-    char *field_labels_int_copy = asn_strdup(field_labels);
-    te_errno rc = asn_impl_read_value_field(container, data, d_len,
-                                            field_labels_int_copy);
+    const asn_value *value;
+    te_errno         rc;
 
-    free(field_labels_int_copy);
+    value = asn_find_descendant_labels(container, field_labels, &rc);
+    if (rc != 0)
+        return rc;
 
-    return rc;
+    return asn_read_primitive(value, data, d_len);
 }
 
 /* See the description in 'asn_usr.h' */
@@ -2041,10 +2584,10 @@ te_errno
 asn_impl_read_value_field(const asn_value *container,  void *data,
                           size_t *d_len, char *field_labels)
 {
-    asn_value *value;
-    te_errno   rc;
+    const asn_value *value;
+    te_errno         rc;
 
-    rc = asn_get_descendent(container, &value, field_labels);
+    value = asn_find_descendant_labels(container, field_labels, &rc);
     if (rc != 0)
         return rc;
 
@@ -2177,8 +2720,9 @@ asn_write_component_value(asn_value *container,
 {
 #if AVOID_STRSEP
     te_errno rc;
-    asn_value *subvalue = asn_retrieve_descendant(container,
-                                                  &rc, subval_labels);
+    asn_value *subvalue = asn_retrieve_descendant_labels(container,
+                                                         subval_labels,
+                                                         &rc);
 
     if (rc != 0)
         return rc;
@@ -2428,6 +2972,7 @@ asn_get_choice_value(const asn_value *container, asn_value **subval,
 }
 
 
+
 /**
  * See description in asn_usr.h
  */
@@ -2793,7 +3338,7 @@ asn_impl_fall_down_to_tree_nc(const asn_value *container, char *field_labels,
 
 #if AVOID_STRSEP
 
-    value = asn_find_descendant(container, &rc, field_labels);
+    value = asn_find_descendant_labels(container, field_labels, &rc);
 #else
 
     char *rest_labels = field_labels;
@@ -245,6 +245,22 @@ rcf_comm_agent_init(const char *config_str,
     return 0;
 }
 
+/* See description in comm_agent.h */
+te_errno
+rcf_comm_agent_attach(int socket, struct rcf_comm_connection **p_rcc)
+{
+    struct rcf_comm_connection *rcc;
+
+    rcc = calloc(1, sizeof(*rcc));
+    if (rcc == NULL)
+        return TE_RC(TE_COMM, TE_ENOMEM);
+
+    rcc->socket = socket;
+    *p_rcc = rcc;
+
+    return 0;
+}
+
 /**
  * Wait for command from the Test Engine via Network Communication library.
  *
@@ -464,6 +480,65 @@ rcf_comm_agent_reply(struct rcf_comm_connection *rcc, const void *buffer,
     return 0;
 }
 
+/* See description in comm_agent.h */
+int
+rcf_comm_agent_reply_v(struct rcf_comm_connection *rcc,
+                       const struct iovec *iov, int iovcnt)
+{
+    struct iovec  vec[RCF_COMM_AGENT_IOV_MAX];
+    struct iovec *cur = vec;
+    ssize_t       sent_len;
+
+    if (iovcnt <= 0)
+        return 0;
+    if (iovcnt > RCF_COMM_AGENT_IOV_MAX)
+        return TE_RC(TE_COMM, TE_EINVAL);
+
+    memcpy(vec, iov, iovcnt * sizeof(*iov));
+#ifdef TE_COMM_DEBUG_PROTO
+    {
+        /* Change \x0 to \n in the answer header before sending */
+        int n = strlen((const char *)vec[0].iov_base);
+
+        assert(n <= vec[0].iov_len);
+        ((char *)vec[0].iov_base)[n] = '\n';
+    }
+#endif
+
+    while (iovcnt > 0)
+    {
+        if (cur->iov_len == 0)
+        {
+            cur++;
+            iovcnt--;
+            continue;
+        }
+
+        sent_len = writev(rcc->socket, cur, iovcnt);
+        if (sent_len < 0)
+        {
+            ERROR("%s(): writev(%d) failed: errno=%d\n",
+                  __FUNCTION__, rcc->socket, errno);
+            return TE_OS_RC(TE_COMM, errno);
+        }
+
+        /* Skip what is sent, the last buffer may be sent partially */
+        while (iovcnt > 0 && (size_t)sent_len >= cur->iov_len)
+        {
+            sent_len -= cur->iov_len;
+            cur++;
+            iovcnt--;
+        }
+        if (sent_len > 0)
+        {
+            cur->iov_base = (uint8_t *)cur->iov_base + sent_len;
+            cur->iov_len -= sent_len;
+        }
+    }
+
+    return 0;
+}
+
 
 
 /**
@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment:
+ *
+ * Test for sending of a reply gathered from several buffers: the answer
+ * header and a big attachment are received by the peer intact although
+ * each writev() call sends only a part of them.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include <sys/uio.h>
+
+static ssize_t test_writev(int fd, const struct iovec *iov, int iovcnt);
+
+/* Library calls writev() which sends at most TEST_CHUNK bytes */
+#define writev test_writev
+#include "../comm_net_agent.c"
+#undef writev
+
+#include <sys/wait.h>
+
+/** Answer header sent before the attachment */
+#define TEST_HDR        "SID 1 0 attach 1048576"
+/** Length of the attachment */
+#define ATTACH_LEN      1048576
+/**
+ * Maximum number of bytes sent by one writev() call, it is not
+ * a multiple of the buffer sizes to split them in the middle
+ */
+#define TEST_CHUNK      1000
+
+/** Number of writev() calls */
+static unsigned int writev_calls;
+
+/* Send at most TEST_CHUNK bytes from the buffers */
+static ssize_t
+test_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    struct iovec vec[RCF_COMM_AGENT_IOV_MAX];
+    size_t       left = TEST_CHUNK;
+    int          n;
+
+    writev_calls++;
+
+    for (n = 0; n < iovcnt && left > 0; n++)
+    {
+        vec[n] = iov[n];
+        if (vec[n].iov_len > left)
+            vec[n].iov_len = left;
+        left -= vec[n].iov_len;
+    }
+
+    return writev(fd, vec, n);
+}
+
+/* Fill the attachment with data which differ at each position */
+static void
+fill_attach(uint8_t *buf, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = (uint8_t)(i * 7 + i / 251);
+}
+
+/* Read the whole reply from the socket and check it */
+static int
+check_reply(int s, const uint8_t *attach)
+{
+    size_t   hdr_len = sizeof(TEST_HDR);
+    size_t   total = hdr_len + ATTACH_LEN;
+    uint8_t *buf;
+    size_t   got = 0;
+    ssize_t  rc;
+    char     extra;
+
+    buf = malloc(total);
+    if (buf == NULL)
+        return -1;
+
+    while (got < total)
+    {
+        rc = read(s, buf + got, total - got);
+        if (rc <= 0)
+        {
+            fprintf(stderr, "Reply is cut after %zu bytes\n", got);
+            free(buf);
+            return -1;
+        }
+        got += rc;
+    }
+
+    if (read(s, &extra, 1) != 0)
+    {
+        fprintf(stderr, "Extra data are sent after the reply\n");
+        free(buf);
+        return -1;
+    }
+
+    if (memcmp(buf, TEST_HDR, hdr_len) != 0 ||
+        memcmp(buf + hdr_len, attach, ATTACH_LEN) != 0)
+    {
+        fprintf(stderr, "Reply is corrupted\n");
+        free(buf);
+        return -1;
+    }
+
+    free(buf);
+    return 0;
+}
+
+int
+main(void)
+{
+    struct rcf_comm_connection  rcc;
+    struct iovec                iov[RCF_COMM_AGENT_IOV_MAX + 1];
+    char                        hdr[] = TEST_HDR;
+    uint8_t                    *attach;
+    int                         s[2];
+    int                         status;
+    pid_t                       pid;
+    int                         result = 1;
+
+    attach = malloc(ATTACH_LEN);
+    if (attach == NULL)
+        return 1;
+    fill_attach(attach, ATTACH_LEN);
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, s) != 0)
+    {
+        perror("socketpair");
+        return 1;
+    }
+
+    memset(&rcc, 0, sizeof(rcc));
+    rcc.socket = s[0];
+
+    /* Too many buffers are rejected without sending anything */
+    memset(iov, 0, sizeof(iov));
+    if (rcf_comm_agent_reply_v(&rcc, iov, RCF_COMM_AGENT_IOV_MAX + 1) == 0)
+    {
+        fprintf(stderr, "Too many buffers are accepted\n");
+        return 1;
+    }
+
+    pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0)
+    {
+        close(s[0]);
+        exit(check_reply(s[1], attach) == 0 ? 0 : 1);
+    }
+    close(s[1]);
+
+    /* Empty buffers in the middle and at the end are skipped */
+    iov[0].iov_base = hdr;
+    iov[0].iov_len = sizeof(hdr);
+    iov[1].iov_base = NULL;
+    iov[1].iov_len = 0;
+    iov[2].iov_base = attach;
+    iov[2].iov_len = ATTACH_LEN / 2;
+    iov[3].iov_base = attach + ATTACH_LEN / 2;
+    iov[3].iov_len = ATTACH_LEN - ATTACH_LEN / 2;
+    iov[4].iov_base = NULL;
+    iov[4].iov_len = 0;
+
+    if (rcf_comm_agent_reply_v(&rcc, iov, 5) != 0)
+    {
+        fprintf(stderr, "Failed to send the reply\n");
+        close(s[0]);
+        waitpid(pid, NULL, 0);
+        goto out;
+    }
+    close(s[0]);
+
+    /* The caller buffers must stay untouched */
+    if (iov[0].iov_base != hdr || iov[0].iov_len != sizeof(hdr) ||
+        iov[2].iov_base != attach || iov[2].iov_len != ATTACH_LEN / 2)
+    {
+        fprintf(stderr, "Buffers of the caller are changed\n");
+        waitpid(pid, NULL, 0);
+        goto out;
+    }
+
+    if (writev_calls < (sizeof(hdr) + ATTACH_LEN) / TEST_CHUNK)
+    {
+        fprintf(stderr, "Reply is sent by %u calls only\n", writev_calls);
+        waitpid(pid, NULL, 0);
+        goto out;
+    }
+
+    if (waitpid(pid, &status, 0) != pid ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        goto out;
+
+    result = 0;
+
+out:
+    free(attach);
+
+    if (result != 0)
+        fprintf(stderr, "Test failed\n");
+    return result;
+}
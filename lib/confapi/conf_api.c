@@ -46,6 +46,7 @@
 #include "te_str.h"
 #include "logger_api.h"
 #include "te_log_stack.h"
+#include "te_trace.h"
 #include "conf_api.h"
 #include "conf_ipc.h"
 #include "conf_messages.h"
@@ -131,6 +132,53 @@ static te_errno kill_all(cfg_handle handle, te_bool local);
 static te_errno kill(cfg_handle handle, te_bool local);
 
 
+/**
+ * Send a message to Configurator via the IPC client and receive
+ * the answer into the same buffer. The request is recorded as
+ * a trace span.
+ *
+ * @param client    IPC client
+ * @param msg       Message to send and buffer for the answer
+ * @param len       On entry - length of the buffer,
+ *                  on exit - length of the answer
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_ipc_client_send_recv(ipc_client *client, cfg_msg *msg, size_t *len)
+{
+    te_trace_span span;
+    te_errno      rc;
+
+    te_trace_span_start(&span, NULL, "confapi.%s",
+                        te_enum_map_from_any_value(cfg_ipc_msg_type_names,
+                                                   msg->type, "unknown"));
+    msg->trace = span.ctx;
+
+    rc = ipc_send_message_with_answer(client, CONFIGURATOR_SERVER,
+                                      msg, msg->len, msg, len);
+
+    te_trace_span_end(&span);
+
+    return rc;
+}
+
+/**
+ * Send a message to Configurator via the common IPC client of
+ * the process, the caller must hold the lock.
+ *
+ * @param msg       Message to send and buffer for the answer
+ * @param len       On entry - length of the buffer,
+ *                  on exit - length of the answer
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_ipc_send_recv(cfg_msg *msg, size_t *len)
+{
+    return cfg_ipc_client_send_recv(cfgl_ipc_client, msg, len);
+}
+
 /* See description in conf_api.h */
 te_errno
 cfg_register_object_str(const char *oid, cfg_obj_descr *descr,
@@ -186,10 +234,7 @@ cfg_register_object_str(const char *oid, cfg_obj_descr *descr,
     msg->len = sizeof(cfg_register_msg) + len + def_val_len;
 
     len = CFG_MSG_MAX;
-    if (((ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                                 CONFIGURATOR_SERVER,
-                                                 msg, msg->len,
-                                                 msg, &len)) == 0) &&
+    if (((ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len)) == 0) &&
         ((ret_val = msg->rc) == 0))
     {
         if (handle != NULL)
@@ -299,9 +344,7 @@ cfg_get_object_descr(cfg_handle handle, cfg_obj_descr *descr)
     msg->handle = handle;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0))
     {
         memcpy((void *)descr, (void *)(&(msg->descr)),
@@ -351,9 +394,7 @@ cfg_get_oid_str(cfg_handle handle, char **oid)
     msg->handle = handle;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0))
     {
         len = strlen(msg->oid) + 1;
@@ -441,9 +482,7 @@ cfg_get_subid(cfg_handle handle, char **subid)
     msg->handle = handle;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0))
     {
         len = strlen(msg->id) + 1;
@@ -502,9 +541,7 @@ cfg_get_inst_name(cfg_handle handle, char **name)
     msg->handle = handle;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0))
     {
         len = strlen(msg->id) + 1;
@@ -614,9 +651,7 @@ cfg_find_str(const char *oid, cfg_handle *handle)
 
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0) && (handle != NULL))
     {
         *handle = msg->handle;
@@ -760,9 +795,7 @@ cfg_find_pattern(const char *pattern, unsigned int *num, cfg_handle **set)
     msg->len = sizeof(cfg_pattern_msg) + len;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (TE_RC_GET_ERROR(ret_val) == TE_ESMALLBUF)
     {
         size_t  rest_len = len - CFG_MSG_MAX;
@@ -913,9 +946,7 @@ cfg_get_family_member(cfg_handle handle, uint8_t who, cfg_handle *member)
     msg->who = who;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0))
     {
         *member = msg->handle;
@@ -1065,9 +1096,7 @@ cfg_add_instance_gen(const char *oid, cfg_handle *handle, te_bool local,
 
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0))
     {
         if (handle != NULL)
@@ -1356,9 +1385,7 @@ kill(cfg_handle handle, te_bool local)
     msg->local = local;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
         ret_val = msg->rc;
 
@@ -1529,9 +1556,7 @@ cfg_set_instance_gen(cfg_handle handle, te_bool local, cfg_val_type type,
 
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
 
 #ifdef HAVE_PTHREAD_H
     pthread_mutex_unlock(&cfgl_lock);
@@ -1639,10 +1664,7 @@ cfg_commit(const char *oid)
 
     len = CFG_MSG_MAX;
 
-    if ((ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                                CONFIGURATOR_SERVER,
-                                                msg, msg->len,
-                                                msg, &len)) == 0)
+    if ((ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len)) == 0)
     {
         ret_val = msg->rc;
         if (ret_val == 0)
@@ -1705,9 +1727,7 @@ cfg_get_instance(cfg_handle handle, cfg_val_type *type, ...)
 
     len = CFG_MSG_MAX;
 
-    rc = ipc_send_message_with_answer(cfgl_ipc_client,
-                                      CONFIGURATOR_SERVER,
-                                      msg, msg->len, msg, &len);
+    rc = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((rc != 0) || ((rc = msg->rc) != 0) ||
         ((rc = cfg_types[msg->val_type].get_from_msg((cfg_msg *)msg,
                                                      &value)) != 0))
@@ -1931,9 +1951,7 @@ cfg_get_instance_sync(cfg_handle handle, cfg_val_type *type, ...)
 
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val != 0) || ((ret_val = msg->rc) != 0) ||
         ((ret_val = cfg_types[msg->val_type].get_from_msg((cfg_msg *)msg,
                                                           &value)) != 0))
@@ -2098,9 +2116,17 @@ cfg_get_addr_sync(struct sockaddr **val, const char *oid_fmt, ...)
     return cfg_get_instance_sync(handle, &type, val);
 }
 
-/* See description in conf_api.h */
-te_errno
-cfg_synchronize(const char *oid, te_bool subtree)
+/**
+ * Send synchronization request to Configurator.
+ *
+ * @param oid        identifier of the object instance or subtree
+ * @param subtree    whether the subtree should be synchronized
+ * @param depth      maximum depth of the subtree, @c 0 for no limit
+ *
+ * @return Status code
+ */
+static te_errno
+cfg_synchronize_gen(const char *oid, te_bool subtree, unsigned int depth)
 {
     cfg_sync_msg *msg;
 
@@ -2126,15 +2152,14 @@ cfg_synchronize(const char *oid, te_bool subtree)
     msg = (cfg_sync_msg *)cfgl_msg_buf;
     msg->type = CFG_SYNC;
     msg->subtree = subtree;
+    msg->depth = depth;
 
     len = strlen(oid) + 1;
     memcpy(msg->oid, oid, len);
     msg->len = sizeof(cfg_sync_msg) + len;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
     {
         ret_val = msg->rc;
@@ -2146,6 +2171,20 @@ cfg_synchronize(const char *oid, te_bool subtree)
     return TE_RC(TE_CONF_API, ret_val);
 }
 
+/* See description in conf_api.h */
+te_errno
+cfg_synchronize(const char *oid, te_bool subtree)
+{
+    return cfg_synchronize_gen(oid, subtree, 0);
+}
+
+/* See description in conf_api.h */
+te_errno
+cfg_synchronize_depth(const char *oid, unsigned int depth)
+{
+    return cfg_synchronize_gen(oid, TRUE, depth);
+}
+
 /* See description in conf_api.h */
 te_errno
 cfg_synchronize_fmt(te_bool subtree, const char *oid_fmt, ...)
@@ -2160,6 +2199,156 @@ cfg_synchronize_fmt(te_bool subtree, const char *oid_fmt, ...)
     return cfg_synchronize(oid, subtree);
 }
 
+/** Subscription to configuration changes */
+struct cfg_subscription {
+    ipc_client     *client; /**< IPC client of the subscription */
+    unsigned int    id;     /**< Subscription ID in Configurator */
+};
+
+/* See description in conf_api.h */
+te_errno
+cfg_subscribe(cfg_subscription **sub, uint32_t sync_period,
+              const char *pattern_fmt, ...)
+{
+    static unsigned int  sub_count = 0;
+    cfg_subscription    *result;
+    cfg_subscribe_msg   *msg;
+    char                 name[32];
+    va_list              ap;
+    size_t               len;
+    int                  n;
+    te_errno             rc;
+
+    msg = TE_ALLOC(CFG_MSG_MAX);
+    msg->type = CFG_SUBSCRIBE;
+    msg->sync_period = sync_period;
+
+    va_start(ap, pattern_fmt);
+    n = vsnprintf(msg->pattern, CFG_MSG_MAX - sizeof(*msg), pattern_fmt, ap);
+    va_end(ap);
+    if (n < 0 || (size_t)n >= CFG_MSG_MAX - sizeof(*msg))
+    {
+        ERROR("%s(): too long OID pattern", __FUNCTION__);
+        free(msg);
+        return TE_RC(TE_CONF_API, TE_EINVAL);
+    }
+    msg->len = sizeof(*msg) + n + 1;
+
+    result = TE_ALLOC(sizeof(*result));
+
+    TE_SPRINTF(name, "cfg_sub_%u_%u", (unsigned int)getpid(),
+               __atomic_add_fetch(&sub_count, 1, __ATOMIC_RELAXED));
+    rc = ipc_init_client(name, CONFIGURATOR_IPC, &result->client);
+    if (rc != 0)
+    {
+        ERROR("%s(): failed to create IPC client: %r", __FUNCTION__, rc);
+        free(result);
+        free(msg);
+        return TE_RC(TE_CONF_API, TE_EIPC);
+    }
+
+    len = CFG_MSG_MAX;
+    rc = cfg_ipc_client_send_recv(result->client, (cfg_msg *)msg, &len);
+    if (rc == 0)
+        rc = msg->rc;
+
+    if (rc != 0)
+    {
+        ipc_close_client(result->client);
+        free(result);
+    }
+    else
+    {
+        result->id = msg->id;
+        *sub = result;
+    }
+
+    free(msg);
+
+    return TE_RC(TE_CONF_API, rc);
+}
+
+/* See description in conf_api.h */
+te_errno
+cfg_subscription_wait(cfg_subscription *sub, uint32_t timeout_ms,
+                      cfg_change_cb cb, void *opaque)
+{
+    cfg_sub_wait_msg *msg;
+    const char       *p;
+    const char       *end;
+    size_t            len = CFG_SUB_WAIT_MAX_LEN;
+    te_errno          rc;
+
+    if (sub == NULL)
+        return TE_RC(TE_CONF_API, TE_EINVAL);
+
+    msg = TE_ALLOC(CFG_SUB_WAIT_MAX_LEN);
+    msg->type = CFG_SUB_WAIT;
+    msg->id = sub->id;
+    msg->timeout = timeout_ms;
+    msg->len = sizeof(*msg);
+
+    rc = cfg_ipc_client_send_recv(sub->client, (cfg_msg *)msg, &len);
+    if (rc == 0)
+        rc = TE_RC_GET_ERROR(msg->rc);
+
+    if (rc == 0)
+    {
+        unsigned int i;
+
+        end = (const char *)msg + MIN(len, msg->len);
+        for (i = 0, p = msg->changes;
+             cb != NULL && i < msg->n_changes && p < end; i++)
+        {
+            const char *oid = p + 1;
+
+            rc = cb(*p, oid, opaque);
+            if (rc != 0)
+                break;
+
+            p = oid + strlen(oid) + 1;
+        }
+
+        if (rc == 0 && msg->lost)
+        {
+            WARN("%s(): some configuration changes are lost",
+                 __FUNCTION__);
+            rc = TE_ENOBUFS;
+        }
+    }
+
+    free(msg);
+
+    return TE_RC(TE_CONF_API, rc);
+}
+
+/* See description in conf_api.h */
+void
+cfg_unsubscribe(cfg_subscription *sub)
+{
+    cfg_unsubscribe_msg msg;
+    size_t              len = sizeof(msg);
+    te_errno            rc;
+
+    if (sub == NULL)
+        return;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.type = CFG_UNSUBSCRIBE;
+    msg.id = sub->id;
+    msg.len = sizeof(msg);
+
+    rc = cfg_ipc_client_send_recv(sub->client, (cfg_msg *)&msg, &len);
+    if (rc == 0)
+        rc = msg.rc;
+    if (rc != 0)
+        ERROR("%s(): failed to remove subscription: %r", __FUNCTION__, rc);
+
+    /* Configurator removes the subscription of a closed client anyway */
+    ipc_close_client(sub->client);
+    free(sub);
+}
+
 /* See description in conf_api.h */
 te_errno
 cfg_enumerate(cfg_handle handle, cfg_inst_handler callback,
@@ -2291,9 +2480,7 @@ cfg_reboot_ta(const char *ta_name, te_bool restore,
     msg->len = sizeof(cfg_reboot_msg) + len;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
     {
         ret_val = msg->rc;
@@ -2339,9 +2526,7 @@ cfg_create_backup(char **name)
     msg->filename_offset = msg->len;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if ((ret_val == 0) && ((ret_val = msg->rc) == 0))
     {
         len = msg->len - msg->filename_offset;
@@ -2420,9 +2605,7 @@ cfg_backup(const char *oid, const char *name, uint8_t op)
     memcpy((char *)msg + msg->filename_offset, name, len);
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
     {
         ret_val = msg->rc;
@@ -2522,9 +2705,7 @@ cfg_create_config(const char *name, te_bool history)
     msg->len = sizeof(cfg_config_msg) + len;
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
     {
         ret_val = msg->rc;
@@ -2592,9 +2773,7 @@ cfg_process_history(const char *filename, const te_kvpair_h *expand_vars)
     }
     len = CFG_MSG_MAX;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
         ret_val = msg->rc;
 
@@ -2645,9 +2824,7 @@ cfg_wait_changes(void)
     msg->type = CFG_CONF_DELAY;
     msg->len = sizeof(*msg);
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
     {
         ret_val = msg->rc;
@@ -2691,9 +2868,7 @@ cfg_touch_instance(const char *oid_tmpl, ...)
 
     msg->len = sizeof(*msg) + strlen(msg->oid) + 1;
 
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
     {
         ret_val = msg->rc;
@@ -2764,9 +2939,7 @@ cfg_tree_print(const char *filename,
     msg->len = sizeof(cfg_tree_print_msg) + id_len + flname_len;
 
     len = CFG_MSG_MAX;
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
         ret_val = msg->rc;
 
@@ -2822,9 +2995,7 @@ cfg_unregister_object_str(const char *id_fmt, ...)
     msg->len = sizeof(cfg_unregister_msg) + id_len;
 
     len = CFG_MSG_MAX;
-    ret_val = ipc_send_message_with_answer(cfgl_ipc_client,
-                                           CONFIGURATOR_SERVER,
-                                           msg, msg->len, msg, &len);
+    ret_val = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (ret_val == 0)
         ret_val = msg->rc;
 
@@ -2894,9 +3065,7 @@ cfg_copy_subtree_fmt(const char *dst_oid,
     }
 
     len = CFG_MSG_MAX;
-    rc = ipc_send_message_with_answer(cfgl_ipc_client,
-                                      CONFIGURATOR_SERVER,
-                                      msg, msg->len, msg, &len);
+    rc = cfg_ipc_send_recv((cfg_msg *)msg, &len);
     if (rc == 0)
         rc = msg->rc;
 
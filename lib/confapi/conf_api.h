@@ -865,6 +865,125 @@ extern te_errno cfg_synchronize(const char *oid, te_bool subtree);
 extern te_errno cfg_synchronize_fmt(te_bool subtree, const char *oid_fmt, ...)
                                     __attribute__((format(printf, 2, 3)));
 
+/**
+ * Synchronize Configurator database with managed objects in a subtree
+ * up to the specified depth. Instances deeper than @p depth levels
+ * below the subtree root are neither added nor removed. If the Test
+ * Agent cannot limit the depth, the whole subtree is synchronized.
+ *
+ * @param oid        identifier of the subtree root
+ * @param depth      maximum number of levels below the root,
+ *                   @c 0 for no limit
+ *
+ * @return Status code (see te_errno.h)
+ */
+extern te_errno cfg_synchronize_depth(const char *oid, unsigned int depth);
+
+/**@}*/
+
+/** @defgroup confapi_base_sub Subscription to configuration changes
+ * @ingroup confapi_base
+ * @{
+ *
+ * A subscription allows to wait for changes of instances matching
+ * an OID pattern in one blocking call instead of polling Configurator
+ * in a loop with cfg_synchronize() and cfg_get_instance().
+ *
+ * Changes are reported for instances added, deleted or changed in
+ * the Configurator database. Changes done by non-CS means on Test
+ * Agents are noticed when the subtree is synchronized: either by
+ * somebody else or periodically by Configurator itself while
+ * the subscriber waits (see @p sync_period of cfg_subscribe()).
+ *
+ * @code
+ * cfg_subscription *sub;
+ *
+ * CHECK_RC(cfg_subscribe(&sub, 100, "/agent:%s/interface:%s/status:",
+ *                        ta, if_name));
+ * rc = cfg_subscription_wait(sub, 5000, link_changed, &status);
+ * cfg_unsubscribe(sub);
+ * @endcode
+ */
+
+/** Type of a configuration change */
+typedef enum cfg_change_type {
+    CFG_CHANGE_ADD = 1, /**< Instance is added */
+    CFG_CHANGE_DEL,     /**< Instance is deleted */
+    CFG_CHANGE_SET,     /**< Instance value is changed */
+} cfg_change_type;
+
+/** Subscription to configuration changes */
+typedef struct cfg_subscription cfg_subscription;
+
+/**
+ * Callback called for each configuration change.
+ *
+ * @param type      Change type
+ * @param oid       Instance OID
+ * @param opaque    Opaque data passed to cfg_subscription_wait()
+ *
+ * @return Status code, non-zero status stops processing of changes
+ *         and is returned by cfg_subscription_wait() (@c TE_EOK may be
+ *         used to stop without an error).
+ */
+typedef te_errno (*cfg_change_cb)(cfg_change_type type, const char *oid,
+                                  void *opaque);
+
+/**
+ * Subscribe to changes of instances matching a pattern and
+ * their descendants.
+ *
+ * Each subscription has its own connection to Configurator, so that
+ * waiting for changes does not block other Configurator API calls of
+ * the process. A subscription must not be used from several threads
+ * simultaneously.
+ *
+ * @param[out] sub          Location for the subscription
+ * @param sync_period       Period of synchronization of the subscribed
+ *                          Test Agent subtree while the subscriber waits,
+ *                          milliseconds (@c 0 - do not synchronize).
+ *                          The subtree is the longest prefix of
+ *                          the pattern without wildcards except
+ *                          the agent name.
+ * @param pattern_fmt       Format string of instance OID pattern, each
+ *                          sub-identifier and instance name may be '*'
+ * @param ...               Format arguments
+ *
+ * @return Status code.
+ */
+extern te_errno cfg_subscribe(cfg_subscription **sub, uint32_t sync_period,
+                              const char *pattern_fmt, ...)
+                              __attribute__((format(printf, 3, 4)));
+
+/**
+ * Wait for changes and call the callback for each of them. Changes
+ * which happened since the subscription or the previous wait are
+ * reported immediately.
+ *
+ * @param sub           Subscription
+ * @param timeout_ms    Timeout, milliseconds
+ * @param cb            Callback to be called for each change or @c NULL
+ *                      if only the fact of changes matters
+ * @param opaque        Opaque data for the callback
+ *
+ * @return Status code.
+ * @retval TE_ETIMEDOUT     No changes during the timeout.
+ * @retval TE_ENOBUFS       Some changes were lost since too many
+ *                          changes were queued; the changes which were
+ *                          not lost are passed to the callback anyway,
+ *                          the caller should re-read the subtree.
+ */
+extern te_errno cfg_subscription_wait(cfg_subscription *sub,
+                                      uint32_t timeout_ms,
+                                      cfg_change_cb cb, void *opaque);
+
+/**
+ * Remove the subscription and free its resources.
+ *
+ * @param sub           Subscription (may be @c NULL)
+ */
+extern void cfg_unsubscribe(cfg_subscription *sub);
+
 /**@}*/
 
 /** @addtogroup confapi_base_traverse
@@ -10,6 +10,38 @@
 #include "conf_ipc.h"
 #include "te_str.h"
 
+/* See description in conf_ipc.h */
+const te_enum_map cfg_ipc_msg_type_names[] = {
+    {.name = "register",        .value = CFG_REGISTER},
+    {.name = "unregister",      .value = CFG_UNREGISTER},
+    {.name = "find",            .value = CFG_FIND},
+    {.name = "get_descr",       .value = CFG_GET_DESCR},
+    {.name = "get_oid",         .value = CFG_GET_OID},
+    {.name = "get_id",          .value = CFG_GET_ID},
+    {.name = "pattern",         .value = CFG_PATTERN},
+    {.name = "family",          .value = CFG_FAMILY},
+    {.name = "add",             .value = CFG_ADD},
+    {.name = "del",             .value = CFG_DEL},
+    {.name = "set",             .value = CFG_SET},
+    {.name = "commit",          .value = CFG_COMMIT},
+    {.name = "get",             .value = CFG_GET},
+    {.name = "copy",            .value = CFG_COPY},
+    {.name = "sync",            .value = CFG_SYNC},
+    {.name = "reboot",          .value = CFG_REBOOT},
+    {.name = "backup",          .value = CFG_BACKUP},
+    {.name = "config",          .value = CFG_CONFIG},
+    {.name = "conf_touch",      .value = CFG_CONF_TOUCH},
+    {.name = "conf_delay",      .value = CFG_CONF_DELAY},
+    {.name = "shutdown",        .value = CFG_SHUTDOWN},
+    {.name = "add_dependency",  .value = CFG_ADD_DEPENDENCY},
+    {.name = "tree_print",      .value = CFG_TREE_PRINT},
+    {.name = "process_history", .value = CFG_PROCESS_HISTORY},
+    {.name = "subscribe",       .value = CFG_SUBSCRIBE},
+    {.name = "unsubscribe",     .value = CFG_UNSUBSCRIBE},
+    {.name = "sub_wait",        .value = CFG_SUB_WAIT},
+    TE_ENUM_MAP_END
+};
+
 /* See description in conf_ipc.h */
 te_errno
 cfg_ipc_mk_get(cfg_get_msg *msg, size_t msg_buf_size,
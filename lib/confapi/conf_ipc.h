@@ -17,6 +17,12 @@
 extern "C" {
 #endif
 
+/**
+ * Short names of Configurator message types used in names of
+ * performance counters and trace spans.
+ */
+extern const te_enum_map cfg_ipc_msg_type_names[];
+
 /**
  * Prepare a cfg_get_instance message.
  *
@@ -12,6 +12,7 @@
 #define __TE_CONF_MESSAGES_H__
 
 #include "conf_api.h"
+#include "te_trace.h"
 
 #ifdef HAVE_SYS_SOCKET_H
 #include <sys/socket.h>
@@ -71,13 +72,25 @@ enum {
     CFG_TREE_PRINT,/**< Print a tree of obj|ins from a prefix */
     CFG_PROCESS_HISTORY,/**< Process history configuration file
                              IN: file name, key-value pairs to substitute */
+    CFG_SUBSCRIBE, /**< Subscribe to changes: IN: OID pattern,
+                        synchronization period; OUT: subscription ID */
+    CFG_UNSUBSCRIBE, /**< Remove subscription: IN: subscription ID */
+    CFG_SUB_WAIT,  /**< Wait for changes: IN: subscription ID, timeout;
+                        OUT: changes */
 };
 
+/**
+ * Maximum length of CFG_SUB_WAIT answer, changes which do not fit
+ * are delivered by the next wait.
+ */
+#define CFG_SUB_WAIT_MAX_LEN    4096
+
 /* Set of generic fields of the Configurator message */
 #define CFG_MSG_FIELDS \
     uint8_t     type;    /**< Message type */                       \
     uint32_t    len;     /**< Length of the whole message */        \
     int         rc;      /**< OUT: errno defined in te_errno.h */   \
+    te_trace_ctx trace;  /**< IN: trace context of the request */   \
 
 /** Generic Configurator message structure */
 typedef struct cfg_msg {
@@ -248,8 +261,10 @@ typedef struct cfg_copy_msg {
 /** CFG_SYNC message content  */
 typedef struct cfg_sync_msg {
     CFG_MSG_FIELDS
-    te_bool subtree;  /**< subtree synchronization*/
-    char    oid[0];   /**< start of object identifier */
+    te_bool      subtree;  /**< subtree synchronization*/
+    unsigned int depth;    /**< maximum depth of subtree synchronization,
+                                0 for no limit */
+    char         oid[0];   /**< start of object identifier */
 } cfg_sync_msg;
 
 /** CFG_REBOOT message content  */
@@ -330,6 +345,36 @@ typedef struct cfg_process_history_msg {
     char    filename[0]; /**< IN: file name */
 } cfg_process_history_msg;
 
+/** CFG_SUBSCRIBE message content */
+typedef struct cfg_subscribe_msg {
+    CFG_MSG_FIELDS
+    uint32_t      sync_period; /**< IN: period of synchronization of
+                                    the subscribed subtree with Test
+                                    Agents while somebody waits for
+                                    changes, milliseconds (@c 0 - do not
+                                    synchronize) */
+    unsigned int  id;          /**< OUT: subscription ID */
+    char          pattern[0];  /**< IN: OID pattern */
+} cfg_subscribe_msg;
+
+/** CFG_UNSUBSCRIBE message content */
+typedef struct cfg_unsubscribe_msg {
+    CFG_MSG_FIELDS
+    unsigned int  id;       /**< IN: subscription ID */
+} cfg_unsubscribe_msg;
+
+/** CFG_SUB_WAIT message content */
+typedef struct cfg_sub_wait_msg {
+    CFG_MSG_FIELDS
+    unsigned int  id;        /**< IN: subscription ID */
+    uint32_t      timeout;   /**< IN: timeout, milliseconds */
+    te_bool       lost;      /**< OUT: some changes were not queued */
+    uint32_t      n_changes; /**< OUT: number of changes */
+    char          changes[0]; /**< OUT: changes, each one is a byte with
+                                   change type (cfg_change_type)
+                                   followed by zero-terminated OID */
+} cfg_sub_wait_msg;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -108,6 +108,34 @@ extern te_bool ipc_is_server_ready(struct ipc_server *ipcs,
 extern const char *
     ipc_server_client_name(const struct ipc_server_client *ipcsc);
 
+/**
+ * Get identifier of the IPC server client. Clients of connection-oriented
+ * servers are freed when they close the connection and the memory may be
+ * reused for a new client, so the server user which defers an answer
+ * should keep the identifier rather than the pointer. Identifiers are
+ * never reused within the process.
+ *
+ * @param ipcsc         Pointer to the ipc_server_client structure
+ *                      returned by ipc_receive_message()
+ *
+ * @return Client identifier, @c 0 if @p ipcsc is @c NULL
+ */
+extern unsigned int ipc_server_client_id(
+                        const struct ipc_server_client *ipcsc);
+
+/**
+ * Find the IPC server client by its identifier.
+ *
+ * @param ipcs          Pointer to the ipc_server structure returned
+ *                      by ipc_register_server()
+ * @param id            Client identifier, see ipc_server_client_id()
+ *
+ * @return Pointer to the client or @c NULL if it does not exist any more
+ */
+extern struct ipc_server_client *ipc_server_client_by_id(
+                                     const struct ipc_server *ipcs,
+                                     unsigned int id);
+
 /**
  * Receive a message from IPC client.
  *
@@ -84,6 +84,9 @@ struct ipc_server_client {
     /** Links to neighbour clients in the list */
     LIST_ENTRY(ipc_server_client)   links;
 
+    /** Identifier of the client, never reused */
+    unsigned int                    id;
+
 #ifdef TE_IPC_AF_UNIX
     struct sockaddr_un  sa;         /**< Address of the sender */
     socklen_t           sa_len;     /**< Length of the sockaddr_un struct */
@@ -144,6 +147,9 @@ struct ipc_server {
 };
 
 
+/** Identifier of the last created client of any IPC server */
+static unsigned int ipc_server_client_last_id = 0;
+
 /*
  * Static functions declaration.
  */
@@ -510,6 +516,31 @@ ipc_server_client_name(const struct ipc_server_client *ipcsc)
 #endif
 }
 
+/* See description in ipc_server.h */
+unsigned int
+ipc_server_client_id(const struct ipc_server_client *ipcsc)
+{
+    return ipcsc == NULL ? 0 : ipcsc->id;
+}
+
+/* See description in ipc_server.h */
+struct ipc_server_client *
+ipc_server_client_by_id(const struct ipc_server *ipcs, unsigned int id)
+{
+    struct ipc_server_client *client;
+
+    if (ipcs == NULL || id == 0)
+        return NULL;
+
+    LIST_FOREACH(client, &ipcs->clients, links)
+    {
+        if (client->id == id)
+            return client;
+    }
+
+    return NULL;
+}
+
 /* See description in ipc_server.h */
 int
 ipc_receive_message(struct ipc_server *ipcs,
@@ -899,6 +930,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
 
             client = calloc(1, sizeof(*client));
             assert(client != NULL);
+            client->id = ++ipc_server_client_last_id;
 
 #ifdef TE_IPC_AF_UNIX
             client->sa_len = sizeof(client->sa);
@@ -1067,6 +1099,7 @@ ipc_int_client_by_addr(struct ipc_server *ipcs,
         ipcsc = calloc(1, sizeof(*ipcsc));
         if (ipcsc != NULL)
         {
+            ipcsc->id = ++ipc_server_client_last_id;
             ipcsc->sa     = *sa_ptr;
             ipcsc->sa_len = sa_len;
             ipcsc->dgram.buffer = calloc(1, IPC_SEGMENT_SIZE);
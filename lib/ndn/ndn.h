@@ -33,8 +33,22 @@ typedef enum {
     NDN_CSAP_PARAMS,
     NDN_CSAP_RECV_TIMEOUT,
     NDN_CSAP_STOP_LATENCY_TIMEOUT,
+    NDN_CSAP_RECV_QUEUE_LIMIT,
+    NDN_CSAP_RECV_QUEUE_POLICY,
 } ndn_message_tags_t;
 
+/**
+ * Policies applied by CSAP when the queue of received packets
+ * reaches its limit.
+ */
+typedef enum ndn_csap_recv_queue_policy {
+    NDN_CSAP_RECV_QUEUE_DROP_OLDEST,    /**< Drop the oldest packet
+                                             in the queue */
+    NDN_CSAP_RECV_QUEUE_PAUSE,          /**< Stop reading from the media
+                                             until packets are got
+                                             from the queue */
+} ndn_csap_recv_queue_policy;
+
 
 /**
  * ASN.1 tag values for DATA-UNIT choice, see definition of DATA-UNIT
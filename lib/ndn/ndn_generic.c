@@ -183,11 +183,26 @@ asn_type ndn_csap_layers_s = {
 const asn_type * const ndn_csap_layers = &ndn_csap_layers_s;
 
 
+static asn_enum_entry_t _ndn_csap_recv_queue_policy_enum_entries[] = {
+    { "drop-oldest", NDN_CSAP_RECV_QUEUE_DROP_OLDEST },
+    { "pause",       NDN_CSAP_RECV_QUEUE_PAUSE },
+};
+
+static asn_type ndn_csap_recv_queue_policy_s = {
+    "CSAP-Recv-Queue-Policy", { PRIVATE, NDN_CSAP_RECV_QUEUE_POLICY },
+    ENUMERATED, TE_ARRAY_LEN(_ndn_csap_recv_queue_policy_enum_entries),
+    { .enum_entries = _ndn_csap_recv_queue_policy_enum_entries }
+};
+
 static asn_named_entry_t _ndn_csap_params_ne_array[] = {
     { "receive-timeout-ms", &asn_base_integer_s,
       { PRIVATE, NDN_CSAP_RECV_TIMEOUT } },
     { "stop-latency-timeout-ms", &asn_base_integer_s,
       { PRIVATE, NDN_CSAP_STOP_LATENCY_TIMEOUT } },
+    { "recv-queue-limit", &asn_base_integer_s,
+      { PRIVATE, NDN_CSAP_RECV_QUEUE_LIMIT } },
+    { "recv-queue-policy", &ndn_csap_recv_queue_policy_s,
+      { PRIVATE, NDN_CSAP_RECV_QUEUE_POLICY } },
 };
 
 static asn_type ndn_csap_params_s = {
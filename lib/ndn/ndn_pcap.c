@@ -22,12 +22,77 @@
 
 
 /**
- * PCAP filter (matching string) definition
+ * Rewriting of addresses and ports of a flow in replayed packets.
+ * Addresses are IPv4 or IPv6 ones in network byte order.
+ */
+static asn_named_entry_t _ndn_pcap_rewrite_ne_array[] = {
+    { "src-addr",       &asn_base_octstring_s, {PRIVATE, 1} },
+    { "dst-addr",       &asn_base_octstring_s, {PRIVATE, 2} },
+    { "src-port",       &asn_base_integer_s, {PRIVATE, 3} },
+    { "dst-port",       &asn_base_integer_s, {PRIVATE, 4} },
+    { "new-src-addr",   &asn_base_octstring_s, {PRIVATE, 5} },
+    { "new-dst-addr",   &asn_base_octstring_s, {PRIVATE, 6} },
+    { "new-src-port",   &asn_base_integer_s, {PRIVATE, 7} },
+    { "new-dst-port",   &asn_base_integer_s, {PRIVATE, 8} },
+};
+
+asn_type ndn_pcap_rewrite_s = {
+    "PCAP-Rewrite", {PRIVATE, 102}, SEQUENCE,
+    TE_ARRAY_LEN(_ndn_pcap_rewrite_ne_array),
+    {_ndn_pcap_rewrite_ne_array}
+};
+
+const asn_type * const ndn_pcap_rewrite = &ndn_pcap_rewrite_s;
+
+static asn_type ndn_pcap_rewrite_seq_s = {
+    "SEQUENCE OF PCAP-Rewrite", {PRIVATE, 103}, SEQUENCE_OF, 0,
+    {.subtype = &ndn_pcap_rewrite_s}
+};
+
+static asn_enum_entry_t _ndn_pcap_replay_timing_enum_entries[] = {
+    { "original",   NDN_PCAP_REPLAY_ORIGINAL },
+    { "scaled",     NDN_PCAP_REPLAY_SCALED },
+    { "max-rate",   NDN_PCAP_REPLAY_MAX_RATE },
+};
+
+static asn_type ndn_pcap_replay_timing_s = {
+    "PCAP-Replay-Timing", {PRIVATE, 104}, ENUMERATED,
+    TE_ARRAY_LEN(_ndn_pcap_replay_timing_enum_entries),
+    { .enum_entries = _ndn_pcap_replay_timing_enum_entries }
+};
+
+/**
+ * Replay of a pcap/pcapng capture file located on the Test Agent.
+ * Speed is in percents of the original one and is used with
+ * scaled timing only. Zero number of loops means replay until stop.
+ */
+static asn_named_entry_t _ndn_pcap_replay_ne_array[] = {
+    { "file",       &asn_base_charstring_s, {PRIVATE, 1} },
+    { "timing",     &ndn_pcap_replay_timing_s, {PRIVATE, 2} },
+    { "speed",      &asn_base_integer_s, {PRIVATE, 3} },
+    { "loops",      &asn_base_integer_s, {PRIVATE, 4} },
+    { "batch",      &asn_base_integer_s, {PRIVATE, 5} },
+    { "rewrite",    &ndn_pcap_rewrite_seq_s, {PRIVATE, 6} },
+};
+
+asn_type ndn_pcap_replay_s = {
+    "PCAP-Replay", {PRIVATE, 105}, SEQUENCE,
+    TE_ARRAY_LEN(_ndn_pcap_replay_ne_array),
+    {_ndn_pcap_replay_ne_array}
+};
+
+const asn_type * const ndn_pcap_replay = &ndn_pcap_replay_s;
+
+
+/**
+ * PCAP filter (matching string) definition. Replay specification
+ * is used in templates only.
  */
 static asn_named_entry_t _ndn_pcap_filter_ne_array[] = {
     { "filter", &ndn_data_unit_char_string_s, {PRIVATE, 1}},
     { "filter-id", &asn_base_integer_s, {PRIVATE, 2}},
     { "bpf-id", &asn_base_integer_s, {PRIVATE, 3}},
+    { "replay", &ndn_pcap_replay_s, {PRIVATE, 4}},
 };
 
 asn_type ndn_pcap_filter_s = {
@@ -34,11 +34,23 @@ enum pcap_csap_receive_mode {
     PCAP_RECV_ALL       = 0x1F,
 };
 
+/** Timing of packets replayed from a capture file */
+typedef enum ndn_pcap_replay_timing {
+    NDN_PCAP_REPLAY_ORIGINAL,   /**< Keep original gaps between packets */
+    NDN_PCAP_REPLAY_SCALED,     /**< Scale original gaps in accordance
+                                     with replay speed */
+    NDN_PCAP_REPLAY_MAX_RATE,   /**< Send packets as fast as possible */
+} ndn_pcap_replay_timing;
+
 extern const asn_type * const ndn_pcap_filter;
 extern const asn_type * const ndn_pcap_csap;
+extern const asn_type * const ndn_pcap_replay;
+extern const asn_type * const ndn_pcap_rewrite;
 
 extern asn_type ndn_pcap_filter_s;
 extern asn_type ndn_pcap_csap_s;
+extern asn_type ndn_pcap_replay_s;
+extern asn_type ndn_pcap_rewrite_s;
 
 #ifdef __cplusplus
 } /* extern "C" */
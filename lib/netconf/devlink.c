@@ -16,6 +16,7 @@
 #include "netconf_internal_genetlink.h"
 #include "logger_api.h"
 #include "te_alloc.h"
+#include "te_string.h"
 
 #if defined(HAVE_LINUX_GENETLINK_H) && defined(HAVE_LINUX_DEVLINK_H)
 
@@ -639,6 +640,768 @@ netconf_devlink_param_set(netconf_handle nh, const char *bus,
 
 #endif /* HAVE_DECL_DEVLINK_CMD_PARAM_SET */
 
+/*
+ * Initialize devlink request and append bus and device names
+ * to it if they are specified.
+ */
+static te_errno
+devlink_req_init(netconf_handle nh, char *req, size_t max_len,
+                 uint16_t flags, uint8_t cmd, const char *bus,
+                 const char *dev)
+{
+    te_errno rc;
+
+    rc = netconf_gn_init_hdrs(req, max_len, devlink_family, flags,
+                              cmd, DEVLINK_GENL_VERSION, nh);
+    if (rc != 0)
+        return rc;
+
+    if (bus == NULL)
+        return 0;
+
+    rc = netconf_append_attr(req, max_len, DEVLINK_ATTR_BUS_NAME,
+                             bus, strlen(bus) + 1);
+    if (rc != 0)
+        return rc;
+
+    return netconf_append_attr(req, max_len, DEVLINK_ATTR_DEV_NAME,
+                               dev, strlen(dev) + 1);
+}
+
+/*
+ * Send devlink request and collect objects from replies
+ * with a callback.
+ */
+static te_errno
+devlink_req_talk(netconf_handle nh, char *req, netconf_recv_cb_t *cb,
+                 netconf_list **list)
+{
+    struct nlmsghdr *h = (struct nlmsghdr *)req;
+    netconf_list *list_ptr = NULL;
+    int os_rc;
+
+    if (list == NULL)
+    {
+        os_rc = netconf_talk(nh, req, h->nlmsg_len, NULL, NULL, NULL);
+        return os_rc != 0 ? te_rc_os2te(errno) : 0;
+    }
+
+    list_ptr = TE_ALLOC(sizeof(*list_ptr));
+
+    os_rc = netconf_talk(nh, req, h->nlmsg_len, cb, NULL, list_ptr);
+    if (os_rc != 0)
+    {
+        netconf_list_free(list_ptr);
+        return te_rc_os2te(errno);
+    }
+
+    *list = list_ptr;
+    return 0;
+}
+
+#if HAVE_DECL_DEVLINK_CMD_PORT_SPLIT
+
+/* Process attributes of devlink port message */
+static te_errno
+port_attr_cb(struct nlattr *na, void *cb_data)
+{
+    netconf_devlink_port *port = cb_data;
+
+    switch (na->nla_type)
+    {
+        case DEVLINK_ATTR_BUS_NAME:
+            return netconf_get_str_attr(na, &port->bus_name);
+
+        case DEVLINK_ATTR_DEV_NAME:
+            return netconf_get_str_attr(na, &port->dev_name);
+
+        case DEVLINK_ATTR_PORT_INDEX:
+            return netconf_get_uint32_attr(na, &port->index);
+
+        case DEVLINK_ATTR_PORT_TYPE:
+            return netconf_get_uint16_attr(na, &port->type);
+
+        case DEVLINK_ATTR_PORT_FLAVOUR:
+            return netconf_get_uint16_attr(na, &port->flavour);
+
+        case DEVLINK_ATTR_PORT_NETDEV_NAME:
+            return netconf_get_str_attr(na, &port->netdev_name);
+
+        case DEVLINK_ATTR_PORT_SPLIT_COUNT:
+            return netconf_get_uint32_attr(na, &port->split_count);
+    }
+
+    return 0;
+}
+
+/* Process devlink port message */
+static int
+port_cb(struct nlmsghdr *h, netconf_list *list, void *cookie)
+{
+    UNUSED(cookie);
+
+    if (netconf_list_extend(list, NETCONF_NODE_DEVLINK_PORT) != 0)
+        return -1;
+
+    if (netconf_gn_process_attrs(h, port_attr_cb,
+                                 &list->tail->data.devlink_port) != 0)
+        return -1;
+
+    return 0;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_port_dump(netconf_handle nh, netconf_list **list)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST | NLM_F_DUMP,
+                          DEVLINK_CMD_PORT_GET, NULL, NULL);
+    if (rc != 0)
+        return rc;
+
+    return devlink_req_talk(nh, req, port_cb, list);
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_port_split(netconf_handle nh, const char *bus,
+                           const char *dev, uint32_t index, uint32_t count)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST | NLM_F_ACK,
+                          count == 0 ? DEVLINK_CMD_PORT_UNSPLIT :
+                                       DEVLINK_CMD_PORT_SPLIT,
+                          bus, dev);
+    if (rc != 0)
+        return rc;
+
+    rc = netconf_append_attr(req, sizeof(req), DEVLINK_ATTR_PORT_INDEX,
+                             &index, sizeof(index));
+    if (rc != 0)
+        return rc;
+
+    if (count != 0)
+    {
+        rc = netconf_append_attr(req, sizeof(req),
+                                 DEVLINK_ATTR_PORT_SPLIT_COUNT,
+                                 &count, sizeof(count));
+        if (rc != 0)
+            return rc;
+    }
+
+    return devlink_req_talk(nh, req, NULL, NULL);
+}
+
+#endif /* HAVE_DECL_DEVLINK_CMD_PORT_SPLIT */
+
+#if HAVE_DECL_DEVLINK_CMD_HEALTH_REPORTER_GET
+
+/* Process nested attributes of HEALTH_REPORTER attribute */
+static te_errno
+health_reporter_attr_cb(struct nlattr *na, void *cb_data)
+{
+    netconf_devlink_health *health = cb_data;
+    uint8_t state;
+    te_errno rc;
+
+    switch (na->nla_type)
+    {
+        case DEVLINK_ATTR_HEALTH_REPORTER_NAME:
+            return netconf_get_str_attr(na, &health->name);
+
+        case DEVLINK_ATTR_HEALTH_REPORTER_STATE:
+            rc = netconf_get_uint8_attr(na, &state);
+            if (rc != 0)
+                return rc;
+
+            /*
+             * Reporter states are not exported to UAPI,
+             * 0 is DEVLINK_HEALTH_REPORTER_STATE_HEALTHY.
+             */
+            health->error = (state != 0);
+            break;
+
+        case DEVLINK_ATTR_HEALTH_REPORTER_ERR_COUNT:
+            return netconf_get_uint64_attr(na, &health->error_count);
+
+        case DEVLINK_ATTR_HEALTH_REPORTER_RECOVER_COUNT:
+            return netconf_get_uint64_attr(na, &health->recover_count);
+    }
+
+    return 0;
+}
+
+/* Process attributes of devlink health reporter message */
+static te_errno
+health_attr_cb(struct nlattr *na, void *cb_data)
+{
+    netconf_devlink_health *health = cb_data;
+
+    switch (na->nla_type)
+    {
+        case DEVLINK_ATTR_BUS_NAME:
+            return netconf_get_str_attr(na, &health->bus_name);
+
+        case DEVLINK_ATTR_DEV_NAME:
+            return netconf_get_str_attr(na, &health->dev_name);
+
+        case DEVLINK_ATTR_PORT_INDEX:
+            health->has_port = TRUE;
+            return netconf_get_uint32_attr(na, &health->port_index);
+
+        case DEVLINK_ATTR_HEALTH_REPORTER:
+            return netconf_process_nested_attrs(na, health_reporter_attr_cb,
+                                                health);
+    }
+
+    return 0;
+}
+
+/* Process devlink health reporter message */
+static int
+health_cb(struct nlmsghdr *h, netconf_list *list, void *cookie)
+{
+    UNUSED(cookie);
+
+    if (netconf_list_extend(list, NETCONF_NODE_DEVLINK_HEALTH) != 0)
+        return -1;
+
+    if (netconf_gn_process_attrs(h, health_attr_cb,
+                                 &list->tail->data.devlink_health) != 0)
+        return -1;
+
+    return 0;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_health_dump(netconf_handle nh, netconf_list **list)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST | NLM_F_DUMP,
+                          DEVLINK_CMD_HEALTH_REPORTER_GET, NULL, NULL);
+    if (rc != 0)
+        return rc;
+
+    return devlink_req_talk(nh, req, health_cb, list);
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_health_recover(netconf_handle nh, const char *bus,
+                               const char *dev, const char *name)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST | NLM_F_ACK,
+                          DEVLINK_CMD_HEALTH_REPORTER_RECOVER, bus, dev);
+    if (rc != 0)
+        return rc;
+
+    rc = netconf_append_attr(req, sizeof(req),
+                             DEVLINK_ATTR_HEALTH_REPORTER_NAME,
+                             name, strlen(name) + 1);
+    if (rc != 0)
+        return rc;
+
+    return devlink_req_talk(nh, req, NULL, NULL);
+}
+
+#endif /* HAVE_DECL_DEVLINK_CMD_HEALTH_REPORTER_GET */
+
+#if HAVE_DECL_DEVLINK_CMD_RESOURCE_DUMP
+
+/*
+ * Auxiliary structure for callbacks flattening the tree of resources
+ */
+typedef struct resource_cb_data {
+    netconf_list *list;         /* List to fill */
+    const char *bus_name;       /* Bus name */
+    const char *dev_name;       /* Device name */
+    const char *prefix;         /* Path of the parent resource */
+
+    netconf_devlink_resource *res;  /* Currently processed resource */
+    struct nlattr *children;        /* RESOURCE_LIST attribute of the
+                                       currently processed resource */
+} resource_cb_data;
+
+/* Process nested attributes of RESOURCE attribute */
+static te_errno
+resource_attr_cb(struct nlattr *na, void *data)
+{
+    resource_cb_data *cb_data = data;
+    netconf_devlink_resource *res = cb_data->res;
+    char *name = NULL;
+    te_errno rc;
+
+    switch (na->nla_type)
+    {
+        case DEVLINK_ATTR_RESOURCE_NAME:
+            rc = netconf_get_str_attr(na, &name);
+            if (rc != 0)
+                return rc;
+
+            res->path = te_string_fmt("%s%s%s", cb_data->prefix,
+                                      *cb_data->prefix == '\0' ? "" : "/",
+                                      name);
+            free(name);
+            break;
+
+        case DEVLINK_ATTR_RESOURCE_ID:
+            return netconf_get_uint64_attr(na, &res->id);
+
+        case DEVLINK_ATTR_RESOURCE_SIZE:
+            return netconf_get_uint64_attr(na, &res->size);
+
+        case DEVLINK_ATTR_RESOURCE_SIZE_NEW:
+            return netconf_get_uint64_attr(na, &res->size_new);
+
+        case DEVLINK_ATTR_RESOURCE_OCC:
+            res->has_occ = TRUE;
+            return netconf_get_uint64_attr(na, &res->occ);
+
+        case DEVLINK_ATTR_RESOURCE_LIST:
+            cb_data->children = na;
+            break;
+    }
+
+    return 0;
+}
+
+/* Process RESOURCE attribute in RESOURCE_LIST and its children */
+static te_errno
+resource_cb(struct nlattr *na, void *data)
+{
+    resource_cb_data *cb_data = data;
+    resource_cb_data child_data;
+    netconf_devlink_resource *res;
+    te_errno rc;
+
+    if (na->nla_type != DEVLINK_ATTR_RESOURCE)
+        return 0;
+
+    if (netconf_list_extend(cb_data->list,
+                            NETCONF_NODE_DEVLINK_RESOURCE) != 0)
+        return TE_ENOMEM;
+
+    res = &cb_data->list->tail->data.devlink_resource;
+    res->bus_name = TE_STRDUP(cb_data->bus_name);
+    res->dev_name = TE_STRDUP(cb_data->dev_name);
+    res->size_new = UINT64_MAX;
+
+    cb_data->res = res;
+    cb_data->children = NULL;
+    rc = netconf_process_nested_attrs(na, resource_attr_cb, cb_data);
+    if (rc != 0)
+        return rc;
+
+    if (res->path == NULL)
+    {
+        ERROR("%s(): resource name is missing", __FUNCTION__);
+        return TE_EINVAL;
+    }
+
+    if (res->size_new == UINT64_MAX)
+        res->size_new = res->size;
+
+    if (cb_data->children == NULL)
+        return 0;
+
+    child_data = *cb_data;
+    child_data.prefix = res->path;
+
+    return netconf_process_nested_attrs(cb_data->children, resource_cb,
+                                        &child_data);
+}
+
+/* Process attributes of DEVLINK_CMD_RESOURCE_DUMP message */
+static te_errno
+resource_dump_attr_cb(struct nlattr *na, void *data)
+{
+    resource_cb_data *cb_data = data;
+
+    if (na->nla_type == DEVLINK_ATTR_RESOURCE_LIST)
+        return netconf_process_nested_attrs(na, resource_cb, cb_data);
+
+    return 0;
+}
+
+/* Process DEVLINK_CMD_RESOURCE_DUMP message */
+static int
+resource_dump_cb(struct nlmsghdr *h, netconf_list *list, void *cookie)
+{
+    resource_cb_data *cb_data = cookie;
+
+    cb_data->list = list;
+    if (netconf_gn_process_attrs(h, resource_dump_attr_cb, cb_data) != 0)
+        return -1;
+
+    return 0;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_resource_dump(netconf_handle nh, const char *bus,
+                              const char *dev, netconf_list **list)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    struct nlmsghdr *h = (struct nlmsghdr *)req;
+    resource_cb_data cb_data = { .bus_name = bus, .dev_name = dev,
+                                 .prefix = "" };
+    netconf_list *list_ptr;
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST,
+                          DEVLINK_CMD_RESOURCE_DUMP, bus, dev);
+    if (rc != 0)
+        return rc;
+
+    list_ptr = TE_ALLOC(sizeof(*list_ptr));
+
+    if (netconf_talk(nh, req, h->nlmsg_len, resource_dump_cb, &cb_data,
+                     list_ptr) != 0)
+    {
+        rc = te_rc_os2te(errno);
+        netconf_list_free(list_ptr);
+        return rc;
+    }
+
+    *list = list_ptr;
+    return 0;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_resource_set(netconf_handle nh, const char *bus,
+                             const char *dev, uint64_t id, uint64_t size)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST | NLM_F_ACK,
+                          DEVLINK_CMD_RESOURCE_SET, bus, dev);
+    if (rc != 0)
+        return rc;
+
+    rc = netconf_append_attr(req, sizeof(req), DEVLINK_ATTR_RESOURCE_ID,
+                             &id, sizeof(id));
+    if (rc != 0)
+        return rc;
+
+    rc = netconf_append_attr(req, sizeof(req), DEVLINK_ATTR_RESOURCE_SIZE,
+                             &size, sizeof(size));
+    if (rc != 0)
+        return rc;
+
+    return devlink_req_talk(nh, req, NULL, NULL);
+}
+
+#endif /* HAVE_DECL_DEVLINK_CMD_RESOURCE_DUMP */
+
+#if HAVE_DECL_DEVLINK_CMD_TRAP_GET
+
+/* Convert native trap action to netconf constant */
+static netconf_devlink_trap_action
+devlink_trap_action_h2netconf(uint8_t val)
+{
+#define CHECK_ACTION(_name) \
+    case DEVLINK_TRAP_ACTION_ ## _name:                 \
+        return NETCONF_DEVLINK_TRAP_ACTION_ ## _name
+
+    switch (val)
+    {
+        CHECK_ACTION(DROP);
+        CHECK_ACTION(TRAP);
+        CHECK_ACTION(MIRROR);
+
+        default:
+            return NETCONF_DEVLINK_TRAP_ACTION_UNDEF;
+    }
+#undef CHECK_ACTION
+}
+
+/* Process nested attributes of STATS attribute */
+static te_errno
+trap_stats_attr_cb(struct nlattr *na, void *cb_data)
+{
+    netconf_devlink_trap *trap = cb_data;
+
+    switch (na->nla_type)
+    {
+        case DEVLINK_ATTR_STATS_RX_PACKETS:
+            return netconf_get_uint64_attr(na, &trap->rx_packets);
+
+        case DEVLINK_ATTR_STATS_RX_BYTES:
+            return netconf_get_uint64_attr(na, &trap->rx_bytes);
+    }
+
+    return 0;
+}
+
+/* Process attributes of devlink trap message */
+static te_errno
+trap_attr_cb(struct nlattr *na, void *cb_data)
+{
+    netconf_devlink_trap *trap = cb_data;
+    uint8_t action;
+    te_errno rc;
+
+    switch (na->nla_type)
+    {
+        case DEVLINK_ATTR_BUS_NAME:
+            return netconf_get_str_attr(na, &trap->bus_name);
+
+        case DEVLINK_ATTR_DEV_NAME:
+            return netconf_get_str_attr(na, &trap->dev_name);
+
+        case DEVLINK_ATTR_TRAP_NAME:
+            return netconf_get_str_attr(na, &trap->name);
+
+        case DEVLINK_ATTR_TRAP_GROUP_NAME:
+            return netconf_get_str_attr(na, &trap->group_name);
+
+        case DEVLINK_ATTR_TRAP_GENERIC:
+            trap->generic = TRUE;
+            break;
+
+        case DEVLINK_ATTR_TRAP_ACTION:
+            rc = netconf_get_uint8_attr(na, &action);
+            if (rc != 0)
+                return rc;
+
+            trap->action = devlink_trap_action_h2netconf(action);
+            break;
+
+        case DEVLINK_ATTR_STATS:
+            return netconf_process_nested_attrs(na, trap_stats_attr_cb,
+                                                trap);
+    }
+
+    return 0;
+}
+
+/* Process devlink trap message */
+static int
+trap_cb(struct nlmsghdr *h, netconf_list *list, void *cookie)
+{
+    netconf_devlink_trap *trap;
+
+    UNUSED(cookie);
+
+    if (netconf_list_extend(list, NETCONF_NODE_DEVLINK_TRAP) != 0)
+        return -1;
+
+    trap = &list->tail->data.devlink_trap;
+    trap->action = NETCONF_DEVLINK_TRAP_ACTION_UNDEF;
+
+    if (netconf_gn_process_attrs(h, trap_attr_cb, trap) != 0)
+        return -1;
+
+    return 0;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_trap_dump(netconf_handle nh, netconf_list **list)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST | NLM_F_DUMP,
+                          DEVLINK_CMD_TRAP_GET, NULL, NULL);
+    if (rc != 0)
+        return rc;
+
+    return devlink_req_talk(nh, req, trap_cb, list);
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_trap_set(netconf_handle nh, const char *bus,
+                         const char *dev, const char *name,
+                         netconf_devlink_trap_action action)
+{
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    uint8_t native_action;
+    te_errno rc;
+
+    switch (action)
+    {
+        case NETCONF_DEVLINK_TRAP_ACTION_DROP:
+            native_action = DEVLINK_TRAP_ACTION_DROP;
+            break;
+
+        case NETCONF_DEVLINK_TRAP_ACTION_TRAP:
+            native_action = DEVLINK_TRAP_ACTION_TRAP;
+            break;
+
+        case NETCONF_DEVLINK_TRAP_ACTION_MIRROR:
+            native_action = DEVLINK_TRAP_ACTION_MIRROR;
+            break;
+
+        default:
+            return TE_EINVAL;
+    }
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = devlink_req_init(nh, req, sizeof(req), NLM_F_REQUEST | NLM_F_ACK,
+                          DEVLINK_CMD_TRAP_SET, bus, dev);
+    if (rc != 0)
+        return rc;
+
+    rc = netconf_append_attr(req, sizeof(req), DEVLINK_ATTR_TRAP_NAME,
+                             name, strlen(name) + 1);
+    if (rc != 0)
+        return rc;
+
+    rc = netconf_append_attr(req, sizeof(req), DEVLINK_ATTR_TRAP_ACTION,
+                             &native_action, sizeof(native_action));
+    if (rc != 0)
+        return rc;
+
+    return devlink_req_talk(nh, req, NULL, NULL);
+}
+
+#endif /* HAVE_DECL_DEVLINK_CMD_TRAP_GET */
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_event_subscribe(netconf_handle nh)
+{
+    uint32_t group;
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    rc = netconf_gn_get_mcast_group(nh, DEVLINK_GENL_NAME,
+                                    DEVLINK_GENL_MCGRP_CONFIG_NAME, &group);
+    if (rc != 0)
+        return rc;
+
+    if (setsockopt(nh->socket, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP,
+                   &group, sizeof(group)) < 0)
+    {
+        rc = te_rc_os2te(errno);
+        ERROR("%s(): failed to join devlink multicast group: %r",
+              __FUNCTION__, rc);
+        return rc;
+    }
+
+    return 0;
+}
+
+/* See description in netconf_internal_genetlink.h */
+te_errno
+netconf_devlink_event_parse(uint16_t family, const void *buf, size_t len,
+                            netconf_list *list)
+{
+    struct nlmsghdr *h;
+    struct genlmsghdr *gh;
+    netconf_recv_cb_t *cb;
+    int rest = len;
+
+    for (h = (struct nlmsghdr *)buf;
+         NLMSG_OK(h, (unsigned int)rest);
+         h = NLMSG_NEXT(h, rest))
+    {
+        if (h->nlmsg_type != family)
+            continue;
+
+        gh = NLMSG_DATA(h);
+        switch (gh->cmd)
+        {
+#if HAVE_DECL_DEVLINK_CMD_PORT_SPLIT
+            case DEVLINK_CMD_PORT_NEW:
+            case DEVLINK_CMD_PORT_DEL:
+                cb = port_cb;
+                break;
+#endif
+#if HAVE_DECL_DEVLINK_CMD_HEALTH_REPORTER_GET
+            case DEVLINK_CMD_HEALTH_REPORTER_RECOVER:
+                cb = health_cb;
+                break;
+#endif
+#if HAVE_DECL_DEVLINK_CMD_TRAP_GET
+            /*
+             * These are notifications about changes of trap
+             * configuration (e.g. action) sent to the "config" group.
+             * Packets dropped by traps are not reported here: the
+             * kernel reports them via the drop monitor (NET_DM) family.
+             */
+            case DEVLINK_CMD_TRAP_NEW:
+            case DEVLINK_CMD_TRAP_DEL:
+                cb = trap_cb;
+                break;
+#endif
+
+            default:
+                cb = NULL;
+        }
+
+        if (cb != NULL && cb(h, list, NULL) != 0)
+        {
+            ERROR("%s(): failed to process devlink notification %u",
+                  __FUNCTION__, (unsigned int)gh->cmd);
+            return TE_EINVAL;
+        }
+    }
+
+    return 0;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_event_recv(netconf_handle nh, netconf_list **list)
+{
+    char buf[NETCONF_RCV_BUF_LEN];
+    netconf_list *list_ptr;
+    int rcvd;
+    te_errno rc;
+
+    GET_CHECK_DEVLINK_FAMILY(nh);
+
+    do {
+        rcvd = recv(nh->socket, buf, sizeof(buf), 0);
+    } while (rcvd < 0 && errno == EINTR);
+    if (rcvd < 0)
+        return te_rc_os2te(errno);
+
+    list_ptr = TE_ALLOC(sizeof(*list_ptr));
+
+    rc = netconf_devlink_event_parse(devlink_family, buf, rcvd, list_ptr);
+    if (rc != 0)
+    {
+        netconf_list_free(list_ptr);
+        return rc;
+    }
+
+    *list = list_ptr;
+    return 0;
+}
+
 #else /* defined(HAVE_LINUX_GENETLINK_H) && defined(HAVE_LINUX_DEVLINK_H) */
 
 #define NO_DEVLINK_IMPL 1
@@ -693,6 +1456,147 @@ netconf_devlink_param_set(netconf_handle nh, const char *bus,
 }
 #endif
 
+#if defined(NO_DEVLINK_IMPL) || !HAVE_DECL_DEVLINK_CMD_PORT_SPLIT
+/* See description in netconf.h */
+te_errno
+netconf_devlink_port_dump(netconf_handle nh, netconf_list **list)
+{
+    UNUSED(nh);
+    UNUSED(list);
+
+    return TE_ENOENT;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_port_split(netconf_handle nh, const char *bus,
+                           const char *dev, uint32_t index, uint32_t count)
+{
+    UNUSED(nh);
+    UNUSED(bus);
+    UNUSED(dev);
+    UNUSED(index);
+    UNUSED(count);
+
+    return TE_ENOENT;
+}
+#endif
+
+#if defined(NO_DEVLINK_IMPL) || !HAVE_DECL_DEVLINK_CMD_HEALTH_REPORTER_GET
+/* See description in netconf.h */
+te_errno
+netconf_devlink_health_dump(netconf_handle nh, netconf_list **list)
+{
+    UNUSED(nh);
+    UNUSED(list);
+
+    return TE_ENOENT;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_health_recover(netconf_handle nh, const char *bus,
+                               const char *dev, const char *name)
+{
+    UNUSED(nh);
+    UNUSED(bus);
+    UNUSED(dev);
+    UNUSED(name);
+
+    return TE_ENOENT;
+}
+#endif
+
+#if defined(NO_DEVLINK_IMPL) || !HAVE_DECL_DEVLINK_CMD_RESOURCE_DUMP
+/* See description in netconf.h */
+te_errno
+netconf_devlink_resource_dump(netconf_handle nh, const char *bus,
+                              const char *dev, netconf_list **list)
+{
+    UNUSED(nh);
+    UNUSED(bus);
+    UNUSED(dev);
+    UNUSED(list);
+
+    return TE_ENOENT;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_resource_set(netconf_handle nh, const char *bus,
+                             const char *dev, uint64_t id, uint64_t size)
+{
+    UNUSED(nh);
+    UNUSED(bus);
+    UNUSED(dev);
+    UNUSED(id);
+    UNUSED(size);
+
+    return TE_ENOENT;
+}
+#endif
+
+#if defined(NO_DEVLINK_IMPL) || !HAVE_DECL_DEVLINK_CMD_TRAP_GET
+/* See description in netconf.h */
+te_errno
+netconf_devlink_trap_dump(netconf_handle nh, netconf_list **list)
+{
+    UNUSED(nh);
+    UNUSED(list);
+
+    return TE_ENOENT;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_trap_set(netconf_handle nh, const char *bus,
+                         const char *dev, const char *name,
+                         netconf_devlink_trap_action action)
+{
+    UNUSED(nh);
+    UNUSED(bus);
+    UNUSED(dev);
+    UNUSED(name);
+    UNUSED(action);
+
+    return TE_ENOENT;
+}
+#endif
+
+#if defined(NO_DEVLINK_IMPL)
+/* See description in netconf.h */
+te_errno
+netconf_devlink_event_subscribe(netconf_handle nh)
+{
+    UNUSED(nh);
+
+    return TE_ENOENT;
+}
+
+/* See description in netconf.h */
+te_errno
+netconf_devlink_event_recv(netconf_handle nh, netconf_list **list)
+{
+    UNUSED(nh);
+    UNUSED(list);
+
+    return TE_ENOENT;
+}
+
+/* See description in netconf_internal_genetlink.h */
+te_errno
+netconf_devlink_event_parse(uint16_t family, const void *buf, size_t len,
+                            netconf_list *list)
+{
+    UNUSED(family);
+    UNUSED(buf);
+    UNUSED(len);
+    UNUSED(list);
+
+    return TE_ENOENT;
+}
+#endif
+
 /* See description in netconf.h */
 void
 netconf_devlink_info_node_free(netconf_node *node)
@@ -794,3 +1698,90 @@ netconf_devlink_param_value_data_mv(
     memcpy(dst, src, sizeof(*src));
     memset(src, 0, sizeof(*src));
 }
+
+/* See description in netconf.h */
+void
+netconf_devlink_port_node_free(netconf_node *node)
+{
+    if (node == NULL)
+        return;
+
+    free(node->data.devlink_port.bus_name);
+    free(node->data.devlink_port.dev_name);
+    free(node->data.devlink_port.netdev_name);
+    free(node);
+}
+
+/* See description in netconf.h */
+void
+netconf_devlink_health_node_free(netconf_node *node)
+{
+    if (node == NULL)
+        return;
+
+    free(node->data.devlink_health.bus_name);
+    free(node->data.devlink_health.dev_name);
+    free(node->data.devlink_health.name);
+    free(node);
+}
+
+/* See description in netconf.h */
+void
+netconf_devlink_resource_node_free(netconf_node *node)
+{
+    if (node == NULL)
+        return;
+
+    free(node->data.devlink_resource.bus_name);
+    free(node->data.devlink_resource.dev_name);
+    free(node->data.devlink_resource.path);
+    free(node);
+}
+
+/* See description in netconf.h */
+void
+netconf_devlink_trap_node_free(netconf_node *node)
+{
+    if (node == NULL)
+        return;
+
+    free(node->data.devlink_trap.bus_name);
+    free(node->data.devlink_trap.dev_name);
+    free(node->data.devlink_trap.name);
+    free(node->data.devlink_trap.group_name);
+    free(node);
+}
+
+/* See description in netconf.h */
+const char *
+devlink_trap_action_netconf2str(netconf_devlink_trap_action action)
+{
+    switch (action)
+    {
+        case NETCONF_DEVLINK_TRAP_ACTION_DROP:
+            return "drop";
+
+        case NETCONF_DEVLINK_TRAP_ACTION_TRAP:
+            return "trap";
+
+        case NETCONF_DEVLINK_TRAP_ACTION_MIRROR:
+            return "mirror";
+
+        default:
+            return "<unknown>";
+    }
+}
+
+/* See description in netconf.h */
+netconf_devlink_trap_action
+devlink_trap_action_str2netconf(const char *action)
+{
+    if (strcmp(action, "drop") == 0)
+        return NETCONF_DEVLINK_TRAP_ACTION_DROP;
+    else if (strcmp(action, "trap") == 0)
+        return NETCONF_DEVLINK_TRAP_ACTION_TRAP;
+    else if (strcmp(action, "mirror") == 0)
+        return NETCONF_DEVLINK_TRAP_ACTION_MIRROR;
+
+    return NETCONF_DEVLINK_TRAP_ACTION_UNDEF;
+}
@@ -56,6 +56,85 @@ family_msg_cb(struct nlmsghdr *h, netconf_list *list, void *cookie)
     return 0;
 }
 
+/* Data for callbacks searching for multicast group ID */
+typedef struct mcast_grp_cb_data {
+    const char *name;   /* Group name */
+    char *cur_name;     /* Name of the currently processed group */
+    int cur_id;         /* ID of the currently processed group */
+    int id;             /* ID of the found group */
+} mcast_grp_cb_data;
+
+/* Process attributes of a multicast group */
+static te_errno
+mcast_grp_attr_cb(struct nlattr *na, void *cb_data)
+{
+    mcast_grp_cb_data *data = cb_data;
+    uint32_t val;
+    te_errno rc;
+
+    switch (na->nla_type)
+    {
+        case CTRL_ATTR_MCAST_GRP_NAME:
+            free(data->cur_name);
+            data->cur_name = NULL;
+            return netconf_get_str_attr(na, &data->cur_name);
+
+        case CTRL_ATTR_MCAST_GRP_ID:
+            rc = netconf_get_uint32_attr(na, &val);
+            if (rc != 0)
+                return rc;
+
+            data->cur_id = val;
+            break;
+    }
+
+    return 0;
+}
+
+/* Process a multicast group in the list of groups */
+static te_errno
+mcast_grp_cb(struct nlattr *na, void *cb_data)
+{
+    mcast_grp_cb_data *data = cb_data;
+    te_errno rc;
+
+    data->cur_id = -1;
+    rc = netconf_process_nested_attrs(na, mcast_grp_attr_cb, data);
+    if (rc == 0 && data->cur_name != NULL && data->cur_id >= 0 &&
+        strcmp(data->cur_name, data->name) == 0)
+        data->id = data->cur_id;
+
+    free(data->cur_name);
+    data->cur_name = NULL;
+
+    return rc;
+}
+
+/* Callback for obtaining multicast groups from message attribute */
+static te_errno
+mcast_grps_attr_cb(struct nlattr *na, void *cb_data)
+{
+    if (na->nla_type == CTRL_ATTR_MCAST_GROUPS)
+        return netconf_process_nested_attrs(na, mcast_grp_cb, cb_data);
+
+    return 0;
+}
+
+/* Callback for processing netlink message containing multicast groups */
+static int
+mcast_grps_msg_cb(struct nlmsghdr *h, netconf_list *list, void *cookie)
+{
+    te_errno rc;
+
+    UNUSED(list);
+
+    rc = netconf_gn_process_attrs(h, mcast_grps_attr_cb, cookie);
+    if (rc != 0)
+        return -1;
+
+    return 0;
+}
+
 #endif /* HAVE_LINUX_GENETLINK_H */
 
 /* See description in netconf_internal_genetlink.h */
@@ -170,3 +249,56 @@ netconf_gn_get_family(netconf_handle nh, const char *family_name,
     return 0;
 #endif
 }
+
+/* See description in netconf_internal_genetlink.h */
+te_errno
+netconf_gn_get_mcast_group(netconf_handle nh, const char *family_name,
+                           const char *group_name, uint32_t *group_id)
+{
+#ifndef HAVE_LINUX_GENETLINK_H
+    UNUSED(nh);
+    UNUSED(family_name);
+    UNUSED(group_name);
+    UNUSED(group_id);
+
+    return TE_ENOENT;
+#else
+    char req[NETCONF_MAX_REQ_LEN] = { 0, };
+    te_errno rc;
+    int os_rc;
+    struct nlmsghdr *h;
+    mcast_grp_cb_data data = { .name = group_name, .id = -1 };
+
+    h = (struct nlmsghdr *)req;
+
+    rc = netconf_gn_init_hdrs(req, sizeof(req), GENL_ID_CTRL, NLM_F_REQUEST,
+                              CTRL_CMD_GETFAMILY, 0x1, nh);
+    if (rc != 0)
+        return rc;
+
+    rc = netconf_append_attr(req, sizeof(req), CTRL_ATTR_FAMILY_NAME,
+                             family_name, strlen(family_name) + 1);
+    if (rc != 0)
+        return rc;
+
+    os_rc = netconf_talk(nh, req, h->nlmsg_len, mcast_grps_msg_cb,
+                         &data, NULL);
+    if (os_rc < 0)
+    {
+        rc = te_rc_os2te(errno);
+        ERROR("%s(): failed to obtain multicast groups of generic netlink "
+              "family '%s', rc=%r", __FUNCTION__, family_name, rc);
+        return rc;
+    }
+
+    if (data.id < 0)
+    {
+        ERROR("%s(): multicast group '%s' was not found for '%s'",
+              __FUNCTION__, group_name, family_name);
+        return TE_ENOENT;
+    }
+
+    *group_id = data.id;
+    return 0;
+#endif
+}
@@ -134,3 +134,54 @@ netconf_link_set_ns(netconf_handle nh, const char *ifname,
 
     return 0;
 }
+
+te_errno
+netconf_link_set_up(netconf_handle nh, const char *ifname, te_bool up)
+{
+    char                req[NETCONF_MAX_REQ_LEN];
+    struct nlmsghdr    *h;
+    struct ifinfomsg   *ifi;
+
+    memset(&req, 0, sizeof(req));
+
+    h = (struct nlmsghdr *)req;
+    h->nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    h->nlmsg_type = RTM_NEWLINK;
+    h->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+    h->nlmsg_seq = ++nh->seq;
+
+    ifi = NLMSG_DATA(h);
+    ifi->ifi_family = AF_UNSPEC;
+    ifi->ifi_change = IFF_UP;
+    ifi->ifi_flags = up ? IFF_UP : 0;
+
+    netconf_append_rta(h, ifname, strlen(ifname), IFLA_IFNAME);
+
+    if (netconf_talk(nh, &req, sizeof(req), NULL, NULL, NULL) < 0)
+        return TE_OS_RC(TE_TA_UNIX, errno);
+
+    return 0;
+}
+
+te_errno
+netconf_link_set_mtu(netconf_handle nh, const char *ifname, uint32_t mtu)
+{
+    char                req[NETCONF_MAX_REQ_LEN];
+    struct nlmsghdr    *h;
+
+    memset(&req, 0, sizeof(req));
+
+    h = (struct nlmsghdr *)req;
+    h->nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    h->nlmsg_type = RTM_NEWLINK;
+    h->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+    h->nlmsg_seq = ++nh->seq;
+
+    netconf_append_rta(h, ifname, strlen(ifname), IFLA_IFNAME);
+    netconf_append_rta(h, &mtu, sizeof(mtu), IFLA_MTU);
+
+    if (netconf_talk(nh, &req, sizeof(req), NULL, NULL, NULL) < 0)
+        return TE_OS_RC(TE_TA_UNIX, errno);
+
+    return 0;
+}
@@ -5,6 +5,11 @@
  * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
  */
 
+#include "config.h"
+
+#include <fcntl.h>
+#include <sched.h>
+
 #include "netconf.h"
 #include "netconf_internal.h"
 #include "logger_api.h"
@@ -107,6 +112,56 @@ netconf_open(netconf_handle *nh, int netlink_family)
     return 0;
 }
 
+int
+netconf_open_ns(netconf_handle *nh, int netlink_family, int ns_fd)
+{
+#ifdef HAVE_SETNS
+    int orig_fd;
+    int rc;
+    int err;
+
+    if (ns_fd < 0)
+        return netconf_open(nh, netlink_family);
+
+    /* Namespace is changed for the calling thread only */
+    orig_fd = open("/proc/thread-self/ns/net", O_RDONLY | O_CLOEXEC);
+    if (orig_fd < 0)
+        return -1;
+
+    if (setns(ns_fd, CLONE_NEWNET) != 0)
+    {
+        err = errno;
+        close(orig_fd);
+        errno = err;
+        return -1;
+    }
+
+    rc = netconf_open(nh, netlink_family);
+    err = errno;
+
+    if (setns(orig_fd, CLONE_NEWNET) != 0)
+    {
+        ERROR("%s(): failed to return to the original network namespace: "
+              "%s", __FUNCTION__, strerror(errno));
+        if (rc == 0)
+            netconf_close(*nh);
+        close(orig_fd);
+        return -1;
+    }
+
+    close(orig_fd);
+    errno = err;
+    return rc;
+#else
+    if (ns_fd < 0)
+        return netconf_open(nh, netlink_family);
+
+    UNUSED(nh);
+    errno = EOPNOTSUPP;
+    return -1;
+#endif
+}
+
 void
 netconf_close(netconf_handle nh)
 {
@@ -352,6 +407,22 @@ netconf_node_free(netconf_node *node)
             netconf_devlink_param_node_free(node);
             break;
 
+        case NETCONF_NODE_DEVLINK_PORT:
+            netconf_devlink_port_node_free(node);
+            break;
+
+        case NETCONF_NODE_DEVLINK_HEALTH:
+            netconf_devlink_health_node_free(node);
+            break;
+
+        case NETCONF_NODE_DEVLINK_RESOURCE:
+            netconf_devlink_resource_node_free(node);
+            break;
+
+        case NETCONF_NODE_DEVLINK_TRAP:
+            netconf_devlink_trap_node_free(node);
+            break;
+
         default:
             NETCONF_ASSERT(0);
             free(node);
@@ -383,6 +383,88 @@ typedef struct netconf_devlink_param {
     netconf_devlink_param_value values[NETCONF_DEVLINK_PARAM_CMODES];
 } netconf_devlink_param;
 
+/** Devlink port */
+typedef struct netconf_devlink_port {
+    char *bus_name;         /**< Bus name */
+    char *dev_name;         /**< Device name */
+    uint32_t index;         /**< Port index */
+    uint16_t type;          /**< Port type (DEVLINK_PORT_TYPE_*) */
+    uint16_t flavour;       /**< Port flavour (DEVLINK_PORT_FLAVOUR_*) */
+    char *netdev_name;      /**< Name of the network interface
+                                 (may be @c NULL) */
+    uint32_t split_count;   /**< Number of subports the port is split to,
+                                 @c 0 if it is not split */
+} netconf_devlink_port;
+
+/** Devlink health reporter */
+typedef struct netconf_devlink_health {
+    char *bus_name;         /**< Bus name */
+    char *dev_name;         /**< Device name */
+    te_bool has_port;       /**< Whether the reporter belongs to a port */
+    uint32_t port_index;    /**< Port index if @a has_port is @c TRUE */
+    char *name;             /**< Reporter name */
+    te_bool error;          /**< @c TRUE if the reporter is in error
+                                 state, @c FALSE if it is healthy */
+    uint64_t error_count;   /**< Number of errors reported */
+    uint64_t recover_count; /**< Number of recoveries */
+} netconf_devlink_health;
+
+/** Devlink resource */
+typedef struct netconf_devlink_resource {
+    char *bus_name;         /**< Bus name */
+    char *dev_name;         /**< Device name */
+    char *path;             /**< Path in the resource tree, names of
+                                 resources separated by @c '/' */
+    uint64_t id;            /**< Resource ID */
+    uint64_t size;          /**< Current size */
+    uint64_t size_new;      /**< Size to be applied on reload */
+    te_bool has_occ;        /**< Whether occupancy is reported */
+    uint64_t occ;           /**< Occupancy */
+} netconf_devlink_resource;
+
+/** Devlink packet trap action */
+typedef enum netconf_devlink_trap_action {
+    NETCONF_DEVLINK_TRAP_ACTION_DROP,   /**< Packet is dropped */
+    NETCONF_DEVLINK_TRAP_ACTION_TRAP,   /**< Packet is sent to CPU */
+    NETCONF_DEVLINK_TRAP_ACTION_MIRROR, /**< Packet is forwarded and
+                                             a copy is sent to CPU */
+
+    /* This should be the last in enum */
+    NETCONF_DEVLINK_TRAP_ACTION_UNDEF,  /**< Not defined */
+} netconf_devlink_trap_action;
+
+/**
+ * Get string name of packet trap action.
+ *
+ * @param action      Trap action
+ *
+ * @return Pointer to statically allocated string.
+ */
+extern const char *devlink_trap_action_netconf2str(
+                          netconf_devlink_trap_action action);
+
+/**
+ * Parse name of packet trap action.
+ *
+ * @param action      Name to parse
+ *
+ * @return One of the values from netconf_devlink_trap_action.
+ */
+extern netconf_devlink_trap_action devlink_trap_action_str2netconf(
+                                                      const char *action);
+
+/** Devlink packet trap */
+typedef struct netconf_devlink_trap {
+    char *bus_name;         /**< Bus name */
+    char *dev_name;         /**< Device name */
+    char *name;             /**< Trap name */
+    char *group_name;       /**< Name of the trap group */
+    te_bool generic;        /**< Is trap generic or driver-specific */
+    netconf_devlink_trap_action action; /**< Trap action */
+    uint64_t rx_packets;    /**< Number of trapped packets */
+    uint64_t rx_bytes;      /**< Number of trapped bytes */
+} netconf_devlink_trap;
+
 /** Type of nodes in the list */
 typedef enum netconf_node_type {
     NETCONF_NODE_UNSPEC,                /**< Unspecified */
@@ -405,6 +487,10 @@ typedef enum netconf_node_type {
                                              from devlink */
     NETCONF_NODE_DEVLINK_PARAM,         /**< Device parameters data obtained
                                              from devlink */
+    NETCONF_NODE_DEVLINK_PORT,          /**< Devlink port */
+    NETCONF_NODE_DEVLINK_HEALTH,        /**< Devlink health reporter */
+    NETCONF_NODE_DEVLINK_RESOURCE,      /**< Devlink resource */
+    NETCONF_NODE_DEVLINK_TRAP,          /**< Devlink packet trap */
 } netconf_node_type;
 
 typedef te_conf_ip_rule netconf_rule;
@@ -429,6 +515,10 @@ typedef struct netconf_node {
 
         netconf_devlink_info     devlink_info;
         netconf_devlink_param    devlink_param;
+        netconf_devlink_port     devlink_port;
+        netconf_devlink_health   devlink_health;
+        netconf_devlink_resource devlink_resource;
+        netconf_devlink_trap     devlink_trap;
     } data;                             /**< Network data */
     struct netconf_node  *next;         /**< Next node of the list */
     struct netconf_node  *prev;         /**< Previous node of the list */
@@ -469,6 +559,23 @@ typedef struct netconf_handle_s *netconf_handle;
  */
 int netconf_open(netconf_handle *nh, int netlink_family);
 
+/**
+ * Open the netconf session in a network namespace. Netlink socket
+ * of the session is created in the target namespace and stays bound
+ * to it, so the session may be used from any thread without switching
+ * the namespace. The namespace of the calling thread is changed only
+ * for the time of socket creation.
+ *
+ * @param nh                Address to store netconf session handle
+ * @param netlink_family    Netlink family to use
+ * @param ns_fd             File descriptor of the network namespace or
+ *                          @c -1 for the namespace of the calling thread
+ *
+ * @return 0 on success, -1 on error (check errno for details).
+ */
+extern int netconf_open_ns(netconf_handle *nh, int netlink_family,
+                           int ns_fd);
+
 /**
  * Get list of all network devices. Free it with netconf_list_free()
  * function.
@@ -493,6 +600,30 @@ netconf_list *netconf_link_dump(netconf_handle nh);
 extern te_errno netconf_link_set_ns(netconf_handle nh, const char *ifname,
                                     int32_t fd, pid_t pid);
 
+/**
+ * Bring a network interface up or down.
+ *
+ * @param nh        Netconf handle.
+ * @param ifname    Interface name.
+ * @param up        @c TRUE to bring the interface up.
+ *
+ * @return Status code
+ */
+extern te_errno netconf_link_set_up(netconf_handle nh, const char *ifname,
+                                    te_bool up);
+
+/**
+ * Set MTU of a network interface.
+ *
+ * @param nh        Netconf handle.
+ * @param ifname    Interface name.
+ * @param mtu       New MTU.
+ *
+ * @return Status code
+ */
+extern te_errno netconf_link_set_mtu(netconf_handle nh, const char *ifname,
+                                     uint32_t mtu);
+
 /**
  * Set default values to fields in network address struct.
  *
@@ -1149,6 +1280,154 @@ extern te_errno netconf_devlink_param_set(
                             netconf_devlink_param_cmode cmode,
                             const netconf_devlink_param_value_data *value);
 
+/**
+ * Get list of devlink ports of all devices.
+ *
+ * @param nh        Netconf session handle
+ * @param list      Where to save pointer to the list of ports
+ *                  (caller should release it)
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_port_dump(netconf_handle nh,
+                                          netconf_list **list);
+
+/**
+ * Split devlink port to @p count subports or unsplit it if @p count
+ * is @c 0.
+ *
+ * @param nh        Netconf session handle
+ * @param bus       Bus name
+ * @param dev       Device name (PCI address for PCI device)
+ * @param index     Port index
+ * @param count     Number of subports
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_port_split(netconf_handle nh,
+                                           const char *bus,
+                                           const char *dev,
+                                           uint32_t index,
+                                           uint32_t count);
+
+/**
+ * Get list of devlink health reporters of all devices.
+ *
+ * @param nh        Netconf session handle
+ * @param list      Where to save pointer to the list of reporters
+ *                  (caller should release it)
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_health_dump(netconf_handle nh,
+                                            netconf_list **list);
+
+/**
+ * Initiate recovery of a device health reporter.
+ *
+ * @param nh        Netconf session handle
+ * @param bus       Bus name
+ * @param dev       Device name (PCI address for PCI device)
+ * @param name      Reporter name
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_health_recover(netconf_handle nh,
+                                               const char *bus,
+                                               const char *dev,
+                                               const char *name);
+
+/**
+ * Get flattened resource tree of a device.
+ *
+ * @param nh        Netconf session handle
+ * @param bus       Bus name
+ * @param dev       Device name (PCI address for PCI device)
+ * @param list      Where to save pointer to the list of resources
+ *                  (caller should release it)
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_resource_dump(netconf_handle nh,
+                                              const char *bus,
+                                              const char *dev,
+                                              netconf_list **list);
+
+/**
+ * Set size of a device resource. The size is applied on device
+ * reload.
+ *
+ * @param nh        Netconf session handle
+ * @param bus       Bus name
+ * @param dev       Device name (PCI address for PCI device)
+ * @param id        Resource ID
+ * @param size      New size
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_resource_set(netconf_handle nh,
+                                             const char *bus,
+                                             const char *dev,
+                                             uint64_t id, uint64_t size);
+
+/**
+ * Get list of packet traps of all devices.
+ *
+ * @param nh        Netconf session handle
+ * @param list      Where to save pointer to the list of traps
+ *                  (caller should release it)
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_trap_dump(netconf_handle nh,
+                                          netconf_list **list);
+
+/**
+ * Set action of a packet trap.
+ *
+ * @param nh        Netconf session handle
+ * @param bus       Bus name
+ * @param dev       Device name (PCI address for PCI device)
+ * @param name      Trap name
+ * @param action    Trap action
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_trap_set(netconf_handle nh,
+                                         const char *bus,
+                                         const char *dev,
+                                         const char *name,
+                                         netconf_devlink_trap_action action);
+
+/**
+ * Subscribe netconf session to devlink notifications. The session
+ * should be opened for @c NETLINK_GENERIC and should be used only
+ * for receiving notifications with netconf_devlink_event_recv().
+ *
+ * @param nh        Netconf session handle
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_event_subscribe(netconf_handle nh);
+
+/**
+ * Receive devlink notifications. The function blocks until
+ * a notification is received. Health reporter, port and packet trap
+ * notifications are returned, others are ignored. Packet trap
+ * notifications report changes of trap configuration, not packets
+ * dropped by traps (the kernel reports those via drop monitor).
+ *
+ * @param nh        Netconf session handle subscribed with
+ *                  netconf_devlink_event_subscribe()
+ * @param list      Where to save pointer to the list of objects
+ *                  from notifications (caller should release it,
+ *                  it may be empty)
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_event_recv(netconf_handle nh,
+                                           netconf_list **list);
+
 #ifdef __cplusplus
 }
 #endif
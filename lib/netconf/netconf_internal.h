@@ -415,6 +415,34 @@ extern void netconf_devlink_info_node_free(netconf_node *node);
  */
 extern void netconf_devlink_param_node_free(netconf_node *node);
 
+/**
+ * Free memory used by a devlink port node.
+ *
+ * @param node  Node to free
+ */
+extern void netconf_devlink_port_node_free(netconf_node *node);
+
+/**
+ * Free memory used by a devlink health reporter node.
+ *
+ * @param node  Node to free
+ */
+extern void netconf_devlink_health_node_free(netconf_node *node);
+
+/**
+ * Free memory used by a devlink resource node.
+ *
+ * @param node  Node to free
+ */
+extern void netconf_devlink_resource_node_free(netconf_node *node);
+
+/**
+ * Free memory used by a devlink packet trap node.
+ *
+ * @param node  Node to free
+ */
+extern void netconf_devlink_trap_node_free(netconf_node *node);
+
 /**
  * Send request to kernel and receive response.
  *
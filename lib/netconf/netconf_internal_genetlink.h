@@ -29,6 +29,21 @@
 te_errno netconf_gn_get_family(netconf_handle nh, const char *family_name,
                                uint16_t *family_id);
 
+/**
+ * Get ID of a multicast group of Generic Netlink family.
+ *
+ * @param nh            Netconf handle
+ * @param family_name   Family name
+ * @param group_name    Multicast group name
+ * @param group_id      Where to save requested group ID
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_gn_get_mcast_group(netconf_handle nh,
+                                           const char *family_name,
+                                           const char *group_name,
+                                           uint32_t *group_id);
+
 /**
  * Process attributes of Generic Netlink message.
  *
@@ -61,4 +76,20 @@ extern te_errno netconf_gn_init_hdrs(void *req, size_t max_len,
                                      uint16_t nlmsg_flags, uint8_t cmd,
                                      uint8_t version, netconf_handle nh);
 
+/**
+ * Parse devlink notifications received from the "config" multicast
+ * group. Messages of other families and unsupported commands are
+ * skipped.
+ *
+ * @param family        Devlink family ID
+ * @param buf           Received messages
+ * @param len           Length of received messages
+ * @param list          List where to add objects from notifications
+ *
+ * @return Status code.
+ */
+extern te_errno netconf_devlink_event_parse(uint16_t family,
+                                            const void *buf, size_t len,
+                                            netconf_list *list);
+
 #endif /* __NETCONF_INTERNAL_GENETLINK_H__ */
@@ -0,0 +1,218 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Device management using netconf library
+ *
+ * Test for parsing of devlink notifications: messages of another
+ * family and unsupported commands are skipped, packet trap
+ * configuration notifications are parsed with all attributes.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "config.h"
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "netconf.h"
+#include "netconf_internal.h"
+#include "netconf_internal_genetlink.h"
+
+#include "linux/genetlink.h"
+#include "linux/devlink.h"
+
+/** Devlink family ID used in the test */
+#define FAMILY          0x20
+/** Size of a buffer for one message */
+#define MSG_LEN         512
+
+#define TEST_BUS        "pci"
+#define TEST_DEV        "0000:01:00.0"
+#define TEST_TRAP       "source_mac_is_multicast"
+#define TEST_GROUP      "l2_drops"
+#define TEST_PACKETS    12345
+#define TEST_BYTES      678901234567ULL
+
+/* Initialize headers of a Generic Netlink message */
+static void
+init_msg(char *msg, uint16_t type, uint8_t cmd)
+{
+    struct nlmsghdr *h = (struct nlmsghdr *)msg;
+    struct genlmsghdr *gh;
+
+    memset(msg, 0, MSG_LEN);
+    h->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+    h->nlmsg_type = type;
+
+    gh = NLMSG_DATA(h);
+    gh->cmd = cmd;
+    gh->version = DEVLINK_GENL_VERSION;
+}
+
+/* Append a string attribute including terminating null byte */
+static te_errno
+append_str(char *msg, uint16_t type, const char *str)
+{
+    return netconf_append_attr(msg, MSG_LEN, type, str, strlen(str) + 1);
+}
+
+/* Fill a packet trap notification */
+static te_errno
+fill_trap_msg(char *msg, uint16_t type, uint8_t cmd)
+{
+    char stats[MSG_LEN];
+    uint64_t packets = TEST_PACKETS;
+    uint64_t bytes = TEST_BYTES;
+    uint8_t action = DEVLINK_TRAP_ACTION_TRAP;
+    te_errno rc;
+
+    /*
+     * Nested attributes are collected in a separate message to
+     * use its payload as data of the nested attribute.
+     */
+    init_msg(stats, 0, 0);
+    ((struct nlmsghdr *)stats)->nlmsg_len = NLMSG_LENGTH(0);
+    if ((rc = netconf_append_attr(stats, sizeof(stats),
+                                  DEVLINK_ATTR_STATS_RX_PACKETS,
+                                  &packets, sizeof(packets))) != 0 ||
+        (rc = netconf_append_attr(stats, sizeof(stats),
+                                  DEVLINK_ATTR_STATS_RX_BYTES,
+                                  &bytes, sizeof(bytes))) != 0)
+        return rc;
+
+    init_msg(msg, type, cmd);
+    if ((rc = append_str(msg, DEVLINK_ATTR_BUS_NAME, TEST_BUS)) != 0 ||
+        (rc = append_str(msg, DEVLINK_ATTR_DEV_NAME, TEST_DEV)) != 0 ||
+        (rc = append_str(msg, DEVLINK_ATTR_TRAP_NAME, TEST_TRAP)) != 0 ||
+        (rc = append_str(msg, DEVLINK_ATTR_TRAP_GROUP_NAME,
+                         TEST_GROUP)) != 0 ||
+        (rc = netconf_append_attr(msg, MSG_LEN, DEVLINK_ATTR_TRAP_GENERIC,
+                                  NULL, 0)) != 0 ||
+        (rc = netconf_append_attr(msg, MSG_LEN, DEVLINK_ATTR_TRAP_ACTION,
+                                  &action, sizeof(action))) != 0 ||
+        (rc = netconf_append_attr(msg, MSG_LEN, DEVLINK_ATTR_STATS,
+                                  NLMSG_DATA((struct nlmsghdr *)stats),
+                                  ((struct nlmsghdr *)stats)->nlmsg_len -
+                                  NLMSG_HDRLEN)) != 0)
+        return rc;
+
+    return 0;
+}
+
+/* Append a message to the buffer of received messages */
+static void
+append_msg(char *buf, size_t *len, const char *msg)
+{
+    size_t msg_len = NLMSG_ALIGN(((const struct nlmsghdr *)msg)->nlmsg_len);
+
+    memcpy(buf + *len, msg, msg_len);
+    *len += msg_len;
+}
+
+/* Check a parsed packet trap */
+static int
+check_trap(const netconf_node *node)
+{
+    const netconf_devlink_trap *trap;
+
+    if (node == NULL || node->type != NETCONF_NODE_DEVLINK_TRAP)
+    {
+        fprintf(stderr, "Packet trap node is missing\n");
+        return -1;
+    }
+
+    trap = &node->data.devlink_trap;
+    if (trap->bus_name == NULL || strcmp(trap->bus_name, TEST_BUS) != 0 ||
+        trap->dev_name == NULL || strcmp(trap->dev_name, TEST_DEV) != 0 ||
+        trap->name == NULL || strcmp(trap->name, TEST_TRAP) != 0 ||
+        trap->group_name == NULL ||
+        strcmp(trap->group_name, TEST_GROUP) != 0)
+    {
+        fprintf(stderr, "Names of the trap are parsed incorrectly\n");
+        return -1;
+    }
+
+    if (!trap->generic || trap->action != NETCONF_DEVLINK_TRAP_ACTION_TRAP)
+    {
+        fprintf(stderr, "Generic flag or action of the trap is parsed "
+                "incorrectly\n");
+        return -1;
+    }
+
+    if (trap->rx_packets != TEST_PACKETS || trap->rx_bytes != TEST_BYTES)
+    {
+        fprintf(stderr, "Statistics of the trap are parsed incorrectly: "
+                "%llu packets, %llu bytes\n",
+                (unsigned long long)trap->rx_packets,
+                (unsigned long long)trap->rx_bytes);
+        return -1;
+    }
+
+    return 0;
+}
+
+int
+main(void)
+{
+    char buf[MSG_LEN * 4];
+    char msg[MSG_LEN];
+    size_t len = 0;
+    netconf_list *list;
+    unsigned int n = 0;
+    netconf_node *node;
+    te_errno rc;
+    int result = 1;
+
+    list = calloc(1, sizeof(*list));
+    if (list == NULL)
+        return 1;
+
+    /* Notification of another family is skipped */
+    if (fill_trap_msg(msg, FAMILY + 1, DEVLINK_CMD_TRAP_NEW) != 0)
+        goto out;
+    append_msg(buf, &len, msg);
+
+    /* Unsupported devlink command is skipped */
+    init_msg(msg, FAMILY, DEVLINK_CMD_NEW);
+    if (append_str(msg, DEVLINK_ATTR_BUS_NAME, TEST_BUS) != 0)
+        goto out;
+    append_msg(buf, &len, msg);
+
+    if (fill_trap_msg(msg, FAMILY, DEVLINK_CMD_TRAP_NEW) != 0)
+        goto out;
+    append_msg(buf, &len, msg);
+
+    if (fill_trap_msg(msg, FAMILY, DEVLINK_CMD_TRAP_DEL) != 0)
+        goto out;
+    append_msg(buf, &len, msg);
+
+    rc = netconf_devlink_event_parse(FAMILY, buf, len, list);
+    if (rc != 0)
+    {
+        fprintf(stderr, "Failed to parse notifications: %d\n", (int)rc);
+        goto out;
+    }
+
+    for (node = list->head; node != NULL; node = node->next)
+    {
+        if (check_trap(node) != 0)
+            goto out;
+        n++;
+    }
+    if (n != 2)
+    {
+        fprintf(stderr, "%u objects are parsed instead of 2\n", n);
+        goto out;
+    }
+
+    result = 0;
+
+out:
+    netconf_list_free(list);
+
+    if (result != 0)
+        fprintf(stderr, "Test failed\n");
+    return result;
+}
@@ -48,6 +48,8 @@
 #include "te_printf.h"
 #include "te_queue.h"
 #include "te_str.h"
+#include "te_file.h"
+#include "te_trace.h"
 #include "logger_api.h"
 #include "logger_ten.h"
 #include "rcf_api.h"
@@ -472,6 +474,7 @@ send_recv_rcf_ipc_message(thread_ctx_t *ctx,
     char                        ta[RCF_MAX_NAME];
     rcf_msg                    *message;
     rcf_message_match_simple    match_data;
+    te_trace_span               span;
 
 
     if (ctx == NULL || ctx->ipc_handle == NULL ||
@@ -486,6 +489,10 @@ send_recv_rcf_ipc_message(thread_ctx_t *ctx,
 
     send_buf->seqno = ctx->seqno++;
 
+    te_trace_span_start(&span, NULL, "rcfapi.%s",
+                        rcf_op_to_string(send_buf->opcode));
+    send_buf->trace = span.ctx;
+
     INFO("%s: send request %u:%d:'%s'", ipc_client_name(ctx->ipc_handle),
          (unsigned)send_buf->seqno, send_buf->sid,
          rcf_op_to_string(send_buf->opcode));
@@ -502,17 +509,18 @@ send_recv_rcf_ipc_message(thread_ctx_t *ctx,
             INFO("%s() failed with rc %r", __FUNCTION__, rc);
         else
             ERROR("%s() failed with rc %r", __FUNCTION__, rc);
-        return TE_RC(TE_RCF_API, TE_EIPC);
+        rc = TE_RC(TE_RCF_API, TE_EIPC);
+        goto exit;
     }
 
     if ((rc = rcf_ipc_receive_answer(ctx->ipc_handle, recv_buf,
                                      recv_size, p_answer)) != 0)
-        return rc;
+        goto exit;
 
     message = (p_answer != NULL && *p_answer != NULL) ? *p_answer
                                                       : recv_buf;
     if (rcf_message_match(recv_buf, &match_data) == 0)
-        return 0;
+        goto exit;
 
     if (msg_buffer_insert(&ctx->msg_buf_head, message) != 0)
         ERROR("RCF message is lost");
@@ -520,9 +528,13 @@ send_recv_rcf_ipc_message(thread_ctx_t *ctx,
     if (message != recv_buf)
         free(message);
 
-    return wait_rcf_ipc_message(ctx->ipc_handle, &ctx->msg_buf_head,
-                                rcf_message_match, &match_data,
-                                recv_buf, recv_size, p_answer);
+    rc = wait_rcf_ipc_message(ctx->ipc_handle, &ctx->msg_buf_head,
+                              rcf_message_match, &match_data,
+                              recv_buf, recv_size, p_answer);
+
+exit:
+    te_trace_span_end(&span);
+    return rc;
 }
 
 #ifdef HAVE_PTHREAD_H
@@ -1199,6 +1211,116 @@ rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
     return 0;
 }
 
+/**
+ * Append binary attachment of getall answer saved by RCF to the result
+ * and remove the file.
+ *
+ * @param file          name of the file saved by RCF
+ * @param result        TE string to append the attachment to
+ *
+ * @return Status code
+ */
+static te_errno
+cfg_getall_read_attachment(const char *file, te_string *result)
+{
+    te_errno rc;
+
+    rc = te_file_read_string(result, TRUE, 0, "%s", file);
+    if (rc != 0)
+    {
+        ERROR("Cannot read file %s saved by RCF process: %r", file, rc);
+        rc = TE_RC(TE_RCF_API, TE_EIPC);
+    }
+
+    if (unlink(file) != 0)
+        ERROR("Cannot unlink file %s saved by RCF process", file);
+
+    return rc;
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_cfg_getall(const char *ta_name, int session, const char *oid,
+                  unsigned int depth, te_string *result)
+{
+    rcf_msg     msg;
+    size_t      anslen = sizeof(msg);
+    te_errno    read_rc = 0;
+    te_errno    rc;
+
+    rcf_message_match_simple match_data = { RCFOP_CONFGET, ta_name,
+                                            session };
+
+    RCF_API_INIT;
+
+    if (oid == NULL || strlen(oid) >= RCF_MAX_ID || BAD_TA)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    memset(&msg, 0, sizeof(msg));
+    te_strlcpy(msg.id, oid, sizeof(msg.id));
+    te_strlcpy(msg.ta, ta_name, sizeof(msg.ta));
+    if (depth == 0)
+    {
+        TE_SPRINTF(msg.value, "%s", RCF_CONFGET_ALL);
+    }
+    else
+    {
+        TE_SPRINTF(msg.value, "%s %s=%u", RCF_CONFGET_ALL,
+                   RCF_CONFGET_DEPTH, depth);
+    }
+    msg.opcode = RCFOP_CONFGET;
+    msg.sid = session;
+
+    rc = send_recv_rcf_ipc_message(ctx_handle, &msg, sizeof(msg),
+                                   &msg, &anslen, NULL);
+
+    if (rc != 0)
+        return rc;
+
+    /* The TA sends the answer by chunks while it walks the tree */
+    while ((msg.flags & INTERMEDIATE_ANSWER) != 0)
+    {
+        rc = cfg_getall_read_attachment(msg.file, result);
+        if (read_rc == 0)
+            read_rc = rc;
+
+        anslen = sizeof(msg);
+        rc = wait_rcf_ipc_message(ctx_handle->ipc_handle,
+                                  &(ctx_handle->msg_buf_head),
+                                  rcf_message_match, &match_data,
+                                  &msg, &anslen, NULL);
+        if (rc != 0)
+        {
+            ERROR("%s: IPC receive answer fails, rc %r",
+                  __FUNCTION__, rc);
+            return TE_RC(TE_RCF_API, TE_EIPC);
+        }
+    }
+
+    if ((rc = msg.error) != 0)
+    {
+        /* Agents built without getall support reject the options */
+        if (TE_RC_GET_ERROR(rc) == TE_EFMT)
+            rc = TE_RC(TE_RCF_API, TE_EOPNOTSUPP);
+        return rc;
+    }
+
+    if ((msg.flags & BINARY_ATTACHMENT) == 0)
+    {
+        /* The TA does not support getall, it answered as to plain get */
+        return TE_RC(TE_RCF_API, TE_EOPNOTSUPP);
+    }
+
+    rc = cfg_getall_read_attachment(msg.file, result);
+    if (rc == 0 && result->len > 0 && result->ptr[result->len - 1] == '\0')
+    {
+        /* Drop the terminating zero sent by the TA */
+        te_string_cut(result, 1);
+    }
+
+    return rc != 0 ? rc : read_rc;
+}
+
 /**
  * Implementation of rcf_ta_cfg_set and rcf_ta_cfg_add functionality -
  * see description of these functions for details.
@@ -2875,6 +2997,37 @@ rcf_ta_kill_thread(const char *ta_name, int session, int tid)
     return rc == 0 ? msg.error : rc;
 }
 
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_event_wait(const char *ta_name, int session, unsigned int timeout,
+                  char *event, size_t len)
+{
+    rcf_msg     msg;
+    size_t      anslen = sizeof(msg);
+    te_errno    rc;
+
+    RCF_API_INIT;
+
+    if (BAD_TA || event == NULL || len == 0)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    memset(&msg, 0, sizeof(msg));
+    msg.opcode = RCFOP_EVENT_WAIT;
+    te_strlcpy(msg.ta, ta_name, sizeof(msg.ta));
+    msg.sid = session;
+    msg.timeout = timeout;
+
+    rc = send_recv_rcf_ipc_message(ctx_handle, &msg, sizeof(msg),
+                                   &msg, &anslen, NULL);
+    if (rc != 0)
+        return rc;
+
+    if (msg.error == 0)
+        te_strlcpy(event, msg.value, len);
+
+    return msg.error;
+}
+
 /* See description in rcf_api.h */
 te_errno
 rcf_check_agent(const char *ta_name)
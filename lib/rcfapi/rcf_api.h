@@ -20,6 +20,7 @@
 #include "rcf_common.h"
 #include "tad_common.h"
 #include "te_vector.h"
+#include "te_string.h"
 
 /** @defgroup rcfapi_base API: RCF
  * @ingroup rcfapi
@@ -297,6 +298,36 @@ extern te_errno rcf_ta_cfg_get(const char *ta_name, int session,
                                const char *oid,
                                char *val_buf, size_t len);
 
+/**
+ * Obtain identifiers and values of all object instances matching
+ * a wildcard identifier in a single request. The function may be called
+ * by Configurator only.
+ *
+ * Each instance is reported in @p result as a separate line
+ * @c "<oid> <value length>:<value>\n". If the value of an instance
+ * cannot be obtained by the TA, the line is @c "<oid> -\n", so the
+ * value should be requested by rcf_ta_cfg_get() to get the error.
+ * The TA sends the answer by chunks while it walks the tree, they are
+ * appended to @p result as they are received.
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param oid           wildcard object instance identifier
+ *                      (e.g. @c /agent:Agt_A/interface:*\/...)
+ * @param depth         if not zero, maximum number of levels below
+ *                      the last sub-identifier without wildcards
+ * @param result        TE string to append the answer to
+ *
+ * @return error code
+ *
+ * @retval 0               success
+ * @retval TE_EOPNOTSUPP   the Test Agent does not support the request
+ * @retval other           see rcf_ta_cfg_get()
+ */
+extern te_errno rcf_ta_cfg_getall(const char *ta_name, int session,
+                                  const char *oid, unsigned int depth,
+                                  te_string *result);
+
 /**
  * This function is used to change value of object instance.
  * The function may be called by Configurator only.
@@ -1083,6 +1114,30 @@ extern te_errno rcf_ta_kill_task(const char *ta_name, int session,
 extern te_errno rcf_ta_kill_thread(const char *ta_name, int session,
                                    int tid);
 
+/**
+ * Wait for an event posted on the Test Agent (see rcf_pch_event_post()).
+ *
+ * The request is answered as soon as an event is available, so
+ * a dedicated session should be used to avoid blocking of other
+ * requests to the Test Agent.
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param timeout       timeout in milliseconds
+ * @param event         location for the event description
+ * @param len           length of @p event buffer
+ *
+ * @return Status code
+ *
+ * @retval TE_ETIMEDOUT     no events during @p timeout
+ * @retval TE_EBUSY         events are already waited for
+ *                          on the Test Agent
+ * @retval TE_EOPNOTSUPP    events are not supported by the Test Agent
+ */
+extern te_errno rcf_ta_event_wait(const char *ta_name, int session,
+                                  unsigned int timeout,
+                                  char *event, size_t len);
+
 /**
  * Call SUN RPC on the TA.
  *
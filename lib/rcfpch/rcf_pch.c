@@ -44,6 +44,8 @@
 #include "te_defs.h"
 #include "te_stdint.h"
 #include "te_str.h"
+#include "te_perf.h"
+#include "te_trace.h"
 #include "rcf_common.h"
 #include "rcf_internal.h"
 #include "comm_agent.h"
@@ -373,6 +375,7 @@ get_opcode(char **ptr, rcf_op_t *opcode)
     TRY_CMD(KILL);
     TRY_CMD(GET_SNIFFERS);
     TRY_CMD(GET_SNIF_DUMP);
+    TRY_CMD(EVENT_WAIT);
 
 #undef TRY_CMD
 
@@ -397,7 +400,9 @@ transmit_log(struct rcf_comm_connection *conn, char *cbuf,
     te_errno    rc;
     int         ret;
 
-    len = ta_log_get(sizeof(log_data), log_data);
+    /* Logs of a sub-agent are delivered by its parent Test Agent */
+    len = rcf_pch_subagent_self() != NULL ? 0 :
+          ta_log_get(sizeof(log_data), log_data);
 
     ret = snprintf(cbuf + answer_plen, buflen - answer_plen,
                    (len == 0) ? "%u" : "0 attach %u",
@@ -427,6 +432,7 @@ rcf_pch_detach(void)
 {
     rcf_comm_agent_close(&conn);
     rcf_pch_rpc_atfork();
+    rcf_pch_event_atfork();
 }
 
 static void *pch_vfork_saved_conn;
@@ -449,26 +455,70 @@ rcf_pch_attach_vfork(void)
 }
 
 
+/** Histograms of commands processing duration by operation code */
+static te_perf_hist *rcf_pch_perf[RCFOP_EVENT_WAIT + 1];
+
 /**
- * Start Portable Command Handler.
+ * Account duration of a command processing in the histogram
+ * of the command operation code.
  *
- * @param confstr   configuration string for communication library
- * @param info      if not NULL, the string to be send to the engine
- *                  after initialisation
+ * @param opcode    Operation code
+ * @param start     Time when the command processing was started
+ *                  (see te_perf_now_us())
+ */
+static void
+rcf_pch_perf_account(rcf_op_t opcode, uint64_t start)
+{
+    if ((unsigned int)opcode >= TE_ARRAY_LEN(rcf_pch_perf))
+        return;
+
+    if (rcf_pch_perf[opcode] == NULL)
+    {
+        char  name[64];
+        char *p;
+
+        /* Operation names contain spaces which are not allowed */
+        TE_SPRINTF(name, "rcf_pch.%s", rcf_op_to_string(opcode));
+        for (p = name; *p != '\0'; p++)
+        {
+            if (*p == ' ')
+                *p = '_';
+        }
+        rcf_pch_perf[opcode] = te_perf_hist_get("%s", name);
+    }
+
+    te_perf_hist_add(rcf_pch_perf[opcode], te_perf_now_us() - start);
+}
+
+/**
+ * Serve commands received from the Test Engine until the shutdown
+ * command is received or a fatal error occurs.
+ *
+ * @param p_cmd         Location of the command buffer (it may be
+ *                      reallocated)
+ * @param p_cmd_buf_len Location of the command buffer length
+ * @param p_answer_plen Location for the length of the answer prefix
+ *                      of the last command
+ * @param p_opcode      Location for the operation code of the last
+ *                      command
  *
  * @return Status code
  */
-int
-rcf_pch_run(const char *confstr, const char *info)
+static int
+rcf_pch_serve(char **p_cmd, int *p_cmd_buf_len, size_t *p_answer_plen,
+              rcf_op_t *p_opcode)
 {
-    char *cmd = NULL;
+    char *cmd = *p_cmd;
     int   rc = 0;
     int   sid = 0;
-    int   cmd_buf_len = RCF_MAX_LEN;
+    int   cmd_buf_len = *p_cmd_buf_len;
 
     size_t   answer_plen = 0;
     rcf_op_t opcode = 0;
-    te_errno rc2;
+    uint64_t start;
+
+    te_trace_ctx  trace;
+    te_trace_span span = { .ctx = TE_TRACE_CTX_INIT };
 
 /**
  * Read any integer parameter from the command.
@@ -509,44 +559,6 @@ rcf_pch_run(const char *confstr, const char *info)
             goto communication_problem;                             \
     } while (FALSE)
 
-    rcf_pch_init_id(confstr);
-
-    VERB("Starting Portable Commands Handler");
-
-    if (rcf_ch_init() != 0)
-    {
-        VERB("Initialization of CH library failed");
-        goto exit;
-    }
-    rcf_pch_cfg_init();
-
-    rc = rcf_ch_tad_init();
-    if (TE_RC_GET_ERROR(rc) == TE_ENOSYS)
-    {
-        WARN("Traffic Application Domain operations are not supported");
-    }
-    else if (rc != 0)
-    {
-        ERROR("Traffic Application Domain initialization failed: %r", rc);
-        /* Continue, but TAD operation will fail */
-    }
-
-    if ((cmd = (char *)malloc(RCF_MAX_LEN)) == NULL)
-        return TE_RC(TE_RCF_PCH, TE_ENOMEM);
-
-    if ((rc = rcf_comm_agent_init(confstr, &conn)) != 0 ||
-        (info != NULL &&
-         (rc = rcf_comm_agent_reply(conn, info, strlen(info) + 1)) != 0))
-    {
-        goto communication_problem;
-    }
-
-#if defined(HAVE_PTHREAD_ATFORK)
-    pthread_atfork(NULL, NULL, rcf_pch_detach);
-#endif
-    register_vfork_hook(rcf_pch_detach_vfork, rcf_pch_attach_vfork,
-                        rcf_pch_detach);
-
     while (TRUE)
     {
         size_t   len = cmd_buf_len;
@@ -577,7 +589,9 @@ rcf_pch_run(const char *confstr, const char *info)
                       old_cmd);
 
                 free(old_cmd);
-                return -1;
+                cmd = NULL;
+                rc = -1;
+                goto exit;
             }
             cmd_buf_len = len;
             tmp = len - received;
@@ -594,6 +608,14 @@ rcf_pch_run(const char *confstr, const char *info)
         }
         VERB("Command <%s> is received", cmd);
 
+        if (*cmd == TE_PROTO_SUBAGENT)
+        {
+            rc = rcf_pch_subagent_relay(conn, cmd, len);
+            if (rc != 0)
+                goto communication_problem;
+            continue;
+        }
+
         ptr = cmd;
         /* Skipping SID */
         if (strncmp(ptr, "SID ", strlen("SID ")) == 0)
@@ -605,9 +627,28 @@ rcf_pch_run(const char *confstr, const char *info)
             answer_plen = ptr - cmd;
         }
 
+        /* Trace context of the request is optional */
+        memset(&trace, 0, sizeof(trace));
+        if (strncmp(ptr, TE_PROTO_TRACE " ",
+                    strlen(TE_PROTO_TRACE " ")) == 0)
+        {
+            const char *end;
+
+            ptr += strlen(TE_PROTO_TRACE " ");
+            if (te_trace_ctx_parse(ptr, &trace, &end) != 0)
+                goto bad_protocol;
+            ptr = (char *)end;
+            SKIP_SPACES(ptr);
+        }
+
         if (get_opcode(&ptr, &opcode) != 0)
             goto bad_protocol;
 
+        start = te_perf_now_us();
+        te_trace_span_start(&span, &trace, "rcf_pch.%s",
+                            rcf_op_to_string(opcode));
+        if (te_trace_span_active(&span))
+            te_trace_set_current(&span.ctx);
         SKIP_SPACES(ptr);
         switch (opcode)
         {
@@ -671,11 +712,19 @@ rcf_pch_run(const char *confstr, const char *info)
                 if (*ptr == 0 || transform_str(&ptr, &oid) != 0)
                     goto bad_protocol;
 
-                if (opcode == RCFOP_CONFGET || opcode == RCFOP_CONFDEL)
+                if (opcode == RCFOP_CONFDEL)
                 {
                     if (*ptr != 0)
                         goto bad_protocol;
                 }
+                else if (opcode == RCFOP_CONFGET)
+                {
+                    /* Optional getall options may follow wildcard OID */
+                    if (*ptr != 0 &&
+                        (ba != NULL || transform_str(&ptr, &val) != 0 ||
+                         *ptr != 0))
+                        goto bad_protocol;
+                }
                 else if (*ptr == 0 && ba == NULL)
                 {
                     if (opcode != RCFOP_CONFADD)
@@ -1271,6 +1320,25 @@ rcf_pch_run(const char *confstr, const char *info)
                 break;
             }
 
+            case RCFOP_EVENT_WAIT:
+            {
+                unsigned int timeout;
+
+                if (*ptr == 0 || ba != NULL)
+                    goto bad_protocol;
+
+                READ_INT(timeout);
+                if (*ptr != 0)
+                    goto bad_protocol;
+
+                rc = rcf_pch_event_wait(conn, cmd, cmd_buf_len,
+                                        answer_plen, timeout);
+                if (rc != 0)
+                    goto communication_problem;
+
+                break;
+            }
+
             case RCFOP_KILL:
             {
                 unsigned int pid;
@@ -1311,17 +1379,148 @@ rcf_pch_run(const char *confstr, const char *info)
             default:
                 assert(FALSE);
         }
+        rcf_pch_perf_account(opcode, start);
+        te_trace_span_end(&span);
+        te_trace_set_current(NULL);
         continue;
 
     bad_protocol:
         ERROR("Bad protocol command <%s> is received", cmd);
         SEND_ANSWER("%d bad command", TE_RC(TE_RCF_PCH, TE_EFMT));
+        te_trace_span_end(&span);
+        te_trace_set_current(NULL);
     }
 
 communication_problem:
     ERROR("Fatal communication error %r", rc);
     LOG_PRINT("Fatal communication error %s", te_rc_err2str(rc));
 
+exit:
+    /* The span of the request is not ended if it is broken off */
+    te_trace_span_end(&span);
+    te_trace_set_current(NULL);
+
+    *p_cmd = cmd;
+    *p_cmd_buf_len = cmd_buf_len;
+    *p_answer_plen = answer_plen;
+    *p_opcode = opcode;
+
+    return rc;
+
+#undef READ_INT
+#undef SEND_ANSWER
+}
+
+/**
+ * Answer the shutdown command.
+ *
+ * @param cmd           Command buffer
+ * @param cmd_buf_len   Command buffer length
+ * @param answer_plen   Length of the answer prefix
+ */
+static void
+rcf_pch_answer_shutdown(char *cmd, int cmd_buf_len, size_t answer_plen)
+{
+    snprintf(cmd + answer_plen, cmd_buf_len - answer_plen, "0");
+
+    RCF_CH_LOCK;
+    (void)rcf_comm_agent_reply(conn, cmd, strlen(cmd) + 1);
+    RCF_CH_UNLOCK;
+}
+
+/* See description in rcf_pch_internal.h */
+void
+rcf_pch_subagent_serve(struct rcf_comm_connection *sub_conn)
+{
+    char     *cmd = malloc(RCF_MAX_LEN);
+    int       cmd_buf_len = RCF_MAX_LEN;
+    size_t    answer_plen = 0;
+    rcf_op_t  opcode = 0;
+    int       rc;
+
+    conn = sub_conn;
+
+    if (cmd == NULL)
+        rc = TE_RC(TE_RCF_PCH, TE_ENOMEM);
+    else
+        rc = rcf_pch_serve(&cmd, &cmd_buf_len, &answer_plen, &opcode);
+
+    /*
+     * Everything else is shared with the parent Test Agent and is
+     * released by it, only RPC servers of the sub-agent are stopped.
+     */
+    rcf_pch_rpc_shutdown();
+    if (opcode == RCFOP_SHUTDOWN)
+        rcf_pch_answer_shutdown(cmd, cmd_buf_len, answer_plen);
+    rcf_comm_agent_close(&conn);
+    free(cmd);
+
+    _exit(rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/**
+ * Start Portable Command Handler.
+ *
+ * @param confstr   configuration string for communication library
+ * @param info      if not NULL, the string to be send to the engine
+ *                  after initialisation
+ *
+ * @return Status code
+ */
+int
+rcf_pch_run(const char *confstr, const char *info)
+{
+    char *cmd = NULL;
+    int   rc = 0;
+    int   cmd_buf_len = RCF_MAX_LEN;
+
+    size_t   answer_plen = 0;
+    rcf_op_t opcode = 0;
+    te_errno rc2;
+
+    rcf_pch_init_id(confstr);
+
+    VERB("Starting Portable Commands Handler");
+
+    if (rcf_ch_init() != 0)
+    {
+        VERB("Initialization of CH library failed");
+        goto exit;
+    }
+    rcf_pch_cfg_init();
+
+    rc = rcf_ch_tad_init();
+    if (TE_RC_GET_ERROR(rc) == TE_ENOSYS)
+    {
+        WARN("Traffic Application Domain operations are not supported");
+    }
+    else if (rc != 0)
+    {
+        ERROR("Traffic Application Domain initialization failed: %r", rc);
+        /* Continue, but TAD operation will fail */
+    }
+
+    if ((cmd = (char *)malloc(RCF_MAX_LEN)) == NULL)
+        return TE_RC(TE_RCF_PCH, TE_ENOMEM);
+
+    if ((rc = rcf_comm_agent_init(confstr, &conn)) != 0 ||
+        (info != NULL &&
+         (rc = rcf_comm_agent_reply(conn, info, strlen(info) + 1)) != 0))
+    {
+        ERROR("Fatal communication error %r", rc);
+        LOG_PRINT("Fatal communication error %s", te_rc_err2str(rc));
+        goto exit;
+    }
+
+#if defined(HAVE_PTHREAD_ATFORK)
+    pthread_atfork(NULL, NULL, rcf_pch_detach);
+#endif
+    register_vfork_hook(rcf_pch_detach_vfork, rcf_pch_attach_vfork,
+                        rcf_pch_detach);
+
+    rcf_pch_subagent_init(conn);
+    rc = rcf_pch_serve(&cmd, &cmd_buf_len, &answer_plen, &opcode);
+
 exit:
     rc2 = rcf_ch_tad_shutdown();
     if (rc2 != 0)
@@ -1331,13 +1530,15 @@ exit:
               te_rc_err2str(rc2));
         TE_RC_UPDATE(rc, rc2);
     }
+    rcf_pch_subagent_shutdown();
     rcf_ch_conf_fini();
     ta_obj_cleanup();
     rcf_pch_rpc_shutdown();
+    rcf_pch_event_shutdown();
     if (opcode == RCFOP_SHUTDOWN &&
         rcf_ch_shutdown(conn, cmd, cmd_buf_len, answer_plen) < 0)
     {
-        SEND_ANSWER("0");
+        rcf_pch_answer_shutdown(cmd, cmd_buf_len, answer_plen);
     }
     rcf_comm_agent_close(&conn);
     free(cmd);
@@ -1346,8 +1547,5 @@ exit:
     LOG_PRINT("Exiting: %d", rc);
 
     return rc;
-
-#undef READ_INT
-#undef SEND_ANSWER
 }
 
@@ -17,6 +17,7 @@
 
 #include "te_defs.h"
 #include "te_stdint.h"
+#include "te_string.h"
 #include "rcf_common.h"
 #include "comm_agent.h"
 
@@ -124,7 +125,8 @@ extern void rcf_pch_cfg_init(void);
  *
  * @param op            configure operation
  * @param oid           object instance identifier or NULL
- * @param val           object instance value or NULL
+ * @param val           object instance value, options of wildcard get
+ *                      request (see RCF_CONFGET_ALL) or NULL
  *
  *
  * @return 0 or error returned by communication library
@@ -215,8 +217,51 @@ extern int rcf_pch_call(struct rcf_comm_connection *conn,
 extern int rcf_pch_rpc(struct rcf_comm_connection *conn, int sid,
                        const char *data, size_t len,
                        const char *server, uint32_t timeout);
+
+/**
+ * Event wait handler. The answer is sent when an event is posted
+ * using rcf_pch_event_post() or the timeout expires.
+ *
+ * @param conn          connection handle
+ * @param cbuf          command buffer
+ * @param buflen        length of the command buffer
+ * @param answer_plen   number of bytes in the command buffer to be
+ *                      copied to the answer
+ * @param timeout       timeout in milliseconds
+ *
+ * @return 0 or error returned by communication library
+ */
+extern int rcf_pch_event_wait(struct rcf_comm_connection *conn,
+                              char *cbuf, size_t buflen,
+                              size_t answer_plen, unsigned int timeout);
 /**@} */
 
+/**
+ * Post an event to be delivered to the Test Engine.
+ * It may be called from any thread of the Test Agent.
+ *
+ * If nobody waits for events, they are queued (the oldest ones
+ * are dropped if there are too many of them).
+ *
+ * @param fmt           format string of the event description
+ * @param ...           format string arguments
+ *
+ * @return Status code.
+ */
+extern te_errno rcf_pch_event_post(const char *fmt, ...)
+                                   __attribute__((format(printf, 1, 2)));
+
+/**
+ * Stop events delivery and drop undelivered events.
+ */
+extern void rcf_pch_event_shutdown(void);
+
+/**
+ * Forget events and the delivery thread state inherited from the parent
+ * process. It is called in a child process after fork().
+ */
+extern void rcf_pch_event_atfork(void);
+
 /** @addtogroup rcf_pch
  * @{
  */
@@ -242,6 +287,15 @@ extern void rcf_pch_rpc_init(const char *tmp_path);
  */
 extern void rcf_pch_rpc_atfork(void);
 
+/**
+ * Start RCF RPC support again in a child process after
+ * rcf_pch_rpc_atfork(). RPC servers created afterwards are children
+ * of this process and connect to its own RPC transport.
+ *
+ * @return Status code.
+ */
+extern te_errno rcf_pch_rpc_restart(void);
+
 /**
  * Cleanup RCF RPC server structures.
  */
@@ -252,6 +306,67 @@ extern void rcf_pch_rpc_shutdown(void);
  */
 extern const char *rcf_pch_rpc_get_provider(void);
 
+/**
+ * Sub-agents.
+ *
+ * A sub-agent is a child process of the Test Agent serving another
+ * Test Agent name (usually in another network namespace). The Test
+ * Engine reaches it via the connection of the parent Test Agent:
+ * commands and answers of the sub-agent are prefixed with
+ * @c TE_PROTO_SUBAGENT and the sub-agent name.
+ */
+
+/**
+ * Callback called in the sub-agent process before it starts serving
+ * commands (e.g. to move the process to a network namespace).
+ *
+ * @param name      Sub-agent name
+ * @param opaque    Data passed to rcf_pch_subagent_start()
+ *
+ * @return Status code (the sub-agent is not started if it is not zero)
+ */
+typedef te_errno (rcf_pch_subagent_enter)(const char *name, void *opaque);
+
+/**
+ * Start a sub-agent. The function returns when the sub-agent is ready
+ * to serve commands or has failed to start.
+ *
+ * @param name      Sub-agent name (the Test Agent name used by
+ *                  the Test Engine)
+ * @param enter     Callback called in the sub-agent process or @c NULL
+ * @param opaque    Data passed to @p enter
+ *
+ * @return Status code
+ */
+extern te_errno rcf_pch_subagent_start(const char *name,
+                                       rcf_pch_subagent_enter *enter,
+                                       void *opaque);
+
+/**
+ * Stop a sub-agent.
+ *
+ * @param name      Sub-agent name
+ *
+ * @return Status code
+ */
+extern te_errno rcf_pch_subagent_stop(const char *name);
+
+/**
+ * Check whether a sub-agent is started.
+ *
+ * @param name      Sub-agent name
+ *
+ * @return @c TRUE if the sub-agent is started
+ */
+extern te_bool rcf_pch_subagent_exists(const char *name);
+
+/**
+ * Get the name of the sub-agent served by the current process.
+ *
+ * @return Sub-agent name or @c NULL in the Test Agent process
+ */
+extern const char *rcf_pch_subagent_self(void);
+
 /** @addtogroup rcf_pch
  * @{
  */
@@ -283,6 +398,85 @@ extern te_errno rpcserver_plugin_disable(void);
  * @{
  */
 
+/**
+ * Function releasing data stored in the configuration snapshot.
+ *
+ * @param data      Data to release
+ */
+typedef void (rcf_pch_snapshot_free)(void *data);
+
+/**
+ * Get data stored in the configuration snapshot by a handler.
+ *
+ * The snapshot lets handlers of sibling objects share state read
+ * once (for example, one netlink dump of all interfaces) while
+ * a configuration request is processed. The snapshot is dropped
+ * before each request except a get in a group of requests, so within
+ * a wildcard request walking the whole tree all handlers see the same
+ * state, and modifications are never answered from outdated data.
+ *
+ * @param key       Key of the data
+ *
+ * @return Data or @c NULL if it is not stored in the current request.
+ */
+extern void *rcf_pch_snapshot_get(const char *key);
+
+/**
+ * Store data in the configuration snapshot. The snapshot takes
+ * ownership of the data, so the pointer must not be used after
+ * the current configuration handler returns.
+ *
+ * @param key       Key of the data
+ * @param data      Data
+ * @param free_cb   Function to release the data or @c NULL
+ */
+extern void rcf_pch_snapshot_put(const char *key, void *data,
+                                 rcf_pch_snapshot_free *free_cb);
+
+/**
+ * Check whether the configuration snapshot may be shared by several
+ * handler calls, i.e. a wildcard get request or a group of requests
+ * is being processed. Otherwise a handler serves a single request,
+ * and reading just the requested value is cheaper than taking
+ * a snapshot of the whole state.
+ *
+ * @return @c TRUE if the snapshot is worth taking.
+ */
+extern te_bool rcf_pch_snapshot_active(void);
+
+/**
+ * Function releasing a value returned by reference.
+ *
+ * @param data      Value to release
+ */
+typedef void (rcf_pch_value_free)(void *data);
+
+/**
+ * Return a value of an object instance from a get handler by reference
+ * instead of copying it to the @c RCF_MAX_VAL bytes buffer passed to
+ * the handler (the buffer is ignored then). The value is sent to
+ * the Test Engine as a binary attachment directly from @p data, so
+ * its length is not limited.
+ *
+ * The value is released after the answer is sent or if the handler
+ * fails. Substitutions are not applied to values returned by reference.
+ *
+ * @param data      Value (terminating @c NUL is not required)
+ * @param len       Length of the value
+ * @param free_cb   Function to release the value or @c NULL
+ */
+extern void rcf_pch_value_set_ref(void *data, size_t len,
+                                  rcf_pch_value_free *free_cb);
+
+/**
+ * Return a value of an object instance from a get handler by reference
+ * taking ownership of the string buffer (see rcf_pch_value_set_ref()).
+ *
+ * @param str       String with the value (it is empty on return,
+ *                  must not use an external buffer)
+ */
+extern void rcf_pch_value_set_string(te_string *str);
+
 /**
  * Find a node corresponding to an object with a
  * given OID.
@@ -364,8 +558,21 @@ extern te_errno rcf_pch_del_node(rcf_pch_cfg_object *node);
  * te_lock_dir should be exported by the TA.
  *
  * If lock of dead TA is found it is automatically removed.
+ *
+ * If @ref RCF_PCH_LOCKD_ENV is set to a non-zero value in the TA
+ * environment, locks are kept by a per-host lock service instead of
+ * lock files. The service is started by the first TA which needs it and
+ * listens on `${te_lockdir}/te_ta_lockd.sock`. Locks of a terminated TA
+ * are released by the service immediately. If the service cannot be
+ * reached, grabbing of resources fails rather than falling back to lock
+ * files, and locks held via a broken connection to the service are
+ * reported as lost. All TAs sharing resources on a host must use the
+ * same locking scheme.
  */
 
+/** Environment variable enabling per-host lock service for resources */
+#define RCF_PCH_LOCKD_ENV "TE_TA_RSRC_LOCKD"
+
 /**
  * Callback for resource grabbing.
  *
@@ -458,6 +665,12 @@ extern te_errno rcf_pch_rsrc_check_locks(const char *rsrc_ptrn);
  */
 extern void rcf_pch_rsrc_init(void);
 
+/**
+ * Link performance counters configuration tree (@c /agent/perf)
+ * exposing metrics registered on the Test Agent (see te_perf.h).
+ */
+extern void rcf_pch_perf_init(void);
+
 /** Directory for locks creation */
 extern const char *te_lockdir;
 
@@ -60,6 +60,12 @@
 
 #define OID_ETC "/..."
 
+/**
+ * Size of accumulated part of configure getall answer which is sent
+ * to RCF without waiting for the end of the walk
+ */
+#define GETALL_CHUNK_SIZE   (64 * 1024)
+
 /**
  * Root of the Test Agent configuration tree. RCF PCH function is
  * used as list callback.
@@ -78,6 +84,28 @@ typedef struct olist {
     char          oid[CFG_OID_MAX]; /**< Element OID */
 } olist;
 
+/**
+ * Callback invoked for every object instance matching a wildcard.
+ *
+ * @param obj       object of the instance
+ * @param oid       object instance identifier
+ * @param data      opaque data of the callback
+ *
+ * @return Status code
+ */
+typedef te_errno (*wildcard_inst_cb)(rcf_pch_cfg_object *obj,
+                                     const char *oid, void *data);
+
+/** Context of the wildcard object instances walk */
+typedef struct wildcard_inst_ctx {
+    const char       *full_oid;     /**< Initial identifier */
+    unsigned int      max_level;    /**< Maximum number of sub-identifiers
+                                         in reported OIDs (0 for no
+                                         limit) */
+    wildcard_inst_cb  cb;           /**< Callback for matched instances */
+    void             *data;         /**< Callback data */
+} wildcard_inst_ctx;
+
 /** Postponed configuration commit operation */
 typedef struct rcf_pch_commit_op_t {
     TAILQ_ENTRY(rcf_pch_commit_op_t)    links;  /**< Tail queue links */
@@ -90,6 +118,132 @@ static TAILQ_HEAD(rcf_pch_commit_head_t, rcf_pch_commit_op_t)   commits;
 
 static te_bool      is_group = FALSE;       /**< Is group started? */
 static unsigned int gid;                    /**< Group identifier */
+static te_bool      is_wildcard = FALSE;    /**< Is wildcard request
+                                                 processed? */
+
+/** Data stored in the configuration snapshot */
+typedef struct snapshot_entry {
+    SLIST_ENTRY(snapshot_entry)  links;     /**< List links */
+    char                        *key;       /**< Key of the data */
+    void                        *data;      /**< Data */
+    rcf_pch_snapshot_free       *free_cb;   /**< Function to free data */
+} snapshot_entry;
+
+/**
+ * Snapshot of the configuration shared by handlers within one
+ * configuration request or a sequence of get requests in a group.
+ * It is dropped when the next request which is not such a get starts,
+ * so a wildcard request (used by Configurator to synchronize the tree)
+ * is answered from one consistent snapshot and modifications are never
+ * answered from outdated data.
+ */
+static SLIST_HEAD(, snapshot_entry) snapshot =
+    SLIST_HEAD_INITIALIZER(snapshot);
+
+/** Free all data of the configuration snapshot */
+static void
+snapshot_drop(void)
+{
+    snapshot_entry *entry;
+
+    while ((entry = SLIST_FIRST(&snapshot)) != NULL)
+    {
+        SLIST_REMOVE_HEAD(&snapshot, links);
+        if (entry->free_cb != NULL)
+            entry->free_cb(entry->data);
+        free(entry->key);
+        free(entry);
+    }
+}
+
+/* See description in rcf_pch.h */
+void *
+rcf_pch_snapshot_get(const char *key)
+{
+    snapshot_entry *entry;
+
+    SLIST_FOREACH(entry, &snapshot, links)
+    {
+        if (strcmp(entry->key, key) == 0)
+            return entry->data;
+    }
+
+    return NULL;
+}
+
+/* See description in rcf_pch.h */
+void
+rcf_pch_snapshot_put(const char *key, void *data,
+                     rcf_pch_snapshot_free *free_cb)
+{
+    snapshot_entry *entry;
+
+    SLIST_FOREACH(entry, &snapshot, links)
+    {
+        if (strcmp(entry->key, key) == 0)
+        {
+            if (entry->free_cb != NULL && entry->data != data)
+                entry->free_cb(entry->data);
+            entry->data = data;
+            entry->free_cb = free_cb;
+            return;
+        }
+    }
+
+    entry = TE_ALLOC(sizeof(*entry));
+    entry->key = TE_STRDUP(key);
+    entry->data = data;
+    entry->free_cb = free_cb;
+    SLIST_INSERT_HEAD(&snapshot, entry, links);
+}
+
+/* See description in rcf_pch.h */
+te_bool
+rcf_pch_snapshot_active(void)
+{
+    return is_wildcard || is_group;
+}
+
+/** Value returned by a get handler by reference */
+static struct {
+    te_bool             set;        /**< Value is returned by reference */
+    void               *data;       /**< Value */
+    size_t              len;        /**< Length of the value */
+    rcf_pch_value_free *free_cb;    /**< Function to free the value */
+} value_ref;
+
+/** Release the value returned by reference, if any */
+static void
+value_ref_release(void)
+{
+    if (value_ref.set && value_ref.free_cb != NULL)
+        value_ref.free_cb(value_ref.data);
+
+    memset(&value_ref, 0, sizeof(value_ref));
+}
+
+/* See description in rcf_pch.h */
+void
+rcf_pch_value_set_ref(void *data, size_t len, rcf_pch_value_free *free_cb)
+{
+    value_ref_release();
+
+    value_ref.set = TRUE;
+    value_ref.data = data;
+    value_ref.len = len;
+    value_ref.free_cb = free_cb;
+}
+
+/* See description in rcf_pch.h */
+void
+rcf_pch_value_set_string(te_string *str)
+{
+    size_t  len = str->len;
+    char   *data;
+
+    te_string_move(&data, str);
+    rcf_pch_value_set_ref(data, len, free);
+}
 
 
 /** Test Agent root node */
@@ -243,24 +397,45 @@ parse_one_level(char *oid, char **next_level, char **sub_id,
 }
 
 /**
- * Create or update list of object instance identifiers matching to
- * provided wildcard identifier.
+ * Count number of sub-identifiers in the object instance identifier.
+ *
+ * @param oid           object instance identifier
+ *
+ * @return Number of sub-identifiers
+ */
+static unsigned int
+oid_level(const char *oid)
+{
+    unsigned int level = 0;
+
+    for (; *oid != '\0'; oid++)
+    {
+        if (*oid == '/')
+            level++;
+    }
+
+    return level;
+}
+
+/**
+ * Walk object instances matching to provided wildcard identifier
+ * and invoke the callback for each of them.
  *
  * @param obj           root of the objects subtree
  * @param parsed        already parsed part of initial identifier or NULL
  * @param oid           wildcard identifier (or its tail if part is
  *                      already parsed)
- * @param full_oid      initial identifier
- * @param list          list of identifiers to be updated
+ * @param ctx           walk context
  *
  * @return Status code
  * @retval 0               success
  * @retval TE_EINVAL       invalid identifier
  * @retval TE_ENOMEM       malloc() failed
+ * @retval other           error returned by the callback
  */
 static te_errno
-create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
-                          const char *full_oid, olist **list)
+walk_wildcard_inst(rcf_pch_cfg_object *obj, char *parsed, char *oid,
+                   const wildcard_inst_ctx *ctx)
 {
     char *sub_id = NULL;
     char *inst_name = NULL;
@@ -276,8 +451,6 @@ create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
  */
 #define RET(_rc) \
     do {                                \
-        if ((_rc) != 0)                 \
-            free_list(*list);           \
         free(sub_id);                   \
         free(inst_name);                \
         return (_rc);                   \
@@ -289,7 +462,7 @@ create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
     if (parse_one_level(oid, &next_level, &sub_id, &inst_name) != 0)
         RET(TE_EINVAL);
 
-    all = strcmp(full_oid, "*:*") == 0 || strcmp(sub_id, OID_ETC) == 0;
+    all = strcmp(ctx->full_oid, "*:*") == 0 || strcmp(sub_id, OID_ETC) == 0;
 
     for ( ; obj != NULL; obj = obj->brother)
     {
@@ -344,7 +517,8 @@ create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
              strlen(tmp_inst_name) > 0;
              tmp_inst_name = tmp)
         {
-            char  tmp_parsed[CFG_OID_MAX];
+            char         tmp_parsed[CFG_OID_MAX];
+            unsigned int level;
 
             if ((tmp = strchr(tmp_inst_name, ' ')) == NULL)
             {
@@ -364,26 +538,27 @@ create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
                      obj->sub_id, tmp_inst_name);
             tmp_parsed[CFG_OID_MAX - 1] = '\0';
 
+            level = oid_level(tmp_parsed);
+            if (ctx->max_level != 0 && level > ctx->max_level)
+                continue;
+
             if (*next_level == 0 || all || strcmp(next_level, OID_ETC) == 0)
             {
-                olist *new_entry;
-
-                if ((new_entry = (olist *)malloc(sizeof(olist))) == NULL)
+                rc = ctx->cb(obj, tmp_parsed, ctx->data);
+                if (rc != 0)
                 {
                     free(tmp_list);
-                    RET(TE_ENOMEM);
+                    RET(rc);
                 }
-
-                strcpy(new_entry->oid, tmp_parsed);
-
-                new_entry->next = *list;
-                *list = new_entry;
             }
 
             rc = 0;
-            if (obj->son != NULL && *next_level != 0)
-                rc = create_wildcard_inst_list(obj->son, tmp_parsed,
-                                               next_level, full_oid, list);
+            if (obj->son != NULL && *next_level != 0 &&
+                (ctx->max_level == 0 || level < ctx->max_level))
+            {
+                rc = walk_wildcard_inst(obj->son, tmp_parsed,
+                                        next_level, ctx);
+            }
             if (rc != 0)
             {
                 free(tmp_list);
@@ -407,6 +582,65 @@ create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
 #undef RET
 }
 
+/** Callback for walk_wildcard_inst() adding instances to olist */
+static te_errno
+add_wildcard_inst_to_list(rcf_pch_cfg_object *obj, const char *oid,
+                          void *data)
+{
+    olist **list = data;
+    olist  *new_entry;
+
+    UNUSED(obj);
+
+    if ((new_entry = (olist *)malloc(sizeof(olist))) == NULL)
+        return TE_ENOMEM;
+
+    strcpy(new_entry->oid, oid);
+
+    new_entry->next = *list;
+    *list = new_entry;
+
+    return 0;
+}
+
+/**
+ * Create or update list of object instance identifiers matching to
+ * provided wildcard identifier.
+ *
+ * @param obj           root of the objects subtree
+ * @param parsed        already parsed part of initial identifier or NULL
+ * @param oid           wildcard identifier (or its tail if part is
+ *                      already parsed)
+ * @param full_oid      initial identifier
+ * @param list          list of identifiers to be updated
+ *
+ * @return Status code
+ * @retval 0               success
+ * @retval TE_EINVAL       invalid identifier
+ * @retval TE_ENOMEM       malloc() failed
+ */
+static te_errno
+create_wildcard_inst_list(rcf_pch_cfg_object *obj, char *parsed, char *oid,
+                          const char *full_oid, olist **list)
+{
+    wildcard_inst_ctx ctx = {
+        .full_oid = full_oid,
+        .max_level = 0,
+        .cb = add_wildcard_inst_to_list,
+        .data = list,
+    };
+    te_errno rc;
+
+    rc = walk_wildcard_inst(obj, parsed, oid, &ctx);
+    if (rc != 0)
+    {
+        free_list(*list);
+        *list = NULL;
+    }
+
+    return rc;
+}
+
 /**
  * Create or update list of object identifiers matching to
  * provided wildcard identifier.
@@ -545,6 +779,57 @@ convert_to_answer(olist *list, char **answer)
     return 0;
 }
 
+/**
+ * Send successful answer with a binary attachment. The answer header
+ * and the attachment are written to the connection at once directly
+ * from the passed buffers, the terminating @c NUL is appended to
+ * the attachment.
+ *
+ * @param conn            connection handle
+ * @param cbuf            command buffer
+ * @param buflen          length of the command buffer
+ * @param answer_plen     number of bytes in the command buffer
+ *                        to be copied to the answer
+ * @param data            attachment
+ * @param len             length of the attachment
+ *
+ * @return 0 or error returned by communication library
+ */
+static te_errno
+send_attachment(struct rcf_comm_connection *conn, char *cbuf,
+                size_t buflen, size_t answer_plen,
+                const void *data, size_t len)
+{
+    static char zero = '\0';
+
+    struct iovec iov[3];
+    int          hdr_len;
+    te_errno     rc;
+
+    hdr_len = snprintf(cbuf + answer_plen, buflen - answer_plen,
+                       "0 attach %zu", len + 1);
+    if (hdr_len < 0 || (size_t)hdr_len >= buflen - answer_plen)
+    {
+        ERROR("Command buffer too small for reply");
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_E2BIG));
+    }
+
+    iov[0].iov_base = cbuf;
+    iov[0].iov_len = answer_plen + hdr_len + 1;
+    iov[1].iov_base = (void *)data;
+    iov[1].iov_len = len;
+    iov[2].iov_base = &zero;
+    iov[2].iov_len = 1;
+
+    RCF_CH_LOCK;
+    rc = rcf_comm_agent_reply_v(conn, iov, TE_ARRAY_LEN(iov));
+    RCF_CH_UNLOCK;
+    VERB("Sent answer '%s' with binary attachment len=%zu rc=%d",
+         cbuf, len + 1, rc);
+
+    return rc;
+}
+
 /**
  * Process wildcard configure get request.
  *
@@ -591,27 +876,7 @@ process_wildcard(struct rcf_comm_connection *conn, char *cbuf,
     if ((rc != 0 )|| ((rc = convert_to_answer(list, &tmp)) != 0))
         SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
 
-    if ((size_t)snprintf(cbuf + answer_plen, buflen - answer_plen,
-                         "0 attach %u",
-                         (unsigned int)(strlen(tmp) + 1)) >=
-            (buflen - answer_plen))
-    {
-        free(tmp);
-        ERROR("Command buffer too small for reply");
-        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_E2BIG));
-    }
-
-    RCF_CH_LOCK;
-    rc = rcf_comm_agent_reply(conn, cbuf, strlen(cbuf) + 1);
-    VERB("Sent answer to wildcard request '%s' len=%u rc=%d",
-         cbuf,  strlen(cbuf) + 1, rc);
-    if (rc == 0)
-    {
-        rc = rcf_comm_agent_reply(conn, tmp, strlen(tmp) + 1);
-        VERB("Sent binary attachment len=%u rc=%d", strlen(tmp) + 1, rc);
-    }
-    RCF_CH_UNLOCK;
-
+    rc = send_attachment(conn, cbuf, buflen, answer_plen, tmp, strlen(tmp));
     free(tmp);
 
     return rc;
@@ -967,6 +1232,329 @@ out:
     return rc;
 }
 
+/**
+ * Get the value of the object instance applying substitutions
+ * the same way as a configure get request does.
+ *
+ * @param[in]  obj      object of the instance
+ * @param[in]  oid      object instance identifier
+ * @param[out] value    location for the value (RCF_MAX_VAL bytes)
+ *
+ * @return Status code
+ */
+static te_errno
+get_instance_value(rcf_pch_cfg_object *obj, const char *oid, char *value)
+{
+#define ALL_INST_NAMES \
+    inst_names[0], inst_names[1], inst_names[2], inst_names[3], \
+    inst_names[4], inst_names[5], inst_names[6], inst_names[7], \
+    inst_names[8], inst_names[9]
+
+    char *inst_names[RCF_MAX_PARAMS] = {NULL,};
+    cfg_oid *p_oid;
+    cfg_inst_subid *p_ids;
+    unsigned int i;
+    te_errno rc;
+
+    *value = '\0';
+    if (obj->get == NULL)
+        return 0;
+
+    p_oid = cfg_convert_oid_str(oid);
+    if (p_oid == NULL)
+        return TE_EFMT;
+
+    p_ids = (cfg_inst_subid *)(p_oid->ids);
+    for (i = 2; i < p_oid->len && i - 2 < RCF_MAX_PARAMS; i++)
+        inst_names[i - 2] = p_ids[i].name;
+
+    value_ref_release();
+    rc = (obj->get)(gid, oid, value, ALL_INST_NAMES);
+    if (rc == 0 && obj->subst != NULL && !value_ref.set)
+        rc = do_substitutions(obj, value, p_ids[p_oid->len - 1].name, p_ids);
+    if (rc != 0)
+        value_ref_release();
+
+    cfg_free_oid(p_oid);
+
+    return rc;
+#undef ALL_INST_NAMES
+}
+
+/** Callback for walk_wildcard_inst() appending instances with values */
+static te_errno
+add_wildcard_inst_value(rcf_pch_cfg_object *obj, const char *oid,
+                        void *data)
+{
+    te_string *answer = data;
+    char       value[RCF_MAX_VAL];
+    te_errno   rc;
+
+    rc = get_instance_value(obj, oid, value);
+    if (rc == 0 && value_ref.set)
+    {
+        te_string_append(answer, "%s %zu:", oid, value_ref.len);
+        te_string_append_buf(answer, value_ref.data, value_ref.len);
+        te_string_append(answer, "\n");
+        value_ref_release();
+        return 0;
+    }
+    else if (rc == 0)
+    {
+        te_string_append(answer, "%s %zu:%s\n", oid, strlen(value), value);
+        return 0;
+    }
+
+    /* The instance has gone after it was listed */
+    if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+        return 0;
+
+    /* Let the requester get the value (and the error) separately */
+    VERB("Failed to get value of '%s' for getall: %r", oid, rc);
+    te_string_append(answer, "%s -\n", oid);
+
+    return 0;
+}
+
+/** Context of wildcard configure getall request */
+typedef struct getall_ctx {
+    struct rcf_comm_connection *conn;         /**< Connection handle */
+    const char                 *cbuf;         /**< Command buffer */
+    size_t                      answer_plen;  /**< Length of the answer
+                                                   prefix in the command
+                                                   buffer */
+    te_string                   answer;       /**< Part of the answer
+                                                   which is not sent yet */
+} getall_ctx;
+
+/**
+ * Send accumulated part of getall answer as an intermediate answer.
+ * It has the binary attachment but no status code, so RCF passes it
+ * to the requester and waits for the rest of the answer.
+ *
+ * The answer header is not written to the command buffer since
+ * the walk may still use the OID located there.
+ *
+ * @param ctx       getall request context
+ *
+ * @return 0 or error returned by communication library
+ */
+static te_errno
+send_getall_chunk(getall_ctx *ctx)
+{
+    te_string    hdr = TE_STRING_INIT;
+    struct iovec iov[2];
+    te_errno     rc;
+
+    te_string_append_buf(&hdr, ctx->cbuf, ctx->answer_plen);
+    te_string_append(&hdr, "attach %zu", ctx->answer.len);
+
+    iov[0].iov_base = hdr.ptr;
+    iov[0].iov_len = hdr.len + 1;
+    iov[1].iov_base = ctx->answer.ptr;
+    iov[1].iov_len = ctx->answer.len;
+
+    RCF_CH_LOCK;
+    rc = rcf_comm_agent_reply_v(ctx->conn, iov, TE_ARRAY_LEN(iov));
+    RCF_CH_UNLOCK;
+    VERB("Sent getall chunk len=%zu rc=%d", ctx->answer.len, rc);
+
+    te_string_reset(&ctx->answer);
+    te_string_free(&hdr);
+
+    return rc;
+}
+
+/**
+ * Callback for walk_wildcard_inst() appending instances with values
+ * to getall answer and sending it by chunks.
+ */
+static te_errno
+add_getall_inst(rcf_pch_cfg_object *obj, const char *oid, void *data)
+{
+    getall_ctx *ctx = data;
+    te_errno    rc;
+
+    rc = add_wildcard_inst_value(obj, oid, &ctx->answer);
+    if (rc == 0 && ctx->answer.len >= GETALL_CHUNK_SIZE)
+        rc = send_getall_chunk(ctx);
+
+    return rc;
+}
+
+/**
+ * Get level of the last sub-identifier without wildcards in
+ * wildcard object instance identifier.
+ *
+ * @param oid           wildcard object instance identifier
+ * @param level         location for the level
+ *
+ * @return Status code
+ */
+static te_errno
+wildcard_prefix_level(const char *oid, unsigned int *level)
+{
+    char             copy[CFG_OID_MAX];
+    size_t           len;
+    cfg_oid         *p_oid;
+    cfg_inst_subid  *ids;
+    unsigned int     i;
+
+    te_strlcpy(copy, oid, sizeof(copy));
+
+    /* Trailing "/..." is not a sub-identifier */
+    len = strlen(copy);
+    if (len > strlen(OID_ETC) &&
+        strcmp(copy + len - strlen(OID_ETC), OID_ETC) == 0)
+    {
+        copy[len - strlen(OID_ETC)] = '\0';
+    }
+
+    p_oid = cfg_convert_oid_str(copy);
+    if (p_oid == NULL || !p_oid->inst)
+    {
+        ERROR("Failed to parse getall OID '%s'", oid);
+        cfg_free_oid(p_oid);
+        return TE_EINVAL;
+    }
+
+    ids = (cfg_inst_subid *)p_oid->ids;
+    for (i = 1; i < p_oid->len; i++)
+    {
+        if (strchr(ids[i].subid, '*') != NULL ||
+            strchr(ids[i].name, '*') != NULL)
+            break;
+    }
+    *level = i - 1;
+
+    cfg_free_oid(p_oid);
+
+    return 0;
+}
+
+/**
+ * Parse options of configure getall request.
+ *
+ * @param oid           wildcard object instance identifier
+ * @param options       options string
+ * @param max_level     location for maximum number of sub-identifiers
+ *                      in reported OIDs
+ *
+ * @return Status code
+ */
+static te_errno
+parse_getall_options(const char *oid, const char *options,
+                     unsigned int *max_level)
+{
+    te_vec       opts = TE_VEC_INIT(char *);
+    char * const *opt;
+    te_errno     rc;
+
+    *max_level = 0;
+
+    rc = te_vec_split_string(options, &opts, ' ', FALSE);
+    if (rc != 0)
+        return rc;
+
+    TE_VEC_FOREACH(&opts, opt)
+    {
+        unsigned int depth;
+        unsigned int prefix_level;
+
+        if (strcmp(*opt, RCF_CONFGET_ALL) == 0)
+            continue;
+
+        if (strcmp_start(RCF_CONFGET_DEPTH "=", *opt) != 0)
+        {
+            ERROR("Unknown getall option '%s'", *opt);
+            rc = TE_EINVAL;
+            break;
+        }
+
+        rc = te_strtoui(*opt + strlen(RCF_CONFGET_DEPTH "="), 10, &depth);
+        if (rc != 0)
+            break;
+
+        /* Depth is counted from the last sub-identifier without wildcards */
+        rc = wildcard_prefix_level(oid, &prefix_level);
+        if (rc != 0)
+            break;
+
+        *max_level = prefix_level + depth;
+    }
+
+    te_vec_deep_free(&opts);
+
+    return rc;
+}
+
+/**
+ * Process wildcard configure getall request: all matching instances
+ * are reported together with their values collected during a single
+ * pass over the tree. The answer is sent by chunks of about
+ * #GETALL_CHUNK_SIZE bytes as intermediate answers while the tree is
+ * walked, the rest is attached to the final answer.
+ *
+ * Each instance is reported as a separate line
+ * @c "<oid> <value length>:<value>\n" or @c "<oid> -\n" if its value
+ * cannot be obtained (so it should be requested separately).
+ *
+ * @param conn            connection handle
+ * @param cbuf            command buffer
+ * @param buflen          length of the command buffer
+ * @param answer_plen     number of bytes in the command buffer
+ *                        to be copied to the answer
+ * @param oid             object instance wildcard identifier
+ * @param options         getall options
+ *
+ * @return 0 or error returned by communication library
+ */
+static te_errno
+process_wildcard_getall(struct rcf_comm_connection *conn, char *cbuf,
+                        size_t buflen, size_t answer_plen, const char *oid,
+                        const char *options)
+{
+    getall_ctx getall = {
+        .conn = conn,
+        .cbuf = cbuf,
+        .answer_plen = answer_plen,
+        .answer = TE_STRING_INIT,
+    };
+    char      copy[CFG_OID_MAX];
+    wildcard_inst_ctx ctx = {
+        .full_oid = oid,
+        .cb = add_getall_inst,
+        .data = &getall,
+    };
+    int rc;
+
+    ENTRY("OID='%s' options='%s'", oid, options);
+
+    if (strchr(oid, ':') == NULL)
+    {
+        ERROR("Getall is supported for object instances only");
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EINVAL));
+    }
+
+    rc = parse_getall_options(oid, options, &ctx.max_level);
+    if (rc != 0)
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
+
+    te_strlcpy(copy, oid, sizeof(copy));
+    rc = walk_wildcard_inst(rcf_pch_conf_root(), NULL, copy, &ctx);
+    if (rc != 0)
+    {
+        te_string_free(&getall.answer);
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
+    }
+
+    rc = send_attachment(conn, cbuf, buflen, answer_plen,
+                         getall.answer.ptr, getall.answer.len);
+    te_string_free(&getall.answer);
+
+    return rc;
+}
+
 /* See description in rcf_pch.h */
 int
 rcf_pch_configure(struct rcf_comm_connection *conn,
@@ -998,6 +1586,13 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
                                         (val == NULL) ? "NULL" : val);
     VERB("Default configuration handler is executed");
 
+    /*
+     * Data of the previous request may be outdated unless it is
+     * the next get in a group.
+     */
+    if (!is_group || op != RCF_CH_CFG_GET)
+        snapshot_drop();
+
     if (oid != 0)
     {
         /* Now parse the oid and look for the object */
@@ -1009,7 +1604,26 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
                 SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EINVAL));
             }
 
-            rc = process_wildcard(conn, cbuf, buflen, answer_plen, oid);
+            /*
+             * Caches of handlers which are bound to group identifier
+             * must not survive between wildcard requests.
+             */
+            if (!is_group)
+                ++gid;
+
+            is_wildcard = TRUE;
+            if (val != NULL)
+            {
+                rc = process_wildcard_getall(conn, cbuf, buflen,
+                                             answer_plen, oid, val);
+            }
+            else
+            {
+                rc = process_wildcard(conn, cbuf, buflen, answer_plen, oid);
+            }
+            is_wildcard = FALSE;
+            if (!is_group)
+                snapshot_drop();
 
             EXIT("%r", rc);
 
@@ -1113,13 +1727,24 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
                 SEND_ANSWER("0");
             }
 
+            value_ref_release();
             rc = (obj->get)(gid, oid, value, ALL_INST_NAMES);
             if (rc != 0)
             {
+                value_ref_release();
                 cfg_free_oid(p_oid);
                 SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
             }
 
+            if (value_ref.set)
+            {
+                cfg_free_oid(p_oid);
+                rc = send_attachment(conn, cbuf, buflen, answer_plen,
+                                     value_ref.data, value_ref.len);
+                value_ref_release();
+                return rc;
+            }
+
             if (obj->subst != NULL)
             {
                 rc = do_substitutions(obj, value, inst_names[i - 3], p_ids);
@@ -1456,6 +2081,20 @@ rsrc_lock_path(const char *name, char *path, size_t pathlen)
     return path;
 }
 
+/**
+ * Get the name of the lock used by the lock service from the lock file
+ * path (so that both schemes use the same names).
+ *
+ * @param path          Path generated by rsrc_lock_path()
+ *
+ * @return Lock name
+ */
+static const char *
+rsrc_lock_key(const char *path)
+{
+    return path + strlen(te_lockdir) + 1;
+}
+
 typedef enum rsrc_lock_type {
     RSRC_LOCK_SHARED,
     RSRC_LOCK_EXCLUSIVE,
@@ -1868,6 +2507,9 @@ rcf_pch_rsrc_check_locks(const char *rsrc_ptrn)
     if (rsrc_lock_path(rsrc_ptrn, path_ptrn, sizeof(path_ptrn)) == NULL)
         return TE_RC(TE_RCF_PCH, TE_ENAMETOOLONG);
 
+    if (rcf_pch_lockd_enabled())
+        return rcf_pch_lockd_check(rsrc_lock_key(path_ptrn));
+
     memset(&gb, 0, sizeof(gb));
     ret = glob(path_ptrn, GLOB_NOSORT, NULL, &gb);
     if (ret == 0)
@@ -1929,6 +2571,17 @@ ta_rsrc_update_lock(const char *name, te_bool *shared, te_bool add_lock,
     if (rsrc_lock_path(name, fname, sizeof(fname)) == NULL)
         return TE_RC(TE_RCF_PCH, TE_ENAMETOOLONG);
 
+    if (rcf_pch_lockd_enabled())
+    {
+        if (add_lock)
+        {
+            return rcf_pch_lockd_lock(rsrc_lock_key(fname), shared,
+                                      fallback_shared, attempts_timeout_ms);
+        }
+
+        return rcf_pch_lockd_unlock(rsrc_lock_key(fname));
+    }
+
     if ((fd = open(fname, O_CREAT | O_RDWR, 0666)) < 0)
         return TE_OS_RC(TE_RCF_PCH, errno);
 
@@ -0,0 +1,341 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF Portable Command Handler
+ *
+ * Delivery of Test Agent events to the Test Engine.
+ *
+ * Events are posted by Test Agent threads (e.g. serial console parsers)
+ * and kept in a queue. The Test Engine issues the event wait command,
+ * the answer to it is postponed until an event is posted or the
+ * timeout expires, so events are delivered as soon as they happen
+ * without polling of the Test Agent state.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#ifdef STDC_HEADERS
+#include <stdlib.h>
+#include <string.h>
+#endif
+#include <time.h>
+#include <pthread.h>
+
+#include "rcf_pch_internal.h"
+
+#include "te_errno.h"
+#include "te_defs.h"
+#include "te_alloc.h"
+#include "te_queue.h"
+#include "te_str.h"
+#include "te_string.h"
+#include "rcf_common.h"
+#include "rcf_internal.h"
+#include "comm_agent.h"
+#include "rcf_pch.h"
+#include "rcf_ch_api.h"
+
+/** Maximum number of events kept while nobody waits for them */
+#define RCF_PCH_EVENT_MAX_QUEUED    64
+
+/** Event posted by the Test Agent */
+typedef struct rcf_pch_event {
+    TAILQ_ENTRY(rcf_pch_event)  links;  /**< List links */
+    char                       *data;   /**< Event description */
+} rcf_pch_event;
+
+/** Queue of events */
+typedef TAILQ_HEAD(rcf_pch_events, rcf_pch_event) rcf_pch_events;
+
+/** Event delivery context */
+typedef struct rcf_pch_event_ctx {
+    pthread_mutex_t     lock;       /**< Lock protecting the context */
+    pthread_cond_t      cond;       /**< Event posted or waiter added */
+    te_bool             started;    /**< Delivery thread is started */
+    te_bool             stop;       /**< Delivery thread should stop */
+    pthread_t           thread;     /**< Delivery thread */
+
+    rcf_pch_events      events;     /**< Queued events */
+    unsigned int        n_events;   /**< Number of queued events */
+
+    struct rcf_comm_connection *conn;   /**< Connection of the waiter
+                                             or @c NULL */
+    char               *answer;     /**< Waiter answer buffer starting
+                                         with the answer prefix */
+    size_t              answer_len; /**< Size of the answer buffer */
+    size_t              answer_plen; /**< Length of the answer prefix */
+    struct timespec     deadline;   /**< When the waiter should get
+                                         timeout (CLOCK_MONOTONIC) */
+} rcf_pch_event_ctx;
+
+static rcf_pch_event_ctx event_ctx = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .events = TAILQ_HEAD_INITIALIZER(event_ctx.events),
+};
+
+/*
+ * Answer the waiter with an event or an error. It is called with
+ * the context lock held.
+ */
+static void
+rcf_pch_event_answer(te_errno rc, const char *data)
+{
+    rcf_pch_event_ctx *ctx = &event_ctx;
+    char              *p = ctx->answer + ctx->answer_plen;
+    size_t             space = ctx->answer_len - ctx->answer_plen;
+    int                n;
+
+    n = snprintf(p, space, "%u", rc);
+    if (data != NULL)
+    {
+        /* Quoting may double the length, plus space and quotes */
+        if (strlen(data) * 2 + 4 > space - n)
+        {
+            ERROR("Event '%s' is too long to be delivered", data);
+            snprintf(p, space, "%u", TE_RC(TE_RCF_PCH, TE_E2BIG));
+        }
+        else
+        {
+            write_str_in_quotes(p + n, data, strlen(data));
+        }
+    }
+
+    RCF_CH_LOCK;
+    rc = rcf_comm_agent_reply(ctx->conn, ctx->answer,
+                              strlen(ctx->answer) + 1);
+    RCF_CH_UNLOCK;
+    if (rc != 0)
+        ERROR("Failed to send event wait answer: %r", rc);
+
+    ctx->conn = NULL;
+}
+
+/* Deliver queued events to the waiter and answer it on timeout */
+static void *
+rcf_pch_event_thread(void *arg)
+{
+    rcf_pch_event_ctx  *ctx = &event_ctx;
+    rcf_pch_event      *event;
+    struct timespec     now;
+
+    UNUSED(arg);
+
+    pthread_mutex_lock(&ctx->lock);
+    while (!ctx->stop)
+    {
+        if (ctx->conn == NULL)
+        {
+            pthread_cond_wait(&ctx->cond, &ctx->lock);
+            continue;
+        }
+
+        event = TAILQ_FIRST(&ctx->events);
+        if (event != NULL)
+        {
+            TAILQ_REMOVE(&ctx->events, event, links);
+            ctx->n_events--;
+            rcf_pch_event_answer(0, event->data);
+            free(event->data);
+            free(event);
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > ctx->deadline.tv_sec ||
+            (now.tv_sec == ctx->deadline.tv_sec &&
+             now.tv_nsec >= ctx->deadline.tv_nsec))
+        {
+            rcf_pch_event_answer(TE_RC(TE_RCF_PCH, TE_ETIMEDOUT), NULL);
+            continue;
+        }
+
+        pthread_cond_timedwait(&ctx->cond, &ctx->lock, &ctx->deadline);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    return NULL;
+}
+
+/* Start the delivery thread if it is not started yet */
+static te_errno
+rcf_pch_event_start(void)
+{
+    rcf_pch_event_ctx  *ctx = &event_ctx;
+    pthread_condattr_t  attr;
+    int                 rc;
+
+    if (ctx->started)
+        return 0;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    rc = pthread_cond_init(&ctx->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (rc != 0)
+        return TE_OS_RC(TE_RCF_PCH, rc);
+
+    ctx->stop = FALSE;
+    rc = pthread_create(&ctx->thread, NULL, rcf_pch_event_thread, NULL);
+    if (rc != 0)
+    {
+        pthread_cond_destroy(&ctx->cond);
+        return TE_OS_RC(TE_RCF_PCH, rc);
+    }
+
+    ctx->started = TRUE;
+    return 0;
+}
+
+/* See description in rcf_pch.h */
+te_errno
+rcf_pch_event_post(const char *fmt, ...)
+{
+    rcf_pch_event_ctx  *ctx = &event_ctx;
+    rcf_pch_event      *event;
+    rcf_pch_event      *oldest;
+    te_string           str = TE_STRING_INIT;
+    va_list             ap;
+
+    va_start(ap, fmt);
+    te_string_append_va(&str, fmt, ap);
+    va_end(ap);
+
+    event = TE_ALLOC(sizeof(*event));
+    te_string_move(&event->data, &str);
+
+    pthread_mutex_lock(&ctx->lock);
+
+    if (ctx->n_events == RCF_PCH_EVENT_MAX_QUEUED)
+    {
+        oldest = TAILQ_FIRST(&ctx->events);
+        WARN("Too many undelivered events, event '%s' is dropped",
+             oldest->data);
+        TAILQ_REMOVE(&ctx->events, oldest, links);
+        ctx->n_events--;
+        free(oldest->data);
+        free(oldest);
+    }
+
+    TAILQ_INSERT_TAIL(&ctx->events, event, links);
+    ctx->n_events++;
+
+    if (ctx->started)
+        pthread_cond_signal(&ctx->cond);
+
+    pthread_mutex_unlock(&ctx->lock);
+
+    return 0;
+}
+
+/* See description in rcf_pch.h */
+int
+rcf_pch_event_wait(struct rcf_comm_connection *conn,
+                   char *cbuf, size_t buflen, size_t answer_plen,
+                   unsigned int timeout)
+{
+    rcf_pch_event_ctx  *ctx = &event_ctx;
+    te_errno            rc;
+
+    pthread_mutex_lock(&ctx->lock);
+
+    if (ctx->conn != NULL)
+    {
+        pthread_mutex_unlock(&ctx->lock);
+        ERROR("Events are already waited for");
+        SEND_ANSWER("%u", TE_RC(TE_RCF_PCH, TE_EBUSY));
+    }
+
+    rc = rcf_pch_event_start();
+    if (rc != 0)
+    {
+        pthread_mutex_unlock(&ctx->lock);
+        ERROR("Failed to start events delivery thread: %r", rc);
+        SEND_ANSWER("%u", rc);
+    }
+
+    if (ctx->answer_len < buflen)
+    {
+        free(ctx->answer);
+        ctx->answer = TE_ALLOC(buflen);
+        ctx->answer_len = buflen;
+    }
+    memcpy(ctx->answer, cbuf, answer_plen);
+    ctx->answer_plen = answer_plen;
+
+    clock_gettime(CLOCK_MONOTONIC, &ctx->deadline);
+    ctx->deadline.tv_sec += TE_MS2SEC(timeout);
+    ctx->deadline.tv_nsec += TE_MS2NS(timeout % 1000);
+    if (ctx->deadline.tv_nsec >= 1000000000)
+    {
+        ctx->deadline.tv_sec++;
+        ctx->deadline.tv_nsec -= 1000000000;
+    }
+
+    ctx->conn = conn;
+    pthread_cond_signal(&ctx->cond);
+
+    pthread_mutex_unlock(&ctx->lock);
+
+    return 0;
+}
+
+/* See description in rcf_pch.h */
+void
+rcf_pch_event_shutdown(void)
+{
+    rcf_pch_event_ctx  *ctx = &event_ctx;
+    rcf_pch_event      *event;
+
+    pthread_mutex_lock(&ctx->lock);
+    if (!ctx->started)
+    {
+        pthread_mutex_unlock(&ctx->lock);
+        return;
+    }
+    /* The connection is going to be closed, nobody waits anymore */
+    ctx->conn = NULL;
+    ctx->stop = TRUE;
+    pthread_cond_signal(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    pthread_join(ctx->thread, NULL);
+    pthread_cond_destroy(&ctx->cond);
+    ctx->started = FALSE;
+
+    while ((event = TAILQ_FIRST(&ctx->events)) != NULL)
+    {
+        TAILQ_REMOVE(&ctx->events, event, links);
+        free(event->data);
+        free(event);
+    }
+    ctx->n_events = 0;
+
+    free(ctx->answer);
+    ctx->answer = NULL;
+    ctx->answer_len = 0;
+}
+
+/* See description in rcf_pch.h */
+void
+rcf_pch_event_atfork(void)
+{
+    rcf_pch_event_ctx  *ctx = &event_ctx;
+    rcf_pch_event      *event;
+
+    /* The delivery thread is not inherited, it is started on demand */
+    pthread_mutex_init(&ctx->lock, NULL);
+    ctx->started = FALSE;
+    ctx->stop = FALSE;
+    ctx->conn = NULL;
+
+    while ((event = TAILQ_FIRST(&ctx->events)) != NULL)
+    {
+        TAILQ_REMOVE(&ctx->events, event, links);
+        free(event->data);
+        free(event);
+    }
+    ctx->n_events = 0;
+}
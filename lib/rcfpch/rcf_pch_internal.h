@@ -170,6 +170,107 @@ extern void rcf_pch_rpcserver_plugin_enable(struct rpcserver *rpcs);
  */
 extern void rcf_pch_rpcserver_plugin_disable(struct rpcserver *rpcs);
 
+/**
+ * Check whether resource locks are kept by the per-host lock service
+ * (see @ref RCF_PCH_LOCKD_ENV). The result depends on the environment
+ * only, the service is connected to (and started if necessary) when
+ * it is used.
+ *
+ * @return @c TRUE if the lock service should be used instead of
+ *         lock files
+ */
+extern te_bool rcf_pch_lockd_enabled(void);
+
+/**
+ * Acquire a resource lock via the lock service.
+ *
+ * @param name                  Lock name (converted resource name)
+ * @param shared                @c TRUE if resource is shared
+ *                              (updated on success)
+ * @param fallback_shared       @c TRUE - try to lock as shared if
+ *                              exclusive locking failed
+ * @param attempts_timeout_ms   Retry attempts to lock until the timeout
+ *                              passes (in milliseconds)
+ *
+ * @return Status code
+ * @retval TE_EPERM     The lock is held by other processes
+ */
+extern te_errno rcf_pch_lockd_lock(const char *name, te_bool *shared,
+                                   te_bool fallback_shared,
+                                   unsigned int attempts_timeout_ms);
+
+/**
+ * Release a resource lock via the lock service.
+ *
+ * @param name          Lock name (converted resource name)
+ *
+ * @return Status code
+ */
+extern te_errno rcf_pch_lockd_unlock(const char *name);
+
+/**
+ * Check whether locks matching the pattern are held by other processes
+ * via the lock service.
+ *
+ * @param pattern       Glob-style pattern of lock names
+ *
+ * @return Status code
+ * @retval 0            No matching locks of other processes
+ * @retval TE_EPERM     Lock of other process found
+ */
+extern te_errno rcf_pch_lockd_check(const char *pattern);
+
+/**
+ * Take the lock protecting RCF RPC servers. It is held around fork()
+ * of a sub-agent, so that the list of RPC servers is consistent in
+ * the child. It must be taken before RCF_CH_LOCK.
+ */
+extern void rcf_pch_rpc_lock(void);
+
+/**
+ * Release the lock taken by rcf_pch_rpc_lock().
+ */
+extern void rcf_pch_rpc_unlock(void);
+
+/**
+ * Remember the connection to the Test Engine used to pass answers
+ * of sub-agents.
+ *
+ * @param conn          Connection to the Test Engine
+ */
+extern void rcf_pch_subagent_init(struct rcf_comm_connection *conn);
+
+/**
+ * Pass a command to the sub-agent it is addressed to. If the sub-agent
+ * does not exist or cannot get the command, an error is answered on
+ * its behalf.
+ *
+ * @param conn          Connection to the Test Engine
+ * @param cmd           Command starting with @c TE_PROTO_SUBAGENT
+ *                      (it is modified)
+ * @param len           Length of the command including attachment
+ *
+ * @return Status code of the communication with the Test Engine.
+ */
+extern te_errno rcf_pch_subagent_relay(struct rcf_comm_connection *conn,
+                                       char *cmd, size_t len);
+
+/**
+ * Stop all sub-agents.
+ */
+extern void rcf_pch_subagent_shutdown(void);
+
+/**
+ * Serve commands received via the connection to the parent Test Agent
+ * in the process of a sub-agent.
+ *
+ * @param sub_conn      Connection to the parent Test Agent
+ *
+ * @note The function never returns, the process exits when
+ *       the connection is closed or the shutdown command is received.
+ */
+extern void rcf_pch_subagent_serve(struct rcf_comm_connection *sub_conn);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,891 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF Portable Command Handler
+ *
+ * Per-host lock service for dynamically grabbed resources.
+ *
+ * The first Test Agent on a host which needs the service forks a daemon
+ * listening on a Unix socket in the lock directory. The daemon keeps
+ * resource locks in memory and drops locks of a process as soon as
+ * the process terminates (detected via pidfd if available and via
+ * hangup of its connection), so neither lock files nor their manual
+ * cleanup are required.
+ *
+ * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#ifdef STDC_HEADERS
+#include <stdlib.h>
+#include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#if HAVE_SIGNAL_H
+#include <signal.h>
+#endif
+#if HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#include "rcf_pch_internal.h"
+
+#include "te_errno.h"
+#include "te_defs.h"
+#include "te_str.h"
+#include "te_string.h"
+#include "te_vector.h"
+#include "te_sleep.h"
+#include "rcf_common.h"
+#include "rcf_pch.h"
+
+#ifdef __linux__
+
+#include <fnmatch.h>
+#include <poll.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+
+/** Name of the lock service socket in the lock directory */
+#define LOCKD_SOCKET_NAME   "te_ta_lockd.sock"
+
+/** Name of the file serializing start and stop of the lock service */
+#define LOCKD_START_NAME    "te_ta_lockd.lock"
+
+/** Time the lock service lives without clients, in milliseconds */
+#define LOCKD_IDLE_TIMEOUT_MS   60000
+
+/** Lock service request/reply operations */
+typedef enum lockd_op {
+    LOCKD_OP_LOCK,      /**< Add the client to the lock */
+    LOCKD_OP_UNLOCK,    /**< Remove the client from the lock */
+    LOCKD_OP_CHECK,     /**< Check locks matching the pattern */
+} lockd_op;
+
+/**
+ * Lock service request and reply. Sequential packet socket is used,
+ * so one message is always sent and received as a whole.
+ */
+typedef struct lockd_msg {
+    uint32_t op;                /**< Operation (see lockd_op) */
+    uint32_t shared;            /**< Shared lock requested or granted */
+    int32_t  rc;                /**< Status code of the reply */
+    char     name[RCF_MAX_PATH]; /**< Lock name or pattern */
+} lockd_msg;
+
+/** Lock kept by the service */
+typedef struct lockd_lock {
+    char    *name;      /**< Lock name */
+    te_bool  shared;    /**< Lock is shared */
+    te_vec   pids;      /**< PIDs of the processes holding the lock */
+} lockd_lock;
+
+/** Client of the lock service */
+typedef struct lockd_client {
+    int   fd;       /**< Connection socket */
+    int   pidfd;    /**< Process file descriptor or @c -1 */
+    pid_t pid;      /**< Client process ID */
+} lockd_client;
+
+/** Connection to the lock service, @c -1 if not connected */
+static int lockd_fd = -1;
+/** Process which owns the connection (it is not shared with children) */
+static pid_t lockd_owner = -1;
+/** Whether the lock service is requested (@c -1 if not checked yet) */
+static int lockd_requested = -1;
+/**
+ * Names of locks held by the process via the lock service. They are
+ * reported as lost if the connection breaks.
+ */
+static te_vec lockd_held = TE_VEC_INIT_DESTROY(char *, te_vec_item_free_ptr);
+
+/* Compose the path to a lock service file in the lock directory */
+static te_errno
+lockd_path(te_string *path, const char *name)
+{
+    te_string_append(path, "%s/%s", te_lockdir, name);
+    if (path->len >= sizeof(((struct sockaddr_un *)NULL)->sun_path))
+    {
+        ERROR("Too long lock service socket path '%s'", path->ptr);
+        return TE_RC(TE_RCF_PCH, TE_ENAMETOOLONG);
+    }
+
+    return 0;
+}
+
+/* Fill in socket address of the lock service */
+static void
+lockd_addr(struct sockaddr_un *addr, const char *path)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    te_strlcpy(addr->sun_path, path, sizeof(addr->sun_path));
+}
+
+/* Check whether the process is still alive (as rsrc lock files do) */
+static te_bool
+lockd_pid_alive(pid_t pid)
+{
+    return kill(pid, 0) == 0;
+}
+
+/* Remove the process from the lock, return TRUE if it was there */
+static te_bool
+lockd_lock_remove_pid(lockd_lock *lock, pid_t pid)
+{
+    size_t i;
+
+    for (i = 0; i < te_vec_size(&lock->pids); i++)
+    {
+        if (TE_VEC_GET(pid_t, &lock->pids, i) == pid)
+        {
+            te_vec_remove_index(&lock->pids, i);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* Forget processes which have terminated without notice */
+static void
+lockd_lock_drop_dead(lockd_lock *lock)
+{
+    size_t i = 0;
+
+    while (i < te_vec_size(&lock->pids))
+    {
+        if (lockd_pid_alive(TE_VEC_GET(pid_t, &lock->pids, i)))
+            i++;
+        else
+            te_vec_remove_index(&lock->pids, i);
+    }
+}
+
+/* Find the lock by name */
+static lockd_lock *
+lockd_lock_find(te_vec *locks, const char *name)
+{
+    lockd_lock *lock;
+
+    TE_VEC_FOREACH(locks, lock)
+    {
+        if (strcmp(lock->name, name) == 0)
+            return lock;
+    }
+
+    return NULL;
+}
+
+/* Remove locks which are not held by anyone */
+static void
+lockd_locks_compact(te_vec *locks)
+{
+    size_t i = 0;
+
+    while (i < te_vec_size(locks))
+    {
+        lockd_lock *lock = te_vec_get(locks, i);
+
+        if (te_vec_size(&lock->pids) > 0)
+        {
+            i++;
+            continue;
+        }
+
+        free(lock->name);
+        te_vec_free(&lock->pids);
+        te_vec_remove_index(locks, i);
+    }
+}
+
+/*
+ * Add the process to the lock. The rules are the same as for
+ * rsrc lock files: a shared lock may be held by many processes,
+ * an exclusive lock - by the only one.
+ */
+static te_errno
+lockd_do_lock(te_vec *locks, const char *name, te_bool shared, pid_t pid)
+{
+    lockd_lock *lock = lockd_lock_find(locks, name);
+    te_bool first_pid_mine;
+    pid_t *p;
+
+    if (lock == NULL)
+    {
+        lockd_lock new_lock = {
+            .name = strdup(name),
+            .shared = shared,
+            .pids = TE_VEC_INIT(pid_t),
+        };
+
+        if (new_lock.name == NULL)
+            return TE_ENOMEM;
+
+        TE_VEC_APPEND(locks, new_lock);
+        lock = te_vec_get(locks, te_vec_size(locks) - 1);
+    }
+
+    lockd_lock_drop_dead(lock);
+
+    if (te_vec_size(&lock->pids) > 0)
+    {
+        first_pid_mine = TE_VEC_GET(pid_t, &lock->pids, 0) == pid;
+
+        if (shared && !lock->shared && !first_pid_mine)
+            return TE_EPERM;
+        if (!shared && (te_vec_size(&lock->pids) > 1 || !first_pid_mine))
+            return TE_EPERM;
+    }
+
+    lock->shared = shared;
+
+    TE_VEC_FOREACH(&lock->pids, p)
+    {
+        if (*p == pid)
+            return 0;
+    }
+
+    return TE_VEC_APPEND(&lock->pids, pid);
+}
+
+/* Check that no locks matching the pattern are held by other processes */
+static te_errno
+lockd_do_check(te_vec *locks, const char *pattern, pid_t pid)
+{
+    lockd_lock *lock;
+    pid_t *p;
+
+    TE_VEC_FOREACH(locks, lock)
+    {
+        if (fnmatch(pattern, lock->name, 0) != 0)
+            continue;
+
+        lockd_lock_drop_dead(lock);
+        TE_VEC_FOREACH(&lock->pids, p)
+        {
+            if (*p != pid)
+                return TE_EPERM;
+        }
+    }
+
+    return 0;
+}
+
+/* Release all locks of the terminated client */
+static void
+lockd_client_gone(te_vec *locks, te_vec *clients, size_t idx)
+{
+    lockd_client *client = te_vec_get(clients, idx);
+    lockd_lock *lock;
+
+    TE_VEC_FOREACH(locks, lock)
+        lockd_lock_remove_pid(lock, client->pid);
+
+    close(client->fd);
+    if (client->pidfd >= 0)
+        close(client->pidfd);
+    te_vec_remove_index(clients, idx);
+}
+
+/* Accept a new client and find out its PID */
+static void
+lockd_client_accept(int listen_fd, te_vec *clients)
+{
+    lockd_client client;
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+
+    client.fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (client.fd < 0)
+        return;
+
+    if (getsockopt(client.fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0)
+    {
+        close(client.fd);
+        return;
+    }
+    client.pid = cred.pid;
+
+#ifdef SYS_pidfd_open
+    client.pidfd = syscall(SYS_pidfd_open, client.pid, 0);
+#else
+    client.pidfd = -1;
+#endif
+
+    TE_VEC_APPEND(clients, client);
+}
+
+/* Process a request of the client */
+static te_errno
+lockd_client_request(te_vec *locks, lockd_client *client)
+{
+    lockd_msg msg;
+    ssize_t n;
+
+    n = recv(client->fd, &msg, sizeof(msg), 0);
+    if (n != sizeof(msg))
+        return TE_ECONNRESET;
+
+    msg.name[sizeof(msg.name) - 1] = '\0';
+    switch (msg.op)
+    {
+        case LOCKD_OP_LOCK:
+            msg.rc = lockd_do_lock(locks, msg.name, msg.shared,
+                                   client->pid);
+            break;
+
+        case LOCKD_OP_UNLOCK:
+        {
+            lockd_lock *lock = lockd_lock_find(locks, msg.name);
+
+            if (lock != NULL && lockd_lock_remove_pid(lock, client->pid))
+                msg.rc = 0;
+            else
+                msg.rc = TE_ENOENT;
+            break;
+        }
+
+        case LOCKD_OP_CHECK:
+            msg.rc = lockd_do_check(locks, msg.name, client->pid);
+            break;
+
+        default:
+            msg.rc = TE_EOPNOTSUPP;
+            break;
+    }
+    lockd_locks_compact(locks);
+
+    if (send(client->fd, &msg, sizeof(msg), MSG_NOSIGNAL) != sizeof(msg))
+        return TE_ECONNRESET;
+
+    return 0;
+}
+
+/*
+ * Check whether the idle lock service may stop. Start and stop are
+ * serialized by the start lock, so no client may connect after
+ * the listening socket is checked and before it is removed.
+ */
+static te_bool
+lockd_may_stop(int listen_fd, const char *sock_path, const char *start_path)
+{
+    struct pollfd pfd = { .fd = listen_fd, .events = POLLIN };
+    te_bool stop;
+    int fd;
+
+    fd = open(start_path, O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+        return FALSE;
+
+    if (flock(fd, LOCK_EX) != 0)
+    {
+        close(fd);
+        return FALSE;
+    }
+
+    stop = (poll(&pfd, 1, 0) == 0);
+    if (stop)
+        unlink(sock_path);
+
+    close(fd);
+
+    return stop;
+}
+
+/*
+ * Main loop of the lock service process. It is a forked copy of
+ * the Test Agent, so it must not use TA facilities (e.g. logging).
+ */
+static void
+lockd_serve(int listen_fd, const char *sock_path, const char *start_path)
+{
+    te_vec locks = TE_VEC_INIT(lockd_lock);
+    te_vec clients = TE_VEC_INIT(lockd_client);
+    te_vec pfds = TE_VEC_INIT(struct pollfd);
+
+    while (TRUE)
+    {
+        struct pollfd pfd = { .fd = listen_fd, .events = POLLIN };
+        lockd_client *client;
+        size_t n_clients = te_vec_size(&clients);
+        size_t i;
+        int ret;
+
+        te_vec_reset(&pfds);
+        TE_VEC_APPEND(&pfds, pfd);
+        TE_VEC_FOREACH(&clients, client)
+        {
+            pfd.fd = client->fd;
+            TE_VEC_APPEND(&pfds, pfd);
+            /* Ignored by poll() if the process has no pidfd */
+            pfd.fd = client->pidfd;
+            TE_VEC_APPEND(&pfds, pfd);
+        }
+
+        ret = poll(te_vec_get(&pfds, 0), te_vec_size(&pfds),
+                   n_clients == 0 ? LOCKD_IDLE_TIMEOUT_MS : -1);
+        if (ret < 0)
+            continue;
+
+        if (ret == 0)
+        {
+            if (lockd_may_stop(listen_fd, sock_path, start_path))
+                break;
+            continue;
+        }
+
+        /* Go backward since clients may be removed */
+        for (i = n_clients; i > 0; i--)
+        {
+            struct pollfd *conn = te_vec_get(&pfds, 2 * i - 1);
+            struct pollfd *proc = te_vec_get(&pfds, 2 * i);
+
+            client = te_vec_get(&clients, i - 1);
+            if ((proc->fd >= 0 && proc->revents != 0) ||
+                (conn->revents & (POLLERR | POLLHUP | POLLNVAL)) != 0 ||
+                ((conn->revents & POLLIN) != 0 &&
+                 lockd_client_request(&locks, client) != 0))
+            {
+                lockd_client_gone(&locks, &clients, i - 1);
+            }
+        }
+
+        if ((((struct pollfd *)te_vec_get(&pfds, 0))->revents & POLLIN) != 0)
+            lockd_client_accept(listen_fd, &clients);
+
+        lockd_locks_compact(&locks);
+    }
+
+    close(listen_fd);
+}
+
+/* Detach from the Test Agent and run the lock service */
+static void
+lockd_daemon(int listen_fd, const char *sock_path, const char *start_path)
+{
+    long max_fd = sysconf(_SC_OPEN_MAX);
+    sigset_t mask;
+    int fd;
+
+    /* Do not keep TA connections and files open */
+    for (fd = 0; fd < (max_fd > 0 ? max_fd : 1024); fd++)
+    {
+        if (fd != listen_fd)
+            close(fd);
+    }
+    fd = open("/dev/null", O_RDWR);
+    if (fd >= 0)
+    {
+        dup2(fd, STDIN_FILENO);
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        if (fd > STDERR_FILENO)
+            close(fd);
+    }
+
+    setsid();
+    signal(SIGINT, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGCHLD, SIG_DFL);
+    sigemptyset(&mask);
+    sigprocmask(SIG_SETMASK, &mask, NULL);
+
+    lockd_serve(listen_fd, sock_path, start_path);
+}
+
+/* Connect to the lock service */
+static te_errno
+lockd_connect(const char *sock_path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return TE_OS_RC(TE_RCF_PCH, errno);
+
+    lockd_addr(&addr, sock_path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        te_errno rc = TE_OS_RC(TE_RCF_PCH, errno);
+
+        close(fd);
+        return rc;
+    }
+
+    lockd_fd = fd;
+    lockd_owner = getpid();
+
+    return 0;
+}
+
+/* Start the lock service, the start lock must be held */
+static te_errno
+lockd_start(const char *sock_path, const char *start_path)
+{
+    struct sockaddr_un addr;
+    te_errno rc;
+    pid_t pid;
+    int fd;
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return TE_OS_RC(TE_RCF_PCH, errno);
+
+    /* The socket is left by a lock service which has crashed */
+    unlink(sock_path);
+
+    lockd_addr(&addr, sock_path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        chmod(sock_path, 0666) != 0 || listen(fd, SOMAXCONN) != 0)
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        ERROR("Failed to create lock service socket '%s': %r",
+              sock_path, rc);
+        close(fd);
+        return rc;
+    }
+
+    /* Fork twice to let the lock service be inherited by init */
+    pid = fork();
+    if (pid == 0)
+    {
+        if (fork() == 0)
+            lockd_daemon(fd, sock_path, start_path);
+        _exit(0);
+    }
+
+    rc = (pid < 0) ? TE_OS_RC(TE_RCF_PCH, errno) : 0;
+    close(fd);
+    if (pid > 0)
+        waitpid(pid, NULL, 0);
+
+    if (rc != 0)
+    {
+        ERROR("Failed to start lock service: %r", rc);
+        unlink(sock_path);
+    }
+
+    return rc;
+}
+
+/* Connect to the lock service starting it if necessary */
+static te_errno
+lockd_open(void)
+{
+    te_string sock_path = TE_STRING_INIT;
+    te_string start_path = TE_STRING_INIT;
+    te_errno rc;
+    int fd = -1;
+
+    rc = lockd_path(&sock_path, LOCKD_SOCKET_NAME);
+    if (rc == 0)
+        rc = lockd_path(&start_path, LOCKD_START_NAME);
+    if (rc != 0)
+        goto out;
+
+    fd = open(start_path.ptr, O_CREAT | O_RDWR | O_CLOEXEC, 0666);
+    if (fd < 0 || flock(fd, LOCK_EX) != 0)
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        ERROR("Failed to lock '%s': %r", start_path.ptr, rc);
+        goto out;
+    }
+
+    rc = lockd_connect(sock_path.ptr);
+    if (rc != 0)
+    {
+        rc = lockd_start(sock_path.ptr, start_path.ptr);
+        if (rc == 0)
+            rc = lockd_connect(sock_path.ptr);
+    }
+
+out:
+    if (fd >= 0)
+        close(fd);
+    te_string_free(&start_path);
+    te_string_free(&sock_path);
+
+    return rc;
+}
+
+/* See the description in rcf_pch_internal.h */
+te_bool
+rcf_pch_lockd_enabled(void)
+{
+    const char *env;
+    te_bool enable = FALSE;
+
+    /*
+     * The choice depends on the environment only, so that all TAs
+     * on a host started with the same environment use the same
+     * locking scheme whether the service is reachable or not.
+     */
+    if (lockd_requested < 0)
+    {
+        env = getenv(RCF_PCH_LOCKD_ENV);
+        lockd_requested = env != NULL &&
+                          te_strtol_bool(env, &enable) == 0 && enable;
+    }
+
+    return lockd_requested;
+}
+
+/* Find the lock in the list of locks held by the process */
+static ssize_t
+lockd_held_find(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < te_vec_size(&lockd_held); i++)
+    {
+        if (strcmp(TE_VEC_GET(char *, &lockd_held, i), name) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+/*
+ * Make sure the process has its own connection to the lock service,
+ * starting the service if necessary.
+ */
+static te_errno
+lockd_ensure_connected(void)
+{
+    te_errno rc;
+
+    if (lockd_fd >= 0)
+    {
+        if (lockd_owner == getpid())
+            return 0;
+
+        /*
+         * The connection and the locks are inherited from the parent,
+         * the service accounts them to the parent.
+         */
+        close(lockd_fd);
+        lockd_fd = -1;
+        te_vec_reset(&lockd_held);
+    }
+
+    rc = lockd_open();
+    if (rc != 0)
+        ERROR("Lock service is not available: %r", rc);
+
+    return rc;
+}
+
+/*
+ * Send the request to the lock service and get the reply.
+ * If the connection is broken, locks held via it are reported as lost
+ * and the next request connects to the service again.
+ */
+static te_errno
+lockd_request(lockd_msg *msg)
+{
+    te_errno rc;
+    ssize_t n;
+    char **lost;
+
+    rc = lockd_ensure_connected();
+    if (rc != 0)
+        return rc;
+
+    n = send(lockd_fd, msg, sizeof(*msg), MSG_NOSIGNAL);
+    if (n == sizeof(*msg))
+        n = recv(lockd_fd, msg, sizeof(*msg), 0);
+
+    if (n == sizeof(*msg))
+        return msg->rc == 0 ? 0 : TE_RC(TE_RCF_PCH, msg->rc);
+
+    rc = (n < 0) ? TE_OS_RC(TE_RCF_PCH, errno) :
+                   TE_RC(TE_RCF_PCH, TE_ECONNRESET);
+    ERROR("Connection to lock service is lost: %r", rc);
+    TE_VEC_FOREACH(&lockd_held, lost)
+    {
+        ERROR("Lock %s is lost, the resource may be grabbed by others",
+              *lost);
+    }
+    te_vec_reset(&lockd_held);
+    close(lockd_fd);
+    lockd_fd = -1;
+
+    return rc;
+}
+
+/* Fill in the request */
+static te_errno
+lockd_msg_init(lockd_msg *msg, lockd_op op, const char *name)
+{
+    memset(msg, 0, sizeof(*msg));
+    msg->op = op;
+    if (te_strlcpy(msg->name, name, sizeof(msg->name)) >= sizeof(msg->name))
+        return TE_RC(TE_RCF_PCH, TE_ENAMETOOLONG);
+
+    return 0;
+}
+
+/* See the description in rcf_pch_internal.h */
+te_errno
+rcf_pch_lockd_lock(const char *name, te_bool *shared,
+                   te_bool fallback_shared,
+                   unsigned int attempts_timeout_ms)
+{
+    te_bool result_shared = *shared;
+    lockd_msg msg;
+    te_errno rc;
+
+    while (TRUE)
+    {
+        unsigned int sleep_ms;
+
+        rc = lockd_msg_init(&msg, LOCKD_OP_LOCK, name);
+        if (rc != 0)
+            return rc;
+        msg.shared = result_shared;
+
+        rc = lockd_request(&msg);
+        if (rc == 0)
+            break;
+        if (TE_RC_GET_ERROR(rc) != TE_EPERM)
+        {
+            ERROR("Failed to acquire lock %s via lock service: %r",
+                  name, rc);
+            return rc;
+        }
+
+        sleep_ms = attempts_timeout_ms > 1000 ? 1000 : attempts_timeout_ms;
+        attempts_timeout_ms -= sleep_ms;
+
+        if (sleep_ms > 0)
+        {
+            RING("Retrying to acquire lock %s", name);
+            te_msleep(sleep_ms);
+        }
+        else if (!result_shared && fallback_shared)
+        {
+            result_shared = TRUE;
+        }
+        else
+        {
+            ERROR("Failed to acquire %s lock %s",
+                  result_shared ? "shared" : "exclusive", name);
+            return rc;
+        }
+    }
+
+    if (lockd_held_find(name) < 0)
+    {
+        rc = te_vec_append_str_fmt(&lockd_held, "%s", name);
+        if (rc != 0)
+        {
+            (void)rcf_pch_lockd_unlock(name);
+            return rc;
+        }
+    }
+
+    *shared = result_shared;
+
+    return 0;
+}
+
+/* See the description in rcf_pch_internal.h */
+te_errno
+rcf_pch_lockd_unlock(const char *name)
+{
+    lockd_msg msg;
+    ssize_t idx;
+    te_errno rc;
+
+    idx = lockd_held_find(name);
+    if (idx < 0)
+    {
+        /* Nothing to release if the lock was lost with the connection */
+        WARN("Lock %s is not held via lock service", name);
+        return 0;
+    }
+    te_vec_remove_index(&lockd_held, idx);
+
+    rc = lockd_msg_init(&msg, LOCKD_OP_UNLOCK, name);
+    if (rc == 0)
+        rc = lockd_request(&msg);
+
+    if (rc != 0)
+        ERROR("Failed to release lock %s: %r", name, rc);
+
+    return rc;
+}
+
+/* See the description in rcf_pch_internal.h */
+te_errno
+rcf_pch_lockd_check(const char *pattern)
+{
+    lockd_msg msg;
+    te_errno rc;
+
+    rc = lockd_msg_init(&msg, LOCKD_OP_CHECK, pattern);
+    if (rc != 0)
+        return rc;
+
+    return lockd_request(&msg);
+}
+
+#else /* !__linux__ */
+
+/* See the description in rcf_pch_internal.h */
+te_bool
+rcf_pch_lockd_enabled(void)
+{
+    return FALSE;
+}
+
+/* See the description in rcf_pch_internal.h */
+te_errno
+rcf_pch_lockd_lock(const char *name, te_bool *shared,
+                   te_bool fallback_shared,
+                   unsigned int attempts_timeout_ms)
+{
+    UNUSED(name);
+    UNUSED(shared);
+    UNUSED(fallback_shared);
+    UNUSED(attempts_timeout_ms);
+
+    return TE_RC(TE_RCF_PCH, TE_EOPNOTSUPP);
+}
+
+/* See the description in rcf_pch_internal.h */
+te_errno
+rcf_pch_lockd_unlock(const char *name)
+{
+    UNUSED(name);
+
+    return TE_RC(TE_RCF_PCH, TE_EOPNOTSUPP);
+}
+
+/* See the description in rcf_pch_internal.h */
+te_errno
+rcf_pch_lockd_check(const char *pattern)
+{
+    UNUSED(pattern);
+
+    return TE_RC(TE_RCF_PCH, TE_EOPNOTSUPP);
+}
+
+#endif /* !__linux__ */
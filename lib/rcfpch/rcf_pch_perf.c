@@ -0,0 +1,172 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF Portable Command Handler
+ *
+ * Exposure of Test Agent performance counters (see te_perf.h)
+ * in the configuration tree.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#ifdef STDC_HEADERS
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "rcf_pch_internal.h"
+
+#include "te_errno.h"
+#include "te_defs.h"
+#include "te_str.h"
+#include "te_string.h"
+#include "te_perf.h"
+#include "rcf_ch_api.h"
+#include "rcf_pch.h"
+
+/** Context of the list of metrics names */
+typedef struct perf_list_ctx {
+    te_bool     is_hist;    /**< List histograms or counters */
+    te_string  *list;       /**< Where to append names */
+} perf_list_ctx;
+
+/* Append a metric name to the list if it has the requested kind */
+static te_errno
+perf_list_cb(const char *name, const te_perf_counter *counter,
+             const te_perf_hist *hist, void *opaque)
+{
+    perf_list_ctx *ctx = opaque;
+
+    UNUSED(counter);
+
+    if ((hist != NULL) == ctx->is_hist)
+        te_string_append(ctx->list, "%s ", name);
+
+    return 0;
+}
+
+/* List registered metrics of a kind */
+static te_errno
+perf_list(te_bool is_hist, char **list)
+{
+    te_string     str = TE_STRING_INIT;
+    perf_list_ctx ctx = { .is_hist = is_hist, .list = &str };
+
+    /* Make sure that an empty list is not NULL */
+    te_string_append(&str, "");
+    te_perf_foreach(perf_list_cb, &ctx);
+
+    *list = str.ptr;
+    return 0;
+}
+
+static te_errno
+perf_counter_list(unsigned int gid, const char *oid, const char *sub_id,
+                  char **list)
+{
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(sub_id);
+
+    return perf_list(FALSE, list);
+}
+
+static te_errno
+perf_counter_get(unsigned int gid, const char *oid, char *value,
+                 const char *perf, const char *name)
+{
+    const te_perf_counter *counter = te_perf_counter_find(name);
+
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(perf);
+
+    if (counter == NULL)
+        return TE_RC(TE_RCF_PCH, TE_ENOENT);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%" PRId64,
+                       te_perf_counter_value(counter));
+}
+
+static te_errno
+perf_hist_list(unsigned int gid, const char *oid, const char *sub_id,
+               char **list)
+{
+    UNUSED(gid);
+    UNUSED(oid);
+    UNUSED(sub_id);
+
+    return perf_list(TRUE, list);
+}
+
+/*
+ * Get a statistic of a histogram. The statistic is chosen by
+ * the last subidentifier of the OID.
+ */
+static te_errno
+perf_hist_stat_get(unsigned int gid, const char *oid, char *value,
+                   const char *perf, const char *name)
+{
+    const te_perf_hist *hist = te_perf_hist_find(name);
+    te_perf_hist_stats  stats;
+    const char         *stat = strrchr(oid, '/');
+    uint64_t            result;
+
+    UNUSED(gid);
+    UNUSED(perf);
+
+    if (hist == NULL || stat == NULL)
+        return TE_RC(TE_RCF_PCH, TE_ENOENT);
+    stat++;
+
+    te_perf_hist_stats_get(hist, &stats);
+
+    if (strcmp_start("count:", stat) == 0)
+        result = stats.count;
+    else if (strcmp_start("sum:", stat) == 0)
+        result = stats.sum;
+    else if (strcmp_start("max:", stat) == 0)
+        result = stats.max;
+    else if (strcmp_start("p50:", stat) == 0)
+        result = stats.p50;
+    else if (strcmp_start("p90:", stat) == 0)
+        result = stats.p90;
+    else if (strcmp_start("p99:", stat) == 0)
+        result = stats.p99;
+    else
+        return TE_RC(TE_RCF_PCH, TE_ENOENT);
+
+    return te_snprintf(value, RCF_MAX_VAL, "%" PRIu64, result);
+}
+
+RCF_PCH_CFG_NODE_RO(node_perf_hist_p99, "p99", NULL, NULL,
+                    perf_hist_stat_get);
+RCF_PCH_CFG_NODE_RO(node_perf_hist_p90, "p90", NULL, &node_perf_hist_p99,
+                    perf_hist_stat_get);
+RCF_PCH_CFG_NODE_RO(node_perf_hist_p50, "p50", NULL, &node_perf_hist_p90,
+                    perf_hist_stat_get);
+RCF_PCH_CFG_NODE_RO(node_perf_hist_max, "max", NULL, &node_perf_hist_p50,
+                    perf_hist_stat_get);
+RCF_PCH_CFG_NODE_RO(node_perf_hist_sum, "sum", NULL, &node_perf_hist_max,
+                    perf_hist_stat_get);
+RCF_PCH_CFG_NODE_RO(node_perf_hist_count, "count", NULL,
+                    &node_perf_hist_sum, perf_hist_stat_get);
+
+RCF_PCH_CFG_NODE_RO_COLLECTION(node_perf_hist, "hist",
+                               &node_perf_hist_count, NULL,
+                               NULL, perf_hist_list);
+
+RCF_PCH_CFG_NODE_RO_COLLECTION(node_perf_counter, "counter",
+                               NULL, &node_perf_hist,
+                               perf_counter_get, perf_counter_list);
+
+RCF_PCH_CFG_NODE_NA(node_perf, "perf", &node_perf_counter, NULL);
+
+/* See description in rcf_pch.h */
+void
+rcf_pch_perf_init(void)
+{
+    rcf_pch_add_node("/agent", &node_perf);
+}
@@ -46,6 +46,8 @@
 #include "te_defs.h"
 #include "te_stdint.h"
 #include "te_str.h"
+#include "te_perf.h"
+#include "te_trace.h"
 #include "rcf_common.h"
 #include "rcf_internal.h"
 #include "comm_agent.h"
@@ -116,6 +118,9 @@ typedef struct rpcserver {
                                 was already  called (if required) */
     char     *config;      /**< Opaque configuration string */
     time_t    sent;        /**< Time of the last request sending */
+    uint64_t  sent_us;     /**< Time of the last request sending
+                                (see te_perf_now_us()) */
+    te_trace_span span;    /**< Trace span of the last request */
     te_bool   async_call;  /**< True if async call in progress */
     uint64_t  last_jobid;  /**< Last async call job id */
 
@@ -124,6 +129,9 @@ typedef struct rpcserver {
 } rpcserver;
 
 static rpcserver *list;        /**< List of all RPC servers */
+static te_perf_hist *rpc_perf_call; /**< Duration of RPC calls from
+                                         sending of a request to receiving
+                                         of the answer, microseconds */
 static uint8_t   *rpc_buf;     /**< Buffer for receiving of RPC answers;
                                     may be used in dispatch thread
                                     context only */
@@ -820,6 +828,8 @@ dispatch(void *arg)
                 continue;
             }
 
+            te_perf_hist_add(rpc_perf_call, te_perf_now_us() - rpcs->sent_us);
+            te_trace_span_end(&rpcs->span);
             send_response(rpcs, conn_saved, rpc_buf, len);
 
             if (rpcs->timeout == 0xFFFFFFFF) /* execve() */
@@ -857,37 +867,83 @@ dispatch(void *arg)
 static const char *rpc_dir_path;
 
 /**
- * Initialize RCF RPC server structures and link RPC configuration
- * nodes to the root.
+ * Initialize RPC transport and start the thread dispatching answers
+ * of RPC servers.
+ *
+ * @return Status code.
  */
-void
-rcf_pch_rpc_init(const char *tmp_path)
+static te_errno
+rcf_pch_rpc_start(void)
 {
     pthread_t tid = 0;
+    te_errno  rc;
 
-    rpc_dir_path = tmp_path;
-    if (rpc_transport_init(rpc_dir_path) != 0)
-        return;
+    rc = rpc_transport_init(rpc_dir_path);
+    if (rc != 0)
+        return rc;
 
     if ((rpc_buf = malloc(RCF_RPC_HUGE_BUF_LEN)) == NULL)
     {
         rpc_transport_shutdown();
         ERROR("Cannot allocate memory for RPC buffer on the TA");
-        return;
+        return TE_RC(TE_RCF_PCH, TE_ENOMEM);
     }
 
     if (pthread_create(&tid, NULL, dispatch, NULL) != 0)
     {
         rpc_transport_shutdown();
         free(rpc_buf);
+        rpc_buf = NULL;
         ERROR("Failed to create the thread for RPC servers dispatching");
-        return;
+        return TE_RC(TE_RCF_PCH, TE_EFAIL);
     }
 
+    return 0;
+}
+
+/**
+ * Initialize RCF RPC server structures and link RPC configuration
+ * nodes to the root.
+ */
+void
+rcf_pch_rpc_init(const char *tmp_path)
+{
+    rpc_dir_path = tmp_path;
+    rpc_perf_call = te_perf_hist_get("rpc.call");
+
+    if (rcf_pch_rpc_start() != 0)
+        return;
+
     rcf_pch_add_node("/agent", &node_rpcserver);
     rcf_pch_rpcserver_plugin_init(&lock, call);
 }
 
+/* See description in rcf_pch_internal.h */
+void
+rcf_pch_rpc_lock(void)
+{
+    pthread_mutex_lock(&lock);
+}
+
+/* See description in rcf_pch_internal.h */
+void
+rcf_pch_rpc_unlock(void)
+{
+    pthread_mutex_unlock(&lock);
+}
+
+/* See the description in rcf_pch.h */
+te_errno
+rcf_pch_rpc_restart(void)
+{
+    if (rpc_dir_path == NULL)
+        return 0;
+
+    conn_saved = NULL;
+
+    return rcf_pch_rpc_start();
+}
+
 /**
  * Close all RCF RPC connections.
  */
@@ -1902,6 +1958,8 @@ rcf_pch_rpc(struct rcf_comm_connection *conn, int sid,
     }
 
     rpcs->sent = time(NULL);
+    rpcs->sent_us = te_perf_now_us();
+    te_trace_span_start(&rpcs->span, NULL, "rpc.%s", rpc_name);
     rpcs->last_sid = sid;
     rpcs->timeout = timeout == 0xFFFFFFFF ? timeout : timeout / 1000;
     pthread_mutex_unlock(&lock);
@@ -0,0 +1,450 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF Portable Command Handler
+ *
+ * Sub-agents served via the connection of the Test Agent.
+ *
+ * A sub-agent is a child process of the Test Agent which serves
+ * the Test Protocol for another Test Agent name, usually in another
+ * network namespace. The Test Agent passes commands addressed to
+ * the sub-agent via a socket pair, a dedicated thread passes answers
+ * of the sub-agent back to the Test Engine. So the Test Engine does not
+ * need a separate connection (and network plumbing required for it)
+ * for every network namespace.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#ifdef STDC_HEADERS
+#include <stdlib.h>
+#include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <pthread.h>
+
+#include "rcf_pch_internal.h"
+
+#include "te_errno.h"
+#include "te_defs.h"
+#include "te_alloc.h"
+#include "te_queue.h"
+#include "te_string.h"
+#include "te_proto.h"
+#include "rcf_common.h"
+#include "comm_agent.h"
+#include "agentlib.h"
+#include "rcf_pch.h"
+#include "rcf_ch_api.h"
+
+/** Time to wait for a sub-agent exit after its connection is closed */
+#define RCF_PCH_SUBAGENT_EXIT_TIMEOUT_MS    1000
+
+/** Sub-agent started by the Test Agent */
+typedef struct rcf_pch_subagent {
+    SLIST_ENTRY(rcf_pch_subagent) links;    /**< List links */
+
+    char                       *name;       /**< Sub-agent name */
+    char                       *tag;        /**< Prefix of its answers */
+    pid_t                       pid;        /**< Sub-agent process */
+    int                         sock;       /**< Socket connected to
+                                                 the sub-agent */
+    struct rcf_comm_connection *conn;       /**< Connection over
+                                                 @p sock */
+    pthread_t                   relay;      /**< Thread passing answers */
+    te_bool                     dead;       /**< Connection is lost */
+    te_bool                     stopping;   /**< Sub-agent is stopped */
+} rcf_pch_subagent;
+
+/** Sub-agents started by the Test Agent */
+static SLIST_HEAD(, rcf_pch_subagent) subagents =
+    SLIST_HEAD_INITIALIZER(subagents);
+
+/** Connection to the Test Engine */
+static struct rcf_comm_connection *subagent_ten_conn = NULL;
+
+/** Name of the sub-agent served by the current process */
+static char *subagent_self = NULL;
+
+/* Find a sub-agent by name */
+static rcf_pch_subagent *
+subagent_find(const char *name)
+{
+    rcf_pch_subagent *sub;
+
+    SLIST_FOREACH(sub, &subagents, links)
+    {
+        if (strcmp(sub->name, name) == 0)
+            return sub;
+    }
+
+    return NULL;
+}
+
+/* Release a sub-agent structure and close the connection to it */
+static void
+subagent_free(rcf_pch_subagent *sub)
+{
+    if (sub->conn != NULL)
+        rcf_comm_agent_close(&sub->conn);
+    else if (sub->sock >= 0)
+        close(sub->sock);
+
+    free(sub->name);
+    free(sub->tag);
+    free(sub);
+}
+
+/*
+ * Entry point of the thread passing answers of a sub-agent to the Test
+ * Engine. Answers are prefixed with the sub-agent tag, so the Test
+ * Engine can tell them from answers of the Test Agent itself.
+ */
+static void *
+subagent_relay_answers(void *arg)
+{
+    rcf_pch_subagent *sub = arg;
+    size_t            buf_len = RCF_MAX_LEN;
+    char             *buf = TE_ALLOC(buf_len);
+    te_errno          rc;
+
+    while (TRUE)
+    {
+        size_t  len = buf_len;
+        void   *ba = NULL;
+
+        rc = rcf_comm_agent_wait(sub->conn, buf, &len, &ba);
+        if (TE_RC_GET_ERROR(rc) == TE_EPENDING)
+        {
+            size_t received = buf_len;
+            size_t rest = len - received;
+
+            TE_REALLOC(buf, len);
+            buf_len = len;
+            rc = rcf_comm_agent_wait(sub->conn, buf + received,
+                                     &rest, NULL);
+        }
+        if (rc != 0)
+            break;
+
+        RCF_CH_LOCK;
+        rc = rcf_comm_agent_reply(subagent_ten_conn, sub->tag,
+                                  strlen(sub->tag));
+        if (rc == 0)
+            rc = rcf_comm_agent_reply(subagent_ten_conn, buf, len);
+        RCF_CH_UNLOCK;
+        if (rc != 0)
+            break;
+    }
+
+    if (!__atomic_load_n(&sub->stopping, __ATOMIC_RELAXED))
+        ERROR("Connection with sub-agent '%s' is lost: %r", sub->name, rc);
+    __atomic_store_n(&sub->dead, TRUE, __ATOMIC_RELAXED);
+
+    free(buf);
+
+    return NULL;
+}
+
+/*
+ * Prepare the sub-agent process and serve commands. Connections
+ * to other sub-agents inherited from the Test Agent are closed.
+ * The status of preparation is reported to the Test Agent via @p sock.
+ */
+static void
+subagent_child(const char *name, int sock, rcf_pch_subagent_enter *enter,
+               void *opaque)
+{
+    struct rcf_comm_connection *conn = NULL;
+    rcf_pch_subagent           *sub;
+    te_errno                    rc = 0;
+
+    while ((sub = SLIST_FIRST(&subagents)) != NULL)
+    {
+        SLIST_REMOVE_HEAD(&subagents, links);
+        subagent_free(sub);
+    }
+    subagent_ten_conn = NULL;
+    subagent_self = TE_STRDUP(name);
+
+    if (enter != NULL)
+        rc = enter(subagent_self, opaque);
+    if (rc == 0)
+        rc = rcf_pch_rpc_restart();
+    if (rc == 0)
+        rc = rcf_comm_agent_attach(sock, &conn);
+
+    if (write(sock, &rc, sizeof(rc)) != sizeof(rc) || rc != 0)
+        _exit(EXIT_FAILURE);
+
+    rcf_pch_subagent_serve(conn);
+}
+
+/* Wait for a sub-agent process exit, kill it if it does not exit */
+static void
+subagent_wait_exit(rcf_pch_subagent *sub)
+{
+    unsigned int waited;
+
+    for (waited = 0; waited < RCF_PCH_SUBAGENT_EXIT_TIMEOUT_MS;
+         waited += 10)
+    {
+        if (ta_waitpid(sub->pid, NULL, WNOHANG) != 0)
+            return;
+
+        usleep(10000);
+    }
+
+    WARN("Sub-agent '%s' does not exit, killing it", sub->name);
+    kill(sub->pid, SIGKILL);
+    ta_waitpid(sub->pid, NULL, 0);
+}
+
+/* Stop a sub-agent removed from the list */
+static void
+subagent_stop(rcf_pch_subagent *sub)
+{
+    __atomic_store_n(&sub->stopping, TRUE, __ATOMIC_RELAXED);
+
+    /* The sub-agent exits when its connection is closed */
+    shutdown(sub->sock, SHUT_RDWR);
+    pthread_join(sub->relay, NULL);
+    subagent_wait_exit(sub);
+
+    INFO("Sub-agent '%s' is stopped", sub->name);
+    subagent_free(sub);
+}
+
+/* See description in rcf_pch.h */
+te_errno
+rcf_pch_subagent_start(const char *name, rcf_pch_subagent_enter *enter,
+                       void *opaque)
+{
+    rcf_pch_subagent   *sub;
+    te_errno            status;
+    te_errno            rc;
+    ssize_t             ret;
+    int                 sv[2];
+
+    if (subagent_self != NULL)
+    {
+        ERROR("Sub-agent '%s' cannot start sub-agents", subagent_self);
+        return TE_RC(TE_RCF_PCH, TE_EPERM);
+    }
+
+    if (subagent_find(name) != NULL)
+    {
+        ERROR("Sub-agent '%s' already exists", name);
+        return TE_RC(TE_RCF_PCH, TE_EEXIST);
+    }
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        ERROR("Failed to create socket pair for sub-agent '%s': %r",
+              name, rc);
+        return rc;
+    }
+#if HAVE_FCNTL_H
+    /* Processes executed by the sub-agent must not keep its connection */
+    (void)fcntl(sv[0], F_SETFD, FD_CLOEXEC);
+    (void)fcntl(sv[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+    sub = TE_ALLOC(sizeof(*sub));
+    sub->name = TE_STRDUP(name);
+    sub->tag = te_string_fmt("%c%s ", TE_PROTO_SUBAGENT, name);
+    sub->sock = sv[0];
+
+    /*
+     * The Test Agent is multithreaded: hold the locks of the state
+     * used by the child (RPC servers, connection to the Test Engine),
+     * so that no other thread is in the middle of its modification
+     * when the process is copied. The locks are released by the same
+     * thread in both processes.
+     */
+    rcf_pch_rpc_lock();
+    RCF_CH_LOCK;
+    sub->pid = fork();
+    RCF_CH_UNLOCK;
+    rcf_pch_rpc_unlock();
+
+    if (sub->pid == 0)
+    {
+        close(sv[0]);
+        subagent_child(name, sv[1], enter, opaque);
+    }
+
+    close(sv[1]);
+    if (sub->pid < 0)
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        ERROR("Failed to fork sub-agent '%s': %r", name, rc);
+        subagent_free(sub);
+        return rc;
+    }
+
+    ret = read(sub->sock, &status, sizeof(status));
+    if (ret != sizeof(status))
+    {
+        ERROR("Sub-agent '%s' has exited unexpectedly", name);
+        status = TE_RC(TE_RCF_PCH, TE_ECHILD);
+    }
+    else if (status != 0)
+    {
+        ERROR("Failed to prepare sub-agent '%s': %r", name, status);
+    }
+
+    if (status == 0)
+        status = rcf_comm_agent_attach(sub->sock, &sub->conn);
+
+    if (status == 0 &&
+        pthread_create(&sub->relay, NULL, subagent_relay_answers, sub) != 0)
+    {
+        ERROR("Failed to create the thread for sub-agent '%s'", name);
+        status = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    }
+
+    if (status != 0)
+    {
+        shutdown(sub->sock, SHUT_RDWR);
+        subagent_wait_exit(sub);
+        subagent_free(sub);
+        return status;
+    }
+
+    SLIST_INSERT_HEAD(&subagents, sub, links);
+
+    RING("Sub-agent '%s' is started, PID %d", name, (int)sub->pid);
+
+    return 0;
+}
+
+/* See description in rcf_pch.h */
+te_errno
+rcf_pch_subagent_stop(const char *name)
+{
+    rcf_pch_subagent *sub = subagent_find(name);
+
+    if (sub == NULL)
+    {
+        ERROR("Sub-agent '%s' does not exist", name);
+        return TE_RC(TE_RCF_PCH, TE_ENOENT);
+    }
+
+    SLIST_REMOVE(&subagents, sub, rcf_pch_subagent, links);
+    subagent_stop(sub);
+
+    return 0;
+}
+
+/* See description in rcf_pch.h */
+te_bool
+rcf_pch_subagent_exists(const char *name)
+{
+    return subagent_find(name) != NULL;
+}
+
+/* See description in rcf_pch.h */
+const char *
+rcf_pch_subagent_self(void)
+{
+    return subagent_self;
+}
+
+/* See description in rcf_pch_internal.h */
+void
+rcf_pch_subagent_init(struct rcf_comm_connection *conn)
+{
+    subagent_ten_conn = conn;
+}
+
+/*
+ * Answer a command addressed to a sub-agent with an error on its
+ * behalf.
+ */
+static te_errno
+subagent_answer_error(struct rcf_comm_connection *conn, const char *name,
+                      const char *cmd, te_errno error)
+{
+    te_string   answer = TE_STRING_INIT;
+    int         sid;
+    te_errno    rc;
+
+    if (sscanf(cmd, "SID %d", &sid) != 1)
+    {
+        ERROR("Cannot answer command <%s> without SID", cmd);
+        return 0;
+    }
+
+    te_string_append(&answer, "%c%s SID %d %u", TE_PROTO_SUBAGENT,
+                     name, sid, error);
+
+    RCF_CH_LOCK;
+    rc = rcf_comm_agent_reply(conn, answer.ptr, answer.len + 1);
+    RCF_CH_UNLOCK;
+
+    te_string_free(&answer);
+
+    return rc;
+}
+
+/* See description in rcf_pch_internal.h */
+te_errno
+rcf_pch_subagent_relay(struct rcf_comm_connection *conn, char *cmd,
+                       size_t len)
+{
+    rcf_pch_subagent   *sub;
+    char               *name = cmd + 1;
+    char               *end = strchr(name, ' ');
+    te_errno            rc;
+
+    if (end == NULL)
+    {
+        ERROR("Bad sub-agent command <%s> is received", cmd);
+        return 0;
+    }
+    *end++ = '\0';
+
+    sub = subagent_find(name);
+    if (sub == NULL || __atomic_load_n(&sub->dead, __ATOMIC_RELAXED))
+    {
+        ERROR("Command <%s> for %s sub-agent '%s' is received", end,
+              sub == NULL ? "unknown" : "dead", name);
+        rc = TE_RC(TE_RCF_PCH, TE_ENOENT);
+    }
+    else
+    {
+        rc = rcf_comm_agent_reply(sub->conn, end, len - (end - cmd));
+        if (rc == 0)
+            return 0;
+
+        ERROR("Failed to pass command to sub-agent '%s': %r", name, rc);
+    }
+
+    return subagent_answer_error(conn, name, end, rc);
+}
+
+/* See description in rcf_pch_internal.h */
+void
+rcf_pch_subagent_shutdown(void)
+{
+    rcf_pch_subagent *sub;
+
+    while ((sub = SLIST_FIRST(&subagents)) != NULL)
+    {
+        SLIST_REMOVE_HEAD(&subagents, links);
+        subagent_stop(sub);
+    }
+}
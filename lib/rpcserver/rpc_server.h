@@ -1323,4 +1323,40 @@ extern te_errno tarpc_fill_buff_with_sequence(char *buf, int size,
 extern te_errno tarpc_fill_buff_with_sequence_lcg(char *buf, int size,
                                                   tarpc_pat_gen_arg *arg);
 
+/**
+ * Length of the header put by tarpc_fill_buff_with_sequence_lcg_pos()
+ * at the beginning of every generated message.
+ */
+#define TARPC_LCG_POS_HDR_LEN 8
+
+/**
+ * Fills the buffer with a message carrying a part of linear
+ * congruential sequence together with its position in the sequence,
+ * and updates @b arg parameter for the next call.
+ *
+ * The message starts with a header containing the index of the first
+ * sequence element in the message (64-bit number in network byte order),
+ * the rest of the message is filled with the sequence elements like
+ * tarpc_fill_buff_with_sequence_lcg() does. Every message starts from
+ * a new element, so the tail of its last element may be cut off.
+ *
+ * It is intended for datagram sockets: each message may be checked
+ * on its own, so receiver may go on after lost, duplicated or reordered
+ * messages. It makes no sense for stream sockets.
+ *
+ * @param buf            Buffer
+ * @param size           Message size (not less than
+ *                       @c TARPC_LCG_POS_HDR_LEN)
+ * @param arg            Pointer to @ref tarpc_pat_gen_arg structure, where:
+ *                       - coef1 is @a x0 - element at position @b pos;
+ *                       - coef2 is @a a - multiplying constant;
+ *                       - coef3 is @a c - additive constant;
+ *                       - offset should be @c 0;
+ *                       - pos is index of the next element.
+ *
+ * @return Status code.
+ */
+extern te_errno tarpc_fill_buff_with_sequence_lcg_pos(char *buf, int size,
+                                                      tarpc_pat_gen_arg *arg);
+
 #endif /* __TARPC_SERVER_H__ */
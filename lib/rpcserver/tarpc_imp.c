@@ -7982,48 +7982,366 @@ get_nth_elm(int n)
     }
 }
 
+/**
+ * Period of get_nth_elm() values. Since SEQUENCE_PERIOD_NUM is
+ * not parenthesized, "n % SEQUENCE_PERIOD_NUM" there depends on
+ * n modulo 255 only.
+ */
+#define SEQUENCE_ELM_PERIOD 255
+
+/** Size of sequence_table (a multiple of SEQUENCE_ELM_PERIOD) */
+#define SEQUENCE_TABLE_SIZE (SEQUENCE_ELM_PERIOD * 64)
+
+/** Precomputed get_nth_elm() values */
+static char sequence_table[SEQUENCE_TABLE_SIZE];
+/** Guard of sequence_table initialization */
+static pthread_once_t sequence_table_once = PTHREAD_ONCE_INIT;
+
+/* Fill sequence_table[] */
+static void
+sequence_table_init(void)
+{
+    int i;
+
+    for (i = 0; i < SEQUENCE_TABLE_SIZE; i++)
+        sequence_table[i] = get_nth_elm(i);
+}
+
 /* See description in rpc_server.h */
 te_errno
 tarpc_fill_buff_with_sequence(char *buf, int size, tarpc_pat_gen_arg *arg)
 {
-    int i;
     int start_n = arg->coef1 % SEQUENCE_PERIOD_NUM;
+    int len;
+
     arg->coef1 += size;
 
-    for (i = 0; i < size; i++)
+    pthread_once(&sequence_table_once, sequence_table_init);
+
+    /* Copy precomputed values instead of computing every byte */
+    start_n %= SEQUENCE_ELM_PERIOD;
+    while (size > 0)
     {
-        buf[i] = get_nth_elm(start_n + i);
+        len = MIN(size, SEQUENCE_TABLE_SIZE - start_n);
+        memcpy(buf, sequence_table + start_n, len);
+        buf += len;
+        size -= len;
+        start_n = (start_n + len) % SEQUENCE_ELM_PERIOD;
     }
 
     return 0;
 }
 
+/**
+ * Number of LCG elements computed in parallel. Every lane jumps
+ * over this number of elements on each step, so lanes do not depend
+ * on each other and the loop may be vectorized by compiler.
+ */
+#define TARPC_LCG_LANES 8
+
+/**
+ * Compute coefficients of LCG jumping over @p n elements at once,
+ * i.e. X[k + n] = a_n * X[k] + c_n. It takes O(log n) steps.
+ *
+ * @param a     Multiplying constant
+ * @param c     Additive constant
+ * @param n     Number of elements to jump over
+ * @param a_n   Where to save multiplying constant of the jump
+ * @param c_n   Where to save additive constant of the jump
+ */
+static void
+tarpc_lcg_jump(uint32_t a, uint32_t c, uint64_t n,
+               uint32_t *a_n, uint32_t *c_n)
+{
+    uint32_t acc_a = 1;
+    uint32_t acc_c = 0;
+
+    for (; n > 0; n >>= 1)
+    {
+        if ((n & 1) != 0)
+        {
+            acc_a *= a;
+            acc_c = acc_c * a + c;
+        }
+        c *= a + 1;
+        a *= a;
+    }
+
+    *a_n = acc_a;
+    *c_n = acc_c;
+}
+
+/**
+ * Fill an array with LCG elements in network byte order.
+ *
+ * @param words     Where to put elements
+ * @param num       Number of elements
+ * @param x         The first element
+ * @param a         Multiplying constant
+ * @param c         Additive constant
+ *
+ * @return The element following the last one put to @p words.
+ */
+static uint32_t
+tarpc_lcg_fill(uint32_t *words, unsigned int num,
+               uint32_t x, uint32_t a, uint32_t c)
+{
+    uint32_t lanes[TARPC_LCG_LANES];
+    uint32_t a_n;
+    uint32_t c_n;
+    unsigned int i;
+    unsigned int j;
+
+    for (j = 0; j < TARPC_LCG_LANES; j++)
+    {
+        lanes[j] = x;
+        x = a * x + c;
+    }
+    tarpc_lcg_jump(a, c, TARPC_LCG_LANES, &a_n, &c_n);
+
+    for (i = 0; i + TARPC_LCG_LANES <= num; i += TARPC_LCG_LANES)
+    {
+        for (j = 0; j < TARPC_LCG_LANES; j++)
+        {
+            words[i + j] = htonl(lanes[j]);
+            lanes[j] = a_n * lanes[j] + c_n;
+        }
+    }
+
+    for (j = 0; i < num; i++, j++)
+        words[i] = htonl(lanes[j]);
+
+    return lanes[j];
+}
+
 /* See description in rpc_server.h */
 te_errno
 tarpc_fill_buff_with_sequence_lcg(char *buf, int size,
                                   tarpc_pat_gen_arg *arg)
 {
-    int i;
-    uint32_t x0 = arg->coef1;
-    uint32_t a = arg->coef2;
-    uint32_t c = arg->coef3;
     uint32_t *p32buf = (uint32_t *)buf;
     int word_size = (size + arg->offset + 3) / 4;
+    uint32_t next;
 
     if (size == 0)
         return 0;
 
     arg->offset = (size + arg->offset) % 4;
-    p32buf[0] = htonl(x0);
+    next = tarpc_lcg_fill(p32buf, word_size, arg->coef1,
+                          arg->coef2, arg->coef3);
+
+    /* The last element is sent partially, it starts the next chunk */
+    arg->coef1 = arg->offset ? ntohl(p32buf[word_size - 1]) : next;
+    return 0;
+}
+
+/* See description in rpc_server.h */
+te_errno
+tarpc_fill_buff_with_sequence_lcg_pos(char *buf, int size,
+                                      tarpc_pat_gen_arg *arg)
+{
+    uint32_t hdr[TARPC_LCG_POS_HDR_LEN / 4];
+    unsigned int word_size;
+
+    if (size < TARPC_LCG_POS_HDR_LEN || arg->offset != 0)
+        return TE_EINVAL;
+
+    word_size = (size - TARPC_LCG_POS_HDR_LEN + 3) / 4;
+
+    hdr[0] = htonl(arg->pos >> 32);
+    hdr[1] = htonl(arg->pos & UINT32_MAX);
+    memcpy(buf, hdr, sizeof(hdr));
+
+    arg->coef1 = tarpc_lcg_fill((uint32_t *)(buf + TARPC_LCG_POS_HDR_LEN),
+                                word_size, arg->coef1,
+                                arg->coef2, arg->coef3);
+    arg->pos += word_size;
+    return 0;
+}
+
+/** Maximum number of gaps in received sequence tracked by verifier */
+#define TARPC_PAT_MAX_GAPS 64
+
+/** Range of sequence elements which were not received yet */
+typedef struct tarpc_pat_gap {
+    uint64_t start;     /**< The first missing element */
+    uint64_t end;       /**< The element after the last missing one */
+} tarpc_pat_gap;
 
-    for (i = 1; i < word_size; ++i)
+/**
+ * Verifier of messages generated by
+ * tarpc_fill_buff_with_sequence_lcg_pos().
+ */
+typedef struct tarpc_pat_verifier {
+    uint64_t        pos0;       /**< Position of the first element */
+    uint32_t        x0;         /**< The first element */
+    uint32_t        a;          /**< Multiplying constant */
+    uint32_t        c;          /**< Additive constant */
+
+    uint64_t        next_pos;   /**< Position of the element following
+                                     the last received one */
+    uint32_t        next_x;     /**< Element at @a next_pos */
+
+    tarpc_pat_gap   gaps[TARPC_PAT_MAX_GAPS];   /**< Missing ranges
+                                                     sorted by position */
+    unsigned int    gaps_num;   /**< Number of missing ranges */
+
+    uint64_t        lost;       /**< Number of missing elements */
+    uint64_t        duplicated; /**< Number of duplicated messages */
+    uint64_t        reordered;  /**< Number of reordered messages */
+} tarpc_pat_verifier;
+
+/* Initialize verifier by pattern generator arguments */
+static void
+tarpc_pat_verifier_init(tarpc_pat_verifier *ver,
+                        const tarpc_pat_gen_arg *arg)
+{
+    memset(ver, 0, sizeof(*ver));
+    ver->pos0 = ver->next_pos = arg->pos;
+    ver->x0 = ver->next_x = arg->coef1;
+    ver->a = arg->coef2;
+    ver->c = arg->coef3;
+}
+
+/* Account a message which fills missing elements or is a duplicate */
+static void
+tarpc_pat_verifier_fill_gap(tarpc_pat_verifier *ver,
+                            uint64_t start, uint64_t end)
+{
+    tarpc_pat_gap *gap;
+    unsigned int i;
+
+    for (i = 0; i < ver->gaps_num; i++)
     {
-        uint32_t curr_elem = a * x0 + c;
-        p32buf[i] = htonl(curr_elem);
-        x0 = curr_elem;
+        gap = &ver->gaps[i];
+        if (gap->start <= start && end <= gap->end)
+            break;
     }
 
-    arg->coef1 = arg->offset ? x0 : (a * x0 + c);
+    if (i == ver->gaps_num)
+    {
+        ver->duplicated++;
+        return;
+    }
+
+    ver->reordered++;
+    ver->lost -= end - start;
+
+    if (gap->start == start && gap->end == end)
+    {
+        ver->gaps_num--;
+        memmove(gap, gap + 1, (ver->gaps_num - i) * sizeof(*gap));
+    }
+    else if (gap->start == start)
+    {
+        gap->start = end;
+    }
+    else if (gap->end == end)
+    {
+        gap->end = start;
+    }
+    else
+    {
+        if (ver->gaps_num == TARPC_PAT_MAX_GAPS)
+        {
+            /* Forget the oldest missing elements, they remain lost */
+            if (i == 0)
+            {
+                gap->start = end;
+                return;
+            }
+
+            ver->gaps_num--;
+            memmove(ver->gaps, ver->gaps + 1, ver->gaps_num * sizeof(*gap));
+            gap--;
+            i--;
+        }
+
+        memmove(gap + 1, gap, (ver->gaps_num - i) * sizeof(*gap));
+        ver->gaps_num++;
+        gap[0].end = start;
+        gap[1].start = end;
+    }
+}
+
+/**
+ * Check a message generated by tarpc_fill_buff_with_sequence_lcg_pos()
+ * and account it in loss, duplication and reordering statistics.
+ *
+ * @param ver       Verifier
+ * @param buf       Received message
+ * @param len       Length of the message
+ * @param check_buf Buffer for expected data (at least
+ *                  @c TARPC_LCG_LEN(@p len) bytes)
+ *
+ * @return Status code.
+ * @retval TE_EILSEQ    the message does not match the pattern.
+ */
+static te_errno
+tarpc_pat_verifier_check(tarpc_pat_verifier *ver, const char *buf, int len,
+                         char *check_buf)
+{
+    uint32_t hdr[TARPC_LCG_POS_HDR_LEN / 4];
+    unsigned int word_size;
+    uint64_t pos;
+    uint64_t end;
+    uint32_t x;
+    uint32_t next_x;
+    uint32_t a_n;
+    uint32_t c_n;
+
+    if (len < TARPC_LCG_POS_HDR_LEN)
+        return TE_EILSEQ;
+
+    memcpy(hdr, buf, sizeof(hdr));
+    pos = ((uint64_t)ntohl(hdr[0]) << 32) | ntohl(hdr[1]);
+    if (pos < ver->pos0)
+        return TE_EILSEQ;
+
+    word_size = (len - TARPC_LCG_POS_HDR_LEN + 3) / 4;
+    end = pos + word_size;
+
+    if (pos == ver->next_pos)
+    {
+        x = ver->next_x;
+    }
+    else
+    {
+        /* Resynchronise: compute the element at the received position */
+        tarpc_lcg_jump(ver->a, ver->c, pos - ver->pos0, &a_n, &c_n);
+        x = a_n * ver->x0 + c_n;
+    }
+
+    next_x = tarpc_lcg_fill((uint32_t *)check_buf, word_size, x,
+                            ver->a, ver->c);
+    if (memcmp(buf + TARPC_LCG_POS_HDR_LEN, check_buf,
+               len - TARPC_LCG_POS_HDR_LEN) != 0)
+        return TE_EILSEQ;
+
+    if (pos < ver->next_pos)
+    {
+        tarpc_pat_verifier_fill_gap(ver, pos, end);
+        return 0;
+    }
+
+    if (pos > ver->next_pos)
+    {
+        if (ver->gaps_num == TARPC_PAT_MAX_GAPS)
+        {
+            /* Forget the oldest gap, its elements remain lost */
+            ver->gaps_num--;
+            memmove(ver->gaps, ver->gaps + 1,
+                    ver->gaps_num * sizeof(ver->gaps[0]));
+        }
+
+        ver->gaps[ver->gaps_num].start = ver->next_pos;
+        ver->gaps[ver->gaps_num].end = pos;
+        ver->gaps_num++;
+        ver->lost += pos - ver->next_pos;
+    }
+
+    ver->next_pos = end;
+    ver->next_x = next_x;
     return 0;
 }
 
@@ -8455,6 +8773,9 @@ pattern_receiver(tarpc_pattern_receiver_in *in,
     struct timeval tv_now;
     int default_recv_timeout = 0;
 
+    tarpc_pat_verifier  ver;
+    te_bool             use_ver;
+
     out->gen_arg = in->gen_arg;
     out->bytes = 0;
 
@@ -8511,6 +8832,15 @@ pattern_receiver(tarpc_pattern_receiver_in *in,
                 rcf_ch_symbol_addr(in->fname.fname_val, TRUE)) == NULL)
         return -1;
 
+    /*
+     * Messages carrying their position in the sequence are checked
+     * one by one, so that lost or reordered ones do not break checking.
+     */
+    use_ver = ((void *)pattern_gen_func ==
+               (void *)tarpc_fill_buff_with_sequence_lcg_pos);
+    if (use_ver)
+        tarpc_pat_verifier_init(&ver, &in->gen_arg);
+
     if ((buf = malloc(MAX_PKT)) == NULL ||
         (check_buf = malloc(TARPC_LCG_LEN(MAX_PKT))) == NULL)
     {
@@ -8653,6 +8983,25 @@ pattern_receiver(tarpc_pattern_receiver_in *in,
             else
                 len = 0;
         }
+        else if (use_ver)
+        {
+            if (tarpc_pat_verifier_check(&ver, buf, len, check_buf) != 0)
+            {
+                LOG_HEX_DIFF_DUMP(TE_LL_WARN, check_buf,
+                                  buf + TARPC_LCG_POS_HDR_LEN,
+                                  MAX(len - TARPC_LCG_POS_HDR_LEN, 0));
+
+                te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                                 "%s(): received data does not match the "
+                                 "pattern", __FUNCTION__);
+                iomux_close(iomux, &iomux_f, &iomux_st);
+                free(buf);
+                free(check_buf);
+                if (iomux == FUNC_NO_IOMUX)
+                    SET_RECV_TIMEOUT(default_recv_timeout);
+                return -2;
+            }
+        }
         else
         {
             if ((rc = pattern_gen_func(check_buf, len, &in->gen_arg)) != 0)
@@ -8692,8 +9041,24 @@ pattern_receiver(tarpc_pattern_receiver_in *in,
 #undef MSEC_DIFF
 #undef MAX_OFFSET
 
-    RING("pattern_receiver() stopped, received %llu bytes",
-         out->bytes);
+    if (use_ver)
+    {
+        in->gen_arg.coef1 = ver.next_x;
+        in->gen_arg.pos = ver.next_pos;
+        out->lost = ver.lost * 4;
+        out->duplicated = ver.duplicated;
+        out->reordered = ver.reordered;
+
+        RING("pattern_receiver() stopped, received %llu bytes, "
+             "lost %llu bytes, duplicated %llu and reordered %llu "
+             "messages", out->bytes, out->lost, out->duplicated,
+             out->reordered);
+    }
+    else
+    {
+        RING("pattern_receiver() stopped, received %llu bytes",
+             out->bytes);
+    }
 
     out->gen_arg = in->gen_arg;
 
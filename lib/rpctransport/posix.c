@@ -56,6 +56,23 @@
 #include <sys/un.h>
 #endif
 
+#if HAVE_POLL_H
+#include <poll.h>
+#endif
+
+/*
+ * Shared memory rings are used with local transport on Linux only
+ * since eventfd is required.
+ */
+#if defined(ENABLE_LOCAL_TRANSPORT) && defined(__linux__)
+#define RPC_TRANSPORT_SHM
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <limits.h>
+#endif
+
 /** Maximum length of the name in sockaddr_un */
 #ifndef UNIX_PATH_MAX
 #define UNIX_PATH_MAX   sizeof(((struct sockaddr_un *)0)->sun_path)
@@ -81,8 +98,14 @@ rpc_transport_log(char *str)
 /** Listening socket */
 static int lsock = -1;
 
-/** Set for listening multiple sessions */
-static fd_set rset;
+/** Descriptors for listening multiple sessions */
+static struct pollfd *rset;
+/** Connection handles corresponding to rset entries */
+static rpc_transport_handle *rset_handles;
+/** Number of entries in rset */
+static unsigned int rset_num;
+/** Number of allocated entries in rset */
+static unsigned int rset_max;
 
 
 /*
@@ -126,6 +149,882 @@ tcp_nodelay_enable(int sock)
 
 #endif
 
+#ifdef RPC_TRANSPORT_SHM
+
+/** Magic number at the beginning of the shared memory area */
+#define RPC_SHM_MAGIC       0x54455250
+
+/** Size of the shared memory area header */
+#define RPC_SHM_HDR_SIZE    4096
+
+/** Size of a ring (must be a power of 2) */
+#define RPC_SHM_RING_SIZE   (256 * 1024)
+
+/** Number of ring checks before going to sleep */
+#define RPC_SHM_SPIN        512
+
+/** Number of file descriptors passed from TA to RPC server */
+#define RPC_SHM_FDS_NUM     5
+
+/**
+ * Connection mode negotiation messages. The RPC server requests
+ * a mode, the TA offers it (with shared memory and eventfds attached
+ * if the mode is shared memory) and the RPC server acknowledges
+ * the offer. Shared memory is used only if all three messages are
+ * RPC_SHM_MODE_SHM, the socket is used otherwise.
+ */
+#define RPC_SHM_MODE_SHM    'S'
+#define RPC_SHM_MODE_SOCK   'N'
+
+/** Control block of a ring, it is written by both sides */
+typedef struct rpc_shm_ring {
+    uint32_t head;          /**< Number of bytes consumed */
+    uint8_t  pad1[60];      /**< Padding to a separate cache line */
+    uint32_t tail;          /**< Number of bytes produced */
+    uint8_t  pad2[60];      /**< Padding to a separate cache line */
+    uint32_t data_waiters;  /**< Number of consumer threads going to
+                                 sleep waiting for data */
+    uint32_t space_waiters; /**< Number of producer threads going to
+                                 sleep waiting for free space */
+    uint8_t  pad3[56];      /**< Padding to a separate cache line */
+} rpc_shm_ring;
+
+/**
+ * Header of the shared memory area. It is followed by data of
+ * the TA to RPC server ring and data of the RPC server to TA ring.
+ */
+typedef struct rpc_shm_hdr {
+    uint32_t     magic;     /**< RPC_SHM_MAGIC */
+    uint32_t     ring_size; /**< Size of each ring */
+    uint8_t      pad[56];   /**< Padding to a separate cache line */
+    rpc_shm_ring rings[2];  /**< Control blocks of the rings */
+} rpc_shm_hdr;
+
+/** Shared memory connection state (local to the process) */
+typedef struct rpc_shm_conn {
+    void         *mem;          /**< Mapped shared memory area */
+    size_t        mem_len;      /**< Length of the area */
+    uint32_t      size;         /**< Size of each ring */
+
+    rpc_shm_ring *tx;           /**< Ring to send data to */
+    uint8_t      *tx_data;      /**< Data of the ring to send data to */
+    int           tx_data_fd;   /**< Eventfd to notify the peer about
+                                     new data */
+    int           tx_space_fd;  /**< Eventfd to wait for free space */
+
+    rpc_shm_ring *rx;           /**< Ring to receive data from */
+    uint8_t      *rx_data;      /**< Data of the ring to receive data
+                                     from */
+    int           rx_data_fd;   /**< Eventfd to wait for new data */
+    int           rx_space_fd;  /**< Eventfd to notify the peer about
+                                     free space */
+} rpc_shm_conn;
+
+/**
+ * Shared memory connections indexed by socket. The table belongs to
+ * the process which established the connections, it is cleared in
+ * a forked child.
+ */
+static rpc_shm_conn **shm_conns;
+/** Number of elements in shm_conns */
+static int shm_conns_num;
+/** Lock protecting shm_conns */
+static pthread_mutex_t shm_lock = PTHREAD_MUTEX_INITIALIZER;
+/** Control of fork handlers registration */
+static pthread_once_t shm_atfork_once = PTHREAD_ONCE_INIT;
+
+/** Directory for the shared memory file if memfd is not available */
+static const char *shm_tmp_path = "/tmp";
+
+/* Check if shared memory transport is requested */
+static te_bool
+shm_enabled(void)
+{
+    const char *value = getenv(RPC_TRANSPORT_SHM_ENV);
+
+    return value != NULL && strcmp(value, "1") == 0;
+}
+
+/* Get shared memory connection state of the socket */
+static rpc_shm_conn *
+shm_conn_get(int sock)
+{
+    rpc_shm_conn *conn = NULL;
+
+    pthread_mutex_lock(&shm_lock);
+    if (sock >= 0 && sock < shm_conns_num)
+        conn = shm_conns[sock];
+    pthread_mutex_unlock(&shm_lock);
+
+    return conn;
+}
+
+/* Release shared memory connection state */
+static void
+shm_conn_free(rpc_shm_conn *conn)
+{
+    if (conn->mem != NULL)
+        munmap(conn->mem, conn->mem_len);
+    close(conn->tx_data_fd);
+    close(conn->tx_space_fd);
+    close(conn->rx_data_fd);
+    close(conn->rx_space_fd);
+    free(conn);
+}
+
+/* Keep shm_conns consistent over fork() */
+static void
+shm_atfork_prepare(void)
+{
+    pthread_mutex_lock(&shm_lock);
+}
+
+/* Release shm_conns in the parent after fork() */
+static void
+shm_atfork_parent(void)
+{
+    pthread_mutex_unlock(&shm_lock);
+}
+
+/*
+ * Drop connections of the parent in a forked child. The child
+ * never uses them (a forked RPC server connects to the TA anew),
+ * and its descriptor numbers are reused for unrelated files once
+ * the inherited socket is closed. Right after fork() descriptors
+ * of the connections are still the inherited ones, so they may be
+ * closed safely.
+ */
+static void
+shm_atfork_child(void)
+{
+    int i;
+
+    for (i = 0; i < shm_conns_num; i++)
+    {
+        if (shm_conns[i] != NULL)
+            shm_conn_free(shm_conns[i]);
+    }
+    free(shm_conns);
+    shm_conns = NULL;
+    shm_conns_num = 0;
+
+    pthread_mutex_unlock(&shm_lock);
+}
+
+/* Register fork handlers of shm_conns */
+static void
+shm_atfork_init(void)
+{
+    if (pthread_atfork(shm_atfork_prepare, shm_atfork_parent,
+                       shm_atfork_child) != 0)
+        ERROR("Failed to register fork handlers of RPC transport");
+}
+
+/* Bind shared memory connection state to the socket */
+static te_errno
+shm_conn_register(int sock, rpc_shm_conn *conn)
+{
+    pthread_once(&shm_atfork_once, shm_atfork_init);
+
+    pthread_mutex_lock(&shm_lock);
+    if (sock >= shm_conns_num)
+    {
+        int            num = MAX(sock + 1, shm_conns_num * 2);
+        rpc_shm_conn **conns = realloc(shm_conns, num * sizeof(*conns));
+
+        if (conns == NULL)
+        {
+            pthread_mutex_unlock(&shm_lock);
+            return TE_RC(TE_RCF_PCH, TE_ENOMEM);
+        }
+        memset(conns + shm_conns_num, 0,
+               (num - shm_conns_num) * sizeof(*conns));
+        shm_conns = conns;
+        shm_conns_num = num;
+    }
+
+    /* The socket has been closed bypassing rpc_transport_close() */
+    if (shm_conns[sock] != NULL)
+        shm_conn_free(shm_conns[sock]);
+    shm_conns[sock] = conn;
+    pthread_mutex_unlock(&shm_lock);
+
+    return 0;
+}
+
+/* Unbind shared memory connection state from the socket and free it */
+static void
+shm_conn_unregister(int sock)
+{
+    rpc_shm_conn *conn = NULL;
+
+    pthread_mutex_lock(&shm_lock);
+    if (sock >= 0 && sock < shm_conns_num)
+    {
+        conn = shm_conns[sock];
+        shm_conns[sock] = NULL;
+    }
+    pthread_mutex_unlock(&shm_lock);
+
+    if (conn != NULL)
+        shm_conn_free(conn);
+}
+
+/*
+ * Map the shared memory area and fill in connection state.
+ * Side 0 is TA, side 1 is RPC server. File descriptors
+ * are: shared memory, data and space eventfds of the TA to RPC
+ * server ring, data and space eventfds of the RPC server to TA ring.
+ */
+static te_errno
+shm_conn_init(rpc_shm_conn *conn, int side, const int *fds, size_t len)
+{
+    rpc_shm_hdr *hdr;
+    uint8_t     *data;
+
+    /* The area is passed by the peer, do not trust its size */
+    if (len < RPC_SHM_HDR_SIZE)
+        return TE_RC(TE_RCF_PCH, TE_EPROTO);
+
+    conn->mem = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fds[0], 0);
+    if (conn->mem == MAP_FAILED)
+    {
+        conn->mem = NULL;
+        return TE_OS_RC(TE_RCF_PCH, errno);
+    }
+    conn->mem_len = len;
+
+    hdr = conn->mem;
+    data = (uint8_t *)conn->mem + RPC_SHM_HDR_SIZE;
+    if (side == 0)
+    {
+        hdr->magic = RPC_SHM_MAGIC;
+        hdr->ring_size = RPC_SHM_RING_SIZE;
+    }
+    else if (hdr->magic != RPC_SHM_MAGIC || hdr->ring_size == 0 ||
+             (hdr->ring_size & (hdr->ring_size - 1)) != 0 ||
+             RPC_SHM_HDR_SIZE + 2 * (size_t)hdr->ring_size != len)
+    {
+        return TE_RC(TE_RCF_PCH, TE_EPROTO);
+    }
+    conn->size = hdr->ring_size;
+
+    conn->tx = &hdr->rings[side];
+    conn->tx_data = data + side * conn->size;
+    conn->tx_data_fd = fds[1 + side * 2];
+    conn->tx_space_fd = fds[2 + side * 2];
+
+    conn->rx = &hdr->rings[1 - side];
+    conn->rx_data = data + (1 - side) * conn->size;
+    conn->rx_data_fd = fds[1 + (1 - side) * 2];
+    conn->rx_space_fd = fds[2 + (1 - side) * 2];
+
+    return 0;
+}
+
+/* Create shared memory file */
+static int
+shm_file_create(size_t len)
+{
+    int fd;
+
+#ifdef MFD_CLOEXEC
+    fd = memfd_create("te_rpc_shm", MFD_CLOEXEC);
+#else
+    char path[PATH_MAX];
+
+    snprintf(path, sizeof(path), "%s/te_rpc_shm_XXXXXX", shm_tmp_path);
+    fd = mkstemp(path);
+    if (fd >= 0)
+        unlink(path);
+#endif
+    if (fd < 0)
+        return -1;
+
+    if (ftruncate(fd, len) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * Send a mode negotiation message.
+ *
+ * @param sock      connected socket
+ * @param mode      RPC_SHM_MODE_SHM or RPC_SHM_MODE_SOCK
+ * @param fds       descriptors to pass with the message or @c NULL
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_msg_send(int sock, char mode, const int *fds)
+{
+    char            cbuf[CMSG_SPACE(sizeof(int) * RPC_SHM_FDS_NUM)];
+    struct iovec    iov = { &mode, sizeof(mode) };
+    struct msghdr   msg;
+    struct cmsghdr *cmsg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (fds != NULL)
+    {
+        msg.msg_control = cbuf;
+        msg.msg_controllen = sizeof(cbuf);
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * RPC_SHM_FDS_NUM);
+        memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * RPC_SHM_FDS_NUM);
+    }
+
+    if (sendmsg(sock, &msg, 0) != sizeof(mode))
+        return TE_OS_RC(TE_RCF_PCH, errno);
+
+    return 0;
+}
+
+/**
+ * Receive a mode negotiation message.
+ *
+ * @param sock      connected socket
+ * @param mode      location for the mode
+ * @param fds       location for passed descriptors or @c NULL if
+ *                  they are not expected; it is filled with @c -1 if
+ *                  no descriptors are passed
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_msg_recv(int sock, char *mode, int *fds)
+{
+    char            cbuf[CMSG_SPACE(sizeof(int) * RPC_SHM_FDS_NUM)];
+    struct iovec    iov = { mode, sizeof(*mode) };
+    struct msghdr   msg;
+    struct cmsghdr *cmsg;
+    struct pollfd   pfd = { .fd = sock, .events = POLLIN };
+    int             rfds[RPC_SHM_FDS_NUM];
+    te_bool         passed = FALSE;
+    int             i;
+
+    while ((i = poll(&pfd, 1, RPC_TIMEOUT)) <= 0)
+    {
+        if (i == 0)
+            return TE_RC(TE_RCF_PCH, TE_ETIMEDOUT);
+        if (errno != EINTR)
+            return TE_OS_RC(TE_RCF_PCH, errno);
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+
+    if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) != sizeof(*mode))
+        return TE_RC(TE_RCF_PCH, TE_ECONNRESET);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg != NULL)
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET ||
+            cmsg->cmsg_type != SCM_RIGHTS ||
+            cmsg->cmsg_len != CMSG_LEN(sizeof(rfds)))
+            return TE_RC(TE_RCF_PCH, TE_EPROTO);
+
+        memcpy(rfds, CMSG_DATA(cmsg), sizeof(rfds));
+        passed = TRUE;
+    }
+
+    if ((*mode != RPC_SHM_MODE_SHM && *mode != RPC_SHM_MODE_SOCK) ||
+        (passed && fds == NULL))
+    {
+        for (i = 0; passed && i < RPC_SHM_FDS_NUM; i++)
+            close(rfds[i]);
+        return TE_RC(TE_RCF_PCH, TE_EPROTO);
+    }
+
+    if (fds != NULL)
+    {
+        for (i = 0; i < RPC_SHM_FDS_NUM; i++)
+            fds[i] = passed ? rfds[i] : -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Offer shared memory rings for the accepted connection to the RPC
+ * server. If the rings cannot be created or the RPC server does not
+ * acknowledge them, the socket is used.
+ *
+ * @param sock      connected socket
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_conn_create(int sock)
+{
+    size_t          len = RPC_SHM_HDR_SIZE + 2 * RPC_SHM_RING_SIZE;
+    int             fds[RPC_SHM_FDS_NUM];
+    rpc_shm_conn   *conn;
+    char            ack;
+    te_errno        rc;
+    int             i;
+
+    conn = calloc(1, sizeof(*conn));
+    if (conn == NULL)
+    {
+        WARN("Failed to allocate shared memory RPC transport, "
+             "the socket is used");
+        return shm_msg_send(sock, RPC_SHM_MODE_SOCK, NULL);
+    }
+
+    for (i = 0; i < RPC_SHM_FDS_NUM; i++)
+        fds[i] = -1;
+
+    fds[0] = shm_file_create(len);
+    for (i = 1; i < RPC_SHM_FDS_NUM; i++)
+        fds[i] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    for (i = 0; i < RPC_SHM_FDS_NUM; i++)
+    {
+        if (fds[i] < 0)
+        {
+            rc = TE_OS_RC(TE_RCF_PCH, errno);
+            WARN("Failed to create shared memory RPC transport, "
+                 "the socket is used: %r", rc);
+            goto fallback;
+        }
+    }
+
+    rc = shm_conn_init(conn, 0, fds, len);
+    if (rc != 0)
+    {
+        WARN("Failed to map shared memory RPC transport, "
+             "the socket is used: %r", rc);
+        goto fallback;
+    }
+
+    rc = shm_msg_send(sock, RPC_SHM_MODE_SHM, fds);
+    close(fds[0]);
+    fds[0] = -1;
+    if (rc != 0)
+    {
+        ERROR("Failed to pass shared memory to RPC server: %r", rc);
+        shm_conn_free(conn);
+        return rc;
+    }
+
+    rc = shm_msg_recv(sock, &ack, NULL);
+    if (rc != 0)
+    {
+        ERROR("Failed to get shared memory acknowledgement from "
+              "RPC server: %r", rc);
+        shm_conn_free(conn);
+        return rc;
+    }
+
+    if (ack != RPC_SHM_MODE_SHM)
+    {
+        WARN("RPC server rejected shared memory, the socket is used");
+        shm_conn_free(conn);
+        return 0;
+    }
+
+    rc = shm_conn_register(sock, conn);
+    if (rc != 0)
+        shm_conn_free(conn);
+
+    return rc;
+
+fallback:
+    for (i = 0; i < RPC_SHM_FDS_NUM; i++)
+    {
+        if (fds[i] >= 0)
+            close(fds[i]);
+    }
+    if (conn->mem != NULL)
+        munmap(conn->mem, conn->mem_len);
+    free(conn);
+
+    return shm_msg_send(sock, RPC_SHM_MODE_SOCK, NULL);
+}
+
+/**
+ * Agree with the RPC server on the mode of the accepted connection.
+ * Shared memory rings are offered only if the RPC server requests
+ * them. It should be called only if the rings are enabled on the TA:
+ * otherwise the RPC server does not take part in negotiation.
+ *
+ * @param sock      connected socket
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_conn_negotiate(int sock)
+{
+    char     req;
+    te_errno rc;
+
+    rc = shm_msg_recv(sock, &req, NULL);
+    if (rc != 0)
+    {
+        ERROR("Failed to get connection mode request from RPC server: %r",
+              rc);
+        return rc;
+    }
+
+    if (req != RPC_SHM_MODE_SHM)
+        return 0;
+
+    return shm_conn_create(sock);
+}
+
+/**
+ * Request shared memory rings from the TA and acknowledge them.
+ * If the TA does not offer the rings or they cannot be mapped,
+ * the socket is used. It should be called only if the rings are
+ * enabled on the RPC server: otherwise the TA does not take part
+ * in negotiation.
+ *
+ * @param sock      connected socket
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_conn_accept(int sock)
+{
+    int             fds[RPC_SHM_FDS_NUM];
+    struct stat     st;
+    rpc_shm_conn   *conn;
+    char            offer;
+    te_errno        rc;
+    int             i;
+
+    rc = shm_msg_send(sock, RPC_SHM_MODE_SHM, NULL);
+    if (rc != 0)
+        return rc;
+
+    rc = shm_msg_recv(sock, &offer, fds);
+    if (rc != 0)
+        return rc;
+
+    if (offer != RPC_SHM_MODE_SHM)
+        return 0;
+
+    if (fds[0] < 0)
+        return TE_RC(TE_RCF_PCH, TE_EPROTO);
+
+    conn = calloc(1, sizeof(*conn));
+    if (conn == NULL)
+    {
+        rc = TE_RC(TE_RCF_PCH, TE_ENOMEM);
+        goto fallback;
+    }
+
+    if (fstat(fds[0], &st) != 0)
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        goto fallback;
+    }
+
+    rc = shm_conn_init(conn, 1, fds, st.st_size);
+    if (rc != 0)
+        goto fallback;
+
+    close(fds[0]);
+    rc = shm_conn_register(sock, conn);
+    if (rc != 0)
+    {
+        shm_conn_free(conn);
+        return shm_msg_send(sock, RPC_SHM_MODE_SOCK, NULL);
+    }
+
+    rc = shm_msg_send(sock, RPC_SHM_MODE_SHM, NULL);
+    if (rc != 0)
+        shm_conn_unregister(sock);
+
+    return rc;
+
+fallback:
+    WARN("Failed to map shared memory from TA, the socket is used: %r", rc);
+    for (i = 0; i < RPC_SHM_FDS_NUM; i++)
+        close(fds[i]);
+    if (conn != NULL && conn->mem != NULL)
+        munmap(conn->mem, conn->mem_len);
+    free(conn);
+
+    return shm_msg_send(sock, RPC_SHM_MODE_SOCK, NULL);
+}
+
+/* Wake up the peer if it sleeps waiting for the condition */
+static inline void
+shm_notify(uint32_t *waiters, int fd)
+{
+    uint64_t one = 1;
+
+    /* Pairs with the fence in shm_wait_start() */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiters, __ATOMIC_RELAXED) != 0)
+    {
+        if (write(fd, &one, sizeof(one)) < 0)
+            ERROR("Failed to wake up RPC transport peer: errno %d", errno);
+    }
+}
+
+/* Tell the peer that it should wake us up when the condition changes */
+static inline void
+shm_wait_start(uint32_t *waiters)
+{
+    __atomic_fetch_add(waiters, 1, __ATOMIC_RELAXED);
+    /* Pairs with the fence in shm_notify() */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/*
+ * Stop waiting for the condition. Other threads may sleep on the same
+ * eventfd, and the wake up which we have consumed may be addressed to
+ * them, so pass it on.
+ */
+static inline void
+shm_wait_stop(uint32_t *waiters, int fd)
+{
+    uint64_t one = 1;
+
+    if (__atomic_sub_fetch(waiters, 1, __ATOMIC_RELAXED) != 0)
+    {
+        if (write(fd, &one, sizeof(one)) < 0)
+            ERROR("Failed to wake up RPC transport waiter: errno %d", errno);
+    }
+}
+
+/* Check whether there are data in the ring to receive from */
+static te_bool
+shm_rx_ready(rpc_shm_conn *conn)
+{
+    return __atomic_load_n(&conn->rx->tail, __ATOMIC_ACQUIRE) !=
+           conn->rx->head;
+}
+
+/* Check whether the whole length prefix of a message is in the ring */
+static te_bool
+shm_rx_prefix_ready(rpc_shm_conn *conn)
+{
+    return __atomic_load_n(&conn->rx->tail, __ATOMIC_ACQUIRE) -
+           conn->rx->head >= sizeof(uint32_t);
+}
+
+/* Check whether there is free space in the ring to send to */
+static te_bool
+shm_tx_ready(rpc_shm_conn *conn)
+{
+    return conn->tx->tail -
+           __atomic_load_n(&conn->tx->head, __ATOMIC_ACQUIRE) < conn->size;
+}
+
+/**
+ * Wait until the condition is satisfied. The ring is polled for
+ * a while, then the process sleeps on the eventfd. The socket is
+ * polled as well to detect the peer death.
+ *
+ * @param conn          connection
+ * @param sock          connection socket
+ * @param ready         condition
+ * @param waiters       counter in the shared memory telling the peer
+ *                      that it should wake us up
+ * @param fd            eventfd to sleep on
+ * @param timeout       timeout in milliseconds or @c -1
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_wait(rpc_shm_conn *conn, int sock,
+         te_bool (*ready)(rpc_shm_conn *), uint32_t *waiters,
+         int fd, int timeout)
+{
+    struct pollfd   fds[2];
+    struct timespec now;
+    struct timespec deadline;
+    uint64_t        cnt;
+    te_errno        rc = 0;
+    int             i;
+
+    for (i = 0; i < RPC_SHM_SPIN && timeout != 0; i++)
+    {
+        if (ready(conn))
+            return 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (timeout % 1000) * 1000000L;
+
+    shm_wait_start(waiters);
+
+    while (!ready(conn))
+    {
+        int wait_ms = timeout;
+
+        if (timeout > 0)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            wait_ms = (deadline.tv_sec - now.tv_sec) * 1000 +
+                      (deadline.tv_nsec - now.tv_nsec) / 1000000;
+            if (wait_ms < 0)
+                wait_ms = 0;
+        }
+
+        fds[0].fd = fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = sock;
+        fds[1].events = POLLIN;
+
+        i = poll(fds, 2, wait_ms);
+        if (i == 0)
+        {
+            rc = TE_RC(TE_RCF_PCH, TE_ETIMEDOUT);
+            break;
+        }
+        else if (i < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            rc = TE_OS_RC(TE_RCF_PCH, errno);
+            break;
+        }
+
+        /* Nothing is sent via the socket, so the peer is gone */
+        if (fds[1].revents != 0 && !ready(conn))
+        {
+            rc = TE_RC(TE_RCF_PCH, TE_ECONNRESET);
+            break;
+        }
+
+        if (fds[0].revents & POLLIN)
+            (void)read(fd, &cnt, sizeof(cnt));
+    }
+
+    shm_wait_stop(waiters, fd);
+
+    return rc;
+}
+
+/**
+ * Receive exact number of bytes from the ring.
+ *
+ * @param conn          connection
+ * @param sock          connection socket
+ * @param buf           buffer for data
+ * @param len           number of bytes to receive
+ * @param timeout       timeout in seconds
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_recv(rpc_shm_conn *conn, int sock, uint8_t *buf, size_t len,
+         int timeout)
+{
+    rpc_shm_ring *ring = conn->rx;
+    uint32_t      head = ring->head;
+    uint32_t      avail;
+    uint32_t      off;
+    size_t        n;
+    size_t        first;
+    te_errno      rc;
+
+    while (len > 0)
+    {
+        avail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head;
+        if (avail == 0)
+        {
+            rc = shm_wait(conn, sock, shm_rx_ready, &ring->data_waiters,
+                          conn->rx_data_fd, timeout * 1000);
+            if (rc != 0)
+                return rc;
+            continue;
+        }
+
+        n = MIN(avail, len);
+        off = head & (conn->size - 1);
+        first = MIN(n, conn->size - off);
+        memcpy(buf, conn->rx_data + off, first);
+        memcpy(buf + first, conn->rx_data, n - first);
+
+        head += n;
+        buf += n;
+        len -= n;
+
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+        shm_notify(&ring->space_waiters, conn->rx_space_fd);
+    }
+
+    return 0;
+}
+
+/**
+ * Send data to the ring. The peer is notified when all data are
+ * put to the ring or when the ring is full.
+ *
+ * @param conn          connection
+ * @param sock          connection socket
+ * @param buf           data
+ * @param len           number of bytes to send
+ * @param last          notify the peer after sending the data
+ *
+ * @return Status code.
+ */
+static te_errno
+shm_send(rpc_shm_conn *conn, int sock, const uint8_t *buf, size_t len,
+         te_bool last)
+{
+    rpc_shm_ring *ring = conn->tx;
+    uint32_t      tail = ring->tail;
+    uint32_t      space;
+    uint32_t      off;
+    size_t        n;
+    size_t        first;
+    te_errno      rc;
+
+    while (len > 0)
+    {
+        space = conn->size -
+                (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE));
+        if (space == 0)
+        {
+            shm_notify(&ring->data_waiters, conn->tx_data_fd);
+            rc = shm_wait(conn, sock, shm_tx_ready, &ring->space_waiters,
+                          conn->tx_space_fd, -1);
+            if (rc != 0)
+                return rc;
+            continue;
+        }
+
+        n = MIN(space, len);
+        off = tail & (conn->size - 1);
+        first = MIN(n, conn->size - off);
+        memcpy(conn->tx_data + off, buf, first);
+        memcpy(conn->tx_data, buf + first, n - first);
+
+        tail += n;
+        buf += n;
+        len -= n;
+
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+
+    if (last)
+        shm_notify(&ring->data_waiters, conn->tx_data_fd);
+
+    return 0;
+}
+
+#endif /* RPC_TRANSPORT_SHM */
+
 /**
  * Initialize RPC transport.
  */
@@ -154,6 +1053,17 @@ rpc_transport_init(const char *tmp_path)
         return rc;                                 \
     } while (0)
 
+    /*
+     * The transport may be initialized again in a child process
+     * (e.g. a sub-agent), the listening socket of the parent is
+     * not used there.
+     */
+    if (lsock >= 0)
+    {
+        close(lsock);
+        lsock = -1;
+    }
+
 #ifdef ENABLE_TCP_TRANSPORT
     if ((lsock = socket(AF_INET, SOCK_STREAM, 0)) < 0)
         RETERR("Failed to open listening socket for RPC servers");
@@ -214,6 +1124,10 @@ rpc_transport_init(const char *tmp_path)
     if (setenv("TE_RPC_PORT", port, 1) < 0)
         RETERR("Failed to set TE_RPC_PORT environment variable");
 
+#ifdef RPC_TRANSPORT_SHM
+    shm_tmp_path = tmp_path;
+#endif
+
     return 0;
 
 #undef RETERR
@@ -288,6 +1202,19 @@ rpc_transport_connect_rpcserver(const char *name,
     (void)fcntl(sock, F_SETFD, FD_CLOEXEC);
 #endif
 
+#ifdef RPC_TRANSPORT_SHM
+    if (shm_enabled())
+    {
+        te_errno rc = shm_conn_negotiate(sock);
+
+        if (rc != 0)
+        {
+            close(sock);
+            return rc;
+        }
+    }
+#endif
+
     *p_handle = (rpc_transport_handle)sock;
 
     return 0;
@@ -386,6 +1313,20 @@ rpc_transport_connect_ta(const char *name, rpc_transport_handle *p_handle)
 
     fcntl(s, F_SETFD, FD_CLOEXEC);
 
+#ifdef RPC_TRANSPORT_SHM
+    if (shm_enabled())
+    {
+        te_errno rc = shm_conn_accept(s);
+
+        if (rc != 0)
+        {
+            ERROR("Failed to agree on connection mode with TA: %r", rc);
+            close(s);
+            return rc;
+        }
+    }
+#endif
+
     *p_handle = (rpc_transport_handle)s;
 
     return 0;
@@ -399,6 +1340,9 @@ rpc_transport_connect_ta(const char *name, rpc_transport_handle *p_handle)
 void
 rpc_transport_close(rpc_transport_handle handle)
 {
+#ifdef RPC_TRANSPORT_SHM
+    shm_conn_unregister((int)handle);
+#endif
     if ((int)handle > 0 && close((int)handle) < 0)
         ERROR("close() for RPC transport socket failed with errno", errno);
 }
@@ -409,7 +1353,41 @@ rpc_transport_close(rpc_transport_handle handle)
 void
 rpc_transport_read_set_init()
 {
-    FD_ZERO(&rset);
+    rset_num = 0;
+}
+
+/* Add a descriptor to the read set */
+static void
+read_set_add_fd(rpc_transport_handle handle, int fd)
+{
+    if (rset_num == rset_max)
+    {
+        unsigned int          max = MAX(rset_max * 2, 16);
+        struct pollfd        *fds = realloc(rset, max * sizeof(*fds));
+        rpc_transport_handle *handles;
+
+        if (fds == NULL)
+        {
+            ERROR("Failed to extend RPC transport read set");
+            return;
+        }
+        rset = fds;
+
+        handles = realloc(rset_handles, max * sizeof(*handles));
+        if (handles == NULL)
+        {
+            ERROR("Failed to extend RPC transport read set");
+            return;
+        }
+        rset_handles = handles;
+        rset_max = max;
+    }
+
+    rset[rset_num].fd = fd;
+    rset[rset_num].events = POLLIN;
+    rset[rset_num].revents = 0;
+    rset_handles[rset_num] = handle;
+    rset_num++;
 }
 
 /**
@@ -420,7 +1398,14 @@ rpc_transport_read_set_init()
 void
 rpc_transport_read_set_add(rpc_transport_handle handle)
 {
-    FD_SET((int)handle, &rset);
+#ifdef RPC_TRANSPORT_SHM
+    rpc_shm_conn *conn = shm_conn_get((int)handle);
+
+    if (conn != NULL)
+        read_set_add_fd(handle, conn->rx_data_fd);
+#endif
+
+    read_set_add_fd(handle, (int)handle);
 }
 
 /**
@@ -433,12 +1418,42 @@ rpc_transport_read_set_add(rpc_transport_handle handle)
 te_bool
 rpc_transport_read_set_wait(int timeout)
 {
-    struct timeval tv;
+    int          rc;
+    int          wait_ms = timeout * 1000;
+#ifdef RPC_TRANSPORT_SHM
+    rpc_shm_conn *conn;
+    unsigned int  i;
+    uint64_t      cnt;
+
+    /* Ask peers with shared memory rings to wake us up */
+    for (i = 0; i < rset_num; i++)
+    {
+        if (rset[i].fd == (int)rset_handles[i] ||
+            (conn = shm_conn_get((int)rset_handles[i])) == NULL)
+            continue;
 
-    tv.tv_sec = timeout;
-    tv.tv_usec = 0;
+        shm_wait_start(&conn->rx->data_waiters);
+        if (shm_rx_ready(conn))
+            wait_ms = 0;
+    }
+#endif
+
+    rc = poll(rset, rset_num, wait_ms);
+
+#ifdef RPC_TRANSPORT_SHM
+    for (i = 0; i < rset_num; i++)
+    {
+        if (rset[i].fd == (int)rset_handles[i] ||
+            (conn = shm_conn_get((int)rset_handles[i])) == NULL)
+            continue;
+
+        if (rset[i].revents & POLLIN)
+            (void)read(rset[i].fd, &cnt, sizeof(cnt));
+        shm_wait_stop(&conn->rx->data_waiters, rset[i].fd);
+    }
+#endif
 
-    if (select(FD_SETSIZE, &rset, NULL, NULL, &tv) < 0)
+    if (rc < 0)
     {
         if (errno != EINTR)
             return FALSE;
@@ -457,7 +1472,21 @@ rpc_transport_read_set_wait(int timeout)
 te_bool
 rpc_transport_is_readable(rpc_transport_handle handle)
 {
-    return FD_ISSET((int)handle, &rset);
+    unsigned int i;
+#ifdef RPC_TRANSPORT_SHM
+    rpc_shm_conn *conn = shm_conn_get((int)handle);
+
+    if (conn != NULL && shm_rx_ready(conn))
+        return TRUE;
+#endif
+
+    for (i = 0; i < rset_num; i++)
+    {
+        if (rset_handles[i] == handle && rset[i].revents != 0)
+            return TRUE;
+    }
+
+    return FALSE;
 }
 
 /** Receive exact number of bytes from the stream */
@@ -520,7 +1549,27 @@ rpc_transport_recv(rpc_transport_handle handle, uint8_t *buf,
     uint8_t  lenbuf[4];
     size_t   len;
     te_errno rc;
+#ifdef RPC_TRANSPORT_SHM
+    rpc_shm_conn *conn = shm_conn_get((int)handle);
 
+    if (conn != NULL)
+    {
+        /*
+         * Do not consume a part of the length prefix if the rest
+         * does not arrive in time, it would be lost.
+         */
+        if (!shm_rx_prefix_ready(conn) &&
+            (rc = shm_wait(conn, (int)handle, shm_rx_prefix_ready,
+                           &conn->rx->data_waiters, conn->rx_data_fd,
+                           timeout * 1000)) != 0)
+            return rc;
+
+        if ((rc = shm_recv(conn, (int)handle, lenbuf,
+                           sizeof(lenbuf), timeout)) != 0)
+            return rc;
+    }
+    else
+#endif
     if ((rc = recv_from_stream((int)handle, lenbuf,
                                sizeof(lenbuf), timeout)) != 0)
     {
@@ -536,7 +1585,13 @@ rpc_transport_recv(rpc_transport_handle handle, uint8_t *buf,
     if (timeout == 0)
         timeout = RPC_TIMEOUT / 1000;
 
-    if ((rc = recv_from_stream((int)handle, buf, len, timeout)) != 0)
+#ifdef RPC_TRANSPORT_SHM
+    if (conn != NULL)
+        rc = shm_recv(conn, (int)handle, buf, len, timeout);
+    else
+#endif
+    rc = recv_from_stream((int)handle, buf, len, timeout);
+    if (rc != 0)
         return TE_RC(TE_RCF_PCH, TE_ECONNRESET);
 
     *p_len = len;
@@ -565,6 +1620,23 @@ rpc_transport_send(rpc_transport_handle handle, const uint8_t *buf,
     lenbuf[2] = (uint8_t)((len >> 8) & 0xFF);
     lenbuf[3] = (uint8_t)(len & 0xFF);
 
+#ifdef RPC_TRANSPORT_SHM
+    {
+        rpc_shm_conn *conn = shm_conn_get((int)handle);
+
+        if (conn != NULL)
+        {
+            if (shm_send(conn, (int)handle, lenbuf, sizeof(lenbuf),
+                         FALSE) != 0 ||
+                shm_send(conn, (int)handle, buf, len, TRUE) != 0)
+            {
+                return TE_RC(TE_RCF_PCH, TE_ECONNRESET);
+            }
+            return 0;
+        }
+    }
+#endif
+
     if (send((int)handle, lenbuf, sizeof(lenbuf), 0) != sizeof(lenbuf) ||
         send((int)handle, buf, len, 0) != (int)len)
     {
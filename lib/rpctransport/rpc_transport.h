@@ -13,6 +13,19 @@
 
 typedef int rpc_transport_handle;
 
+/**
+ * Name of the environment variable which should be set to @c 1 on
+ * Test Agent to pass RPC data via shared memory rings instead of
+ * the local socket (the socket is still used to establish connection
+ * and to detect the peer death). If it is set, the Test Agent and
+ * the RPC server agree on using the rings when the connection is
+ * established, nothing is exchanged otherwise. So it must be set for
+ * both of them: set it on the Test Agent before RPC servers are
+ * created and restart them after changing it. It is ignored if local
+ * transport is not used or the platform is not Linux.
+ */
+#define RPC_TRANSPORT_SHM_ENV "TE_RPC_SHM"
+
 /**
  * Initialize RPC transport.
  *
@@ -4482,12 +4482,17 @@ struct tarpc_echoer_out {
  * @param coef1,
  *        coef2,
  *        coef3     Arguments for a pattern generator function.
+ * @param pos       Position of the next element in the generated
+ *                  sequence. It is used in generator functions which
+ *                  embed the position into generated data to let
+ *                  receiver resynchronise after lost or reordered data.
  */
 struct tarpc_pat_gen_arg {
     uint32_t    offset;
     uint32_t    coef1;
     uint32_t    coef2;
     uint32_t    coef3;
+    uint64_t    pos;
 };
 
 typedef struct tarpc_pat_gen_arg tarpc_pat_gen_arg;
@@ -4581,7 +4586,26 @@ struct tarpc_pattern_receiver_in {
                                      arguments */
 };
 
-typedef struct tarpc_pattern_sender_out tarpc_pattern_receiver_out;
+struct tarpc_pattern_receiver_out {
+    struct tarpc_out_arg common;
+
+    tarpc_int   retval;         /**< 0 (success), -1 (failure) or
+                                     -2 (data do not match the pattern) */
+
+    uint64_t    bytes;          /**< Number of received bytes */
+    tarpc_bool  func_failed;    /**< TRUE if it was data receiving
+                                     function who failed */
+
+    tarpc_pat_gen_arg gen_arg;  /**< Pattern generator function
+                                     arguments */
+
+    uint64_t    lost;           /**< Number of lost bytes (only for
+                                     patterns with embedded position;
+                                     counted in 4-byte elements) */
+    uint64_t    duplicated;     /**< Number of duplicated messages */
+    uint64_t    reordered;      /**< Number of messages received after
+                                     messages following them */
+};
 
 struct tarpc_create_process_in {
     struct tarpc_in_arg common;
@@ -35,6 +35,9 @@
 #if HAVE_SIGNAL_H
 #include <signal.h>
 #endif
+#if HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
 
 /* The maximum size of log user entry (in bytes) for filter logging. */
 #define MAX_LOG_USER_SIZE 128
@@ -56,6 +59,17 @@
 #define MAX_MESSAGE_DATA_SIZE 8192
 
 #define CTRL_PIPE_INITIALIZER {-1, -1}
+
+/** Mount point of cgroup v2 hierarchy */
+#define CGROUP2_ROOT "/sys/fs/cgroup"
+/** Mount point of cgroup v2 hierarchy in hybrid mode */
+#define CGROUP2_ROOT_HYBRID CGROUP2_ROOT "/unified"
+/** Maximum number of passes to kill processes of a cgroup one by one */
+#define CGROUP_KILL_PASSES 16
+/** Time to wait for a cgroup to become empty before its removal */
+#define CGROUP_RMDIR_TIMEOUT_MS 1000
+/** Name of the leaf cgroup to which processes of the agent cgroup move */
+#define CGROUP_AGENT_LEAF "ta_agent"
 #define CTRL_MESSAGE ("c\n")
 
 /**
@@ -182,6 +196,11 @@ typedef struct ta_job_t {
     LIST_HEAD(wrapper_list, wrapper_t) wrappers;
 
     te_exec_param *exec_params;
+
+    /* Parent of the dedicated cgroup, @c NULL if the job has no cgroup */
+    char *cgroup_parent;
+    /* Dedicated cgroup directory, created on the first start */
+    char *cgroup;
 } ta_job_t;
 
 struct ta_job_manager_t {
@@ -875,6 +894,8 @@ ta_job_dealloc(ta_job_t *job)
 
     free(job->spawner);
     free(job->tool);
+    free(job->cgroup_parent);
+    free(job->cgroup);
     if (job->exec_params != NULL)
     {
         te_exec_param *item;
@@ -912,6 +933,306 @@ ta_job_create(ta_job_manager_t *manager, const char *spawner, const char *tool,
     return 0;
 }
 
+/*
+ * Get path to a cgroup directory by a parent specified by user,
+ * empty parent means the cgroup of the agent. The cgroup of the agent
+ * is remembered on the first call since the agent moves to its leaf
+ * child later (see cgroup_agent_move_to_leaf()).
+ */
+static te_errno
+cgroup_resolve_parent(const char *parent, te_string *path)
+{
+    static te_string agent_cgroup = TE_STRING_INIT;
+    te_string cgroups = TE_STRING_INIT;
+    const char *line;
+    te_errno rc;
+
+    if (*parent != '\0')
+    {
+        te_string_append(path, "%s", parent);
+        return 0;
+    }
+
+    if (agent_cgroup.len != 0)
+    {
+        te_string_append(path, "%s", agent_cgroup.ptr);
+        return 0;
+    }
+
+    rc = te_file_read_string(&cgroups, FALSE, 0, "/proc/self/cgroup");
+    if (rc != 0)
+    {
+        ERROR("Failed to read cgroups of the agent: %r", rc);
+        return rc;
+    }
+
+    /* cgroup v2 hierarchy has ID 0 and no controllers in the list */
+    for (line = cgroups.ptr; line != NULL; line = strchr(line, '\n'))
+    {
+        if (*line == '\n')
+            line++;
+        if (strncmp(line, "0::", 3) == 0)
+            break;
+    }
+
+    if (line == NULL)
+    {
+        ERROR("The agent is not in cgroup v2 hierarchy");
+        te_string_free(&cgroups);
+        return TE_ENOENT;
+    }
+
+    line += 3;
+    te_string_append(path, "%s%.*s",
+                     te_access_fmt(F_OK, "%s/cgroup.controllers",
+                                   CGROUP2_ROOT) == 0 ?
+                     CGROUP2_ROOT : CGROUP2_ROOT_HYBRID,
+                     (int)strcspn(line, "\n"), line);
+    te_string_free(&cgroups);
+
+    te_string_append(&agent_cgroup, "%s", path->ptr);
+
+    return 0;
+}
+
+/*
+ * Write a value to a cgroup interface file. Errors are not logged
+ * since some files are optional.
+ */
+static te_errno
+cgroup_write(const char *cgroup, const char *file, const char *value)
+{
+    te_string path = TE_STRING_INIT;
+    te_errno rc = 0;
+    int fd;
+
+    te_string_append(&path, "%s/%s", cgroup, file);
+    fd = open(path.ptr, O_WRONLY);
+    te_string_free(&path);
+    if (fd < 0)
+        return te_rc_os2te(errno);
+
+    if (write(fd, value, strlen(value)) < 0)
+        rc = te_rc_os2te(errno);
+    close(fd);
+
+    return rc;
+}
+
+/*
+ * Read a cgroup interface file. @c TE_ENOENT is returned silently
+ * if the file does not exist, e.g. the controller is not enabled.
+ */
+static te_errno
+cgroup_read(const char *cgroup, const char *file, te_string *buf)
+{
+    if (te_access_fmt(R_OK, "%s/%s", cgroup, file) != 0)
+        return TE_ENOENT;
+
+    return te_file_read_string(buf, FALSE, 0, "%s/%s", cgroup, file);
+}
+
+/*
+ * Move processes of the agent cgroup (the agent and processes started
+ * by it) to a leaf child cgroup. A non-root cgroup having processes
+ * cannot enable controllers for its children, so it is done before
+ * enabling memory and IO controllers for dedicated cgroups of jobs
+ * which are created as siblings of the leaf. Processes are moved only
+ * once, if it fails, only CPU usage of jobs is available.
+ */
+static void
+cgroup_agent_move_to_leaf(const char *cgroup)
+{
+    static te_bool done = FALSE;
+    te_string leaf = TE_STRING_INIT;
+    te_string procs = TE_STRING_INIT;
+    char *line;
+    char *saveptr = NULL;
+    te_errno rc;
+
+    if (done)
+        return;
+    done = TRUE;
+
+    /* The root cgroup may have both processes and enabled controllers */
+    if (strcmp(cgroup, CGROUP2_ROOT "/") == 0 ||
+        strcmp(cgroup, CGROUP2_ROOT_HYBRID "/") == 0)
+        return;
+
+    te_string_append(&leaf, "%s/%s", cgroup, CGROUP_AGENT_LEAF);
+    if (mkdir(leaf.ptr, 0755) != 0 && errno != EEXIST)
+    {
+        VERB("Failed to create cgroup '%s': %s", leaf.ptr, strerror(errno));
+        te_string_free(&leaf);
+        return;
+    }
+
+    rc = cgroup_read(cgroup, "cgroup.procs", &procs);
+    if (rc != 0)
+    {
+        VERB("Failed to get processes of cgroup '%s': %r", cgroup, rc);
+        te_string_free(&leaf);
+        return;
+    }
+
+    if (procs.ptr != NULL)
+    {
+        for (line = strtok_r(procs.ptr, "\n", &saveptr); line != NULL;
+             line = strtok_r(NULL, "\n", &saveptr))
+        {
+            /* Processes may exit in the meantime */
+            rc = cgroup_write(leaf.ptr, "cgroup.procs", line);
+            if (rc != 0 && TE_RC_GET_ERROR(rc) != TE_ESRCH)
+            {
+                VERB("Failed to move process %s to cgroup '%s': %r",
+                     line, leaf.ptr, rc);
+            }
+        }
+    }
+
+    te_string_free(&procs);
+    te_string_free(&leaf);
+}
+
+/* Create the dedicated cgroup of a job if it does not exist yet */
+static te_errno
+job_cgroup_create(ta_job_t *job)
+{
+    static const char *controllers[] = { "+cpu", "+memory", "+io" };
+    te_string path = TE_STRING_INIT;
+    unsigned int i;
+    te_errno rc;
+
+    if (job->cgroup_parent == NULL || job->cgroup != NULL)
+        return 0;
+
+    rc = cgroup_resolve_parent(job->cgroup_parent, &path);
+    if (rc != 0)
+    {
+        te_string_free(&path);
+        return rc;
+    }
+
+    if (*job->cgroup_parent == '\0')
+        cgroup_agent_move_to_leaf(path.ptr);
+
+    /*
+     * Try to enable controllers providing memory and IO statistics,
+     * it is not possible if the parent still has processes, so only
+     * CPU usage is available then.
+     */
+    for (i = 0; i < TE_ARRAY_LEN(controllers); i++)
+    {
+        rc = cgroup_write(path.ptr, "cgroup.subtree_control", controllers[i]);
+        if (rc != 0)
+        {
+            VERB("Failed to enable %s controller in '%s': %r",
+                 controllers[i] + 1, path.ptr, rc);
+        }
+    }
+
+    te_string_append(&path, "/ta_job_%d_%u", (int)getpid(), job->id);
+    if (mkdir(path.ptr, 0755) != 0 && errno != EEXIST)
+    {
+        rc = te_rc_os2te(errno);
+        ERROR("Failed to create cgroup '%s': %r", path.ptr, rc);
+        te_string_free(&path);
+        return rc;
+    }
+
+    te_string_move(&job->cgroup, &path);
+
+    return 0;
+}
+
+/*
+ * Send a signal to all processes of a cgroup. SIGKILL is delivered
+ * with cgroup.kill if the kernel supports it, otherwise processes
+ * are killed one by one until the cgroup is empty, since they may
+ * fork in the meantime.
+ */
+static te_errno
+cgroup_signal(const char *cgroup, int signo)
+{
+    te_string procs = TE_STRING_INIT;
+    unsigned int pass;
+    te_errno rc;
+
+    /* cgroup.kill is available since Linux 5.14 */
+    if (signo == SIGKILL && cgroup_write(cgroup, "cgroup.kill", "1") == 0)
+        return 0;
+
+    for (pass = 0; pass < CGROUP_KILL_PASSES; pass++)
+    {
+        char *line;
+        char *saveptr = NULL;
+        te_bool signalled = FALSE;
+
+        te_string_reset(&procs);
+        rc = cgroup_read(cgroup, "cgroup.procs", &procs);
+        if (rc != 0)
+        {
+            ERROR("Failed to get processes of cgroup '%s': %r", cgroup, rc);
+            break;
+        }
+
+        if (procs.ptr == NULL)
+            break;
+
+        for (line = strtok_r(procs.ptr, "\n", &saveptr); line != NULL;
+             line = strtok_r(NULL, "\n", &saveptr))
+        {
+            int pid;
+
+            if (sscanf(line, "%d", &pid) != 1)
+                continue;
+
+            if (kill(pid, signo) < 0 && errno != ESRCH)
+            {
+                rc = te_rc_os2te(errno);
+                ERROR("Process kill(%d, %s) failed: %r", pid,
+                      signum_rpc2str(signum_h2rpc(signo)), rc);
+            }
+            signalled = TRUE;
+        }
+
+        if (!signalled || signo != SIGKILL)
+            break;
+    }
+    te_string_free(&procs);
+
+    return rc;
+}
+
+/* Kill all processes of the dedicated cgroup of a job and remove it */
+static void
+job_cgroup_destroy(ta_job_t *job)
+{
+    unsigned int waited_ms = 0;
+
+    if (job->cgroup == NULL)
+        return;
+
+    (void)cgroup_signal(job->cgroup, SIGKILL);
+
+    /* The cgroup is busy until killed processes actually exit */
+    while (rmdir(job->cgroup) != 0)
+    {
+        if (errno != EBUSY || waited_ms >= CGROUP_RMDIR_TIMEOUT_MS)
+        {
+            WARN("Failed to remove cgroup '%s': %s", job->cgroup,
+                 strerror(errno));
+            break;
+        }
+
+        usleep(PROC_WAIT_US);
+        waited_ms += TE_US2MS(PROC_WAIT_US);
+    }
+
+    free(job->cgroup);
+    job->cgroup = NULL;
+}
+
 static te_errno
 proc_wait(pid_t pid, int timeout_ms, ta_job_status_t *status)
 {
@@ -1549,6 +1870,39 @@ ta_job_build_tool_and_args(char **tool, te_vec *args, ta_job_t *job)
     return TE_VEC_APPEND_RVALUE(args, char *, end_arg);
 }
 
+/*
+ * Build process parameters of a job with its cgroup appended.
+ * Items are not copied, so only the array must be freed.
+ */
+static te_errno
+ta_job_exec_params_with_cgroup(ta_job_t *job, te_exec_cgroup_param *cgroup,
+                               te_exec_param **params)
+{
+    te_exec_param *result;
+    size_t n = 0;
+
+    while (job->exec_params != NULL &&
+           job->exec_params[n].type != TE_EXEC_END)
+        n++;
+
+    result = calloc(n + 2, sizeof(*result));
+    if (result == NULL)
+        return TE_ENOMEM;
+
+    if (n > 0)
+        memcpy(result, job->exec_params, n * sizeof(*result));
+
+    cgroup->path = job->cgroup;
+    result[n].type = TE_EXEC_CGROUP;
+    result[n].data = cgroup;
+    result[n + 1].type = TE_EXEC_END;
+    result[n + 1].data = NULL;
+
+    *params = result;
+
+    return 0;
+}
+
 /* See description in ta_job.h */
 te_errno
 ta_job_start(ta_job_manager_t *manager, unsigned int id)
@@ -1568,6 +1922,8 @@ ta_job_start(ta_job_manager_t *manager, unsigned int id)
     size_t i;
     char *tool = NULL;
     te_vec args = TE_VEC_INIT(char *);
+    te_exec_param *exec_params;
+    te_exec_cgroup_param cgroup;
 
     job = get_job(manager, id);
     if (job == NULL)
@@ -1594,19 +1950,36 @@ ta_job_start(ta_job_manager_t *manager, unsigned int id)
     if (job->n_in_channels < 1)
         stdin_fd_p = TE_EXEC_CHILD_DEV_NULL_FD;
 
+    exec_params = job->exec_params;
+    if (job->cgroup_parent != NULL)
+    {
+        rc = job_cgroup_create(job);
+        if (rc == 0)
+            rc = ta_job_exec_params_with_cgroup(job, &cgroup, &exec_params);
+        if (rc != 0)
+        {
+            ERROR("Failed to prepare cgroup of the job, rc = %r", rc);
+            return rc;
+        }
+    }
+
     rc = ta_job_build_tool_and_args(&tool, &args, job);
     if (rc != 0)
     {
         ERROR("Failed to build command line, rc = %r", rc);
         te_vec_deep_free(&args);
+        if (exec_params != job->exec_params)
+            free(exec_params);
         return rc;
     }
 
     // TODO: use spawner method
     pid = te_exec_child(tool, (char **)args.data.ptr, job->env,
                         -1, stdin_fd_p, stdout_fd_p, stderr_fd_p,
-                        job->exec_params);
+                        exec_params);
     te_vec_deep_free(&args);
+    if (exec_params != job->exec_params)
+        free(exec_params);
     if (pid < 0)
     {
         ERROR("Exec child failure\n");
@@ -2508,6 +2881,10 @@ ta_job_killpg(ta_job_manager_t *manager, unsigned int job_id, int signo)
     if (job == NULL)
         return TE_EINVAL;
 
+    /* Processes which left the process group are still in the cgroup */
+    if (job->cgroup != NULL)
+        return cgroup_signal(job->cgroup, signo);
+
     if (job->pid < 0)
         return TE_ESRCH;
 
@@ -2574,6 +2951,10 @@ ta_job_stop(ta_job_manager_t *manager, unsigned int job_id, int signo,
             job->pid = -1;
     }
 
+    /* Do not leave processes started by the job behind */
+    if (rc == 0 && job->cgroup != NULL)
+        rc = cgroup_signal(job->cgroup, SIGKILL);
+
     return rc;
 }
 
@@ -2609,6 +2990,7 @@ ta_job_destroy(ta_job_manager_t *manager, unsigned int job_id,
      */
     if (job->pid != (pid_t)-1)
         proc_kill(job->pid, SIGTERM, term_timeout_ms);
+    job_cgroup_destroy(job);
 
     LIST_REMOVE(job, next);
 
@@ -2758,3 +3140,138 @@ ta_job_add_exec_param(ta_job_manager_t *manager, unsigned int job_id,
     job->exec_params = exec_params;
     return 0;
 }
+
+/* See description in ta_job.h */
+te_errno
+ta_job_set_cgroup(ta_job_manager_t *manager, unsigned int job_id,
+                  const char *parent)
+{
+    ta_job_t *job;
+    char *dup = NULL;
+
+    job = get_job(manager, job_id);
+    if (job == NULL)
+        return TE_EINVAL;
+
+    if (job->pid != (pid_t)-1)
+    {
+        ERROR("Failed to set cgroup: Job has been started.");
+        return TE_EPERM;
+    }
+
+    if (parent != NULL)
+    {
+        dup = strdup(parent);
+        if (dup == NULL)
+            return TE_ENOMEM;
+    }
+
+    job_cgroup_destroy(job);
+    free(job->cgroup_parent);
+    job->cgroup_parent = dup;
+
+    return 0;
+}
+
+/* Read a value of a key from a flat keyed cgroup file like cpu.stat */
+static void
+cgroup_read_keyed(const char *cgroup, const char *file, const char *key,
+                  uint64_t *value)
+{
+    te_string buf = TE_STRING_INIT;
+    size_t key_len = strlen(key);
+    const char *line;
+
+    if (cgroup_read(cgroup, file, &buf) != 0)
+    {
+        te_string_free(&buf);
+        return;
+    }
+
+    for (line = buf.ptr; line != NULL; line = strchr(line, '\n'))
+    {
+        if (*line == '\n')
+            line++;
+        if (strncmp(line, key, key_len) == 0 && line[key_len] == ' ')
+        {
+            sscanf(line + key_len + 1, "%" SCNu64, value);
+            break;
+        }
+    }
+
+    te_string_free(&buf);
+}
+
+/* Read a single value cgroup file like memory.current */
+static void
+cgroup_read_single(const char *cgroup, const char *file, uint64_t *value)
+{
+    te_string buf = TE_STRING_INIT;
+
+    if (cgroup_read(cgroup, file, &buf) == 0)
+        sscanf(buf.ptr, "%" SCNu64, value);
+
+    te_string_free(&buf);
+}
+
+/* Sum read and written bytes over all devices listed in io.stat */
+static void
+cgroup_read_io(const char *cgroup, uint64_t *rbytes, uint64_t *wbytes)
+{
+    te_string buf = TE_STRING_INIT;
+    const char *field;
+    uint64_t value;
+
+    if (cgroup_read(cgroup, "io.stat", &buf) != 0)
+    {
+        te_string_free(&buf);
+        return;
+    }
+
+    for (field = buf.ptr; (field = strstr(field, "bytes=")) != NULL;
+         field += strlen("bytes="))
+    {
+        if (field == buf.ptr || sscanf(field + strlen("bytes="),
+                                       "%" SCNu64, &value) != 1)
+            continue;
+
+        if (field[-1] == 'r')
+            *rbytes += value;
+        else if (field[-1] == 'w')
+            *wbytes += value;
+    }
+
+    te_string_free(&buf);
+}
+
+/* See description in ta_job.h */
+te_errno
+ta_job_get_cgroup_stats(ta_job_manager_t *manager, unsigned int job_id,
+                        ta_job_cgroup_stats_t *stats)
+{
+    ta_job_t *job;
+
+    job = get_job(manager, job_id);
+    if (job == NULL)
+        return TE_EINVAL;
+
+    if (job->cgroup_parent == NULL)
+        return TE_ENOENT;
+
+    memset(stats, 0, sizeof(*stats));
+    /* The cgroup is created on the first start of the job */
+    if (job->cgroup == NULL)
+        return 0;
+
+    cgroup_read_keyed(job->cgroup, "cpu.stat", "usage_usec",
+                      &stats->cpu_usage_us);
+    cgroup_read_keyed(job->cgroup, "cpu.stat", "user_usec",
+                      &stats->cpu_user_us);
+    cgroup_read_keyed(job->cgroup, "cpu.stat", "system_usec",
+                      &stats->cpu_system_us);
+    cgroup_read_single(job->cgroup, "memory.current", &stats->memory_current);
+    cgroup_read_single(job->cgroup, "memory.peak", &stats->memory_peak);
+    cgroup_read_io(job->cgroup, &stats->io_read_bytes, &stats->io_write_bytes);
+
+    return 0;
+}
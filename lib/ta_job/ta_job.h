@@ -48,6 +48,28 @@ typedef struct ta_job_status_t {
     int value;
 } ta_job_status_t;
 
+/**
+ * Resource usage of a job accounted in its dedicated cgroup.
+ * Statistics of controllers which are not enabled for the cgroup
+ * (e.g. memory and IO if the parent cgroup has processes) are zero.
+ */
+typedef struct ta_job_cgroup_stats_t {
+    /** Total CPU time in microseconds */
+    uint64_t cpu_usage_us;
+    /** User CPU time in microseconds */
+    uint64_t cpu_user_us;
+    /** System CPU time in microseconds */
+    uint64_t cpu_system_us;
+    /** Current memory usage in bytes */
+    uint64_t memory_current;
+    /** Peak memory usage in bytes */
+    uint64_t memory_peak;
+    /** Number of bytes read from block devices */
+    uint64_t io_read_bytes;
+    /** Number of bytes written to block devices */
+    uint64_t io_write_bytes;
+} ta_job_cgroup_stats_t;
+
 /** A structure to store messages produced by the job */
 typedef struct ta_job_buffer_t {
     /** Channel from which the message was received */
@@ -375,7 +397,9 @@ extern te_errno ta_job_kill(ta_job_manager_t *manager, unsigned int job_id,
                             int signo);
 
 /**
- * Send a signal to a job's process group
+ * Send a signal to a job's process group. If the job has a dedicated
+ * cgroup, the signal is sent to all processes in the cgroup including
+ * the ones which left the process group or whose parent exited.
  *
  * @param      manager         Job manager handle
  * @param      job_id          ID of the job to send signal to
@@ -408,7 +432,8 @@ extern te_errno ta_job_wait(ta_job_manager_t *manager, unsigned int job_id,
  * Stop a job. It can be started over with ta_job_start().
  * The function tries to terminate the job with the specified signal.
  * If the signal fails to terminate the job withing @p term_timeout_ms,
- * the function will send @c SIGKILL.
+ * the function will send @c SIGKILL. If the job has a dedicated cgroup,
+ * processes remaining in it are killed with @c SIGKILL.
  *
  * @param      manager         Job manager handle
  * @param      job_id          ID of the job to stop
@@ -495,6 +520,41 @@ extern te_errno ta_job_add_exec_param(ta_job_manager_t *manager,
                                       unsigned int job_id,
                                       te_exec_param *exec_params);
 
+/**
+ * Make a job run in a dedicated cgroup v2. The cgroup is created
+ * on the first start of the job and is removed when the job is destroyed,
+ * all processes in the cgroup are killed then.
+ *
+ * @param      manager         Job manager handle
+ * @param      job_id          ID of the job which is not running
+ * @param      parent          Path to a cgroup v2 directory in which
+ *                             the dedicated cgroup is created, empty string
+ *                             means the cgroup of the agent (processes
+ *                             of which are moved to its leaf child
+ *                             @c ta_agent then), @c NULL means that
+ *                             the job has no dedicated cgroup
+ *
+ * @return     Status code
+ */
+extern te_errno ta_job_set_cgroup(ta_job_manager_t *manager,
+                                  unsigned int job_id, const char *parent);
+
+/**
+ * Get resource usage of a job accounted in its dedicated cgroup
+ * over all runs of the job. Zeros are reported if the job has not
+ * been started yet.
+ *
+ * @param[in]  manager         Job manager handle
+ * @param[in]  job_id          ID of the job
+ * @param[out] stats           Location for the statistics
+ *
+ * @return     Status code
+ * @retval     TE_ENOENT       The job has no dedicated cgroup
+ */
+extern te_errno ta_job_get_cgroup_stats(ta_job_manager_t *manager,
+                                        unsigned int job_id,
+                                        ta_job_cgroup_stats_t *stats);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -52,6 +52,7 @@ static csap_spt_type_t eth_csap_spt =
     .prepare_recv_cb     = tad_eth_prepare_recv,
     .read_cb             = tad_eth_read_cb,
     .shutdown_recv_cb    = tad_eth_shutdown_recv,
+    .recv_drops_cb       = tad_eth_recv_drops_cb,
 
     .write_read_cb       = tad_common_write_read_cb,
 };
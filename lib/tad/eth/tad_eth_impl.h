@@ -115,6 +115,13 @@ extern te_errno tad_eth_prepare_recv(csap_p csap);
  */
 extern te_errno tad_eth_shutdown_recv(csap_p csap);
 
+/**
+ * Get number of frames dropped by receive socket of Ethernet CSAP.
+ *
+ * The function complies with csap_recv_drops_cb_t prototype.
+ */
+extern te_errno tad_eth_recv_drops_cb(csap_p csap, uint64_t *drops);
+
 
 /**
  * Callback to initialize 'eth' CSAP layer.
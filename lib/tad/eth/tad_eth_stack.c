@@ -97,6 +97,17 @@ tad_eth_shutdown_recv(csap_p csap)
     return tad_eth_sap_recv_close(&spec_data->sap);
 }
 
+/* See description tad_eth_impl.h */
+te_errno
+tad_eth_recv_drops_cb(csap_p csap, uint64_t *drops)
+{
+    tad_eth_rw_data *spec_data = csap_get_rw_data(csap);
+
+    assert(spec_data != NULL);
+
+    return tad_eth_sap_recv_drops(&spec_data->sap, drops);
+}
+
 
 /* See description tad_eth_impl.h */
 te_errno
@@ -33,6 +33,11 @@
 #include <pthread.h>
 #endif
 
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/select.h>
+
 #include "logger_api.h"
 #include "logger_ta_fast.h"
 #include "send_queue.h"
@@ -55,165 +60,307 @@ static sendq_t         *sendq_list[TADF_SENDQ_LIST_SIZE_MAX];
 /** As the sendq_list is a shared resource there should be a mutex lock */
 static pthread_mutex_t  sendq_list_lock;
 
+/** Amount of nanoseconds in one second */
+#define TADF_NS_PER_SEC 1000000000ULL
+
+/** Mask of a slot number on a timer wheel level */
+#define TADF_SENDQ_WHEEL_MASK ((uint64_t)TADF_SENDQ_WHEEL_SLOTS - 1)
+
+/** Number of ticks covered by all timer wheel levels */
+#define TADF_SENDQ_WHEEL_SPAN \
+    (1ULL << (TADF_SENDQ_WHEEL_LEVELS * TADF_SENDQ_WHEEL_BITS))
+
 /**
- * The macro determines what time is later
+ * Get the current time used for packet scheduling.
+ *
+ * @return          Nanoseconds of CLOCK_MONOTONIC.
  */
-#define MAX_TV(ts1, ts2) \
-    ((timeval_compare(ts1, ts2) == 1) ? ts1 : ts2)
+static inline uint64_t
+tadf_sendq_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * TADF_NS_PER_SEC + ts.tv_nsec;
+}
 
 /**
- * Inserts the entry to the send queue due to it's send_time
+ * Convert the packet send time (wall clock) to the deadline used for
+ * packet scheduling.
  *
- * @param queue     The queue to insert entry in.
- * @param entry     Pointer to the filled entry which should be inserter.
+ * @param send_time The time packet should be sent at.
  *
- * @return          0 - if the function ends correctly
- *                  ENOBUFS - if the buffer is full
+ * @return          Nanoseconds of CLOCK_MONOTONIC.
  */
-static inline int
-tadf_sendq_entry_insert(sendq_t *queue, sendq_entry_t *entry)
+static uint64_t
+tadf_sendq_deadline(struct timeval send_time)
 {
-    sendq_entry_t *current;
+    struct timeval  curr_time;
+    uint64_t        now = tadf_sendq_now();
+    int64_t         delay;
 
-    pthread_mutex_lock(&queue->sendq_lock);
-    current = queue->head;
+    gettimeofday(&curr_time, NULL);
+    delay = ((int64_t)send_time.tv_sec - curr_time.tv_sec) * TV_RADIX +
+            ((int64_t)send_time.tv_usec - curr_time.tv_usec);
 
-    VERB("SendQ %d (csap %d), Adding a packet: sendq size = %d, "
-         "sendq max size = %d",
-         queue->id, queue->csap->id,
-         queue->queue_size, queue->queue_size_max);
-    /* if the sendq is full then we simply exit */
-    if (queue->queue_size_max <= queue->queue_size)
-    {
-        pthread_mutex_unlock(&queue->sendq_lock);
-        return TE_RC(TE_TA_EXT, TE_ENOBUFS);
-    }
+    return delay > 0 ? now + (uint64_t)delay * 1000 : now;
+}
 
+/**
+ * Append the entry to the list.
+ *
+ * @param list      The list.
+ * @param entry     The entry to append.
+ */
+static inline void
+sendq_list_append(sendq_list_t *list, sendq_entry_t *entry)
+{
     entry->next = NULL;
-    entry->prev = NULL;
+    entry->prev = list->tail;
+    if (list->tail != NULL)
+        list->tail->next = entry;
+    else
+        list->head = entry;
+    list->tail = entry;
+}
 
-    queue->queue_size++;
+/**
+ * Insert the entry to the list sorted by deadline after all entries
+ * with the same or earlier deadline. The list is scanned from the tail
+ * since the entry usually should be sent after all others.
+ *
+ * @param list      The list.
+ * @param entry     The entry to insert.
+ */
+static void
+sendq_list_insert_sorted(sendq_list_t *list, sendq_entry_t *entry)
+{
+    sendq_entry_t *current = list->tail;
+
+    while (current != NULL && current->deadline > entry->deadline)
+        current = current->prev;
 
-    /* The sendq is empty */
     if (current == NULL)
     {
-        queue->head = entry;
-        queue->tail = entry;
-        goto finish;
+        entry->prev = NULL;
+        entry->next = list->head;
+        if (list->head != NULL)
+            list->head->prev = entry;
+        else
+            list->tail = entry;
+        list->head = entry;
+        return;
     }
 
-    if (timeval_compare(entry->send_time, current->send_time) >= 0)
+    entry->prev = current;
+    entry->next = current->next;
+    if (current->next != NULL)
+        current->next->prev = entry;
+    else
+        list->tail = entry;
+    current->next = entry;
+}
+
+/**
+ * Free all entries of the list.
+ *
+ * @param list      The list.
+ */
+static void
+sendq_list_free(sendq_list_t *list)
+{
+    sendq_entry_t *current = list->head;
+    sendq_entry_t *next;
+
+    while (current != NULL)
     {
-        entry->next = current;
-        current->prev = entry;
-        queue->head = entry;
-        goto finish;
+        next = current->next;
+        free(current->pkt);
+        free(current);
+        current = next;
     }
-    current = current->next;
+    list->head = list->tail = NULL;
+}
 
-    while ((current != NULL) &&
-           (timeval_compare(entry->send_time, current->send_time) == -1))
-        current = current->next;
+/**
+ * Put the entry to the timer wheel of the send queue or, if its send
+ * time has come, to the ready list.
+ *
+ * @param queue     The send queue.
+ * @param entry     The entry.
+ */
+static void
+sendq_wheel_add(sendq_t *queue, sendq_entry_t *entry)
+{
+    sendq_wheel_t *wheel = &queue->wheel;
+    uint64_t       tick = entry->deadline >> TADF_SENDQ_TICK_SHIFT;
+    uint64_t       diff;
+    unsigned int   level;
+    unsigned int   slot;
 
-    if (current == NULL)
+    if (tick <= wheel->now)
     {
-        entry->prev = queue->tail;
-        queue->tail->next = entry;
-        queue->tail = entry;
+        sendq_list_insert_sorted(&queue->ready, entry);
+        return;
     }
-    else
+
+    /* The level is the highest one on which the tick differs from now */
+    diff = tick ^ wheel->now;
+    for (level = 0; level < TADF_SENDQ_WHEEL_LEVELS; level++)
     {
-        (current->prev)->next = entry;
-        entry->prev = current->prev;
-        entry->next = current;
-        current->prev = entry;
+        diff >>= TADF_SENDQ_WHEEL_BITS;
+        if (diff == 0)
+            break;
     }
-/* If we are here we heve inserted the entry */
-finish:
-    pthread_mutex_unlock(&queue->sendq_lock);
-    return 0;
+
+    if (level == TADF_SENDQ_WHEEL_LEVELS)
+    {
+        sendq_list_append(&wheel->overflow, entry);
+        return;
+    }
+
+    slot = (tick >> (level * TADF_SENDQ_WHEEL_BITS)) & TADF_SENDQ_WHEEL_MASK;
+    sendq_list_append(&wheel->slots[level][slot], entry);
+    wheel->busy[level][slot / 64] |= 1ULL << (slot % 64);
 }
 
 /**
- * Removes given entry from the send queue.
+ * Re-add entries of the list to the timer wheel of the send queue,
+ * the list is emptied.
  *
- * @param queue     The send queue to remove entry from
- * @param entry     The entry to remove from the queue
+ * @param queue     The send queue.
+ * @param list      The list of entries.
+ */
+static void
+sendq_wheel_readd(sendq_t *queue, sendq_list_t *list)
+{
+    sendq_entry_t *current = list->head;
+    sendq_entry_t *next;
+
+    list->head = list->tail = NULL;
+    while (current != NULL)
+    {
+        next = current->next;
+        sendq_wheel_add(queue, current);
+        current = next;
+    }
+}
+
+/**
+ * Find the first non-empty slot after the given one on a timer wheel
+ * level.
  *
- * @return          0 - if the pointer was not NULL
- *                  TE_EWRONGPTR - otherwise
+ * @param wheel     The timer wheel.
+ * @param level     The level.
+ * @param slot      The slot to start after.
+ *
+ * @return          Slot number or @c -1 if there is no such slot.
  */
-static inline int
-tadf_sendq_entry_remove(sendq_t *queue, sendq_entry_t  *entry)
+static int
+sendq_wheel_next_busy(const sendq_wheel_t *wheel, unsigned int level,
+                      unsigned int slot)
 {
+    unsigned int i = slot + 1;
+    uint64_t     word;
 
-    pthread_mutex_lock(&queue->sendq_lock);
+    while (i < TADF_SENDQ_WHEEL_SLOTS)
+    {
+        word = wheel->busy[level][i / 64] >> (i % 64);
+        if (word != 0)
+            return i + __builtin_ctzll(word);
 
-    if ((entry == NULL) || (entry->pkt == NULL))
+        i = (i / 64 + 1) * 64;
+    }
+
+    return -1;
+}
+
+/**
+ * Get the tick at which the timer wheel should be processed next time,
+ * i.e. when some slot is expired or moved to lower levels.
+ *
+ * @param wheel     The timer wheel.
+ *
+ * @return          Tick or @c UINT64_MAX if the timer wheel is empty.
+ */
+static uint64_t
+sendq_wheel_next_event(const sendq_wheel_t *wheel)
+{
+    unsigned int level;
+    unsigned int shift;
+    int          slot;
+
+    /* All slots of a level are later than any slot of lower levels */
+    for (level = 0; level < TADF_SENDQ_WHEEL_LEVELS; level++)
     {
-        WARN("NULL entry could not be removed from the queue");
-        pthread_mutex_unlock(&queue->sendq_lock);
-        return TE_RC(TE_TA_EXT, TE_EWRONGPTR);
+        shift = level * TADF_SENDQ_WHEEL_BITS;
+        slot = sendq_wheel_next_busy(wheel, level,
+                                     (wheel->now >> shift) &
+                                     TADF_SENDQ_WHEEL_MASK);
+        if (slot >= 0)
+        {
+            return ((wheel->now >> (shift + TADF_SENDQ_WHEEL_BITS)) <<
+                    (shift + TADF_SENDQ_WHEEL_BITS)) |
+                   ((uint64_t)slot << shift);
+        }
     }
 
-    if (entry->prev != NULL)
-        (entry->prev)->next = entry->next;
-    else
-        queue->head = entry->next;
-    if (entry->next != NULL)
-        (entry->next)->prev = entry->prev;
-    else
-        queue->tail = entry->prev;
+    if (wheel->overflow.head != NULL)
+        return (wheel->now / TADF_SENDQ_WHEEL_SPAN + 1) *
+               TADF_SENDQ_WHEEL_SPAN;
 
-    queue->queue_size--;
-    free(entry->pkt);
-    free(entry);
-    pthread_mutex_unlock(&queue->sendq_lock);
-    return 0;
+    return UINT64_MAX;
 }
 
-#if 0
-/* this code is not used */
 /**
- * Finds the entry in the send queue due to it's send time.
- * The function sets the entry pointer to the entry (in case
- * there are many entries with such send_time the pointer is
- * set to the entry which is later in the sendq).
- *
- * @param queue       The queue in which we will search.
- * @param entry       The pointer to the found entry.
- * @param send_time   The send time of the entry we should search for.
- *
- * @return            0 - if the function ends correctly and the entry
- *                        is found
- *                    TE_EINVAL - if there was no such entry
+ * Advance the timer wheel of the send queue to the given tick moving
+ * all packets which send time has come to the ready list. Empty slots
+ * are skipped, so the cost does not depend on the time passed.
+ *
+ * @param queue     The send queue.
+ * @param tick      The current tick.
  */
-static inline int
-tadf_sendq_entry_find(sendq_t *queue,
-                      sendq_entry_t **entry,
-                      struct timeval *send_time)
+static void
+sendq_wheel_advance(sendq_t *queue, uint64_t tick)
 {
-    sendq_entry_t *current;
+    sendq_wheel_t *wheel = &queue->wheel;
+    sendq_list_t   list;
+    uint64_t       next;
+    unsigned int   shift;
+    unsigned int   slot;
+    int            level;
+
+    while ((next = sendq_wheel_next_event(wheel)) <= tick)
+    {
+        wheel->now = next;
 
-    pthread_mutex_lock(&queue->sendq_lock);
-    current = queue->head;
+        if (next % TADF_SENDQ_WHEEL_SPAN == 0)
+            sendq_wheel_readd(queue, &wheel->overflow);
 
-    while (current != NULL)
-    {
-        if ((current->send_time.tv_sec == send_time->tv_sec) &&
-            (current->send_time.tv_usec == send_time->tv_usec))
+        /*
+         * Move entries of the reached slots from higher levels down,
+         * entries of the level 0 slot go to the ready list.
+         */
+        for (level = TADF_SENDQ_WHEEL_LEVELS - 1; level >= 0; level--)
         {
-            *entry = &(current);
-            pthread_mutex_unlock(&queue->sendq_lock);
-            return 0;
+            shift = level * TADF_SENDQ_WHEEL_BITS;
+            if ((next & ((1ULL << shift) - 1)) != 0)
+                continue;
+
+            slot = (next >> shift) & TADF_SENDQ_WHEEL_MASK;
+            if (wheel->slots[level][slot].head == NULL)
+                continue;
+
+            list = wheel->slots[level][slot];
+            memset(&wheel->slots[level][slot], 0, sizeof(list));
+            wheel->busy[level][slot / 64] &= ~(1ULL << (slot % 64));
+            sendq_wheel_readd(queue, &list);
         }
-        current = current->next;
     }
-    pthread_mutex_unlock(&queue->sendq_lock);
-    /* if we are here we failed to find the entry */
-    return TE_RC(TE_TA_EXT, TE_ENOENT);
+
+    if (tick > wheel->now)
+        wheel->now = tick;
 }
-#endif
 
 /**
  * This function initializes the objects of the send queue:
@@ -251,6 +398,9 @@ tadf_sendq_init(sendq_t **queue, csap_p csap, int bandwidth, int size_max)
     sendq->queue_size = 0;
     sendq->queue_bandwidth = bandwidth;
 
+    sendq->wheel.now = tadf_sendq_now() >> TADF_SENDQ_TICK_SHIFT;
+    sendq->wakeup_ts = UINT64_MAX;
+
     sendq->sendq_lock = lock;
 
     /*
@@ -295,9 +445,8 @@ tadf_sendq_free(sendq_t *sendq)
     int      rc = -1;
     void    *thread_rc = NULL;
     uint8_t  msg_type = TADF_SYNC_MSG_TYPE_EXIT;
-
-    sendq_entry_t *current = sendq->head;
-    sendq_entry_t *next;
+    unsigned int level;
+    unsigned int slot;
 
     rc = write(sendq->sendq_sync_sockets[0], &msg_type, sizeof(msg_type));
     if (rc == -1)
@@ -318,11 +467,12 @@ tadf_sendq_free(sendq_t *sendq)
         ERROR("Failed to close socket connection  of the send queue");
 
     /* Removing the sendq entries */
-    while (current != NULL)
+    sendq_list_free(&sendq->ready);
+    sendq_list_free(&sendq->wheel.overflow);
+    for (level = 0; level < TADF_SENDQ_WHEEL_LEVELS; level++)
     {
-        next = current->next;
-        tadf_sendq_entry_remove(sendq, current);
-        current = next;
+        for (slot = 0; slot < TADF_SENDQ_WHEEL_SLOTS; slot++)
+            sendq_list_free(&sendq->wheel.slots[level][slot]);
     }
 
     /* Destroing the mutex lock */
@@ -352,61 +502,79 @@ tadf_sendq_put_pkt(sendq_t *queue,
                    const size_t pkt_len,
                    struct timeval mdump)
 {
-    int            rc = -1;
+    int            rc;
     uint8_t        msg_type = TADF_SYNC_MSG_TYPE_WAKE;
-
-    sendq_entry_t *entry = (sendq_entry_t *)malloc(sizeof(sendq_entry_t));
+    te_bool        wake;
+    sendq_entry_t *entry;
 
     if (pkt == NULL)
     {
-        free(entry);
         WARN("Wrong data pointer");
         return TE_RC(TE_TA_EXT, TE_EWRONGPTR);
     }
 
+    entry = (sendq_entry_t *)malloc(sizeof(sendq_entry_t));
+    if (entry == NULL)
+        return TE_RC(TE_TA_EXT, TE_ENOMEM);
+
     entry->pkt = (uint8_t *)malloc(pkt_len);
     if (entry->pkt == NULL)
+    {
+        free(entry);
         return TE_RC(TE_TA_EXT, TE_ENOMEM);
+    }
 
     memcpy(entry->pkt, pkt, pkt_len);
     entry->pkt_len = pkt_len;
-    entry->send_time = mdump;
+    entry->deadline = tadf_sendq_deadline(mdump);
 
     pthread_mutex_lock(&queue->sendq_lock);
-    /* Insertig the packet */
-    rc = tadf_sendq_entry_insert(queue, entry);
-    if (rc != 0)
+
+    VERB("SendQ %d (csap %d), Adding a packet: sendq size = %d, "
+         "sendq max size = %d",
+         queue->id, queue->csap->id,
+         queue->queue_size, queue->queue_size_max);
+    /* if the sendq is full then we simply drop the packet */
+    if (queue->queue_size_max <= queue->queue_size)
     {
-        WARN("Failed to insert the entry in the send queue of the "
-             "Forwarder CSAP");
+        queue->stats.dropped++;
         pthread_mutex_unlock(&queue->sendq_lock);
-        goto error;
+        VERB("Failed to insert the entry in the send queue of the "
+             "Forwarder CSAP");
+        free(entry->pkt);
+        free(entry);
+        return TE_RC(TE_TA_EXT, TE_ENOBUFS);
     }
 
+    entry->seqno = queue->seqno++;
+    queue->queue_size++;
+    sendq_wheel_add(queue, entry);
+
     /*
-     * If we inserter the packet to the top of the send queue, the function
-     * informs  sending thread via send queue sync pipe.
+     * If the packet should be sent earlier than the sending thread
+     * is going to wake up, inform it via send queue sync pipe.
      */
-    if (entry->next == NULL)
+    wake = (entry->deadline < queue->wakeup_ts);
+    if (wake)
+        queue->wakeup_ts = entry->deadline;
+
+    pthread_mutex_unlock(&queue->sendq_lock);
+
+    if (wake)
     {
-        pthread_mutex_unlock(&queue->sendq_lock);
         rc = write(queue->sendq_sync_sockets[0], &msg_type,
                    sizeof(msg_type));
         VERB("Sending sync message to the main sending thread, rc = %d",
              rc);
         if (rc < 0)
         {
+            rc = TE_OS_RC(TE_TA_EXT, errno);
             ERROR("Failed to send message to the thread of the send queue");
-            goto error;
+            return rc;
         }
-        return 0;
     }
-    pthread_mutex_unlock(&queue->sendq_lock);
+
     return 0;
-error:
-    free(entry->pkt);
-    free(entry);
-    return TE_RC(TE_TA_EXT, rc);
 }
 
 /**
@@ -424,7 +592,8 @@ int
 tadf_sendq_get_param(int sendq_id,
                      const char *param_spec)
 {
-    sendq_t *queue;
+    sendq_t  *queue;
+    uint64_t  value;
 
     queue = tadf_sendq_find(sendq_id);
     if (queue == NULL)
@@ -443,10 +612,33 @@ tadf_sendq_get_param(int sendq_id,
     else if (strncmp("bandwidth", param_spec, strlen("bandwidth")) == 0)
     {
         return queue->queue_bandwidth;
+    }
+    else if (strncmp("sent", param_spec, strlen("sent")) == 0)
+    {
+        value = queue->stats.sent;
+    }
+    else if (strncmp("dropped", param_spec, strlen("dropped")) == 0)
+    {
+        value = queue->stats.dropped;
+    }
+    else if (strncmp("reordered", param_spec, strlen("reordered")) == 0)
+    {
+        value = queue->stats.reordered;
+    }
+    else if (strncmp("jitter_avg", param_spec, strlen("jitter_avg")) == 0)
+    {
+        value = (queue->stats.sent == 0) ? 0 :
+                queue->stats.jitter_sum / queue->stats.sent;
+    }
+    else if (strncmp("jitter_max", param_spec, strlen("jitter_max")) == 0)
+    {
+        value = queue->stats.jitter_max;
     } else
     {
         return -1;
     }
+
+    return MIN(value, INT_MAX);
 }
 
 /**
@@ -513,14 +705,15 @@ tadf_pkt_ctrl_free_fake(void *ptr)
 }
 
 /**
- * Send a packet from the queue tail.
+ * Send a packet.
  *
  * @param sendq         queue to send packet from
+ * @param entry         entry of the packet
  *
  * @return Status code.
  */
 static te_errno
-tadf_send_pkt(sendq_t *sendq)
+tadf_send_pkt(sendq_t *sendq, sendq_entry_t *entry)
 {
      tad_pkt     pkt;
      tad_pkt_seg seg;
@@ -531,8 +724,8 @@ tadf_send_pkt(sendq_t *sendq)
 
      memset(&seg, 0, sizeof(seg));
      seg.my_free = tadf_pkt_ctrl_free_fake;
-     tad_pkt_init_seg_data(&seg, sendq->tail->pkt,
-                           sendq->tail->pkt_len, tadf_seg_free_fake);
+     tad_pkt_init_seg_data(&seg, entry->pkt, entry->pkt_len,
+                           tadf_seg_free_fake);
 
      tad_pkt_append_seg(&pkt, &seg);
 
@@ -540,9 +733,157 @@ tadf_send_pkt(sendq_t *sendq)
                 proto_support->write_cb(sendq->csap, &pkt);
 }
 
+/**
+ * Detach packets which should be sent at the moment from the ready
+ * list of the send queue. If the bandwidth is limited, packets are
+ * taken while it permits. Must be called under the send queue lock.
+ *
+ * @param sendq         The send queue.
+ * @param now           The current time.
+ *
+ * @return              List of packets to be sent or @c NULL.
+ */
+static sendq_entry_t *
+tadf_sendq_get_batch(sendq_t *sendq, uint64_t now)
+{
+    sendq_entry_t *first = sendq->ready.head;
+    sendq_entry_t *last = NULL;
+    sendq_entry_t *entry;
+
+    for (entry = first;
+         entry != NULL && entry->deadline <= now;
+         entry = entry->next)
+    {
+        if (sendq->queue_bandwidth > 0)
+        {
+            if (sendq->bandwidth_ts > now)
+                break;
+
+            /*
+             * The bandwidth timestamp is advanced from the previous
+             * one rather than from the current time, so that sending
+             * delays do not decrease the resulting bandwidth.
+             */
+            sendq->bandwidth_ts = MAX(sendq->bandwidth_ts,
+                                      entry->deadline) +
+                                  entry->pkt_len * TADF_NS_PER_SEC /
+                                  sendq->queue_bandwidth;
+        }
+        sendq->queue_size--;
+        last = entry;
+    }
+
+    if (last == NULL)
+        return NULL;
+
+    sendq->ready.head = last->next;
+    if (last->next != NULL)
+        last->next->prev = NULL;
+    else
+        sendq->ready.tail = NULL;
+    last->next = NULL;
+
+    return first;
+}
+
+/**
+ * Get the time the sending thread should wake up at.
+ * Must be called under the send queue lock.
+ *
+ * @param sendq         The send queue.
+ *
+ * @return              Nanoseconds of CLOCK_MONOTONIC or @c UINT64_MAX
+ *                      if there is nothing to wait for.
+ */
+static uint64_t
+tadf_sendq_wakeup_time(sendq_t *sendq)
+{
+    uint64_t tick;
+
+    if (sendq->ready.head != NULL)
+    {
+        if (sendq->queue_bandwidth > 0)
+            return MAX(sendq->ready.head->deadline, sendq->bandwidth_ts);
+
+        return sendq->ready.head->deadline;
+    }
+
+    tick = sendq_wheel_next_event(&sendq->wheel);
+    if (tick == UINT64_MAX)
+        return UINT64_MAX;
+
+    return tick << TADF_SENDQ_TICK_SHIFT;
+}
+
+/**
+ * Send a batch of packets and update the send queue statistics.
+ * Packets are freed.
+ *
+ * @param sendq         The send queue.
+ * @param batch         List of packets.
+ */
+static void
+tadf_sendq_send_batch(sendq_t *sendq, sendq_entry_t *batch)
+{
+    sendq_stats_t  stats;
+    sendq_entry_t *entry;
+    uint64_t       seqno_sent = sendq->seqno_sent;
+    uint64_t       delay;
+    te_errno       rc;
+
+    memset(&stats, 0, sizeof(stats));
+
+    while (batch != NULL)
+    {
+        entry = batch;
+        batch = entry->next;
+
+        rc = tadf_send_pkt(sendq, entry);
+        if (rc != 0)
+        {
+            ERROR("SendQ %d (csap %d), Failed to send data via "
+                  "Ethernet CSAP: %r",
+                  sendq->id, sendq->csap->id, rc);
+            stats.dropped++;
+        }
+        else
+        {
+            delay = tadf_sendq_now() - entry->deadline;
+
+            stats.sent++;
+            stats.jitter_sum += delay;
+            stats.jitter_max = MAX(stats.jitter_max, delay);
+
+            if (entry->seqno < seqno_sent)
+                stats.reordered++;
+            else
+                seqno_sent = entry->seqno + 1;
+
+            F_VERB("SendQ %d (csap %d), Packet sent: len %u, "
+                   "delay %llu ns", sendq->id, sendq->csap->id,
+                   (unsigned)entry->pkt_len, (unsigned long long)delay);
+        }
+
+        free(entry->pkt);
+        free(entry);
+    }
+
+    pthread_mutex_lock(&sendq->sendq_lock);
+    sendq->seqno_sent = seqno_sent;
+    sendq->stats.sent += stats.sent;
+    sendq->stats.dropped += stats.dropped;
+    sendq->stats.reordered += stats.reordered;
+    sendq->stats.jitter_sum += stats.jitter_sum;
+    sendq->stats.jitter_max = MAX(sendq->stats.jitter_max,
+                                  stats.jitter_max);
+    pthread_mutex_unlock(&sendq->sendq_lock);
+}
+
 /**
  * The main sending thread function. The function sends packets
  * to their destination using write_cb of the corresponding CSAP.
+ * All packets which send time has come are sent in one batch
+ * without holding the send queue lock.
  *
  * @param queue         The queue the thread should work with
  *
@@ -552,190 +893,76 @@ tadf_send_pkt(sendq_t *sendq)
 void *
 tadf_sendq_send_thread_main(void *queue)
 {
-    sendq_t *sendq = (sendq_t *)queue;
-    struct   timeval curr_time;
-    struct   timeval sleep_tv;
+    sendq_t        *sendq = (sendq_t *)queue;
+    sendq_entry_t  *batch;
+    uint64_t        now;
+    uint64_t        wakeup = UINT64_MAX;
+    uint64_t        sleep_ns;
+    struct timespec sleep_ts;
+    fd_set          read_fd;
+    int             rc;
 
     uint8_t  msg_type = TADF_SYNC_MSG_TYPE_WAKE;
 
-    int      rc;
-
-    sendq_entry_t *tail;
-
-    long long  time_stamp;
-
-    fd_set read_fd;
-
     for (;;)
     {
         pthread_mutex_lock(&sendq->sendq_lock);
 
-        tail = sendq->tail;
-        gettimeofday(&curr_time, NULL);
+        now = tadf_sendq_now();
+        sendq_wheel_advance(sendq, now >> TADF_SENDQ_TICK_SHIFT);
 
-        /* In case we have a limited bandwidth */
-        if (sendq->queue_bandwidth > 0)
-        {
-            VERB("SendQ %d (csap %d), Limited bw case",
-                 sendq->id, sendq->csap->id);
-            /*
-             * We should check, if we can send packets now due to
-             * the bandwidth parameter
-             */
-            if (timeval_compare(sendq->bandwidth_ts, curr_time) > 0)
-            {
-                /* The time we still should sleep */
-                SUB_TV(sleep_tv, sendq->bandwidth_ts, curr_time);
-                VERB("SendQ %d (csap %d), "
-                     "We still have to sleep to some time, "
-                     "sendq->bandwidth_ts: (%d.%d)",
-                     sendq->id, sendq->csap->id,
-                     sendq->bandwidth_ts.tv_sec,
-                     sendq->bandwidth_ts.tv_usec);
-                goto sleep;
-            }
+        batch = tadf_sendq_get_batch(sendq, now);
+        if (batch == NULL)
+            wakeup = tadf_sendq_wakeup_time(sendq);
 
-            memset(&(sendq->bandwidth_ts), 0, sizeof(struct timeval));
+        /*
+         * While the thread is awake, it checks the queue before
+         * sleeping, so it should not be woken up.
+         */
+        sendq->wakeup_ts = (batch == NULL) ? wakeup : 0;
 
-            if (tail == NULL)
-            {
-                memset(&sleep_tv, 0, sizeof(struct timeval));
-                goto sleep;
-            }
-            else
-                SUB_TV(sleep_tv, tail->send_time, curr_time);
+        pthread_mutex_unlock(&sendq->sendq_lock);
 
-            if (timeval_compare(curr_time, tail->send_time) >= 0)
-            {
-                struct timeval ts_diff;
-
-                VERB("SendQ %d (csap %d), send_time=(%d, %d), bandwidth=%d",
-                     sendq->id, sendq->csap->id,
-                     tail->send_time.tv_sec, tail->send_time.tv_usec,
-                     sendq->queue_bandwidth);
-                /*
-                 * The sleep time is maximum of the time we should sleep
-                 * due to the bandwidth and to the time till next packet
-                 * should be sent
-                 */
-                time_stamp =
-                    (tail->pkt_len * 1000000) / sendq->queue_bandwidth;
-                sleep_tv.tv_sec = time_stamp / 1000000;
-                sleep_tv.tv_usec = time_stamp % 1000000;
-
-                /*
-                 * We should set bandwidth wake up time. If next time we
-                 * will wake up earlier than senq->bandwidth_ts we can't
-                 * send any packets.
-                 */
-                ADD_TV(sendq->bandwidth_ts, curr_time, sleep_tv);
-
-                /*
-                 * If there are no packets to send for some time we can
-                 * simply sleep until there are some or until we are awaken
-                 */
-                if (tail->prev != NULL)
-                {
-                    SUB_TV(ts_diff, tail->prev->send_time, curr_time);
-                    sleep_tv =  MAX_TV(sleep_tv, ts_diff);
-                }
-
-                /* Sending packet using Ethernet CSAP write_cb */
-                rc = tadf_send_pkt(sendq);
-                if (rc != 0)
-                {
-                    ERROR("SendQ %d (csap %d), Failed to send data via "
-                          "Ethernet CSAP: %r",
-                          sendq->id, sendq->csap->id, rc);
-
-                    pthread_mutex_unlock(&sendq->sendq_lock);
-                    return NULL;
-                }
-                F_VERB("SendQ %d (csap %d), csap write cb return %d "
-                       "for pkt with len %d",
-                       sendq->id, sendq->csap->id,
-                       rc, tail->pkt_len);
-                F_VERB("SendQ %d (csap %d), Packet sent: %d, %d , "
-                       "sendq size = %d\n",
-                       sendq->id, sendq->csap->id,
-                       tail->send_time.tv_sec, tail->send_time.tv_usec,
-                       sendq->queue_size);
-
-                tadf_sendq_entry_remove(sendq, tail);
-            }
-        }
-        else
+        if (batch != NULL)
         {
-            /*
-             * We should send all packets with send_time less or equal
-             * current time
-             */
-            memset(&sleep_tv, 0, sizeof(sleep_tv));
-            while ((tail != NULL) &&
-                   (timeval_compare(curr_time, tail->send_time) >= 0))
-            {
-                /* Sending packet using Ethernet CSAP write_cb */
-                rc = tadf_send_pkt(sendq);
-                if (rc != 0)
-                {
-                    ERROR("SendQ %d (csap %d), Failed to send data via "
-                          "Ethernet CSAP: %r",
-                          sendq->id, sendq->csap->id, rc);
-
-                    pthread_mutex_unlock(&sendq->sendq_lock);
-                    return NULL;
-                }
-
-                tadf_sendq_entry_remove(sendq, tail);
-                VERB("SendQ %d (csap %d), Packet sent: %d, %d , "
-                     "sendq size = %d\n",
-                     sendq->id, sendq->csap->id,
-                     tail->send_time.tv_sec, tail->send_time.tv_usec,
-                     sendq->queue_size);
-
-                tail = sendq->tail;
-            }
-
-            /*
-             * If during our sleep somebody will change the sendq_bandwidth
-             * this thing will help us not to became crazy
-             */
-            memset(&sendq->bandwidth_ts, 0, sizeof(struct timeval));
-            if (tail != NULL)
-                SUB_TV(sleep_tv, tail->send_time, curr_time);
+            tadf_sendq_send_batch(sendq, batch);
+            continue;
         }
 
-sleep:
         FD_ZERO(&read_fd);
         FD_SET(sendq->sendq_sync_sockets[1], &read_fd);
 
-        pthread_mutex_unlock(&sendq->sendq_lock);
-
         /*
          * Now we sleep until any message is received via communication
          * channel of the send queue
          */
-        if (IS_ZERO(sleep_tv))
+        if (wakeup == UINT64_MAX)
         {
             VERB("SendQ %d (csap %d), Going to unlimited sleep",
                  sendq->id, sendq->csap->id);
-            rc = select(sendq->sendq_sync_sockets[1] + 1, &read_fd,
-                        NULL, NULL, NULL);
+            rc = pselect(sendq->sendq_sync_sockets[1] + 1, &read_fd,
+                         NULL, NULL, NULL, NULL);
         }
         else
         {
-            VERB("SendQ %d (csap %d), Going to sleep, time = (%d, %d)",
+            sleep_ns = (wakeup > now) ? wakeup - now : 0;
+            sleep_ts.tv_sec = sleep_ns / TADF_NS_PER_SEC;
+            sleep_ts.tv_nsec = sleep_ns % TADF_NS_PER_SEC;
+
+            VERB("SendQ %d (csap %d), Going to sleep, time = %llu ns",
                  sendq->id, sendq->csap->id,
-                 sleep_tv.tv_sec, sleep_tv.tv_usec);
-            rc = select(sendq->sendq_sync_sockets[1] + 1, &read_fd,
-                        NULL, NULL, &sleep_tv);
+                 (unsigned long long)sleep_ns);
+            rc = pselect(sendq->sendq_sync_sockets[1] + 1, &read_fd,
+                         NULL, NULL, &sleep_ts, NULL);
         }
         if (rc < 0)
         {
-            ERROR("SendQ %d (csap %d), Select() in main send thread "
-                  "returned %d, errno = %d",
-                  sendq->id, sendq->csap->id,
-                  errno);
+            if (errno == EINTR)
+                continue;
+
+            ERROR("SendQ %d (csap %d), pselect() in main send thread "
+                  "failed, errno = %d",
+                  sendq->id, sendq->csap->id, errno);
             return NULL;
         }
 
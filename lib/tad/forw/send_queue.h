@@ -14,6 +14,7 @@
 #ifdef HAVE_SYS_TIME_H
 #include <sys/time.h> /* For 'struct timeval' */
 #endif
+#include "te_stdint.h"
 #include "tad_csap_inst.h"
 
 /** The maximum number of send queues created on the forwarder host */
@@ -58,21 +59,78 @@
 
 /** Send queue entry structure */
 typedef struct sendq_entry_s {
-    struct sendq_entry_s *next; /**< previous packet in the queue */
-    struct sendq_entry_s *prev; /**< next packet in the queue     */
+    struct sendq_entry_s *next; /**< next packet in the list      */
+    struct sendq_entry_s *prev; /**< previous packet in the list  */
 
     uint8_t        *pkt;        /**< packet data                  */
     size_t          pkt_len;    /**< packet data size             */
-    struct timeval  send_time;  /**< packet send time             */
+    uint64_t        deadline;   /**< packet send time, nanoseconds
+                                     of CLOCK_MONOTONIC           */
+    uint64_t        seqno;      /**< sequence number of the packet
+                                     in the send queue            */
 } sendq_entry_t;
 
+/** List of send queue entries */
+typedef struct sendq_list_s {
+    sendq_entry_t  *head; /**< the first entry of the list */
+    sendq_entry_t  *tail; /**< the last entry of the list  */
+} sendq_list_t;
+
+/** Binary logarithm of the timer wheel tick length in nanoseconds */
+#define TADF_SENDQ_TICK_SHIFT    10
+
+/** Binary logarithm of the number of slots on a timer wheel level */
+#define TADF_SENDQ_WHEEL_BITS    8
+
+/** Number of slots on a timer wheel level */
+#define TADF_SENDQ_WHEEL_SLOTS   (1 << TADF_SENDQ_WHEEL_BITS)
+
+/** Number of timer wheel levels */
+#define TADF_SENDQ_WHEEL_LEVELS  4
+
+/** Number of 64-bit words in a bitmap of a timer wheel level */
+#define TADF_SENDQ_WHEEL_WORDS   (TADF_SENDQ_WHEEL_SLOTS / 64)
+
 /**
- * Send queue structure. Packets from the tail of the queue should
- * be sent first
+ * Hierarchical timer wheel keeping delayed packets.
+ *
+ * A packet which should be sent at tick @a t is kept on level @a k
+ * in slot number ((@a t >> (@a k * TADF_SENDQ_WHEEL_BITS)) &
+ * (TADF_SENDQ_WHEEL_SLOTS - 1)), where @a k is the highest level on
+ * which @a t differs from the current tick. When the current tick
+ * reaches a slot of a higher level, its packets are moved to lower
+ * levels, so that insertion and expiration do not depend on the number
+ * of queued packets.
+ */
+typedef struct sendq_wheel_s {
+    uint64_t        now;      /**< current tick */
+    sendq_list_t    slots[TADF_SENDQ_WHEEL_LEVELS][TADF_SENDQ_WHEEL_SLOTS];
+                              /**< slots of all levels */
+    uint64_t        busy[TADF_SENDQ_WHEEL_LEVELS][TADF_SENDQ_WHEEL_WORDS];
+                              /**< bitmaps of non-empty slots */
+    sendq_list_t    overflow; /**< packets beyond the highest level */
+} sendq_wheel_t;
+
+/** Send queue statistics */
+typedef struct sendq_stats_s {
+    uint64_t        sent;       /**< number of sent packets */
+    uint64_t        dropped;    /**< number of packets dropped because
+                                     of queue overflow or send failure */
+    uint64_t        reordered;  /**< number of packets sent after
+                                     a packet put to the queue later */
+    uint64_t        jitter_sum; /**< sum of send delays (relative to
+                                     the packet send time), nanoseconds */
+    uint64_t        jitter_max; /**< maximum send delay, nanoseconds */
+} sendq_stats_t;
+
+/**
+ * Send queue structure. Delayed packets are kept in the timer wheel,
+ * packets which send time has come are moved to the ready list sorted
+ * by send time.
  */
 typedef struct sendq_s {
-    sendq_entry_t  *head; /**< head of the queue */
-    sendq_entry_t  *tail; /**< tail of the queue */
+    sendq_wheel_t   wheel;  /**< delayed packets */
+    sendq_list_t    ready;  /**< packets to be sent */
 
     int             id;   /**< Unique send queue identifier */
 
@@ -87,7 +145,16 @@ typedef struct sendq_s {
     int             queue_size;      /**< queue current size */
     int             queue_bandwidth; /**< sendq bandwidth    */
 
-    struct timeval  bandwidth_ts;    /**< bandwidth timestamp */
+    uint64_t        bandwidth_ts;    /**< the time the next packet may be
+                                          sent at due to the bandwidth,
+                                          nanoseconds of CLOCK_MONOTONIC */
+    uint64_t        wakeup_ts;       /**< the time the sending thread
+                                          is going to wake up at */
+    uint64_t        seqno;           /**< the next packet sequence number */
+    uint64_t        seqno_sent;      /**< the maximum sequence number of
+                                          sent packets plus one */
+
+    sendq_stats_t   stats;           /**< statistics */
 } sendq_t;
 
 /**
@@ -172,7 +239,11 @@ extern int tadf_sendq_set_param(int sendq_id,
  * @param sendq_id        The ID of the queue the parameter of which
  *                        should be
  *                        outputed.
- * @param param_spec      The name of the parameter in human-readable form.
+ * @param param_spec      The name of the parameter in human-readable form:
+ *                        "size_max", "size", "bandwidth" or one of
+ *                        the statistics counters "sent", "dropped",
+ *                        "reordered", "jitter_avg", "jitter_max" (the
+ *                        last two are send delays in nanoseconds).
  *
  * @return                Value of the parameter or -1 if there is no
  *                        parameter with such name.
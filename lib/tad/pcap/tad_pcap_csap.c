@@ -26,11 +26,11 @@ static csap_spt_type_t pcap_csap_spt =
 
     .init_cb             = tad_pcap_init_cb,
     .destroy_cb          = tad_pcap_destroy_cb,
-    .get_param_cb        = NULL,
+    .get_param_cb        = tad_pcap_get_param_cb,
 
-    .confirm_tmpl_cb     = NULL,
+    .confirm_tmpl_cb     = tad_pcap_confirm_tmpl_cb,
     .generate_pkts_cb    = NULL,
-    .release_tmpl_cb     = NULL,
+    .release_tmpl_cb     = tad_pcap_release_tmpl_cb,
 
     .confirm_ptrn_cb     = tad_pcap_confirm_ptrn_cb,
     .match_pre_cb        = NULL,
@@ -45,9 +45,10 @@ static csap_spt_type_t pcap_csap_spt =
     .rw_init_cb          = tad_pcap_rw_init_cb,
     .rw_destroy_cb       = tad_pcap_rw_destroy_cb,
 
-    .prepare_send_cb     = NULL,
+    .prepare_send_cb     = tad_pcap_prepare_send,
     .write_cb            = NULL,
-    .shutdown_send_cb    = NULL,
+    .shutdown_send_cb    = tad_pcap_shutdown_send,
+    .send_tmpl_cb        = tad_pcap_replay_cb,
 
     .prepare_recv_cb     = tad_pcap_prepare_recv,
     .read_cb             = tad_pcap_read_cb,
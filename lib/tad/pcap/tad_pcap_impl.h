@@ -11,13 +11,39 @@
 #ifndef __TE_TAD_PCAP_IMPL_H__
 #define __TE_TAD_PCAP_IMPL_H__
 
+#include "te_stdint.h"
 #include "tad_csap_support.h"
+#include "tad_eth_sap.h"
 
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Statistics of the last replay of a capture file */
+typedef struct tad_pcap_replay_stats {
+    uint64_t    pkts;           /**< Number of sent packets */
+    uint64_t    bytes;          /**< Number of sent bytes */
+    uint64_t    loops;          /**< Number of completed loops */
+    uint64_t    requested_ns;   /**< Time from start of the replay to
+                                     the last sent packet in accordance
+                                     with requested timing (zero for
+                                     maximum rate) */
+    uint64_t    duration_ns;    /**< Real time from start of the replay
+                                     to the last sent packet */
+    uint64_t    max_lag_ns;     /**< Maximum delay of a packet against
+                                     requested timing */
+} tad_pcap_replay_stats;
+
+/** Ethernet-PCAP layer read/write specific data */
+typedef struct tad_pcap_rw_data {
+    tad_eth_sap             sap;            /**< Ethernet service access
+                                                 point */
+    unsigned int            recv_mode;      /**< Default receive mode */
+    tad_pcap_replay_stats   replay_stats;   /**< Statistics of the last
+                                                 replay */
+} tad_pcap_rw_data;
+
 
 /**
  * Callback for init Ethernet-PCAP CSAP layer if single in stack.
@@ -47,6 +73,20 @@ extern te_errno tad_pcap_prepare_recv(csap_p csap);
  */
 extern te_errno tad_pcap_shutdown_recv(csap_p csap);
 
+/**
+ * Open send socket for Ethernet-PCAP CSAP.
+ *
+ * This function complies with csap_low_resource_cb_t prototype.
+ */
+extern te_errno tad_pcap_prepare_send(csap_p csap);
+
+/**
+ * Close send socket for Ethernet-PCAP CSAP.
+ *
+ * This function complies with csap_low_resource_cb_t prototype.
+ */
+extern te_errno tad_pcap_shutdown_send(csap_p csap);
+
 /**
  * Callback for read data from media of Ethernet-PCAP CSAP.
  *
@@ -70,6 +110,43 @@ extern te_errno tad_pcap_init_cb(csap_p csap, unsigned int layer);
  */
 extern te_errno tad_pcap_destroy_cb(csap_p csap, unsigned int layer);
 
+/**
+ * Callback to get parameter of Ethernet-PCAP CSAP.
+ * @c CSAP_PARAM_REPLAY_STATS parameter is supported.
+ *
+ * The function complies with csap_layer_get_param_cb_t prototype.
+ */
+extern char *tad_pcap_get_param_cb(csap_p csap, unsigned int layer,
+                                   const char *param);
+
+/**
+ * Callback for confirm template PDU with Ethernet-PCAP CSAP parameters
+ * and possibilities. The capture file to be replayed is mapped and
+ * indexed, and requested rewriting is applied to its packets.
+ *
+ * The function complies with csap_layer_confirm_pdu_cb_t prototype.
+ */
+extern te_errno tad_pcap_confirm_tmpl_cb(csap_p         csap,
+                                         unsigned int   layer,
+                                         asn_value     *layer_pdu,
+                                         void         **p_opaque);
+
+/**
+ * Callback to release data prepared by confirm template callback.
+ *
+ * The function complies with csap_layer_release_opaque_cb_t prototype.
+ */
+extern void tad_pcap_release_tmpl_cb(csap_p csap, unsigned int layer,
+                                     void *opaque);
+
+/**
+ * Callback to replay the capture file prepared by confirm template
+ * callback.
+ *
+ * The function complies with csap_send_tmpl_cb_t prototype.
+ */
+extern te_errno tad_pcap_replay_cb(csap_p csap, void *opaque);
+
 /**
  * Callback for confirm pattern PDU with Ethernet-PCAP CSAP parameters
  * and possibilities.
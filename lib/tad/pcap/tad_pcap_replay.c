@@ -0,0 +1,1208 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD PCAP
+ *
+ * Traffic Application Domain Command Handler.
+ * Ethernet-PCAP CSAP replay of pcap/pcapng capture files.
+ *
+ * Capture file is mapped into memory (privately, so packets may be
+ * modified by rewriting without touching the file) and indexed when
+ * template is confirmed. Sending walks the index and passes packets
+ * which are due to the Ethernet service access point in batches.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "TAD Ethernet-PCAP"
+
+#include "te_config.h"
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#if HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#if HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#if HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif
+#include <sys/mman.h>
+#include <time.h>
+
+#include "te_defs.h"
+#include "te_stdint.h"
+#include "te_errno.h"
+#include "te_alloc.h"
+#include "te_vector.h"
+#include "logger_api.h"
+#include "asn_usr.h"
+#include "ndn_pcap.h"
+#include "tad_csap_inst.h"
+#include "tad_send.h"
+#include "tad_utils.h"
+
+#include "tad_pcap_impl.h"
+
+
+/** Link type of Ethernet frames in capture files */
+#define TAD_PCAP_REPLAY_LINKTYPE_ETHERNET   1
+
+/** Magic numbers of classic pcap files */
+#define TAD_PCAP_REPLAY_MAGIC_US            0xa1b2c3d4
+#define TAD_PCAP_REPLAY_MAGIC_NS            0xa1b23c4d
+
+/** pcapng block types */
+#define TAD_PCAP_REPLAY_PCAPNG_SHB          0x0a0d0d0a
+#define TAD_PCAP_REPLAY_PCAPNG_IDB          0x00000001
+#define TAD_PCAP_REPLAY_PCAPNG_SPB          0x00000003
+#define TAD_PCAP_REPLAY_PCAPNG_EPB          0x00000006
+
+/** pcapng byte-order magic */
+#define TAD_PCAP_REPLAY_PCAPNG_BOM          0x1a2b3c4d
+
+/** pcapng interface description block option with timestamp resolution */
+#define TAD_PCAP_REPLAY_PCAPNG_IF_TSRESOL   9
+
+/** Default number of packets passed to the media at once */
+#define TAD_PCAP_REPLAY_BATCH_DEF           32
+
+/** Maximum number of packets passed to the media at once */
+#define TAD_PCAP_REPLAY_BATCH_MAX           256
+
+/**
+ * Packets which are due in less than this number of nanoseconds
+ * are waited for by polling of the clock rather than by sleeping.
+ */
+#define TAD_PCAP_REPLAY_SPIN_NS             50000
+
+/**
+ * Maximum time to sleep at once (in nanoseconds) to check whether
+ * the CSAP is requested to stop.
+ */
+#define TAD_PCAP_REPLAY_SLEEP_MAX_NS        100000000
+
+/** Index of source address/port in rewriting rules */
+#define TAD_PCAP_REPLAY_SRC     0
+/** Index of destination address/port in rewriting rules */
+#define TAD_PCAP_REPLAY_DST     1
+
+/** Packet of a capture file */
+typedef struct tad_pcap_replay_pkt {
+    uint8_t    *data;   /**< Frame in the mapped file */
+    uint32_t    len;    /**< Captured length of the frame */
+    uint64_t    ts;     /**< Timestamp relative to the first packet,
+                             nanoseconds */
+} tad_pcap_replay_pkt;
+
+/** Address in a rewriting rule */
+typedef struct tad_pcap_replay_addr {
+    size_t      len;        /**< Address length: @c 4 or @c 16,
+                                 @c 0 if not specified */
+    uint8_t     addr[16];   /**< Address in network byte order */
+} tad_pcap_replay_addr;
+
+/**
+ * Rewriting rule. Packet matches the rule if all specified match
+ * fields are equal to ones of the packet.
+ */
+typedef struct tad_pcap_replay_rewrite {
+    tad_pcap_replay_addr    match_addr[2];  /**< Addresses to match */
+    int32_t                 match_port[2];  /**< Ports to match
+                                                 or @c -1 */
+    tad_pcap_replay_addr    new_addr[2];    /**< New addresses */
+    int32_t                 new_port[2];    /**< New ports or @c -1 */
+} tad_pcap_replay_rewrite;
+
+/** Interface of a pcapng file */
+typedef struct tad_pcap_replay_iface {
+    uint16_t        linktype;   /**< Link type */
+    te_bool         binary;     /**< Timestamp resolution is a power
+                                     of 2 rather than of 10 */
+    unsigned int    exp;        /**< Timestamp resolution exponent */
+} tad_pcap_replay_iface;
+
+/** Replay specification prepared from a template */
+typedef struct tad_pcap_replay {
+    char                   *file;       /**< Capture file name */
+    void                   *map;        /**< Mapped capture file */
+    size_t                  map_len;    /**< Length of the mapping */
+    te_vec                  pkts;       /**< Index of packets
+                                             (tad_pcap_replay_pkt) */
+    uint64_t                period;     /**< Period of loops in original
+                                             timing, nanoseconds */
+    ndn_pcap_replay_timing  timing;     /**< Requested timing */
+    unsigned int            speed;      /**< Speed in percents of
+                                             the original one */
+    unsigned int            loops;      /**< Number of loops or @c 0 */
+    unsigned int            batch;      /**< Maximum number of packets
+                                             passed to the media at once */
+    te_vec                  rewrite;    /**< Rewriting rules
+                                             (tad_pcap_replay_rewrite) */
+} tad_pcap_replay;
+
+
+/** Read 16-bit value from a capture file */
+static inline uint16_t
+tad_pcap_replay_rd16(const uint8_t *p, te_bool swap)
+{
+    uint16_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return swap ? __builtin_bswap16(v) : v;
+}
+
+/** Read 32-bit value from a capture file */
+static inline uint32_t
+tad_pcap_replay_rd32(const uint8_t *p, te_bool swap)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return swap ? __builtin_bswap32(v) : v;
+}
+
+/** Get current time of the monotonic clock in nanoseconds */
+static uint64_t
+tad_pcap_replay_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Add a packet to the index of a capture file.
+ *
+ * @param replay        Replay specification
+ * @param data          Frame data
+ * @param len           Captured length
+ * @param ts            Timestamp in nanoseconds
+ */
+static void
+tad_pcap_replay_add_pkt(tad_pcap_replay *replay, uint8_t *data,
+                        uint32_t len, uint64_t ts)
+{
+    tad_pcap_replay_pkt pkt = { .data = data, .len = len, .ts = ts };
+
+    TE_VEC_APPEND(&replay->pkts, pkt);
+}
+
+/**
+ * Index packets of a classic pcap file.
+ *
+ * @param replay        Replay specification with mapped file
+ * @param swap          Whether byte order of the file is not native
+ * @param nsec          Whether timestamps are in nanoseconds
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_pcap_replay_index_pcap(tad_pcap_replay *replay, te_bool swap,
+                           te_bool nsec)
+{
+    uint8_t    *p = replay->map;
+    size_t      off = 24;
+    uint32_t    linktype;
+    uint32_t    caplen;
+    uint64_t    ts;
+
+    if (replay->map_len < off)
+    {
+        ERROR("Capture file '%s' is truncated", replay->file);
+        return TE_RC(TE_TAD_CSAP, TE_EPROTO);
+    }
+
+    /* Upper bits may carry FCS length */
+    linktype = tad_pcap_replay_rd32(p + 20, swap) & 0x0fffffff;
+    if (linktype != TAD_PCAP_REPLAY_LINKTYPE_ETHERNET)
+    {
+        ERROR("Capture file '%s' has unsupported link type %u",
+              replay->file, linktype);
+        return TE_RC(TE_TAD_CSAP, TE_EOPNOTSUPP);
+    }
+
+    while (off + 16 <= replay->map_len)
+    {
+        ts = (uint64_t)tad_pcap_replay_rd32(p + off, swap) * 1000000000 +
+             (uint64_t)tad_pcap_replay_rd32(p + off + 4, swap) *
+             (nsec ? 1 : 1000);
+        caplen = tad_pcap_replay_rd32(p + off + 8, swap);
+        if (caplen > replay->map_len - off - 16)
+            break;
+
+        tad_pcap_replay_add_pkt(replay, p + off + 16, caplen, ts);
+        off += 16 + caplen;
+    }
+
+    if (off != replay->map_len)
+        WARN("Capture file '%s' is truncated, %zu bytes are ignored",
+             replay->file, replay->map_len - off);
+
+    return 0;
+}
+
+/**
+ * Convert timestamp of a pcapng packet to nanoseconds.
+ *
+ * @param iface         Interface the packet is captured on
+ * @param ts            Timestamp in units of the interface
+ *
+ * @return Timestamp in nanoseconds.
+ */
+static uint64_t
+tad_pcap_replay_pcapng_ts(const tad_pcap_replay_iface *iface, uint64_t ts)
+{
+    uint64_t        mult = 1;
+    uint64_t        frac;
+    unsigned int    i;
+
+    if (iface->binary)
+    {
+        frac = ts & ((UINT64_C(1) << iface->exp) - 1);
+        ts >>= iface->exp;
+
+        /*
+         * Fraction multiplied by 10^9 does not fit in 64 bits if it
+         * has more than 34 bits, so it is multiplied by halves:
+         * (hi * 2^32 + lo) * 10^9 / 2^exp =
+         * (hi * 10^9 + lo * 10^9 / 2^32) / 2^(exp - 32).
+         */
+        if (iface->exp > 32)
+        {
+            return ts * 1000000000 +
+                   (((frac >> 32) * 1000000000 +
+                     (((frac & UINT32_MAX) * 1000000000) >> 32)) >>
+                    (iface->exp - 32));
+        }
+
+        return ts * 1000000000 + ((frac * 1000000000) >> iface->exp);
+    }
+
+    for (i = 0; i < (iface->exp > 9 ? iface->exp - 9 : 9 - iface->exp); i++)
+        mult *= 10;
+
+    return iface->exp > 9 ? ts / mult : ts * mult;
+}
+
+/**
+ * Get interface description from pcapng interface description block.
+ *
+ * @param body          Block body
+ * @param len           Length of the block body
+ * @param swap          Whether byte order of the section is not native
+ * @param iface         Location for the interface description
+ */
+static void
+tad_pcap_replay_pcapng_idb(const uint8_t *body, size_t len, te_bool swap,
+                           tad_pcap_replay_iface *iface)
+{
+    size_t      off = 8;
+    uint16_t    code;
+    uint16_t    opt_len;
+
+    iface->linktype = len >= 2 ? tad_pcap_replay_rd16(body, swap) : 0;
+    /* Microseconds by default */
+    iface->binary = FALSE;
+    iface->exp = 6;
+
+    while (off + 4 <= len)
+    {
+        code = tad_pcap_replay_rd16(body + off, swap);
+        opt_len = tad_pcap_replay_rd16(body + off + 2, swap);
+        if (code == 0 || off + 4 + opt_len > len)
+            break;
+
+        if (code == TAD_PCAP_REPLAY_PCAPNG_IF_TSRESOL && opt_len >= 1)
+        {
+            iface->binary = (body[off + 4] & 0x80) != 0;
+            iface->exp = body[off + 4] & 0x7f;
+            if ((iface->binary && iface->exp >= 64) ||
+                (!iface->binary && iface->exp > 18))
+            {
+                WARN("Unsupported timestamp resolution 0x%x, "
+                     "microseconds are assumed", body[off + 4]);
+                iface->binary = FALSE;
+                iface->exp = 6;
+            }
+        }
+
+        off += 4 + TE_ALIGN(opt_len, 4);
+    }
+}
+
+/**
+ * Index packets of a pcapng file. Enhanced and simple packet blocks
+ * are replayed, other blocks are skipped. Packets captured on
+ * interfaces with link type other than Ethernet are skipped.
+ *
+ * @param replay        Replay specification with mapped file
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_pcap_replay_index_pcapng(tad_pcap_replay *replay)
+{
+    te_vec                      ifaces = TE_VEC_INIT(tad_pcap_replay_iface);
+    const tad_pcap_replay_iface *iface;
+    tad_pcap_replay_iface       new_iface;
+    uint8_t                    *p = replay->map;
+    uint8_t                    *body;
+    size_t                      off = 0;
+    size_t                      body_len;
+    te_bool                     swap = FALSE;
+    uint32_t                    type;
+    uint32_t                    len;
+    uint32_t                    ifid;
+    uint32_t                    caplen;
+    uint64_t                    ts = 0;
+    unsigned int                skipped = 0;
+    te_errno                    rc = 0;
+
+    while (off + 12 <= replay->map_len)
+    {
+        type = tad_pcap_replay_rd32(p + off, swap);
+        if (type == TAD_PCAP_REPLAY_PCAPNG_SHB)
+        {
+            /* New section may have another byte order and interfaces */
+            swap = (tad_pcap_replay_rd32(p + off + 8, FALSE) !=
+                    TAD_PCAP_REPLAY_PCAPNG_BOM);
+            if (swap && tad_pcap_replay_rd32(p + off + 8, TRUE) !=
+                            TAD_PCAP_REPLAY_PCAPNG_BOM)
+            {
+                ERROR("Capture file '%s' has invalid section header "
+                      "at offset %zu", replay->file, off);
+                rc = TE_RC(TE_TAD_CSAP, TE_EPROTO);
+                break;
+            }
+            te_vec_reset(&ifaces);
+        }
+
+        len = tad_pcap_replay_rd32(p + off + 4, swap);
+        if (len < 12 || len % 4 != 0 || len > replay->map_len - off)
+        {
+            WARN("Capture file '%s' is truncated or corrupted "
+                 "at offset %zu", replay->file, off);
+            break;
+        }
+
+        body = p + off + 8;
+        body_len = len - 12;
+
+        switch (type)
+        {
+            case TAD_PCAP_REPLAY_PCAPNG_IDB:
+                tad_pcap_replay_pcapng_idb(body, body_len, swap,
+                                           &new_iface);
+                TE_VEC_APPEND(&ifaces, new_iface);
+                break;
+
+            case TAD_PCAP_REPLAY_PCAPNG_EPB:
+                if (body_len < 20)
+                    break;
+
+                ifid = tad_pcap_replay_rd32(body, swap);
+                caplen = tad_pcap_replay_rd32(body + 12, swap);
+                if (ifid >= te_vec_size(&ifaces) ||
+                    caplen > body_len - 20)
+                {
+                    skipped++;
+                    break;
+                }
+
+                iface = te_vec_get(&ifaces, ifid);
+                if (iface->linktype != TAD_PCAP_REPLAY_LINKTYPE_ETHERNET)
+                {
+                    skipped++;
+                    break;
+                }
+
+                ts = tad_pcap_replay_pcapng_ts(iface,
+                        ((uint64_t)tad_pcap_replay_rd32(body + 4, swap) << 32) |
+                        tad_pcap_replay_rd32(body + 8, swap));
+                tad_pcap_replay_add_pkt(replay, body + 20, caplen, ts);
+                break;
+
+            case TAD_PCAP_REPLAY_PCAPNG_SPB:
+                if (body_len < 4 || te_vec_size(&ifaces) == 0 ||
+                    TE_VEC_GET(tad_pcap_replay_iface, &ifaces, 0).linktype !=
+                        TAD_PCAP_REPLAY_LINKTYPE_ETHERNET)
+                {
+                    skipped++;
+                    break;
+                }
+
+                /* No timestamp, the packet is sent just after previous */
+                caplen = MIN(tad_pcap_replay_rd32(body, swap), body_len - 4);
+                tad_pcap_replay_add_pkt(replay, body + 4, caplen, ts);
+                break;
+
+            default:
+                break;
+        }
+
+        off += len;
+    }
+
+    if (skipped > 0)
+        WARN("%u packets of capture file '%s' are not replayed since "
+             "they are malformed or not Ethernet frames",
+             skipped, replay->file);
+
+    te_vec_free(&ifaces);
+
+    return rc;
+}
+
+/**
+ * Map a capture file and index packets in it.
+ *
+ * @param replay        Replay specification with file name
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_pcap_replay_load(tad_pcap_replay *replay)
+{
+    struct stat             st;
+    uint32_t                magic;
+    tad_pcap_replay_pkt    *pkt;
+    uint64_t                first;
+    uint64_t                prev;
+    size_t                  n;
+    int                     fd;
+    te_errno                rc;
+
+    fd = open(replay->file, O_RDONLY);
+    if (fd < 0)
+    {
+        rc = TE_OS_RC(TE_TAD_CSAP, errno);
+        ERROR("Failed to open capture file '%s': %r", replay->file, rc);
+        return rc;
+    }
+
+    if (fstat(fd, &st) != 0)
+    {
+        rc = TE_OS_RC(TE_TAD_CSAP, errno);
+        ERROR("Failed to get size of capture file '%s': %r",
+              replay->file, rc);
+        close(fd);
+        return rc;
+    }
+
+    if (st.st_size < (off_t)sizeof(magic))
+    {
+        ERROR("Capture file '%s' is too short", replay->file);
+        close(fd);
+        return TE_RC(TE_TAD_CSAP, TE_EPROTO);
+    }
+
+    /* Private writable mapping allows to rewrite packets in place */
+    replay->map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fd, 0);
+    rc = (replay->map == MAP_FAILED) ? TE_OS_RC(TE_TAD_CSAP, errno) : 0;
+    close(fd);
+    if (rc != 0)
+    {
+        replay->map = NULL;
+        ERROR("Failed to map capture file '%s': %r", replay->file, rc);
+        return rc;
+    }
+    replay->map_len = st.st_size;
+
+    magic = tad_pcap_replay_rd32(replay->map, FALSE);
+    if (magic == TAD_PCAP_REPLAY_MAGIC_US)
+        rc = tad_pcap_replay_index_pcap(replay, FALSE, FALSE);
+    else if (magic == __builtin_bswap32(TAD_PCAP_REPLAY_MAGIC_US))
+        rc = tad_pcap_replay_index_pcap(replay, TRUE, FALSE);
+    else if (magic == TAD_PCAP_REPLAY_MAGIC_NS)
+        rc = tad_pcap_replay_index_pcap(replay, FALSE, TRUE);
+    else if (magic == __builtin_bswap32(TAD_PCAP_REPLAY_MAGIC_NS))
+        rc = tad_pcap_replay_index_pcap(replay, TRUE, TRUE);
+    else if (magic == TAD_PCAP_REPLAY_PCAPNG_SHB)
+        rc = tad_pcap_replay_index_pcapng(replay);
+    else
+    {
+        ERROR("Unknown format of capture file '%s'", replay->file);
+        rc = TE_RC(TE_TAD_CSAP, TE_EPROTO);
+    }
+    if (rc != 0)
+        return rc;
+
+    n = te_vec_size(&replay->pkts);
+    if (n == 0)
+    {
+        ERROR("No packets to replay in capture file '%s'", replay->file);
+        return TE_RC(TE_TAD_CSAP, TE_ENODATA);
+    }
+
+    /*
+     * Make timestamps relative to the first packet and do not allow
+     * them to go back to keep the schedule monotonic.
+     */
+    first = TE_VEC_GET(tad_pcap_replay_pkt, &replay->pkts, 0).ts;
+    prev = 0;
+    TE_VEC_FOREACH(&replay->pkts, pkt)
+    {
+        pkt->ts = (pkt->ts > first) ? pkt->ts - first : 0;
+        if (pkt->ts < prev)
+            pkt->ts = prev;
+        prev = pkt->ts;
+    }
+
+    /* The next loop starts after average gap between packets */
+    replay->period = (n > 1) ? prev + prev / (n - 1) : 0;
+
+    INFO("Capture file '%s' with %zu packets is prepared for replay",
+         replay->file, n);
+
+    return 0;
+}
+
+/**
+ * Update checksum field in accordance with change of data covered
+ * by it (see RFC 1624).
+ *
+ * @param csum          Checksum field
+ * @param old           Old data
+ * @param new           New data
+ * @param len           Length of data (even)
+ * @param udp           Whether the checksum is UDP one, i.e. zero
+ *                      means no checksum
+ */
+static void
+tad_pcap_replay_csum_update(uint8_t *csum, const uint8_t *old,
+                            const uint8_t *new, size_t len, te_bool udp)
+{
+    uint16_t    value;
+    uint16_t    word;
+    uint32_t    sum;
+    size_t      i;
+
+    memcpy(&value, csum, sizeof(value));
+    if (udp && value == 0)
+        return;
+
+    sum = (uint16_t)~value;
+    for (i = 0; i + 1 < len; i += 2)
+    {
+        memcpy(&word, old + i, sizeof(word));
+        sum += (uint16_t)~word;
+        memcpy(&word, new + i, sizeof(word));
+        sum += word;
+    }
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    value = ~sum;
+    if (udp && value == 0)
+        value = 0xffff;
+    memcpy(csum, &value, sizeof(value));
+}
+
+/**
+ * Replace a field of a packet and update checksums covering it.
+ *
+ * @param field         Field to replace
+ * @param value         New value
+ * @param len           Length of the field
+ * @param ip_csum       IPv4 header checksum to update or @c NULL
+ * @param l4_csum       TCP/UDP checksum to update or @c NULL
+ * @param udp           Whether @p l4_csum is UDP checksum
+ */
+static void
+tad_pcap_replay_set_field(uint8_t *field, const uint8_t *value,
+                          size_t len, uint8_t *ip_csum, uint8_t *l4_csum,
+                          te_bool udp)
+{
+    uint8_t old[16];
+
+    memcpy(old, field, len);
+    memcpy(field, value, len);
+
+    if (ip_csum != NULL)
+        tad_pcap_replay_csum_update(ip_csum, old, value, len, FALSE);
+    if (l4_csum != NULL)
+        tad_pcap_replay_csum_update(l4_csum, old, value, len, udp);
+}
+
+/**
+ * Apply the first matching rewriting rule to a packet.
+ *
+ * Ethernet frames with up to two VLAN tags carrying IPv4 or IPv6
+ * (without extension headers) are supported. Ports are rewritten in
+ * TCP and UDP headers of non-fragmented packets and first fragments.
+ *
+ * @param replay        Replay specification
+ * @param pkt           Packet
+ *
+ * @return @c TRUE if the packet is modified.
+ */
+static te_bool
+tad_pcap_replay_rewrite_pkt(const tad_pcap_replay *replay,
+                            tad_pcap_replay_pkt *pkt)
+{
+    const tad_pcap_replay_rewrite  *rule;
+    uint8_t        *data = pkt->data;
+    size_t          off = 14;
+    size_t          l4_off;
+    size_t          addr_len;
+    uint16_t        ethertype;
+    uint8_t        *addr[2];
+    uint8_t        *port[2] = { NULL, NULL };
+    uint8_t        *ip_csum = NULL;
+    uint8_t        *l4_csum = NULL;
+    uint8_t         proto;
+    te_bool         udp = FALSE;
+    te_bool         match;
+    uint16_t        new_port;
+    unsigned int    i;
+
+    if (pkt->len < off)
+        return FALSE;
+
+    ethertype = tad_pcap_replay_rd16(data + 12, FALSE);
+    while ((ethertype == htons(0x8100) || ethertype == htons(0x88a8)) &&
+           pkt->len >= off + 4)
+    {
+        ethertype = tad_pcap_replay_rd16(data + off + 2, FALSE);
+        off += 4;
+    }
+
+    if (ethertype == htons(0x0800) && pkt->len >= off + 20)
+    {
+        addr_len = 4;
+        addr[TAD_PCAP_REPLAY_SRC] = data + off + 12;
+        addr[TAD_PCAP_REPLAY_DST] = data + off + 16;
+        ip_csum = data + off + 10;
+        proto = data[off + 9];
+        l4_off = off + (data[off] & 0x0f) * 4;
+        /* Fragment offset must be zero to have L4 header */
+        if ((data[off] & 0x0f) < 5 ||
+            (tad_pcap_replay_rd16(data + off + 6, FALSE) &
+             htons(0x1fff)) != 0)
+            proto = 0;
+    }
+    else if (ethertype == htons(0x86dd) && pkt->len >= off + 40)
+    {
+        addr_len = 16;
+        addr[TAD_PCAP_REPLAY_SRC] = data + off + 8;
+        addr[TAD_PCAP_REPLAY_DST] = data + off + 24;
+        proto = data[off + 6];
+        l4_off = off + 40;
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    if (proto == IPPROTO_TCP && pkt->len >= l4_off + 18)
+    {
+        l4_csum = data + l4_off + 16;
+    }
+    else if (proto == IPPROTO_UDP && pkt->len >= l4_off + 8)
+    {
+        l4_csum = data + l4_off + 6;
+        udp = TRUE;
+    }
+    if (l4_csum != NULL)
+    {
+        port[TAD_PCAP_REPLAY_SRC] = data + l4_off;
+        port[TAD_PCAP_REPLAY_DST] = data + l4_off + 2;
+    }
+
+    TE_VEC_FOREACH(&replay->rewrite, rule)
+    {
+        match = TRUE;
+        for (i = 0; match && i < TE_ARRAY_LEN(addr); i++)
+        {
+            if ((rule->match_addr[i].len != 0 &&
+                 (rule->match_addr[i].len != addr_len ||
+                  memcmp(rule->match_addr[i].addr, addr[i],
+                         addr_len) != 0)) ||
+                (rule->new_addr[i].len != 0 &&
+                 rule->new_addr[i].len != addr_len) ||
+                ((rule->match_port[i] >= 0 || rule->new_port[i] >= 0) &&
+                 port[i] == NULL) ||
+                (rule->match_port[i] >= 0 &&
+                 tad_pcap_replay_rd16(port[i], FALSE) !=
+                     htons(rule->match_port[i])))
+                match = FALSE;
+        }
+        if (!match)
+            continue;
+
+        for (i = 0; i < TE_ARRAY_LEN(addr); i++)
+        {
+            /* Pseudo-header of TCP/UDP includes addresses */
+            if (rule->new_addr[i].len != 0)
+                tad_pcap_replay_set_field(addr[i], rule->new_addr[i].addr,
+                                          addr_len, ip_csum, l4_csum, udp);
+            if (rule->new_port[i] >= 0)
+            {
+                new_port = htons(rule->new_port[i]);
+                tad_pcap_replay_set_field(port[i], (uint8_t *)&new_port,
+                                          sizeof(new_port), NULL,
+                                          l4_csum, udp);
+            }
+        }
+
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * Read an address of a rewriting rule.
+ *
+ * @param rule_spec     ASN.1 value with rewriting rule
+ * @param label         Label of the address
+ * @param addr          Location for the address
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_pcap_replay_read_addr(const asn_value *rule_spec, const char *label,
+                          tad_pcap_replay_addr *addr)
+{
+    int         len = asn_get_length(rule_spec, label);
+    size_t      val_len;
+    te_errno    rc;
+
+    addr->len = 0;
+    if (len < 0)
+        return 0;
+
+    if (len != 4 && len != 16)
+    {
+        ERROR("Invalid length %d of '%s' in PCAP rewriting rule",
+              len, label);
+        return TE_RC(TE_TAD_CSAP, TE_EINVAL);
+    }
+
+    val_len = len;
+    rc = asn_read_value_field(rule_spec, addr->addr, &val_len, label);
+    if (rc != 0)
+    {
+        ERROR("Failed to read '%s' of PCAP rewriting rule: %r", label, rc);
+        return TE_RC(TE_TAD_CSAP, rc);
+    }
+    addr->len = val_len;
+
+    return 0;
+}
+
+/**
+ * Read a port of a rewriting rule.
+ *
+ * @param rule_spec     ASN.1 value with rewriting rule
+ * @param label         Label of the port
+ * @param port          Location for the port or @c -1
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_pcap_replay_read_port(const asn_value *rule_spec, const char *label,
+                          int32_t *port)
+{
+    te_errno rc;
+
+    rc = asn_read_int32(rule_spec, port, label);
+    if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        *port = -1;
+        return 0;
+    }
+    if (rc != 0)
+    {
+        ERROR("Failed to read '%s' of PCAP rewriting rule: %r", label, rc);
+        return TE_RC(TE_TAD_CSAP, rc);
+    }
+    if (*port < 0 || *port > UINT16_MAX)
+    {
+        ERROR("Invalid '%s' %d of PCAP rewriting rule", label, *port);
+        return TE_RC(TE_TAD_CSAP, TE_EINVAL);
+    }
+
+    return 0;
+}
+
+/**
+ * Read rewriting rules from replay specification.
+ *
+ * @param replay        Replay specification
+ * @param replay_spec   ASN.1 value with replay specification
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_pcap_replay_read_rewrite(tad_pcap_replay *replay,
+                             const asn_value *replay_spec)
+{
+    tad_pcap_replay_rewrite     rule;
+    asn_value                  *rule_spec;
+    int                         n = asn_get_length(replay_spec, "rewrite");
+    int                         i;
+    te_errno                    rc = 0;
+
+    for (i = 0; rc == 0 && i < n; i++)
+    {
+        rc = asn_get_indexed(replay_spec, &rule_spec, i, "rewrite");
+        if (rc != 0)
+        {
+            ERROR("Failed to get PCAP rewriting rule %d: %r", i, rc);
+            return TE_RC(TE_TAD_CSAP, rc);
+        }
+
+        if ((rc = tad_pcap_replay_read_addr(rule_spec, "src-addr",
+                      &rule.match_addr[TAD_PCAP_REPLAY_SRC])) != 0 ||
+            (rc = tad_pcap_replay_read_addr(rule_spec, "dst-addr",
+                      &rule.match_addr[TAD_PCAP_REPLAY_DST])) != 0 ||
+            (rc = tad_pcap_replay_read_addr(rule_spec, "new-src-addr",
+                      &rule.new_addr[TAD_PCAP_REPLAY_SRC])) != 0 ||
+            (rc = tad_pcap_replay_read_addr(rule_spec, "new-dst-addr",
+                      &rule.new_addr[TAD_PCAP_REPLAY_DST])) != 0 ||
+            (rc = tad_pcap_replay_read_port(rule_spec, "src-port",
+                      &rule.match_port[TAD_PCAP_REPLAY_SRC])) != 0 ||
+            (rc = tad_pcap_replay_read_port(rule_spec, "dst-port",
+                      &rule.match_port[TAD_PCAP_REPLAY_DST])) != 0 ||
+            (rc = tad_pcap_replay_read_port(rule_spec, "new-src-port",
+                      &rule.new_port[TAD_PCAP_REPLAY_SRC])) != 0 ||
+            (rc = tad_pcap_replay_read_port(rule_spec, "new-dst-port",
+                      &rule.new_port[TAD_PCAP_REPLAY_DST])) != 0)
+            break;
+
+        TE_VEC_APPEND(&replay->rewrite, rule);
+    }
+
+    return rc;
+}
+
+/**
+ * Read an optional non-negative integer of replay specification.
+ *
+ * @param replay_spec   ASN.1 value with replay specification
+ * @param label         Label of the field
+ * @param def           Default value
+ * @param value         Location for the value
+ *
+ * @return Status code.
+ */
+static te_errno
+tad_pcap_replay_read_uint(const asn_value *replay_spec, const char *label,
+                          unsigned int def, unsigned int *value)
+{
+    int32_t     i32;
+    te_errno    rc;
+
+    rc = asn_read_int32(replay_spec, &i32, label);
+    if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        *value = def;
+        return 0;
+    }
+    if (rc != 0)
+    {
+        ERROR("Failed to read '%s' of PCAP replay: %r", label, rc);
+        return TE_RC(TE_TAD_CSAP, rc);
+    }
+    if (i32 < 0)
+    {
+        ERROR("Invalid '%s' %d of PCAP replay", label, i32);
+        return TE_RC(TE_TAD_CSAP, TE_EINVAL);
+    }
+
+    *value = i32;
+    return 0;
+}
+
+/**
+ * Free replay specification.
+ *
+ * @param replay        Replay specification
+ */
+static void
+tad_pcap_replay_free(tad_pcap_replay *replay)
+{
+    if (replay == NULL)
+        return;
+
+    if (replay->map != NULL)
+        munmap(replay->map, replay->map_len);
+    te_vec_free(&replay->pkts);
+    te_vec_free(&replay->rewrite);
+    free(replay->file);
+    free(replay);
+}
+
+/* See description in tad_pcap_impl.h */
+te_errno
+tad_pcap_confirm_tmpl_cb(csap_p csap, unsigned int layer,
+                         asn_value *layer_pdu, void **p_opaque)
+{
+    tad_pcap_replay        *replay;
+    asn_value              *replay_spec;
+    tad_pcap_replay_pkt    *pkt;
+    int32_t                 i32;
+    unsigned int            rewritten = 0;
+    te_errno                rc;
+
+    UNUSED(layer);
+
+    rc = asn_get_subvalue(layer_pdu, &replay_spec, "replay");
+    if (rc != 0)
+    {
+        ERROR(CSAP_LOG_FMT "PCAP CSAP may send traffic by replay "
+              "of a capture file only", CSAP_LOG_ARGS(csap));
+        return TE_RC(TE_TAD_CSAP, TE_EOPNOTSUPP);
+    }
+
+    replay = TE_ALLOC(sizeof(*replay));
+    replay->pkts = TE_VEC_INIT(tad_pcap_replay_pkt);
+    replay->rewrite = TE_VEC_INIT(tad_pcap_replay_rewrite);
+
+    rc = asn_read_string(replay_spec, &replay->file, "file");
+    if (rc != 0)
+    {
+        ERROR(CSAP_LOG_FMT "Capture file to replay is not specified: %r",
+              CSAP_LOG_ARGS(csap), rc);
+        rc = TE_RC(TE_TAD_CSAP, rc);
+        goto fail;
+    }
+
+    rc = asn_read_int32(replay_spec, &i32, "timing");
+    if (rc == 0)
+    {
+        replay->timing = i32;
+    }
+    else if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        replay->timing = NDN_PCAP_REPLAY_ORIGINAL;
+    }
+    else
+    {
+        ERROR(CSAP_LOG_FMT "Failed to read replay timing: %r",
+              CSAP_LOG_ARGS(csap), rc);
+        rc = TE_RC(TE_TAD_CSAP, rc);
+        goto fail;
+    }
+
+    if ((rc = tad_pcap_replay_read_uint(replay_spec, "speed", 100,
+                                        &replay->speed)) != 0 ||
+        (rc = tad_pcap_replay_read_uint(replay_spec, "loops", 1,
+                                        &replay->loops)) != 0 ||
+        (rc = tad_pcap_replay_read_uint(replay_spec, "batch",
+                                        TAD_PCAP_REPLAY_BATCH_DEF,
+                                        &replay->batch)) != 0 ||
+        (rc = tad_pcap_replay_read_rewrite(replay, replay_spec)) != 0)
+        goto fail;
+
+    if (replay->timing == NDN_PCAP_REPLAY_ORIGINAL)
+        replay->speed = 100;
+    if (replay->speed == 0)
+    {
+        ERROR(CSAP_LOG_FMT "Replay speed must be positive",
+              CSAP_LOG_ARGS(csap));
+        rc = TE_RC(TE_TAD_CSAP, TE_EINVAL);
+        goto fail;
+    }
+    replay->batch = MIN(MAX(replay->batch, 1), TAD_PCAP_REPLAY_BATCH_MAX);
+
+    rc = tad_pcap_replay_load(replay);
+    if (rc != 0)
+        goto fail;
+
+    /* Rewrite packets once rather than on each send */
+    if (te_vec_size(&replay->rewrite) > 0)
+    {
+        TE_VEC_FOREACH(&replay->pkts, pkt)
+        {
+            if (tad_pcap_replay_rewrite_pkt(replay, pkt))
+                rewritten++;
+        }
+        INFO(CSAP_LOG_FMT "%u packets of capture file '%s' are rewritten",
+             CSAP_LOG_ARGS(csap), rewritten, replay->file);
+    }
+
+    *p_opaque = replay;
+
+    return 0;
+
+fail:
+    tad_pcap_replay_free(replay);
+    return rc;
+}
+
+/* See description in tad_pcap_impl.h */
+void
+tad_pcap_release_tmpl_cb(csap_p csap, unsigned int layer, void *opaque)
+{
+    UNUSED(csap);
+    UNUSED(layer);
+
+    tad_pcap_replay_free(opaque);
+}
+
+/**
+ * Wait until the time when a packet is due. Waiting is interrupted
+ * periodically to allow the caller to check whether the CSAP is
+ * requested to stop.
+ *
+ * @param due           Time when the packet is due, nanoseconds
+ *
+ * @return Current time, nanoseconds.
+ */
+static uint64_t
+tad_pcap_replay_wait(uint64_t due)
+{
+    uint64_t        now = tad_pcap_replay_now();
+    uint64_t        until;
+    struct timespec ts;
+
+    if (now + TAD_PCAP_REPLAY_SPIN_NS < due)
+    {
+        until = MIN(due - TAD_PCAP_REPLAY_SPIN_NS,
+                    now + TAD_PCAP_REPLAY_SLEEP_MAX_NS);
+        ts.tv_sec = until / 1000000000;
+        ts.tv_nsec = until % 1000000000;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        return tad_pcap_replay_now();
+    }
+
+    while (now < due)
+        now = tad_pcap_replay_now();
+
+    return now;
+}
+
+/* See description in tad_pcap_impl.h */
+te_errno
+tad_pcap_replay_cb(csap_p csap, void *opaque)
+{
+    tad_pcap_rw_data           *spec_data = csap_get_rw_data(csap);
+    tad_pcap_replay            *replay = opaque;
+    tad_pcap_replay_stats      *stats;
+    const tad_pcap_replay_pkt  *pkts;
+    struct iovec                frames[TAD_PCAP_REPLAY_BATCH_MAX];
+    te_bool                     timed;
+    size_t                      n_pkts;
+    size_t                      i;
+    unsigned int                n;
+    unsigned int                sent = 0;
+    unsigned int                loop;
+    uint64_t                    start;
+    uint64_t                    now;
+    uint64_t                    offset;
+    uint64_t                    due = 0;
+    uint64_t                    sched = 0;
+    te_errno                    rc = 0;
+
+    if (replay == NULL)
+    {
+        ERROR(CSAP_LOG_FMT "Nothing to replay", CSAP_LOG_ARGS(csap));
+        return TE_RC(TE_TAD_CSAP, TE_EINVAL);
+    }
+
+    stats = &spec_data->replay_stats;
+    memset(stats, 0, sizeof(*stats));
+
+    pkts = te_vec_get(&replay->pkts, 0);
+    n_pkts = te_vec_size(&replay->pkts);
+    timed = (replay->timing != NDN_PCAP_REPLAY_MAX_RATE);
+
+    start = tad_pcap_replay_now();
+    now = start;
+
+    for (loop = 0; replay->loops == 0 || loop < replay->loops; loop++)
+    {
+        offset = loop * replay->period;
+
+        for (i = 0; i < n_pkts; i += sent)
+        {
+            if (csap->state & CSAP_STATE_STOP)
+            {
+                INFO(CSAP_LOG_FMT "Replay terminated", CSAP_LOG_ARGS(csap));
+                rc = TE_RC(TE_TAD_CH, TE_EINTR);
+                goto exit;
+            }
+
+            if (timed)
+            {
+                due = start + (offset + pkts[i].ts) * 100 / replay->speed;
+                if (now < due)
+                {
+                    now = tad_pcap_replay_wait(due);
+                    if (now < due)
+                    {
+                        /* Interrupted to check for stop */
+                        sent = 0;
+                        continue;
+                    }
+                }
+                stats->max_lag_ns = MAX(stats->max_lag_ns, now - due);
+            }
+
+            /* Pass all packets which are already due at once */
+            for (n = 0; n < replay->batch && i + n < n_pkts; n++)
+            {
+                if (timed && n > 0 &&
+                    start + (offset + pkts[i + n].ts) * 100 /
+                    replay->speed > now)
+                    break;
+
+                frames[n].iov_base = pkts[i + n].data;
+                frames[n].iov_len = pkts[i + n].len;
+                stats->bytes += pkts[i + n].len;
+            }
+
+            rc = tad_eth_sap_send_batch(&spec_data->sap, frames, n, &sent);
+            if (sent < n)
+            {
+                for (; n > sent; n--)
+                    stats->bytes -= pkts[i + n - 1].len;
+            }
+
+            if (sent > 0)
+            {
+                now = tad_pcap_replay_now();
+                sched = timed ? (offset + pkts[i + sent - 1].ts) * 100 /
+                                replay->speed : 0;
+                stats->pkts += sent;
+                stats->requested_ns = sched;
+                stats->duration_ns = now - start;
+                tad_send_account(csap, sent);
+            }
+
+            if (rc != 0)
+            {
+                ERROR(CSAP_LOG_FMT "Failed to send packets of capture "
+                      "file '%s': %r", CSAP_LOG_ARGS(csap), replay->file,
+                      rc);
+                goto exit;
+            }
+        }
+
+        stats->loops++;
+    }
+
+exit:
+    INFO(CSAP_LOG_FMT "Replayed %" PRIu64 " packets (%" PRIu64 " bytes) "
+         "in %" PRIu64 " ns, requested %" PRIu64 " ns",
+         CSAP_LOG_ARGS(csap), stats->pkts, stats->bytes,
+         stats->duration_ns, stats->requested_ns);
+
+    return rc;
+}
@@ -18,9 +18,13 @@
 #if HAVE_ASSERT_H
 #include <assert.h>
 #endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
 
 #include "te_errno.h"
 #include "te_alloc.h"
+#include "te_string.h"
 #include "tad_common.h"
 #include "logger_api.h"
 #include "asn_usr.h"
@@ -29,13 +33,27 @@
 #include "tad_pcap_impl.h"
 
 
-/** Ethernet layer read/write specific data */
-typedef struct tad_pcap_rw_data {
-    tad_eth_sap     sap;        /**< Ethernet service access point */
-    unsigned int    recv_mode;  /**< Default receive mode */
-} tad_pcap_rw_data;
+/* See description tad_pcap_impl.h */
+te_errno
+tad_pcap_prepare_send(csap_p csap)
+{
+    tad_pcap_rw_data *spec_data = csap_get_rw_data(csap);
 
+    assert(spec_data != NULL);
 
+    return tad_eth_sap_send_open(&spec_data->sap, 0);
+}
+
+/* See description tad_pcap_impl.h */
+te_errno
+tad_pcap_shutdown_send(csap_p csap)
+{
+    tad_pcap_rw_data *spec_data = csap_get_rw_data(csap);
+
+    assert(spec_data != NULL);
+
+    return tad_eth_sap_send_close(&spec_data->sap);
+}
 
 /* See description tad_pcap_impl.h */
 te_errno
@@ -121,6 +139,30 @@ tad_pcap_rw_init_cb(csap_p csap)
 }
 
 
+/* See description tad_pcap_impl.h */
+char *
+tad_pcap_get_param_cb(csap_p csap, unsigned int layer, const char *param)
+{
+    tad_pcap_rw_data       *spec_data = csap_get_rw_data(csap);
+    tad_pcap_replay_stats  *stats;
+
+    UNUSED(layer);
+
+    if (spec_data == NULL ||
+        strcmp(param, CSAP_PARAM_REPLAY_STATS) != 0)
+        return NULL;
+
+    stats = &spec_data->replay_stats;
+
+    return te_string_fmt("pkts=%" PRIu64 ":bytes=%" PRIu64
+                         ":loops=%" PRIu64 ":requested_ns=%" PRIu64
+                         ":duration_ns=%" PRIu64 ":max_lag_ns=%" PRIu64,
+                         stats->pkts, stats->bytes, stats->loops,
+                         stats->requested_ns, stats->duration_ns,
+                         stats->max_lag_ns);
+}
+
+
 /* See description tad_pcap_impl.h */
 te_errno
 tad_pcap_rw_destroy_cb(csap_p csap)
@@ -322,6 +322,38 @@ tad_csap_create(const char *stack, const char *spec_str, csap_p *new_csap_p)
         goto exit;
     }
 
+    /* 'recv-queue-limit' parameter processing */
+    rc = asn_read_int32(new_csap->nds, &i32_tmp, "params.recv-queue-limit");
+    if (rc == 0)
+    {
+        new_csap->recv_queue_limit = MAX(i32_tmp, 0);
+    }
+    else if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        /* Unspecified, the queue is not limited */
+    }
+    else
+    {
+        ERROR("Failed to read 'recv-queue-limit' from CSAP NDS: %r", rc);
+        goto exit;
+    }
+
+    /* 'recv-queue-policy' parameter processing */
+    rc = asn_read_int32(new_csap->nds, &i32_tmp, "params.recv-queue-policy");
+    if (rc == 0)
+    {
+        new_csap->recv_queue_policy = i32_tmp;
+    }
+    else if (TE_RC_GET_ERROR(rc) == TE_EASNINCOMPLVAL)
+    {
+        new_csap->recv_queue_policy = NDN_CSAP_RECV_QUEUE_DROP_OLDEST;
+    }
+    else
+    {
+        ERROR("Failed to read 'recv-queue-policy' from CSAP NDS: %r", rc);
+        goto exit;
+    }
+
     /* Get layers specification */
     rc = asn_get_child_value(new_csap->nds, &csap_layers,
                              PRIVATE, NDN_CSAP_LAYERS);
@@ -1274,6 +1306,26 @@ rcf_ch_csap_param(struct rcf_comm_connection *rcfc,
              no_match_pkts);
         SEND_ANSWER("0 %u", no_match_pkts);
     }
+    else if (strcmp(param, CSAP_PARAM_RECV_STATS) == 0)
+    {
+        tad_recv_context   *ctx = csap_get_recv_context(csap);
+        unsigned int        queue_len;
+        unsigned int        queue_max;
+        unsigned int        queue_drops;
+
+        CSAP_LOCK(csap);
+        queue_len = ctx->queue_len;
+        queue_max = ctx->queue_max;
+        queue_drops = ctx->queue_drops;
+        CSAP_UNLOCK(csap);
+
+        SEND_ANSWER("0 matched=%u:unmatched=%u:bytes=%" PRIu64
+                    ":match_ns=%" PRIu64 ":media_drops=%" PRIu64
+                    ":queued=%u:queue_max=%u:queue_drops=%u",
+                    ctx->match_pkts, ctx->no_match_pkts, ctx->bytes,
+                    ctx->match_ns, ctx->media_drops,
+                    queue_len, queue_max, queue_drops);
+    }
     else if (strcmp(param, CSAP_PARAM_FIRST_PACKET_TIME) == 0)
     {
         VERB("CSAP get_param, get first pkt, %u.%u\n",
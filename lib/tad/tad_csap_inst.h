@@ -169,6 +169,13 @@ typedef struct csap_instance {
                                                  latency of stop/destroy
                                                  operations) */
     unsigned int    recv_timeout;   /**< Default receive timeout */
+    unsigned int    recv_queue_limit;   /**< Maximum number of packets
+                                             in the queue of received
+                                             packets (0 - unlimited) */
+    unsigned int    recv_queue_policy;  /**< Policy applied when
+                                             the queue is full
+                                             (see enum
+                                             ndn_csap_recv_queue_policy) */
 
     struct timeval  wait_for;   /**< Zero or moment of timeout
                                      current CSAP operation */
@@ -295,6 +295,24 @@ typedef te_errno (*csap_read_cb_t)(csap_p csap, unsigned int timeout,
  */
 typedef te_errno (*csap_write_cb_t)(csap_p csap, const tad_pkt *pkt);
 
+/**
+ * Callback type to send traffic specified by a template unit without
+ * generation of packets by protocol layers. It is used by CSAPs which
+ * take packets from another source (e.g. a capture file) and control
+ * timing of them on their own.
+ *
+ * The callback should account sent packets using tad_send_account()
+ * and return @c TE_EINTR as soon as possible when the CSAP is requested
+ * to stop.
+ *
+ * @param csap          CSAP instance
+ * @param opaque        Opaque data prepared by confirm template callback
+ *                      of the read/write layer
+ *
+ * @return Status code.
+ */
+typedef te_errno (*csap_send_tmpl_cb_t)(csap_p csap, void *opaque);
+
 /**
  * Callback type to write data to media of CSAP and read
  *  data from media just after write, to get answer to sent request.
@@ -311,6 +329,18 @@ typedef te_errno (*csap_write_read_cb_t)(csap_p csap, unsigned int timeout,
                                          const tad_pkt *w_pkt,
                                          tad_pkt *r_pkt, size_t *r_pkt_len);
 
+/**
+ * Callback type to get number of packets dropped by media of the CSAP
+ * (for example, because of socket receive buffer overflow) since
+ * the previous call.
+ *
+ * @param csap          CSAP instance
+ * @param drops         Location for number of dropped packets
+ *
+ * @return Status code.
+ */
+typedef te_errno (*csap_recv_drops_cb_t)(csap_p csap, uint64_t *drops);
+
 
 /*=====================================================================
  * Structures for CSAP types support specifications.
@@ -385,10 +415,12 @@ typedef struct csap_spt_type_t {
     csap_low_resource_cb_t  prepare_send_cb;
     csap_write_cb_t         write_cb;
     csap_low_resource_cb_t  shutdown_send_cb;
+    csap_send_tmpl_cb_t     send_tmpl_cb;
 
     csap_low_resource_cb_t  prepare_recv_cb;
     csap_read_cb_t          read_cb;
     csap_low_resource_cb_t  shutdown_recv_cb;
+    csap_recv_drops_cb_t    recv_drops_cb;
 
     csap_write_read_cb_t    write_read_cb;
 
@@ -405,10 +437,12 @@ typedef struct csap_spt_type_t {
     .prepare_send_cb  = NULL,   \
     .write_cb         = NULL,   \
     .shutdown_send_cb = NULL,   \
+    .send_tmpl_cb     = NULL,   \
                                 \
     .prepare_recv_cb  = NULL,   \
     .read_cb          = NULL,   \
     .shutdown_recv_cb = NULL,   \
+    .recv_drops_cb    = NULL,   \
                                 \
     .write_read_cb    = NULL
 
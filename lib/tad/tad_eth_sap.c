@@ -121,6 +121,8 @@ typedef struct tad_eth_sap_data {
     pcap_t         *out;        /**< Output handle (for send) */
     char            errbuf[PCAP_ERRBUF_SIZE]; /**< Error buffer for pcap
                                                    calls error messages */
+    unsigned int    recv_drops; /**< Number of dropped packets reported
+                                     by the previous pcap_stats() */
 #endif
     unsigned int    send_mode;  /**< Send mode */
     unsigned int    recv_mode;  /**< Receive mode */
@@ -685,6 +687,85 @@ tad_eth_sap_send(tad_eth_sap *sap, const tad_pkt *pkt)
     return 0;
 }
 
+/* See the description in tad_eth_sap.h */
+te_errno
+tad_eth_sap_send_batch(tad_eth_sap *sap, const struct iovec *frames,
+                       unsigned int n_frames, unsigned int *sent)
+{
+#if defined(USE_PF_PACKET) && defined(HAVE_SENDMMSG)
+    tad_eth_sap_data   *data;
+    struct mmsghdr      msgs[n_frames];
+    unsigned int        nobufs = 0;
+    unsigned int        i;
+    int                 ret_val;
+    te_errno            rc;
+
+    assert(sap != NULL);
+    data = sap->data;
+    assert(data != NULL);
+
+    *sent = 0;
+
+    if (data->out < 0)
+    {
+        ERROR("%s(): no output socket", __FUNCTION__);
+        return TE_RC(TE_TAD_CSAP, TE_EINVAL);
+    }
+
+    memset(msgs, 0, sizeof(msgs));
+    for (i = 0; i < n_frames; i++)
+    {
+        msgs[i].msg_hdr.msg_iov = (struct iovec *)&frames[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (*sent < n_frames)
+    {
+        ret_val = sendmmsg(data->out, msgs + *sent, n_frames - *sent, 0);
+        if (ret_val < 0)
+        {
+            rc = te_rc_os2te(errno);
+            if ((rc == TE_ENOBUFS || rc == TE_EAGAIN) &&
+                nobufs++ < TAD_WRITE_NOBUFS)
+            {
+                /* See tad_eth_sap_send() */
+                struct timeval clr_delay = { 0, rand() & 0x3f };
+
+                select(0, NULL, NULL, NULL, &clr_delay);
+                continue;
+            }
+
+            ERROR("%s(CSAP %d): sendmmsg() failed: %r",
+                  __FUNCTION__, sap->csap->id, rc);
+            return TE_RC(TE_TAD_CSAP, rc);
+        }
+        nobufs = 0;
+        *sent += ret_val;
+    }
+
+    return 0;
+#else
+    tad_pkt         pkt;
+    tad_pkt_seg     seg;
+    te_errno        rc;
+
+    /* Send frames one by one by the generic routine */
+    for (*sent = 0; *sent < n_frames; (*sent)++)
+    {
+        tad_pkt_init(&pkt, NULL, NULL, NULL);
+        tad_pkt_init_seg_data(&seg, frames[*sent].iov_base,
+                              frames[*sent].iov_len, NULL);
+        tad_pkt_append_seg(&pkt, &seg);
+
+        rc = tad_eth_sap_send(sap, &pkt);
+        if (rc != 0)
+            return rc;
+    }
+
+    return 0;
+#endif
+}
+
 /* See the description in tad_eth_sap.h */
 te_errno
 tad_eth_sap_send_close(tad_eth_sap *sap)
@@ -1135,6 +1216,7 @@ tad_eth_sap_recv_open(tad_eth_sap *sap, unsigned int mode)
               0, data->errbuf, rc);
         return rc;
     }
+    data->recv_drops = 0;
 #endif
 
     data->recv_mode = mode;
@@ -1386,6 +1468,51 @@ tad_eth_sap_recv(tad_eth_sap *sap, unsigned int timeout,
 #endif
 }
 
+/* See the description in tad_eth_sap.h */
+te_errno
+tad_eth_sap_recv_drops(tad_eth_sap *sap, uint64_t *drops)
+{
+    tad_eth_sap_data   *data;
+    te_errno            rc;
+#ifdef USE_PF_PACKET
+    struct tpacket_stats    stats;
+    socklen_t               len = sizeof(stats);
+#else
+    struct pcap_stat        stats;
+#endif
+
+    assert(sap != NULL);
+    data = sap->data;
+    assert(data != NULL);
+
+#ifdef USE_PF_PACKET
+    /* Kernel resets the statistics on read */
+    if (getsockopt(data->in, SOL_PACKET, PACKET_STATISTICS,
+                   &stats, &len) != 0)
+    {
+        rc = TE_OS_RC(TE_TAD_PF_PACKET, errno);
+        ERROR("%s(): getsockopt(PACKET_STATISTICS) failed: %r",
+              __FUNCTION__, rc);
+        return rc;
+    }
+
+    *drops = stats.tp_drops;
+#else
+    if (pcap_stats(data->in, &stats) != 0)
+    {
+        rc = TE_RC(TE_TAD_BPF, TE_EFAULT);
+        ERROR("%s(): pcap_stats() failed: %s", __FUNCTION__,
+              pcap_geterr(data->in));
+        return rc;
+    }
+
+    *drops = stats.ps_drop - data->recv_drops;
+    data->recv_drops = stats.ps_drop;
+#endif
+
+    return 0;
+}
+
 /* See the description in tad_eth_sap.h */
 te_errno
 tad_eth_sap_recv_close(tad_eth_sap *sap)
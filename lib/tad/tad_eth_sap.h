@@ -97,6 +97,25 @@ extern te_errno tad_eth_sap_send_open(tad_eth_sap  *sap,
  */
 extern te_errno tad_eth_sap_send(tad_eth_sap *sap, const tad_pkt *pkt);
 
+/**
+ * Send a batch of Ethernet frames using service access point opened
+ * for sending. Frames are passed to the kernel by one system call
+ * when it is supported.
+ *
+ * @param sap           SAP description structure
+ * @param frames        Frames to be sent (one element per frame)
+ * @param n_frames      Number of frames
+ * @param sent          Location for number of sent frames
+ *
+ * @return Status code.
+ *
+ * @sa tad_eth_sap_send()
+ */
+extern te_errno tad_eth_sap_send_batch(tad_eth_sap *sap,
+                                       const struct iovec *frames,
+                                       unsigned int n_frames,
+                                       unsigned int *sent);
+
 /**
  * Close Ethernet service access point for sending.
  *
@@ -138,6 +157,17 @@ extern te_errno tad_eth_sap_recv_open(tad_eth_sap  *sap,
 extern te_errno tad_eth_sap_recv(tad_eth_sap *sap, unsigned int timeout,
                                  tad_pkt *pkt, size_t *pkt_len);
 
+/**
+ * Get number of frames dropped by the service provider (e.g. because
+ * of socket receive buffer overflow) since the previous call.
+ *
+ * @param sap           SAP description structure
+ * @param drops         Location for number of dropped frames
+ *
+ * @return Status code.
+ */
+extern te_errno tad_eth_sap_recv_drops(tad_eth_sap *sap, uint64_t *drops);
+
 /**
  * Close Ethernet service access point for receiving.
  *
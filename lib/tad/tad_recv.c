@@ -21,6 +21,7 @@
 #include <netinet/in.h>
 #include <unistd.h>
 
+#include "te_perf.h"
 #include "logger_api.h"
 #include "logger_ta_fast.h"
 #include "rcf_ch_api.h"
@@ -504,12 +505,30 @@ tad_recv_release_context(csap_p csap, tad_recv_context *context)
 }
 
 
+/**
+ * Number of packets read from the media between updates of number of
+ * packets dropped by the media.
+ */
+#define TAD_RECV_MEDIA_DROPS_INTERVAL   1024
+
+/** Number of packets matched by all CSAPs */
+static te_perf_counter *tad_perf_rx_pkts = NULL;
+/** Number of packets which do not match patterns of all CSAPs */
+static te_perf_counter *tad_perf_rx_no_match_pkts = NULL;
+
 /* See description in tad_recv.h */
 void
 tad_recv_init_context(tad_recv_context *context)
 {
     memset(context, 0, sizeof(*context));
     TAILQ_INIT(&context->packets);
+
+    if (tad_perf_rx_pkts == NULL)
+    {
+        tad_perf_rx_pkts = te_perf_counter_get("tad.rx_pkts");
+        tad_perf_rx_no_match_pkts =
+            te_perf_counter_get("tad.rx_no_match_pkts");
+    }
 }
 
 /* See description in tad_recv.h */
@@ -520,6 +539,8 @@ tad_recv_prepare(csap_p csap, asn_value *pattern, unsigned int num,
     tad_recv_context       *my_ctx = csap_get_recv_context(csap);
     te_errno                rc;
     csap_low_resource_cb_t  prepare_recv_cb;
+    csap_recv_drops_cb_t    recv_drops_cb;
+    uint64_t                drops;
 
     assert(csap != NULL);
     assert(pattern != NULL);
@@ -529,6 +550,8 @@ tad_recv_prepare(csap_p csap, asn_value *pattern, unsigned int num,
     my_ctx->status = 0;
     my_ctx->wait_pkts = num;
     my_ctx->match_pkts = my_ctx->got_pkts = my_ctx->no_match_pkts = 0;
+    my_ctx->bytes = my_ctx->match_ns = my_ctx->media_drops = 0;
+    my_ctx->queue_len = my_ctx->queue_max = my_ctx->queue_drops = 0;
 
     if (timeout == TAD_TIMEOUT_INF)
     {
@@ -578,6 +601,16 @@ tad_recv_prepare(csap_p csap, asn_value *pattern, unsigned int num,
         return rc;
     }
 
+    /*
+     * The media may be kept open between receive operations and its
+     * counter of drops is reset on read, so read it now to count only
+     * drops which happen during this operation.
+     */
+    recv_drops_cb = csap_get_proto_support(csap,
+                        csap_get_rw_layer(csap))->recv_drops_cb;
+    if (recv_drops_cb != NULL)
+        (void)recv_drops_cb(csap, &drops);
+
     return 0;
 }
 
@@ -1123,10 +1156,27 @@ out:
 static void
 tad_recv_pkt_enqueue(csap_p csap, tad_recv_pkts *pkts, tad_recv_pkt *pkt)
 {
-    int ret;
+    tad_recv_context   *context = csap_get_recv_context(csap);
+    tad_recv_pkt       *dropped = NULL;
+    int                 ret;
 
     CSAP_LOCK(csap);
+    /*
+     * Drop the oldest packet if the queue is full. In the case of
+     * pause policy Receiver does not read from the media when the queue
+     * is full, so it is just a safety net.
+     */
+    if (csap->recv_queue_limit != 0 &&
+        context->queue_len >= csap->recv_queue_limit)
+    {
+        dropped = TAILQ_FIRST(pkts);
+        TAILQ_REMOVE(pkts, dropped, links);
+        context->queue_len--;
+        context->queue_drops++;
+    }
     TAILQ_INSERT_TAIL(pkts, pkt, links);
+    context->queue_len++;
+    context->queue_max = MAX(context->queue_max, context->queue_len);
     if ((ret = pthread_cond_broadcast(&csap->event)) != 0)
     {
         te_errno rc = TE_OS_RC(TE_TAD_CH, ret);
@@ -1136,6 +1186,72 @@ tad_recv_pkt_enqueue(csap_p csap, tad_recv_pkts *pkts, tad_recv_pkt *pkt)
               "packet: %r - ignore", CSAP_LOG_ARGS(csap), rc);
     }
     CSAP_UNLOCK(csap);
+
+    tad_recv_pkt_free(csap, dropped);
+}
+
+/**
+ * Wait until there is room in the queue of received packets if
+ * receiving should be paused when the queue is full.
+ *
+ * @param csap          CSAP instance
+ * @param context       Receiver context
+ * @param timeout       Maximum time to wait in microseconds
+ *
+ * @return @c TRUE if the queue is still full.
+ */
+static te_bool
+tad_recv_queue_wait(csap_p csap, tad_recv_context *context,
+                    unsigned int timeout)
+{
+    struct timeval  now;
+    struct timespec deadline;
+    te_bool         full;
+
+    if (csap->recv_queue_limit == 0 ||
+        csap->recv_queue_policy != NDN_CSAP_RECV_QUEUE_PAUSE)
+        return FALSE;
+
+    CSAP_LOCK(csap);
+    full = context->queue_len >= csap->recv_queue_limit;
+    if (full && (csap->state & (CSAP_STATE_COMPLETE | CSAP_STATE_STOP)) == 0)
+    {
+        gettimeofday(&now, NULL);
+        deadline.tv_sec = now.tv_sec + TE_US2SEC(timeout);
+        deadline.tv_nsec = TE_US2NS(now.tv_usec + timeout % 1000000);
+        if (deadline.tv_nsec >= TE_SEC2NS(1))
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= TE_SEC2NS(1);
+        }
+
+        /* Getting a packet from the queue broadcasts the event */
+        (void)pthread_cond_timedwait(&csap->event, &csap->lock, &deadline);
+        full = context->queue_len >= csap->recv_queue_limit;
+    }
+    CSAP_UNLOCK(csap);
+
+    return full;
+}
+
+/**
+ * Add number of packets dropped by the media since the previous call
+ * to receive statistics.
+ *
+ * @param csap          CSAP instance
+ * @param context       Receiver context
+ */
+static void
+tad_recv_update_media_drops(csap_p csap, tad_recv_context *context)
+{
+    csap_recv_drops_cb_t    recv_drops_cb;
+    uint64_t                drops;
+
+    recv_drops_cb = csap_get_proto_support(csap,
+                        csap_get_rw_layer(csap))->recv_drops_cb;
+
+    if (recv_drops_cb != NULL && recv_drops_cb(csap, &drops) == 0)
+        context->media_drops += drops;
 }
 
 
@@ -1151,6 +1267,9 @@ tad_recv_do(csap_p csap)
     tad_recv_pkt       *meta_pkt = NULL;
     tad_pkt            *pkt;
     size_t              read_len;
+    unsigned int        read_pkts = 0;
+    struct timespec     match_start;
+    struct timespec     match_end;
 
 
     assert(csap != NULL);
@@ -1269,6 +1388,10 @@ tad_recv_do(csap_p csap)
             timeout = MIN(timeout, (unsigned int)wait_timeout);
         }
 
+        /* Do not read from the media if there is no room for packets */
+        if (tad_recv_queue_wait(csap, context, timeout))
+            continue;
+
         if ((meta_pkt == NULL) &&
             ((meta_pkt = tad_recv_pkt_alloc(csap)) == NULL))
         {
@@ -1293,6 +1416,7 @@ tad_recv_do(csap_p csap)
         {
             VERB(CSAP_LOG_FMT "read callback timed out, check state and "
                  "total timeout", CSAP_LOG_ARGS(csap));
+            tad_recv_update_media_drops(csap, context);
             continue;
         }
         if (rc != 0)
@@ -1303,12 +1427,22 @@ tad_recv_do(csap_p csap)
             break;
         }
 
+        context->bytes += read_len;
+        if (++read_pkts % TAD_RECV_MEDIA_DROPS_INTERVAL == 0)
+            tad_recv_update_media_drops(csap, context);
+
         /* Match received packet against pattern */
+        clock_gettime(CLOCK_MONOTONIC, &match_start);
         rc = tad_recv_match(csap, &context->ptrn_data, meta_pkt,
                             read_len, &no_report);
+        clock_gettime(CLOCK_MONOTONIC, &match_end);
+        context->match_ns += TE_SEC2NS(match_end.tv_sec -
+                                       match_start.tv_sec) +
+                             match_end.tv_nsec - match_start.tv_nsec;
         if (TE_RC_GET_ERROR(rc) == TE_ETADNOTMATCH)
         {
             context->no_match_pkts++;
+            te_perf_counter_add(tad_perf_rx_no_match_pkts, 1);
             if (csap->state & CSAP_STATE_RECV_MISMATCH)
             {
                 meta_pkt->match_unit = -1;
@@ -1354,6 +1488,7 @@ tad_recv_do(csap_p csap)
         if (context->match_pkts == 0)
             csap->first_pkt = csap->last_pkt;
         context->match_pkts++;
+        te_perf_counter_add(tad_perf_rx_pkts, 1);
 
         if ((csap->state & CSAP_STATE_RESULTS) && !no_report)
         {
@@ -1385,6 +1520,8 @@ tad_recv_do(csap_p csap)
 exit:
     context->status = rc;
 
+    tad_recv_update_media_drops(csap, context);
+
     /*
      * Shutdown receiver and release resources allocated during pattern
      * preprocessing.
@@ -1466,6 +1603,12 @@ tad_recv_get_packet(csap_p csap, te_bool wait, tad_recv_pkt **pkt)
     if (*pkt != NULL)
     {
         TAILQ_REMOVE(&ctx->packets, *pkt, links);
+        ctx->queue_len--;
+
+        /* Wake up Receiver paused since the queue is full */
+        if (csap->recv_queue_limit != 0 &&
+            ctx->queue_len + 1 == csap->recv_queue_limit)
+            (void)pthread_cond_broadcast(&csap->event);
     }
     else if (rc == 0)
     {
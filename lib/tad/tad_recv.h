@@ -127,6 +127,19 @@ typedef struct tad_recv_context {
     unsigned int    got_pkts;   /**< Number of matched packets got via
                                      traffic receive get operation */
     unsigned int    no_match_pkts;   /**< Number of unmatched packets */
+
+    uint64_t        bytes;          /**< Number of bytes read from
+                                         the media */
+    uint64_t        match_ns;       /**< Time spent in matching of
+                                         received packets in
+                                         nanoseconds */
+    uint64_t        media_drops;    /**< Number of packets dropped by
+                                         the media (e.g. by the kernel) */
+    unsigned int    queue_len;      /**< Number of packets in the queue */
+    unsigned int    queue_max;      /**< Maximum number of packets
+                                         in the queue */
+    unsigned int    queue_drops;    /**< Number of packets dropped since
+                                         the queue is full */
 } tad_recv_context;
 
 
@@ -30,6 +30,7 @@
 #endif
 
 #include "te_tools.h"
+#include "te_perf.h"
 #include "logger_api.h"
 #include "logger_ta_fast.h"
 #include "rcf_ch_api.h"
@@ -399,11 +400,17 @@ tad_send_free_context(csap_p csap, tad_send_context *context)
 }
 
 
+/** Number of packets sent by all CSAPs */
+static te_perf_counter *tad_perf_tx_pkts = NULL;
+
 /* See description in tad_send.h */
 void
 tad_send_init_context(tad_send_context *context)
 {
     memset(context, 0, sizeof(*context));
+
+    if (tad_perf_tx_pkts == NULL)
+        tad_perf_tx_pkts = te_perf_counter_get("tad.tx_pkts");
 }
 
 /* See description in tad_send.h */
@@ -631,6 +638,21 @@ tad_send_delay()
 #endif
 
 
+/* See description in tad_send.h */
+void
+tad_send_account(csap_p csap, unsigned int n_pkts)
+{
+    if (n_pkts == 0)
+        return;
+
+    gettimeofday(&csap->last_pkt, NULL);
+    if (csap->sender.sent_pkts == 0)
+        csap->first_pkt = csap->last_pkt;
+
+    csap->sender.sent_pkts += n_pkts;
+    te_perf_counter_add(tad_perf_tx_pkts, n_pkts);
+}
+
 /**
  * TAD Sender callback to send one packet.
  *
@@ -655,12 +677,7 @@ tad_send_cb(tad_pkt *pkt, void *opaque)
         return rc;
     }
     /* Written successfull */
-
-    gettimeofday(&csap->last_pkt, NULL);
-    if (csap->sender.sent_pkts == 0)
-        csap->first_pkt = csap->last_pkt;
-
-    csap->sender.sent_pkts++;
+    tad_send_account(csap, 1);
 
     F_VERB(CSAP_LOG_FMT "write callback OK, sent %u packets",
            CSAP_LOG_ARGS(csap), csap->sender.sent_pkts);
@@ -711,9 +728,11 @@ tad_send_free_packets(tad_pkts *pkts, unsigned int num)
 static te_errno
 tad_send_by_template_unit(csap_p csap, tad_send_tmpl_unit_data *tu_data)
 {
-    te_errno        rc;
-    tad_pkts       *pkts;
-    unsigned int    i;
+    te_errno            rc;
+    tad_pkts           *pkts;
+    unsigned int        i;
+    unsigned int        rw_layer = csap_get_rw_layer(csap);
+    csap_send_tmpl_cb_t send_tmpl_cb;
 
 #if 1 /* FIXME: More part of this processing to prepare stage */
     tad_special_send_pkt_cb  send_cb = NULL;
@@ -723,6 +742,18 @@ tad_send_by_template_unit(csap_p csap, tad_send_tmpl_unit_data *tu_data)
 
     F_ENTRY();
 
+    /*
+     * Packets are not generated by layers if the CSAP sends traffic
+     * specified by a template unit on its own.
+     */
+    send_tmpl_cb = csap_get_proto_support(csap, rw_layer)->send_tmpl_cb;
+    if (send_tmpl_cb != NULL)
+    {
+        rc = send_tmpl_cb(csap, tu_data->layer_opaque[rw_layer]);
+        F_EXIT("%r", rc);
+        return rc;
+    }
+
     pkts = malloc((csap->depth + 1) * sizeof(*pkts));
     if (pkts == NULL)
         return TE_RC(TE_TAD_CH, TE_ENOMEM);
@@ -99,6 +99,15 @@ extern te_errno tad_send_prepare(csap_p                     csap,
  */
 extern te_errno tad_send_stop(csap_p csap, unsigned int *sent_pkts);
 
+/**
+ * Account packets just sent by a CSAP: update the number of sent packets
+ * and timestamps of the first and the last of them.
+ *
+ * @param csap          CSAP instance
+ * @param n_pkts        Number of sent packets
+ */
+extern void tad_send_account(csap_p csap, unsigned int n_pkts);
+
 
 /**
  * Start routine for Sender thread.
@@ -0,0 +1,446 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAD PCAP
+ *
+ * Test for indexing of pcap/pcapng capture files and rewriting of
+ * packets replayed by Ethernet-PCAP CSAP.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "../pcap/tad_pcap_replay.c"
+
+#include <stdio.h>
+
+/** Buffer to build a capture file in */
+typedef struct test_buf {
+    uint8_t     data[1024];     /**< File contents */
+    size_t      len;            /**< Length of contents */
+} test_buf;
+
+/** Append a 16-bit value in host byte order */
+static void
+put16(test_buf *buf, uint16_t v)
+{
+    memcpy(buf->data + buf->len, &v, sizeof(v));
+    buf->len += sizeof(v);
+}
+
+/** Append a 32-bit value in host byte order */
+static void
+put32(test_buf *buf, uint32_t v)
+{
+    memcpy(buf->data + buf->len, &v, sizeof(v));
+    buf->len += sizeof(v);
+}
+
+/** Append data padded with zeros to @p align bytes */
+static void
+put_data(test_buf *buf, const void *data, size_t len, size_t align)
+{
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    while (buf->len % align != 0)
+        buf->data[buf->len++] = 0;
+}
+
+/** Ethernet frame with IPv4/UDP packet used in the test */
+static const uint8_t udp_frame[] = {
+    /* Ethernet */
+    0x00, 0x0e, 0xa6, 0x41, 0xd5, 0x2e, 0x00, 0x0e, 0xa6, 0x41, 0xd5, 0x2f,
+    0x08, 0x00,
+    /* IPv4 */
+    0x45, 0x00, 0x00, 0x20, 0x00, 0x01, 0x00, 0x00, 0x40, 0x11, 0x00, 0x00,
+    10, 0, 0, 1, 10, 0, 0, 2,
+    /* UDP */
+    0x30, 0x39, 0x00, 0x35, 0x00, 0x0c, 0x00, 0x00,
+    /* Payload */
+    0xde, 0xad, 0xbe, 0xef,
+};
+
+/** Offset of IPv4 header in the frame */
+#define IP_OFF      14
+/** Offset of UDP header in the frame */
+#define UDP_OFF     (IP_OFF + 20)
+
+/** Compute Internet checksum of data with initial sum */
+static uint16_t
+csum(const uint8_t *data, size_t len, uint32_t sum)
+{
+    uint16_t    word;
+    size_t      i;
+
+    for (i = 0; i + 1 < len; i += 2)
+    {
+        memcpy(&word, data + i, sizeof(word));
+        sum += word;
+    }
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    return ~sum;
+}
+
+/** Compute UDP checksum of an IPv4/UDP packet in the frame */
+static uint16_t
+udp_csum(const uint8_t *frame)
+{
+    uint8_t     pseudo[12];
+    uint16_t    udp_len = htons(sizeof(udp_frame) - UDP_OFF);
+    uint16_t    sum;
+
+    memcpy(pseudo, frame + IP_OFF + 12, 8);
+    pseudo[8] = 0;
+    pseudo[9] = IPPROTO_UDP;
+    memcpy(pseudo + 10, &udp_len, sizeof(udp_len));
+
+    sum = (uint16_t)~csum(pseudo, sizeof(pseudo), 0);
+    return csum(frame + UDP_OFF, sizeof(udp_frame) - UDP_OFF, sum);
+}
+
+/** Check conversion of pcapng timestamps to nanoseconds */
+static int
+test_pcapng_ts(void)
+{
+    static const struct {
+        te_bool     binary;
+        unsigned int exp;
+        uint64_t    ts;
+        uint64_t    ns;
+    } checks[] = {
+        { FALSE, 6, UINT64_C(1500000), UINT64_C(1500000000) },
+        { FALSE, 9, UINT64_C(1500000000), UINT64_C(1500000000) },
+        { FALSE, 12, UINT64_C(1500000000000), UINT64_C(1500000000) },
+        { TRUE, 10, (UINT64_C(3) << 10) | 512, UINT64_C(3500000000) },
+        { TRUE, 32, (UINT64_C(1) << 32) | (UINT64_C(1) << 30),
+          UINT64_C(1250000000) },
+        { TRUE, 40, (UINT64_C(5) << 40) | (UINT64_C(1) << 39),
+          UINT64_C(5500000000) },
+        { TRUE, 63, (UINT64_C(1) << 63) - 1, UINT64_C(999999999) },
+        { TRUE, 60, UINT64_C(3) << 58, UINT64_C(750000000) },
+    };
+    tad_pcap_replay_iface   iface;
+    uint64_t                ns;
+    unsigned int            i;
+
+    for (i = 0; i < TE_ARRAY_LEN(checks); i++)
+    {
+        iface.linktype = TAD_PCAP_REPLAY_LINKTYPE_ETHERNET;
+        iface.binary = checks[i].binary;
+        iface.exp = checks[i].exp;
+
+        ns = tad_pcap_replay_pcapng_ts(&iface, checks[i].ts);
+        if (ns != checks[i].ns)
+        {
+            fprintf(stderr, "Timestamp %llu with resolution %s^-%u is "
+                    "converted to %llu ns instead of %llu ns\n",
+                    (unsigned long long)checks[i].ts,
+                    checks[i].binary ? "2" : "10", checks[i].exp,
+                    (unsigned long long)ns,
+                    (unsigned long long)checks[i].ns);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Write a capture file and load it for replay.
+ *
+ * @param buf       Capture file contents
+ * @param n_pkts    Expected number of packets
+ * @param ts        Expected timestamps of packets relative to the first
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+check_load(const test_buf *buf, size_t n_pkts, const uint64_t *ts)
+{
+    tad_pcap_replay    *replay;
+    tad_pcap_replay_pkt *pkt;
+    char                file[] = "/tmp/te_pcap_replay_XXXXXX";
+    int                 fd;
+    size_t              i;
+    te_errno            rc;
+    int                 result = -1;
+
+    fd = mkstemp(file);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return -1;
+    }
+    if (write(fd, buf->data, buf->len) != (ssize_t)buf->len)
+    {
+        perror("write");
+        close(fd);
+        unlink(file);
+        return -1;
+    }
+    close(fd);
+
+    replay = TE_ALLOC(sizeof(*replay));
+    replay->pkts = TE_VEC_INIT(tad_pcap_replay_pkt);
+    replay->rewrite = TE_VEC_INIT(tad_pcap_replay_rewrite);
+    replay->file = TE_STRDUP(file);
+
+    rc = tad_pcap_replay_load(replay);
+    if (rc != 0)
+    {
+        fprintf(stderr, "Failed to load capture file: %x\n", rc);
+        goto out;
+    }
+
+    if (te_vec_size(&replay->pkts) != n_pkts)
+    {
+        fprintf(stderr, "%zu packets are loaded instead of %zu\n",
+                te_vec_size(&replay->pkts), n_pkts);
+        goto out;
+    }
+
+    for (i = 0; i < n_pkts; i++)
+    {
+        pkt = te_vec_get(&replay->pkts, i);
+        if (pkt->len != sizeof(udp_frame) ||
+            memcmp(pkt->data, udp_frame, sizeof(udp_frame)) != 0)
+        {
+            fprintf(stderr, "Packet %zu is loaded incorrectly\n", i);
+            goto out;
+        }
+        if (pkt->ts != ts[i])
+        {
+            fprintf(stderr, "Packet %zu has timestamp %llu instead "
+                    "of %llu\n", i, (unsigned long long)pkt->ts,
+                    (unsigned long long)ts[i]);
+            goto out;
+        }
+    }
+
+    result = 0;
+
+out:
+    tad_pcap_replay_free(replay);
+    unlink(file);
+    return result;
+}
+
+/** Check indexing of a classic pcap file with microsecond timestamps */
+static int
+test_load_pcap(void)
+{
+    static const uint64_t   ts[] = { 0, 1500000000, 1500000000 };
+    test_buf                buf = { .len = 0 };
+
+    put32(&buf, TAD_PCAP_REPLAY_MAGIC_US);
+    put16(&buf, 2);
+    put16(&buf, 4);
+    put32(&buf, 0);
+    put32(&buf, 0);
+    put32(&buf, 65535);
+    put32(&buf, TAD_PCAP_REPLAY_LINKTYPE_ETHERNET);
+
+    put32(&buf, 100);
+    put32(&buf, 0);
+    put32(&buf, sizeof(udp_frame));
+    put32(&buf, sizeof(udp_frame));
+    put_data(&buf, udp_frame, sizeof(udp_frame), 1);
+
+    put32(&buf, 101);
+    put32(&buf, 500000);
+    put32(&buf, sizeof(udp_frame));
+    put32(&buf, sizeof(udp_frame));
+    put_data(&buf, udp_frame, sizeof(udp_frame), 1);
+
+    /* Timestamp going back is replaced with the previous one */
+    put32(&buf, 100);
+    put32(&buf, 500000);
+    put32(&buf, sizeof(udp_frame));
+    put32(&buf, sizeof(udp_frame));
+    put_data(&buf, udp_frame, sizeof(udp_frame), 1);
+
+    return check_load(&buf, TE_ARRAY_LEN(ts), ts);
+}
+
+/** Append enhanced packet block with the test frame to pcapng file */
+static void
+put_pcapng_epb(test_buf *buf, uint32_t ifid, uint64_t ts)
+{
+    uint32_t len = 32 + TE_ALIGN(sizeof(udp_frame), 4);
+
+    put32(buf, TAD_PCAP_REPLAY_PCAPNG_EPB);
+    put32(buf, len);
+    put32(buf, ifid);
+    put32(buf, ts >> 32);
+    put32(buf, ts & UINT32_MAX);
+    put32(buf, sizeof(udp_frame));
+    put32(buf, sizeof(udp_frame));
+    put_data(buf, udp_frame, sizeof(udp_frame), 4);
+    put32(buf, len);
+}
+
+/**
+ * Check indexing of a pcapng file with binary timestamp resolution
+ * which does not allow to convert fractions of a second in 64 bits,
+ * and with a packet on an interface with another link type.
+ */
+static int
+test_load_pcapng(void)
+{
+    static const uint64_t   ts[] = { 0, 250000000 };
+    test_buf                buf = { .len = 0 };
+    uint8_t                 tsresol = 0x80 | 40;
+
+    put32(&buf, TAD_PCAP_REPLAY_PCAPNG_SHB);
+    put32(&buf, 28);
+    put32(&buf, TAD_PCAP_REPLAY_PCAPNG_BOM);
+    put16(&buf, 1);
+    put16(&buf, 0);
+    put32(&buf, UINT32_MAX);
+    put32(&buf, UINT32_MAX);
+    put32(&buf, 28);
+
+    /* Ethernet interface with 2^-40 s resolution */
+    put32(&buf, TAD_PCAP_REPLAY_PCAPNG_IDB);
+    put32(&buf, 32);
+    put16(&buf, TAD_PCAP_REPLAY_LINKTYPE_ETHERNET);
+    put16(&buf, 0);
+    put32(&buf, 65535);
+    put16(&buf, TAD_PCAP_REPLAY_PCAPNG_IF_TSRESOL);
+    put16(&buf, 1);
+    put_data(&buf, &tsresol, 1, 4);
+    put32(&buf, 0);
+    put32(&buf, 32);
+
+    /* Interface with another link type */
+    put32(&buf, TAD_PCAP_REPLAY_PCAPNG_IDB);
+    put32(&buf, 20);
+    put16(&buf, 113);
+    put16(&buf, 0);
+    put32(&buf, 65535);
+    put32(&buf, 20);
+
+    put_pcapng_epb(&buf, 0, (UINT64_C(100) << 40) | (UINT64_C(1) << 39));
+    put_pcapng_epb(&buf, 1, UINT64_C(100) << 40);
+    put_pcapng_epb(&buf, 0, (UINT64_C(100) << 40) | (UINT64_C(3) << 38));
+
+    return check_load(&buf, TE_ARRAY_LEN(ts), ts);
+}
+
+/** Check that checksums of the frame are valid */
+static int
+check_csums(const uint8_t *frame)
+{
+    if (csum(frame + IP_OFF, 20, 0) != 0)
+    {
+        fprintf(stderr, "IPv4 header checksum is invalid\n");
+        return -1;
+    }
+    if (udp_csum(frame) != 0)
+    {
+        fprintf(stderr, "UDP checksum is invalid\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/** Check rewriting of addresses and ports with checksums update */
+static int
+test_rewrite(void)
+{
+    uint8_t                 frame[sizeof(udp_frame)];
+    uint16_t                sum;
+    tad_pcap_replay         replay;
+    tad_pcap_replay_rewrite rule;
+    tad_pcap_replay_pkt     pkt = { .data = frame, .len = sizeof(frame) };
+    static const uint8_t    new_src[] = { 192, 168, 1, 1 };
+    uint16_t                port;
+    int                     result = -1;
+
+    memcpy(frame, udp_frame, sizeof(frame));
+    sum = csum(frame + IP_OFF, 20, 0);
+    memcpy(frame + IP_OFF + 10, &sum, sizeof(sum));
+    sum = udp_csum(frame);
+    memcpy(frame + UDP_OFF + 6, &sum, sizeof(sum));
+    if (check_csums(frame) != 0)
+        return -1;
+
+    memset(&replay, 0, sizeof(replay));
+    replay.rewrite = TE_VEC_INIT(tad_pcap_replay_rewrite);
+
+    /* Rule which does not match the packet */
+    memset(&rule, 0, sizeof(rule));
+    rule.match_port[TAD_PCAP_REPLAY_SRC] = 1;
+    rule.match_port[TAD_PCAP_REPLAY_DST] = -1;
+    rule.new_port[TAD_PCAP_REPLAY_SRC] = 2;
+    rule.new_port[TAD_PCAP_REPLAY_DST] = -1;
+    TE_VEC_APPEND(&replay.rewrite, rule);
+
+    /* Rule which matches the packet */
+    memset(&rule, 0, sizeof(rule));
+    rule.match_addr[TAD_PCAP_REPLAY_DST].len = 4;
+    memcpy(rule.match_addr[TAD_PCAP_REPLAY_DST].addr, frame + IP_OFF + 16,
+           4);
+    rule.match_port[TAD_PCAP_REPLAY_SRC] = 12345;
+    rule.match_port[TAD_PCAP_REPLAY_DST] = -1;
+    rule.new_addr[TAD_PCAP_REPLAY_SRC].len = sizeof(new_src);
+    memcpy(rule.new_addr[TAD_PCAP_REPLAY_SRC].addr, new_src,
+           sizeof(new_src));
+    rule.new_port[TAD_PCAP_REPLAY_SRC] = -1;
+    rule.new_port[TAD_PCAP_REPLAY_DST] = 5353;
+    TE_VEC_APPEND(&replay.rewrite, rule);
+
+    if (!tad_pcap_replay_rewrite_pkt(&replay, &pkt))
+    {
+        fprintf(stderr, "Packet is not rewritten\n");
+        goto out;
+    }
+
+    memcpy(&port, frame + UDP_OFF, sizeof(port));
+    if (ntohs(port) != 12345)
+    {
+        fprintf(stderr, "Port is rewritten by not matching rule\n");
+        goto out;
+    }
+    memcpy(&port, frame + UDP_OFF + 2, sizeof(port));
+    if (memcmp(frame + IP_OFF + 12, new_src, sizeof(new_src)) != 0 ||
+        ntohs(port) != 5353)
+    {
+        fprintf(stderr, "Packet is rewritten incorrectly\n");
+        goto out;
+    }
+    if (check_csums(frame) != 0)
+        goto out;
+
+    /* The same rule does not match the rewritten packet any more */
+    memcpy(rule.match_addr[TAD_PCAP_REPLAY_SRC].addr,
+           udp_frame + IP_OFF + 12, 4);
+    rule.match_addr[TAD_PCAP_REPLAY_SRC].len = 4;
+    te_vec_reset(&replay.rewrite);
+    TE_VEC_APPEND(&replay.rewrite, rule);
+    if (tad_pcap_replay_rewrite_pkt(&replay, &pkt))
+    {
+        fprintf(stderr, "Packet is rewritten by not matching rule\n");
+        goto out;
+    }
+
+    result = 0;
+
+out:
+    te_vec_free(&replay.rewrite);
+    return result;
+}
+
+int
+main(void)
+{
+    if (test_pcapng_ts() != 0 || test_load_pcap() != 0 ||
+        test_load_pcapng() != 0 || test_rewrite() != 0)
+    {
+        fprintf(stderr, "Test failed\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -55,6 +55,12 @@
 #include "tapi_mem.h"
 #include "tapi_test_behaviour.h"
 
+/**
+ * Minimum interval of link status synchronization in
+ * tapi_cfg_base_if_await_link_up(), milliseconds.
+ */
+#define TAPI_CFG_BASE_LINK_WAIT_MIN_MS 10
+
 /* See the description in tapi_cfg_base.h */
 char *
 tapi_cfg_base_get_ta_dir(const char *ta, tapi_cfg_base_ta_dir kind)
@@ -1434,6 +1440,7 @@ tapi_cfg_base_if_await_link_up(const char *ta, const char *iface,
                                unsigned int wait_int_ms,
                                unsigned int after_up_ms)
 {
+    cfg_subscription *sub = NULL;
     unsigned int i = 0;
     int oper_status;
     te_errno rc;
@@ -1441,14 +1448,42 @@ tapi_cfg_base_if_await_link_up(const char *ta, const char *iface,
     if (ta == NULL || iface == NULL)
         return TE_RC(TE_TAPI, TE_EINVAL);
 
-    do {
-        if (i != 0)
-            usleep(wait_int_ms * 1000);
+    /*
+     * Zero interval means no synchronization and no waiting for
+     * the subscription, so the status would never be refreshed.
+     */
+    wait_int_ms = MAX(wait_int_ms, TAPI_CFG_BASE_LINK_WAIT_MIN_MS);
+
+    /*
+     * Configurator synchronizes the status while we wait for its
+     * changes, so there is no need to poll it here.
+     */
+    rc = cfg_subscribe(&sub, wait_int_ms,
+                       "/agent:%s/interface:%s/oper_status:", ta, iface);
+    if (rc != 0)
+        return rc;
+
+    rc = cfg_get_instance_int_sync_fmt(&oper_status,
+                                       "/agent:%s/interface:%s/oper_status:",
+                                       ta, iface);
+    while (rc == 0 && oper_status == 0 && i < nb_attempts)
+    {
+        rc = cfg_subscription_wait(sub, wait_int_ms, NULL, NULL);
+        if (TE_RC_GET_ERROR(rc) == TE_ETIMEDOUT)
+        {
+            i++;
+            rc = 0;
+            continue;
+        }
+        if (rc != 0 && TE_RC_GET_ERROR(rc) != TE_ENOBUFS)
+            break;
+
+        rc = cfg_get_instance_int_fmt(&oper_status,
+                                      "/agent:%s/interface:%s/oper_status:",
+                                      ta, iface);
+    }
 
-        rc = cfg_get_instance_int_sync_fmt(&oper_status,
-                                           "/agent:%s/interface:%s/oper_status:",
-                                           ta, iface);
-    } while (rc == 0 && oper_status == 0 && i++ < nb_attempts);
+    cfg_unsubscribe(sub);
 
     if (rc == 0)
     {
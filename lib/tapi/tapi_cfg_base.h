@@ -613,7 +613,8 @@ tapi_cfg_base_if_down(const char *ta, const char *iface)
  * @param ta            Test Agent name
  * @param iface         Interface name
  * @param nb_attempts   The number of attempts to check link status
- * @param wait_int_ms   The amount of time which shall elapse prior attempt (ms)
+ * @param wait_int_ms   The amount of time which shall elapse prior attempt
+ *                      (ms), small values are rounded up to 10 ms
  * @param after_up_ms   The amount of time which shall elapse after link UP
  *                      has been detected in order to wait for the other
  *                      resources to become ready (ms)
@@ -17,6 +17,7 @@
 #include "tapi_cfg_if_rss.h"
 #include "te_alloc.h"
 #include "te_str.h"
+#include "te_sockaddr.h"
 #include "logger_api.h"
 
 /* See description in tapi_cfg_if_rss.h */
@@ -216,9 +217,10 @@ tapi_cfg_if_rss_print_indir_table(const char *ta,
     unsigned int size;
     unsigned int i;
     te_string str = TE_STRING_INIT;
-    int val;
+    unsigned int *table = NULL;
 
-    rc = tapi_cfg_if_rss_indir_table_size(ta, if_name, rss_context, &size);
+    rc = tapi_cfg_if_rss_indir_table_get(ta, if_name, rss_context,
+                                         &table, &size);
     if (rc != 0)
         return rc;
 
@@ -236,12 +238,7 @@ tapi_cfg_if_rss_print_indir_table(const char *ta,
 
         for (i = 0; i < size; i++)
         {
-            rc = tapi_cfg_if_rss_indir_get(ta, if_name, rss_context,
-                                           i, &val);
-            if (rc != 0)
-                goto finish;
-
-            rc = te_string_append(&str, "%5u ---> %d\n", i, val);
+            rc = te_string_append(&str, "%5u ---> %u\n", i, table[i]);
             if (rc != 0)
                 goto finish;
         }
@@ -252,6 +249,7 @@ tapi_cfg_if_rss_print_indir_table(const char *ta,
 finish:
 
     te_string_free(&str);
+    free(table);
     return rc;
 }
 
@@ -402,3 +400,392 @@ cleanup:
 
     return rc;
 }
+
+/* See description in tapi_cfg_if_rss.h */
+te_errno
+tapi_cfg_if_rss_indir_table_get(const char *ta,
+                                const char *if_name,
+                                unsigned int rss_context,
+                                unsigned int **table,
+                                unsigned int *size)
+{
+    cfg_handle *entries = NULL;
+    unsigned int *result = NULL;
+    unsigned int num;
+    unsigned int idx;
+    unsigned int i;
+    cfg_val_type type;
+    char *name;
+    int val;
+    te_errno rc;
+
+    rc = cfg_find_pattern_fmt(
+            &num, &entries,
+            "/agent:%s/interface:%s/rss:/context:%u/hash_indir:/indir:*",
+            ta, if_name, rss_context);
+    if (rc != 0)
+        return rc;
+
+    result = TE_ALLOC(num * sizeof(*result));
+
+    for (i = 0; i < num; i++)
+    {
+        rc = cfg_get_inst_name(entries[i], &name);
+        if (rc != 0)
+            goto cleanup;
+
+        rc = te_strtoui(name, 0, &idx);
+        free(name);
+        if (rc != 0)
+            goto cleanup;
+
+        if (idx >= num)
+        {
+            ERROR("%s(): unexpected indirection table entry %u",
+                  __FUNCTION__, idx);
+            rc = TE_RC(TE_TAPI, TE_EINVAL);
+            goto cleanup;
+        }
+
+        type = CVT_INT32;
+        rc = cfg_get_instance(entries[i], &type, &val);
+        if (rc != 0)
+            goto cleanup;
+
+        result[idx] = val;
+    }
+
+    *table = result;
+    *size = num;
+
+cleanup:
+
+    free(entries);
+
+    if (rc != 0)
+        free(result);
+
+    return rc;
+}
+
+/* See description in tapi_cfg_if_rss.h */
+te_errno
+tapi_cfg_if_rss_model_get(const char *ta,
+                          const char *if_name,
+                          unsigned int rss_context,
+                          tapi_cfg_if_rss_model *model)
+{
+    tapi_cfg_if_rss_hfunc *hfuncs = NULL;
+    unsigned int hfuncs_num;
+    uint8_t *key = NULL;
+    size_t key_len;
+    unsigned int i;
+    te_errno rc;
+
+    memset(model, 0, sizeof(*model));
+    model->hash_var = TE_TOEPLITZ_HASH_STANDARD;
+
+    rc = tapi_cfg_if_rss_hfuncs_get(ta, if_name, rss_context,
+                                    &hfuncs, &hfuncs_num);
+    if (rc != 0)
+        return rc;
+
+    for (i = 0; i < hfuncs_num; i++)
+    {
+        if (hfuncs[i].enabled && strcmp(hfuncs[i].name, "toeplitz") != 0)
+        {
+            ERROR("%s(): hash function '%s' is not supported",
+                  __FUNCTION__, hfuncs[i].name);
+            free(hfuncs);
+            return TE_RC(TE_TAPI, TE_EOPNOTSUPP);
+        }
+    }
+    free(hfuncs);
+
+    rc = tapi_cfg_if_rss_hash_key_get(ta, if_name, rss_context,
+                                      &key, &key_len);
+    if (rc != 0)
+        return rc;
+
+    model->cache = te_toeplitz_cache_init_size(key, key_len);
+    free(key);
+    if (model->cache == NULL)
+        return TE_RC(TE_TAPI, TE_EINVAL);
+
+    rc = tapi_cfg_if_rss_indir_table_get(ta, if_name, rss_context,
+                                         &model->indir, &model->indir_size);
+    if (rc == 0 && model->indir_size == 0)
+    {
+        ERROR("%s(): indirection table is empty", __FUNCTION__);
+        rc = TE_RC(TE_TAPI, TE_ENOENT);
+    }
+
+    if (rc != 0)
+        tapi_cfg_if_rss_model_free(model);
+
+    return rc;
+}
+
+/* See description in tapi_cfg_if_rss.h */
+void
+tapi_cfg_if_rss_model_free(tapi_cfg_if_rss_model *model)
+{
+    if (model == NULL)
+        return;
+
+    te_toeplitz_hash_fini(model->cache);
+    free(model->indir);
+    memset(model, 0, sizeof(*model));
+}
+
+/** Number of flows hashed at once */
+#define TAPI_CFG_IF_RSS_BATCH 256
+
+/* Check that addresses may be hashed and get address size */
+static te_errno
+rss_model_check_addrs(const struct sockaddr *src_addr,
+                      const struct sockaddr *dst_addr,
+                      unsigned int *addr_size)
+{
+    if (src_addr->sa_family != dst_addr->sa_family ||
+        (src_addr->sa_family != AF_INET && src_addr->sa_family != AF_INET6))
+    {
+        ERROR("%s(): addresses should be both IPv4 or both IPv6",
+              __FUNCTION__);
+        return TE_RC(TE_TAPI, TE_EINVAL);
+    }
+
+    *addr_size = te_netaddr_get_size(src_addr->sa_family);
+    return 0;
+}
+
+/* Map hashes of flows to RX queues */
+static void
+rss_model_hashes2queues(const tapi_cfg_if_rss_model *model,
+                        unsigned int n, const uint32_t *hashes,
+                        unsigned int *queues)
+{
+    unsigned int i;
+
+    for (i = 0; i < n; i++)
+        queues[i] = model->indir[hashes[i] % model->indir_size];
+}
+
+/* See description in tapi_cfg_if_rss.h */
+te_errno
+tapi_cfg_if_rss_model_predict(const tapi_cfg_if_rss_model *model,
+                              unsigned int n,
+                              const struct sockaddr *const *src_addrs,
+                              const struct sockaddr *const *dst_addrs,
+                              unsigned int *queues)
+{
+    uint8_t input[TAPI_CFG_IF_RSS_BATCH][TE_TOEPLITZ_INPUT_MAX];
+    uint32_t hashes[TAPI_CFG_IF_RSS_BATCH];
+    unsigned int addr_size;
+    unsigned int batch_addr_size = 0;
+    unsigned int len = 0;
+    unsigned int done;
+    unsigned int num;
+    unsigned int i;
+    te_errno rc;
+
+    for (done = 0; done < n; done += num)
+    {
+        num = MIN(n - done, TAPI_CFG_IF_RSS_BATCH);
+
+        for (i = 0; i < num; i++)
+        {
+            const struct sockaddr *src = src_addrs[done + i];
+            const struct sockaddr *dst = dst_addrs[done + i];
+
+            rc = rss_model_check_addrs(src, dst, &addr_size);
+            if (rc != 0)
+                return rc;
+
+            /* Records of different lengths cannot be hashed together */
+            if (i > 0 && addr_size != batch_addr_size)
+            {
+                num = i;
+                break;
+            }
+            batch_addr_size = addr_size;
+
+            len = te_toeplitz_hash_input(model->hash_var, addr_size,
+                                         te_sockaddr_get_netaddr(src),
+                                         te_sockaddr_get_port(src),
+                                         te_sockaddr_get_netaddr(dst),
+                                         te_sockaddr_get_port(dst),
+                                         input[i]);
+        }
+
+        te_toeplitz_hash_batch(model->cache, input[0], sizeof(input[0]),
+                               len, num, hashes);
+        rss_model_hashes2queues(model, num, hashes, queues + done);
+    }
+
+    return 0;
+}
+
+/* See description in tapi_cfg_if_rss.h */
+te_errno
+tapi_cfg_if_rss_model_gen_flows(const tapi_cfg_if_rss_model *model,
+                                const struct sockaddr *src_addr,
+                                const struct sockaddr *dst_addr,
+                                tapi_cfg_if_rss_port port,
+                                int queue, unsigned int n,
+                                struct sockaddr_storage *src_addrs,
+                                struct sockaddr_storage *dst_addrs)
+{
+/* The first port used for generated flows if it is not specified */
+#define RSS_MODEL_PORT_MIN 1024
+/* Number of ports which may be tried */
+#define RSS_MODEL_PORTS_NUM (UINT16_MAX - RSS_MODEL_PORT_MIN + 1)
+
+    uint8_t input[TAPI_CFG_IF_RSS_BATCH][TE_TOEPLITZ_INPUT_MAX];
+    uint16_t ports[TAPI_CFG_IF_RSS_BATCH];
+    uint32_t hashes[TAPI_CFG_IF_RSS_BATCH];
+    unsigned int flow_queues[TAPI_CFG_IF_RSS_BATCH];
+    unsigned int *targets = NULL;
+    unsigned int *counts = NULL;
+    unsigned int targets_num;
+    unsigned int max_queue = 0;
+    unsigned int addr_size;
+    unsigned int len = 0;
+    unsigned int found = 0;
+    unsigned int tried;
+    unsigned int num;
+    unsigned int i;
+    unsigned int j;
+    uint16_t cur_port;
+    te_errno rc;
+
+    rc = rss_model_check_addrs(src_addr, dst_addr, &addr_size);
+    if (rc != 0)
+        return rc;
+
+    if (n == 0)
+        return 0;
+
+    /* Map of queue number to its position in the list of target queues */
+    for (i = 0; i < model->indir_size; i++)
+        max_queue = MAX(max_queue, model->indir[i]);
+
+    targets = TE_ALLOC((max_queue + 1) * sizeof(*targets));
+    counts = TE_ALLOC((max_queue + 1) * sizeof(*counts));
+    for (i = 0; i <= max_queue; i++)
+        targets[i] = UINT_MAX;
+
+    targets_num = 0;
+    if (queue == TAPI_CFG_IF_RSS_ANY_QUEUE)
+    {
+        for (i = 0; i <= max_queue; i++)
+        {
+            for (j = 0; j < model->indir_size; j++)
+            {
+                if (model->indir[j] == i)
+                {
+                    targets[i] = targets_num++;
+                    break;
+                }
+            }
+        }
+    }
+    else if (queue >= 0 && (unsigned int)queue <= max_queue)
+    {
+        for (j = 0; j < model->indir_size; j++)
+        {
+            if (model->indir[j] == (unsigned int)queue)
+            {
+                targets[queue] = targets_num++;
+                break;
+            }
+        }
+    }
+
+    if (targets_num == 0)
+    {
+        ERROR("%s(): queue %d is not present in indirection table",
+              __FUNCTION__, queue);
+        rc = TE_RC(TE_TAPI, TE_ENOENT);
+        goto cleanup;
+    }
+
+    cur_port = ntohs(port == TAPI_CFG_IF_RSS_SRC_PORT ?
+                     te_sockaddr_get_port(src_addr) :
+                     te_sockaddr_get_port(dst_addr));
+    if (cur_port < RSS_MODEL_PORT_MIN)
+        cur_port = RSS_MODEL_PORT_MIN;
+
+    for (tried = 0; tried < RSS_MODEL_PORTS_NUM && found < n; tried += num)
+    {
+        num = MIN(RSS_MODEL_PORTS_NUM - tried, TAPI_CFG_IF_RSS_BATCH);
+
+        for (i = 0; i < num; i++)
+        {
+            uint16_t src_port = te_sockaddr_get_port(src_addr);
+            uint16_t dst_port = te_sockaddr_get_port(dst_addr);
+
+            ports[i] = cur_port;
+            if (port == TAPI_CFG_IF_RSS_SRC_PORT)
+                src_port = htons(cur_port);
+            else
+                dst_port = htons(cur_port);
+
+            len = te_toeplitz_hash_input(model->hash_var, addr_size,
+                                         te_sockaddr_get_netaddr(src_addr),
+                                         src_port,
+                                         te_sockaddr_get_netaddr(dst_addr),
+                                         dst_port, input[i]);
+
+            cur_port = (cur_port == UINT16_MAX) ? RSS_MODEL_PORT_MIN :
+                                                  cur_port + 1;
+        }
+
+        te_toeplitz_hash_batch(model->cache, input[0], sizeof(input[0]),
+                               len, num, hashes);
+        rss_model_hashes2queues(model, num, hashes, flow_queues);
+
+        for (i = 0; i < num && found < n; i++)
+        {
+            unsigned int target = targets[flow_queues[i]];
+            unsigned int slot;
+
+            if (target == UINT_MAX)
+                continue;
+
+            /* Flows are placed round-robin over target queues */
+            slot = target + counts[flow_queues[i]] * targets_num;
+            if (slot >= n)
+                continue;
+
+            counts[flow_queues[i]]++;
+            found++;
+
+            memcpy(&src_addrs[slot], src_addr,
+                   te_sockaddr_get_size(src_addr));
+            memcpy(&dst_addrs[slot], dst_addr,
+                   te_sockaddr_get_size(dst_addr));
+            te_sockaddr_set_port(
+                        SA(port == TAPI_CFG_IF_RSS_SRC_PORT ?
+                           &src_addrs[slot] : &dst_addrs[slot]),
+                        htons(ports[i]));
+        }
+    }
+
+    if (found < n)
+    {
+        ERROR("%s(): only %u of %u flows may be generated",
+              __FUNCTION__, found, n);
+        rc = TE_RC(TE_TAPI, TE_ENOENT);
+    }
+
+cleanup:
+
+    free(targets);
+    free(counts);
+
+    return rc;
+
+#undef RSS_MODEL_PORT_MIN
+#undef RSS_MODEL_PORTS_NUM
+}
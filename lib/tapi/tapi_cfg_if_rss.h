@@ -13,6 +13,7 @@
 #define __TE_TAPI_CFG_IF_RSS_H__
 
 #include "te_errno.h"
+#include "te_toeplitz.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -269,6 +270,130 @@ extern te_errno tapi_cfg_if_rss_hfunc_set_single_local(
                                              unsigned int rss_context,
                                              const char *func_name);
 
+/**
+ * Get the whole RSS hash indirection table.
+ *
+ * @param ta            Test Agent name
+ * @param if_name       Network interface name
+ * @param rss_context   RSS context
+ * @param table         Where to save pointer to the array of RX queue
+ *                      numbers indexed by table entry (should be
+ *                      released by the caller)
+ * @param size          Where to save table size
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_if_rss_indir_table_get(const char *ta,
+                                                const char *if_name,
+                                                unsigned int rss_context,
+                                                unsigned int **table,
+                                                unsigned int *size);
+
+/**
+ * Model of RSS on a network interface. It allows to predict the RX
+ * queue of a flow and to choose flows landing on given queues
+ * without sending any traffic.
+ *
+ * The queue is determined as the value of indirection table entry
+ * with index equal to the remainder of division of Toeplitz hash
+ * by the table size.
+ */
+typedef struct tapi_cfg_if_rss_model {
+    te_toeplitz_hash_cache   *cache;       /**< Toeplitz hash cache built
+                                                from the hash key */
+    te_toeplitz_hash_variant  hash_var;    /**< Hash variant (standard
+                                                by default, may be
+                                                changed by the caller) */
+    unsigned int             *indir;       /**< Indirection table */
+    unsigned int              indir_size;  /**< Indirection table size */
+} tapi_cfg_if_rss_model;
+
+/**
+ * Get RSS hash key and indirection table of an interface and build
+ * RSS model from them.
+ *
+ * @param ta            Test Agent name
+ * @param if_name       Network interface name
+ * @param rss_context   RSS context
+ * @param model         Where to save the model (should be released with
+ *                      tapi_cfg_if_rss_model_free())
+ *
+ * @return Status code.
+ * @retval TE_EOPNOTSUPP    Enabled hash function is not Toeplitz.
+ */
+extern te_errno tapi_cfg_if_rss_model_get(const char *ta,
+                                          const char *if_name,
+                                          unsigned int rss_context,
+                                          tapi_cfg_if_rss_model *model);
+
+/**
+ * Release resources allocated for RSS model.
+ *
+ * @param model         RSS model
+ */
+extern void tapi_cfg_if_rss_model_free(tapi_cfg_if_rss_model *model);
+
+/**
+ * Predict RX queues of a batch of TCP or UDP flows.
+ *
+ * @param model         RSS model
+ * @param n             Number of flows
+ * @param src_addrs     Source addresses/ports of the flows (as seen
+ *                      by the interface receiving packets)
+ * @param dst_addrs     Destination addresses/ports of the flows
+ * @param queues        Where to save @p n RX queue numbers
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_if_rss_model_predict(
+                                const tapi_cfg_if_rss_model *model,
+                                unsigned int n,
+                                const struct sockaddr *const *src_addrs,
+                                const struct sockaddr *const *dst_addrs,
+                                unsigned int *queues);
+
+/** Port which is changed to generate flows */
+typedef enum tapi_cfg_if_rss_port {
+    TAPI_CFG_IF_RSS_SRC_PORT,   /**< Source port */
+    TAPI_CFG_IF_RSS_DST_PORT,   /**< Destination port */
+} tapi_cfg_if_rss_port;
+
+/**
+ * Special value of queue for tapi_cfg_if_rss_model_gen_flows()
+ * requesting even distribution of flows over all queues present in
+ * the indirection table.
+ */
+#define TAPI_CFG_IF_RSS_ANY_QUEUE (-1)
+
+/**
+ * Generate TCP or UDP flows landing on a given RX queue or spread
+ * evenly over all RX queues. Flows differ only in one port, it is
+ * changed starting from its value in the template address (or from
+ * @c 1024 if it is zero) up to @c 65535 and then from @c 1024.
+ *
+ * @param model         RSS model
+ * @param src_addr      Template source address/port
+ * @param dst_addr      Template destination address/port
+ * @param port          Which port to change
+ * @param queue         RX queue number or @ref TAPI_CFG_IF_RSS_ANY_QUEUE
+ *                      to spread flows evenly (flow @a i lands on
+ *                      (@a i modulo number of queues)-th queue)
+ * @param n             Number of flows to generate
+ * @param src_addrs     Where to save @p n source addresses
+ * @param dst_addrs     Where to save @p n destination addresses
+ *
+ * @return Status code.
+ * @retval TE_ENOENT    There are not enough suitable ports.
+ */
+extern te_errno tapi_cfg_if_rss_model_gen_flows(
+                                const tapi_cfg_if_rss_model *model,
+                                const struct sockaddr *src_addr,
+                                const struct sockaddr *dst_addr,
+                                tapi_cfg_if_rss_port port,
+                                int queue, unsigned int n,
+                                struct sockaddr_storage *src_addrs,
+                                struct sockaddr_storage *dst_addrs);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
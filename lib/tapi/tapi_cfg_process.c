@@ -290,6 +290,50 @@ tapi_cfg_ps_get_autorestart(const char *ta, const char *ps_name,
     return rc;
 }
 
+/* See descriptions in tapi_cfg_process.h */
+te_errno
+tapi_cfg_ps_set_cgroup(const char *ta, const char *ps_name, te_bool enable,
+                       const char *parent)
+{
+    te_errno rc;
+
+    if (parent == NULL)
+        parent = "";
+
+    rc = cfg_set_instance_fmt(CFG_VAL(STRING, parent),
+                              TE_CFG_TA_PS "/cgroup:/parent:", ta, ps_name);
+    if (rc == 0)
+    {
+        rc = cfg_set_instance_fmt(CFG_VAL(INT32, enable ? 1 : 0),
+                                  TE_CFG_TA_PS "/cgroup:", ta, ps_name);
+    }
+    if (rc != 0)
+    {
+        ERROR("Cannot set cgroup (process '%s', TA '%s'): %r",
+              ps_name, ta, rc);
+    }
+
+    return rc;
+}
+
+/* See descriptions in tapi_cfg_process.h */
+te_errno
+tapi_cfg_ps_get_cgroup_stat(const char *ta, const char *ps_name,
+                            const char *counter, uint64_t *value)
+{
+    te_errno rc;
+
+    rc = cfg_get_uint64(value, TE_CFG_TA_PS "/cgroup:/%s:", ta, ps_name,
+                        counter);
+    if (rc != 0)
+    {
+        ERROR("Cannot get cgroup counter '%s' (process '%s', TA '%s'): %r",
+              counter, ps_name, ta, rc);
+    }
+
+    return rc;
+}
+
 /** @param killpg   If @c TRUE, send signal to process group, else to process */
 static te_errno
 tapi_cfg_ps_kill_common(const char *ta, const char *ps_name, int signo,
@@ -234,6 +234,41 @@ extern te_errno tapi_cfg_ps_get_workdir(const char *ta,
                                         const char *ps_name,
                                         char **workdir);
 
+/**
+ * Make the process run in a dedicated cgroup v2 or disable it.
+ * The process must be stopped.
+ *
+ * @param ta        Test Agent name.
+ * @param ps_name   Process.
+ * @param enable    Whether the process should run in a dedicated cgroup.
+ * @param parent    Path to cgroup v2 directory in which the dedicated
+ *                  cgroup is created, @c NULL means the cgroup of
+ *                  the Test Agent.
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_ps_set_cgroup(const char *ta,
+                                       const char *ps_name,
+                                       te_bool enable,
+                                       const char *parent);
+
+/**
+ * Get a resource usage counter of the dedicated cgroup of the process.
+ *
+ * @param[in]  ta       Test Agent name.
+ * @param[in]  ps_name  Process.
+ * @param[in]  counter  Counter name, e.g. "cpu_usage" or "memory_peak"
+ *                      (see /agent/process/cgroup in the configuration
+ *                      model).
+ * @param[out] value    Counter value.
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_ps_get_cgroup_stat(const char *ta,
+                                            const char *ps_name,
+                                            const char *counter,
+                                            uint64_t *value);
+
 /**
  * Send a signal to the process.
  *
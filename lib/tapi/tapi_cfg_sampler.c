@@ -0,0 +1,360 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test API to control Test Agent side counter samplers.
+ *
+ * Implementation of API to configure samplers and to get collected
+ * time series.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "TAPI CFG Sampler"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <math.h>
+#ifdef STDC_HEADERS
+#include <stdlib.h>
+#include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include <arpa/inet.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_alloc.h"
+#include "te_string.h"
+#include "te_file.h"
+#include "logger_api.h"
+#include "rcf_api.h"
+#include "conf_api.h"
+#include "tapi_cfg_base.h"
+#include "tapi_file.h"
+#include "tapi_cfg_sampler.h"
+
+/** Magic number of a sampler dump */
+#define TAPI_CFG_SAMPLER_MAGIC      0x5445534d
+
+/** Supported version of a sampler dump */
+#define TAPI_CFG_SAMPLER_VERSION    1
+
+/** Position in a sampler dump being parsed */
+typedef struct tapi_cfg_sampler_reader {
+    const uint8_t  *p;      /**< Current position */
+    size_t          left;   /**< Number of bytes left */
+} tapi_cfg_sampler_reader;
+
+/* Read a 32-bit number in network byte order */
+static te_bool
+tapi_cfg_sampler_read_u32(tapi_cfg_sampler_reader *r, uint32_t *value)
+{
+    uint32_t v;
+
+    if (r->left < sizeof(v))
+        return FALSE;
+
+    memcpy(&v, r->p, sizeof(v));
+    *value = ntohl(v);
+    r->p += sizeof(v);
+    r->left -= sizeof(v);
+
+    return TRUE;
+}
+
+/* Read a 64-bit number in network byte order */
+static te_bool
+tapi_cfg_sampler_read_u64(tapi_cfg_sampler_reader *r, uint64_t *value)
+{
+    uint32_t hi;
+    uint32_t lo;
+
+    if (!tapi_cfg_sampler_read_u32(r, &hi) ||
+        !tapi_cfg_sampler_read_u32(r, &lo))
+        return FALSE;
+
+    *value = ((uint64_t)hi << 32) | lo;
+    return TRUE;
+}
+
+/* Read a null-terminated string */
+static te_bool
+tapi_cfg_sampler_read_str(tapi_cfg_sampler_reader *r, char **str)
+{
+    const uint8_t *end = memchr(r->p, '\0', r->left);
+
+    if (end == NULL)
+        return FALSE;
+
+    *str = TE_STRDUP((const char *)r->p);
+    r->left -= end - r->p + 1;
+    r->p = end + 1;
+
+    return TRUE;
+}
+
+/* Parse a sampler dump and compute rates */
+static te_errno
+tapi_cfg_sampler_parse(const uint8_t *data, size_t len,
+                       tapi_cfg_sampler_series *series)
+{
+    tapi_cfg_sampler_reader r = { .p = data, .left = len };
+    uint32_t                magic;
+    uint32_t                version;
+    uint32_t                interval;
+    uint32_t                n_counters;
+    uint32_t                n_samples;
+    uint64_t                offset;
+    size_t                  n_values;
+    unsigned int            i;
+    unsigned int            j;
+
+    memset(series, 0, sizeof(*series));
+
+    if (!tapi_cfg_sampler_read_u32(&r, &magic) ||
+        !tapi_cfg_sampler_read_u32(&r, &version))
+        goto truncated;
+
+    if (magic != TAPI_CFG_SAMPLER_MAGIC ||
+        version != TAPI_CFG_SAMPLER_VERSION)
+    {
+        ERROR("Unsupported sampler dump: magic 0x%x, version %u",
+              magic, version);
+        return TE_RC(TE_TAPI, TE_EPROTO);
+    }
+
+    if (!tapi_cfg_sampler_read_u32(&r, &interval) ||
+        !tapi_cfg_sampler_read_u32(&r, &n_counters) ||
+        !tapi_cfg_sampler_read_u32(&r, &n_samples) ||
+        !tapi_cfg_sampler_read_u64(&r, &series->missed) ||
+        !tapi_cfg_sampler_read_u64(&r, &offset))
+        goto truncated;
+
+    series->interval = interval;
+
+    /* Each counter name takes at least one byte */
+    if (n_counters > r.left)
+        goto truncated;
+
+    if (n_counters > 0)
+        series->names = TE_ALLOC(n_counters * sizeof(*series->names));
+    for (i = 0; i < n_counters; i++)
+    {
+        if (!tapi_cfg_sampler_read_str(&r, &series->names[i]))
+            goto truncated;
+        series->n_counters++;
+    }
+
+    n_values = (size_t)n_samples * n_counters;
+    if (r.left != (n_samples + n_values) * sizeof(uint64_t))
+        goto truncated;
+
+    series->n_samples = n_samples;
+    if (n_samples == 0)
+        return 0;
+
+    series->ts = TE_ALLOC(n_samples * sizeof(*series->ts));
+    series->values = TE_ALLOC(n_values * sizeof(*series->values));
+    series->rates = TE_ALLOC(n_values * sizeof(*series->rates));
+
+    for (i = 0; i < n_samples; i++)
+    {
+        uint64_t *values = &series->values[(size_t)i * n_counters];
+        double   *rates = &series->rates[(size_t)i * n_counters];
+        double    dt = 0;
+
+        tapi_cfg_sampler_read_u64(&r, &series->ts[i]);
+        for (j = 0; j < n_counters; j++)
+            tapi_cfg_sampler_read_u64(&r, &values[j]);
+
+        if (i > 0)
+            dt = (series->ts[i] - series->ts[i - 1]) / 1e9;
+
+        for (j = 0; j < n_counters; j++)
+        {
+            uint64_t prev;
+
+            if (i == 0)
+            {
+                rates[j] = 0;
+                continue;
+            }
+
+            prev = values[j - n_counters];
+            if (values[j] == TAPI_CFG_SAMPLER_VALUE_NONE ||
+                prev == TAPI_CFG_SAMPLER_VALUE_NONE || dt <= 0)
+            {
+                rates[j] = NAN;
+                continue;
+            }
+
+            /* Gauges (e.g. queue length) may decrease */
+            rates[j] = (double)(int64_t)(values[j] - prev) / dt;
+        }
+    }
+
+    /* Rates are computed, so timestamps may be converted now */
+    for (i = 0; i < n_samples; i++)
+        series->ts[i] += offset;
+
+    return 0;
+
+truncated:
+    ERROR("Sampler dump is truncated or corrupted");
+    tapi_cfg_sampler_series_free(series);
+    return TE_RC(TE_TAPI, TE_EPROTO);
+}
+
+/* See description in tapi_cfg_sampler.h */
+te_errno
+tapi_cfg_sampler_add(const char *ta, const char *name,
+                     unsigned int interval, unsigned int depth)
+{
+    te_errno rc;
+
+    rc = cfg_add_instance_fmt(NULL, CFG_VAL(NONE, NULL),
+                              "/agent:%s/sampler:%s", ta, name);
+    if (rc != 0)
+    {
+        ERROR("Failed to add sampler '%s' on %s: %r", name, ta, rc);
+        return rc;
+    }
+
+    rc = cfg_set_instance_fmt(CFG_VAL(UINT32, interval),
+                              "/agent:%s/sampler:%s/interval:", ta, name);
+    if (rc == 0)
+    {
+        rc = cfg_set_instance_fmt(CFG_VAL(UINT32, depth),
+                                  "/agent:%s/sampler:%s/depth:", ta, name);
+    }
+    if (rc != 0)
+    {
+        ERROR("Failed to configure sampler '%s' on %s: %r", name, ta, rc);
+        (void)tapi_cfg_sampler_del(ta, name);
+    }
+
+    return rc;
+}
+
+/* See description in tapi_cfg_sampler.h */
+te_errno
+tapi_cfg_sampler_del(const char *ta, const char *name)
+{
+    return cfg_del_instance_fmt(TRUE, "/agent:%s/sampler:%s", ta, name);
+}
+
+/* See description in tapi_cfg_sampler.h */
+te_errno
+tapi_cfg_sampler_counter_add(const char *ta, const char *name,
+                             const char *counter, const char *source)
+{
+    te_errno rc;
+
+    rc = cfg_add_instance_fmt(NULL, CFG_VAL(STRING, source),
+                              "/agent:%s/sampler:%s/counter:%s",
+                              ta, name, counter);
+    if (rc != 0)
+    {
+        ERROR("Failed to add counter '%s' (%s) to sampler '%s' on %s: %r",
+              counter, source, name, ta, rc);
+    }
+
+    return rc;
+}
+
+/* See description in tapi_cfg_sampler.h */
+te_errno
+tapi_cfg_sampler_enable(const char *ta, const char *name, te_bool enable)
+{
+    return cfg_set_instance_fmt(CFG_VAL(INT32, enable ? 1 : 0),
+                                "/agent:%s/sampler:%s/enable:", ta, name);
+}
+
+/* See description in tapi_cfg_sampler.h */
+te_errno
+tapi_cfg_sampler_fetch(const char *ta, const char *name,
+                       tapi_cfg_sampler_series *series)
+{
+    te_string   content = TE_STRING_INIT;
+    char       *relname;
+    char       *rname;
+    char       *lname = NULL;
+    te_errno    rc;
+
+    relname = te_string_fmt("sampler_%s.dump", name);
+    rname = tapi_file_resolve_ta_pathname(NULL, ta,
+                                          TAPI_CFG_BASE_TA_DIR_TMP,
+                                          relname);
+    free(relname);
+    if (rname == NULL)
+        return TE_RC(TE_TAPI, TE_ENOENT);
+
+    rc = cfg_set_instance_fmt(CFG_VAL(STRING, rname),
+                              "/agent:%s/sampler:%s/dump:", ta, name);
+    if (rc != 0)
+    {
+        ERROR("Failed to dump sampler '%s' on %s: %r", name, ta, rc);
+        goto out;
+    }
+
+    lname = tapi_file_make_pathname(NULL);
+    rc = rcf_ta_get_file(ta, 0, rname, lname);
+    (void)rcf_ta_del_file(ta, 0, rname);
+    if (rc != 0)
+    {
+        ERROR("Failed to get sampler '%s' dump from %s: %r", name, ta, rc);
+        goto out;
+    }
+
+    rc = te_file_read_string(&content, TRUE, 0, "%s", lname);
+    unlink(lname);
+    if (rc != 0)
+        goto out;
+
+    rc = tapi_cfg_sampler_parse((const uint8_t *)content.ptr, content.len,
+                                series);
+
+out:
+    te_string_free(&content);
+    free(rname);
+    free(lname);
+
+    return rc;
+}
+
+/* See description in tapi_cfg_sampler.h */
+te_errno
+tapi_cfg_sampler_counter_idx(const tapi_cfg_sampler_series *series,
+                             const char *counter, unsigned int *idx)
+{
+    unsigned int i;
+
+    for (i = 0; i < series->n_counters; i++)
+    {
+        if (strcmp(series->names[i], counter) == 0)
+        {
+            *idx = i;
+            return 0;
+        }
+    }
+
+    return TE_RC(TE_TAPI, TE_ENOENT);
+}
+
+/* See description in tapi_cfg_sampler.h */
+void
+tapi_cfg_sampler_series_free(tapi_cfg_sampler_series *series)
+{
+    unsigned int i;
+
+    for (i = 0; i < series->n_counters; i++)
+        free(series->names[i]);
+    free(series->names);
+    free(series->ts);
+    free(series->values);
+    free(series->rates);
+
+    memset(series, 0, sizeof(*series));
+}
@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test API to control Test Agent side counter samplers.
+ *
+ * Definition of API to configure samplers (/agent/sampler subtree)
+ * and to get collected time series.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_TAPI_CFG_SAMPLER_H__
+#define __TE_TAPI_CFG_SAMPLER_H__
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "conf_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup tapi_conf_sampler Test Agent side counter samplers
+ * @ingroup tapi_conf
+ * @{
+ *
+ * A sampler reads a set of counters (see @c /agent/sampler/counter
+ * description for supported sources) with a fixed interval in
+ * a separate thread of the Test Agent. Samples are kept in a ring
+ * on the Test Agent and fetched at once, so timestamps are precise
+ * and sampling is not affected by Configurator requests.
+ *
+ * Samples are dumped by the Test Agent to a file in the following
+ * format (all numbers are in network byte order):
+ * - 32-bit magic number @c 0x5445534d ("TESM");
+ * - 32-bit format version (@c 1);
+ * - 32-bit sampling interval in milliseconds;
+ * - 32-bit number of counters;
+ * - 32-bit number of samples;
+ * - 64-bit number of missed sampling intervals;
+ * - 64-bit offset in nanoseconds to convert timestamps to real time;
+ * - null-terminated names of counters;
+ * - samples: 64-bit CLOCK_MONOTONIC timestamp in nanoseconds followed
+ *   by 64-bit values of all counters (@c UINT64_MAX if a counter
+ *   could not be read).
+ */
+
+/** Value of a counter which could not be read */
+#define TAPI_CFG_SAMPLER_VALUE_NONE UINT64_MAX
+
+/** Time series collected by a sampler */
+typedef struct tapi_cfg_sampler_series {
+    unsigned int  interval;     /**< Sampling interval, milliseconds */
+    uint64_t      missed;       /**< Number of missed intervals */
+    unsigned int  n_counters;   /**< Number of counters */
+    char        **names;        /**< Names of counters */
+    unsigned int  n_samples;    /**< Number of samples */
+    uint64_t     *ts;           /**< Timestamps of samples, nanoseconds
+                                     since the Epoch by the Test Agent
+                                     clock */
+    uint64_t     *values;       /**< Values, @a n_counters per sample
+                                     (see tapi_cfg_sampler_value()) */
+    double       *rates;        /**< Per second rates of change since
+                                     the previous sample, @a n_counters
+                                     per sample; @c 0 for the first
+                                     sample and @c NAN if a value is
+                                     missing (see tapi_cfg_sampler_rate())
+                                     */
+} tapi_cfg_sampler_series;
+
+/**
+ * Get a value of a counter in a sample.
+ *
+ * @param series        Time series
+ * @param sample        Sample index
+ * @param counter       Counter index
+ *
+ * @return Counter value or @c TAPI_CFG_SAMPLER_VALUE_NONE.
+ */
+static inline uint64_t
+tapi_cfg_sampler_value(const tapi_cfg_sampler_series *series,
+                       unsigned int sample, unsigned int counter)
+{
+    return series->values[(size_t)sample * series->n_counters + counter];
+}
+
+/**
+ * Get a rate of change of a counter in a sample.
+ *
+ * @param series        Time series
+ * @param sample        Sample index
+ * @param counter       Counter index
+ *
+ * @return Rate per second (negative if the counter decreases).
+ */
+static inline double
+tapi_cfg_sampler_rate(const tapi_cfg_sampler_series *series,
+                      unsigned int sample, unsigned int counter)
+{
+    return series->rates[(size_t)sample * series->n_counters + counter];
+}
+
+/**
+ * Add a sampler on a Test Agent.
+ *
+ * @param ta            Test Agent name
+ * @param name          Sampler name
+ * @param interval      Sampling interval in milliseconds (at least 1)
+ * @param depth         Maximum number of samples kept by the agent
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_sampler_add(const char *ta, const char *name,
+                                     unsigned int interval,
+                                     unsigned int depth);
+
+/**
+ * Remove a sampler from a Test Agent.
+ *
+ * @param ta            Test Agent name
+ * @param name          Sampler name
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_sampler_del(const char *ta, const char *name);
+
+/**
+ * Add a counter to a disabled sampler.
+ *
+ * @param ta            Test Agent name
+ * @param name          Sampler name
+ * @param counter       Counter name
+ * @param source        Counter source, e.g. @c "if:eth0:rx_packets",
+ *                      @c "ethtool:eth0:rx_missed" or
+ *                      @c "snmp:Tcp:RetransSegs"
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_sampler_counter_add(const char *ta,
+                                             const char *name,
+                                             const char *counter,
+                                             const char *source);
+
+/**
+ * Start or stop sampling. Previously collected samples are discarded
+ * when sampling is started.
+ *
+ * @param ta            Test Agent name
+ * @param name          Sampler name
+ * @param enable        Whether sampling should be started
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_sampler_enable(const char *ta, const char *name,
+                                        te_bool enable);
+
+/**
+ * Get samples collected by a sampler. The sampler may be either
+ * enabled or disabled.
+ *
+ * @param[in]  ta       Test Agent name
+ * @param[in]  name     Sampler name
+ * @param[out] series   Where to save the time series (should be released
+ *                      with tapi_cfg_sampler_series_free())
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_cfg_sampler_fetch(const char *ta, const char *name,
+                                       tapi_cfg_sampler_series *series);
+
+/**
+ * Get index of a counter in a time series.
+ *
+ * @param[in]  series   Time series
+ * @param[in]  counter  Counter name
+ * @param[out] idx      Where to save the index
+ *
+ * @return Status code.
+ * @retval TE_ENOENT    There is no such counter.
+ */
+extern te_errno tapi_cfg_sampler_counter_idx(
+                                const tapi_cfg_sampler_series *series,
+                                const char *counter, unsigned int *idx);
+
+/**
+ * Release memory allocated for a time series.
+ *
+ * @param series        Time series
+ */
+extern void tapi_cfg_sampler_series_free(tapi_cfg_sampler_series *series);
+
+/**@} <!-- END tapi_conf_sampler --> */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_TAPI_CFG_SAMPLER_H__ */
@@ -125,6 +125,34 @@ extern te_errno tapi_netns_add_ta(const char *host,
                                   const char *ld_preload,
                                   te_bool ext_rcf_listener);
 
+/**
+ * Start a sub-agent serving the network namespace @p ns_name. The
+ * sub-agent is a process forked by the test agent @p ta, it is
+ * controlled via the connection of @p ta and has the same type.
+ *
+ * @param ta        Test agent name
+ * @param ns_name   The network namespace name
+ * @param sub_ta    The sub-agent name
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_netns_add_subagent(const char *ta,
+                                        const char *ns_name,
+                                        const char *sub_ta);
+
+/**
+ * Stop a sub-agent started with tapi_netns_add_subagent().
+ *
+ * @param ta        Test agent name
+ * @param ns_name   The network namespace name
+ * @param sub_ta    The sub-agent name
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_netns_del_subagent(const char *ta,
+                                        const char *ns_name,
+                                        const char *sub_ta);
+
 /**
  * Create network namespace and configure control network channel using
  * auxiliary macvlan interface. IP address is obtained using @b dhclient.
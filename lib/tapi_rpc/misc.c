@@ -853,18 +853,25 @@ rpc_pattern_receiver(rcf_rpc_server *rpcs, int s,
     if (args->recv_failed_ptr != NULL)
         *(args->recv_failed_ptr) = out.func_failed;
 
+    args->lost = out.lost;
+    args->duplicated = out.duplicated;
+    args->reordered = out.reordered;
+
     CHECK_RETVAL_VAR(pattern_receiver, out.retval,
                      !(out.retval <= 0 && out.retval >= -2), -1);
 
     TAPI_RPC_LOG(rpcs, pattern_receiver, "fd=%d, gen_func='%s', "
                  "gen_arg=[" TARPC_PAT_GEN_ARG_FMT "], iomux='%s', "
                  "time2wait=%u, duration_sec=%d, ignore_pollerr=%s",
-                 "%d received=%" TE_PRINTF_64 "u",
+                 "%d received=%" TE_PRINTF_64 "u lost=%" TE_PRINTF_64 "u "
+                 "duplicated=%" TE_PRINTF_64 "u "
+                 "reordered=%" TE_PRINTF_64 "u",
                  s, args->gen_func, TARPC_PAT_GEN_ARG_VAL(in.gen_arg),
                  iomux2str(args->iomux), args->time2wait,
                  args->duration_sec,
                  (args->ignore_pollerr ? "TRUE" : "FALSE"),
-                 out.retval, out.bytes);
+                 out.retval, out.bytes, out.lost, out.duplicated,
+                 out.reordered);
     RETVAL_INT(pattern_receiver, out.retval);
 }
 
@@ -207,6 +207,58 @@ tapi_netns_add_ta(const char *host, const char *ns_name, const char *ta_name,
     return rc;
 }
 
+/* See description in tapi_namespaces.h */
+te_errno
+tapi_netns_add_subagent(const char *ta, const char *ns_name,
+                        const char *sub_ta)
+{
+    char        confstr[CONFSTR_LEN];
+    char        ta_type[RCF_MAX_NAME];
+    int         res;
+    te_errno    rc;
+
+    rc = rcf_ta_name2type(ta, ta_type);
+    if (rc != 0)
+        return rc;
+
+    res = snprintf(confstr, sizeof(confstr), "parent=%s:", ta);
+    if (res >= (int)sizeof(confstr))
+        return TE_RC(TE_TAPI, TE_ESMALLBUF);
+
+    rc = cfg_add_instance_fmt(NULL, CVT_NONE, NULL,
+                              "/agent:%s/namespace:/net:%s/subagent:%s",
+                              ta, ns_name, sub_ta);
+    if (rc != 0)
+        return rc;
+
+    rc = rcf_add_ta(sub_ta, ta_type, "rcfsub", confstr, 0);
+    if (rc != 0)
+    {
+        cfg_del_instance_fmt(FALSE,
+                             "/agent:%s/namespace:/net:%s/subagent:%s",
+                             ta, ns_name, sub_ta);
+        return rc;
+    }
+
+    return cfg_synchronize_fmt(TRUE, "/agent:%s", sub_ta);
+}
+
+/* See description in tapi_namespaces.h */
+te_errno
+tapi_netns_del_subagent(const char *ta, const char *ns_name,
+                        const char *sub_ta)
+{
+    te_errno rc;
+
+    rc = rcf_del_ta(sub_ta);
+    if (rc != 0)
+        return rc;
+
+    return cfg_del_instance_fmt(FALSE,
+                                "/agent:%s/namespace:/net:%s/subagent:%s",
+                                ta, ns_name, sub_ta);
+}
+
 /**
  * Extract issued IP address from dhclient output.
  *
@@ -195,6 +195,16 @@ typedef struct tapi_pat_receiver {
     uint64_t            received;       /**< Number of received bytes */
     te_bool             recv_failed;    /**< @c TRUE if @b recv() call
                                              was failed */
+    uint64_t            lost;           /**< Number of lost bytes
+                                             (counted in 4-byte elements,
+                                             only for
+                                             @ref RPC_PATTERN_GEN_LCG_POS) */
+    uint64_t            duplicated;     /**< Number of duplicated messages
+                                             (only for
+                                             @ref RPC_PATTERN_GEN_LCG_POS) */
+    uint64_t            reordered;      /**< Number of reordered messages
+                                             (only for
+                                             @ref RPC_PATTERN_GEN_LCG_POS) */
 
     /*
      * These fields are alternative to fields without "_ptr". After
@@ -430,6 +440,29 @@ extern int rpc_pattern_sender(rcf_rpc_server *rpcs, int s,
  */
 #define RPC_PATTERN_GEN_LCG "tarpc_fill_buff_with_sequence_lcg"
 
+/**
+ * Fills the buffer with a message carrying a part of linear congruential
+ * sequence (see @ref RPC_PATTERN_GEN_LCG) prepended by 8-byte index of
+ * its first element in the sequence.
+ *
+ * It is intended for datagram sockets. @ref rpc_pattern_receiver() checks
+ * such messages one by one, resynchronising by the embedded index, so
+ * lost, duplicated or reordered messages do not make checking fail but
+ * are reported in @ref tapi_pat_receiver.
+ *
+ * @param buf            Buffer
+ * @param size           Message size in bytes (at least @c 8)
+ * @param arg            Pointer to @ref tarpc_pat_gen_arg structure, where
+ *                       - coef1 is @a x0 - element at index @b pos,
+ *                       - coef2 is @a a - multiplying constant,
+ *                       - coef3 is @a c - additive constant,
+ *                       - offset should be @c 0,
+ *                       - pos is index of the next element
+ *
+ * @return 0 on success
+ */
+#define RPC_PATTERN_GEN_LCG_POS "tarpc_fill_buff_with_sequence_lcg_pos"
+
 /**
  * @def TARPC_PAT_GEN_ARG_FMT
  * Macro for logging the @ref tarpc_pat_gen_arg structure members.
@@ -437,12 +470,12 @@ extern int rpc_pattern_sender(rcf_rpc_server *rpcs, int s,
  *
  * Example:
  * @code
- * tarpc_pat_gen_arg pattern_gen_args = {1,2,3,4};
+ * tarpc_pat_gen_arg pattern_gen_args = {1,2,3,4,5};
  * RING("pattern generator coeffs are "TARPC_PAT_GEN_ARG_FMT,
  *      TARPC_PAT_GEN_ARG_VAL(pattern_gen_args));
  * @endcode
  */
-#define TARPC_PAT_GEN_ARG_FMT "%u, %u, %u, %u"
+#define TARPC_PAT_GEN_ARG_FMT "%u, %u, %u, %u, %" TE_PRINTF_64 "u"
 
 /**
  * @def TARPC_PAT_GEN_ARG_VAL
@@ -451,13 +484,14 @@ extern int rpc_pattern_sender(rcf_rpc_server *rpcs, int s,
  *
  * Example:
  * @code
- * tarpc_pat_gen_arg pattern_gen_args = {1,2,3,4};
+ * tarpc_pat_gen_arg pattern_gen_args = {1,2,3,4,5};
  * RING("pattern generator coeffs are "TARPC_PAT_GEN_ARG_FMT,
  *      TARPC_PAT_GEN_ARG_VAL(pattern_gen_args));
  * @endcode
  */
 #define TARPC_PAT_GEN_ARG_VAL(_gen_arg) \
-  (_gen_arg).offset, (_gen_arg).coef1, (_gen_arg).coef2, (_gen_arg).coef3
+  (_gen_arg).offset, (_gen_arg).coef1, (_gen_arg).coef2, (_gen_arg).coef3, \
+  (_gen_arg).pos
 
 /**
  * Patterned data receiver. Data may be received using IO multiplexing or not,
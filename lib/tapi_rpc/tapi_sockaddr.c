@@ -59,44 +59,180 @@ tapi_get_random_port(void)
     return rand_range(MIN_AVAILABLE_PORT, MAX_AVAILABLE_PORT);
 }
 
-/* See description in tapi_sockaddr.h */
-te_errno
-tapi_allocate_port(struct rcf_rpc_server *pco, uint16_t *p_port)
-{
-    static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
-
-    int  rc;
-    int  port;
+/** Mutex protecting the global port counter */
+static pthread_mutex_t port_alloc_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-    /* NOTE: if scheme of port allocation will be changed,
-       implementation of tapi_allocate_port_range() also should be fixed! */
-    pthread_mutex_lock(&mutex);
+/**
+ * Get the first candidate port from the global port counter
+ * (/volatile:/sockaddr_port:) which keeps ports unique among
+ * test agents. It should be called with @ref port_alloc_mutex held.
+ *
+ * @param[out] port     Candidate port
+ *
+ * @return Status code.
+ */
+static te_errno
+tapi_port_counter_next(int *port)
+{
+    te_errno rc;
+    int      value;
 
-    rc = cfg_get_instance_int_fmt(&port, "/volatile:/sockaddr_port:");
+    rc = cfg_get_instance_int_fmt(&value, "/volatile:/sockaddr_port:");
     if (rc != 0)
     {
-        pthread_mutex_unlock(&mutex);
         ERROR("Failed to get /volatile:/sockaddr_port:: %r", rc);
         return rc;
     }
-    if (port < 0 || port > 0xffff)
+    if (value < 0 || value > 0xffff)
     {
-        pthread_mutex_unlock(&mutex);
-        ERROR("Wrong value %d is got from /volatile:/sockaddr_port:", port);
+        ERROR("Wrong value %d is got from /volatile:/sockaddr_port:", value);
         return TE_EINVAL;
     }
-    if ((port < MIN_AVAILABLE_PORT) || (port >= MAX_AVAILABLE_PORT))
+    if ((value < MIN_AVAILABLE_PORT) || (value >= MAX_AVAILABLE_PORT))
     {
         /* Random numbers generator should be initialized earlier */
-        port = MIN_AVAILABLE_PORT +
+        value = MIN_AVAILABLE_PORT +
                 rand_range(0, MAX_AVAILABLE_PORT - MIN_AVAILABLE_PORT);
     }
     else
     {
-        port++;
+        value++;
     }
 
-    /* Check that port is free */
+    *port = value;
+
+    return 0;
+}
+
+/**
+ * Update the global port counter (/volatile:/sockaddr_port:).
+ * It should be called with @ref port_alloc_mutex held.
+ *
+ * @param port      The last allocated port
+ *
+ * @return Status code.
+ */
+static te_errno
+tapi_port_counter_set(int port)
+{
+    te_errno rc;
+
+    rc = cfg_set_instance_fmt(CFG_VAL(INT32, port),
+                              "/volatile:/sockaddr_port:");
+    if (rc != 0)
+        ERROR("Failed to set /volatile:/sockaddr_port:: %r", rc);
+
+    return rc;
+}
+
+/**
+ * Allocate consecutive ports using the allocator of the test agent
+ * (@path{doc/cm/cm_l4_port.yml}). The search starts from the port of
+ * the global counter and is done on the agent which skips ports used
+ * by sockets in the system and ports reserved before, so the number
+ * of Configurator requests does not depend on the number of busy ports.
+ * Allocated ports are added to the configuration tree, so they are
+ * released when the configuration is restored after the test.
+ *
+ * @param pco       RPC server which test agent allocates ports
+ * @param p_port    Location for allocated ports
+ * @param num       Number of ports
+ *
+ * @return Status code.
+ * @retval TE_ENOENT    The allocator is not supported by the agent.
+ */
+static te_errno
+tapi_allocate_port_ta(rcf_rpc_server *pco, uint16_t *p_port, int num)
+{
+    te_errno rc;
+    int      start;
+    int      range;
+    int      port;
+    int      i;
+
+    pthread_mutex_lock(&port_alloc_mutex);
+
+    rc = tapi_port_counter_next(&start);
+    if (rc != 0)
+        goto out;
+
+    rc = cfg_set_instance_fmt(CFG_VAL(INT32, start),
+                              "/agent:%s/l4_port:/alloc:/next:/start:",
+                              pco->ta);
+    if (rc != 0)
+        goto out;
+
+    rc = cfg_get_instance_int_fmt(&range,
+                                  "/agent:%s/l4_port:/alloc:/next:/range:",
+                                  pco->ta);
+    if (rc != 0)
+        goto out;
+
+    if (range != num)
+    {
+        rc = cfg_set_instance_fmt(CFG_VAL(INT32, num),
+                                  "/agent:%s/l4_port:/alloc:/next:/range:",
+                                  pco->ta);
+        if (rc != 0)
+            goto out;
+    }
+
+    rc = cfg_get_instance_int_fmt(&port, "/agent:%s/l4_port:/alloc:/next:",
+                                  pco->ta);
+    if (rc != 0)
+        goto out;
+
+    for (i = 0; i < num; i++)
+    {
+        rc = cfg_add_instance_fmt(NULL, CFG_VAL(NONE, NULL),
+                                  "/agent:%s/l4_port:/alloc:/allocated:%d",
+                                  pco->ta, port + i);
+        if (rc != 0)
+        {
+            ERROR("Failed to add allocated port %d: %r", port + i, rc);
+            /* The allocator is supported, do not fall back */
+            if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+                rc = TE_RC(TE_TAPI, TE_EFAIL);
+            goto out;
+        }
+
+        p_port[i] = port + i;
+    }
+
+    rc = tapi_port_counter_set(port + num - 1);
+
+out:
+    pthread_mutex_unlock(&port_alloc_mutex);
+
+    return rc;
+}
+
+/* See description in tapi_sockaddr.h */
+te_errno
+tapi_allocate_port(struct rcf_rpc_server *pco, uint16_t *p_port)
+{
+    int  rc;
+    int  port;
+
+    if (pco != NULL)
+    {
+        rc = tapi_allocate_port_ta(pco, p_port, 1);
+        if (TE_RC_GET_ERROR(rc) != TE_ENOENT)
+            return rc;
+    }
+
+    /* NOTE: if scheme of port allocation will be changed,
+       implementation of tapi_allocate_port_range() also should be fixed! */
+    pthread_mutex_lock(&port_alloc_mutex);
+
+    rc = tapi_port_counter_next(&port);
+    if (rc != 0)
+    {
+        pthread_mutex_unlock(&port_alloc_mutex);
+        return rc;
+    }
+
+    /* The agent has no port allocator, check that port is free via RPC */
     if (pco != NULL)
     {
         int port_max = MAX_AVAILABLE_PORT;
@@ -116,17 +252,14 @@ tapi_allocate_port(struct rcf_rpc_server *pco, uint16_t *p_port)
         }
     }
 
-    /* Set /volatile:/sockaddr_port */
-    rc = cfg_set_instance_fmt(CFG_VAL(INT32, port),
-                              "/volatile:/sockaddr_port:");
+    rc = tapi_port_counter_set(port);
     if (rc != 0)
     {
-        pthread_mutex_unlock(&mutex);
-        ERROR("Failed to set /volatile:/sockaddr_port:: %r", rc);
+        pthread_mutex_unlock(&port_alloc_mutex);
         return rc;
     }
 
-    pthread_mutex_unlock(&mutex);
+    pthread_mutex_unlock(&port_alloc_mutex);
 
     *p_port = (uint16_t)port;
 
@@ -153,6 +286,13 @@ tapi_allocate_port_range(struct rcf_rpc_server *pco,
     int         i;
     int         j;
 
+    if (pco != NULL && num > 0)
+    {
+        rc = tapi_allocate_port_ta(pco, p_port, num);
+        if (TE_RC_GET_ERROR(rc) != TE_ENOENT)
+            return rc;
+    }
+
     /** Try 3 times */
     for (i = 0; i < 3; i++)
     {
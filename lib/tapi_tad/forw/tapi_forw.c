@@ -315,8 +315,10 @@ tapi_forw_sendq_set_param(const char *ta, int sid,
  *
  * @param ta         name of TA, on which the send queue is situated
  * @param sid        RCF session ID.
- * @param param      Parameter name in human form ("size_max" or
- *                   "bandwidth")
+ * @param param      Parameter name in human form ("size_max",
+ *                   "size", "bandwidth") or statistics counter name
+ *                   ("sent", "dropped", "reordered", "jitter_avg",
+ *                   "jitter_max", jitter is in nanoseconds)
  * @param sendq_id   ID of the send queue.
  * @param val        Value of the parameter (OUT)
  *
@@ -31,7 +31,12 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <stddef.h>
+
 #include "te_errno.h"
+#include "te_kvpair.h"
+#include "te_sockaddr.h"
+#include "te_str.h"
 #include "rcf_api.h"
 #include "ndn_pcap.h"
 #include "logger_api.h"
@@ -276,3 +281,190 @@ tapi_pcap_pattern_add(const char *filter,
 
     return 0;
 }
+
+/* See the description in tapi_pcap.h */
+te_errno
+tapi_pcap_add_replay(asn_value **tmpl,
+                     const tapi_pcap_replay_params *params,
+                     asn_value **pdu)
+{
+    asn_value  *layer;
+    te_errno    rc;
+
+    if (tmpl == NULL || params == NULL || params->file == NULL)
+        return TE_RC(TE_TAPI, TE_EINVAL);
+
+    rc = tapi_tad_tmpl_ptrn_add_layer(tmpl, FALSE, ndn_pcap_filter,
+                                      "#pcap", &layer);
+    if (rc != 0)
+        return rc;
+
+    rc = asn_write_string(layer, params->file, "replay.file");
+    if (rc == 0)
+        rc = asn_write_int32(layer, params->timing, "replay.timing");
+    if (rc == 0 && params->timing == NDN_PCAP_REPLAY_SCALED)
+        rc = asn_write_int32(layer, params->speed, "replay.speed");
+    if (rc == 0)
+        rc = asn_write_int32(layer, params->loops, "replay.loops");
+    if (rc == 0 && params->batch != 0)
+        rc = asn_write_int32(layer, params->batch, "replay.batch");
+    if (rc != 0)
+    {
+        ERROR("Failed to fill in PCAP replay specification: %r", rc);
+        return rc;
+    }
+
+    if (pdu != NULL)
+        *pdu = layer;
+
+    return 0;
+}
+
+/**
+ * Write address and port of a flow to PCAP rewriting rule.
+ *
+ * @param rule          Rewriting rule
+ * @param sa            Address and port (may be @c NULL)
+ * @param addr_label    Label of the address
+ * @param port_label    Label of the port
+ *
+ * @return Status code.
+ */
+static te_errno
+tapi_pcap_rewrite_write_addr(asn_value *rule, const struct sockaddr *sa,
+                             const char *addr_label, const char *port_label)
+{
+    te_errno rc = 0;
+
+    if (sa == NULL)
+        return 0;
+
+    if (!te_sockaddr_is_wildcard(sa))
+    {
+        rc = asn_write_value_field(rule, te_sockaddr_get_netaddr(sa),
+                                   te_netaddr_get_size(sa->sa_family),
+                                   addr_label);
+    }
+    if (rc == 0 && te_sockaddr_get_port(sa) != 0)
+    {
+        rc = asn_write_int32(rule, ntohs(te_sockaddr_get_port(sa)),
+                             port_label);
+    }
+
+    return rc;
+}
+
+/* See the description in tapi_pcap.h */
+te_errno
+tapi_pcap_replay_add_rewrite(asn_value *pdu,
+                             const struct sockaddr *match_src,
+                             const struct sockaddr *match_dst,
+                             const struct sockaddr *new_src,
+                             const struct sockaddr *new_dst)
+{
+    asn_value  *rule;
+    te_errno    rc;
+
+    if (pdu == NULL)
+        return TE_RC(TE_TAPI, TE_EINVAL);
+
+    rule = asn_init_value(ndn_pcap_rewrite);
+    if (rule == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    rc = tapi_pcap_rewrite_write_addr(rule, match_src,
+                                      "src-addr", "src-port");
+    if (rc == 0)
+        rc = tapi_pcap_rewrite_write_addr(rule, match_dst,
+                                          "dst-addr", "dst-port");
+    if (rc == 0)
+        rc = tapi_pcap_rewrite_write_addr(rule, new_src,
+                                          "new-src-addr", "new-src-port");
+    if (rc == 0)
+        rc = tapi_pcap_rewrite_write_addr(rule, new_dst,
+                                          "new-dst-addr", "new-dst-port");
+    if (rc == 0)
+        rc = asn_insert_indexed(pdu, rule, -1, "replay.rewrite");
+
+    if (rc != 0)
+    {
+        ERROR("Failed to add PCAP rewriting rule: %r", rc);
+        asn_free_value(rule);
+    }
+
+    return rc;
+}
+
+/* See the description in tapi_pcap.h */
+te_errno
+tapi_pcap_replay_get_stats(const char *ta_name, int sid,
+                           csap_handle_t csap,
+                           tapi_pcap_replay_stats *stats)
+{
+    static const struct {
+        const char *name;
+        size_t      offset;
+    } fields[] = {
+#define REPLAY_STATS_FIELD(_name) \
+        { #_name, offsetof(tapi_pcap_replay_stats, _name) }
+        REPLAY_STATS_FIELD(pkts),
+        REPLAY_STATS_FIELD(bytes),
+        REPLAY_STATS_FIELD(loops),
+        REPLAY_STATS_FIELD(requested_ns),
+        REPLAY_STATS_FIELD(duration_ns),
+        REPLAY_STATS_FIELD(max_lag_ns),
+#undef REPLAY_STATS_FIELD
+    };
+
+    char            buf[RCF_MAX_VAL] = "";
+    te_kvpair_h     kvpairs;
+    const char     *value;
+    uintmax_t       num;
+    unsigned int    i;
+    te_errno        rc;
+
+    rc = rcf_ta_csap_param(ta_name, sid, csap, CSAP_PARAM_REPLAY_STATS,
+                           sizeof(buf), buf);
+    if (rc != 0)
+    {
+        ERROR("Failed to get replay statistics of CSAP %u on TA %s: %r",
+              csap, ta_name, rc);
+        return rc;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+
+    te_kvpair_init(&kvpairs);
+    rc = te_kvpair_from_str(buf, &kvpairs);
+    for (i = 0; rc == 0 && i < TE_ARRAY_LEN(fields); i++)
+    {
+        value = te_kvpairs_get(&kvpairs, fields[i].name);
+        if (value == NULL)
+        {
+            ERROR("Replay statistics '%s' lacks '%s'", buf, fields[i].name);
+            rc = TE_RC(TE_TAPI, TE_EPROTO);
+            break;
+        }
+
+        rc = te_strtoumax(value, 10, &num);
+        if (rc == 0)
+            *(uint64_t *)((uint8_t *)stats + fields[i].offset) = num;
+    }
+    te_kvpair_fini(&kvpairs);
+
+    if (rc != 0)
+        return rc;
+
+    if (stats->requested_ns != 0)
+    {
+        stats->requested_pps = stats->pkts * 1e9 / stats->requested_ns;
+        stats->requested_bps = stats->bytes * 8e9 / stats->requested_ns;
+    }
+    if (stats->duration_ns != 0)
+    {
+        stats->pps = stats->pkts * 1e9 / stats->duration_ns;
+        stats->bps = stats->bytes * 8e9 / stats->duration_ns;
+    }
+
+    return 0;
+}
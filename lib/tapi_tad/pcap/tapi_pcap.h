@@ -22,6 +22,9 @@
 #if HAVE_NETINET_ETHER_H
 #include <netinet/ether.h>
 #endif
+#if HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
 
 #include "te_stdint.h"
 #include "te_defs.h"
@@ -128,6 +131,94 @@ extern int tapi_pcap_pattern_add(const char *filter,
                                  const int   filter_id,
                                  asn_value **pattern);
 
+/** Parameters of replay of a capture file by Ethernet-PCAP CSAP */
+typedef struct tapi_pcap_replay_params {
+    const char             *file;       /**< pcap/pcapng file on TA */
+    ndn_pcap_replay_timing  timing;     /**< Timing of packets */
+    unsigned int            speed;      /**< Speed in percents of
+                                             the original one (used with
+                                             scaled timing only) */
+    unsigned int            loops;      /**< Number of loops,
+                                             @c 0 - until stop */
+    unsigned int            batch;      /**< Maximum number of packets
+                                             passed to the media at once,
+                                             @c 0 - default */
+} tapi_pcap_replay_params;
+
+/**
+ * Add Ethernet-PCAP PDU with replay of a capture file to a traffic
+ * template. The template may be sent by Ethernet-PCAP CSAP using
+ * tapi_tad_trsend_start().
+ *
+ * @param tmpl          Location of the traffic template
+ *                      (allocated if @c NULL)
+ * @param params        Replay parameters
+ * @param pdu           Location for the added PDU (may be @c NULL)
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_pcap_add_replay(asn_value **tmpl,
+                                     const tapi_pcap_replay_params *params,
+                                     asn_value **pdu);
+
+/**
+ * Add rewriting of addresses and ports of a flow to Ethernet-PCAP PDU
+ * with replay of a capture file. Rules are checked in order they are
+ * added, the first matching one is applied to a packet.
+ *
+ * @param pdu           Ethernet-PCAP PDU
+ * @param match_src     Source address and port of the flow, unspecified
+ *                      address/zero port means any (may be @c NULL)
+ * @param match_dst     Destination address and port of the flow
+ *                      (may be @c NULL)
+ * @param new_src       New source address and port, unspecified
+ *                      address/zero port means no change
+ *                      (may be @c NULL)
+ * @param new_dst       New destination address and port
+ *                      (may be @c NULL)
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_pcap_replay_add_rewrite(asn_value *pdu,
+                                        const struct sockaddr *match_src,
+                                        const struct sockaddr *match_dst,
+                                        const struct sockaddr *new_src,
+                                        const struct sockaddr *new_dst);
+
+/** Statistics of the last replay of a capture file */
+typedef struct tapi_pcap_replay_stats {
+    uint64_t    pkts;           /**< Number of sent packets */
+    uint64_t    bytes;          /**< Number of sent bytes */
+    uint64_t    loops;          /**< Number of completed loops */
+    uint64_t    requested_ns;   /**< Duration of the replay in accordance
+                                     with requested timing
+                                     (@c 0 for maximum rate) */
+    uint64_t    duration_ns;    /**< Achieved duration of the replay */
+    uint64_t    max_lag_ns;     /**< Maximum delay of a packet against
+                                     requested timing */
+    double      requested_pps;  /**< Requested packet rate
+                                     (@c 0 for maximum rate) */
+    double      requested_bps;  /**< Requested bit rate
+                                     (@c 0 for maximum rate) */
+    double      pps;            /**< Achieved packet rate */
+    double      bps;            /**< Achieved bit rate */
+} tapi_pcap_replay_stats;
+
+/**
+ * Get statistics of the current (or the last) replay of a capture file
+ * by Ethernet-PCAP CSAP.
+ *
+ * @param ta_name       Test Agent name
+ * @param sid           RCF session
+ * @param csap          CSAP handle
+ * @param stats         Location for the statistics
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_pcap_replay_get_stats(const char *ta_name, int sid,
+                                           csap_handle_t csap,
+                                           tapi_pcap_replay_stats *stats);
+
 #endif /* __TE_TAPI_PCAP_H__ */
 
 /**@} <!-- END tapi_tad_pcap --> */
@@ -27,6 +27,7 @@
 #include "te_defs.h"
 #include "te_errno.h"
 #include "te_str.h"
+#include "te_kvpair.h"
 #include "tad_common.h"
 
 #include "logger_api.h"
@@ -636,6 +637,66 @@ tapi_tad_csap_get_no_match_pkts(const char *ta_name, int session,
     RETURN_RC(0);
 }
 
+/* See the description in tapi_tad.h */
+te_errno
+tapi_tad_csap_get_recv_stats(const char *ta_name, int session,
+                             csap_handle_t csap_id,
+                             tapi_tad_recv_stats *stats)
+{
+    static const struct {
+        const char *name;
+        size_t      offset;
+    } fields[] = {
+#define RECV_STATS_FIELD(_name) \
+        { #_name, offsetof(tapi_tad_recv_stats, _name) }
+        RECV_STATS_FIELD(matched),
+        RECV_STATS_FIELD(unmatched),
+        RECV_STATS_FIELD(bytes),
+        RECV_STATS_FIELD(match_ns),
+        RECV_STATS_FIELD(media_drops),
+        RECV_STATS_FIELD(queued),
+        RECV_STATS_FIELD(queue_max),
+        RECV_STATS_FIELD(queue_drops),
+#undef RECV_STATS_FIELD
+    };
+
+    char            buf[RCF_MAX_VAL] = "";
+    te_kvpair_h     kvpairs;
+    const char     *value;
+    uintmax_t       num;
+    unsigned int    i;
+    te_errno        rc;
+
+    rc = rcf_ta_csap_param(ta_name, session, csap_id,
+                           CSAP_PARAM_RECV_STATS, sizeof(buf), buf);
+    if (rc != 0)
+    {
+        ERROR("Failed to get receive statistics of CSAP %u on TA %s: %r",
+              csap_id, ta_name, rc);
+        return rc;
+    }
+
+    te_kvpair_init(&kvpairs);
+    rc = te_kvpair_from_str(buf, &kvpairs);
+    for (i = 0; rc == 0 && i < TE_ARRAY_LEN(fields); i++)
+    {
+        value = te_kvpairs_get(&kvpairs, fields[i].name);
+        if (value == NULL)
+        {
+            ERROR("Receive statistics '%s' lacks '%s'", buf, fields[i].name);
+            rc = TE_RC(TE_TAPI, TE_EPROTO);
+            break;
+        }
+
+        rc = te_strtoumax(value, 10, &num);
+        if (rc == 0)
+            *(uint64_t *)((uint8_t *)stats + fields[i].offset) = num;
+    }
+    te_kvpair_fini(&kvpairs);
+
+    return rc;
+}
+
 /**
  * Destroy CSAP by its Configurator handle using RCF.
  *
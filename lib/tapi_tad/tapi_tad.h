@@ -366,6 +366,37 @@ extern te_errno tapi_tad_csap_get_no_match_pkts(const char *ta_name,
                                                 csap_handle_t csap_id,
                                                 unsigned int *val);
 
+/** Statistics of the receive operation on a CSAP */
+typedef struct tapi_tad_recv_stats {
+    uint64_t matched;       /**< Number of matched packets */
+    uint64_t unmatched;     /**< Number of unmatched packets */
+    uint64_t bytes;         /**< Number of bytes read from the media */
+    uint64_t match_ns;      /**< Time spent in matching, nanoseconds */
+    uint64_t media_drops;   /**< Number of packets dropped by the media
+                                 (e.g. by the kernel) */
+    uint64_t queued;        /**< Number of packets in the queue on
+                                 the Test Agent */
+    uint64_t queue_max;     /**< Maximum number of packets in the queue */
+    uint64_t queue_drops;   /**< Number of packets dropped since
+                                 the queue is full */
+} tapi_tad_recv_stats;
+
+/**
+ * Get statistics of the current (or the last) receive operation
+ * on a CSAP.
+ *
+ * @param ta_name       Test Agent name
+ * @param session       RCF session identifier
+ * @param csap_id       CSAP handle
+ * @param stats         Location for the statistics
+ *
+ * @return Status code.
+ */
+extern te_errno tapi_tad_csap_get_recv_stats(const char *ta_name,
+                                             int session,
+                                             csap_handle_t csap_id,
+                                             tapi_tad_recv_stats *stats);
+
 /**
  * Finalise all CSAP instances on all Test Agents using RCF.
  *
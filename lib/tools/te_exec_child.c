@@ -16,6 +16,9 @@
 #if HAVE_FCNTL_H
 #include <fcntl.h>
 #endif
+#if HAVE_SPAWN_H
+#include <spawn.h>
+#endif
 
 #include "logger_api.h"
 
@@ -25,6 +28,11 @@
 
 #define VALID_FD_PTR(ptr) ((ptr) != NULL && (ptr) != TE_EXEC_CHILD_DEV_NULL_FD)
 
+#if defined(HAVE_SPAWN_H) && defined(HAVE_POSIX_SPAWNP)
+#define WITH_POSIX_SPAWN
+extern char **environ;
+#endif
+
 static void
 maybe_open_dev_null(const int *fd_arg, te_bool input, int *dev_null_fd)
 {
@@ -182,6 +190,10 @@ add_exec_param(pid_t pid, const te_exec_param *exec_param)
                 break;
             }
 
+            case TE_EXEC_CGROUP:
+                /* The cgroup is joined before other parameters are applied */
+                break;
+
             default:
                 ERROR("Unsupported process parameter. type = %d", iter->type);
                 return TE_EINVAL;
@@ -194,14 +206,200 @@ add_exec_param(pid_t pid, const te_exec_param *exec_param)
     return rc;
 }
 
+/**
+ * Open cgroup.procs file of the cgroup specified in process parameters.
+ * The file is opened by the parent to report errors properly, the child
+ * moves itself to the cgroup by writing to the file before exec, so that
+ * no process started by the program may escape the cgroup.
+ *
+ * @param exec_param    Process parameters (may be @c NULL)
+ * @param[out] fd       File descriptor or @c -1 if no cgroup is specified
+ *
+ * @return Status code.
+ */
+static te_errno
+cgroup_procs_open(const te_exec_param *exec_param, int *fd)
+{
+    const te_exec_cgroup_param *cgroup = NULL;
+    const te_exec_param *iter;
+    te_string path = TE_STRING_INIT;
+    te_errno rc = 0;
+
+    *fd = -1;
+    if (exec_param == NULL)
+        return 0;
+
+    for (iter = exec_param; iter->type != TE_EXEC_END; iter++)
+    {
+        if (iter->type == TE_EXEC_CGROUP)
+            cgroup = iter->data;
+    }
+    if (cgroup == NULL)
+        return 0;
+
+    te_string_append(&path, "%s/cgroup.procs", cgroup->path);
+    *fd = open(path.ptr, O_WRONLY | O_CLOEXEC);
+    if (*fd < 0)
+    {
+        rc = te_rc_os2te(errno);
+        ERROR("Failed to open '%s': %r", path.ptr, rc);
+    }
+    te_string_free(&path);
+
+    return rc;
+}
+
+#ifdef WITH_POSIX_SPAWN
+/**
+ * Check whether the child may be started with posix_spawn(), i.e.
+ * nothing has to be done in the child before exec except what
+ * posix_spawn() file actions and attributes can do.
+ *
+ * @param uid           User ID to execute the file
+ * @param exec_param    Process parameters (may be @c NULL)
+ * @param child_fds     Child ends of pipes to stdin/stdout/stderr
+ *                      (@c -1 if there is no pipe)
+ *
+ * @return @c TRUE if posix_spawn() may be used.
+ */
+static te_bool
+spawn_is_possible(uid_t uid, const te_exec_param *exec_param,
+                  const int child_fds[3])
+{
+    const te_exec_param *iter;
+    unsigned int i;
+
+    if (uid != (uid_t)(-1))
+        return FALSE;
+
+    /* Keep file actions simple: pipe ends must not clash with stdio */
+    for (i = 0; i < 3; i++)
+    {
+        if (child_fds[i] >= 0 && child_fds[i] <= STDERR_FILENO)
+            return FALSE;
+    }
+
+    if (exec_param == NULL)
+        return TRUE;
+
+    for (iter = exec_param; iter->type != TE_EXEC_END; iter++)
+    {
+        switch (iter->type)
+        {
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP
+            case TE_EXEC_WORKDIR:
+                break;
+#endif
+
+            default:
+                return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * Start the child with posix_spawn(). It does not copy address space
+ * of the caller, so it is much cheaper than fork() for big processes.
+ *
+ * @param file          File to execute
+ * @param argv          Command line arguments
+ * @param envp          Environment variables or @c NULL
+ * @param fd_args       Locations of stdin/stdout/stderr descriptors
+ *                      passed to te_exec_child()
+ * @param child_fds     Child ends of pipes to stdin/stdout/stderr
+ * @param exec_param    Process parameters (may be @c NULL)
+ *
+ * @return PID of the child or @c -1 on failure.
+ */
+static pid_t
+spawn_child(const char *file, char *const argv[], char *const envp[],
+            int *const fd_args[3], const int child_fds[3],
+            const te_exec_param *exec_param)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    const te_exec_param *iter;
+    pid_t pid = -1;
+    int rc;
+    int i;
+
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return -1;
+    if (posix_spawnattr_init(&attr) != 0)
+    {
+        posix_spawn_file_actions_destroy(&actions);
+        return -1;
+    }
+
+    /* Make the child a process group leader as fork() path does */
+    rc = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    if (rc == 0)
+        rc = posix_spawnattr_setpgroup(&attr, 0);
+
+    for (i = 0; i < 3 && rc == 0; i++)
+    {
+        if (VALID_FD_PTR(fd_args[i]))
+        {
+            rc = posix_spawn_file_actions_adddup2(&actions, child_fds[i], i);
+            if (rc == 0)
+                rc = posix_spawn_file_actions_addclose(&actions, child_fds[i]);
+        }
+        else if (fd_args[i] == TE_EXEC_CHILD_DEV_NULL_FD)
+        {
+            rc = posix_spawn_file_actions_addopen(&actions, i, "/dev/null",
+                                                  i == STDIN_FILENO ?
+                                                  O_RDONLY : O_WRONLY, 0);
+        }
+    }
+
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP
+    for (iter = exec_param; rc == 0 && iter != NULL &&
+         iter->type != TE_EXEC_END; iter++)
+    {
+        if (iter->type == TE_EXEC_WORKDIR)
+        {
+            const te_exec_workdir_param *data = iter->data;
+
+            rc = posix_spawn_file_actions_addchdir_np(&actions,
+                                                      data->workdir);
+        }
+    }
+#else
+    UNUSED(iter);
+    UNUSED(exec_param);
+#endif
+
+    if (rc == 0)
+    {
+        rc = posix_spawnp(&pid, file, &actions, &attr, argv,
+                          envp == NULL ? environ : envp);
+    }
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (rc != 0)
+    {
+        errno = rc;
+        return -1;
+    }
+
+    return pid;
+}
+#endif
+
 pid_t
 te_exec_child(const char *file, char *const argv[],
               char *const envp[], uid_t uid, int *in_fd,
               int *out_fd, int *err_fd,
               const te_exec_param *exec_param)
 {
-    int   pid;
+    int   pid = -1;
     int   in_pipe[2], out_pipe[2], err_pipe[2];
+    int   cgroup_fd = -1;
+    int   saved_errno;
 
     if (file == NULL || argv == NULL)
     {
@@ -234,7 +432,27 @@ te_exec_child(const char *file, char *const argv[],
         return -1;
     }
 
-    pid = fork();
+#ifdef WITH_POSIX_SPAWN
+    {
+        int *const fd_args[3] = { in_fd, out_fd, err_fd };
+        int child_fds[3] = {
+            VALID_FD_PTR(in_fd) ? in_pipe[0] : -1,
+            VALID_FD_PTR(out_fd) ? out_pipe[1] : -1,
+            VALID_FD_PTR(err_fd) ? err_pipe[1] : -1,
+        };
+
+        /*
+         * If posix_spawn() fails, fall back to fork() which reports
+         * exec failures in the usual way, i.e. by child exit status.
+         */
+        if (spawn_is_possible(uid, exec_param, child_fds))
+            pid = spawn_child(file, argv, envp, fd_args, child_fds,
+                              exec_param);
+    }
+#endif
+
+    if (pid < 0 && cgroup_procs_open(exec_param, &cgroup_fd) == 0)
+        pid = fork();
     if (pid == 0)
     {
         int pipe_fd[3] = { 0, 1, 2};
@@ -245,6 +463,19 @@ te_exec_child(const char *file, char *const argv[],
 
         /* Set us to be the process leader */
         setpgid(getpid(), getpid());
+
+        /* Join the cgroup before any privileges are dropped */
+        if (cgroup_fd >= 0)
+        {
+            if (write(cgroup_fd, "0", 1) != 1)
+            {
+                ERROR("%s: failed to move the child to cgroup: %s",
+                      __func__, strerror(errno));
+                _exit(EXIT_FAILURE);
+            }
+            close(cgroup_fd);
+        }
+
         if (uid != (uid_t)(-1) && setuid(uid) != 0)
         {
             ERROR("Failed to set user %d before running program \"%s\"",
@@ -365,6 +596,10 @@ te_exec_child(const char *file, char *const argv[],
         _exit(EXIT_FAILURE);
     }
 
+    saved_errno = errno;
+    if (cgroup_fd >= 0)
+        close(cgroup_fd);
+
     if (VALID_FD_PTR(in_fd))
         close(in_pipe[0]);
     if (VALID_FD_PTR(out_fd))
@@ -388,6 +623,7 @@ te_exec_child(const char *file, char *const argv[],
             close(err_pipe[0]);
             *err_fd = -1;
         }
+        errno = saved_errno;
     }
     else
     {
@@ -40,6 +40,8 @@ typedef enum te_exec_param_type {
     TE_EXEC_PRIORITY,
     /** Set process working directory */
     TE_EXEC_WORKDIR,
+    /** Move process to a cgroup v2 before execution */
+    TE_EXEC_CGROUP,
 
     /** Last kind marker */
     TE_EXEC_END
@@ -109,6 +111,16 @@ typedef struct te_exec_workdir_param {
     char *workdir;
 } te_exec_workdir_param;
 
+/** Data specific for cgroup type (@p TE_EXEC_CGROUP). */
+typedef struct te_exec_cgroup_param {
+    /**
+     * Path to cgroup v2 directory, e.g. /sys/fs/cgroup/te/job. The child
+     * joins the cgroup before executing the program, so all processes
+     * it creates are accounted in the cgroup as well.
+     */
+    char *path;
+} te_exec_cgroup_param;
+
 /**
  * Function to base system()-like and popen()-like functions on it.
  * You MUST use uid parameter instead of "su - user -c", because su makes
@@ -121,6 +133,12 @@ typedef struct te_exec_workdir_param {
  *    to @p in_fd @p out_fd @p err_fd;
  * 4) executes specified program in the child process;
  *
+ * If neither @p uid nor process parameters (except working directory
+ * when the platform allows to change it on spawn) require the child to
+ * run code before exec, the child is started with posix_spawn() which
+ * does not copy address space of the caller and so is much cheaper
+ * for big multithreaded processes.
+ *
  * @note if a file descriptor location is @c NULL, copy of the respective
  *       standard file descriptor will be inherited by the child;
  *       if a file descriptor location is @c TE_EXEC_CHILD_DEV_NULL_FD,
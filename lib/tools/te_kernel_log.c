@@ -505,6 +505,8 @@ parser_data_processing(serial_parser_t *parser, char *buffer)
                      event->t_name);
                 event->status = TRUE;
                 event->count++;
+                if (parser->event_cb != NULL)
+                    parser->event_cb(parser, event);
                 break;
             }
         }
@@ -0,0 +1,400 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Performance counters registry
+ *
+ * Implementation of the registry of performance counters.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Perf"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#ifdef STDC_HEADERS
+#include <stdlib.h>
+#include <string.h>
+#endif
+#include <time.h>
+#include <pthread.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_alloc.h"
+#include "te_str.h"
+#include "te_string.h"
+#include "logger_api.h"
+#include "te_perf.h"
+
+/** Registered metric */
+typedef struct te_perf_metric {
+    struct te_perf_metric  *next;       /**< Next metric in the order
+                                             of names */
+    char                   *name;       /**< Metric name */
+    te_bool                 is_hist;    /**< Metric is a histogram */
+    union {
+        te_perf_counter     counter;    /**< Counter */
+        te_perf_hist        hist;       /**< Histogram */
+    } u;
+} te_perf_metric;
+
+/**
+ * Registered metrics sorted by name. Metrics are never removed,
+ * so the list is traversed without locking.
+ */
+static te_perf_metric *metrics = NULL;
+
+/** Lock serializing registration of metrics */
+static pthread_mutex_t metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Periodic dumping context */
+static struct {
+    pthread_mutex_t lock;       /**< Lock protecting the context */
+    pthread_cond_t  cond;       /**< Used to wake up the thread */
+    te_bool         started;    /**< The thread is started */
+    te_bool         stop;       /**< The thread should stop */
+    unsigned int    period;     /**< Dumping period, milliseconds */
+    pthread_t       thread;     /**< Dumping thread */
+} perf_log = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* Find a metric, the lock is not required */
+static te_perf_metric *
+te_perf_metric_find(const char *name, te_bool is_hist)
+{
+    te_perf_metric *m;
+
+    for (m = __atomic_load_n(&metrics, __ATOMIC_ACQUIRE); m != NULL;
+         m = __atomic_load_n(&m->next, __ATOMIC_ACQUIRE))
+    {
+        if (m->is_hist == is_hist && strcmp(m->name, name) == 0)
+            return m;
+    }
+
+    return NULL;
+}
+
+/* Find a metric, register it if it does not exist */
+static te_perf_metric *
+te_perf_metric_get(te_bool is_hist, const char *name_fmt, va_list ap)
+{
+    te_perf_metric  *m;
+    te_perf_metric **prev;
+    char            *name;
+
+    name = te_string_fmt_va(name_fmt, ap);
+
+    m = te_perf_metric_find(name, is_hist);
+    if (m != NULL)
+    {
+        free(name);
+        return m;
+    }
+
+    pthread_mutex_lock(&metrics_lock);
+
+    /* It might be registered by another thread in the meantime */
+    m = te_perf_metric_find(name, is_hist);
+    if (m != NULL)
+    {
+        pthread_mutex_unlock(&metrics_lock);
+        free(name);
+        return m;
+    }
+
+    m = TE_ALLOC(sizeof(*m));
+    m->name = name;
+    m->is_hist = is_hist;
+
+    for (prev = &metrics; *prev != NULL; prev = &(*prev)->next)
+    {
+        if (strcmp((*prev)->name, name) > 0)
+            break;
+    }
+
+    /* Publish the metric after it is completely initialized */
+    m->next = *prev;
+    __atomic_store_n(prev, m, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&metrics_lock);
+
+    return m;
+}
+
+/* See description in te_perf.h */
+te_perf_counter *
+te_perf_counter_get(const char *name_fmt, ...)
+{
+    te_perf_metric *m;
+    va_list         ap;
+
+    va_start(ap, name_fmt);
+    m = te_perf_metric_get(FALSE, name_fmt, ap);
+    va_end(ap);
+
+    return &m->u.counter;
+}
+
+/* See description in te_perf.h */
+te_perf_hist *
+te_perf_hist_get(const char *name_fmt, ...)
+{
+    te_perf_metric *m;
+    va_list         ap;
+
+    va_start(ap, name_fmt);
+    m = te_perf_metric_get(TRUE, name_fmt, ap);
+    va_end(ap);
+
+    return &m->u.hist;
+}
+
+/* See description in te_perf.h */
+const te_perf_counter *
+te_perf_counter_find(const char *name)
+{
+    te_perf_metric *m = te_perf_metric_find(name, FALSE);
+
+    return m == NULL ? NULL : &m->u.counter;
+}
+
+/* See description in te_perf.h */
+const te_perf_hist *
+te_perf_hist_find(const char *name)
+{
+    te_perf_metric *m = te_perf_metric_find(name, TRUE);
+
+    return m == NULL ? NULL : &m->u.hist;
+}
+
+/* Get upper bound of a histogram bucket */
+static uint64_t
+te_perf_bucket_max(unsigned int bucket)
+{
+    if (bucket == 0)
+        return 0;
+    if (bucket == TE_PERF_HIST_BUCKETS - 1)
+        return UINT64_MAX;
+
+    return (UINT64_C(1) << bucket) - 1;
+}
+
+/* See description in te_perf.h */
+void
+te_perf_hist_stats_get(const te_perf_hist *hist, te_perf_hist_stats *stats)
+{
+    uint64_t     buckets[TE_PERF_HIST_BUCKETS];
+    uint64_t     total = 0;
+    uint64_t     seen = 0;
+    unsigned int i;
+    struct {
+        unsigned int  percent;
+        uint64_t     *result;
+    } pcts[] = {
+        { 50, &stats->p50 },
+        { 90, &stats->p90 },
+        { 99, &stats->p99 },
+    };
+    unsigned int p = 0;
+
+    memset(stats, 0, sizeof(*stats));
+
+    for (i = 0; i < TE_PERF_HIST_BUCKETS; i++)
+    {
+        buckets[i] = __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+        total += buckets[i];
+    }
+    stats->count = __atomic_load_n(&hist->count, __ATOMIC_RELAXED);
+    stats->sum = __atomic_load_n(&hist->sum, __ATOMIC_RELAXED);
+    stats->max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+
+    if (total == 0)
+        return;
+
+    for (i = 0; i < TE_PERF_HIST_BUCKETS && p < TE_ARRAY_LEN(pcts); i++)
+    {
+        seen += buckets[i];
+        while (p < TE_ARRAY_LEN(pcts) &&
+               seen * 100 >= total * pcts[p].percent)
+        {
+            *pcts[p].result = MIN(te_perf_bucket_max(i), stats->max);
+            p++;
+        }
+    }
+}
+
+/* See description in te_perf.h */
+te_errno
+te_perf_foreach(te_perf_foreach_cb *cb, void *opaque)
+{
+    te_perf_metric *m;
+    te_errno        rc;
+
+    for (m = __atomic_load_n(&metrics, __ATOMIC_ACQUIRE); m != NULL;
+         m = __atomic_load_n(&m->next, __ATOMIC_ACQUIRE))
+    {
+        rc = cb(m->name, m->is_hist ? NULL : &m->u.counter,
+                m->is_hist ? &m->u.hist : NULL, opaque);
+        if (rc != 0)
+            return rc;
+    }
+
+    return 0;
+}
+
+/* Append a metric to the dump */
+static te_errno
+te_perf_dump_metric(const char *name, const te_perf_counter *counter,
+                    const te_perf_hist *hist, void *opaque)
+{
+    te_string          *dest = opaque;
+    te_perf_hist_stats  stats;
+
+    if (counter != NULL)
+    {
+        te_string_append(dest, "%s %" PRId64 "\n", name,
+                         te_perf_counter_value(counter));
+        return 0;
+    }
+
+    te_perf_hist_stats_get(hist, &stats);
+    te_string_append(dest, "%s count=%" PRIu64 " avg=%" PRIu64
+                     " p50=%" PRIu64 " p90=%" PRIu64 " p99=%" PRIu64
+                     " max=%" PRIu64 "\n", name, stats.count,
+                     stats.count == 0 ? 0 : stats.sum / stats.count,
+                     stats.p50, stats.p90, stats.p99, stats.max);
+    return 0;
+}
+
+/* See description in te_perf.h */
+void
+te_perf_dump(te_string *dest)
+{
+    te_perf_foreach(te_perf_dump_metric, dest);
+}
+
+/* Dump metrics to the log */
+static void
+te_perf_log_dump(void)
+{
+    te_string dump = TE_STRING_INIT;
+
+    te_perf_dump(&dump);
+    if (dump.len > 0)
+        RING("Performance counters:\n%s", dump.ptr);
+    te_string_free(&dump);
+}
+
+/* Thread dumping metrics periodically */
+static void *
+te_perf_log_thread(void *arg)
+{
+    struct timespec deadline;
+
+    UNUSED(arg);
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    pthread_mutex_lock(&perf_log.lock);
+    while (!perf_log.stop)
+    {
+        deadline.tv_sec += perf_log.period / 1000;
+        deadline.tv_nsec += (perf_log.period % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        while (!perf_log.stop &&
+               pthread_cond_timedwait(&perf_log.cond, &perf_log.lock,
+                                      &deadline) == 0)
+            ;
+
+        if (perf_log.stop)
+            break;
+
+        pthread_mutex_unlock(&perf_log.lock);
+        te_perf_log_dump();
+        pthread_mutex_lock(&perf_log.lock);
+    }
+    pthread_mutex_unlock(&perf_log.lock);
+
+    return NULL;
+}
+
+/* See description in te_perf.h */
+te_errno
+te_perf_log_start(void)
+{
+    pthread_condattr_t  attr;
+    const char         *period = getenv(TE_PERF_LOG_PERIOD_ENV);
+    te_errno            rc;
+    int                 ret;
+
+    if (period == NULL || *period == '\0')
+        return 0;
+
+    pthread_mutex_lock(&perf_log.lock);
+
+    if (perf_log.started)
+    {
+        pthread_mutex_unlock(&perf_log.lock);
+        return 0;
+    }
+
+    rc = te_strtoui(period, 0, &perf_log.period);
+    if (rc != 0 || perf_log.period == 0)
+    {
+        pthread_mutex_unlock(&perf_log.lock);
+        if (rc != 0)
+            ERROR("Invalid %s value '%s'", TE_PERF_LOG_PERIOD_ENV, period);
+        return rc;
+    }
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&perf_log.cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    perf_log.stop = FALSE;
+    ret = pthread_create(&perf_log.thread, NULL, te_perf_log_thread, NULL);
+    if (ret != 0)
+    {
+        pthread_cond_destroy(&perf_log.cond);
+        pthread_mutex_unlock(&perf_log.lock);
+        ERROR("Failed to start performance counters dumping: %s",
+              strerror(ret));
+        return TE_OS_RC(TE_MODULE_NONE, ret);
+    }
+
+    perf_log.started = TRUE;
+    pthread_mutex_unlock(&perf_log.lock);
+
+    return 0;
+}
+
+/* See description in te_perf.h */
+void
+te_perf_log_stop(void)
+{
+    pthread_mutex_lock(&perf_log.lock);
+    if (!perf_log.started)
+    {
+        pthread_mutex_unlock(&perf_log.lock);
+        return;
+    }
+
+    perf_log.stop = TRUE;
+    pthread_cond_signal(&perf_log.cond);
+    pthread_mutex_unlock(&perf_log.lock);
+
+    pthread_join(perf_log.thread, NULL);
+    pthread_cond_destroy(&perf_log.cond);
+    perf_log.started = FALSE;
+
+    te_perf_log_dump();
+}
@@ -0,0 +1,282 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Performance counters registry
+ *
+ * @defgroup te_tools_te_perf Performance counters
+ * @ingroup te_tools
+ * @{
+ *
+ * Process-wide registry of named counters and histograms used to see
+ * where time goes inside TE itself (RCF queues, command latencies,
+ * Configurator synchronization, etc.).
+ *
+ * Metrics are registered once by name and never removed, so
+ * a component looks a metric up (e.g. when a Test Agent is added)
+ * and keeps the pointer. Updates use atomic operations only and may
+ * be done from any thread without locking.
+ *
+ * Metric names are dot-separated words, e.g. @c "rcf.Agt_A.latency".
+ * They should not contain @c '/' and @c ':' since metrics of a Test
+ * Agent are exposed as Configurator instances (@c /agent/perf).
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ *
+ *
+ * @section te_tools_te_perf_example Example of usage
+ *
+ * @code
+ * te_perf_hist *latency = te_perf_hist_get("my.op.latency");
+ * uint64_t start = te_perf_now_us();
+ *
+ * do_operation();
+ * te_perf_hist_add(latency, te_perf_now_us() - start);
+ * @endcode
+ */
+
+#ifndef __TE_PERF_H__
+#define __TE_PERF_H__
+
+#include <time.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_stdint.h"
+#include "te_string.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of histogram buckets. Bucket @c 0 counts zero values,
+ * bucket @c i > 0 counts values in [2^(i - 1), 2^i), the last bucket
+ * counts all larger values as well.
+ */
+#define TE_PERF_HIST_BUCKETS    40
+
+/**
+ * Name of the environment variable with the period (in milliseconds)
+ * of metrics dumping to the log.
+ */
+#define TE_PERF_LOG_PERIOD_ENV  "TE_PERF_LOG_PERIOD"
+
+/**
+ * Counter. It may be used as a monotonic counter (events, bytes)
+ * or as a gauge (queue depth).
+ */
+typedef struct te_perf_counter te_perf_counter;
+
+/** Histogram of values, usually durations in microseconds */
+typedef struct te_perf_hist te_perf_hist;
+
+/** @cond NOT_DOCUMENTED */
+struct te_perf_counter {
+    int64_t value;
+};
+
+struct te_perf_hist {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[TE_PERF_HIST_BUCKETS];
+};
+/** @endcond */
+
+/** Snapshot of a histogram */
+typedef struct te_perf_hist_stats {
+    uint64_t count;     /**< Number of values */
+    uint64_t sum;       /**< Sum of values */
+    uint64_t max;       /**< Maximum value */
+    uint64_t p50;       /**< Median (upper bound of the bucket) */
+    uint64_t p90;       /**< 90th percentile (upper bound of the bucket) */
+    uint64_t p99;       /**< 99th percentile (upper bound of the bucket) */
+} te_perf_hist_stats;
+
+/**
+ * Find a counter by name, register it if it does not exist.
+ *
+ * @param name_fmt      Format string of the counter name
+ * @param ...           Format arguments
+ *
+ * @return Counter (never @c NULL).
+ */
+extern te_perf_counter *te_perf_counter_get(const char *name_fmt, ...)
+                                       __attribute__((format(printf, 1, 2)));
+
+/**
+ * Find a histogram by name, register it if it does not exist.
+ *
+ * @param name_fmt      Format string of the histogram name
+ * @param ...           Format arguments
+ *
+ * @return Histogram (never @c NULL).
+ */
+extern te_perf_hist *te_perf_hist_get(const char *name_fmt, ...)
+                                      __attribute__((format(printf, 1, 2)));
+
+/**
+ * Add a value to a counter.
+ *
+ * @param counter       Counter (nothing is done if it is @c NULL)
+ * @param delta         Value to add (may be negative)
+ */
+static inline void
+te_perf_counter_add(te_perf_counter *counter, int64_t delta)
+{
+    if (counter != NULL)
+        __atomic_fetch_add(&counter->value, delta, __ATOMIC_RELAXED);
+}
+
+/**
+ * Set a counter value (e.g. current queue depth).
+ *
+ * @param counter       Counter (nothing is done if it is @c NULL)
+ * @param value         New value
+ */
+static inline void
+te_perf_counter_set(te_perf_counter *counter, int64_t value)
+{
+    if (counter != NULL)
+        __atomic_store_n(&counter->value, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * Get a counter value.
+ *
+ * @param counter       Counter
+ *
+ * @return Counter value.
+ */
+static inline int64_t
+te_perf_counter_value(const te_perf_counter *counter)
+{
+    return __atomic_load_n(&counter->value, __ATOMIC_RELAXED);
+}
+
+/**
+ * Add a value to a histogram.
+ *
+ * @param hist          Histogram (nothing is done if it is @c NULL)
+ * @param value         Value to add
+ */
+static inline void
+te_perf_hist_add(te_perf_hist *hist, uint64_t value)
+{
+    unsigned int bucket;
+    uint64_t     max;
+
+    if (hist == NULL)
+        return;
+
+    bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+    if (bucket >= TE_PERF_HIST_BUCKETS)
+        bucket = TE_PERF_HIST_BUCKETS - 1;
+
+    __atomic_fetch_add(&hist->buckets[bucket], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->sum, value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+
+    max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&hist->max, &max, value, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+/**
+ * Get a snapshot of a histogram. Since the histogram may be updated
+ * concurrently, fields of the snapshot may be slightly inconsistent.
+ *
+ * @param hist          Histogram
+ * @param stats         Where to save the snapshot
+ */
+extern void te_perf_hist_stats_get(const te_perf_hist *hist,
+                                   te_perf_hist_stats *stats);
+
+/**
+ * Get current time to measure durations for histograms.
+ *
+ * @return Monotonic time in microseconds.
+ */
+static inline uint64_t
+te_perf_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * Function called for each registered metric.
+ *
+ * @param name          Metric name
+ * @param counter       Counter or @c NULL if it is a histogram
+ * @param hist          Histogram or @c NULL if it is a counter
+ * @param opaque        Opaque data
+ *
+ * @return Status code (iteration is stopped if it is not @c 0).
+ */
+typedef te_errno te_perf_foreach_cb(const char *name,
+                                    const te_perf_counter *counter,
+                                    const te_perf_hist *hist,
+                                    void *opaque);
+
+/**
+ * Call a function for each registered metric in the order of names.
+ *
+ * @param cb            Function to call
+ * @param opaque        Opaque data passed to the function
+ *
+ * @return Status code returned by the function.
+ */
+extern te_errno te_perf_foreach(te_perf_foreach_cb *cb, void *opaque);
+
+/**
+ * Find a registered counter.
+ *
+ * @param name          Counter name
+ *
+ * @return Counter or @c NULL if there is no such counter.
+ */
+extern const te_perf_counter *te_perf_counter_find(const char *name);
+
+/**
+ * Find a registered histogram.
+ *
+ * @param name          Histogram name
+ *
+ * @return Histogram or @c NULL if there is no such histogram.
+ */
+extern const te_perf_hist *te_perf_hist_find(const char *name);
+
+/**
+ * Append values of all registered metrics to a string,
+ * one metric per line.
+ *
+ * @param dest          String to append to
+ */
+extern void te_perf_dump(te_string *dest);
+
+/**
+ * Start a thread dumping all metrics to the log periodically.
+ * The period is taken from @c TE_PERF_LOG_PERIOD environment
+ * variable, nothing is done if it is not set or zero.
+ *
+ * @return Status code.
+ */
+extern te_errno te_perf_log_start(void);
+
+/**
+ * Stop periodic dumping started by te_perf_log_start() and dump
+ * metrics for the last time.
+ */
+extern void te_perf_log_stop(void);
+
+/**@} <!-- END te_tools_te_perf --> */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_PERF_H__ */
@@ -51,6 +51,18 @@ typedef struct serial_event_t {
 SLIST_HEAD(serial_event_h_t, serial_event_t);
 typedef struct serial_event_h_t serial_event_h_t;
 
+struct serial_parser_t;
+
+/**
+ * Callback invoked when an event is detected by the parser.
+ * It is called with the parser mutex locked.
+ *
+ * @param parser    The parser
+ * @param event     Detected event
+ */
+typedef void (serial_event_cb)(const struct serial_parser_t *parser,
+                               const serial_event_t *event);
+
 /** List of the serial console parsers settings */
 typedef struct serial_parser_t {
     char    name[TE_SERIAL_MAX_NAME + 1];   /**< Name of the parser */
@@ -66,6 +78,8 @@ typedef struct serial_parser_t {
     int     level;                      /**< Message level for logging */
     char    log_user[TE_SERIAL_MAX_NAME + 1];   /**< Logger user name */
     te_bool rcf;                        /**< Launched via RCF */
+    serial_event_cb *event_cb;          /**< Event detection callback
+                                             or @c NULL */
 
     pthread_t                     thread;     /**< Thread identifier */
     pthread_mutex_t               mutex;      /**< Provides access to this
@@ -96,6 +96,72 @@ te_toeplitz_hash(const te_toeplitz_hash_cache *toeplitz_hash_cache,
     return hash;
 }
 
+/* See description in te_toeplitz.h */
+unsigned int
+te_toeplitz_hash_input(te_toeplitz_hash_variant hash_var,
+                       unsigned int addr_size,
+                       const uint8_t *src_addr, uint16_t src_port,
+                       const uint8_t *dst_addr, uint16_t dst_port,
+                       uint8_t *buf)
+{
+    uint16_t ports[2];
+    unsigned int i;
+    unsigned int pos = 0;
+
+    assert(TE_TOEPLITZ_TCPUDP_LEN(addr_size) <= TE_TOEPLITZ_INPUT_MAX);
+
+    if (hash_var == TE_TOEPLITZ_HASH_SYM_OR_XOR)
+    {
+        for (i = 0; i < addr_size; i++)
+            buf[pos++] = src_addr[i] | dst_addr[i];
+
+        for (i = 0; i < addr_size; i++)
+            buf[pos++] = src_addr[i] ^ dst_addr[i];
+
+        ports[0] = src_port | dst_port;
+        ports[1] = src_port ^ dst_port;
+    }
+    else
+    {
+        memcpy(buf + pos, src_addr, addr_size);
+        pos += addr_size;
+        memcpy(buf + pos, dst_addr, addr_size);
+        pos += addr_size;
+
+        ports[0] = src_port;
+        ports[1] = dst_port;
+    }
+
+    memcpy(buf + pos, ports, sizeof(ports));
+    pos += sizeof(ports);
+
+    return pos;
+}
+
+/* See description in te_toeplitz.h */
+void
+te_toeplitz_hash_batch(const te_toeplitz_hash_cache *toeplitz_hash_cache,
+                       const uint8_t *input, size_t stride,
+                       unsigned int datalen, unsigned int n,
+                       uint32_t *hashes)
+{
+    const uint32_t *row;
+    const uint8_t *p;
+    unsigned int pos;
+    unsigned int i;
+
+    assert(datalen <= toeplitz_hash_cache->max_in_size);
+
+    memset(hashes, 0, n * sizeof(*hashes));
+
+    for (pos = 0; pos < datalen; pos++)
+    {
+        row = toeplitz_hash_cache->cache + pos * (UINT8_MAX + 1);
+        for (i = 0, p = input + pos; i < n; i++, p += stride)
+            hashes[i] ^= row[*p];
+    }
+}
+
 /* See description in te_toeplitz.h */
 uint32_t
 te_toeplitz_hash_sym_or_xor(
@@ -104,27 +170,16 @@ te_toeplitz_hash_sym_or_xor(
     const uint8_t *src_addr, uint16_t src_port,
     const uint8_t *dst_addr, uint16_t dst_port)
 {
-    static const size_t max_addr_size = sizeof(struct in6_addr);
-    uint8_t data[TE_TOEPLITZ_TCPUDP_LEN(max_addr_size)];
-    unsigned int i;
-    unsigned int pos = 0;
+    uint8_t data[TE_TOEPLITZ_INPUT_MAX];
+    unsigned int len;
 
-    assert(addr_size <= max_addr_size);
     assert(TE_TOEPLITZ_TCPUDP_LEN(addr_size) <= cache->max_in_size);
 
-    for (i = 0; i < addr_size; i++)
-        data[pos++] = src_addr[i] | dst_addr[i];
-
-    for (i = 0; i < addr_size; i++)
-        data[pos++] = src_addr[i] ^ dst_addr[i];
-
-    *(uint16_t *)&data[pos] = src_port | dst_port;
-    pos += sizeof(uint16_t);
-
-    *(uint16_t *)&data[pos] = src_port ^ dst_port;
-    pos += sizeof(uint16_t);
+    len = te_toeplitz_hash_input(TE_TOEPLITZ_HASH_SYM_OR_XOR, addr_size,
+                                 src_addr, src_port, dst_addr, dst_port,
+                                 data);
 
-    return te_toeplitz_hash_data(cache, data, 0, pos);
+    return te_toeplitz_hash_data(cache, data, 0, len);
 }
 
 /* See description in te_toeplitz.h */
@@ -105,6 +105,55 @@ extern uint32_t te_toeplitz_hash_sym_or_xor(
     unsigned int addr_size, const uint8_t *src_addr, uint16_t src_port,
     const uint8_t *dst_addr, uint16_t dst_port);
 
+/**
+ * Maximum length of hash input prepared by te_toeplitz_hash_input()
+ * (IPv6 addresses and ports).
+ */
+#define TE_TOEPLITZ_INPUT_MAX (sizeof(struct in6_addr) * 2 + \
+                               sizeof(uint16_t) * 2)
+
+/**
+ * Prepare input data of RSS hash for a TCP or UDP connection, so that
+ * hash may be computed with te_toeplitz_hash_data() or
+ * te_toeplitz_hash_batch().
+ *
+ * @param hash_var      Hash variant
+ * @param addr_size     IPv4 / IPv6 address length
+ * @param src_addr      Pointer to source address
+ * @param src_port      Source port number in network byte order
+ * @param dst_addr      Pointer to destination address
+ * @param dst_port      Destination port number in network byte order
+ * @param buf           Where to save input data (at least
+ *                      @ref TE_TOEPLITZ_INPUT_MAX bytes)
+ *
+ * @return Length of input data.
+ */
+extern unsigned int te_toeplitz_hash_input(
+    te_toeplitz_hash_variant hash_var,
+    unsigned int addr_size, const uint8_t *src_addr, uint16_t src_port,
+    const uint8_t *dst_addr, uint16_t dst_port, uint8_t *buf);
+
+/**
+ * Calculate Toeplitz hashes of many inputs of the same length.
+ *
+ * Inputs are processed byte position by byte position, so that only
+ * one row of the cache is used at a time and the inner loop has no
+ * dependencies between inputs. It is much faster than calling
+ * te_toeplitz_hash_data() for every input when there are many of them.
+ *
+ * @param toeplitz_hash_cache Pre-constructed cache
+ * @param input               Input data: @p n records placed
+ *                            @p stride bytes apart
+ * @param stride              Distance between records in bytes
+ * @param datalen             Length of each record in bytes
+ * @param n                   Number of records
+ * @param hashes              Where to save @p n hash values
+ */
+extern void te_toeplitz_hash_batch(
+    const te_toeplitz_hash_cache *toeplitz_hash_cache,
+    const uint8_t *input, size_t stride, unsigned int datalen,
+    unsigned int n, uint32_t *hashes);
+
 /**
  * Free pre-constructed cache
  *
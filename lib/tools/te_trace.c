@@ -0,0 +1,245 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Tracing of operations across TE components
+ *
+ * Implementation of trace contexts and spans.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Trace"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#ifdef STDC_HEADERS
+#include <stdlib.h>
+#include <string.h>
+#endif
+#include <ctype.h>
+#include <time.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_string.h"
+#include "te_json.h"
+#include "logger_api.h"
+#include "te_trace.h"
+
+/** Current trace context of the thread */
+static __thread te_trace_ctx trace_current = TE_TRACE_CTX_INIT;
+
+/** Seed of identifiers, initialized on the first use */
+static uint64_t trace_id_seed = 0;
+
+/** Counter of generated identifiers */
+static uint64_t trace_id_counter = 0;
+
+/* Get time in microseconds */
+static uint64_t
+te_trace_now_us(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*
+ * Generate a new non-zero identifier. Identifiers are unique within
+ * the process and unlikely to collide with identifiers of other
+ * processes since the seed depends on the process ID and start time.
+ */
+static uint64_t
+te_trace_new_id(void)
+{
+    uint64_t seed = __atomic_load_n(&trace_id_seed, __ATOMIC_RELAXED);
+    uint64_t z;
+
+    if (seed == 0)
+    {
+        struct timespec ts;
+        uint64_t        expected = 0;
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+        seed = ((uint64_t)getpid() << 32) ^ (uint64_t)ts.tv_sec ^
+               ((uint64_t)ts.tv_nsec << 20) ^ (uintptr_t)&ts;
+        seed |= 1;
+
+        /* Another thread may initialize the seed in the meantime */
+        if (!__atomic_compare_exchange_n(&trace_id_seed, &expected, seed,
+                                         FALSE, __ATOMIC_RELAXED,
+                                         __ATOMIC_RELAXED))
+            seed = expected;
+    }
+
+    /* SplitMix64 of the counter gives well distributed values */
+    do {
+        z = seed + UINT64_C(0x9e3779b97f4a7c15) *
+            (__atomic_fetch_add(&trace_id_counter, 1, __ATOMIC_RELAXED) + 1);
+        z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+        z ^= z >> 31;
+    } while (z == 0);
+
+    return z;
+}
+
+/* See description in te_trace.h */
+te_bool
+te_trace_enabled(void)
+{
+    static int enabled = -1;
+    int        value = __atomic_load_n(&enabled, __ATOMIC_RELAXED);
+
+    if (value < 0)
+    {
+        const char *env = getenv(TE_TRACE_ENV);
+
+        value = (env != NULL && *env != '\0' && strcmp(env, "0") != 0);
+        __atomic_store_n(&enabled, value, __ATOMIC_RELAXED);
+    }
+
+    return value != 0;
+}
+
+/* See description in te_trace.h */
+void
+te_trace_current(te_trace_ctx *ctx)
+{
+    *ctx = trace_current;
+}
+
+/* See description in te_trace.h */
+void
+te_trace_set_current(const te_trace_ctx *ctx)
+{
+    if (ctx == NULL)
+        memset(&trace_current, 0, sizeof(trace_current));
+    else
+        trace_current = *ctx;
+}
+
+/* See description in te_trace.h */
+void
+te_trace_span_start(te_trace_span *span, const te_trace_ctx *parent,
+                    const char *name_fmt, ...)
+{
+    va_list ap;
+
+    memset(span, 0, sizeof(*span));
+
+    if (parent == NULL)
+        parent = &trace_current;
+
+    if (parent->trace_id != 0)
+    {
+        span->ctx.trace_id = parent->trace_id;
+        span->parent_id = parent->span_id;
+    }
+    else if (te_trace_enabled())
+    {
+        span->ctx.trace_id = te_trace_new_id();
+    }
+    else
+    {
+        return;
+    }
+
+    span->ctx.span_id = te_trace_new_id();
+
+    va_start(ap, name_fmt);
+    vsnprintf(span->name, sizeof(span->name), name_fmt, ap);
+    va_end(ap);
+
+    span->start = te_trace_now_us(CLOCK_REALTIME);
+    span->start_mono = te_trace_now_us(CLOCK_MONOTONIC);
+}
+
+/* See description in te_trace.h */
+void
+te_trace_span_end(te_trace_span *span)
+{
+    te_string     record = TE_STRING_INIT;
+    te_json_ctx_t json = TE_JSON_INIT_STR(&record);
+    uint64_t      duration;
+
+    if (!te_trace_span_active(span))
+        return;
+
+    duration = te_trace_now_us(CLOCK_MONOTONIC) - span->start_mono;
+
+    te_json_start_object(&json);
+    te_json_add_key_str(&json, "type", "trace_span");
+    te_json_add_key(&json, "version");
+    te_json_add_integer(&json, 1);
+    te_json_add_key(&json, "trace");
+    te_json_add_string(&json, "%016" PRIx64, span->ctx.trace_id);
+    te_json_add_key(&json, "span");
+    te_json_add_string(&json, "%016" PRIx64, span->ctx.span_id);
+    if (span->parent_id != 0)
+    {
+        te_json_add_key(&json, "parent");
+        te_json_add_string(&json, "%016" PRIx64, span->parent_id);
+    }
+    te_json_add_key_str(&json, "name", span->name);
+    te_json_add_key(&json, "start");
+    te_json_add_integer(&json, span->start);
+    te_json_add_key(&json, "duration");
+    te_json_add_integer(&json, duration);
+    te_json_end(&json);
+
+    LGR_MESSAGE(TE_LL_MI | TE_LL_CONTROL, TE_TRACE_LOG_USER, "%s",
+                record.ptr);
+    te_string_free(&record);
+
+    /* The span must not be recorded twice */
+    span->ctx.trace_id = 0;
+}
+
+/* Parse 16 hexadecimal digits */
+static const char *
+te_trace_parse_id(const char *str, uint64_t *id)
+{
+    unsigned int i;
+    uint64_t     value = 0;
+
+    for (i = 0; i < 16; i++)
+    {
+        int c = str[i];
+
+        if (!isxdigit(c))
+            return NULL;
+        value = (value << 4) |
+                (unsigned int)(isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+    }
+
+    *id = value;
+    return str + i;
+}
+
+/* See description in te_trace.h */
+te_errno
+te_trace_ctx_parse(const char *str, te_trace_ctx *ctx, const char **end)
+{
+    te_trace_ctx result;
+
+    str = te_trace_parse_id(str, &result.trace_id);
+    if (str == NULL || *str != ':')
+        return TE_EINVAL;
+
+    str = te_trace_parse_id(str + 1, &result.span_id);
+    if (str == NULL || isxdigit(*str))
+        return TE_EINVAL;
+
+    *ctx = result;
+    if (end != NULL)
+        *end = str;
+
+    return 0;
+}
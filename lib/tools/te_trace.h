@@ -0,0 +1,170 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Tracing of operations across TE components
+ *
+ * @defgroup te_tools_te_trace Tracing of operations
+ * @ingroup te_tools
+ * @{
+ *
+ * A single API call (e.g. Configurator set of an instance) is processed
+ * by several TE components: confapi in the test, Configurator, RCF,
+ * Portable Commands Handler on the Test Agent, RPC server. Each
+ * component records the time spent on the call as a span. Spans of
+ * the same call share a trace ID and are linked to the span of the
+ * calling component by the parent span ID, so that the whole call
+ * may be shown as a latency waterfall.
+ *
+ * A trace context (trace ID and span ID) is passed between components
+ * in RCF and Configurator messages. Each thread has a current trace
+ * context which is used as a parent of spans started in the thread.
+ *
+ * Spans are logged as MI messages of type @c "trace_span" on completion:
+ *
+ * @code
+ * {"type":"trace_span","version":1,"trace":"<hex>","span":"<hex>",
+ *  "parent":"<hex>","name":"<name>","start":<us>,"duration":<us>}
+ * @endcode
+ *
+ * where @c start is the real time of the span start in microseconds
+ * since the Epoch and @c duration is measured with the monotonic clock.
+ * @c parent is omitted for a root span.
+ *
+ * New traces are started only if @c TE_TRACE environment variable is
+ * set to a non-zero value. Spans with a parent are always recorded, so
+ * it is sufficient to enable tracing in the test only.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_TRACE_H__
+#define __TE_TRACE_H__
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_stdint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Name of the environment variable enabling new traces */
+#define TE_TRACE_ENV            "TE_TRACE"
+
+/** Logger user of span records */
+#define TE_TRACE_LOG_USER       "Trace"
+
+/** Maximum length of a span name (including trailing zero) */
+#define TE_TRACE_NAME_MAX       64
+
+/** Format string of a trace context */
+#define TE_TRACE_CTX_FMT        "%016" PRIx64 ":%016" PRIx64
+
+/**
+ * Arguments for TE_TRACE_CTX_FMT.
+ *
+ * @param _ctx      Pointer to te_trace_ctx
+ */
+#define TE_TRACE_CTX_ARGS(_ctx) (_ctx)->trace_id, (_ctx)->span_id
+
+/** Trace context */
+typedef struct te_trace_ctx {
+    uint64_t trace_id;  /**< Trace ID, @c 0 if there is no trace */
+    uint64_t span_id;   /**< ID of the current span */
+} te_trace_ctx;
+
+/** Initializer of an empty trace context */
+#define TE_TRACE_CTX_INIT { .trace_id = 0, .span_id = 0 }
+
+/** Span being recorded */
+typedef struct te_trace_span {
+    te_trace_ctx ctx;               /**< Trace ID and ID of the span,
+                                         trace ID is @c 0 if the span
+                                         is not recorded */
+    uint64_t     parent_id;         /**< ID of the parent span or @c 0 */
+    char         name[TE_TRACE_NAME_MAX]; /**< Span name */
+    uint64_t     start;             /**< Real time of the start,
+                                         microseconds */
+    uint64_t     start_mono;        /**< Monotonic time of the start,
+                                         microseconds */
+} te_trace_span;
+
+/**
+ * Check whether new traces should be started (see @c TE_TRACE).
+ *
+ * @return @c TRUE if tracing is enabled.
+ */
+extern te_bool te_trace_enabled(void);
+
+/**
+ * Get the current trace context of the calling thread.
+ *
+ * @param[out] ctx      Where to save the context
+ */
+extern void te_trace_current(te_trace_ctx *ctx);
+
+/**
+ * Set the current trace context of the calling thread.
+ *
+ * @param ctx           Trace context (@c NULL to reset it)
+ */
+extern void te_trace_set_current(const te_trace_ctx *ctx);
+
+/**
+ * Start a span. The current trace context of the thread is not changed,
+ * use te_trace_set_current() to make the span a parent of nested spans.
+ *
+ * If the parent context has no trace, a new trace is started provided
+ * that tracing is enabled. Otherwise the span is not recorded and
+ * te_trace_span_end() does nothing.
+ *
+ * @param span          Span to start
+ * @param parent        Parent context or @c NULL to use the current
+ *                      context of the thread
+ * @param name_fmt      Format string of the span name
+ * @param ...           Format arguments
+ */
+extern void te_trace_span_start(te_trace_span *span,
+                                const te_trace_ctx *parent,
+                                const char *name_fmt, ...)
+                                __attribute__((format(printf, 3, 4)));
+
+/**
+ * Finish a span and log its record.
+ *
+ * @param span          Span started by te_trace_span_start()
+ */
+extern void te_trace_span_end(te_trace_span *span);
+
+/**
+ * Check whether a span is recorded.
+ *
+ * @param span          Span
+ *
+ * @return @c TRUE if the span is a part of a trace.
+ */
+static inline te_bool
+te_trace_span_active(const te_trace_span *span)
+{
+    return span->ctx.trace_id != 0;
+}
+
+/**
+ * Parse a trace context formatted with TE_TRACE_CTX_FMT.
+ *
+ * @param[in]  str      String to parse
+ * @param[out] ctx      Where to save the context
+ * @param[out] end      Where to save a pointer to the first character
+ *                      after the context (may be @c NULL)
+ *
+ * @return Status code.
+ * @retval TE_EINVAL    The string does not start with a trace context.
+ */
+extern te_errno te_trace_ctx_parse(const char *str, te_trace_ctx *ctx,
+                                   const char **end);
+
+/**@} <!-- END te_tools_te_trace --> */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_TRACE_H__ */
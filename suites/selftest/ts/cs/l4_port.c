@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Allocation of TCP/UDP ports on a test agent
+ *
+ * Allocate TCP/UDP ports using the allocator of a test agent
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page cs-l4_port Allocation of TCP/UDP ports on a test agent
+ *
+ * @objective Check that TAPI allocates ports using the allocator of
+ *            a test agent, that allocated ports are reserved on the agent
+ *            and that ports used by sockets are not allocated.
+ *
+ * @param env   Testing environment with @p pco_iut and IPv4 @p iut_addr
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/l4_port"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+#include "te_sockaddr.h"
+#include "conf_api.h"
+#include "tapi_sockaddr.h"
+#include "tapi_rpc_socket.h"
+#include "tapi_rpcsock_macros.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/** Number of ports in the allocated range */
+#define RANGE_SIZE  4
+
+/**
+ * Check whether the port is reserved on the test agent.
+ *
+ * @param ta        Test agent name
+ * @param port      Port in host endian
+ *
+ * @return @c TRUE if the port is reserved
+ */
+static te_bool
+port_is_reserved(const char *ta, uint16_t port)
+{
+    cfg_handle handle;
+
+    return cfg_find_fmt(&handle, "/agent:%s/l4_port:/alloc:/allocated:%u",
+                        ta, port) == 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server            *pco_iut = NULL;
+    const struct sockaddr     *iut_addr = NULL;
+    struct sockaddr_storage    bind_addr;
+    uint16_t                   ports[RANGE_SIZE];
+    uint16_t                   busy_port;
+    uint16_t                   port;
+    int                        iut_s = -1;
+    unsigned int               i;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+
+    TEST_STEP("Allocate a range of ports and check that the ports are "
+              "consecutive and reserved on the agent");
+    CHECK_RC(tapi_allocate_port_range(pco_iut, ports, RANGE_SIZE));
+    for (i = 0; i < RANGE_SIZE; i++)
+    {
+        RING("Allocated port %u", ports[i]);
+        if (i > 0 && ports[i] != ports[i - 1] + 1)
+            TEST_VERDICT("Allocated ports are not consecutive");
+        if (!port_is_reserved(pco_iut->ta, ports[i]))
+            TEST_VERDICT("Allocated port is not reserved on the agent");
+    }
+
+    TEST_STEP("Allocate a port, release it on the agent and bind "
+              "a socket to it");
+    CHECK_RC(tapi_allocate_port(pco_iut, &busy_port));
+    CHECK_RC(cfg_del_instance_fmt(FALSE,
+                                  "/agent:%s/l4_port:/alloc:/allocated:%u",
+                                  pco_iut->ta, busy_port));
+
+    tapi_sockaddr_clone_exact(iut_addr, &bind_addr);
+    te_sockaddr_set_wildcard(SA(&bind_addr));
+    te_sockaddr_set_port(SA(&bind_addr), htons(busy_port));
+    iut_s = rpc_socket(pco_iut, rpc_socket_domain_by_addr(iut_addr),
+                       RPC_SOCK_STREAM, RPC_PROTO_DEF);
+    rpc_bind(pco_iut, iut_s, SA(&bind_addr));
+
+    TEST_STEP("Check that the port used by the socket cannot be reserved "
+              "on the agent");
+    rc = cfg_add_instance_fmt(NULL, CFG_VAL(NONE, NULL),
+                              "/agent:%s/l4_port:/alloc:/allocated:%u",
+                              pco_iut->ta, busy_port);
+    if (rc == 0)
+        TEST_VERDICT("Port used by a socket is reserved on the agent");
+
+    TEST_STEP("Allocate a port and check that it differs from all ports "
+              "allocated before and from the port used by the socket");
+    CHECK_RC(tapi_allocate_port(pco_iut, &port));
+    RING("Allocated port %u", port);
+    if (port == busy_port)
+        TEST_VERDICT("Port used by a socket is allocated");
+    for (i = 0; i < RANGE_SIZE; i++)
+    {
+        if (port == ports[i])
+            TEST_VERDICT("Port is allocated twice");
+    }
+    if (!port_is_reserved(pco_iut->ta, port))
+        TEST_VERDICT("Allocated port is not reserved on the agent");
+
+    TEST_SUCCESS;
+
+cleanup:
+    CLEANUP_RPC_CLOSE(pco_iut, iut_s);
+
+    TEST_END;
+}
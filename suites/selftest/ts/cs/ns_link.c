@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Interfaces of a network namespace
+ *
+ * Configure interfaces of a network namespace from the root agent
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page cs-ns_link Interfaces of a network namespace
+ *
+ * @objective Check that interfaces moved to a network namespace are
+ *            listed and configured via the agent netconf session bound
+ *            to the namespace, and that the session follows
+ *            the namespace when it is created again with the same name.
+ *
+ * @param env   Testing environment with @p pco_iut
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/ns_link"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include "conf_api.h"
+#include "tapi_cfg_base.h"
+#include "tapi_namespaces.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/** Name of the network namespace */
+#define NS_NAME         "te_selftest_ns"
+/** Name of the veth interface kept in the agent namespace */
+#define VETH_NAME       "te_ns_veth0"
+/** Name of the veth interface moved to the namespace */
+#define VETH_PEER       "te_ns_veth1"
+/** MTU set on the interface in the namespace */
+#define TEST_MTU        1400
+/** Address added to the interface in the namespace */
+#define TEST_ADDR       "192.0.2.1"
+/** Prefix length of @c TEST_ADDR */
+#define TEST_PREFIX     24
+
+/** Format of OID of the interface in the namespace */
+#define LINK_OID_FMT    "/agent:%s/namespace:/net:%s/link:%s"
+
+/**
+ * Check that the interface is listed in the namespace and read its MTU
+ * via the namespace session.
+ */
+static void
+check_link(const char *ta, int *mtu)
+{
+    cfg_handle      handle;
+
+    CHECK_RC(cfg_synchronize_fmt(TRUE, "/agent:%s/namespace:/net:%s",
+                                 ta, NS_NAME));
+    if (cfg_find_fmt(&handle, LINK_OID_FMT, ta, NS_NAME, VETH_PEER) != 0)
+        TEST_VERDICT("Interface is not listed in the namespace");
+
+    CHECK_RC(cfg_get_instance_int_sync_fmt(mtu, LINK_OID_FMT "/mtu:",
+                                           ta, NS_NAME, VETH_PEER));
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    cfg_handle      handle;
+    te_bool         ns_added = FALSE;
+    te_bool         veth_added = FALSE;
+    te_bool         if_set = FALSE;
+    int             status;
+    int             mtu;
+    int             prefix;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+
+    TEST_STEP("Create a network namespace and move one end of a veth "
+              "pair to it");
+    CHECK_RC(tapi_netns_add(pco_iut->ta, NS_NAME));
+    ns_added = TRUE;
+    CHECK_RC(tapi_cfg_base_if_add_veth(pco_iut->ta, VETH_NAME, VETH_PEER));
+    veth_added = TRUE;
+    CHECK_RC(tapi_netns_if_set(pco_iut->ta, NS_NAME, VETH_PEER));
+    if_set = TRUE;
+
+    TEST_STEP("Bring the interface up, change its MTU and add an address "
+              "to it in the namespace");
+    check_link(pco_iut->ta, &mtu);
+    CHECK_RC(cfg_set_instance_fmt(CFG_VAL(INT32, 1), LINK_OID_FMT "/status:",
+                                  pco_iut->ta, NS_NAME, VETH_PEER));
+    CHECK_RC(cfg_set_instance_fmt(CFG_VAL(INT32, TEST_MTU),
+                                  LINK_OID_FMT "/mtu:",
+                                  pco_iut->ta, NS_NAME, VETH_PEER));
+    CHECK_RC(cfg_add_instance_fmt(NULL, CFG_VAL(INT32, TEST_PREFIX),
+                                  LINK_OID_FMT "/net_addr:" TEST_ADDR,
+                                  pco_iut->ta, NS_NAME, VETH_PEER));
+
+    TEST_STEP("Check that the changes are got back in the same "
+              "synchronization of the namespace subtree");
+    CHECK_RC(cfg_synchronize_fmt(TRUE, "/agent:%s/namespace:/net:%s",
+                                 pco_iut->ta, NS_NAME));
+    CHECK_RC(cfg_get_instance_int_fmt(&status, LINK_OID_FMT "/status:",
+                                      pco_iut->ta, NS_NAME, VETH_PEER));
+    CHECK_RC(cfg_get_instance_int_fmt(&mtu, LINK_OID_FMT "/mtu:",
+                                      pco_iut->ta, NS_NAME, VETH_PEER));
+    if (status != 1 || mtu != TEST_MTU)
+    {
+        ERROR("Got status %d and MTU %d", status, mtu);
+        TEST_VERDICT("Interface in the namespace is not configured");
+    }
+    CHECK_RC(cfg_get_instance_int_fmt(&prefix,
+                                      LINK_OID_FMT "/net_addr:" TEST_ADDR,
+                                      pco_iut->ta, NS_NAME, VETH_PEER));
+    if (prefix != TEST_PREFIX)
+        TEST_VERDICT("Address is added with wrong prefix length");
+
+    TEST_STEP("Create the namespace again with the same name keeping "
+              "it grabbed by the test and move the interface to it");
+    CHECK_RC(tapi_netns_if_unset(pco_iut->ta, NS_NAME, VETH_PEER));
+    if_set = FALSE;
+    CHECK_RC(cfg_del_instance_fmt(TRUE, "/agent:%s/namespace:/net:%s",
+                                  pco_iut->ta, NS_NAME));
+    CHECK_RC(cfg_add_instance_fmt(NULL, CVT_NONE, NULL,
+                                  "/agent:%s/namespace:/net:%s",
+                                  pco_iut->ta, NS_NAME));
+    CHECK_RC(tapi_netns_if_set(pco_iut->ta, NS_NAME, VETH_PEER));
+    if_set = TRUE;
+
+    TEST_STEP("Check that the interface is found in the new namespace "
+              "and has not got the address added in the old one");
+    check_link(pco_iut->ta, &mtu);
+    if (cfg_find_fmt(&handle, LINK_OID_FMT "/net_addr:" TEST_ADDR,
+                     pco_iut->ta, NS_NAME, VETH_PEER) == 0)
+        TEST_VERDICT("Address is kept after moving between namespaces");
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (if_set)
+    {
+        CLEANUP_CHECK_RC(tapi_netns_if_unset(pco_iut->ta, NS_NAME,
+                                             VETH_PEER));
+    }
+    if (veth_added)
+        CLEANUP_CHECK_RC(tapi_cfg_base_if_del_veth(pco_iut->ta, VETH_NAME));
+    if (ns_added)
+        CLEANUP_CHECK_RC(tapi_netns_del(pco_iut->ta, NS_NAME));
+
+    TEST_END;
+}
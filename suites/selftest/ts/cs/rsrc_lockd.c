@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Contend for a resource via the per-host lock service
+ *
+ * Two agents on one host grab the same resource via the lock service
+ *
+ * Copyright (C) 2022-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page cs-rsrc_lockd Contend for a resource via the per-host lock service
+ *
+ * @objective Check that the per-host lock service does not let two
+ *            agents on one host grab the same resource exclusively
+ *
+ * @param env   Testing environment with @p pco_iut and @p pco_tst
+ *              on agents running on the same host with
+ *              @c TE_TA_RSRC_LOCKD enabled
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/rsrc_lockd"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+#include "te_str.h"
+#include "tapi_rpc_unistd.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/** Name of the resource the agents contend for */
+#define RSRC_LOCKD_NAME "te_lockd_selftest"
+
+/**
+ * Check that the lock service is enabled on the agent of the PCO.
+ *
+ * @param rpcs      RPC server
+ *
+ * @return @c TRUE if the lock service is enabled
+ */
+static te_bool
+lockd_enabled(rcf_rpc_server *rpcs)
+{
+    char *value = NULL;
+    te_bool enabled = FALSE;
+
+    if (cfg_get_instance_string_fmt(&value, "/agent:%s/env:TE_TA_RSRC_LOCKD",
+                                    rpcs->ta) != 0)
+        return FALSE;
+
+    if (te_strtol_bool(value, &enabled) != 0)
+        enabled = FALSE;
+    free(value);
+
+    return enabled;
+}
+
+/**
+ * Grab the resource on the agent of the PCO.
+ *
+ * @param rpcs      RPC server
+ *
+ * @return Status code.
+ */
+static te_errno
+rsrc_grab(rcf_rpc_server *rpcs)
+{
+    char rsrc_oid[CFG_OID_MAX];
+
+    snprintf(rsrc_oid, sizeof(rsrc_oid), "/agent:%s/veth:" RSRC_LOCKD_NAME,
+             rpcs->ta);
+
+    return cfg_add_instance_fmt(NULL, CVT_STRING, rsrc_oid,
+                                "/agent:%s/rsrc:" RSRC_LOCKD_NAME, rpcs->ta);
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    char iut_host[RCF_MAX_NAME] = "";
+    char tst_host[RCF_MAX_NAME] = "";
+    te_bool iut_grabbed = FALSE;
+    te_bool tst_grabbed = FALSE;
+    te_errno rc;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+
+    TEST_STEP("Check that the agents run on one host and use "
+              "the lock service");
+    rpc_gethostname(pco_iut, iut_host, sizeof(iut_host));
+    rpc_gethostname(pco_tst, tst_host, sizeof(tst_host));
+    if (strcmp(iut_host, tst_host) != 0)
+        TEST_SKIP("The agents run on different hosts");
+    if (!lockd_enabled(pco_iut) || !lockd_enabled(pco_tst))
+        TEST_SKIP("The lock service is not enabled on the agents");
+
+    TEST_STEP("Grab the resource on the IUT agent");
+    CHECK_RC(rsrc_grab(pco_iut));
+    iut_grabbed = TRUE;
+
+    TEST_STEP("Check that the resource cannot be grabbed on the TST agent");
+    rc = rsrc_grab(pco_tst);
+    if (rc == 0)
+    {
+        tst_grabbed = TRUE;
+        TEST_VERDICT("The resource is grabbed by two agents");
+    }
+    RING("The second grab failed as expected: %r", rc);
+
+    TEST_STEP("Release the resource on the IUT agent");
+    CHECK_RC(cfg_del_instance_fmt(FALSE, "/agent:%s/rsrc:" RSRC_LOCKD_NAME,
+                                  pco_iut->ta));
+    iut_grabbed = FALSE;
+
+    TEST_STEP("Check that the resource can be grabbed on the TST agent now");
+    rc = rsrc_grab(pco_tst);
+    if (rc != 0)
+        TEST_VERDICT("The released resource cannot be grabbed: %r", rc);
+    tst_grabbed = TRUE;
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (iut_grabbed)
+    {
+        CLEANUP_CHECK_RC(cfg_del_instance_fmt(FALSE,
+                                              "/agent:%s/rsrc:"
+                                              RSRC_LOCKD_NAME,
+                                              pco_iut->ta));
+    }
+    if (tst_grabbed)
+    {
+        CLEANUP_CHECK_RC(cfg_del_instance_fmt(FALSE,
+                                              "/agent:%s/rsrc:"
+                                              RSRC_LOCKD_NAME,
+                                              pco_tst->ta));
+    }
+
+    TEST_END;
+}
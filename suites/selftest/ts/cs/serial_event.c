@@ -0,0 +1,199 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Handling of serial console parser events by Tester
+ *
+ * Check that events of serial console parsers are handled by Tester
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page cs-serial_event Handling of serial console parser events by Tester
+ *
+ * @objective Check that Tester handles an activated serial console
+ *            parser event exactly once and resets its status.
+ *
+ * @param env   Testing environment with @p pco_iut
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/serial_event"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "te_file.h"
+#include "te_string.h"
+#include "conf_api.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/** Name of the Tester event */
+#define TESTER_EVENT    "selftest_event"
+/** Name of the parser */
+#define PARSER          "selftest_parser"
+/** Name of the parser event */
+#define PARSER_EVENT    "selftest"
+
+/** Maximum time to wait for the event to be handled, in seconds */
+#define HANDLE_TIMEOUT  5
+
+/**
+ * Wait until Tester resets status of the event.
+ *
+ * @param ta        Test Agent name
+ */
+static void
+wait_event_handled(const char *ta)
+{
+    unsigned int i;
+    int          status = 1;
+
+    for (i = 0; i < HANDLE_TIMEOUT * 10; i++)
+    {
+        CHECK_RC(cfg_get_instance_int_fmt(&status,
+                                          "/agent:%s/parser:%s/event:%s/"
+                                          "status:", ta, PARSER,
+                                          PARSER_EVENT));
+        if (status == 0)
+            return;
+        te_msleep(100);
+    }
+
+    TEST_VERDICT("Event status is not reset by Tester");
+}
+
+/**
+ * Check how many times the event handler is called.
+ *
+ * @param counter   Path to the file the handler appends to
+ * @param expected  Expected number of calls
+ */
+static void
+check_handled(const char *counter, unsigned int expected)
+{
+    te_string    calls = TE_STRING_INIT;
+    unsigned int n = 0;
+    size_t       i;
+
+    CHECK_RC(te_file_read_string(&calls, FALSE, 0, "%s", counter));
+    for (i = 0; i < calls.len; i++)
+    {
+        if (calls.ptr[i] == '\n')
+            n++;
+    }
+    te_string_free(&calls);
+
+    if (n != expected)
+    {
+        ERROR("The event handler is called %u times instead of %u",
+              n, expected);
+        TEST_VERDICT("The event is handled %s than expected",
+                     n > expected ? "more times" : "less times");
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    char           *counter = NULL;
+    char           *handler = NULL;
+    te_string       script = TE_STRING_INIT;
+    te_bool         parser_added = FALSE;
+    te_bool         event_added = FALSE;
+    unsigned int    i;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+
+    TEST_STEP("Create an external Tester event handler which counts "
+              "its calls");
+    counter = te_file_create_unique("/tmp/te_serial_event_", ".cnt");
+    handler = te_file_create_unique("/tmp/te_serial_event_", ".sh");
+    if (counter == NULL || handler == NULL)
+        TEST_FAIL("Failed to create temporary files");
+
+    te_string_append(&script, "#!/bin/sh\necho >>%s\nexit 0\n", counter);
+    CHECK_RC(te_file_write_string(&script, 0, O_TRUNC, 0, "%s", handler));
+    if (chmod(handler, 0700) != 0)
+        TEST_FAIL("Failed to make the handler executable: %s",
+                  strerror(errno));
+
+    CHECK_RC(cfg_add_instance_fmt(NULL, CVT_NONE, NULL,
+                                  "/local:/tester:/event:%s",
+                                  TESTER_EVENT));
+    event_added = TRUE;
+    CHECK_RC(cfg_add_instance_fmt(NULL, CVT_STRING, handler,
+                                  "/local:/tester:/event:%s/handler:h",
+                                  TESTER_EVENT));
+    CHECK_RC(cfg_set_instance_fmt(CVT_INT32, 0,
+                                  "/local:/tester:/event:%s/handler:h/"
+                                  "internal:", TESTER_EVENT));
+    CHECK_RC(cfg_set_instance_fmt(CVT_INT32, 1,
+                                  "/local:/tester:/event:%s/handler:h/"
+                                  "priority:", TESTER_EVENT));
+
+    TEST_STEP("Add a serial console parser with an event on the agent");
+    CHECK_RC(cfg_add_instance_fmt(NULL, CVT_STRING, PARSER,
+                                  "/agent:%s/parser:%s", pco_iut->ta,
+                                  PARSER));
+    parser_added = TRUE;
+    CHECK_RC(cfg_add_instance_fmt(NULL, CVT_STRING, TESTER_EVENT,
+                                  "/agent:%s/parser:%s/event:%s",
+                                  pco_iut->ta, PARSER, PARSER_EVENT));
+
+    for (i = 1; i <= 2; i++)
+    {
+        TEST_STEP("Activate the event and check that Tester handles "
+                  "it once and resets its status");
+        CHECK_RC(cfg_set_instance_fmt(CVT_INT32, 1,
+                                      "/agent:%s/parser:%s/event:%s/status:",
+                                      pco_iut->ta, PARSER, PARSER_EVENT));
+        wait_event_handled(pco_iut->ta);
+
+        /* Give a chance to handle the event once more by mistake */
+        SLEEP(1);
+        check_handled(counter, i);
+    }
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (parser_added)
+    {
+        CLEANUP_CHECK_RC(cfg_del_instance_fmt(TRUE, "/agent:%s/parser:%s",
+                                              pco_iut->ta, PARSER));
+    }
+    if (event_added)
+    {
+        CLEANUP_CHECK_RC(cfg_del_instance_fmt(TRUE,
+                                              "/local:/tester:/event:%s",
+                                              TESTER_EVENT));
+    }
+    if (counter != NULL)
+        unlink(counter);
+    if (handler != NULL)
+        unlink(handler);
+    free(counter);
+    free(handler);
+    te_string_free(&script);
+
+    TEST_END;
+}
@@ -0,0 +1,152 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Sub-agent serving a network namespace
+ *
+ * Control a sub-agent via the connection of its parent test agent
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page cs-subagent Sub-agent serving a network namespace
+ *
+ * @objective Check that commands to a sub-agent are forwarded by
+ *            its parent test agent, including commands with
+ *            attachments and arguments which look like attachment
+ *            markers.
+ *
+ * @param env   Testing environment with @p pco_iut
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/subagent"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include <fcntl.h>
+
+#include "te_file.h"
+#include "te_string.h"
+#include "conf_api.h"
+#include "rcf_api.h"
+#include "tapi_namespaces.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/** Name of the network namespace */
+#define NS_NAME         "te_selftest_ns"
+/** Name of the sub-agent */
+#define SUB_TA          "Agt_selftest_sub"
+/** Name of the environment variable set on the sub-agent */
+#define ENV_NAME        "TE_SELFTEST_SUBAGENT"
+/** Value which looks like an attachment marker in the command */
+#define ENV_VALUE       "value attach 7"
+/** Size of the file copied to and from the sub-agent */
+#define FILE_SIZE       100000
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    char           *value = NULL;
+    char           *lfile = NULL;
+    char           *lfile_back = NULL;
+    char           *rfile = NULL;
+    te_string       data = TE_STRING_INIT;
+    te_string       data_back = TE_STRING_INIT;
+    te_bool         ns_added = FALSE;
+    te_bool         sub_added = FALSE;
+    te_bool         env_added = FALSE;
+    te_bool         rfile_put = FALSE;
+    unsigned int    i;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+
+    TEST_STEP("Create a network namespace and start a sub-agent in it");
+    CHECK_RC(tapi_netns_add(pco_iut->ta, NS_NAME));
+    ns_added = TRUE;
+    CHECK_RC(tapi_netns_add_subagent(pco_iut->ta, NS_NAME, SUB_TA));
+    sub_added = TRUE;
+
+    TEST_STEP("Set a configuration value with an attachment marker "
+              "inside via the sub-agent and read it back");
+    CHECK_RC(cfg_add_instance_fmt(NULL, CVT_STRING, ENV_VALUE,
+                                  "/agent:%s/env:%s", SUB_TA, ENV_NAME));
+    env_added = TRUE;
+    CHECK_RC(cfg_synchronize_fmt(TRUE, "/agent:%s/env:%s",
+                                 SUB_TA, ENV_NAME));
+    CHECK_RC(cfg_get_instance_string_fmt(&value, "/agent:%s/env:%s",
+                                         SUB_TA, ENV_NAME));
+    if (strcmp(value, ENV_VALUE) != 0)
+    {
+        ERROR("Got '%s' instead of '%s'", value, ENV_VALUE);
+        TEST_VERDICT("Value set via the sub-agent is corrupted");
+    }
+
+    TEST_STEP("Copy a file to the sub-agent and back and check that "
+              "its content is not changed");
+    lfile = te_file_create_unique("/tmp/te_subagent_", ".out");
+    lfile_back = te_file_create_unique("/tmp/te_subagent_", ".in");
+    if (lfile == NULL || lfile_back == NULL)
+        TEST_FAIL("Failed to create temporary files");
+
+    for (i = 0; data.len < FILE_SIZE; i++)
+        te_string_append(&data, "line %u\n", i);
+    CHECK_RC(te_file_write_string(&data, 0, O_TRUNC, 0, "%s", lfile));
+
+    rfile = te_string_fmt("/tmp/te_subagent_%u", (unsigned int)getpid());
+    CHECK_RC(rcf_ta_put_file(SUB_TA, 0, lfile, rfile));
+    rfile_put = TRUE;
+    CHECK_RC(rcf_ta_get_file(SUB_TA, 0, rfile, lfile_back));
+
+    CHECK_RC(te_file_read_string(&data_back, TRUE, 0, "%s", lfile_back));
+    if (data_back.len != data.len ||
+        memcmp(data_back.ptr, data.ptr, data.len) != 0)
+        TEST_VERDICT("File copied via the sub-agent is corrupted");
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (rfile_put)
+        CLEANUP_CHECK_RC(rcf_ta_del_file(SUB_TA, 0, rfile));
+    if (env_added)
+    {
+        CLEANUP_CHECK_RC(cfg_del_instance_fmt(FALSE, "/agent:%s/env:%s",
+                                              SUB_TA, ENV_NAME));
+    }
+    if (sub_added)
+    {
+        CLEANUP_CHECK_RC(tapi_netns_del_subagent(pco_iut->ta, NS_NAME,
+                                                 SUB_TA));
+    }
+    if (ns_added)
+        CLEANUP_CHECK_RC(tapi_netns_del(pco_iut->ta, NS_NAME));
+
+    if (lfile != NULL)
+        unlink(lfile);
+    if (lfile_back != NULL)
+        unlink(lfile_back);
+    free(lfile);
+    free(lfile_back);
+    free(rfile);
+    free(value);
+    te_string_free(&data);
+    te_string_free(&data_back);
+
+    TEST_END;
+}
@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2024 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Testing subscription to configuration changes
+ *
+ * Testing subscription to configuration changes
+ */
+
+/** @page cs-subscribe Testing subscription to configuration changes
+ *
+ * @objective Check that subscribers are notified about added,
+ *            changed and deleted instances
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME "cs/subscribe"
+
+#include "te_config.h"
+#include "te_str.h"
+#include "te_string.h"
+#include "tapi_cfg_changed.h"
+#include "tapi_test.h"
+
+#define CHANGE_TAG "subscribe"
+
+/* Collect changes as a string */
+static te_errno
+collect_change(cfg_change_type type, const char *oid, void *opaque)
+{
+    te_string *changes = opaque;
+
+    te_string_append(changes, "%s %s\n",
+                     type == CFG_CHANGE_ADD ? "add" :
+                     type == CFG_CHANGE_DEL ? "del" :
+                     type == CFG_CHANGE_SET ? "set" : "unknown", oid);
+
+    return 0;
+}
+
+/* Wait for changes and check that the expected one is reported */
+static void
+check_change(cfg_subscription *sub, const char *expected)
+{
+    te_string changes = TE_STRING_INIT;
+
+    CHECK_RC(cfg_subscription_wait(sub, 1000, collect_change, &changes));
+    RING("Reported changes:\n%s", changes.ptr);
+    if (strstr(changes.ptr, expected) == NULL)
+        TEST_VERDICT("Change '%s' is not reported", expected);
+
+    te_string_free(&changes);
+}
+
+int
+main(int argc, char **argv)
+{
+    cfg_subscription *sub = NULL;
+    cfg_subscription *other = NULL;
+
+    TEST_START;
+
+    TEST_STEP("Subscribe to changes of a subtree");
+    CHECK_RC(cfg_subscribe(&sub, 0, "/local:/changed:%s", CHANGE_TAG));
+
+    TEST_STEP("Check that nothing is reported without changes");
+    rc = cfg_subscription_wait(sub, 0, collect_change, NULL);
+    if (TE_RC_GET_ERROR(rc) != TE_ETIMEDOUT)
+        TEST_VERDICT("Waiting without changes returned %r", rc);
+
+    TEST_STEP("Check that an added instance is reported");
+    CHECK_RC(tapi_cfg_changed_add_region(CHANGE_TAG, 0, 100));
+    check_change(sub, "add /local:/changed:" CHANGE_TAG "/region:0\n");
+
+    TEST_STEP("Check that a changed value is reported");
+    CHECK_RC(tapi_cfg_changed_add_region(CHANGE_TAG, 0, 200));
+    check_change(sub, "set /local:/changed:" CHANGE_TAG "/region:0\n");
+
+    TEST_STEP("Check that changes outside the subtree are not reported");
+    CHECK_RC(tapi_cfg_changed_add_region(CHANGE_TAG "_other", 0, 100));
+    rc = cfg_subscription_wait(sub, 0, collect_change, NULL);
+    if (TE_RC_GET_ERROR(rc) != TE_ETIMEDOUT)
+        TEST_VERDICT("Change outside the subtree is reported");
+
+    TEST_STEP("Check that a pattern with wildcards matches several "
+              "subtrees");
+    CHECK_RC(cfg_subscribe(&other, 0, "/local:/changed:*/region:0"));
+    CHECK_RC(tapi_cfg_changed_clear_tag(CHANGE_TAG "_other"));
+    check_change(other, "del /local:/changed:" CHANGE_TAG "_other/region:0\n");
+
+    TEST_STEP("Check that deleted instances are reported");
+    CHECK_RC(tapi_cfg_changed_clear_tag(CHANGE_TAG));
+    check_change(sub, "del /local:/changed:" CHANGE_TAG "\n");
+
+    TEST_SUCCESS;
+
+cleanup:
+    cfg_unsubscribe(other);
+    cfg_unsubscribe(sub);
+    CLEANUP_CHECK_RC(tapi_cfg_changed_clear_tag(CHANGE_TAG));
+    CLEANUP_CHECK_RC(tapi_cfg_changed_clear_tag(CHANGE_TAG "_other"));
+
+    TEST_END;
+}
@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Synchronization of a subtree limited by depth
+ *
+ * Synchronize Configurator database with a subtree limited by depth
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page cs-sync_depth Synchronization of a subtree limited by depth
+ *
+ * @objective Check that Configurator synchronizes instances of a subtree
+ *            up to the requested depth only.
+ *
+ * @param env   Testing environment with @p pco_iut and @p iut_if
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/sync_depth"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+#include "te_sockaddr.h"
+#include "conf_api.h"
+#include "tapi_rpc_stdio.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/**
+ * Check whether the instance is present in Configurator database.
+ *
+ * @param oid       object instance identifier
+ * @param expected  whether the instance is expected to be present
+ */
+static void
+check_inst(const char *oid, te_bool expected)
+{
+    cfg_handle handle;
+    te_bool    found;
+
+    found = cfg_find_str(oid, &handle) == 0;
+    if (found != expected)
+    {
+        ERROR("'%s' is %spresent in Configurator database", oid,
+              found ? "" : "not ");
+        TEST_VERDICT("Instance is %spresent in Configurator database "
+                     "after synchronization", found ? "" : "not ");
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server     *pco_iut = NULL;
+    const tapi_env_if  *iut_if = NULL;
+    struct sockaddr    *new_addr = NULL;
+    const char         *if_name;
+    char                if_oid[CFG_OID_MAX];
+    char                addr_oid[CFG_OID_MAX];
+    char                bcast_oid[CFG_OID_MAX];
+    char                addr_str[INET_ADDRSTRLEN];
+    te_bool             added = FALSE;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_ENV_IF(iut_if);
+
+    if_name = iut_if->if_info.if_name;
+    CHECK_RC(tapi_env_allocate_addr(iut_if->net, AF_INET, &new_addr, NULL));
+    TE_SPRINTF(addr_str, "%s", te_sockaddr_get_ipstr(new_addr));
+
+    TE_SPRINTF(if_oid, "/agent:%s/interface:%s", pco_iut->ta, if_name);
+    TE_SPRINTF(addr_oid, "%s/net_addr:%s", if_oid, addr_str);
+    TE_SPRINTF(bcast_oid, "%s/broadcast:", addr_oid);
+
+    TEST_STEP("Add an address to @p iut_if bypassing Configurator");
+    rpc_system_ex(pco_iut, "ip addr add %s/%u dev %s", addr_str,
+                  iut_if->net->ip4pfx, if_name);
+    added = TRUE;
+    check_inst(addr_oid, FALSE);
+
+    TEST_STEP("Synchronize @p iut_if subtree with depth 1 and check that "
+              "the address is added but its broadcast is not");
+    CHECK_RC(cfg_synchronize_depth(if_oid, 1));
+    check_inst(addr_oid, TRUE);
+    check_inst(bcast_oid, FALSE);
+
+    TEST_STEP("Synchronize @p iut_if subtree with depth 2 and check that "
+              "broadcast of the address is added");
+    CHECK_RC(cfg_synchronize_depth(if_oid, 2));
+    check_inst(bcast_oid, TRUE);
+
+    TEST_STEP("Remove the address bypassing Configurator, synchronize "
+              "@p iut_if subtree with depth 1 and check that the address "
+              "is removed");
+    rpc_system_ex(pco_iut, "ip addr del %s/%u dev %s", addr_str,
+                  iut_if->net->ip4pfx, if_name);
+    added = FALSE;
+    CHECK_RC(cfg_synchronize_depth(if_oid, 1));
+    check_inst(addr_oid, FALSE);
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (added)
+    {
+        RPC_AWAIT_ERROR(pco_iut);
+        rpc_system_ex(pco_iut, "ip addr del %s/%u dev %s", addr_str,
+                      iut_if->net->ip4pfx, if_name);
+        CLEANUP_CHECK_RC(cfg_synchronize(if_oid, TRUE));
+    }
+    free(new_addr);
+
+    TEST_END;
+}
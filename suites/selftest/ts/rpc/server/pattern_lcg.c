@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment
+ *
+ * Linear congruential pattern generator with positions.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page rpc_server-pattern_lcg Linear congruential pattern generator
+ *
+ * @objective Check that messages generated by
+ *            @ref RPC_PATTERN_GEN_LCG_POS carry the linear congruential
+ *            sequence from the position put in their header, and that
+ *            pattern receiver checks messages starting far from
+ *            the first element of the sequence.
+ *
+ * @param env   Testing environment with @p pco_iut and @p pco_tst
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME    "pattern_lcg"
+
+#include "rpc_suite.h"
+#include "tapi_rpc_client_server.h"
+
+/** Multiplying constant of the sequence */
+#define LCG_A           1664525
+/** Additive constant of the sequence */
+#define LCG_C           1013904223
+/** The first element of the sequence */
+#define LCG_X0          12345
+/** Position of the first element sent */
+#define START_POS       100000
+/** Length of a message (elements do not fit it exactly) */
+#define MSG_LEN         1001
+/** Length of the header with the position of the first element */
+#define HDR_LEN         8
+/** Number of elements in a message */
+#define MSG_WORDS       ((MSG_LEN - HDR_LEN + 3) / 4)
+/** Number of messages sent at once */
+#define MSGS_NUM        10
+
+/* Compute the element of the sequence at a position step by step */
+static uint32_t
+lcg_at(uint64_t pos)
+{
+    uint32_t x = LCG_X0;
+
+    for (; pos > 0; pos--)
+        x = LCG_A * x + LCG_C;
+
+    return x;
+}
+
+/* Check a message against the sequence computed step by step */
+static void
+check_msg(const uint8_t *msg, size_t len, uint64_t exp_pos)
+{
+    uint8_t  exp[MSG_LEN + 3];
+    uint32_t x = lcg_at(exp_pos);
+    uint32_t word;
+    size_t   i;
+
+    if (len != MSG_LEN)
+        TEST_VERDICT("Message of unexpected length is received");
+
+    for (i = 0; i < HDR_LEN; i++)
+        exp[i] = exp_pos >> (8 * (HDR_LEN - 1 - i));
+
+    for (i = HDR_LEN; i < len; i += sizeof(word))
+    {
+        word = htonl(x);
+        memcpy(exp + i, &word, sizeof(word));
+        x = LCG_A * x + LCG_C;
+    }
+
+    if (memcmp(msg, exp, HDR_LEN) != 0)
+        TEST_VERDICT("Message header has unexpected position");
+    if (memcmp(msg + HDR_LEN, exp + HDR_LEN, len - HDR_LEN) != 0)
+        TEST_VERDICT("Message does not match the sequence");
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server          *pco_iut = NULL;
+    rcf_rpc_server          *pco_tst = NULL;
+    const struct sockaddr   *iut_addr;
+    const struct sockaddr   *tst_addr;
+    int                      iut_s = -1;
+    int                      tst_s = -1;
+    tapi_pat_sender          sender;
+    tapi_pat_receiver        receiver;
+    uint8_t                  msg[MSG_LEN + 1];
+    uint64_t                 round_pos;
+    ssize_t                  len;
+    unsigned int             i;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+
+    TEST_STEP("Create a pair of connected UDP sockets");
+    GEN_CONNECTION(pco_tst, pco_iut, RPC_SOCK_DGRAM, RPC_PROTO_DEF,
+                   tst_addr, iut_addr, &tst_s, &iut_s);
+
+    TEST_STEP("Send messages starting from a position in the middle of "
+              "the sequence and check them against the sequence computed "
+              "step by step");
+    tapi_pat_sender_init(&sender);
+    sender.gen_func = RPC_PATTERN_GEN_LCG_POS;
+    sender.gen_arg.coef1 = lcg_at(START_POS);
+    sender.gen_arg.coef2 = LCG_A;
+    sender.gen_arg.coef3 = LCG_C;
+    sender.gen_arg.pos = START_POS;
+    tapi_rand_gen_set(&sender.size, MSG_LEN, MSG_LEN, TRUE);
+    tapi_rand_gen_set(&sender.delay, 0, 0, TRUE);
+    sender.duration_sec = 5;
+    sender.total_size = MSG_LEN * MSGS_NUM;
+
+    rpc_pattern_sender(pco_iut, iut_s, &sender);
+    if (sender.sent != MSG_LEN * MSGS_NUM)
+        TEST_VERDICT("Not all messages are sent");
+
+    for (i = 0; i < MSGS_NUM; i++)
+    {
+        len = rpc_recv(pco_tst, tst_s, msg, sizeof(msg), 0);
+        check_msg(msg, len, START_POS + (uint64_t)i * MSG_WORDS);
+    }
+
+    round_pos = START_POS + (uint64_t)MSGS_NUM * MSG_WORDS;
+    if (sender.gen_arg.pos != round_pos ||
+        sender.gen_arg.coef1 != lcg_at(round_pos))
+        TEST_VERDICT("Generator state is not updated for the next message");
+
+    TEST_STEP("Receive messages continuing the sequence by the pattern "
+              "receiver which starts from the first element and check "
+              "that preceding elements are reported as lost");
+    tapi_pat_receiver_init(&receiver);
+    receiver.gen_func = RPC_PATTERN_GEN_LCG_POS;
+    receiver.gen_arg.coef1 = LCG_X0;
+    receiver.gen_arg.coef2 = LCG_A;
+    receiver.gen_arg.coef3 = LCG_C;
+    receiver.duration_sec = 10;
+    receiver.time2wait = 1000;
+    receiver.exp_received = MSG_LEN * MSGS_NUM;
+
+    pco_tst->op = RCF_RPC_CALL;
+    rpc_pattern_receiver(pco_tst, tst_s, &receiver);
+
+    sender.total_size = MSG_LEN * MSGS_NUM;
+    rpc_pattern_sender(pco_iut, iut_s, &sender);
+
+    pco_tst->op = RCF_RPC_WAIT;
+    rpc_pattern_receiver(pco_tst, tst_s, &receiver);
+
+    if (receiver.received != sender.sent)
+        TEST_VERDICT("Not all sent data are received");
+    if (receiver.lost != round_pos * 4)
+    {
+        ERROR("%" TE_PRINTF_64 "u bytes are lost instead of "
+              "%" TE_PRINTF_64 "u", receiver.lost, round_pos * 4);
+        TEST_VERDICT("Wrong amount of lost data is reported");
+    }
+    if (receiver.duplicated != 0 || receiver.reordered != 0)
+        TEST_VERDICT("Messages are reported as duplicated or reordered");
+
+    TEST_SUCCESS;
+
+cleanup:
+    CLEANUP_RPC_CLOSE(pco_iut, iut_s);
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+
+    TEST_END;
+}
@@ -0,0 +1,158 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment
+ *
+ * RPC calls over shared memory RPC transport.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page rpc_shm RPC calls over shared memory rings
+ *
+ * @objective Check that RPC calls work when data are passed via shared
+ *            memory rings, including messages larger than a ring and
+ *            RPC servers created by fork(), that the rings are really
+ *            mapped by RPC servers and that they are not used if
+ *            they are not enabled.
+ *
+ * @param env   Testing environment with @p pco_iut
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME    "rpc_shm"
+
+#include "rpc_suite.h"
+#include "tapi_mem.h"
+#include "tapi_sh_env.h"
+#include "tapi_rpc_stdio.h"
+
+/** Size of the data buffer, it is larger than a shared memory ring */
+#define RPC_SHM_BUF_SIZE    (700 * 1024)
+
+/** Name of the shared memory file of the rings */
+#define RPC_SHM_FILE_NAME   "te_rpc_shm"
+
+/**
+ * Check whether shared memory rings are mapped by the RPC server
+ * process.
+ *
+ * @param rpcs      RPC server
+ * @param expected  Whether the rings are expected to be mapped
+ */
+static void
+check_rings_mapped(rcf_rpc_server *rpcs, te_bool expected)
+{
+    rpc_wait_status st;
+    char           *maps = NULL;
+    te_bool         mapped;
+    pid_t           pid;
+
+    pid = rpc_getpid(rpcs);
+    st = rpc_shell_get_all2(rpcs, &maps, "cat /proc/%d/maps", (int)pid);
+    if (st.flag != RPC_WAIT_STATUS_EXITED || st.value != 0 || maps == NULL)
+    {
+        free(maps);
+        TEST_FAIL("Failed to get memory mappings of RPC server %s",
+                  rpcs->name);
+    }
+
+    mapped = strstr(maps, RPC_SHM_FILE_NAME) != NULL;
+    free(maps);
+
+    if (mapped != expected)
+    {
+        TEST_VERDICT("Shared memory rings are %s by RPC server %s",
+                     mapped ? "unexpectedly mapped" : "not mapped",
+                     rpcs->name);
+    }
+}
+
+/**
+ * Pass a buffer to the RPC server and get it back.
+ *
+ * @param rpcs      RPC server
+ */
+static void
+check_buf_round_trip(rcf_rpc_server *rpcs)
+{
+    uint8_t *tx_buf = te_make_buf_by_len(RPC_SHM_BUF_SIZE);
+    uint8_t *rx_buf = tapi_calloc(1, RPC_SHM_BUF_SIZE);
+    rpc_ptr  buf;
+
+    buf = rpc_malloc(rpcs, RPC_SHM_BUF_SIZE);
+    rpc_set_buf(rpcs, tx_buf, RPC_SHM_BUF_SIZE, buf);
+    rpc_get_buf(rpcs, buf, RPC_SHM_BUF_SIZE, rx_buf);
+    rpc_free(rpcs, buf);
+
+    if (memcmp(tx_buf, rx_buf, RPC_SHM_BUF_SIZE) != 0)
+        TEST_VERDICT("Data are corrupted on RPC server %s", rpcs->name);
+
+    free(tx_buf);
+    free(rx_buf);
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_child = NULL;
+    te_bool         env_set = FALSE;
+    pid_t           pid_iut;
+    pid_t           pid_child;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+
+    TEST_STEP("Enable shared memory RPC transport on the agent and "
+              "restart @p pco_iut");
+    CHECK_RC(tapi_sh_env_set(pco_iut, "TE_RPC_SHM", "1",
+                             TRUE, TRUE));
+    env_set = TRUE;
+
+    TEST_STEP("Check that @p pco_iut maps shared memory rings");
+    check_rings_mapped(pco_iut, TRUE);
+
+    TEST_STEP("Pass a buffer larger than a ring to @p pco_iut and back");
+    check_buf_round_trip(pco_iut);
+
+    TEST_STEP("Fork @p pco_iut");
+    CHECK_RC(rcf_rpc_server_fork(pco_iut, "iut_child", &pco_child));
+
+    TEST_STEP("Check that both the parent and the child serve RPC calls");
+    pid_iut = rpc_getpid(pco_iut);
+    pid_child = rpc_getpid(pco_child);
+    if (pid_iut == pid_child)
+        TEST_VERDICT("The forked RPC server runs in the parent process");
+
+    check_rings_mapped(pco_child, TRUE);
+    check_buf_round_trip(pco_child);
+    check_buf_round_trip(pco_iut);
+
+    TEST_STEP("Destroy the child and check that @p pco_iut still works");
+    CHECK_RC(rcf_rpc_server_destroy(pco_child));
+    pco_child = NULL;
+    check_buf_round_trip(pco_iut);
+
+    TEST_STEP("Disable shared memory RPC transport on the agent, restart "
+              "@p pco_iut and check that it works without the rings");
+    CHECK_RC(tapi_sh_env_unset(pco_iut, "TE_RPC_SHM", FALSE, TRUE));
+    env_set = FALSE;
+    check_rings_mapped(pco_iut, FALSE);
+    check_buf_round_trip(pco_iut);
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (pco_child != NULL)
+        CLEANUP_CHECK_RC(rcf_rpc_server_destroy(pco_child));
+
+    if (env_set)
+    {
+        CLEANUP_CHECK_RC(tapi_sh_env_unset(pco_iut, "TE_RPC_SHM",
+                                           FALSE, TRUE));
+    }
+
+    TEST_END;
+}
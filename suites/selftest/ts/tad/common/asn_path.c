@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment
+ *
+ * Tests on generic TAD functionality.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page common-asn_path Compiled ASN.1 label paths
+ *
+ * @objective Check that compiled label paths are cached consistently
+ *            and find the same subvalues as lookup by labels does.
+ *
+ * @par Scenario:
+ *
+ * -# Parse a raw packet with Ethernet PDU.
+ * -# Compile the same labels several times and check that the same
+ *    compiled path is returned for the same type and labels and
+ *    a different one for another type.
+ * -# Check that @b asn_path_find() finds the same subvalues as
+ *    @b asn_find_descendant() does and fails in the same way.
+ * -# Check that lookup by labels with different indexes of
+ *    @c SEQUENCE_OF elements finds different elements or fails
+ *    if there is no such element.
+ *
+ */
+
+#ifndef DOXYGEN_TEST_SPEC
+
+#define TE_TEST_NAME    "common/asn_path"
+
+#include "te_config.h"
+
+#include "tapi_test.h"
+#include "asn_usr.h"
+#include "ndn.h"
+#include "ndn_eth.h"
+
+/** Labels of Ethernet length/type field in a raw packet */
+#define LEN_TYPE_LABELS "pdus.0.#eth.length-type.#plain"
+
+/** Raw packet used in the test */
+#define RAW_PACKET_TEXT \
+    "{ pdus { eth:{ src-addr plain:'00 0E A6 41 D5 2E'H, " \
+    "               dst-addr plain:'FF FF FF FF FF FF'H, " \
+    "               length-type plain:2054 } }, "          \
+    "  payload bytes:'01 02 03 04'H }"
+
+/**
+ * Check that lookup by compiled path and by labels give the same result.
+ *
+ * @param pkt       ASN.1 value
+ * @param labels    Labels of the subvalue
+ */
+static void
+check_find(const asn_value *pkt, const char *labels)
+{
+    const asn_path *path;
+    asn_value      *by_path;
+    asn_value      *by_labels;
+    te_errno        rc_path;
+    te_errno        rc_labels;
+
+    CHECK_RC(asn_path_compile(ndn_raw_packet, labels, &path));
+    by_path = asn_path_find(pkt, path, &rc_path);
+    by_labels = asn_find_descendant(pkt, &rc_labels, labels);
+    if (by_path != by_labels ||
+        TE_RC_GET_ERROR(rc_path) != TE_RC_GET_ERROR(rc_labels))
+    {
+        ERROR("%s: compiled path: %p, %r; labels: %p, %r",
+              labels, by_path, rc_path, by_labels, rc_labels);
+        TEST_VERDICT("Field is looked up differently by compiled path "
+                     "and by labels");
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    asn_value      *pkt = NULL;
+    const asn_path *path1;
+    const asn_path *path2;
+    const asn_path *path3;
+    char            labels_copy[] = LEN_TYPE_LABELS;
+    asn_value      *first;
+    asn_value      *last;
+    asn_value      *missing;
+    te_errno        rc_missing;
+    int             syms;
+
+    TEST_START;
+
+    TEST_STEP("Parse a raw packet with Ethernet PDU");
+    CHECK_RC(asn_parse_value_text(RAW_PACKET_TEXT, ndn_raw_packet,
+                                  &pkt, &syms));
+
+    TEST_STEP("Compile the same labels several times");
+    CHECK_RC(asn_path_compile(ndn_raw_packet, LEN_TYPE_LABELS, &path1));
+    CHECK_RC(asn_path_compile(ndn_raw_packet, labels_copy, &path2));
+    if (path1 != path2)
+        TEST_VERDICT("Cached path is not found for the same labels");
+
+    CHECK_RC(asn_path_compile(ndn_traffic_pattern_unit, LEN_TYPE_LABELS,
+                              &path3));
+    if (path3 == path1)
+        TEST_VERDICT("Path compiled for another type is returned");
+
+    TEST_STEP("Compare lookups by compiled path and by labels");
+    check_find(pkt, LEN_TYPE_LABELS);
+    check_find(pkt, "pdus.1.#eth");
+    check_find(pkt, "received");
+
+    TEST_STEP("Look up elements of SEQUENCE_OF by different indexes");
+    first = asn_find_descendant(pkt, NULL, "pdus.0.#eth");
+    last = asn_find_descendant(pkt, NULL, "pdus.-1.#eth");
+    if (first == NULL || first != last)
+    {
+        ERROR("pdus.0: %p, pdus.-1: %p", first, last);
+        TEST_VERDICT("The only PDU is found differently by positive "
+                     "and negative indexes");
+    }
+
+    missing = asn_find_descendant(pkt, &rc_missing, "pdus.1.#eth");
+    if (missing != NULL || rc_missing == 0)
+        TEST_VERDICT("PDU which does not exist is found");
+
+    TEST_SUCCESS;
+
+cleanup:
+    asn_free_value(pkt);
+
+    TEST_END;
+}
+
+#endif /* !DOXYGEN_TEST_SPEC */
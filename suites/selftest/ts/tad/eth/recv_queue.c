@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment
+ *
+ * Limit of the queue of packets received by Ethernet CSAP.
+ *
+ * Copyright (C) 2024 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page eth-recv_queue Limit of the queue of received packets
+ *
+ * @objective Check that Ethernet CSAP applies the limit and the policy
+ *            of the queue of received packets and reports them in
+ *            receive statistics.
+ *
+ * @param host_send     Host to send data
+ * @param if_send       Interface of the @p host_send to send data to
+ * @param hwaddr_send   IEEE 802.3 MAC address of the sender
+ * @param host_recv     Host to receive data
+ * @param if_recv       Interface of the @p host_recv to receive data from
+ * @param hwaddr_recv   IEEE 802.3 MAC address of the receiver
+ * @param policy        Policy applied when the queue is full:
+ *                      - @c drop-oldest
+ *                      - @c pause
+ *
+ * @par Scenario:
+ *
+ * -# Create eth CSAPs on @p host_send and @p host_recv, the receive
+ *    CSAP has the queue limited by @c QUEUE_LIMIT packets with
+ *    @p policy.
+ * -# Start to receive packets on the receive CSAP and send
+ *    @c PKTS_NUM frames.
+ * -# Check receive statistics:
+ *      - the queue is full and has never been longer than the limit;
+ *      - no packets are dropped by the media;
+ *      - with @c drop-oldest policy all frames are matched and
+ *        the excess is dropped from the queue;
+ *      - with @c pause policy no packets are dropped from the queue
+ *        and the excess is not read from the media.
+ * -# Stop receiving and check that the queued packets are got.
+ * -# Destroy created CSAPs.
+ *
+ */
+
+#ifndef DOXYGEN_TEST_SPEC
+
+#define TE_TEST_NAME    "eth/recv_queue"
+
+#define TEST_START_VARS         TEST_START_ENV_VARS
+#define TEST_START_SPECIFIC     TEST_START_ENV
+#define TEST_END_SPECIFIC       TEST_END_ENV
+
+#include "te_config.h"
+
+#include "tapi_test.h"
+#include "tapi_env.h"
+#include "tapi_ndn.h"
+#include "tapi_tad.h"
+#include "tapi_eth.h"
+#include "ndn.h"
+
+/** Maximum number of packets in the queue */
+#define QUEUE_LIMIT     2
+/** Number of sent frames */
+#define PKTS_NUM        5
+
+/** Policies of the queue */
+#define QUEUE_POLICIES \
+    { "drop-oldest", NDN_CSAP_RECV_QUEUE_DROP_OLDEST }, \
+    { "pause",       NDN_CSAP_RECV_QUEUE_PAUSE }
+
+static const uint16_t tst_eth_type = 0xf0f1;
+
+int
+main(int argc, char **argv)
+{
+    tapi_env_host              *host_send = NULL;
+    tapi_env_host              *host_recv = NULL;
+    const struct if_nameindex  *if_send = NULL;
+    const struct if_nameindex  *if_recv = NULL;
+    const void                 *hwaddr_send = NULL;
+    const void                 *hwaddr_recv = NULL;
+    int                         policy;
+
+    csap_handle_t   send_csap = CSAP_INVALID_HANDLE;
+    csap_handle_t   recv_csap = CSAP_INVALID_HANDLE;
+
+    asn_value  *csap_spec = NULL;
+    asn_value  *tmpl = NULL;
+    asn_value  *pattern = NULL;
+
+    tapi_tad_recv_stats stats;
+    unsigned int        num;
+    unsigned int        i;
+
+    TEST_START;
+    TEST_GET_HOST(host_send);
+    TEST_GET_IF(if_send);
+    TEST_GET_LINK_ADDR(hwaddr_send);
+    TEST_GET_HOST(host_recv);
+    TEST_GET_IF(if_recv);
+    TEST_GET_LINK_ADDR(hwaddr_recv);
+    TEST_GET_ENUM_PARAM(policy, QUEUE_POLICIES);
+
+    TEST_STEP("Create send CSAP and receive CSAP with limited queue");
+    CHECK_RC(tapi_eth_add_csap_layer(&csap_spec, if_send->if_name,
+                                     TAD_ETH_RECV_NO,
+                                     hwaddr_recv, hwaddr_send, NULL,
+                                     TE_BOOL3_ANY, TE_BOOL3_ANY));
+    CHECK_RC(tapi_tad_csap_create(host_send->ta, 0, "eth", csap_spec,
+                                  &send_csap));
+    asn_free_value(csap_spec);
+    csap_spec = NULL;
+
+    CHECK_RC(tapi_eth_add_csap_layer(&csap_spec, if_recv->if_name,
+                                     TAD_ETH_RECV_ALL,
+                                     hwaddr_send, hwaddr_recv,
+                                     &tst_eth_type,
+                                     TE_BOOL3_ANY, TE_BOOL3_ANY));
+    CHECK_RC(asn_write_int32(csap_spec, QUEUE_LIMIT,
+                             "params.recv-queue-limit"));
+    CHECK_RC(asn_write_int32(csap_spec, policy, "params.recv-queue-policy"));
+    CHECK_RC(tapi_tad_csap_create(host_recv->ta, 0, "eth", csap_spec,
+                                  &recv_csap));
+
+    TEST_STEP("Start receiving and send frames");
+    CHECK_RC(tapi_eth_add_pdu(&pattern, NULL, TRUE, NULL, NULL,
+                              &tst_eth_type, TE_BOOL3_ANY, TE_BOOL3_ANY));
+    CHECK_RC(tapi_tad_trrecv_start(host_recv->ta, 0, recv_csap, pattern,
+                                   TAD_TIMEOUT_INF, 0,
+                                   RCF_TRRECV_PACKETS));
+
+    CHECK_RC(tapi_eth_add_pdu(&tmpl, NULL, FALSE, NULL, NULL,
+                              &tst_eth_type, TE_BOOL3_ANY, TE_BOOL3_ANY));
+    for (i = 0; i < PKTS_NUM; i++)
+    {
+        CHECK_RC(tapi_tad_trsend_start(host_send->ta, 0, send_csap, tmpl,
+                                       RCF_MODE_BLOCKING));
+    }
+
+    /* Let the receiver read the frames */
+    SLEEP(1);
+
+    TEST_STEP("Check receive statistics");
+    CHECK_RC(tapi_tad_csap_get_recv_stats(host_recv->ta, 0, recv_csap,
+                                          &stats));
+    RING("matched=%" PRIu64 " queued=%" PRIu64 " queue_max=%" PRIu64
+         " queue_drops=%" PRIu64 " media_drops=%" PRIu64,
+         stats.matched, stats.queued, stats.queue_max, stats.queue_drops,
+         stats.media_drops);
+
+    if (stats.queued != QUEUE_LIMIT || stats.queue_max != QUEUE_LIMIT)
+        TEST_VERDICT("Queue length does not match its limit");
+    if (stats.media_drops != 0)
+        TEST_VERDICT("Packets are reported as dropped by the media");
+
+    if (policy == NDN_CSAP_RECV_QUEUE_DROP_OLDEST)
+    {
+        if (stats.matched != PKTS_NUM)
+            TEST_VERDICT("Not all frames are matched");
+        if (stats.queue_drops != PKTS_NUM - QUEUE_LIMIT)
+            TEST_VERDICT("Unexpected number of packets dropped from "
+                         "the queue");
+    }
+    else
+    {
+        if (stats.queue_drops != 0)
+            TEST_VERDICT("Packets are dropped from the queue");
+        if (stats.matched >= PKTS_NUM)
+            TEST_VERDICT("Receiving is not paused when the queue is full");
+    }
+
+    TEST_STEP("Stop receiving and check the number of got packets");
+    CHECK_RC(tapi_tad_trrecv_stop(host_recv->ta, 0, recv_csap, NULL, &num));
+    if (num < QUEUE_LIMIT)
+        TEST_VERDICT("Queued packets are lost");
+    if (policy == NDN_CSAP_RECV_QUEUE_DROP_OLDEST && num != QUEUE_LIMIT)
+        TEST_VERDICT("More packets than the queue limit are got");
+
+    TEST_SUCCESS;
+
+cleanup:
+    asn_free_value(csap_spec);
+    asn_free_value(tmpl);
+    asn_free_value(pattern);
+
+    if (host_send != NULL)
+        CLEANUP_CHECK_RC(tapi_tad_csap_destroy(host_send->ta, 0,
+                                               send_csap));
+    if (host_recv != NULL)
+        CLEANUP_CHECK_RC(tapi_tad_csap_destroy(host_recv->ta, 0,
+                                               recv_csap));
+
+    TEST_END;
+}
+
+#endif /* !DOXYGEN_TEST_SPEC */
@@ -0,0 +1,109 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TAPI Job test suite cgroup signalling test
+ *
+ * TAPI Job test suite cgroup signalling test
+ *
+ * Copyright (C) 2022-2022 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page job-cgroup_killpg Signal all processes of a job in a dedicated cgroup
+ *
+ * @objective Check that a signal sent to the process group of a job
+ *            running in a dedicated cgroup reaches every process of
+ *            the cgroup, including ones which left the process group
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "job/cgroup_killpg"
+
+#include "te_config.h"
+
+#include "tapi_cfg_process.h"
+#include "tapi_job.h"
+#include "tapi_job_factory_cfg.h"
+#include "tapi_test.h"
+
+/**
+ * Maximum CPU time in microseconds which may be accounted in the cgroup
+ * after the job is signalled
+ */
+#define CGROUP_KILLPG_CPU_SLACK_US 10000
+
+int
+main(int argc, char **argv)
+{
+    const char *ta = "Agt_A";
+    const char *name = "cgroup_killpg";
+    const char *tool = "/bin/sh";
+    const char *script =
+        "for i in 1 2 3 4; do "
+        "setsid sh -c 'while :; do :; done' & done; wait";
+    tapi_job_factory_t *factory = NULL;
+    tapi_job_t *job = NULL;
+    tapi_job_status_t exit_status;
+    uint64_t cpu_before;
+    uint64_t cpu_after;
+
+    TEST_START;
+
+    TEST_STEP("Initialize factory");
+    CHECK_RC(tapi_job_factory_cfg_create(ta, &factory));
+
+    TEST_STEP("Create a job which starts several busy processes, each in "
+              "its own session");
+    CHECK_RC(tapi_job_create(factory, name, tool,
+                             (const char *[]){tool, "-c", script, NULL},
+                             NULL, &job));
+
+    TEST_STEP("Make the job run in a dedicated cgroup");
+    CHECK_RC(tapi_cfg_ps_set_cgroup(ta, name, TRUE, NULL));
+
+    TEST_STEP("Start the job");
+    CHECK_RC(tapi_job_start(job));
+
+    VSLEEP(1, "Wait for the busy processes to start");
+
+    TEST_STEP("Check that the processes consume CPU");
+    CHECK_RC(tapi_cfg_ps_get_cgroup_stat(ta, name, "cpu_usage",
+                                         &cpu_before));
+    VSLEEP(1, "Let the busy processes run");
+    CHECK_RC(tapi_cfg_ps_get_cgroup_stat(ta, name, "cpu_usage",
+                                         &cpu_after));
+    if (cpu_after <= cpu_before)
+        TEST_FAIL("CPU usage of the cgroup does not grow");
+
+    TEST_STEP("Send SIGTERM to the process group of the job");
+    CHECK_RC(tapi_job_killpg(job, SIGTERM));
+
+    TEST_STEP("Check exit status of the job");
+    CHECK_RC(tapi_job_wait(job, TE_SEC2MS(5), &exit_status));
+    if (exit_status.type != TAPI_JOB_STATUS_SIGNALED ||
+        exit_status.value != SIGTERM)
+    {
+        TEST_VERDICT("The job was not terminated by SIGTERM");
+    }
+
+    TEST_STEP("Check that no process of the cgroup consumes CPU anymore");
+    CHECK_RC(tapi_cfg_ps_get_cgroup_stat(ta, name, "cpu_usage",
+                                         &cpu_before));
+    VSLEEP(1, "Let remaining processes run if any");
+    CHECK_RC(tapi_cfg_ps_get_cgroup_stat(ta, name, "cpu_usage",
+                                         &cpu_after));
+    if (cpu_after - cpu_before > CGROUP_KILLPG_CPU_SLACK_US)
+    {
+        TEST_VERDICT("Some processes of the cgroup did not get the signal, "
+                     "%" PRIu64 " us of CPU time consumed after it",
+                     cpu_after - cpu_before);
+    }
+
+    TEST_SUCCESS;
+
+cleanup:
+    CLEANUP_CHECK_RC(tapi_job_destroy(job, -1));
+    tapi_job_factory_destroy(factory);
+
+    TEST_END;
+}
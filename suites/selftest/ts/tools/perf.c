@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2024 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Test for te_perf.h functions
+ *
+ * Testing performance counters registry
+ */
+
+/** @page tools_perf te_perf.h test
+ *
+ * @objective Testing performance counters registry
+ *
+ * Check that counters and histograms are registered once, updated
+ * correctly from several threads and reported in the order of names.
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "tools/perf"
+
+#include "te_config.h"
+
+#include <pthread.h>
+
+#include "tapi_test.h"
+#include "te_perf.h"
+
+/** Number of updating threads */
+#define N_THREADS       4
+
+/** Number of updates done by each thread */
+#define N_UPDATES       100000
+
+/* Update a counter and a histogram concurrently with other threads */
+static void *
+update_thread(void *arg)
+{
+    te_perf_counter *counter = te_perf_counter_get("selftest.counter");
+    te_perf_hist    *hist = te_perf_hist_get("selftest.hist");
+    unsigned int     i;
+
+    UNUSED(arg);
+
+    for (i = 0; i < N_UPDATES; i++)
+    {
+        te_perf_counter_add(counter, 1);
+        te_perf_hist_add(hist, i % 1000);
+    }
+
+    return NULL;
+}
+
+/* Collect names of metrics */
+static te_errno
+collect_names(const char *name, const te_perf_counter *counter,
+              const te_perf_hist *hist, void *opaque)
+{
+    te_string *names = opaque;
+
+    UNUSED(counter);
+    UNUSED(hist);
+
+    if (strcmp_start("selftest.", name) == 0)
+        te_string_append(names, "%s%s", names->len == 0 ? "" : ",", name);
+
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    pthread_t           threads[N_THREADS];
+    te_perf_hist_stats  stats;
+    te_perf_hist       *hist;
+    te_string           names = TE_STRING_INIT;
+    te_string           dump = TE_STRING_INIT;
+    const te_perf_counter *counter;
+    unsigned int        i;
+
+    TEST_START;
+
+    TEST_STEP("Check that a metric is registered once");
+    if (te_perf_counter_get("selftest.%s", "counter") !=
+        te_perf_counter_get("selftest.counter"))
+        TEST_VERDICT("Counter is registered twice");
+    if (te_perf_hist_find("selftest.counter") != NULL)
+        TEST_VERDICT("Counter is found as a histogram");
+
+    TEST_STEP("Update metrics from several threads");
+    for (i = 0; i < N_THREADS; i++)
+    {
+        if (pthread_create(&threads[i], NULL, update_thread, NULL) != 0)
+            TEST_FAIL("Failed to create a thread");
+    }
+    for (i = 0; i < N_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    TEST_STEP("Check the counter value");
+    CHECK_NOT_NULL(counter = te_perf_counter_find("selftest.counter"));
+    if (te_perf_counter_value(counter) != N_THREADS * N_UPDATES)
+    {
+        TEST_VERDICT("Counter value is %" PRId64 " instead of %u",
+                     te_perf_counter_value(counter),
+                     N_THREADS * N_UPDATES);
+    }
+
+    TEST_STEP("Check the histogram statistics");
+    CHECK_NOT_NULL(te_perf_hist_find("selftest.hist"));
+    te_perf_hist_stats_get(te_perf_hist_find("selftest.hist"), &stats);
+    RING("count=%" PRIu64 " sum=%" PRIu64 " max=%" PRIu64 " p50=%" PRIu64
+         " p90=%" PRIu64 " p99=%" PRIu64, stats.count, stats.sum,
+         stats.max, stats.p50, stats.p90, stats.p99);
+    if (stats.count != N_THREADS * N_UPDATES)
+        TEST_VERDICT("Histogram count is wrong");
+    if (stats.sum != (uint64_t)N_THREADS * (N_UPDATES / 1000) *
+                     (999 * 1000 / 2))
+        TEST_VERDICT("Histogram sum is wrong");
+    if (stats.max != 999)
+        TEST_VERDICT("Histogram maximum is wrong");
+    /* Percentiles are upper bounds of power of 2 buckets */
+    if (stats.p50 != 511 || stats.p90 != 999 || stats.p99 != 999)
+        TEST_VERDICT("Histogram percentiles are wrong");
+
+    TEST_STEP("Check that an empty histogram has zero statistics");
+    hist = te_perf_hist_get("selftest.empty");
+    te_perf_hist_stats_get(hist, &stats);
+    if (stats.count != 0 || stats.max != 0 || stats.p99 != 0)
+        TEST_VERDICT("Statistics of an empty histogram are not zero");
+
+    TEST_STEP("Check that metrics are reported in the order of names");
+    te_perf_counter_get("selftest.a");
+    te_perf_foreach(collect_names, &names);
+    if (strcmp(names.ptr, "selftest.a,selftest.counter,"
+                          "selftest.empty,selftest.hist") != 0)
+        TEST_VERDICT("Unexpected order of metrics: %s", names.ptr);
+
+    TEST_STEP("Check the dump of metrics");
+    te_perf_dump(&dump);
+    RING("Dump:\n%s", dump.ptr);
+    if (strstr(dump.ptr, "selftest.counter 400000\n") == NULL)
+        TEST_VERDICT("Counter is not dumped correctly");
+    if (strstr(dump.ptr, "selftest.hist count=400000 avg=499 ") == NULL)
+        TEST_VERDICT("Histogram is not dumped correctly");
+
+    TEST_SUCCESS;
+
+cleanup:
+    te_string_free(&names);
+    te_string_free(&dump);
+
+    TEST_END;
+}
@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2024 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Test for te_toeplitz.h functions
+ *
+ * Testing batch calculation of Toeplitz hashes
+ */
+
+/** @page tools_toeplitz te_toeplitz.h test
+ *
+ * @objective Testing batch calculation of Toeplitz hashes
+ *
+ * Check that hashes of many connections calculated at once are the same
+ * as hashes calculated for every connection separately.
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "tools/toeplitz"
+
+#include "te_config.h"
+
+#include "tapi_test.h"
+#include "tapi_mem.h"
+#include "te_toeplitz.h"
+
+/** Number of connections hashed at once */
+#define CONN_NUM    1000
+
+/** Microsoft RSS verification key */
+static const uint8_t test_key[] = {
+    0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+    0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+    0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+    0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+    0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+};
+
+/** Connection hashed in the test */
+typedef struct test_conn {
+    uint8_t  src_addr[sizeof(struct in6_addr)];
+    uint8_t  dst_addr[sizeof(struct in6_addr)];
+    uint16_t src_port;
+    uint16_t dst_port;
+} test_conn;
+
+/* Fill a buffer with random bytes */
+static void
+fill_random(uint8_t *buf, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = rand_range(0, UINT8_MAX);
+}
+
+/*
+ * Hash random connections with te_toeplitz_hash_batch() and compare
+ * the result with te_toeplitz_hash() or te_toeplitz_hash_sym_or_xor().
+ */
+static void
+check_batch(const te_toeplitz_hash_cache *cache,
+            te_toeplitz_hash_variant hash_var, unsigned int addr_size)
+{
+    test_conn    *conns = tapi_calloc(CONN_NUM, sizeof(*conns));
+    uint8_t      *input = tapi_calloc(CONN_NUM, TE_TOEPLITZ_INPUT_MAX);
+    uint32_t     *hashes = tapi_calloc(CONN_NUM, sizeof(*hashes));
+    unsigned int  datalen = 0;
+    uint32_t      expected;
+    unsigned int  i;
+
+    for (i = 0; i < CONN_NUM; i++)
+    {
+        fill_random(conns[i].src_addr, addr_size);
+        fill_random(conns[i].dst_addr, addr_size);
+        conns[i].src_port = rand_range(1, UINT16_MAX);
+        conns[i].dst_port = rand_range(1, UINT16_MAX);
+
+        datalen = te_toeplitz_hash_input(hash_var, addr_size,
+                                         conns[i].src_addr,
+                                         conns[i].src_port,
+                                         conns[i].dst_addr,
+                                         conns[i].dst_port,
+                                         input + i * TE_TOEPLITZ_INPUT_MAX);
+    }
+
+    te_toeplitz_hash_batch(cache, input, TE_TOEPLITZ_INPUT_MAX, datalen,
+                           CONN_NUM, hashes);
+
+    for (i = 0; i < CONN_NUM; i++)
+    {
+        if (hash_var == TE_TOEPLITZ_HASH_SYM_OR_XOR)
+        {
+            expected = te_toeplitz_hash_sym_or_xor(cache, addr_size,
+                                                   conns[i].src_addr,
+                                                   conns[i].src_port,
+                                                   conns[i].dst_addr,
+                                                   conns[i].dst_port);
+        }
+        else
+        {
+            expected = te_toeplitz_hash(cache, addr_size,
+                                        conns[i].src_addr,
+                                        conns[i].src_port,
+                                        conns[i].dst_addr,
+                                        conns[i].dst_port);
+        }
+
+        if (hashes[i] != expected)
+        {
+            ERROR("Connection %u: batch hash 0x%08x, scalar hash 0x%08x",
+                  i, hashes[i], expected);
+            TEST_VERDICT("Batch hash differs from scalar one");
+        }
+    }
+
+    free(conns);
+    free(input);
+    free(hashes);
+}
+
+int
+main(int argc, char **argv)
+{
+    te_toeplitz_hash_cache *cache = NULL;
+    struct in_addr          src = { .s_addr = htonl(0x420995bb) };
+    struct in_addr          dst = { .s_addr = htonl(0xa18e6450) };
+    uint8_t                 input[TE_TOEPLITZ_INPUT_MAX];
+    unsigned int            datalen;
+    uint32_t                hash;
+
+    TEST_START;
+
+    cache = te_toeplitz_cache_init(test_key);
+    if (cache == NULL)
+        TEST_FAIL("Failed to create Toeplitz hash cache");
+
+    TEST_STEP("Check the hash of a known IPv4 connection");
+    hash = te_toeplitz_hash(cache, sizeof(src), (const uint8_t *)&src,
+                            htons(2794), (const uint8_t *)&dst,
+                            htons(1766));
+    if (hash != 0x51ccc178)
+        TEST_VERDICT("Scalar hash of a known connection is wrong");
+
+    datalen = te_toeplitz_hash_input(TE_TOEPLITZ_HASH_STANDARD, sizeof(src),
+                                     (const uint8_t *)&src, htons(2794),
+                                     (const uint8_t *)&dst, htons(1766),
+                                     input);
+    te_toeplitz_hash_batch(cache, input, datalen, datalen, 1, &hash);
+    if (hash != 0x51ccc178)
+        TEST_VERDICT("Batch hash of a known connection is wrong");
+
+    TEST_STEP("Compare batch and scalar hashes of random connections");
+    check_batch(cache, TE_TOEPLITZ_HASH_STANDARD, sizeof(struct in_addr));
+    check_batch(cache, TE_TOEPLITZ_HASH_STANDARD, sizeof(struct in6_addr));
+    check_batch(cache, TE_TOEPLITZ_HASH_SYM_OR_XOR,
+                sizeof(struct in_addr));
+    check_batch(cache, TE_TOEPLITZ_HASH_SYM_OR_XOR,
+                sizeof(struct in6_addr));
+
+    TEST_SUCCESS;
+
+cleanup:
+    te_toeplitz_hash_fini(cache);
+
+    TEST_END;
+}
@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2024 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Test for te_trace.h functions
+ *
+ * Testing trace contexts and spans
+ */
+
+/** @page tools_trace te_trace.h test
+ *
+ * @objective Testing trace contexts and spans
+ *
+ * Check that spans inherit trace context from their parents and that
+ * trace contexts survive formatting and parsing.
+ *
+ * @par Test sequence:
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "tools/trace"
+
+#include "te_config.h"
+
+#include "tapi_test.h"
+#include "te_trace.h"
+
+int
+main(int argc, char **argv)
+{
+    te_trace_ctx  root_ctx = { .trace_id = 0x0123456789abcdef,
+                               .span_id = 0xfedcba9876543210 };
+    te_trace_ctx  parsed;
+    te_trace_ctx  current;
+    te_trace_span span;
+    te_trace_span child;
+    const char   *end;
+    char          buf[64];
+
+    TEST_START;
+
+    TEST_STEP("Check that a trace context is formatted and parsed back");
+    TE_SPRINTF(buf, TE_TRACE_CTX_FMT " rest", TE_TRACE_CTX_ARGS(&root_ctx));
+    CHECK_RC(te_trace_ctx_parse(buf, &parsed, &end));
+    if (parsed.trace_id != root_ctx.trace_id ||
+        parsed.span_id != root_ctx.span_id)
+        TEST_VERDICT("Parsed trace context does not match the original");
+    if (strcmp(end, " rest") != 0)
+        TEST_VERDICT("End of the parsed context is wrong");
+
+    TEST_STEP("Check that malformed trace contexts are rejected");
+    if (te_trace_ctx_parse("0123456789abcdef", &parsed, NULL) == 0 ||
+        te_trace_ctx_parse("0123456789abcdef:0123", &parsed, NULL) == 0 ||
+        te_trace_ctx_parse("0123456789abcdefg:0123456789abcdef",
+                           &parsed, NULL) == 0 ||
+        te_trace_ctx_parse("0123456789abcdef:0123456789abcdef0",
+                           &parsed, NULL) == 0)
+        TEST_VERDICT("Malformed trace context is accepted");
+
+    TEST_STEP("Check that a span inherits the trace of its parent");
+    te_trace_span_start(&span, &root_ctx, "selftest.%s", "root");
+    if (!te_trace_span_active(&span))
+        TEST_VERDICT("Span with a parent is not recorded");
+    if (span.ctx.trace_id != root_ctx.trace_id ||
+        span.parent_id != root_ctx.span_id)
+        TEST_VERDICT("Span is not linked to its parent");
+    if (span.ctx.span_id == 0 || span.ctx.span_id == root_ctx.span_id)
+        TEST_VERDICT("Span ID is not unique");
+    if (strcmp(span.name, "selftest.root") != 0)
+        TEST_VERDICT("Span name is wrong");
+
+    TEST_STEP("Check that the current context is used as a default parent");
+    te_trace_set_current(&span.ctx);
+    te_trace_span_start(&child, NULL, "selftest.child");
+    if (child.ctx.trace_id != span.ctx.trace_id ||
+        child.parent_id != span.ctx.span_id ||
+        child.ctx.span_id == span.ctx.span_id)
+        TEST_VERDICT("Child span is not linked to the current context");
+    te_trace_span_end(&child);
+    if (te_trace_span_active(&child))
+        TEST_VERDICT("Span is still active after its end");
+
+    te_trace_set_current(NULL);
+    te_trace_current(&current);
+    if (current.trace_id != 0)
+        TEST_VERDICT("Current trace context is not reset");
+
+    te_trace_span_end(&span);
+
+    TEST_SUCCESS;
+
+cleanup:
+    te_trace_set_current(NULL);
+
+    TEST_END;
+}
@@ -17,6 +17,7 @@
 
 #include "log_msg.h"
 #include "index_mode.h"
+#include "output.h"
 
 #include "te_errno.h"
 
@@ -66,13 +67,13 @@ print_prev_length(void)
 {
     if (first_message)
     {
-        fprintf(rgt_ctx.out_fd, "0.0 0 0 0 FIRST %u ROOT",
-                TE_TIN_INVALID);
+        rgt_out_printf("0.0 0 0 0 FIRST %u ROOT",
+                       TE_TIN_INVALID);
         first_message = FALSE;
     }
     if (prev_rawlog_fpos >= 0)
-        fprintf(rgt_ctx.out_fd, " %lld\n",
-                (long long int)(rgt_ctx.rawlog_fpos - prev_rawlog_fpos));
+        rgt_out_printf(" %lld\n",
+                       (long long int)(rgt_ctx.rawlog_fpos - prev_rawlog_fpos));
     prev_rawlog_fpos = rgt_ctx.rawlog_fpos;
 }
 
@@ -81,11 +82,11 @@ static int
 print_node_start(node_info_t *node)
 {
     print_prev_length();
-    fprintf(rgt_ctx.out_fd, "%u.%.6u %lld %d %d START %u %s",
-            node->start_ts[0], node->start_ts[1],
-            (long long int)rgt_ctx.rawlog_fpos,
-            node->parent_id, node->node_id,
-            node->descr.tin, node_type2str(node->type));
+    rgt_out_printf("%u.%.6u %lld %d %d START %u %s",
+                   node->start_ts[0], node->start_ts[1],
+                   (long long int)rgt_ctx.rawlog_fpos,
+                   node->parent_id, node->node_id,
+                   node->descr.tin, node_type2str(node->type));
 
     return 1;
 }
@@ -95,11 +96,11 @@ static int
 print_node_end(node_info_t *node)
 {
     print_prev_length();
-    fprintf(rgt_ctx.out_fd, "%u.%.6u %lld %d %d END -1 %s",
-            node->end_ts[0], node->end_ts[1],
-            (long long int)rgt_ctx.rawlog_fpos,
-            node->parent_id, node->node_id,
-            node_type2str(node->type));
+    rgt_out_printf("%u.%.6u %lld %d %d END -1 %s",
+                   node->end_ts[0], node->end_ts[1],
+                   (long long int)rgt_ctx.rawlog_fpos,
+                   node->parent_id, node->node_id,
+                   node_type2str(node->type));
 
     return 1;
 }
@@ -201,10 +202,10 @@ index_process_regular_msg(log_msg *msg)
         to_start_frag = 1;
 
     print_prev_length();
-    fprintf(rgt_ctx.out_fd, "%u.%.6u %lld %u -1 REGULAR %u UNDEF",
-            msg->timestamp[0], msg->timestamp[1],
-            (long long int)rgt_ctx.rawlog_fpos, msg->id,
-            to_start_frag);
+    rgt_out_printf("%u.%.6u %lld %u -1 REGULAR %u UNDEF",
+                   msg->timestamp[0], msg->timestamp[1],
+                   (long long int)rgt_ctx.rawlog_fpos, msg->id,
+                   to_start_frag);
 
     return 1;
 }
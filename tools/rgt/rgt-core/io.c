@@ -25,6 +25,7 @@
 #include "io.h"
 #include "rgt_common.h"
 #include "log_msg.h"
+#include "output.h"
 
 /* See the description in io.h */
 size_t
@@ -76,6 +77,10 @@ universal_read(FILE *fd, void *buf, size_t count, rgt_io_mode_t io_mode, const c
             }
         }
 
+        /* Processing is interrupted, do not wait for more data */
+        if (rgt_interrupted)
+            return 0;
+
         /* Wait for a while may be some data comes */
         sleep(1);
     } while (1);
@@ -142,14 +147,14 @@ write_xml_string(struct obstack *obstk, const char *str, te_bool attr_val)
                     if (obstk != NULL)
                         obstack_grow(obstk, "&#10;", 5);
                     else
-                        fputs("&#10;", rgt_ctx.out_fd);
+                        rgt_out_puts("&#10;");
                 }
                 else
                 {
                     if (obstk != NULL)
                         obstack_grow(obstk, "<br/>", 5);
                     else
-                        fputs("<br/>", rgt_ctx.out_fd);
+                        rgt_out_puts("<br/>");
                 }
                 break;
 
@@ -157,21 +162,21 @@ write_xml_string(struct obstack *obstk, const char *str, te_bool attr_val)
                 if (obstk != NULL)
                     obstack_grow(obstk, "&lt;", 4);
                 else
-                    fputs("&lt;", rgt_ctx.out_fd);
+                    rgt_out_puts("&lt;");
                 break;
 
             case '>':
                 if (obstk != NULL)
                     obstack_grow(obstk, "&gt;", 4);
                 else
-                    fputs("&gt;", rgt_ctx.out_fd);
+                    rgt_out_puts("&gt;");
                 break;
 
             case '&':
                 if (obstk != NULL)
                     obstack_grow(obstk, "&amp;", 5);
                 else
-                    fputs("&amp;", rgt_ctx.out_fd);
+                    rgt_out_puts("&amp;");
                 break;
 
             case '\'':
@@ -186,7 +191,7 @@ write_xml_string(struct obstack *obstk, const char *str, te_bool attr_val)
                     if (obstk != NULL)
                         obstack_grow(obstk, val, strlen(val));
                     else
-                        fputs(val, rgt_ctx.out_fd);
+                        rgt_out_puts(val);
                     break;
                 }
                 /* FALLTHROUGH */
@@ -201,7 +206,7 @@ write_xml_string(struct obstack *obstk, const char *str, te_bool attr_val)
                     if (obstk != NULL)
                         obstack_1grow(obstk, str[i]);
                     else
-                        fputc(str[i], rgt_ctx.out_fd);
+                        rgt_out_putc(str[i]);
                 }
                 else
                 {
@@ -209,8 +214,8 @@ write_xml_string(struct obstack *obstk, const char *str, te_bool attr_val)
                         obstack_printf(obstk, "&lt;0x%02x&gt;",
                                        (unsigned char)str[i]);
                     else
-                        fprintf(rgt_ctx.out_fd, "&lt;0x%02x&gt;",
-                                (unsigned char)str[i]);
+                        rgt_out_printf("&lt;0x%02x&gt;",
+                                       (unsigned char)str[i]);
                 }
                 break;
         }
@@ -26,6 +26,7 @@
 #include "log_msg.h"
 #include "junit_mode.h"
 #include "memory.h"
+#include "output.h"
 
 #include "te_errno.h"
 #include "tq_string.h"
@@ -86,8 +87,8 @@ junit_mode_init(f_process_ctrl_log_msg
 static int
 junit_process_open(void)
 {
-    fputs("<?xml version=\"1.0\"?>\n", rgt_ctx.out_fd);
-    fputs("<testsuites>\n", rgt_ctx.out_fd);
+    rgt_out_puts("<?xml version=\"1.0\"?>\n");
+    rgt_out_puts("<testsuites>\n");
 
     TAILQ_INIT(&pkg_names);
 
@@ -102,7 +103,7 @@ junit_process_close(void)
 {
     tqe_string            *tqe_str;
 
-    fputs("</testsuites>\n", rgt_ctx.out_fd);
+    rgt_out_puts("</testsuites>\n");
 
     while ((tqe_str = TAILQ_FIRST(&pkg_names)) != NULL)
     {
@@ -125,8 +126,8 @@ junit_process_pkg_start(node_info_t *node, ctrl_msg_data *data)
 
     time_val = RGT_TIME_DIFF(node->end_ts, node->start_ts);
 
-    fprintf(rgt_ctx.out_fd, "<testsuite name=\"%s\" time=\"%.3f\">\n",
-            node->descr.name, time_val);
+    rgt_out_printf("<testsuite name=\"%s\" time=\"%.3f\">\n",
+                   node->descr.name, time_val);
 
     tqe_str = calloc(1, sizeof(*tqe_str));
     if (tqe_str == NULL)
@@ -165,7 +166,7 @@ print_verdicts_in_attr_cb(gpointer data, gpointer user_data)
     msg = log_msg_read(msg_ptr);
     rgt_expand_log_msg(msg);
     if (!*first)
-        fputs("; ", rgt_ctx.out_fd);
+        rgt_out_puts("; ");
     write_xml_string(NULL, msg->txt_msg, TRUE);
     free_log_msg(msg);
 
@@ -184,14 +185,14 @@ process_skipped(ctrl_msg_data *data)
     {
         te_bool first = TRUE;
 
-        fputs("<skipped message=\"", rgt_ctx.out_fd);
+        rgt_out_puts("<skipped message=\"");
         msg_queue_foreach(&data->verdicts, print_verdicts_in_attr_cb,
                           &first);
-        fputs("\"/>\n", rgt_ctx.out_fd);
+        rgt_out_puts("\"/>\n");
     }
     else
     {
-        fputs("<skipped/>\n", rgt_ctx.out_fd);
+        rgt_out_puts("<skipped/>\n");
     }
 }
 
@@ -214,7 +215,7 @@ junit_process_pkg_end(node_info_t *node, ctrl_msg_data *data)
         node->result.status == RES_STATUS_SKIPPED)
         process_skipped(data);
 
-    fputs("</testsuite>\n", rgt_ctx.out_fd);
+    rgt_out_puts("</testsuite>\n");
 
     tqe_str = TAILQ_LAST(&pkg_names, tqh_strings);
     assert(tqe_str != NULL);
@@ -237,7 +238,7 @@ process_result_cb(gpointer data, gpointer user_data)
     msg = log_msg_read(msg_ptr);
     rgt_expand_log_msg(msg);
     write_xml_string(NULL, msg->txt_msg, FALSE);
-    fputs("\n", rgt_ctx.out_fd);
+    rgt_out_puts("\n");
     free_log_msg(msg);
 }
 
@@ -253,16 +254,16 @@ junit_process_test_start(node_info_t *node, ctrl_msg_data *data)
     if (ew_log_obstk == NULL)
         ew_log_obstk = obstack_initialize();
 
-    fputs("<testcase classname=\"", rgt_ctx.out_fd);
+    rgt_out_puts("<testcase classname=\"");
 
     tqe_str = TAILQ_FIRST(&pkg_names);
     if (tqe_str != NULL)
     {
-        fputs(tqe_str->v, rgt_ctx.out_fd);
+        rgt_out_puts(tqe_str->v);
         tqe_str = TAILQ_NEXT(tqe_str, links);
         if (tqe_str != NULL)
         {
-            fprintf(rgt_ctx.out_fd, ".%s", tqe_str->v);
+            rgt_out_printf(".%s", tqe_str->v);
             tqe_str = TAILQ_NEXT(tqe_str, links);
         }
         else
@@ -270,25 +271,25 @@ junit_process_test_start(node_info_t *node, ctrl_msg_data *data)
             /* This is done for top prologue/epilogue;
              * otherwise Jenkins will place them into separate
              * hierarchy having unnamed root. */
-            fputs(".[top]", rgt_ctx.out_fd);
+            rgt_out_puts(".[top]");
         }
     }
 
-    fputs("\" name=\"", rgt_ctx.out_fd);
+    rgt_out_puts("\" name=\"");
 
     while (tqe_str != NULL)
     {
-        fprintf(rgt_ctx.out_fd, "%s.", tqe_str->v);
+        rgt_out_printf("%s.", tqe_str->v);
         tqe_str = TAILQ_NEXT(tqe_str, links);
     }
 
-    fputs(node->descr.name, rgt_ctx.out_fd);
+    rgt_out_puts(node->descr.name);
 
     if (!string_empty(node->descr.hash))
-        fprintf(rgt_ctx.out_fd, "%%%s", node->descr.hash);
+        rgt_out_printf("%%%s", node->descr.hash);
 
     time_val = RGT_TIME_DIFF(node->end_ts, node->start_ts);
-    fprintf(rgt_ctx.out_fd, "\" time=\"%.3f\">\n", time_val);
+    rgt_out_printf("\" time=\"%.3f\">\n", time_val);
 
     return 0;
 }
@@ -299,39 +300,39 @@ process_failure(node_info_t *node, ctrl_msg_data *data)
 {
     struct param *p;
 
-    fprintf(rgt_ctx.out_fd, "<failure message=\"%s: %s\">\n",
-            result_status2str(node->result.status), node->result.err);
+    rgt_out_printf("<failure message=\"%s: %s\">\n",
+                   result_status2str(node->result.status), node->result.err);
 
-    fprintf(rgt_ctx.out_fd, "Test parameters:\n");
+    rgt_out_puts("Test parameters:\n");
     for (p = node->params; p != NULL; p = p->next)
     {
-        fprintf(rgt_ctx.out_fd, "  %s = ", p->name);
+        rgt_out_printf("  %s = ", p->name);
         write_xml_string(NULL, p->val, FALSE);
-        fputc('\n', rgt_ctx.out_fd);
+        rgt_out_putc('\n');
     }
 
-    fprintf(rgt_ctx.out_fd, "\nError and warning messages:\n");
+    rgt_out_puts("\nError and warning messages:\n");
     if (ew_log_obstk != NULL)
     {
         obstack_1grow(ew_log_obstk, '\0');
-        fputs(obstack_finish(ew_log_obstk), rgt_ctx.out_fd);
+        rgt_out_puts(obstack_finish(ew_log_obstk));
     }
 
     if (data != NULL)
     {
         if (!msg_queue_is_empty(&data->verdicts))
         {
-            fputs("\nVerdict: ", rgt_ctx.out_fd);
+            rgt_out_puts("\nVerdict: ");
             msg_queue_foreach(&data->verdicts, process_result_cb, NULL);
         }
         if (!msg_queue_is_empty(&data->artifacts))
         {
-            fputs("\nArtifacts: ", rgt_ctx.out_fd);
+            rgt_out_puts("\nArtifacts: ");
             msg_queue_foreach(&data->artifacts, process_result_cb, NULL);
         }
     }
 
-    fputs("</failure>\n", rgt_ctx.out_fd);
+    rgt_out_puts("</failure>\n");
 }
 
 /** Process "test ended" control message. */
@@ -343,7 +344,7 @@ junit_process_test_end(node_info_t *node, ctrl_msg_data *data)
     else if (node->result.status == RES_STATUS_SKIPPED)
         process_skipped(data);
 
-    fputs("</testcase>\n", rgt_ctx.out_fd);
+    rgt_out_puts("</testcase>\n");
 
     if (ew_log_obstk != NULL) {
         obstack_destroy(ew_log_obstk);
@@ -16,6 +16,7 @@
 
 #include "log_msg.h"
 #include "live_mode.h"
+#include "output.h"
 
 #include "te_errno.h"
 
@@ -76,7 +77,7 @@ print_ts(uint32_t *ts)
     res = strftime(time_buf, TIME_BUF_LEN, "%T", &tm);
 #endif
     assert(res > 0);
-    fprintf(rgt_ctx.out_fd, "%s %u ms", time_buf, ts[1] / 1000);
+    rgt_out_printf("%s %u ms", time_buf, ts[1] / 1000);
 
 #undef TIME_BUF_LEN
 }
@@ -88,12 +89,12 @@ print_params(param *prms)
 
     if (prm != NULL)
     {
-        fprintf(rgt_ctx.out_fd, "|- Parameters:\n");
+        rgt_out_puts("|- Parameters:\n");
     }
 
     while (prm != NULL)
     {
-        fprintf(rgt_ctx.out_fd, "     + %s = %s\n", prm->name, prm->val);
+        rgt_out_printf("     + %s = %s\n", prm->name, prm->val);
         prm = prm->next;
     }
 }
@@ -104,46 +105,47 @@ live_process_start_event(node_info_t *node, const char *node_name,
 {
     UNUSED(data);
 
-    fprintf(rgt_ctx.out_fd, "| Starting %s: %s\n",
-            node_name, node->descr.name);
+    rgt_out_printf("| Starting %s: %s\n",
+                   node_name, node->descr.name);
     if (node->descr.tin != TE_TIN_INVALID)
-        fprintf(rgt_ctx.out_fd, "|- TIN: %u\n", node->descr.tin);
-    fprintf(rgt_ctx.out_fd, "|- Date: ");
+        rgt_out_printf("|- TIN: %u\n", node->descr.tin);
+    rgt_out_puts("|- Date: ");
     print_ts(node->start_ts);
-    fprintf(rgt_ctx.out_fd, "\n");
+    rgt_out_puts("\n");
 
     if (node->descr.objective != NULL)
-        fprintf(rgt_ctx.out_fd, "|- Objective: %s\n",
-                node->descr.objective);
+        rgt_out_printf("|- Objective: %s\n",
+                       node->descr.objective);
 
     if (node->descr.authors_num > 0)
     {
         unsigned int i;
         rgt_author *author;
 
-        fprintf(rgt_ctx.out_fd, "|- Authors: ");
+        rgt_out_puts("|- Authors: ");
         for (i = 0; i < node->descr.authors_num; i++)
         {
             if (i > 0)
-                fprintf(rgt_ctx.out_fd, ", ");
+                rgt_out_puts(", ");
 
             author = &node->descr.authors[i];
             if (author->name != NULL)
-                fprintf(rgt_ctx.out_fd, "%s", author->name);
+                rgt_out_puts(author->name);
 
             if (author->email != NULL)
             {
-                fprintf(rgt_ctx.out_fd, "%s%s",
-                        author->name == NULL ? "" : " ",
-                        author->email);
+                rgt_out_printf("%s%s",
+                               author->name == NULL ? "" : " ",
+                               author->email);
             }
         }
-        fprintf(rgt_ctx.out_fd, "\n");
+        rgt_out_puts("\n");
     }
 
     print_params(node->params);
 
-    fprintf(rgt_ctx.out_fd, "\n");
+    rgt_out_puts("\n");
+    rgt_out_flush();
 
     return 1;
 }
@@ -176,11 +178,12 @@ live_process_end_event(node_info_t *node, const char *node_name,
             assert(0);
     }
 
-    fprintf(rgt_ctx.out_fd, "| %s complited %-55s %s\n", node_name,
-            node->descr.name, result);
-    fprintf(rgt_ctx.out_fd, "|- Date: ");
+    rgt_out_printf("| %s complited %-55s %s\n", node_name,
+                   node->descr.name, result);
+    rgt_out_puts("|- Date: ");
     print_ts(node->end_ts);
-    fprintf(rgt_ctx.out_fd, "\n\n");
+    rgt_out_puts("\n\n");
+    rgt_out_flush();
 
     return 1;
 }
@@ -242,10 +245,11 @@ live_process_regular_msg(log_msg *msg)
 {
     rgt_expand_log_msg(msg);
 
-    fprintf(rgt_ctx.out_fd, "%s %s %s ",
-            msg->level_str, msg->entity, msg->user);
+    rgt_out_printf("%s %s %s ",
+                   msg->level_str, msg->entity, msg->user);
     print_ts(msg->timestamp);
-    fprintf(rgt_ctx.out_fd, "\n  %s\n\n", msg->txt_msg);
+    rgt_out_printf("\n  %s\n\n", msg->txt_msg);
+    rgt_out_flush();
 
     return 1;
 }
@@ -0,0 +1,356 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2004-2023 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief RGT core: buffered output
+ *
+ * Implementation of the output layer shared by all operation modes.
+ */
+
+#include "te_config.h"
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/uio.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "output.h"
+
+/** Size of one output chunk */
+#define RGT_OUT_CHUNK_SIZE  (256 * 1024)
+
+/** Number of output chunks */
+#define RGT_OUT_CHUNK_NUM   8
+
+/** Output chunk */
+typedef struct rgt_out_chunk {
+    char   *data;   /**< Chunk data */
+    size_t  len;    /**< Number of bytes filled */
+} rgt_out_chunk;
+
+/**
+ * Output context.
+ *
+ * Chunks are used as a ring: @a n_queued chunks starting from @a head
+ * are waiting to be written, the next one is being filled, the rest
+ * are free.
+ */
+typedef struct rgt_out_ctx {
+    int             fd;         /**< Output file descriptor */
+    te_bool         threaded;   /**< Data are written by the thread */
+    te_bool         failed;     /**< Some data could not be written */
+    char           *arena;      /**< Memory of all chunks */
+    rgt_out_chunk   chunks[RGT_OUT_CHUNK_NUM]; /**< Output chunks */
+    rgt_out_chunk  *cur;        /**< Chunk being filled */
+    unsigned int    head;       /**< The first chunk to be written */
+    unsigned int    n_queued;   /**< Number of chunks to be written */
+
+    te_bool         stop;       /**< The writer thread should stop */
+    pthread_t       thread;     /**< Writer thread */
+    pthread_mutex_t lock;       /**< Lock protecting the queue */
+    pthread_cond_t  cond;       /**< Queue state changed */
+} rgt_out_ctx;
+
+static rgt_out_ctx out = {
+    .fd = -1,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* Write the queued chunks with as few system calls as possible */
+static void
+rgt_out_write_chunks(unsigned int head, unsigned int num)
+{
+    struct iovec iov[RGT_OUT_CHUNK_NUM];
+    struct iovec *cur_iov = iov;
+    unsigned int iovcnt = 0;
+    unsigned int i;
+
+    for (i = 0; i < num; i++)
+    {
+        rgt_out_chunk *chunk = &out.chunks[(head + i) % RGT_OUT_CHUNK_NUM];
+
+        if (chunk->len == 0)
+            continue;
+
+        iov[iovcnt].iov_base = chunk->data;
+        iov[iovcnt].iov_len = chunk->len;
+        iovcnt++;
+    }
+
+    while (iovcnt > 0 && !out.failed)
+    {
+        ssize_t rc = writev(out.fd, cur_iov, iovcnt);
+
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            perror("Failed to write rgt-core output");
+            out.failed = TRUE;
+            break;
+        }
+
+        while (iovcnt > 0 && (size_t)rc >= cur_iov->iov_len)
+        {
+            rc -= cur_iov->iov_len;
+            cur_iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0)
+        {
+            cur_iov->iov_base = (char *)cur_iov->iov_base + rc;
+            cur_iov->iov_len -= rc;
+        }
+    }
+}
+
+/* Writer thread: write chunks as soon as they are queued */
+static void *
+rgt_out_writer(void *arg)
+{
+    unsigned int head;
+    unsigned int num;
+
+    UNUSED(arg);
+
+    pthread_mutex_lock(&out.lock);
+    while (TRUE)
+    {
+        while (out.n_queued == 0 && !out.stop)
+            pthread_cond_wait(&out.cond, &out.lock);
+
+        if (out.n_queued == 0)
+            break;
+
+        head = out.head;
+        num = out.n_queued;
+        pthread_mutex_unlock(&out.lock);
+
+        /* The chunks being written are not touched by the main thread */
+        rgt_out_write_chunks(head, num);
+
+        pthread_mutex_lock(&out.lock);
+        out.head = (head + num) % RGT_OUT_CHUNK_NUM;
+        out.n_queued -= num;
+        pthread_cond_broadcast(&out.cond);
+    }
+    pthread_mutex_unlock(&out.lock);
+
+    return NULL;
+}
+
+/* Queue the current chunk for writing and take the next free one */
+static void
+rgt_out_seal(void)
+{
+    if (out.threaded)
+    {
+        pthread_mutex_lock(&out.lock);
+        out.n_queued++;
+        pthread_cond_broadcast(&out.cond);
+        while (out.n_queued == RGT_OUT_CHUNK_NUM)
+            pthread_cond_wait(&out.cond, &out.lock);
+        pthread_mutex_unlock(&out.lock);
+    }
+    else
+    {
+        out.n_queued++;
+        if (out.n_queued == RGT_OUT_CHUNK_NUM)
+        {
+            /* All the chunks are filled, head is not changed */
+            rgt_out_write_chunks(out.head, out.n_queued);
+            out.n_queued = 0;
+        }
+    }
+
+    /* Chunks are filled in the ring order */
+    out.cur = &out.chunks[(out.cur - out.chunks + 1) % RGT_OUT_CHUNK_NUM];
+    out.cur->len = 0;
+}
+
+/* See the description in output.h */
+int
+rgt_out_init(FILE *f, te_bool threaded)
+{
+    unsigned int i;
+
+    fflush(f);
+
+    out.arena = malloc(RGT_OUT_CHUNK_SIZE * RGT_OUT_CHUNK_NUM);
+    if (out.arena == NULL)
+        return -1;
+
+    for (i = 0; i < RGT_OUT_CHUNK_NUM; i++)
+    {
+        out.chunks[i].data = out.arena + i * RGT_OUT_CHUNK_SIZE;
+        out.chunks[i].len = 0;
+    }
+
+    out.fd = fileno(f);
+    out.failed = FALSE;
+    out.head = 0;
+    out.n_queued = 0;
+    out.cur = &out.chunks[0];
+    out.stop = FALSE;
+    out.threaded = FALSE;
+    if (threaded)
+    {
+        sigset_t all;
+        sigset_t old;
+
+        /* Signals (SIGINT in particular) are handled by the main thread */
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, &old);
+        out.threaded = pthread_create(&out.thread, NULL, rgt_out_writer,
+                                      NULL) == 0;
+        pthread_sigmask(SIG_SETMASK, &old, NULL);
+    }
+
+    return 0;
+}
+
+/* See the description in output.h */
+void
+rgt_out_flush(void)
+{
+    if (out.cur->len > 0)
+        rgt_out_seal();
+
+    if (out.threaded)
+    {
+        pthread_mutex_lock(&out.lock);
+        while (out.n_queued > 0)
+            pthread_cond_wait(&out.cond, &out.lock);
+        pthread_mutex_unlock(&out.lock);
+    }
+    else if (out.n_queued > 0)
+    {
+        rgt_out_write_chunks(out.head, out.n_queued);
+        out.head = (out.head + out.n_queued) % RGT_OUT_CHUNK_NUM;
+        out.n_queued = 0;
+    }
+}
+
+/* See the description in output.h */
+int
+rgt_out_fini(void)
+{
+    if (out.arena == NULL)
+        return 0;
+
+    rgt_out_flush();
+
+    if (out.threaded)
+    {
+        pthread_mutex_lock(&out.lock);
+        out.stop = TRUE;
+        pthread_cond_broadcast(&out.cond);
+        pthread_mutex_unlock(&out.lock);
+        pthread_join(out.thread, NULL);
+        out.threaded = FALSE;
+    }
+
+    free(out.arena);
+    out.arena = NULL;
+
+    return out.failed ? -1 : 0;
+}
+
+/* See the description in output.h */
+void
+rgt_out_write(const void *data, size_t len)
+{
+    const char *p = data;
+
+    while (len > 0)
+    {
+        size_t n = RGT_OUT_CHUNK_SIZE - out.cur->len;
+
+        if (n > len)
+            n = len;
+
+        memcpy(out.cur->data + out.cur->len, p, n);
+        out.cur->len += n;
+        p += n;
+        len -= n;
+
+        if (out.cur->len == RGT_OUT_CHUNK_SIZE)
+            rgt_out_seal();
+    }
+}
+
+/* See the description in output.h */
+void
+rgt_out_puts(const char *str)
+{
+    rgt_out_write(str, strlen(str));
+}
+
+/* See the description in output.h */
+void
+rgt_out_putc(char c)
+{
+    out.cur->data[out.cur->len++] = c;
+    if (out.cur->len == RGT_OUT_CHUNK_SIZE)
+        rgt_out_seal();
+}
+
+/* See the description in output.h */
+void
+rgt_out_vprintf(const char *fmt, va_list ap)
+{
+    size_t  space = RGT_OUT_CHUNK_SIZE - out.cur->len;
+    va_list ap_copy;
+    char   *buf;
+    int     n;
+
+    /* Format in place: it is the common case */
+    va_copy(ap_copy, ap);
+    n = vsnprintf(out.cur->data + out.cur->len, space, fmt, ap_copy);
+    va_end(ap_copy);
+    if (n < 0)
+        return;
+
+    if ((size_t)n < space)
+    {
+        out.cur->len += n;
+        return;
+    }
+
+    if ((size_t)n < RGT_OUT_CHUNK_SIZE)
+    {
+        rgt_out_seal();
+        out.cur->len = vsnprintf(out.cur->data, RGT_OUT_CHUNK_SIZE, fmt, ap);
+        return;
+    }
+
+    /* Too long to fit into a chunk */
+    if (vasprintf(&buf, fmt, ap) < 0)
+        return;
+
+    rgt_out_write(buf, n);
+    free(buf);
+}
+
+/* See the description in output.h */
+void
+rgt_out_printf(const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    rgt_out_vprintf(fmt, ap);
+    va_end(ap);
+}
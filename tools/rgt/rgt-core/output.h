@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2004-2023 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief RGT core: buffered output
+ *
+ * Output layer shared by all rgt-core operation modes.
+ *
+ * Formatted data is accumulated in a preallocated set of large chunks.
+ * Filled chunks are written with writev() either by a writer thread,
+ * so that I/O overlaps with raw log parsing and formatting, or
+ * synchronously when all chunks are filled (or on explicit flush).
+ */
+
+#ifndef __TE_RGT_CORE_OUTPUT_H__
+#define __TE_RGT_CORE_OUTPUT_H__
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "te_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Start buffered output to a file.
+ *
+ * @param f         File to write to (it must not be written via stdio
+ *                  until rgt_out_fini() is called)
+ * @param threaded  Write the data in a separate thread
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+extern int rgt_out_init(FILE *f, te_bool threaded);
+
+/**
+ * Write all the buffered data and stop buffered output.
+ *
+ * @return @c 0 on success, @c -1 if some data could not be written.
+ */
+extern int rgt_out_fini(void);
+
+/**
+ * Write all the buffered data to the file. It should be used when
+ * the output is expected to be seen immediately (e.g. in live mode).
+ */
+extern void rgt_out_flush(void);
+
+/**
+ * Output a block of data.
+ *
+ * @param data      Data to output.
+ * @param len       Length of the data.
+ */
+extern void rgt_out_write(const void *data, size_t len);
+
+/**
+ * Output a string.
+ *
+ * @param str       String to output.
+ */
+extern void rgt_out_puts(const char *str);
+
+/**
+ * Output a character.
+ *
+ * @param c         Character to output.
+ */
+extern void rgt_out_putc(char c);
+
+/**
+ * Output formatted data.
+ *
+ * @param fmt       Format string.
+ * @param ap        Arguments for the format string.
+ */
+extern void rgt_out_vprintf(const char *fmt, va_list ap);
+
+/**
+ * Output formatted data.
+ *
+ * @param fmt       Format string.
+ * @param ...       Arguments for the format string.
+ */
+extern void rgt_out_printf(const char *fmt, ...)
+                           __attribute__((format(printf, 1, 2)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TE_RGT_CORE_OUTPUT_H__ */
@@ -21,6 +21,7 @@
 #include "log_msg.h"
 #include "postponed_mode.h"
 #include "memory.h"
+#include "output.h"
 
 #include "te_errno.h"
 
@@ -74,6 +75,7 @@ postponed_mode_init(f_process_ctrl_log_msg
     root_proc[CTRL_EVT_END] = postponed_process_close;
 }
 
+/* Print timestamp to @p fd or to rgt-core output if @p fd is NULL */
 static void
 print_ts(FILE *fd, uint32_t *ts)
 {
@@ -99,7 +101,10 @@ print_ts(FILE *fd, uint32_t *ts)
 #endif
 
     assert(res > 0);
-    fprintf(fd, "%s.%03u", time_buf, ts[1] / 1000);
+    if (fd == NULL)
+        rgt_out_printf("%s.%03u", time_buf, ts[1] / 1000);
+    else
+        fprintf(fd, "%s.%03u", time_buf, ts[1] / 1000);
 
 #undef TIME_BUF_LEN
 }
@@ -109,25 +114,25 @@ print_ts_info(node_info_t *node)
 {
     uint32_t duration[2];
 
-    fprintf(rgt_ctx.out_fd, "<start-ts>");
-    print_ts(rgt_ctx.out_fd, node->start_ts);
-    fprintf(rgt_ctx.out_fd, "</start-ts>\n");
-    fprintf(rgt_ctx.out_fd, "<end-ts>");
-    print_ts(rgt_ctx.out_fd, node->end_ts);
-    fprintf(rgt_ctx.out_fd, "</end-ts>\n");
+    rgt_out_puts("<start-ts>");
+    print_ts(NULL, node->start_ts);
+    rgt_out_puts("</start-ts>\n");
+    rgt_out_puts("<end-ts>");
+    print_ts(NULL, node->end_ts);
+    rgt_out_puts("</end-ts>\n");
 
     /*
      * This information is surplus but it could be useful to get it
      * without additional processing "start-ts" and "end-ts" tags.
      */
-    fprintf(rgt_ctx.out_fd, "<duration>");
+    rgt_out_puts("<duration>");
     TIMESTAMP_SUB(duration, node->end_ts, node->start_ts);
-    fprintf(rgt_ctx.out_fd, "%u:%u:%u.%03u",
-            duration[0] / (60 * 60),
-            (duration[0] % (60 * 60)) / 60,
-            (duration[0] % (60 * 60)) % 60,
-            duration[1] / 1000);
-    fprintf(rgt_ctx.out_fd, "</duration>\n");
+    rgt_out_printf("%u:%u:%u.%03u",
+                   duration[0] / (60 * 60),
+                   (duration[0] % (60 * 60)) / 60,
+                   (duration[0] % (60 * 60)) % 60,
+                   duration[1] / 1000);
+    rgt_out_puts("</duration>\n");
 }
 
 /**
@@ -143,9 +148,9 @@ print_ts_info(node_info_t *node)
 static void
 append_attr(const char *name, const char *value)
 {
-    fprintf(rgt_ctx.out_fd, " %s=\"", name);
+    rgt_out_printf(" %s=\"", name);
     write_xml_string(NULL, value, TRUE);
-    fprintf(rgt_ctx.out_fd, "\"");
+    rgt_out_puts("\"");
 }
 
 int
@@ -154,9 +159,9 @@ postponed_process_open()
     if (log_obstk == NULL)
         log_obstk = obstack_initialize();
 
-    fprintf(rgt_ctx.out_fd, "<?xml version=\"1.0\"?>\n");
-    fprintf(rgt_ctx.out_fd, "<proteos:log_report "
-            "xmlns:proteos=\"http://www.oktetlabs.ru/proteos\">\n");
+    rgt_out_puts("<?xml version=\"1.0\"?>\n");
+    rgt_out_printf("<proteos:log_report "
+                   "xmlns:proteos=\"http://www.oktetlabs.ru/proteos\">\n");
 
     return 0;
 }
@@ -169,12 +174,12 @@ postponed_process_close()
 
     if (!logs_closed)
     {
-        fprintf(rgt_ctx.out_fd, "</logs>\n");
+        rgt_out_puts("</logs>\n");
         logs_opened = 0;
         logs_closed = 1;
     }
 
-    fprintf(rgt_ctx.out_fd, "</proteos:log_report>\n");
+    rgt_out_puts("</proteos:log_report>\n");
     return 0;
 }
 
@@ -185,16 +190,16 @@ print_params(node_info_t *node)
     {
         param *prm = node->params;
 
-        fprintf(rgt_ctx.out_fd, "<params>\n");
+        rgt_out_puts("<params>\n");
         while (prm != NULL)
         {
-            fprintf(rgt_ctx.out_fd, "<param");
+            rgt_out_puts("<param");
             append_attr("name", prm->name);
             append_attr("value", prm->val);
-            fprintf(rgt_ctx.out_fd, "/>\n");
+            rgt_out_puts("/>\n");
             prm = prm->next;
         }
-        fprintf(rgt_ctx.out_fd, "</params>\n");
+        rgt_out_puts("</params>\n");
     }
 }
 
@@ -217,9 +222,9 @@ process_result_msg(gpointer data, gpointer user_data,
     msg = log_msg_read(msg_ptr);
     if (~msg->level & TE_LL_MI || rgt_ctx.mi_meta)
     {
-        fprintf(rgt_ctx.out_fd, "<%s level=\"%s\">", tag, msg->level_str);
+        rgt_out_printf("<%s level=\"%s\">", tag, msg->level_str);
         output_regular_log_msg(msg);
-        fprintf(rgt_ctx.out_fd, "</%s>\n", tag);
+        rgt_out_printf("</%s>\n", tag);
     }
     free_log_msg(msg);
 }
@@ -248,18 +253,18 @@ postponed_process_start_event(node_info_t *node, const char *node_name,
 {
     if (!logs_closed)
     {
-        fprintf(rgt_ctx.out_fd, "</logs>\n");
+        rgt_out_puts("</logs>\n");
         logs_opened = 0;
         logs_closed = 1;
     }
 
-    fprintf(rgt_ctx.out_fd, "<%s", node_name);
+    rgt_out_printf("<%s", node_name);
     if (node->descr.tin != TE_TIN_INVALID)
-        fprintf(rgt_ctx.out_fd, " tin=\"%u\"", node->descr.tin);
-    fprintf(rgt_ctx.out_fd, " test_id=\"%d\"", node->node_id);
+        rgt_out_printf(" tin=\"%u\"", node->descr.tin);
+    rgt_out_printf(" test_id=\"%d\"", node->node_id);
 
     if (node->plan_id >= 0)
-        fprintf(rgt_ctx.out_fd, " plan_id=\"%d\"", node->plan_id);
+        rgt_out_printf(" plan_id=\"%d\"", node->plan_id);
 
     if (node->descr.name)
         append_attr("name", node->descr.name);
@@ -270,7 +275,7 @@ postponed_process_start_event(node_info_t *node, const char *node_name,
     {
 #define NODE_RES_CASE(res_) \
         case RES_STATUS_ ## res_:                \
-            fprintf(rgt_ctx.out_fd, " result=\"" #res_ "\""); \
+            rgt_out_printf(" result=\"" #res_ "\""); \
             break
 
         NODE_RES_CASE(PASSED);
@@ -290,84 +295,84 @@ postponed_process_start_event(node_info_t *node, const char *node_name,
     if (node->result.err)
         append_attr("err", node->result.err);
 
-    fprintf(rgt_ctx.out_fd, ">\n");
+    rgt_out_puts(">\n");
 
     if (node->descr.n_branches > 1)
     {
-        fprintf(rgt_ctx.out_fd, "<meta nbranches=\"%d\">\n",
-                node->descr.n_branches);
+        rgt_out_printf("<meta nbranches=\"%d\">\n",
+                       node->descr.n_branches);
     }
     else
     {
-        fprintf(rgt_ctx.out_fd, "<meta>\n");
+        rgt_out_puts("<meta>\n");
     }
 
     print_ts_info(node);
 
     if (node->descr.objective != NULL)
     {
-        fputs("<objective>", rgt_ctx.out_fd);
+        rgt_out_puts("<objective>");
         write_xml_string(NULL, node->descr.objective, FALSE);
-        fputs("</objective>\n", rgt_ctx.out_fd);
+        rgt_out_puts("</objective>\n");
     }
     if (node->descr.page != NULL)
     {
-        fputs("<page>", rgt_ctx.out_fd);
+        rgt_out_puts("<page>");
         write_xml_string(NULL, node->descr.page, FALSE);
-        fputs("</page>\n", rgt_ctx.out_fd);
+        rgt_out_puts("</page>\n");
     }
     if (node->descr.authors_num > 0)
     {
         unsigned int i;
         rgt_author *author;
 
-        fputs("<authors>", rgt_ctx.out_fd);
+        rgt_out_puts("<authors>");
 
         for (i = 0; i < node->descr.authors_num; i++)
         {
-            fputs("<author", rgt_ctx.out_fd);
+            rgt_out_puts("<author");
 
             author = &node->descr.authors[i];
 
             if (author->name != NULL)
             {
-                fputs(" name=\"", rgt_ctx.out_fd);
+                rgt_out_puts(" name=\"");
                 write_xml_string(NULL, author->name, TRUE);
-                fputs("\"", rgt_ctx.out_fd);
+                rgt_out_puts("\"");
             }
 
             if (author->email != NULL)
             {
-                fputs(" email=\"", rgt_ctx.out_fd);
+                rgt_out_puts(" email=\"");
                 write_xml_string(NULL, author->email, TRUE);
-                fputs("\"", rgt_ctx.out_fd);
+                rgt_out_puts("\"");
             }
 
-            fputs("></author>", rgt_ctx.out_fd);
+            rgt_out_puts("></author>");
         }
-        fputs("</authors>\n", rgt_ctx.out_fd);
+        rgt_out_puts("</authors>\n");
     }
 
     if (data != NULL)
     {
         if (!msg_queue_is_empty(&data->verdicts))
         {
-            fputs("<verdicts>", rgt_ctx.out_fd);
+            rgt_out_puts("<verdicts>");
             msg_queue_foreach(&data->verdicts, process_verdict_cb, NULL);
-            fputs("</verdicts>\n", rgt_ctx.out_fd);
+            rgt_out_puts("</verdicts>\n");
         }
 
         if (!msg_queue_is_empty(&data->artifacts) &&
             (data->not_mi_artifacts || rgt_ctx.mi_meta))
         {
-            fputs("<artifacts>", rgt_ctx.out_fd);
+            rgt_out_puts("<artifacts>");
             msg_queue_foreach(&data->artifacts, process_artifact_cb, NULL);
-            fputs("</artifacts>\n", rgt_ctx.out_fd);
+            rgt_out_puts("</artifacts>\n");
         }
     }
 
     print_params(node);
-    fprintf(rgt_ctx.out_fd, "</meta>\n");
+    rgt_out_puts("</meta>\n");
     logs_opened = 0;
 
     return 1;
@@ -382,12 +387,12 @@ postponed_process_end_event(node_info_t *node, const char *node_name,
 
     if (!logs_closed)
     {
-        fprintf(rgt_ctx.out_fd, "</logs>\n");
+        rgt_out_puts("</logs>\n");
         logs_opened = 0;
         logs_closed = 1;
     }
 
-    fprintf(rgt_ctx.out_fd, "</%s>\n", node_name);
+    rgt_out_printf("</%s>\n", node_name);
     return 1;
 }
 
@@ -435,11 +440,11 @@ postponed_process_branch_start(node_info_t *node, ctrl_msg_data *data)
 
     if (!logs_closed)
     {
-        fprintf(rgt_ctx.out_fd, "</logs>\n");
+        rgt_out_puts("</logs>\n");
         logs_opened = 0;
         logs_closed = 1;
     }
-    fprintf(rgt_ctx.out_fd, "<branch>\n");
+    rgt_out_puts("<branch>\n");
     return 1;
 }
 
@@ -451,11 +456,11 @@ postponed_process_branch_end(node_info_t *node, ctrl_msg_data *data)
 
     if (!logs_closed)
     {
-        fprintf(rgt_ctx.out_fd, "</logs>\n");
+        rgt_out_puts("</logs>\n");
         logs_opened = 0;
         logs_closed = 1;
     }
-    fprintf(rgt_ctx.out_fd, "</branch>\n");
+    rgt_out_puts("</branch>\n");
     return 1;
 }
 
@@ -464,21 +469,21 @@ postponed_process_regular_msg(log_msg *msg)
 {
     if (!logs_opened)
     {
-        fprintf(rgt_ctx.out_fd, "<logs>");
+        rgt_out_puts("<logs>");
         logs_opened = 1;
         logs_closed = 0;
     }
 
-    fprintf(rgt_ctx.out_fd, "<msg level=\"%s\"",
-            msg->level_str);
+    rgt_out_printf("<msg level=\"%s\"",
+                   msg->level_str);
     append_attr("entity", msg->entity);
     append_attr("user", msg->user);
-    fprintf(rgt_ctx.out_fd, " ts_val=\"%u.%06u\" ts=\"",
-            msg->timestamp[0], msg->timestamp[1]);
-    print_ts(rgt_ctx.out_fd, msg->timestamp);
-    fprintf(rgt_ctx.out_fd, "\" nl=\"%d\">", msg->nest_lvl);
+    rgt_out_printf(" ts_val=\"%u.%06u\" ts=\"",
+                   msg->timestamp[0], msg->timestamp[1]);
+    print_ts(NULL, msg->timestamp);
+    rgt_out_printf("\" nl=\"%d\">", msg->nest_lvl);
     output_regular_log_msg(msg);
-    fprintf(rgt_ctx.out_fd, "</msg>\n");
+    rgt_out_puts("</msg>\n");
 
     return 1;
 }
@@ -507,7 +512,7 @@ output_regular_log_msg(log_msg *msg)
                                                       \
         obstack_1grow(log_obstk, '\0');               \
         out_str = (char *)obstack_finish(log_obstk);  \
-        fprintf(rgt_ctx.out_fd, "%s", out_str);            \
+        rgt_out_puts(out_str);            \
         obstack_free(log_obstk, out_str);             \
     } while (0)
 
@@ -817,7 +822,7 @@ output_regular_log_msg(log_msg *msg)
         }
         *(out_str + str_len + br_len - i) = '\0';
 
-        fprintf(rgt_ctx.out_fd, "%s", out_str);
+        rgt_out_puts(out_str);
         obstack_free(log_obstk, out_str);
     }
 
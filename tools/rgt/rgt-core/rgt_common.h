@@ -46,6 +46,7 @@ extern "C" {
 #include <sys/types.h>
 #include <errno.h>
 #include <setjmp.h>
+#include <signal.h>
 
 #include <stdio.h>
 
@@ -126,6 +127,12 @@ extern "C" {
 /** The stack context of the main procedure */
 extern jmp_buf rgt_mainjmp;
 
+/**
+ * Set on SIGINT. Processing of log messages stops as soon as
+ * the main loop notices it, and the output is completed there.
+ */
+extern volatile sig_atomic_t rgt_interrupted;
+
 /* Generates an exception from any point of RGT */
 #define THROW_EXCEPTION \
     do {                     \
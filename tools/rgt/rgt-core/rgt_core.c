@@ -24,6 +24,7 @@
 #include "flow_tree.h"
 #include "filter.h"
 #include "io.h"
+#include "output.h"
 #include "memory.h"
 #include "live_mode.h"
 #include "postponed_mode.h"
@@ -59,6 +60,9 @@ rgt_gen_ctx_t rgt_ctx;
  */
 jmp_buf rgt_mainjmp;
 
+/* See the description in rgt_common.h */
+volatile sig_atomic_t rgt_interrupted = 0;
+
 
 /**
  * Print "usage" how to.
@@ -342,13 +346,29 @@ process_cmd_line_opts(int argc, char **argv, rgt_gen_ctx_t *ctx)
     }
 }
 
+#ifdef HAVE_SIGNAL_H
+/**
+ * SIGINT handler. Only the flag is set here since completing the output
+ * (mutex, condition variable, thread join) is not async-signal-safe.
+ *
+ * @param  signo  Signal number (unused).
+ */
+static void
+rgt_sigint_handler(int signo)
+{
+    UNUSED(signo);
+
+    rgt_interrupted = 1;
+}
+#endif
+
 /**
  * Frees all global resources are used by rgt-core:
  *   Destroys flow tree module;
  *   Destroys filter module;
  *   Closes all file descriptors.
- * This function can be called explicitly or as a callback function on
- * arriving SIGINT signal to the program.
+ * This function is called explicitly on completion, on an error and
+ * when processing is interrupted by SIGINT.
  *
  * @param  signo  Signal number by which the program is terminated.
  *                If signo is equal to zero it means an error was occurred
@@ -365,6 +385,10 @@ static void free_resources(int signo)
     destroy_node_info_pool();
     destroy_log_msg_pool();
     fclose(rgt_ctx.rawlog_fd);
+
+    /* Incomplete output is treated as failure */
+    if (rgt_out_fini() != 0)
+        signo = 0;
     fclose(rgt_ctx.out_fd);
 
     if (signo == 0)
@@ -398,9 +422,20 @@ main(int argc, char **argv)
     rgt_ctx_set_defaults(&rgt_ctx);
     process_cmd_line_opts(argc, argv, &rgt_ctx);
 
+    /*
+     * Output is written in a separate thread unless it should be
+     * seen as soon as possible.
+     */
+    if (rgt_out_init(rgt_ctx.out_fd,
+                     rgt_ctx.op_mode != RGT_OP_MODE_LIVE) != 0)
+    {
+        fprintf(stderr, "Failed to allocate output buffers\n");
+        free_resources(0);
+    }
+
 #ifdef HAVE_SIGNAL_H
     /* Set signal handler for catching CTRL^C interruption */
-    signal(SIGINT, free_resources);
+    signal(SIGINT, rgt_sigint_handler);
 #endif
 
     if (rgt_filter_init(rgt_ctx.fltr_fname) < 0)
@@ -428,7 +463,7 @@ main(int argc, char **argv)
             log_root_proc[CTRL_EVT_START]();
 
         /* Log message processing loop */
-        while (1)
+        while (!rgt_interrupted)
         {
             rgt_update_progress_bar(&rgt_ctx);
 
@@ -476,6 +511,10 @@ main(int argc, char **argv)
             rgt_core_process_log_msg(msg);
         }
 
+        /* CTRL^C: keep what has been output so far */
+        if (rgt_interrupted)
+            free_resources(SIGINT);
+
         if (rgt_ctx.op_mode == RGT_OP_MODE_POSTPONED ||
             rgt_ctx.op_mode == RGT_OP_MODE_JUNIT)
         {
@@ -494,7 +533,8 @@ main(int argc, char **argv)
     }
     else
     {
-        free_resources(0);
+        /* Reading may be broken by CTRL^C in the middle of a message */
+        free_resources(rgt_interrupted ? SIGINT : 0);
     }
 
     free(rgt_ctx.rawlog_fname);
@@ -1158,6 +1158,44 @@ cleanup:
         te_rgt_mi_clean(mi);
 }
 
+/** Parse "trace_span" MI message */
+static void
+te_rgt_parse_mi_trace_span_message(te_rgt_mi *mi)
+{
+    int                   ret;
+    int                   version;
+    const char           *type;
+    json_int_t            start;
+    json_int_t            duration;
+    json_error_t          err;
+    te_rgt_mi_trace_span *data;
+
+    mi->type = TE_RGT_MI_TYPE_TRACE_SPAN;
+    data = &mi->data.trace_span;
+
+    ret = json_unpack_ex((json_t *)(mi->json_obj), &err, JSON_STRICT,
+                         "{s:s, s:i, s:s, s:s, s?s, s:s, s:I, s:I}",
+                         "type", &type,
+                         "version", &version,
+                         "trace", &data->trace,
+                         "span", &data->span,
+                         "parent", &data->parent,
+                         "name", &data->name,
+                         "start", &start,
+                         "duration", &duration);
+    if (ret != 0)
+    {
+        te_rgt_mi_parse_error(mi, TE_EINVAL,
+                              "Error unpacking trace_span JSON log "
+                              "message: %s (line %d, column %d)",
+                              err.text, err.line, err.column);
+        return;
+    }
+
+    data->start = start;
+    data->duration = duration;
+}
+
 #endif /* HAVE_LIBJANSSON */
 
 /* See description in mi_msg.h */
@@ -1211,6 +1249,10 @@ te_rgt_parse_mi_message(const char *json_buf, size_t buf_len,
     {
         te_rgt_parse_mi_trc_tags_message(mi);
     }
+    else if (strcmp(type, "trace_span") == 0)
+    {
+        te_rgt_parse_mi_trace_span_message(mi);
+    }
     else
     {
         /* Unknown type - handle as generic JSON */
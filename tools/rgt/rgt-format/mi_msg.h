@@ -174,12 +174,23 @@ typedef struct te_rgt_mi_trc_tags {
     te_vec tags; /**< Vector of TRC tags */
 } te_rgt_mi_trc_tags;
 
+/** Description of MI message of type "trace_span" (see te_trace.h) */
+typedef struct te_rgt_mi_trace_span {
+    const char *trace;      /**< Trace ID */
+    const char *span;       /**< Span ID */
+    const char *parent;     /**< Parent span ID or @c NULL */
+    const char *name;       /**< Span name */
+    int64_t     start;      /**< Start time, microseconds since Epoch */
+    int64_t     duration;   /**< Duration, microseconds */
+} te_rgt_mi_trace_span;
+
 /** Types of MI message */
 typedef enum {
     TE_RGT_MI_TYPE_MEASUREMENT = 0,   /**< Measurement */
     TE_RGT_MI_TYPE_TEST_START,        /**< Package/Session/Test start */
     TE_RGT_MI_TYPE_TEST_END,          /**< Package/Session/Test end */
     TE_RGT_MI_TYPE_TRC_TAGS,          /**< TRC tags */
+    TE_RGT_MI_TYPE_TRACE_SPAN,        /**< Span of a traced operation */
     TE_RGT_MI_TYPE_UNKNOWN            /**< Unknown type */
 } te_rgt_mi_type;
 
@@ -204,6 +215,8 @@ typedef struct te_rgt_mi {
         te_rgt_mi_test_end   test_end;   /**< Data for test_end MI message */
 
         te_rgt_mi_trc_tags trc_tags; /**< Data for trc_tags MI message */
+        te_rgt_mi_trace_span trace_span; /**< Data for trace_span MI
+                                              message */
     } data; /**< Data obtained from JSON object */
 } te_rgt_mi;
 
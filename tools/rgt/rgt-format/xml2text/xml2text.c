@@ -162,6 +162,20 @@ flow_stack_pop(flow_stack_t *stack, int id)
     return NULL;
 }
 
+/** Span of a traced operation collected for the waterfall view */
+typedef struct trace_span_item {
+    char    *trace;     /**< Trace ID */
+    char    *span;      /**< Span ID */
+    char    *parent;    /**< Parent span ID or @c NULL */
+    char    *name;      /**< Span name */
+    int64_t  start;     /**< Start time, microseconds */
+    int64_t  duration;  /**< Duration, microseconds */
+    unsigned int depth; /**< Depth in the tree of spans */
+} trace_span_item;
+
+/** Width of the bar of the waterfall view in characters */
+#define TRACE_BAR_WIDTH 40
+
 /** Structure to keep basic user data in general parsing context */
 typedef struct gen_ctx_user {
     FILE             *fd; /**< File descriptor of the document to output
@@ -176,6 +190,10 @@ typedef struct gen_ctx_user {
     char msg_prefix[1024];   /**< Prefix to be printed before every line
                                   of the message */
     int msg_prefix_len;      /**< Length of the message prefix */
+
+    te_vec trace_spans;      /**< Spans of traced operations
+                                  (trace_span_item) collected since
+                                  the last waterfall view */
 } gen_ctx_user_t;
 
 /* RGT format-specific options table */
@@ -328,6 +346,149 @@ tmpls_output_cb(rgt_gen_ctx_t *gen_ctx, rgt_depth_ctx_t *depth_ctx,
     rgt_tmpls_output_log(ctx, tmpl, attrs);
 }
 
+/** Release memory of a collected span */
+static void
+trace_span_item_free(const void *item)
+{
+    const trace_span_item *span = item;
+
+    free(span->trace);
+    free(span->span);
+    free(span->parent);
+    free(span->name);
+}
+
+/** Compare spans by trace ID and start time */
+static int
+trace_span_item_cmp(const void *item1, const void *item2)
+{
+    const trace_span_item *span1 = item1;
+    const trace_span_item *span2 = item2;
+    int                    rc;
+
+    rc = strcmp(span1->trace, span2->trace);
+    if (rc != 0)
+        return rc;
+
+    if (span1->start != span2->start)
+        return span1->start < span2->start ? -1 : 1;
+
+    /* A parent starting at the same time goes first */
+    return span1->depth < span2->depth ? -1 : span1->depth > span2->depth;
+}
+
+/**
+ * Compute depth of a span in the tree of spans of its trace.
+ *
+ * @param spans     Collected spans
+ * @param span      Span
+ *
+ * @return Number of ancestors of the span found among collected spans.
+ */
+static unsigned int
+trace_span_depth(te_vec *spans, const trace_span_item *span)
+{
+    const trace_span_item *cur = span;
+    const trace_span_item *item;
+    unsigned int           depth = 0;
+
+    while (cur->parent != NULL && depth < te_vec_size(spans))
+    {
+        const trace_span_item *parent = NULL;
+
+        TE_VEC_FOREACH(spans, item)
+        {
+            if (strcmp(item->span, cur->parent) == 0 &&
+                strcmp(item->trace, cur->trace) == 0)
+            {
+                parent = item;
+                break;
+            }
+        }
+        if (parent == NULL)
+            break;
+
+        depth++;
+        cur = parent;
+    }
+
+    return depth;
+}
+
+/**
+ * Log a waterfall view of collected spans of traced operations
+ * and forget the spans.
+ *
+ * @param ctx       Logging context.
+ */
+static void
+log_trace_waterfall(gen_ctx_user_t *ctx)
+{
+    size_t           n = te_vec_size(&ctx->trace_spans);
+    size_t           first;
+    size_t           i;
+    trace_span_item *span;
+
+    if (n == 0)
+        return;
+
+    TE_VEC_FOREACH(&ctx->trace_spans, span)
+        span->depth = trace_span_depth(&ctx->trace_spans, span);
+    te_vec_sort(&ctx->trace_spans, trace_span_item_cmp);
+
+    for (first = 0; first < n; first = i)
+    {
+        const trace_span_item *head = te_vec_get(&ctx->trace_spans, first);
+        int64_t                begin = head->start;
+        int64_t                end = head->start + head->duration;
+
+        for (i = first; i < n; i++)
+        {
+            span = te_vec_get(&ctx->trace_spans, i);
+            if (strcmp(span->trace, head->trace) != 0)
+                break;
+            end = MAX(end, span->start + span->duration);
+        }
+
+        fprintf(ctx->fd, "\nTrace %s (%" PRId64 " us):\n",
+                head->trace, end - begin);
+
+        for (; first < i; first++)
+        {
+            char    bar[TRACE_BAR_WIDTH + 1];
+            int64_t offset;
+            int64_t width;
+
+            span = te_vec_get(&ctx->trace_spans, first);
+
+            if (end > begin)
+            {
+                offset = (span->start - begin) * TRACE_BAR_WIDTH /
+                         (end - begin);
+                width = span->duration * TRACE_BAR_WIDTH / (end - begin);
+            }
+            else
+            {
+                offset = 0;
+                width = TRACE_BAR_WIDTH;
+            }
+            offset = MIN(offset, TRACE_BAR_WIDTH - 1);
+            width = MAX(MIN(width, TRACE_BAR_WIDTH - offset), 1);
+
+            memset(bar, ' ', TRACE_BAR_WIDTH);
+            memset(bar + offset, '#', width);
+            bar[TRACE_BAR_WIDTH] = '\0';
+
+            fprintf(ctx->fd, "  %*s%-*s %10" PRId64 " us |%s|\n",
+                    (int)span->depth * 2, "",
+                    (int)MAX(0, 40 - (int)span->depth * 2), span->name,
+                    span->duration, bar);
+        }
+    }
+
+    te_vec_reset(&ctx->trace_spans);
+}
+
 void rgt_process_cmdline(rgt_gen_ctx_t *ctx, poptContext con, int val) {
     UNUSED(ctx);
     UNUSED(con);
@@ -349,6 +510,9 @@ RGT_DEF_FUNC(proc_document_start)
 
     user_ctx.msg_prefix_len = 0;
 
+    user_ctx.trace_spans = TE_VEC_INIT_DESTROY(trace_span_item,
+                                               trace_span_item_free);
+
     /* In text output all XML entities should be expanded */
     ctx->expand_entities = TRUE;
 
@@ -377,18 +541,33 @@ RGT_DEF_FUNC(proc_document_end)
 
     RGT_FUNC_UNUSED_PRMS();
 
+    log_trace_waterfall(user_ctx);
+
     rgt_tmpls_output(fd, &xml2fmt_tmpls[DOCUMENT_END], NULL);
     fclose(fd);
 
     te_dbuf_free(&user_ctx->json_data);
+    te_vec_free(&user_ctx->trace_spans);
+}
+
+/*
+ * Traced operations of a test, package or session are shown
+ * as a waterfall at its end.
+ */
+#define DEF_FUNC_TRACE_WATERFALL(name_) \
+RGT_DEF_FUNC(name_)                                                 \
+{                                                                   \
+    RGT_FUNC_UNUSED_PRMS();                                         \
+                                                                    \
+    log_trace_waterfall((gen_ctx_user_t *)(ctx->user_data));        \
 }
 
 RGT_DEF_DUMMY_FUNC(proc_session_start)
-RGT_DEF_DUMMY_FUNC(proc_session_end)
+DEF_FUNC_TRACE_WATERFALL(proc_session_end)
 RGT_DEF_DUMMY_FUNC(proc_pkg_start)
-RGT_DEF_DUMMY_FUNC(proc_pkg_end)
+DEF_FUNC_TRACE_WATERFALL(proc_pkg_end)
 RGT_DEF_DUMMY_FUNC(proc_test_start)
-RGT_DEF_DUMMY_FUNC(proc_test_end)
+DEF_FUNC_TRACE_WATERFALL(proc_test_end)
 
 #define DEF_FUNC_WITH_ATTRS(name_, enum_const_) \
 RGT_DEF_FUNC(name_)                                                 \
@@ -802,6 +981,36 @@ log_mi_trc_tags(gen_ctx_user_t *ctx, te_rgt_mi *mi)
     }
 }
 
+/**
+ * Log MI artifact of type "trace_span" and save the span for
+ * the waterfall view.
+ *
+ * @param ctx     Logging context.
+ * @param mi      Structure with data from parsed MI artifact.
+ */
+static void
+log_mi_trace_span(gen_ctx_user_t *ctx, te_rgt_mi *mi)
+{
+    te_rgt_mi_trace_span *data = &mi->data.trace_span;
+    trace_span_item       item;
+
+    fprintf_log(ctx, "Span %s: %" PRId64 " us (trace %s, span %s",
+                data->name, data->duration, data->trace, data->span);
+    if (data->parent != NULL)
+        fprintf_log(ctx, ", parent %s", data->parent);
+    fprintf_log(ctx, ")");
+
+    item.trace = TE_STRDUP(data->trace);
+    item.span = TE_STRDUP(data->span);
+    item.parent = data->parent == NULL ? NULL : TE_STRDUP(data->parent);
+    item.name = TE_STRDUP(data->name);
+    item.start = data->start;
+    item.duration = data->duration;
+    item.depth = 0;
+
+    TE_VEC_APPEND(&ctx->trace_spans, item);
+}
+
 /**
  * Log MI artifact.
  *
@@ -921,6 +1130,10 @@ log_mi_artifact(gen_ctx_user_t *ctx, te_rgt_mi *mi)
     {
         log_mi_trc_tags(ctx, mi);
     }
+    else if (mi->type == TE_RGT_MI_TYPE_TRACE_SPAN)
+    {
+        log_mi_trace_span(ctx, mi);
+    }
 }
 
 RGT_DEF_FUNC(proc_log_msg_end)